@@ -143,6 +143,13 @@ CommandLineHandler::CommandLineHandler()
             .set_syntax("filename")
             .set_exact_value_count(1));
 
+    parser().add_option_handler(
+        &m_stream_output
+            .add_name("--stream-output")
+            .set_description("write tiles to a tiled exr file as soon as they are rendered")
+            .set_syntax("filename")
+            .set_exact_value_count(1));
+
 #if defined __APPLE__ || defined _WIN32
     parser().add_option_handler(
         &m_display_output
@@ -171,6 +178,13 @@ CommandLineHandler::CommandLineHandler()
             .add_name("--to-stdout")
             .set_description("send render to standard output"));
 
+    parser().add_option_handler(
+        &m_send_to_stdout_compression
+            .add_name("--to-stdout-compression")
+            .set_description("compress tiles sent to standard output (none, half, lz4 or half-lz4)")
+            .set_syntax("method")
+            .set_exact_value_count(1));
+
     parser().add_option_handler(
         &m_save_light_paths
             .add_name("--save-light-paths")
@@ -178,11 +192,25 @@ CommandLineHandler::CommandLineHandler()
             .set_syntax("filename")
             .set_exact_value_count(1));
 
+#ifdef APPLESEED_WITH_TRACING
+    parser().add_option_handler(
+        &m_save_trace
+            .add_name("--save-trace")
+            .set_description("save a timeline of the rendering process to disk in the chrome trace event format")
+            .set_syntax("filename")
+            .set_exact_value_count(1));
+#endif
+
     parser().add_option_handler(
         &m_disable_autosave
             .add_name("--disable-autosave")
             .set_description("disable automatic saving of rendered images"));
 
+    parser().add_option_handler(
+        &m_async_logging
+            .add_name("--async-logging")
+            .set_description("queue log messages emitted while rendering and write them from a background thread"));
+
     parser().add_option_handler(
         &m_run_unit_tests
             .add_name("--run-unit-tests")
@@ -199,6 +227,40 @@ CommandLineHandler::CommandLineHandler()
             .set_min_value_count(0)
             .set_max_value_count(1));
 
+    parser().add_option_handler(
+        &m_unit_benchmark_runs
+            .add_name("--unit-benchmark-runs")
+            .set_description("set the number of independent timing runs per unit benchmark case")
+            .set_syntax("n")
+            .set_exact_value_count(1));
+
+    parser().add_option_handler(
+        &m_unit_benchmark_warmup
+            .add_name("--unit-benchmark-warmup")
+            .set_description("set the number of unmeasured calls before timing a unit benchmark case")
+            .set_syntax("n")
+            .set_exact_value_count(1));
+
+    parser().add_option_handler(
+        &m_unit_benchmark_no_pinning
+            .add_name("--unit-benchmark-no-pinning")
+            .set_description("do not pin the benchmarking thread to a single processor"));
+
+    parser().add_option_handler(
+        &m_compare_unit_benchmarks
+            .add_name("--compare-unit-benchmarks")
+            .set_description("compare two unit benchmark results files, or a results file with the results of --run-unit-benchmarks, and report regressions")
+            .set_syntax("baseline [current]")
+            .set_min_value_count(1)
+            .set_max_value_count(2));
+
+    parser().add_option_handler(
+        &m_unit_benchmark_threshold
+            .add_name("--unit-benchmark-threshold")
+            .set_description("set the relative slowdown above which a unit benchmark case is reported as a regression (default: 0.05)")
+            .set_syntax("fraction")
+            .set_exact_value_count(1));
+
     parser().add_option_handler(
         &m_verbose_unit_tests
             .add_name("--verbose-unit-tests")
@@ -36,6 +36,7 @@
 #include "foundation/utility/commandlineparser.h"
 
 // Standard headers.
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -73,18 +74,29 @@ class CommandLineHandler
 
     // Output options.
     foundation::ValueOptionHandler<std::string>         m_output;
+    foundation::ValueOptionHandler<std::string>         m_stream_output;
 #if defined __APPLE__ || defined _WIN32
     foundation::FlagOptionHandler                       m_display_output;
 #endif
     foundation::ValueOptionHandler<std::string>         m_checkpoint_create;
     foundation::ValueOptionHandler<std::string>         m_checkpoint_resume;
     foundation::FlagOptionHandler                       m_send_to_stdout;
+    foundation::ValueOptionHandler<std::string>         m_send_to_stdout_compression;
     foundation::FlagOptionHandler                       m_disable_autosave;
+    foundation::FlagOptionHandler                       m_async_logging;
     foundation::ValueOptionHandler<std::string>         m_save_light_paths;
+#ifdef APPLESEED_WITH_TRACING
+    foundation::ValueOptionHandler<std::string>         m_save_trace;
+#endif
 
     // Developer-oriented options.
     foundation::ValueOptionHandler<std::string>         m_run_unit_tests;
     foundation::ValueOptionHandler<std::string>         m_run_unit_benchmarks;
+    foundation::ValueOptionHandler<std::size_t>         m_unit_benchmark_runs;
+    foundation::ValueOptionHandler<std::size_t>         m_unit_benchmark_warmup;
+    foundation::FlagOptionHandler                       m_unit_benchmark_no_pinning;
+    foundation::ValueOptionHandler<std::string>         m_compare_unit_benchmarks;
+    foundation::ValueOptionHandler<double>              m_unit_benchmark_threshold;
     foundation::FlagOptionHandler                       m_verbose_unit_tests;
     foundation::FlagOptionHandler                       m_benchmark_mode;
 
@@ -58,6 +58,7 @@
 #include "foundation/utility/filter.h"
 #include "foundation/utility/searchpaths.h"
 #include "foundation/utility/test.h"
+#include "foundation/utility/tracerecorder.h"
 
 // appleseed.main headers.
 #include "main/allocator.h"
@@ -73,6 +74,7 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
 
 using namespace appleseed::cli;
 using namespace appleseed::common;
@@ -187,7 +189,8 @@ namespace
         return result.get_assertion_failure_count() == 0;
     }
 
-    void run_unit_benchmarks()
+    // Run unit benchmarks and return the path to the JSON results file, or an empty string.
+    std::string run_unit_benchmarks()
     {
         // Configure the renderer's logger: mute all log messages except warnings and errors.
         SaveLogFormatterConfig save_global_logger_config(global_logger());
@@ -220,26 +223,52 @@ namespace
                 xmlfile_path.string().c_str());
         }
 
+        // Try to add a benchmark listener that outputs to a JSON file.
+        auto_release_ptr<JSONFileBenchmarkListener> jsonfile_listener(
+            create_jsonfile_benchmark_listener());
+        const std::string jsonfile_name = "benchmark." + get_time_stamp_string() + ".json";
+        const bf::path jsonfile_path =
+              bf::path(Application::get_tests_root_path())
+            / "unit benchmarks" / "results" / jsonfile_name;
+        if (jsonfile_listener->open(jsonfile_path.string().c_str()))
+            result.add_listener(jsonfile_listener.get());
+        else
+        {
+            LOG_WARNING(
+                g_logger,
+                "automatic benchmark results archiving to %s failed: i/o error.",
+                jsonfile_path.string().c_str());
+        }
+
+        // Collect benchmarking parameters.
+        BenchmarkParams params;
+        if (g_cl.m_unit_benchmark_runs.is_set())
+            params.m_run_count = g_cl.m_unit_benchmark_runs.value();
+        if (g_cl.m_unit_benchmark_warmup.is_set())
+            params.m_warmup_count = g_cl.m_unit_benchmark_warmup.value();
+        if (g_cl.m_unit_benchmark_no_pinning.is_set())
+            params.m_pin_thread = false;
+
         const bf::path old_current_path =
             Application::change_current_directory_to_tests_root_path();
 
         // Run benchmark suites.
         if (g_cl.m_run_unit_benchmarks.values().empty())
-            BenchmarkSuiteRepository::instance().run(result);
+            BenchmarkSuiteRepository::instance().run(result, params);
         else
         {
             const char* regex = g_cl.m_run_unit_benchmarks.value().c_str();
             const RegExFilter filter(regex, RegExFilter::CaseInsensitive);
 
             if (filter.is_valid())
-                BenchmarkSuiteRepository::instance().run(filter, result);
+                BenchmarkSuiteRepository::instance().run(filter, result, params);
             else
             {
                 LOG_ERROR(
                     g_logger,
                     "malformed regular expression '%s', disabling benchmark filtering.",
                     regex);
-                BenchmarkSuiteRepository::instance().run(result);
+                BenchmarkSuiteRepository::instance().run(result, params);
             }
         }
 
@@ -248,6 +277,90 @@ namespace
 
         // Print results.
         print_unit_benchmark_result(result);
+
+        if (!jsonfile_listener->is_open())
+            return std::string();
+
+        jsonfile_listener->close();
+
+        return jsonfile_path.string();
+    }
+
+    // Compare unit benchmark results files and return false if regressions were found.
+    bool compare_unit_benchmarks(const std::string& current_results_path)
+    {
+        const std::vector<std::string>& values = g_cl.m_compare_unit_benchmarks.values();
+        const std::string& baseline_path = values[0];
+        const std::string current_path = values.size() > 1 ? values[1] : current_results_path;
+
+        if (current_path.empty())
+        {
+            LOG_ERROR(
+                g_logger,
+                "no unit benchmark results to compare against %s; specify a second results file or use --run-unit-benchmarks.",
+                baseline_path.c_str());
+            return false;
+        }
+
+        BenchmarkComparison comparison;
+
+        if (!comparison.read_baseline(baseline_path.c_str()))
+        {
+            LOG_ERROR(g_logger, "failed to read unit benchmark results file %s.", baseline_path.c_str());
+            return false;
+        }
+
+        if (!comparison.read_current(current_path.c_str()))
+        {
+            LOG_ERROR(g_logger, "failed to read unit benchmark results file %s.", current_path.c_str());
+            return false;
+        }
+
+        const double threshold =
+            g_cl.m_unit_benchmark_threshold.is_set()
+                ? g_cl.m_unit_benchmark_threshold.value()
+                : 0.05;
+
+        comparison.compare(threshold);
+
+        size_t improvement_count = 0;
+
+        for (size_t i = 0, e = comparison.get_case_count(); i < e; ++i)
+        {
+            const BenchmarkComparison::Case& c = comparison.get_case(i);
+
+            if (!c.m_regression && !c.m_improvement)
+                continue;
+
+            if (c.m_improvement)
+                ++improvement_count;
+
+            LOG(
+                g_logger,
+                c.m_regression ? LogMessage::Warning : LogMessage::Info,
+                "%s: %s::%s: %s ns -> %s ns (%s%s)",
+                c.m_regression ? "regression" : "improvement",
+                c.m_suite_name,
+                c.m_case_name,
+                pretty_scalar(c.m_baseline_time * 1.0e9, 1).c_str(),
+                pretty_scalar(c.m_current_time * 1.0e9, 1).c_str(),
+                c.m_relative_change > 0.0 ? "+" : "",
+                pretty_scalar(c.m_relative_change * 100.0, 1).c_str());
+        }
+
+        LOG_INFO(
+            g_logger,
+            "unit benchmarks comparison summary:\n"
+            "  compared    : %s cases, %s unmatched\n"
+            "  regressions : %s (threshold %s%%)\n"
+            "  improvements: %s",
+            pretty_uint(comparison.get_case_count()).c_str(),
+            pretty_uint(comparison.get_unmatched_case_count()).c_str(),
+            pretty_uint(comparison.get_regression_count()).c_str(),
+            pretty_scalar(threshold * 100.0, 1).c_str(),
+            pretty_uint(improvement_count).c_str());
+
+        return comparison.get_regression_count() == 0;
     }
 
     void apply_rendering_settings_command_line_options(ParamArray& params)
@@ -530,6 +643,36 @@ namespace
         return apply_command_line_options(project, params);
     }
 
+    bool get_stdout_tile_compression(StdOutTileCallbackFactory::TileCompression& compression)
+    {
+        compression = StdOutTileCallbackFactory::TileCompression::None;
+
+        if (!g_cl.m_send_to_stdout_compression.is_set())
+            return true;
+
+        const std::string& method = g_cl.m_send_to_stdout_compression.value();
+
+        if (method == "none")
+            compression = StdOutTileCallbackFactory::TileCompression::None;
+        else if (method == "half")
+            compression = StdOutTileCallbackFactory::TileCompression::Half;
+        else if (method == "lz4")
+            compression = StdOutTileCallbackFactory::TileCompression::LZ4;
+        else if (method == "half-lz4")
+            compression = StdOutTileCallbackFactory::TileCompression::HalfLZ4;
+        else
+        {
+            LOG_ERROR(
+                g_logger,
+                "invalid value \"%s\" for %s, expected none, half, lz4 or half-lz4",
+                method.c_str(),
+                g_cl.m_send_to_stdout_compression.get_name().c_str());
+            return false;
+        }
+
+        return true;
+    }
+
     bool is_progressive_render(const ParamArray& params)
     {
         const std::string value = params.get_required<std::string>("frame_renderer", "generic");
@@ -552,9 +695,14 @@ namespace
         std::unique_ptr<ITileCallbackFactory> tile_callback_factory;
         if (g_cl.m_send_to_stdout.is_set())
         {
+            StdOutTileCallbackFactory::TileCompression compression;
+            if (!get_stdout_tile_compression(compression))
+                return false;
+
             tile_callback_factory.reset(
                 new StdOutTileCallbackFactory(
-                    StdOutTileCallbackFactory::TileOutputOptions::AllAOVs));
+                    StdOutTileCallbackFactory::TileOutputOptions::AllAOVs,
+                    compression));
         }
         else if (project->get_display() == nullptr)
         {
@@ -568,6 +716,27 @@ namespace
             }
         }
 
+        // Optionally stream finished tiles to disk.
+        std::unique_ptr<ITileCallbackFactory> stream_tile_callback_factory;
+        std::unique_ptr<TileCallbackCollectionFactory> tile_callback_collection_factory;
+        if (g_cl.m_stream_output.is_set())
+        {
+            if (params.get_optional<std::string>("frame_renderer", "") == "progressive")
+                LOG_WARNING(g_logger, "tiles cannot be streamed to disk with the progressive frame renderer.");
+            else
+            {
+                stream_tile_callback_factory.reset(
+                    new StreamingEXRTileCallbackFactory(
+                        g_cl.m_stream_output.value().c_str(),
+                        params.get_optional<size_t>("passes", 1)));
+
+                tile_callback_collection_factory.reset(new TileCallbackCollectionFactory());
+                tile_callback_collection_factory->insert(stream_tile_callback_factory.get());
+                if (tile_callback_factory)
+                    tile_callback_collection_factory->insert(tile_callback_factory.get());
+            }
+        }
+
         SearchPaths resource_search_paths;
         Application::initialize_resource_search_paths(resource_search_paths);
 
@@ -577,7 +746,9 @@ namespace
             project.ref(),
             params,
             resource_search_paths,
-            tile_callback_factory.get());
+            tile_callback_collection_factory
+                ? tile_callback_collection_factory.get()
+                : tile_callback_factory.get());
 
         // Render the frame.
         LOG_INFO(g_logger, "rendering frame...");
@@ -662,6 +833,34 @@ namespace
         return success;
     }
 
+#ifdef APPLESEED_WITH_TRACING
+
+    void start_trace_recording()
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+        recorder.set_current_thread_name("main");
+        recorder.start();
+    }
+
+    bool save_trace()
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+        recorder.stop();
+
+        const char* file_path = g_cl.m_save_trace.value().c_str();
+        LOG_INFO(g_logger, "writing trace to %s...", file_path);
+
+        if (!recorder.write_chrome_trace(file_path))
+        {
+            LOG_ERROR(g_logger, "failed to write trace file %s.", file_path);
+            return false;
+        }
+
+        return true;
+    }
+
+#endif
+
     bool benchmark_render(const std::string& project_filename)
     {
         // Configure our logger.
@@ -764,6 +963,10 @@ int main(int argc, char* argv[])
     // target of the global logger.
     global_logger().initialize_from(g_logger);
 
+    // Keep render threads from contending on the logger's lock.
+    if (g_cl.m_async_logging.is_set())
+        global_logger().set_asynchronous();
+
     bool success = true;
 
     // Run unit tests.
@@ -771,19 +974,38 @@ int main(int argc, char* argv[])
         success = success && run_unit_tests();
 
     // Run unit benchmarks.
+    std::string unit_benchmark_results_path;
     if (g_cl.m_run_unit_benchmarks.is_set())
-        run_unit_benchmarks();
+        unit_benchmark_results_path = run_unit_benchmarks();
+
+    // Compare unit benchmark results.
+    if (g_cl.m_compare_unit_benchmarks.is_set())
+        success = compare_unit_benchmarks(unit_benchmark_results_path) && success;
 
     // Render the specified project.
     if (!g_cl.m_filename.values().empty())
     {
         const std::string project_filename = g_cl.m_filename.value();
 
+#ifdef APPLESEED_WITH_TRACING
+        // Optionally record a timeline of the rendering process, from project loading to image writing.
+        if (g_cl.m_save_trace.is_set())
+            start_trace_recording();
+#endif
+
         if (g_cl.m_benchmark_mode.is_set())
             success = success && benchmark_render(project_filename);
         else success = success && render(project_filename);
+
+#ifdef APPLESEED_WITH_TRACING
+        if (g_cl.m_save_trace.is_set())
+            success = save_trace() && success;
+#endif
     }
 
+    // Write all queued log messages.
+    global_logger().set_asynchronous(false);
+
     const int return_code = success ? 0 : 1;
     LOG_DEBUG(g_logger, "returning code %d.", return_code);
 
@@ -34,16 +34,25 @@
 #include "renderer/api/frame.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/platform/thread.h"
 
+// LZ4 headers.
+#include <lz4.h>
+
 // Standard headers.
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 // Platform headers.
 #ifdef _WIN32
@@ -59,17 +68,223 @@ namespace cli {
 
 namespace
 {
+    // Do not change the values of the enumerators as this WILL break client compabitility.
+    enum ChunkType
+    {
+        // Protocol v2
+        ChunkTypeTileHighlight          = 10,
+        ChunkTypeTilesHeader            = 11,
+        ChunkTypePlaneDefinition        = 12,
+        ChunkTypeTileData               = 13,
+
+        // Protocol v3
+        ChunkTypeCompressedTileData     = 14,
+        ChunkTypeProgressiveUpdate      = 15
+    };
+
+    typedef std::vector<std::uint8_t> Chunk;
+
+    void append(Chunk& chunk, const void* data, const size_t size)
+    {
+        const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+        chunk.insert(chunk.end(), bytes, bytes + size);
+    }
+
+    template <size_t N>
+    void append(Chunk& chunk, const std::uint32_t (&values)[N])
+    {
+        append(chunk, values, sizeof(values));
+    }
+
+    void append_progressive_update(
+        Chunk&              chunk,
+        const size_t        tile_count,
+        const std::uint64_t samples)
+    {
+        // Build and write progressive update footer.
+        // It follows the tiles of a progressive update and carries the total sample count.
+        const size_t chunk_size = 3 * sizeof(std::uint32_t);
+        const std::uint32_t footer[] =
+        {
+            static_cast<std::uint32_t>(ChunkTypeProgressiveUpdate),
+            static_cast<std::uint32_t>(chunk_size),
+            static_cast<std::uint32_t>(tile_count),
+            static_cast<std::uint32_t>(samples & 0xFFFFFFFFu),
+            static_cast<std::uint32_t>(samples >> 32)
+        };
+        append(chunk, footer);
+    }
+
+
+    //
+    // Writes chunks to the standard output from a dedicated thread, so that rendering
+    // threads never wait for the consumer. Chunks queued while a batch is being
+    // written are written together in the next batch, followed by a single flush.
     //
-    // StdOutTileCallbackFactory.
+    // Tiles of progressive updates are coalesced: a tile that was not written yet is
+    // replaced by its newer data, so a slow consumer only delays updates and at most
+    // one copy of each tile is queued. All other chunks, including final tiles, are
+    // written in order and never dropped.
+    //
+
+    class StdOutWriter
+      : public NonCopyable
+    {
+      public:
+        StdOutWriter()
+          : m_progressive_samples(0)
+          , m_progressive_footer(false)
+          , m_done(false)
+          , m_writing(false)
+          , m_thread([this]() { run(); })
+        {
+        }
+
+        ~StdOutWriter()
+        {
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_done = true;
+            }
+
+            m_pending_cond.notify_one();
+            m_thread.join();
+        }
+
+        // Queue a chunk for writing. Never blocks on the consumer.
+        void push(Chunk&& chunk)
+        {
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_pending.push_back(std::move(chunk));
+            }
+
+            m_pending_cond.notify_one();
+        }
+
+        // Queue the tiles of a progressive update, replacing the tiles of previous updates
+        // that were not written yet. If `footer` is true, a progressive update footer with
+        // the number of written tiles and the latest sample count follows them.
+        void push_progressive_update(
+            std::vector<std::pair<size_t, Chunk>>&& tiles,
+            const std::uint64_t samples,
+            const bool          footer)
+        {
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+
+                for (std::pair<size_t, Chunk>& tile : tiles)
+                    m_progressive_tiles[tile.first] = std::move(tile.second);
+
+                m_progressive_samples = samples;
+                m_progressive_footer = footer;
+            }
+
+            m_pending_cond.notify_one();
+        }
+
+        // Wait until all queued chunks have been written.
+        void wait_until_drained()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            while (!m_pending.empty() || !m_progressive_tiles.empty() || m_writing)
+                m_drained_cond.wait(lock);
+        }
+
+      private:
+        boost::mutex                m_mutex;
+        boost::condition_variable   m_pending_cond;
+        boost::condition_variable   m_drained_cond;
+        std::vector<Chunk>          m_pending;
+        std::map<size_t, Chunk>     m_progressive_tiles;    // latest unwritten data, by tile index
+        std::uint64_t               m_progressive_samples;
+        bool                        m_progressive_footer;
+        bool                        m_done;
+        bool                        m_writing;
+        boost::thread               m_thread;
+
+        void run()
+        {
+            set_current_thread_name("stdout");
+
+#ifdef _WIN32
+            const int old_stdout_mode = _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+            std::vector<Chunk> batch;
+            std::map<size_t, Chunk> progressive_tiles;
+            std::uint64_t progressive_samples = 0;
+            bool progressive_footer = false;
+
+            while (true)
+            {
+                {
+                    boost::mutex::scoped_lock lock(m_mutex);
+
+                    while (m_pending.empty() && m_progressive_tiles.empty() && !m_done)
+                        m_pending_cond.wait(lock);
+
+                    if (m_pending.empty() && m_progressive_tiles.empty())
+                        break;
+
+                    batch.swap(m_pending);
+                    progressive_tiles.swap(m_progressive_tiles);
+                    progressive_samples = m_progressive_samples;
+                    progressive_footer = m_progressive_footer;
+                    m_writing = true;
+                }
+
+                for (const Chunk& chunk : batch)
+                    fwrite(chunk.data(), 1, chunk.size(), stdout);
+
+                if (!progressive_tiles.empty())
+                {
+                    for (const auto& tile : progressive_tiles)
+                        fwrite(tile.second.data(), 1, tile.second.size(), stdout);
+
+                    if (progressive_footer)
+                    {
+                        Chunk footer;
+                        append_progressive_update(footer, progressive_tiles.size(), progressive_samples);
+                        fwrite(footer.data(), 1, footer.size(), stdout);
+                    }
+                }
+
+                fflush(stdout);
+
+                batch.clear();
+                progressive_tiles.clear();
+
+                {
+                    boost::mutex::scoped_lock lock(m_mutex);
+                    m_writing = false;
+                }
+
+                m_drained_cond.notify_all();
+            }
+
+#ifdef _WIN32
+            _setmode(_fileno(stdout), old_stdout_mode);
+#endif
+        }
+    };
+
+
+    //
+    // StdOutTileCallback.
     //
 
     class StdOutTileCallback
       : public TileCallbackBase
     {
       public:
-        explicit StdOutTileCallback(StdOutTileCallbackFactory::TileOutputOptions export_options)
+        StdOutTileCallback(
+            const StdOutTileCallbackFactory::TileOutputOptions  export_options,
+            const StdOutTileCallbackFactory::TileCompression    compression)
           : m_header_sent(false)
           , m_export_options(export_options)
+          , m_compression(compression)
         {
         }
 
@@ -79,6 +294,12 @@ namespace
             // Prevent this instance from being destroyed by doing nothing here.
         }
 
+        void on_tiled_frame_end(const Frame* frame) override
+        {
+            // Make sure the whole frame was sent once rendering ends.
+            m_writer.wait_until_drained();
+        }
+
         void on_tile_begin(
             const Frame*        frame,
             const size_t        tile_x,
@@ -86,17 +307,9 @@ namespace
             const size_t        thread_index,
             const size_t        thread_count) override
         {
-            boost::mutex::scoped_lock lock(m_mutex);
-
-#ifdef _WIN32
-            const int old_stdout_mode = _setmode(_fileno(stdout), _O_BINARY);
-#endif
-            send_highlight_tile(*frame, tile_x, tile_y);
-
-            fflush(stdout);
-#ifdef _WIN32
-            _setmode(_fileno(stdout), old_stdout_mode);
-#endif
+            Chunk chunk;
+            append_highlight_tile(chunk, *frame, tile_x, tile_y);
+            m_writer.push(std::move(chunk));
         }
 
         void on_tile_end(
@@ -104,38 +317,64 @@ namespace
             const size_t        tile_x,
             const size_t        tile_y) override
         {
-            boost::mutex::scoped_lock lock(m_mutex);
-
-#ifdef _WIN32
-            const int old_stdout_mode = _setmode(_fileno(stdout), _O_BINARY);
-#endif
             send_header(*frame);
-            send_tile(*frame, tile_x, tile_y);
 
-            fflush(stdout);
-#ifdef _WIN32
-            _setmode(_fileno(stdout), old_stdout_mode);
-#endif
+            Chunk chunk;
+            append_tile(chunk, *frame, tile_x, tile_y);
+            m_writer.push(std::move(chunk));
+        }
+
+        void on_progressive_frame_tiles_update(
+            const Frame&        frame,
+            const double        time,
+            const std::uint64_t samples,
+            const double        samples_per_pixel,
+            const std::uint64_t samples_per_second,
+            const size_t        tile_count,
+            const size_t*       tile_indices) override
+        {
+            if (tile_count == 0)
+                return;
+
+            send_header(frame);
+
+            // Only send the tiles that changed since the last update.
+            std::vector<std::pair<size_t, Chunk>> tiles(tile_count);
+            const size_t tile_count_x = frame.image().properties().m_tile_count_x;
+            for (size_t i = 0; i < tile_count; ++i)
+            {
+                tiles[i].first = tile_indices[i];
+                append_tile(tiles[i].second, frame, tile_indices[i] % tile_count_x, tile_indices[i] / tile_count_x);
+            }
+
+            // In protocol v3, mark the end of the update.
+            m_writer.push_progressive_update(
+                std::move(tiles),
+                samples,
+                m_compression != StdOutTileCallbackFactory::TileCompression::None);
         }
 
       private:
-        // Do not change the values of the enumerators as this WILL break client compabitility.
-        enum ChunkType
+        // Bit flags describing the encoding of compressed tile data.
+        enum TileEncoding
         {
-            // Protocol v2
-            ChunkTypeTileHighlight          = 10,
-            ChunkTypeTilesHeader            = 11,
-            ChunkTypePlaneDefinition        = 12,
-            ChunkTypeTileData               = 13
+            TileEncodingHalf                = 1 << 0,
+            TileEncodingLZ4                 = 1 << 1
         };
 
         boost::mutex m_mutex;
 
         bool m_header_sent;
         const StdOutTileCallbackFactory::TileOutputOptions m_export_options;
+        const StdOutTileCallbackFactory::TileCompression m_compression;
+
+        // Declared last so that queued chunks are written before anything else is destroyed.
+        StdOutWriter m_writer;
 
         void send_header(const Frame& frame)
         {
+            boost::mutex::scoped_lock lock(m_mutex);
+
             if (m_header_sent) return;
 
             // Build and write tiles header.
@@ -149,9 +388,11 @@ namespace
                 static_cast<std::uint32_t>(chunk_size),
                 static_cast<std::uint32_t>(plane_count),
             };
-            fwrite(header, sizeof(header), 1, stdout);
 
-            send_plane_definition(frame.image(), "beauty", 0);
+            Chunk chunk;
+            append(chunk, header);
+
+            append_plane_definition(chunk, frame.image(), "beauty", 0);
 
             if (!beauty_only)
             {
@@ -159,20 +400,25 @@ namespace
                 {
                     const AOV* aov = frame.aovs().get_by_index(i);
 
-                    send_plane_definition(
+                    append_plane_definition(
+                        chunk,
                         aov->get_image(),
                         aov->get_name(),
                         i + 1);
                 }
             }
 
+            // Queue the header while holding the lock so that it precedes all tiles.
+            m_writer.push(std::move(chunk));
+
             m_header_sent = true;
         }
 
-        void send_plane_definition(
+        static void append_plane_definition(
+            Chunk&              chunk,
             const Image&        img,
             const char*         name,
-            const size_t        index) const
+            const size_t        index)
         {
             // Build and write AOV header.
             const size_t name_len = strlen(name);
@@ -185,14 +431,15 @@ namespace
                 static_cast<std::uint32_t>(name_len),
                 static_cast<std::uint32_t>(img.properties().m_channel_count)
             };
-            fwrite(header, sizeof(header), 1, stdout);
-            fwrite(name, sizeof(char), name_len, stdout);
+            append(chunk, header);
+            append(chunk, name, name_len * sizeof(char));
         }
 
-        void send_highlight_tile(
+        static void append_highlight_tile(
+            Chunk&              chunk,
             const Frame&        frame,
             const size_t        tile_x,
-            const size_t        tile_y) const
+            const size_t        tile_y)
         {
             // Compute the coordinates in the image of the top-left corner of the tile.
             const CanvasProperties& frame_props = frame.image().properties();
@@ -216,10 +463,11 @@ namespace
                 static_cast<std::uint32_t>(w),
                 static_cast<std::uint32_t>(h)
             };
-            fwrite(header, sizeof(header), 1, stdout);
+            append(chunk, header);
         }
 
-        void send_tile(
+        void append_tile(
+            Chunk&              chunk,
             const Frame&        frame,
             const size_t        tile_x,
             const size_t        tile_y) const
@@ -228,7 +476,8 @@ namespace
             const CanvasProperties& props = frame.image().properties();
 
             // Send beauty tile.
-            do_send_tile(
+            append_tile(
+                chunk,
                 props,
                 frame.image().tile(tile_x, tile_y),
                 tile_x,
@@ -242,7 +491,8 @@ namespace
                 {
                     const AOV* aov = frame.aovs().get_by_index(i);
 
-                    do_send_tile(
+                    append_tile(
+                        chunk,
                         props,
                         aov->get_image().tile(tile_x, tile_y),
                         tile_x,
@@ -252,12 +502,26 @@ namespace
             }
         }
 
-        void do_send_tile(
+        void append_tile(
+            Chunk&              chunk,
             const CanvasProperties& properties,
             const Tile&         tile,
             const size_t        tile_x,
             const size_t        tile_y,
             const size_t        plane_index) const
+        {
+            if (m_compression == StdOutTileCallbackFactory::TileCompression::None)
+                append_tile_data(chunk, properties, tile, tile_x, tile_y, plane_index);
+            else append_compressed_tile_data(chunk, properties, tile, tile_x, tile_y, plane_index);
+        }
+
+        static void append_tile_data(
+            Chunk&              chunk,
+            const CanvasProperties& properties,
+            const Tile&         tile,
+            const size_t        tile_x,
+            const size_t        tile_y,
+            const size_t        plane_index)
         {
             const size_t x = tile_x * properties.m_tile_width;
             const size_t y = tile_y * properties.m_tile_height;
@@ -281,18 +545,103 @@ namespace
                 static_cast<std::uint32_t>(h),
                 static_cast<std::uint32_t>(c),
             };
-            fwrite(header, sizeof(header), 1, stdout);
+            append(chunk, header);
 
             // Send tile pixels.
-            if (properties.m_pixel_format != PixelFormatFloat)
+            if (tile.get_pixel_format() != PixelFormatFloat)
             {
                 const Tile tmp(tile, PixelFormatFloat);
-                fwrite(tmp.get_storage(), 1, tmp.get_size(), stdout);
+                append(chunk, tmp.get_storage(), tmp.get_size());
             }
             else
             {
-                fwrite(tile.get_storage(), 1, tile.get_size(), stdout);
+                append(chunk, tile.get_storage(), tile.get_size());
+            }
+        }
+
+        void append_compressed_tile_data(
+            Chunk&              chunk,
+            const CanvasProperties& properties,
+            const Tile&         tile,
+            const size_t        tile_x,
+            const size_t        tile_y,
+            const size_t        plane_index) const
+        {
+            const size_t x = tile_x * properties.m_tile_width;
+            const size_t y = tile_y * properties.m_tile_height;
+
+            // Retrieve the tile dimensions.
+            const size_t w = tile.get_width();
+            const size_t h = tile.get_height();
+            const size_t c = tile.get_channel_count();
+
+            const bool use_half =
+                m_compression == StdOutTileCallbackFactory::TileCompression::Half ||
+                m_compression == StdOutTileCallbackFactory::TileCompression::HalfLZ4;
+            const bool use_lz4 =
+                m_compression == StdOutTileCallbackFactory::TileCompression::LZ4 ||
+                m_compression == StdOutTileCallbackFactory::TileCompression::HalfLZ4;
+
+            // Convert tile pixels to the transmitted pixel format.
+            const PixelFormat format = use_half ? PixelFormatHalf : PixelFormatFloat;
+            std::unique_ptr<Tile> converted;
+            if (tile.get_pixel_format() != format)
+                converted.reset(new Tile(tile, format));
+            const Tile& source = converted ? *converted : tile;
+
+            std::uint32_t encoding = use_half ? TileEncodingHalf : 0;
+
+            // Build the header now, the encoding and the payload size are filled below.
+            const size_t header_offset = chunk.size();
+            std::uint32_t header[] =
+            {
+                static_cast<std::uint32_t>(ChunkTypeCompressedTileData),
+                0,
+                static_cast<std::uint32_t>(plane_index),
+                static_cast<std::uint32_t>(x),
+                static_cast<std::uint32_t>(y),
+                static_cast<std::uint32_t>(w),
+                static_cast<std::uint32_t>(h),
+                static_cast<std::uint32_t>(c),
+                0,
+                0
+            };
+            append(chunk, header);
+
+            const size_t payload_offset = chunk.size();
+            size_t payload_size = source.get_size();
+
+            if (use_lz4)
+            {
+                // Compress tile pixels directly into the chunk.
+                const int bound = LZ4_compressBound(static_cast<int>(source.get_size()));
+                chunk.resize(payload_offset + static_cast<size_t>(bound));
+
+                const int compressed_size =
+                    LZ4_compress_default(
+                        reinterpret_cast<const char*>(source.get_storage()),
+                        reinterpret_cast<char*>(&chunk[payload_offset]),
+                        static_cast<int>(source.get_size()),
+                        bound);
+
+                // Keep compressed pixels only if compression was effective.
+                if (compressed_size > 0 && static_cast<size_t>(compressed_size) < source.get_size())
+                {
+                    encoding |= TileEncodingLZ4;
+                    payload_size = static_cast<size_t>(compressed_size);
+                    chunk.resize(payload_offset + payload_size);
+                }
+                else chunk.resize(payload_offset);
             }
+
+            if ((encoding & TileEncodingLZ4) == 0)
+                append(chunk, source.get_storage(), source.get_size());
+
+            // Fill the chunk size, the encoding and the payload size.
+            header[1] = static_cast<std::uint32_t>(8 * sizeof(std::uint32_t) + payload_size);
+            header[8] = encoding;
+            header[9] = static_cast<std::uint32_t>(payload_size);
+            std::memcpy(&chunk[header_offset], header, sizeof(header));
         }
     };
 }
@@ -302,8 +651,10 @@ namespace
 // StdOutTileCallbackFactory class implementation.
 //
 
-StdOutTileCallbackFactory::StdOutTileCallbackFactory(TileOutputOptions export_options)
-  : m_callback(new StdOutTileCallback(export_options))
+StdOutTileCallbackFactory::StdOutTileCallbackFactory(
+    TileOutputOptions   export_options,
+    TileCompression     compression)
+  : m_callback(new StdOutTileCallback(export_options, compression))
 {
 }
 
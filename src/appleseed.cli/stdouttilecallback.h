@@ -47,7 +47,18 @@ class StdOutTileCallbackFactory
         AllAOVs
     };
 
-    explicit StdOutTileCallbackFactory(TileOutputOptions export_options);
+    // Compressing tiles switches to the version 3 of the protocol.
+    enum class TileCompression
+    {
+        None,               // protocol v2: 32-bit floating point pixels
+        Half,               // protocol v3: 16-bit floating point pixels
+        LZ4,                // protocol v3: LZ4-compressed 32-bit floating point pixels
+        HalfLZ4             // protocol v3: LZ4-compressed 16-bit floating point pixels
+    };
+
+    explicit StdOutTileCallbackFactory(
+        TileOutputOptions   export_options,
+        TileCompression     compression = TileCompression::None);
 
     void release() override;
 
@@ -28,19 +28,26 @@
 
 // appleseed.python headers.
 #include "dict2dict.h"
+#include "gillocks.h"
 #include "unalignedtransform.h"
 
 // appleseed.renderer headers.
+#include "renderer/api/log.h"
 #include "renderer/api/object.h"
 #include "renderer/api/scene.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/python.h"
+#include "foundation/platform/system.h"
+#include "foundation/utility/job/parallelloop.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -225,6 +232,289 @@ namespace
 }
 
 
+namespace
+{
+    //
+    // Mesh arrays are sized upfront, then filled in parallel chunks with the GIL released.
+    //
+
+    const size_t ChunkSize = 16 * 1024;
+
+    typedef std::function<void (const size_t, const size_t)> ChunkBody;
+
+    // Create a parallel loop if there is enough work to amortize the cost of starting threads.
+    std::unique_ptr<ParallelLoop> create_parallel_loop(const size_t work_item_count)
+    {
+        const size_t thread_count = System::get_logical_cpu_core_count();
+
+        if (thread_count < 2 || work_item_count < 2 * ChunkSize)
+            return std::unique_ptr<ParallelLoop>();
+
+        return std::unique_ptr<ParallelLoop>(new ParallelLoop(global_logger(), thread_count));
+    }
+
+    // Invoke body(begin, end) on consecutive ranges covering [0, count).
+    void for_each_chunk(
+        ParallelLoop*       loop,
+        const size_t        count,
+        const ChunkBody&    body)
+    {
+        const size_t chunk_count = (count + ChunkSize - 1) / ChunkSize;
+
+        parallel_for(
+            loop,
+            chunk_count,
+            [count, &body](const size_t chunk_index, const size_t)
+            {
+                const size_t begin = chunk_index * ChunkSize;
+                body(begin, std::min(begin + ChunkSize, count));
+            });
+    }
+
+    GVector3 get_vertex_position(const MVert& vert)
+    {
+        return GVector3(vert.co[0], vert.co[1], vert.co[2]);
+    }
+
+    GVector3 get_vertex_normal(const MVert& vert)
+    {
+        return normalize(GVector3(vert.no[0], vert.no[1], vert.no[2]));
+    }
+
+    struct Blender79Mesh
+    {
+        MeshObject*         m_mesh;
+        size_t              m_vert_count;
+        const MVert*        m_vertices;
+        size_t              m_faces_count;
+        const MFace*        m_faces;
+        const MTFace*       m_uv_faces;
+        bool                m_export_normals;
+        bool                m_export_uvs;
+    };
+
+    void fill_mesh_blender79(const Blender79Mesh& bl_mesh, ParallelLoop* loop)
+    {
+        MeshObject& mesh = *bl_mesh.m_mesh;
+
+        const size_t vertex_base = mesh.get_vertex_count();
+        const size_t normal_base = mesh.get_vertex_normal_count();
+        const size_t triangle_base = mesh.get_triangle_count();
+        const size_t tex_coords_base = mesh.get_tex_coords_count();
+
+        mesh.resize_vertices(vertex_base + bl_mesh.m_vert_count);
+        mesh.resize_triangles(triangle_base + bl_mesh.m_faces_count);
+
+        if (bl_mesh.m_export_normals)
+            mesh.resize_vertex_normals(normal_base + bl_mesh.m_vert_count);
+
+        if (bl_mesh.m_export_uvs)
+            mesh.resize_tex_coords(tex_coords_base + 3 * bl_mesh.m_faces_count);
+
+        // Set vertices and normals.
+        for_each_chunk(
+            loop,
+            bl_mesh.m_vert_count,
+            [&](const size_t begin, const size_t end)
+            {
+                for (size_t vertex_index = begin; vertex_index < end; ++vertex_index)
+                {
+                    const MVert& vert = bl_mesh.m_vertices[vertex_index];
+
+                    mesh.set_vertex(vertex_base + vertex_index, get_vertex_position(vert));
+
+                    if (bl_mesh.m_export_normals)
+                        mesh.set_vertex_normal(normal_base + vertex_index, get_vertex_normal(vert));
+                }
+            });
+
+        // Set triangles, with vertex normals tied to vertices and one set of uv coordinates per face corner.
+        // Indices are offset by the sizes of the mesh arrays before this export, in case the mesh wasn't empty.
+        const std::uint32_t vertex_offset = static_cast<std::uint32_t>(vertex_base);
+        const std::uint32_t normal_offset = static_cast<std::uint32_t>(normal_base);
+        for_each_chunk(
+            loop,
+            bl_mesh.m_faces_count,
+            [&](const size_t begin, const size_t end)
+            {
+                for (size_t face_index = begin; face_index < end; ++face_index)
+                {
+                    const MFace& face = bl_mesh.m_faces[face_index];
+                    Triangle tri(
+                        vertex_offset + face.v[0],
+                        vertex_offset + face.v[1],
+                        vertex_offset + face.v[2],
+                        face.mat_nr);
+
+                    if (bl_mesh.m_export_normals)
+                    {
+                        tri.m_n0 = normal_offset + face.v[0];
+                        tri.m_n1 = normal_offset + face.v[1];
+                        tri.m_n2 = normal_offset + face.v[2];
+                    }
+
+                    if (bl_mesh.m_export_uvs)
+                    {
+                        const MTFace& tex_face = bl_mesh.m_uv_faces[face_index];
+                        const std::uint32_t uv_vertex_index = static_cast<std::uint32_t>(tex_coords_base + 3 * face_index);
+
+                        for (size_t i = 0; i < 3; ++i)
+                        {
+                            mesh.set_tex_coords(
+                                uv_vertex_index + i,
+                                GVector2(tex_face.uv[i][0], tex_face.uv[i][1]));
+                        }
+
+                        tri.m_a0 = uv_vertex_index;
+                        tri.m_a1 = uv_vertex_index + 1;
+                        tri.m_a2 = uv_vertex_index + 2;
+                    }
+
+                    mesh.get_triangle(triangle_base + face_index) = tri;
+                }
+            });
+    }
+
+    struct Blender80Mesh
+    {
+        MeshObject*         m_mesh;
+        size_t              m_looptri_count;
+        const MLoopTri*     m_looptris;
+        size_t              m_loop_count;
+        const MLoop*        m_loops;
+        const MPoly*        m_polys;
+        const MVert*        m_vertices;
+        const MLoopUV*      m_loop_uvs;
+        bool                m_export_normals;
+        bool                m_export_uvs;
+    };
+
+    void fill_mesh_blender80(const Blender80Mesh& bl_mesh, ParallelLoop* loop)
+    {
+        MeshObject& mesh = *bl_mesh.m_mesh;
+
+        const size_t vertex_base = mesh.get_vertex_count();
+        const size_t normal_base = mesh.get_vertex_normal_count();
+        const size_t triangle_base = mesh.get_triangle_count();
+        const size_t tex_coords_base = mesh.get_tex_coords_count();
+
+        mesh.resize_vertices(vertex_base + bl_mesh.m_loop_count);
+        mesh.resize_triangles(triangle_base + bl_mesh.m_looptri_count);
+
+        if (bl_mesh.m_export_normals)
+            mesh.resize_vertex_normals(normal_base + bl_mesh.m_loop_count);
+
+        if (bl_mesh.m_export_uvs)
+            mesh.resize_tex_coords(tex_coords_base + bl_mesh.m_loop_count);
+
+        // Set one vertex, normal and uv coordinates per loop.
+        for_each_chunk(
+            loop,
+            bl_mesh.m_loop_count,
+            [&](const size_t begin, const size_t end)
+            {
+                for (size_t loop_index = begin; loop_index < end; ++loop_index)
+                {
+                    const MLoop& bl_loop = bl_mesh.m_loops[loop_index];
+                    const MVert& bl_vert = bl_mesh.m_vertices[bl_loop.v];
+
+                    mesh.set_vertex(vertex_base + loop_index, get_vertex_position(bl_vert));
+
+                    if (bl_mesh.m_export_normals)
+                        mesh.set_vertex_normal(normal_base + loop_index, get_vertex_normal(bl_vert));
+
+                    if (bl_mesh.m_export_uvs)
+                    {
+                        const MLoopUV& bl_loop_uv = bl_mesh.m_loop_uvs[loop_index];
+                        mesh.set_tex_coords(
+                            tex_coords_base + loop_index,
+                            GVector2(bl_loop_uv.uv[0], bl_loop_uv.uv[1]));
+                    }
+                }
+            });
+
+        // Set triangles. Normals and uv coordinates are indexed like vertices.
+        // Indices are offset by the sizes of the mesh arrays before this export, in case the mesh wasn't empty.
+        const std::uint32_t vertex_offset = static_cast<std::uint32_t>(vertex_base);
+        const std::uint32_t normal_offset = static_cast<std::uint32_t>(normal_base);
+        const std::uint32_t tex_coords_offset = static_cast<std::uint32_t>(tex_coords_base);
+        for_each_chunk(
+            loop,
+            bl_mesh.m_looptri_count,
+            [&](const size_t begin, const size_t end)
+            {
+                for (size_t looptri_index = begin; looptri_index < end; ++looptri_index)
+                {
+                    const MLoopTri& bl_looptri = bl_mesh.m_looptris[looptri_index];
+                    const short mat_index = bl_mesh.m_polys[bl_looptri.poly].mat_nr;
+                    Triangle as_tri(
+                        vertex_offset + bl_looptri.tri[0],
+                        vertex_offset + bl_looptri.tri[1],
+                        vertex_offset + bl_looptri.tri[2],
+                        mat_index);
+
+                    if (bl_mesh.m_export_normals)
+                    {
+                        as_tri.m_n0 = normal_offset + bl_looptri.tri[0];
+                        as_tri.m_n1 = normal_offset + bl_looptri.tri[1];
+                        as_tri.m_n2 = normal_offset + bl_looptri.tri[2];
+                    }
+
+                    if (bl_mesh.m_export_uvs)
+                    {
+                        as_tri.m_a0 = tex_coords_offset + bl_looptri.tri[0];
+                        as_tri.m_a1 = tex_coords_offset + bl_looptri.tri[1];
+                        as_tri.m_a2 = tex_coords_offset + bl_looptri.tri[2];
+                    }
+
+                    mesh.get_triangle(triangle_base + looptri_index) = as_tri;
+                }
+            });
+    }
+
+    Blender80Mesh make_blender80_mesh(
+        MeshObject*         blender_mesh,
+        const size_t        bl_looptri_count,
+        const uintptr_t     bl_looptri_ptr,
+        const size_t        bl_loop_count,
+        const uintptr_t     bl_loops_ptr,
+        const uintptr_t     bl_polys_ptr,
+        const uintptr_t     bl_vertices_ptr,
+        const uintptr_t     bl_loops_uv_ptr,
+        const bool          export_normals,
+        const bool          export_uvs)
+    {
+        // Convert uintptr_t numbers to actual pointers.
+        Blender80Mesh bl_mesh;
+        bl_mesh.m_mesh = blender_mesh;
+        bl_mesh.m_looptri_count = bl_looptri_count;
+        bl_mesh.m_looptris = reinterpret_cast<MLoopTri*>(bl_looptri_ptr);
+        bl_mesh.m_loop_count = bl_loop_count;
+        bl_mesh.m_loops = reinterpret_cast<MLoop*>(bl_loops_ptr);
+        bl_mesh.m_polys = reinterpret_cast<MPoly*>(bl_polys_ptr);
+        bl_mesh.m_vertices = reinterpret_cast<MVert*>(bl_vertices_ptr);
+        bl_mesh.m_loop_uvs = reinterpret_cast<MLoopUV*>(bl_loops_uv_ptr);
+        bl_mesh.m_export_normals = export_normals;
+        bl_mesh.m_export_uvs = export_uvs;
+        return bl_mesh;
+    }
+
+    template <typename T>
+    T extract_argument(const bpy::object& args, const size_t index)
+    {
+        bpy::extract<T> ex(args[index]);
+
+        if (!ex.check())
+        {
+            PyErr_SetString(PyExc_TypeError, "Incompatible argument type.");
+            bpy::throw_error_already_set();
+        }
+
+        return ex();
+    }
+}
+
+
 //
 // The following function takes a series of pointers to Blender mesh data
 // and modifies the appleseed MeshObject entity.
@@ -248,70 +538,20 @@ void export_mesh_blender79(
     const bool          export_uvs)
 {
     // Convert uintptr_t numbers to actual pointers.
-    const MVert* bl_vertices = reinterpret_cast<MVert*>(bl_vert_ptr);
-    const MFace* bl_faces = reinterpret_cast<MFace*>(bl_faces_ptr);
-    const MTFace* bl_uv_faces = reinterpret_cast<MTFace*>(bl_uv_ptr);
-
-    blender_mesh->reserve_vertices(bl_vert_count);
-    blender_mesh->reserve_triangles(bl_faces_count);
-
-    // Push vertices.
-    for (size_t vertex_index = 0; vertex_index < bl_vert_count; ++vertex_index)
-    {
-        const MVert& vert = bl_vertices[vertex_index];
-        blender_mesh->push_vertex(GVector3(vert.co[0], vert.co[1], vert.co[2]));
-    }
-
-    // Push normals.
-    if (export_normals)
-    {
-        blender_mesh->reserve_vertex_normals(bl_vert_count);
-        for (size_t vertex_index = 0; vertex_index < bl_vert_count; ++vertex_index)
-        {
-            const MVert& vert = bl_vertices[vertex_index];
-            blender_mesh->push_vertex_normal(normalize(GVector3(vert.no[0], vert.no[1], vert.no[2])));
-        }
-    }
-
-    // Push triangles.
-    for (size_t face_index = 0; face_index < bl_faces_count; ++face_index)
-    {
-        const MFace& face = bl_faces[face_index];
-        blender_mesh->push_triangle(Triangle(face.v[0], face.v[1], face.v[2], face.mat_nr));
-    }
-
-    // Tie vertex normals to mesh faces.
-    if (export_normals)
-    {
-        for (size_t face_index = 0; face_index < bl_faces_count; ++face_index)
-        {
-            const MFace& face = bl_faces[face_index];
-            Triangle& tri = blender_mesh->get_triangle(face_index);
-            tri.m_n0 = face.v[0];
-            tri.m_n1 = face.v[1];
-            tri.m_n2 = face.v[2];
-        }
-    }
-
-    // Tie uv coordinates to mesh faces.
-    if (export_uvs)
-    {
-        std::uint32_t uv_vertex_index = 0;
-        blender_mesh->reserve_tex_coords(bl_vert_count);
-        for (size_t face_index = 0; face_index < bl_faces_count; ++face_index)
-        {
-            const MTFace& tex_face = bl_uv_faces[face_index];
-            Triangle& tri = blender_mesh->get_triangle(face_index);
-            blender_mesh->push_tex_coords(GVector2(tex_face.uv[0][0], tex_face.uv[0][1]));
-            tri.m_a0 = uv_vertex_index++;
-
-            blender_mesh->push_tex_coords(GVector2(tex_face.uv[1][0], tex_face.uv[1][1]));
-            tri.m_a1 = uv_vertex_index++;
-
-            blender_mesh->push_tex_coords(GVector2(tex_face.uv[2][0], tex_face.uv[2][1]));
-            tri.m_a2 = uv_vertex_index++;
-        }
-    }
+    Blender79Mesh bl_mesh;
+    bl_mesh.m_mesh = blender_mesh;
+    bl_mesh.m_vert_count = bl_vert_count;
+    bl_mesh.m_vertices = reinterpret_cast<MVert*>(bl_vert_ptr);
+    bl_mesh.m_faces_count = bl_faces_count;
+    bl_mesh.m_faces = reinterpret_cast<MFace*>(bl_faces_ptr);
+    bl_mesh.m_uv_faces = reinterpret_cast<MTFace*>(bl_uv_ptr);
+    bl_mesh.m_export_normals = export_normals;
+    bl_mesh.m_export_uvs = export_uvs;
+
+    ScopedGILUnlock unlock;
+
+    std::unique_ptr<ParallelLoop> loop(create_parallel_loop(std::max(bl_vert_count, bl_faces_count)));
+    fill_mesh_blender79(bl_mesh, loop.get());
 }
 
 void export_mesh_blender79_pose(
@@ -324,22 +564,34 @@ void export_mesh_blender79_pose(
     // Convert uintptr_t numbers to actual pointers.
     const MVert* bl_vertices = reinterpret_cast<MVert*>(bl_vert_ptr);
 
-    // Push vertices.
-    for (size_t vertex_index = 0; vertex_index < bl_vert_count; ++vertex_index)
-    {
-        const MVert& vert = bl_vertices[vertex_index];
-        blender_mesh->set_vertex_pose(vertex_index, pose, GVector3(vert.co[0], vert.co[1], vert.co[2]));
-    }
+    if (bl_vert_count == 0)
+        return;
 
-    // Push normals.
+    ScopedGILUnlock unlock;
+
+    // Setting the pose of the last vertex first sizes the pose storage,
+    // after which the poses of the other vertices can be set in parallel.
+    const size_t last = bl_vert_count - 1;
+    blender_mesh->set_vertex_pose(last, pose, get_vertex_position(bl_vertices[last]));
     if (export_normals)
-    {
-        for (size_t vertex_index = 0; vertex_index < bl_vert_count; ++vertex_index)
+        blender_mesh->set_vertex_normal_pose(last, pose, get_vertex_normal(bl_vertices[last]));
+
+    std::unique_ptr<ParallelLoop> loop(create_parallel_loop(bl_vert_count));
+    for_each_chunk(
+        loop.get(),
+        last,
+        [&](const size_t begin, const size_t end)
         {
-            const MVert& vert = bl_vertices[vertex_index];
-            blender_mesh->set_vertex_normal_pose(vertex_index, pose, normalize(GVector3(vert.no[0], vert.no[1], vert.no[2])));
-        }
-    }
+            for (size_t vertex_index = begin; vertex_index < end; ++vertex_index)
+            {
+                const MVert& vert = bl_vertices[vertex_index];
+
+                blender_mesh->set_vertex_pose(vertex_index, pose, get_vertex_position(vert));
+
+                if (export_normals)
+                    blender_mesh->set_vertex_normal_pose(vertex_index, pose, get_vertex_normal(vert));
+            }
+        });
 }
 
 void export_mesh_blender80(
@@ -354,70 +606,77 @@ void export_mesh_blender80(
     const bool          export_normals,
     const bool          export_uvs)
 {
-    // Convert uintptr_t numbers to actual pointers.
-    const MLoopTri* bl_looptri_array = reinterpret_cast<MLoopTri*>(bl_looptri_ptr);
-    const MLoop* bl_loop_array = reinterpret_cast<MLoop*>(bl_loops_ptr);
-    const MPoly* bl_poly_array = reinterpret_cast<MPoly*>(bl_polys_ptr);
-    const MVert* bl_vert_array = reinterpret_cast<MVert*>(bl_vertices_ptr);
-    const MLoopUV* bl_loop_uv_array = reinterpret_cast<MLoopUV*>(bl_loops_uv_ptr);
-
-    // Push vertices.
-    blender_mesh->reserve_vertices(bl_loop_count);
+    const Blender80Mesh bl_mesh =
+        make_blender80_mesh(
+            blender_mesh,
+            bl_looptri_count,
+            bl_looptri_ptr,
+            bl_loop_count,
+            bl_loops_ptr,
+            bl_polys_ptr,
+            bl_vertices_ptr,
+            bl_loops_uv_ptr,
+            export_normals,
+            export_uvs);
+
+    ScopedGILUnlock unlock;
+
+    std::unique_ptr<ParallelLoop> loop(create_parallel_loop(std::max(bl_loop_count, bl_looptri_count)));
+    fill_mesh_blender80(bl_mesh, loop.get());
+}
 
-    for (size_t loop_index = 0; loop_index < bl_loop_count; ++loop_index)
-    {
-        const MLoop& bl_loop = bl_loop_array[loop_index];
-        const MVert& bl_vert = bl_vert_array[bl_loop.v];
-        blender_mesh->push_vertex(GVector3(bl_vert.co[0], bl_vert.co[1], bl_vert.co[2]));
-    }
+//
+// Export several meshes concurrently. `meshes` is a list of tuples holding the arguments
+// of export_mesh_blender80(), in the same order. Meshes are distributed over threads;
+// a single mesh is filled in parallel chunks instead.
+//
 
-    // Push faces.
-    blender_mesh->reserve_triangles(bl_looptri_count);
+void export_meshes_blender80(const bpy::list& meshes)
+{
+    std::vector<Blender80Mesh> bl_meshes;
+    size_t total_loop_count = 0;
 
-    for (size_t looptri_index = 0; looptri_index < bl_looptri_count; ++looptri_index)
+    for (bpy::ssize_t i = 0, e = bpy::len(meshes); i < e; ++i)
     {
-        const MLoopTri& bl_looptri = bl_looptri_array[looptri_index];
-        short mat_index = bl_poly_array[bl_looptri.poly].mat_nr;
-        blender_mesh->push_triangle(Triangle(bl_looptri.tri[0], bl_looptri.tri[1], bl_looptri.tri[2], mat_index));
-    }
+        const bpy::object args = meshes[i];
 
-    // Push normals.
-    if (export_normals)
-    {
-        for (size_t loop_index = 0; loop_index < bl_loop_count; ++loop_index)
+        if (bpy::len(args) != 10)
         {
-            const MLoop& bl_loop = bl_loop_array[loop_index];
-            const MVert& bl_vert = bl_vert_array[bl_loop.v];
-            blender_mesh->push_vertex_normal(normalize(GVector3(bl_vert.no[0], bl_vert.no[1], bl_vert.no[2])));
+            PyErr_SetString(PyExc_ValueError, "Each mesh must be described by 10 arguments.");
+            bpy::throw_error_already_set();
         }
 
-        for (size_t looptri_index = 0; looptri_index < bl_looptri_count; ++looptri_index)
-        {
-            const MLoopTri& bl_looptri = bl_looptri_array[looptri_index];
-            Triangle& as_tri = blender_mesh->get_triangle(looptri_index);
-            as_tri.m_n0 = bl_looptri.tri[0];
-            as_tri.m_n1 = bl_looptri.tri[1];
-            as_tri.m_n2 = bl_looptri.tri[2];
-        }
+        bl_meshes.push_back(
+            make_blender80_mesh(
+                extract_argument<MeshObject*>(args, 0),
+                extract_argument<size_t>(args, 1),
+                extract_argument<uintptr_t>(args, 2),
+                extract_argument<size_t>(args, 3),
+                extract_argument<uintptr_t>(args, 4),
+                extract_argument<uintptr_t>(args, 5),
+                extract_argument<uintptr_t>(args, 6),
+                extract_argument<uintptr_t>(args, 7),
+                extract_argument<bool>(args, 8),
+                extract_argument<bool>(args, 9)));
+
+        total_loop_count += bl_meshes.back().m_loop_count;
     }
 
-    // Push UV coordinates.
-    if (export_uvs)
-    {
-        for (size_t loop_index = 0; loop_index < bl_loop_count; ++loop_index)
-        {
-            const MLoopUV& bl_loop_uv = bl_loop_uv_array[loop_index];
-            blender_mesh->push_tex_coords(GVector2(bl_loop_uv.uv[0], bl_loop_uv.uv[1]));
-        }
+    ScopedGILUnlock unlock;
 
-        for (size_t looptri_index = 0; looptri_index < bl_looptri_count; ++looptri_index)
-        {
-            const MLoopTri& bl_looptri = bl_looptri_array[looptri_index];
-            Triangle& as_tri = blender_mesh->get_triangle(looptri_index);
-            as_tri.m_a0 = bl_looptri.tri[0];
-            as_tri.m_a1 = bl_looptri.tri[1];
-            as_tri.m_a2 = bl_looptri.tri[2];
-        }
+    std::unique_ptr<ParallelLoop> loop(create_parallel_loop(total_loop_count));
+
+    if (bl_meshes.size() == 1)
+        fill_mesh_blender80(bl_meshes[0], loop.get());
+    else
+    {
+        parallel_for(
+            loop.get(),
+            bl_meshes.size(),
+            [&bl_meshes](const size_t mesh_index, const size_t)
+            {
+                fill_mesh_blender80(bl_meshes[mesh_index], nullptr);
+            });
     }
 }
 
@@ -433,24 +692,36 @@ void export_mesh_blender80_pose(
     const MVert* bl_vert_array = reinterpret_cast<MVert*>(bl_vert_ptr);
     const MLoop* bl_loop_array = reinterpret_cast<MLoop*>(bl_loop_ptr);
 
-    // Push vertices.
-    for (size_t loop_index = 0; loop_index < bl_loop_count; ++loop_index)
-    {
-        const MLoop& bl_loop = bl_loop_array[loop_index];
-        const MVert& bl_vert = bl_vert_array[bl_loop.v];
-        blender_mesh->set_vertex_pose(loop_index, pose, GVector3(bl_vert.co[0], bl_vert.co[1], bl_vert.co[2]));
-    }
+    if (bl_loop_count == 0)
+        return;
 
-    // Push normals.
+    ScopedGILUnlock unlock;
+
+    // Setting the pose of the last vertex first sizes the pose storage,
+    // after which the poses of the other vertices can be set in parallel.
+    const size_t last = bl_loop_count - 1;
+    const MVert& last_vert = bl_vert_array[bl_loop_array[last].v];
+    blender_mesh->set_vertex_pose(last, pose, get_vertex_position(last_vert));
     if (export_normals)
-    {
-        for (size_t loop_index = 0; loop_index < bl_loop_count; ++loop_index)
+        blender_mesh->set_vertex_normal_pose(last, pose, get_vertex_normal(last_vert));
+
+    std::unique_ptr<ParallelLoop> loop(create_parallel_loop(bl_loop_count));
+    for_each_chunk(
+        loop.get(),
+        last,
+        [&](const size_t begin, const size_t end)
         {
-            const MLoop& bl_loop = bl_loop_array[loop_index];
-            const MVert& bl_vert = bl_vert_array[bl_loop.v];
-            blender_mesh->set_vertex_normal_pose(loop_index, pose, normalize(GVector3(bl_vert.no[0], bl_vert.no[1], bl_vert.no[2])));
-        }
-    }
+            for (size_t loop_index = begin; loop_index < end; ++loop_index)
+            {
+                const MLoop& bl_loop = bl_loop_array[loop_index];
+                const MVert& bl_vert = bl_vert_array[bl_loop.v];
+
+                blender_mesh->set_vertex_pose(loop_index, pose, get_vertex_position(bl_vert));
+
+                if (export_normals)
+                    blender_mesh->set_vertex_normal_pose(loop_index, pose, get_vertex_normal(bl_vert));
+            }
+        });
 }
 
 void bind_blender_export()
@@ -469,5 +740,6 @@ void bind_blender_export()
     bpy::def("export_mesh_blender79", &export_mesh_blender79);
     bpy::def("export_mesh_blender79_pose", &export_mesh_blender79_pose);
     bpy::def("export_mesh_blender80", &export_mesh_blender80);
+    bpy::def("export_meshes_blender80", &export_meshes_blender80);
     bpy::def("export_mesh_blender80_pose", &export_mesh_blender80_pose);
 }
@@ -44,6 +44,7 @@
 #include <glad/glad.h>
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -69,7 +70,8 @@ namespace
         explicit BlenderProgressiveTileCallback(const bpy::object& request_redraw_callback)
           : m_buffer_width(0)
           , m_buffer_height(0)
-          , m_updated_buffer(false)
+          , m_dirty_row_begin(0)
+          , m_dirty_row_end(0)
           , m_texture_width(0)
           , m_texture_height(0)
           , m_request_redraw_callback(request_redraw_callback)
@@ -133,41 +135,53 @@ namespace
             const double            /*samples_per_pixel*/,
             const std::uint64_t     /*samples_per_second*/) override
         {
-            Image& image = frame.image();
-
-            // Realloc the buffer if the image size changed since the last time.
+            const Image& image = frame.image();
             const CanvasProperties& props = image.properties();
 
-            if (props.m_canvas_width != m_buffer_width || props.m_canvas_height != m_buffer_height)
-            {
-                m_buffer_width = props.m_canvas_width;
-                m_buffer_height = props.m_canvas_height;
-                m_buffer.resize(m_buffer_width * m_buffer_height * 4);
-            }
+            resize_buffer(props);
 
-            // Copy the pixels to the buffer.
+            // Copy all tiles to the buffer.
             for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
             {
                 for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
                     copy_tile(image.tile(tx, ty), props, tx, ty);
             }
 
-            m_updated_buffer = true;
+            request_redraw();
+        }
 
-            // Call the request redraw Python callback.
-            if (m_request_redraw_callback)
+        void on_progressive_frame_tiles_update(
+            const Frame&            frame,
+            const double            /*time*/,
+            const std::uint64_t     /*samples*/,
+            const double            /*samples_per_pixel*/,
+            const std::uint64_t     /*samples_per_second*/,
+            const size_t            tile_count,
+            const size_t*           tile_indices) override
+        {
+            const Image& image = frame.image();
+            const CanvasProperties& props = image.properties();
+
+            // A resized buffer must be filled entirely.
+            if (resize_buffer(props))
             {
-                ScopedGILLock lock;
+                on_progressive_frame_update(frame, 0.0, 0, 0.0, 0);
+                return;
+            }
 
-                try
-                {
-                    m_request_redraw_callback();
-                }
-                catch (...)
-                {
-                    // Don't let Python exceptions propagate into C++.
-                }
+            // Nothing to redraw if no tile changed.
+            if (tile_count == 0)
+                return;
+
+            // Copy the tiles that changed to the buffer.
+            for (size_t i = 0; i < tile_count; ++i)
+            {
+                const size_t tx = tile_indices[i] % props.m_tile_count_x;
+                const size_t ty = tile_indices[i] / props.m_tile_count_x;
+                copy_tile(image.tile(tx, ty), props, tx, ty);
             }
+
+            request_redraw();
         }
 
         void draw_pixels()
@@ -180,21 +194,22 @@ namespace
 
             if (m_texture_id != 0)
             {
-                if (m_updated_buffer)
+                if (m_dirty_row_begin < m_dirty_row_end)
                 {
+                    // Only upload the rows of the buffer that changed since the last upload.
                     glBindTexture(GL_TEXTURE_2D, m_texture_id);
-                    glTexImage2D(
+                    glTexSubImage2D(
                         GL_TEXTURE_2D,
                         0,
-                        GL_RGBA32F,
-                        static_cast<GLsizei>(m_texture_width),
-                        static_cast<GLsizei>(m_texture_height),
                         0,
+                        static_cast<GLint>(m_dirty_row_begin),
+                        static_cast<GLsizei>(m_texture_width),
+                        static_cast<GLsizei>(m_dirty_row_end - m_dirty_row_begin),
                         GL_RGBA,
                         GL_FLOAT,
-                        m_buffer.data());
+                        m_buffer.data() + m_dirty_row_begin * m_texture_width * 4);
                     glBindTexture(GL_TEXTURE_2D, 0);
-                    m_updated_buffer = false;
+                    m_dirty_row_begin = m_dirty_row_end = 0;
                 }
 
                 if (!m_updated_data_buffer)
@@ -288,7 +303,8 @@ namespace
         std::vector<float>      m_buffer;
         size_t                  m_buffer_width;
         size_t                  m_buffer_height;
-        bool                    m_updated_buffer;
+        size_t                  m_dirty_row_begin;
+        size_t                  m_dirty_row_end;
 
         GLuint                  m_texture_id;
         size_t                  m_texture_width;
@@ -388,6 +404,41 @@ namespace
                 GL_FLOAT,
                 nullptr);
             glBindTexture(GL_TEXTURE_2D, 0);
+
+            // The new texture must be uploaded entirely.
+            m_dirty_row_begin = 0;
+            m_dirty_row_end = m_texture_height;
+        }
+
+        // Realloc the buffer if the image size changed since the last time. Return true if it did.
+        bool resize_buffer(const CanvasProperties& props)
+        {
+            if (props.m_canvas_width == m_buffer_width && props.m_canvas_height == m_buffer_height)
+                return false;
+
+            m_buffer_width = props.m_canvas_width;
+            m_buffer_height = props.m_canvas_height;
+            m_buffer.resize(m_buffer_width * m_buffer_height * 4);
+
+            return true;
+        }
+
+        void request_redraw()
+        {
+            // Call the request redraw Python callback.
+            if (m_request_redraw_callback)
+            {
+                ScopedGILLock lock;
+
+                try
+                {
+                    m_request_redraw_callback();
+                }
+                catch (...)
+                {
+                    // Don't let Python exceptions propagate into C++.
+                }
+            }
         }
 
         void copy_tile(const Tile& tile, const CanvasProperties& props, const size_t tile_x, const size_t tile_y)
@@ -395,6 +446,19 @@ namespace
             const size_t x0 = tile_x * props.m_tile_width;
             const size_t y0 = tile_y * props.m_tile_height;
 
+            // Extend the range of rows to upload to the texture.
+            const size_t y1 = y0 + tile.get_height();
+            if (m_dirty_row_begin < m_dirty_row_end)
+            {
+                m_dirty_row_begin = std::min(m_dirty_row_begin, y0);
+                m_dirty_row_end = std::max(m_dirty_row_end, y1);
+            }
+            else
+            {
+                m_dirty_row_begin = y0;
+                m_dirty_row_end = y1;
+            }
+
             for (size_t y = 0, ye = tile.get_height(); y < ye; ++y)
             {
                 const size_t offset = (((y0 + y) * props.m_canvas_width) + x0) * 4;
@@ -27,6 +27,10 @@
 // THE SOFTWARE.
 //
 
+// appleseed.python headers.
+#include "gillocks.h"
+#include "pybuffer.h"
+
 // appleseed.renderer headers.
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/tilestack.h"
@@ -40,6 +44,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -132,6 +137,112 @@ namespace
         return c_array_to_py_array(data.get(), tile->get_pixel_format(), tile->get_size());
     }
 
+    // Return the pixel format matching the items of a buffer.
+    PixelFormat get_buffer_pixel_format(const PyBuffer& buffer)
+    {
+        switch (buffer.get_item_type())
+        {
+          case PyBuffer::UInt8:     return PixelFormatUInt8;
+          case PyBuffer::UInt16:    return PixelFormatUInt16;
+          case PyBuffer::UInt32:    return PixelFormatUInt32;
+          case PyBuffer::Half:      return PixelFormatHalf;
+          case PyBuffer::Float32:   return PixelFormatFloat;
+          case PyBuffer::Float64:   return PixelFormatDouble;
+
+          default:
+            PyErr_SetString(PyExc_TypeError, "buffers of signed integers are not supported.");
+            bpy::throw_error_already_set();
+            return PixelFormatUInt8;
+        }
+    }
+
+    // Copy the pixels of a tile into a buffer of width x height x channels components.
+    // Components are converted to the item type of the buffer. The GIL is released while copying.
+    void tile_copy_to_buffer(const Tile* tile, const bpy::object& buffer)
+    {
+        PyBuffer output(buffer, true);
+        const PixelFormat dest_format = get_buffer_pixel_format(output);
+        const size_t value_count = tile->get_pixel_count() * tile->get_channel_count();
+        output.check_item_count(value_count);
+
+        ScopedGILUnlock unlock;
+
+        Pixel::convert(
+            tile->get_pixel_format(),
+            tile->get_storage(),
+            tile->get_storage() + tile->get_size(),
+            1,
+            dest_format,
+            output.get_data(),
+            1);
+    }
+
+    // Copy the pixels of a buffer of width x height x channels components into a tile.
+    // Components are converted to the pixel format of the tile. The GIL is released while copying.
+    void tile_copy_from_buffer(Tile* tile, const bpy::object& buffer)
+    {
+        const PyBuffer input(buffer, false);
+        const PixelFormat src_format = get_buffer_pixel_format(input);
+        const size_t value_count = tile->get_pixel_count() * tile->get_channel_count();
+        input.check_item_count(value_count);
+
+        ScopedGILUnlock unlock;
+
+        const std::uint8_t* src_begin = static_cast<const std::uint8_t*>(input.get_data());
+
+        Pixel::convert(
+            src_format,
+            src_begin,
+            src_begin + value_count * input.get_item_size(),
+            1,
+            tile->get_pixel_format(),
+            tile->get_storage(),
+            1);
+    }
+
+    // Copy the pixels of an image into a buffer of canvas height x canvas width x channels
+    // components. Components are converted to the item type of the buffer. The GIL is released
+    // while copying.
+    void image_copy_to_buffer(const Image* image, const bpy::object& buffer)
+    {
+        const CanvasProperties& props = image->properties();
+
+        PyBuffer output(buffer, true);
+        const PixelFormat dest_format = get_buffer_pixel_format(output);
+        output.check_item_count(props.m_pixel_count * props.m_channel_count);
+
+        ScopedGILUnlock unlock;
+
+        std::uint8_t* dest = static_cast<std::uint8_t*>(output.get_data());
+        const size_t dest_pixel_size = props.m_channel_count * output.get_item_size();
+
+        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        {
+            for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+            {
+                const Tile& tile = image->tile(tx, ty);
+                const size_t row_size =
+                    tile.get_width() * tile.get_channel_count() * Pixel::size(tile.get_pixel_format());
+
+                for (size_t y = 0, h = tile.get_height(); y < h; ++y)
+                {
+                    const size_t image_x = tx * props.m_tile_width;
+                    const size_t image_y = ty * props.m_tile_height + y;
+                    const std::uint8_t* src_begin = tile.pixel(0, y);
+
+                    Pixel::convert(
+                        tile.get_pixel_format(),
+                        src_begin,
+                        src_begin + row_size,
+                        1,
+                        dest_format,
+                        dest + (image_y * props.m_canvas_width + image_x) * dest_pixel_size,
+                        1);
+                }
+            }
+        }
+    }
+
     std::string image_stack_get_name(const ImageStack* image_stack, const size_t index)
     {
         return image_stack->get_name(index);
@@ -176,7 +287,9 @@ void bind_image()
         .def("get_channel_count", &Tile::get_channel_count)
         .def("get_pixel_count", &Tile::get_pixel_count)
         .def("get_size", &Tile::get_size)
-        .def("get_storage", tile_get_storage);
+        .def("get_storage", tile_get_storage)
+        .def("copy_to_buffer", tile_copy_to_buffer)
+        .def("copy_from_buffer", tile_copy_from_buffer);
 
     const Tile& (Image::*image_get_tile)(const size_t, const size_t) const = &Image::tile;
 
@@ -184,7 +297,8 @@ void bind_image()
         .def("__copy__", copy_image, bpy::return_value_policy<bpy::manage_new_object>())
         .def("__deepcopy__", copy_image, bpy::return_value_policy<bpy::manage_new_object>())
         .def("properties", &Image::properties, bpy::return_value_policy<bpy::reference_existing_object>())
-        .def("tile", image_get_tile, bpy::return_value_policy<bpy::reference_existing_object>());
+        .def("tile", image_get_tile, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("copy_to_buffer", image_copy_to_buffer);
 
     const Image& (ImageStack::*image_stack_get_image)(const size_t) const = &ImageStack::get_image;
 
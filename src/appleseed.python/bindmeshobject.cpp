@@ -30,6 +30,8 @@
 // appleseed.python headers.
 #include "bindentitycontainers.h"
 #include "dict2dict.h"
+#include "gillocks.h"
+#include "pybuffer.h"
 
 // appleseed.renderer headers.
 #include "renderer/api/object.h"
@@ -41,6 +43,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace bpy = boost::python;
@@ -127,6 +130,376 @@ namespace
     {
         compute_signature(hash, *mesh);
     }
+
+    //
+    // Bulk accessors.
+    //
+    // They accept any object supporting the buffer protocol, such as NumPy arrays.
+    // Buffers are read and written as flat sequences of components and converted
+    // as needed. The GIL is released while copying.
+    //
+
+    template <typename Vector>
+    Vector read_vector(const PyBuffer& buffer, const size_t index)
+    {
+        Vector v;
+
+        for (size_t i = 0; i < Vector::Dimension; ++i)
+            v[i] = buffer.read<typename Vector::ValueType>(index * Vector::Dimension + i);
+
+        return v;
+    }
+
+    template <typename Vector>
+    void write_vector(PyBuffer& buffer, const size_t index, const Vector& v)
+    {
+        for (size_t i = 0; i < Vector::Dimension; ++i)
+            buffer.write(index * Vector::Dimension + i, v[i]);
+    }
+
+    // Reserving room for exactly the pushed items would reallocate the arrays of the mesh
+    // every time a small buffer is pushed. Only reserve when the array at least doubles in
+    // size, and otherwise let push_back() grow it geometrically.
+    void reserve_for_push(
+        MeshObject*                         object,
+        void (MeshObject::*reserve)(const size_t),
+        const size_t                        current_count,
+        const size_t                        pushed_count)
+    {
+        if (pushed_count >= current_count)
+            (object->*reserve)(current_count + pushed_count);
+    }
+
+    void push_vertices_from_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBuffer input(buffer, false);
+        const size_t count = input.get_group_count(3);
+
+        ScopedGILUnlock unlock;
+
+        reserve_for_push(object, &MeshObject::reserve_vertices, object->get_vertex_count(), count);
+
+        for (size_t i = 0; i < count; ++i)
+            object->push_vertex(read_vector<GVector3>(input, i));
+    }
+
+    void copy_vertices_to_buffer(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBuffer output(buffer, true);
+        const size_t count = object->get_vertex_count();
+        output.check_item_count(count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            write_vector(output, i, object->get_vertex(i));
+    }
+
+    void push_vertex_normals_from_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBuffer input(buffer, false);
+        const size_t count = input.get_group_count(3);
+
+        ScopedGILUnlock unlock;
+
+        reserve_for_push(object, &MeshObject::reserve_vertex_normals, object->get_vertex_normal_count(), count);
+
+        for (size_t i = 0; i < count; ++i)
+            object->push_vertex_normal(read_vector<GVector3>(input, i));
+    }
+
+    void copy_vertex_normals_to_buffer(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBuffer output(buffer, true);
+        const size_t count = object->get_vertex_normal_count();
+        output.check_item_count(count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            write_vector(output, i, object->get_vertex_normal(i));
+    }
+
+    void push_vertex_tangents_from_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBuffer input(buffer, false);
+        const size_t count = input.get_group_count(3);
+
+        ScopedGILUnlock unlock;
+
+        reserve_for_push(object, &MeshObject::reserve_vertex_tangents, object->get_vertex_tangent_count(), count);
+
+        for (size_t i = 0; i < count; ++i)
+            object->push_vertex_tangent(read_vector<GVector3>(input, i));
+    }
+
+    void copy_vertex_tangents_to_buffer(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBuffer output(buffer, true);
+        const size_t count = object->get_vertex_tangent_count();
+        output.check_item_count(count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            write_vector(output, i, object->get_vertex_tangent(i));
+    }
+
+    void push_tex_coords_from_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBuffer input(buffer, false);
+        const size_t count = input.get_group_count(2);
+
+        ScopedGILUnlock unlock;
+
+        reserve_for_push(object, &MeshObject::reserve_tex_coords, object->get_tex_coords_count(), count);
+
+        for (size_t i = 0; i < count; ++i)
+            object->push_tex_coords(read_vector<GVector2>(input, i));
+    }
+
+    void copy_tex_coords_to_buffer(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBuffer output(buffer, true);
+        const size_t count = object->get_tex_coords_count();
+        output.check_item_count(count * 2);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            write_vector(output, i, object->get_tex_coords(i));
+    }
+
+    // Triangle buffers have one of the following layouts, selected by the extent of their
+    // last dimension (one-dimensional buffers use the first layout):
+    //
+    //   3 columns:  v0 v1 v2
+    //   4 columns:  v0 v1 v2 pa
+    //   7 columns:  v0 v1 v2 n0 n1 n2 pa
+    //   10 columns: v0 v1 v2 n0 n1 n2 a0 a1 a2 pa
+    //
+    size_t get_triangle_column_count(const PyBuffer& buffer)
+    {
+        const size_t column_count = buffer.get_column_count(3);
+
+        if (column_count != 3 && column_count != 4 && column_count != 7 && column_count != 10)
+        {
+            PyErr_SetString(PyExc_ValueError, "triangle buffers must have 3, 4, 7 or 10 columns.");
+            bpy::throw_error_already_set();
+        }
+
+        return column_count;
+    }
+
+    void check_triangle_item_type(const PyBuffer& buffer)
+    {
+        if (!buffer.is_integer())
+        {
+            PyErr_SetString(PyExc_TypeError, "triangle buffers must hold integers.");
+            bpy::throw_error_already_set();
+        }
+    }
+
+    const size_t NoInvalidItem = ~size_t(0);
+
+    // Return the position of the first item of a triangle buffer that is not a valid index into
+    // the vertices, vertex normals or texture coordinates of a mesh, or a valid primitive attribute
+    // index, or NoInvalidItem if all items are valid. Vertices, vertex normals and texture
+    // coordinates must be pushed before the triangles that refer to them.
+    size_t find_invalid_triangle_item(
+        const MeshObject&   object,
+        const PyBuffer&     buffer,
+        const size_t        column_count)
+    {
+        // Exclusive upper bound of the items of each column.
+        size_t bounds[10];
+        bounds[0] = bounds[1] = bounds[2] = object.get_vertex_count();
+        if (column_count >= 7)
+            bounds[3] = bounds[4] = bounds[5] = object.get_vertex_normal_count();
+        if (column_count == 10)
+            bounds[6] = bounds[7] = bounds[8] = object.get_tex_coords_count();
+        if (column_count > 3)
+            bounds[column_count - 1] = Triangle::None;
+
+        const bool is_signed = buffer.is_signed_integer();
+
+        for (size_t i = 0, e = buffer.get_item_count(); i < e; ++i)
+        {
+            if (is_signed && buffer.read<std::int64_t>(i) < 0)
+                return i;
+
+            if (buffer.read<std::uint64_t>(i) >= bounds[i % column_count])
+                return i;
+        }
+
+        return NoInvalidItem;
+    }
+
+    void push_triangles_from_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PyBuffer input(buffer, false);
+        check_triangle_item_type(input);
+        const size_t column_count = get_triangle_column_count(input);
+        const size_t count = input.get_group_count(column_count);
+
+        // Check all indices before pushing any triangle so that the mesh is left unchanged on error.
+        size_t invalid_item;
+        {
+            ScopedGILUnlock unlock;
+            invalid_item = find_invalid_triangle_item(*object, input, column_count);
+        }
+
+        if (invalid_item != NoInvalidItem)
+        {
+            const std::string value =
+                input.is_signed_integer()
+                    ? std::to_string(input.read<std::int64_t>(invalid_item))
+                    : std::to_string(input.read<std::uint64_t>(invalid_item));
+
+            PyErr_SetString(
+                PyExc_ValueError,
+                ("invalid index " + value + " at position " + std::to_string(invalid_item) +
+                 " of triangle buffer: indices must be non-negative and refer to existing vertices, "
+                 "vertex normals and texture coordinates.").c_str());
+            bpy::throw_error_already_set();
+        }
+
+        ScopedGILUnlock unlock;
+
+        reserve_for_push(object, &MeshObject::reserve_triangles, object->get_triangle_count(), count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t base = i * column_count;
+
+            switch (column_count)
+            {
+              case 3:
+                object->push_triangle(
+                    Triangle(
+                        input.read<size_t>(base + 0),
+                        input.read<size_t>(base + 1),
+                        input.read<size_t>(base + 2)));
+                break;
+
+              case 4:
+                object->push_triangle(
+                    Triangle(
+                        input.read<size_t>(base + 0),
+                        input.read<size_t>(base + 1),
+                        input.read<size_t>(base + 2),
+                        input.read<size_t>(base + 3)));
+                break;
+
+              case 7:
+                object->push_triangle(
+                    Triangle(
+                        input.read<size_t>(base + 0),
+                        input.read<size_t>(base + 1),
+                        input.read<size_t>(base + 2),
+                        input.read<size_t>(base + 3),
+                        input.read<size_t>(base + 4),
+                        input.read<size_t>(base + 5),
+                        input.read<size_t>(base + 6)));
+                break;
+
+              case 10:
+                object->push_triangle(
+                    Triangle(
+                        input.read<size_t>(base + 0),
+                        input.read<size_t>(base + 1),
+                        input.read<size_t>(base + 2),
+                        input.read<size_t>(base + 3),
+                        input.read<size_t>(base + 4),
+                        input.read<size_t>(base + 5),
+                        input.read<size_t>(base + 6),
+                        input.read<size_t>(base + 7),
+                        input.read<size_t>(base + 8),
+                        input.read<size_t>(base + 9)));
+                break;
+            }
+        }
+    }
+
+    void copy_triangles_to_buffer(const MeshObject* object, const bpy::object& buffer)
+    {
+        PyBuffer output(buffer, true);
+        const size_t column_count = get_triangle_column_count(output);
+        const size_t count = object->get_triangle_count();
+        output.check_item_count(count * column_count);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Triangle& triangle = object->get_triangle(i);
+            size_t index = i * column_count;
+
+            output.write(index++, triangle.m_v0);
+            output.write(index++, triangle.m_v1);
+            output.write(index++, triangle.m_v2);
+
+            if (column_count >= 7)
+            {
+                output.write(index++, triangle.m_n0);
+                output.write(index++, triangle.m_n1);
+                output.write(index++, triangle.m_n2);
+            }
+
+            if (column_count == 10)
+            {
+                output.write(index++, triangle.m_a0);
+                output.write(index++, triangle.m_a1);
+                output.write(index++, triangle.m_a2);
+            }
+
+            if (column_count != 3)
+                output.write(index++, triangle.m_pa);
+        }
+    }
+
+    void check_motion_segment_index(const MeshObject* object, const size_t motion_segment_index)
+    {
+        if (motion_segment_index >= object->get_motion_segment_count())
+        {
+            PyErr_SetString(PyExc_IndexError, "motion segment index out of range.");
+            bpy::throw_error_already_set();
+        }
+    }
+
+    void set_vertex_poses_from_buffer(
+        MeshObject*             object,
+        const size_t            motion_segment_index,
+        const bpy::object&      buffer)
+    {
+        check_motion_segment_index(object, motion_segment_index);
+
+        const PyBuffer input(buffer, false);
+        const size_t count = object->get_vertex_count();
+        input.check_item_count(count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            object->set_vertex_pose(i, motion_segment_index, read_vector<GVector3>(input, i));
+    }
+
+    void copy_vertex_poses_to_buffer(
+        const MeshObject*       object,
+        const size_t            motion_segment_index,
+        const bpy::object&      buffer)
+    {
+        check_motion_segment_index(object, motion_segment_index);
+
+        PyBuffer output(buffer, true);
+        const size_t count = object->get_vertex_count();
+        output.check_item_count(count * 3);
+
+        ScopedGILUnlock unlock;
+
+        for (size_t i = 0; i < count; ++i)
+            write_vector(output, i, object->get_vertex_pose(i, motion_segment_index));
+    }
 }
 
 void bind_mesh_object()
@@ -157,27 +530,37 @@ void bind_mesh_object()
         .def("push_vertex", &MeshObject::push_vertex)
         .def("get_vertex_count", &MeshObject::get_vertex_count)
         .def("get_vertex", &MeshObject::get_vertex, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("push_vertices_from_buffer", push_vertices_from_buffer)
+        .def("copy_vertices_to_buffer", copy_vertices_to_buffer)
 
         .def("reserve_vertex_normals", &MeshObject::reserve_vertex_normals)
         .def("push_vertex_normal", &MeshObject::push_vertex_normal)
         .def("get_vertex_normal_count", &MeshObject::get_vertex_normal_count)
         .def("get_vertex_normal", &MeshObject::get_vertex_normal, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("push_vertex_normals_from_buffer", push_vertex_normals_from_buffer)
+        .def("copy_vertex_normals_to_buffer", copy_vertex_normals_to_buffer)
 
         .def("reserve_vertex_tangents", &MeshObject::reserve_vertex_tangents)
         .def("push_vertex_tangent", &MeshObject::push_vertex_tangent)
         .def("get_vertex_tangent_count", &MeshObject::get_vertex_tangent_count)
         .def("get_vertex_tangent", &MeshObject::get_vertex_tangent)
+        .def("push_vertex_tangents_from_buffer", push_vertex_tangents_from_buffer)
+        .def("copy_vertex_tangents_to_buffer", copy_vertex_tangents_to_buffer)
 
         .def("reserve_tex_coords", &MeshObject::reserve_tex_coords)
         .def("push_tex_coords", &MeshObject::push_tex_coords)
         .def("get_tex_coords_count", &MeshObject::get_tex_coords_count)
         .def("get_tex_coords", &MeshObject::get_tex_coords)
+        .def("push_tex_coords_from_buffer", push_tex_coords_from_buffer)
+        .def("copy_tex_coords_to_buffer", copy_tex_coords_to_buffer)
 
         .def("reserve_triangles", &MeshObject::reserve_triangles)
         .def("push_triangle", &MeshObject::push_triangle)
         .def("get_triangle_count", &MeshObject::get_triangle_count)
         .def("get_triangle", get_triangle, bpy::return_value_policy<bpy::reference_existing_object>())
         .def("set_triangle", set_triangle)
+        .def("push_triangles_from_buffer", push_triangles_from_buffer)
+        .def("copy_triangles_to_buffer", copy_triangles_to_buffer)
 
         .def("set_motion_segment_count", &MeshObject::set_motion_segment_count)
         .def("get_motion_segment_count", &MeshObject::get_motion_segment_count)
@@ -185,6 +568,8 @@ void bind_mesh_object()
         .def("set_vertex_pose", &MeshObject::set_vertex_pose)
         .def("get_vertex_pose", &MeshObject::get_vertex_pose)
         .def("clear_vertex_poses", &MeshObject::clear_vertex_poses)
+        .def("set_vertex_poses_from_buffer", set_vertex_poses_from_buffer)
+        .def("copy_vertex_poses_to_buffer", copy_vertex_poses_to_buffer)
 
         .def("set_vertex_normal_pose", &MeshObject::set_vertex_normal_pose)
         .def("get_vertex_normal_pose", &MeshObject::get_vertex_normal_pose)
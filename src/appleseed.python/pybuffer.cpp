@@ -0,0 +1,148 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "pybuffer.h"
+
+// Standard headers.
+#include <cstring>
+#include <string>
+
+namespace bpy = boost::python;
+
+namespace
+{
+    void raise(PyObject* type, const std::string& message)
+    {
+        PyErr_SetString(type, message.c_str());
+        bpy::throw_error_already_set();
+    }
+
+    bool is_integer_code(const char c)
+    {
+        return std::strchr("bBhHiIlLqQnN", c) != nullptr;
+    }
+
+    bool is_unsigned_integer_code(const char c)
+    {
+        return std::strchr("BHILQN", c) != nullptr;
+    }
+
+    PyBuffer::ItemType parse_item_type(const char* format, const size_t item_size)
+    {
+        // Skip the byte order, size and alignment character, if any.
+        // Only native byte order is supported.
+        if (*format == '@' || *format == '=')
+            ++format;
+        else if (*format == '<' || *format == '>' || *format == '!')
+            raise(PyExc_TypeError, "buffers with non-native byte order are not supported.");
+
+        const char code = format[0];
+
+        if (code == '\0' || format[1] != '\0')
+            raise(PyExc_TypeError, "buffers with compound item formats are not supported.");
+
+        if (code == 'e' && item_size == 2)
+            return PyBuffer::Half;
+
+        if (code == 'f' && item_size == 4)
+            return PyBuffer::Float32;
+
+        if (code == 'd' && item_size == 8)
+            return PyBuffer::Float64;
+
+        if (is_integer_code(code))
+        {
+            const bool is_unsigned = is_unsigned_integer_code(code);
+
+            switch (item_size)
+            {
+              case 1: return is_unsigned ? PyBuffer::UInt8 : PyBuffer::Int8;
+              case 2: return is_unsigned ? PyBuffer::UInt16 : PyBuffer::Int16;
+              case 4: return is_unsigned ? PyBuffer::UInt32 : PyBuffer::Int32;
+              case 8: return is_unsigned ? PyBuffer::UInt64 : PyBuffer::Int64;
+            }
+        }
+
+        raise(PyExc_TypeError, std::string("unsupported buffer item format \"") + format + "\".");
+        return PyBuffer::UInt8;
+    }
+}
+
+PyBuffer::PyBuffer(const bpy::object& object, const bool writable)
+{
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+    if (writable)
+        flags |= PyBUF_WRITABLE;
+
+    if (PyObject_GetBuffer(object.ptr(), &m_buffer, flags) != 0)
+        bpy::throw_error_already_set();
+
+    try
+    {
+        m_item_type =
+            parse_item_type(
+                m_buffer.format != nullptr ? m_buffer.format : "B",
+                static_cast<size_t>(m_buffer.itemsize));
+    }
+    catch (...)
+    {
+        PyBuffer_Release(&m_buffer);
+        throw;
+    }
+
+    m_item_count = static_cast<size_t>(m_buffer.len / m_buffer.itemsize);
+}
+
+PyBuffer::~PyBuffer()
+{
+    PyBuffer_Release(&m_buffer);
+}
+
+size_t PyBuffer::get_group_count(const size_t group_size) const
+{
+    if (m_item_count % group_size != 0)
+    {
+        raise(
+            PyExc_ValueError,
+            "buffer size (" + std::to_string(m_item_count) +
+            " items) is not a multiple of " + std::to_string(group_size) + ".");
+    }
+
+    return m_item_count / group_size;
+}
+
+void PyBuffer::check_item_count(const size_t expected_count) const
+{
+    if (m_item_count != expected_count)
+    {
+        raise(
+            PyExc_ValueError,
+            "buffer size (" + std::to_string(m_item_count) +
+            " items) does not match the expected size (" + std::to_string(expected_count) + " items).");
+    }
+}
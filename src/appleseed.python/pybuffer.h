@@ -0,0 +1,200 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/half.h"
+#include "foundation/platform/python.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+//
+// Scoped access to the memory of a Python object that supports the buffer protocol,
+// such as a NumPy array, an array.array or a bytearray.
+//
+// The buffer must be C-contiguous. Its items are addressed as a flat sequence,
+// regardless of the shape of the buffer. A Python exception is raised if the object
+// does not expose a suitable buffer.
+//
+
+class PyBuffer
+  : public foundation::NonCopyable
+{
+  public:
+    enum ItemType
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Half,
+        Float32,
+        Float64
+    };
+
+    // Constructor. Acquire the buffer, optionally requesting write access.
+    PyBuffer(const boost::python::object& object, const bool writable);
+
+    // Destructor. Release the buffer.
+    ~PyBuffer();
+
+    ItemType get_item_type() const;
+    size_t get_item_size() const;
+    size_t get_item_count() const;
+
+    // Return true if items are integers, and if they are signed integers, respectively.
+    bool is_integer() const;
+    bool is_signed_integer() const;
+
+    // Return the extent of the last dimension of a multidimensional buffer,
+    // or a given default value if the buffer is one-dimensional.
+    size_t get_column_count(const size_t default_count) const;
+
+    const void* get_data() const;
+    void* get_data();
+
+    // Raise a ValueError if the number of items is not a multiple of a given number.
+    // Return the number of groups of items.
+    size_t get_group_count(const size_t group_size) const;
+
+    // Raise a ValueError if the number of items is different from a given number.
+    void check_item_count(const size_t expected_count) const;
+
+    // Read item i, converted to type T.
+    template <typename T>
+    T read(const size_t i) const;
+
+    // Write item i, converted from type T.
+    template <typename T>
+    void write(const size_t i, const T value);
+
+  private:
+    Py_buffer   m_buffer;
+    ItemType    m_item_type;
+    size_t      m_item_count;
+};
+
+
+//
+// PyBuffer class implementation.
+//
+
+inline PyBuffer::ItemType PyBuffer::get_item_type() const
+{
+    return m_item_type;
+}
+
+inline size_t PyBuffer::get_item_size() const
+{
+    return static_cast<size_t>(m_buffer.itemsize);
+}
+
+inline size_t PyBuffer::get_item_count() const
+{
+    return m_item_count;
+}
+
+inline bool PyBuffer::is_integer() const
+{
+    return m_item_type <= UInt64;
+}
+
+inline bool PyBuffer::is_signed_integer() const
+{
+    return
+        m_item_type == Int8 ||
+        m_item_type == Int16 ||
+        m_item_type == Int32 ||
+        m_item_type == Int64;
+}
+
+inline size_t PyBuffer::get_column_count(const size_t default_count) const
+{
+    return
+        m_buffer.ndim > 1 && m_buffer.shape != nullptr
+            ? static_cast<size_t>(m_buffer.shape[m_buffer.ndim - 1])
+            : default_count;
+}
+
+inline const void* PyBuffer::get_data() const
+{
+    return m_buffer.buf;
+}
+
+inline void* PyBuffer::get_data()
+{
+    return m_buffer.buf;
+}
+
+template <typename T>
+inline T PyBuffer::read(const size_t i) const
+{
+    switch (m_item_type)
+    {
+      case Int8:    return static_cast<T>(static_cast<const std::int8_t*>(m_buffer.buf)[i]);
+      case UInt8:   return static_cast<T>(static_cast<const std::uint8_t*>(m_buffer.buf)[i]);
+      case Int16:   return static_cast<T>(static_cast<const std::int16_t*>(m_buffer.buf)[i]);
+      case UInt16:  return static_cast<T>(static_cast<const std::uint16_t*>(m_buffer.buf)[i]);
+      case Int32:   return static_cast<T>(static_cast<const std::int32_t*>(m_buffer.buf)[i]);
+      case UInt32:  return static_cast<T>(static_cast<const std::uint32_t*>(m_buffer.buf)[i]);
+      case Int64:   return static_cast<T>(static_cast<const std::int64_t*>(m_buffer.buf)[i]);
+      case UInt64:  return static_cast<T>(static_cast<const std::uint64_t*>(m_buffer.buf)[i]);
+      case Half:    return static_cast<T>(static_cast<float>(static_cast<const foundation::Half*>(m_buffer.buf)[i]));
+      case Float32: return static_cast<T>(static_cast<const float*>(m_buffer.buf)[i]);
+      case Float64: return static_cast<T>(static_cast<const double*>(m_buffer.buf)[i]);
+      default:      assert(false); return T(0);
+    }
+}
+
+template <typename T>
+inline void PyBuffer::write(const size_t i, const T value)
+{
+    switch (m_item_type)
+    {
+      case Int8:    static_cast<std::int8_t*>(m_buffer.buf)[i] = static_cast<std::int8_t>(value); break;
+      case UInt8:   static_cast<std::uint8_t*>(m_buffer.buf)[i] = static_cast<std::uint8_t>(value); break;
+      case Int16:   static_cast<std::int16_t*>(m_buffer.buf)[i] = static_cast<std::int16_t>(value); break;
+      case UInt16:  static_cast<std::uint16_t*>(m_buffer.buf)[i] = static_cast<std::uint16_t>(value); break;
+      case Int32:   static_cast<std::int32_t*>(m_buffer.buf)[i] = static_cast<std::int32_t>(value); break;
+      case UInt32:  static_cast<std::uint32_t*>(m_buffer.buf)[i] = static_cast<std::uint32_t>(value); break;
+      case Int64:   static_cast<std::int64_t*>(m_buffer.buf)[i] = static_cast<std::int64_t>(value); break;
+      case UInt64:  static_cast<std::uint64_t*>(m_buffer.buf)[i] = static_cast<std::uint64_t>(value); break;
+      case Half:    static_cast<foundation::Half*>(m_buffer.buf)[i] = static_cast<float>(value); break;
+      case Float32: static_cast<float*>(m_buffer.buf)[i] = static_cast<float>(value); break;
+      case Float64: static_cast<double*>(m_buffer.buf)[i] = static_cast<double>(value); break;
+      default:      assert(false); break;
+    }
+}
@@ -0,0 +1,147 @@
+
+#
+# This source file is part of appleseed.
+# Visit https://appleseedhq.net/ for additional information and resources.
+#
+# This software is released under the MIT license.
+# Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+# Copyright (c) 2016-2018 Esteban Tovagliari, The appleseedhq Organization
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+
+import array
+import unittest
+import appleseed as asr
+
+
+class TestMeshObjectBuffers(unittest.TestCase):
+    """
+    Bulk mesh accessors using the buffer protocol.
+    """
+
+    def setUp(self):
+        self.mesh = asr.MeshObject("mesh", {})
+
+    def test_push_vertices_from_buffer(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0, 1, 2, 3, 4, 5]))
+
+        self.assertEqual(self.mesh.get_vertex_count(), 2)
+        v = self.mesh.get_vertex(1)
+        self.assertEqual((v[0], v[1], v[2]), (3, 4, 5))
+
+    def test_copy_vertices_to_buffer(self):
+        self.mesh.push_vertices_from_buffer(array.array('d', [0, 1, 2, 3, 4, 5]))
+
+        result = array.array('f', [0] * 6)
+        self.mesh.copy_vertices_to_buffer(result)
+
+        self.assertEqual(list(result), [0, 1, 2, 3, 4, 5])
+
+    def test_push_vertices_from_buffer_with_incomplete_vertex_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            self.mesh.push_vertices_from_buffer(array.array('f', [0, 1, 2, 3]))
+
+    def test_copy_vertices_to_buffer_with_wrong_size_raises_value_error(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0, 1, 2]))
+
+        with self.assertRaises(ValueError):
+            self.mesh.copy_vertices_to_buffer(array.array('f', [0] * 6))
+
+    def test_push_tex_coords_from_buffer(self):
+        self.mesh.push_tex_coords_from_buffer(array.array('f', [0.25, 0.5, 0.75, 1.0]))
+
+        result = array.array('f', [0] * 4)
+        self.mesh.copy_tex_coords_to_buffer(result)
+
+        self.assertEqual(self.mesh.get_tex_coords_count(), 2)
+        self.assertEqual(list(result), [0.25, 0.5, 0.75, 1.0])
+
+    def test_push_triangles_from_buffer(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 12))
+        self.mesh.push_triangles_from_buffer(array.array('I', [0, 1, 2, 1, 2, 3]))
+
+        self.assertEqual(self.mesh.get_triangle_count(), 2)
+        t = self.mesh.get_triangle(1)
+        self.assertEqual((t.m_v0, t.m_v1, t.m_v2), (1, 2, 3))
+
+        result = array.array('I', [0] * 6)
+        self.mesh.copy_triangles_to_buffer(result)
+
+        self.assertEqual(list(result), [0, 1, 2, 1, 2, 3])
+
+    def test_push_triangles_from_buffer_with_signed_indices(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 9))
+        self.mesh.push_triangles_from_buffer(array.array('i', [0, 1, 2]))
+
+        self.assertEqual(self.mesh.get_triangle_count(), 1)
+
+    def test_push_triangles_from_buffer_with_float_indices_raises_type_error(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 9))
+
+        with self.assertRaises(TypeError):
+            self.mesh.push_triangles_from_buffer(array.array('f', [0, 1, 2]))
+
+    def test_push_triangles_from_buffer_with_negative_index_raises_value_error(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 9))
+
+        with self.assertRaises(ValueError):
+            self.mesh.push_triangles_from_buffer(array.array('i', [0, -1, 2]))
+
+        self.assertEqual(self.mesh.get_triangle_count(), 0)
+
+    def test_push_triangles_from_buffer_with_out_of_range_index_raises_value_error(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 9))
+
+        with self.assertRaises(ValueError):
+            self.mesh.push_triangles_from_buffer(array.array('I', [0, 1, 2, 1, 2, 3]))
+
+        self.assertEqual(self.mesh.get_triangle_count(), 0)
+
+    def test_push_triangles_from_buffer_with_out_of_range_normal_index_raises_value_error(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 9))
+        self.mesh.push_vertex_normals_from_buffer(array.array('f', [0, 0, 1]))
+
+        with self.assertRaises(ValueError):
+            self.mesh.push_triangles_from_buffer(array.array('I', [0, 1, 2, 0, 0, 1, 0]))
+
+    def test_push_triangles_from_buffer_repeatedly(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 9))
+
+        for i in range(100):
+            self.mesh.push_triangles_from_buffer(array.array('I', [0, 1, 2]))
+
+        self.assertEqual(self.mesh.get_triangle_count(), 100)
+
+    def test_set_vertex_poses_from_buffer(self):
+        self.mesh.push_vertices_from_buffer(array.array('f', [0] * 6))
+        self.mesh.set_motion_segment_count(1)
+        self.mesh.set_vertex_poses_from_buffer(0, array.array('f', [1, 2, 3, 4, 5, 6]))
+
+        result = array.array('f', [0] * 6)
+        self.mesh.copy_vertex_poses_to_buffer(0, result)
+
+        self.assertEqual(list(result), [1, 2, 3, 4, 5, 6])
+
+        with self.assertRaises(IndexError):
+            self.mesh.copy_vertex_poses_to_buffer(1, result)
+
+if __name__ == "__main__":
+    unittest.main()
@@ -128,6 +128,7 @@ void ApplicationSettingsWindow::load_settings()
     m_ui->combobox_sampling_mode->setCurrentIndex(
         sampling_mode == "rng" ? 0 :
         sampling_mode == "qmc" ? 1 :
+        sampling_mode == "sobol" ? 2 :
         1);     // "qmc" if an unknown value was found
 
     // Rendering threads.
@@ -179,8 +180,12 @@ void ApplicationSettingsWindow::save_settings()
                                        "fatal");
 
     // Sampling mode.
-    m_settings.insert_path(SETTINGS_SAMPLING_MODE,
-        m_ui->combobox_sampling_mode->currentIndex() == 0 ? "rng" : "qmc");
+    const auto sampling_mode_index = m_ui->combobox_sampling_mode->currentIndex();
+    m_settings.insert_path(
+        SETTINGS_SAMPLING_MODE,
+        sampling_mode_index == 0 ? "rng" :
+        sampling_mode_index == 2 ? "sobol" :
+                                   "qmc");
 
     // Rendering threads.
     std::string rendering_threads_str;
@@ -72,6 +72,7 @@
 #include "foundation/platform/python.h"
 #include "foundation/platform/system.h"
 #include "foundation/utility/foreach.h"
+#include "foundation/utility/job/parallelloop.h"
 
 // Qt headers.
 #include <QAction>
@@ -1318,8 +1319,10 @@ void MainWindow::apply_post_processing_stage(
     OnFrameBeginRecorder recorder;
     if (stage.on_frame_begin(*project, nullptr, recorder, nullptr))
     {
-        // Execute the post-processing stage.
-        stage.execute(working_frame);
+        // Execute the post-processing stage, reusing the same worker threads every time.
+        if (!m_post_processing_loop)
+            m_post_processing_loop.reset(new ParallelLoop(global_logger(), System::get_logical_cpu_core_count()));
+        stage.execute(working_frame, *m_post_processing_loop);
 
         // Blit the frame copy into the render widget.
         for (const_each<RenderTabCollection> i = m_render_tabs; i; ++i)
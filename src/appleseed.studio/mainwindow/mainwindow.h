@@ -65,6 +65,7 @@ namespace appleseed { namespace studio { class AttributeEditor; } }
 namespace appleseed { namespace studio { class LightPathsTab; } }
 namespace appleseed { namespace studio { class MinimizeButton; } }
 namespace appleseed { namespace studio { class ProjectExplorer; } }
+namespace foundation { class ParallelLoop; }
 namespace renderer  { class Project; }
 namespace Ui        { class MainWindow; }
 class QAction;
@@ -155,6 +156,8 @@ class MainWindow
     std::unique_ptr<BenchmarkWindow>            m_benchmark_window;
     std::unique_ptr<FalseColorsWindow>          m_false_colors_window;
 
+    std::unique_ptr<foundation::ParallelLoop>   m_post_processing_loop;
+
     qtcommon::ProjectManager                    m_project_manager;
     ProjectExplorer*                            m_project_explorer;
     QFileSystemWatcher*                         m_project_file_watcher;
@@ -34,15 +34,171 @@
 #include "foundation/utility/foreach.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
-#include <map>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace foundation
 {
 
-typedef std::map<InternedString, std::string> StringMap;
-typedef std::map<InternedString, Dictionary> DictionaryMap;
+namespace
+{
+    //
+    // Items of both kinds of dictionaries are kept in vectors sorted by key.
+    // Keys are compared as C strings, which yields the same order as comparing
+    // interned strings but doesn't require interning keys before looking them up.
+    //
+
+    template <typename Item>
+    struct ItemKeyLess
+    {
+        bool operator()(const Item& lhs, const char* rhs) const
+        {
+            return std::strcmp(lhs.m_key.c_str(), rhs) < 0;
+        }
+    };
+
+    template <typename ItemVector>
+    typename ItemVector::iterator lower_bound_item(ItemVector& items, const char* key)
+    {
+        return
+            std::lower_bound(
+                items.begin(),
+                items.end(),
+                key,
+                ItemKeyLess<typename ItemVector::value_type>());
+    }
+
+    template <typename ItemVector>
+    typename ItemVector::const_iterator lower_bound_item(const ItemVector& items, const char* key)
+    {
+        return
+            std::lower_bound(
+                items.begin(),
+                items.end(),
+                key,
+                ItemKeyLess<typename ItemVector::value_type>());
+    }
+
+    template <typename ItemVector>
+    typename ItemVector::iterator find_item(ItemVector& items, const char* key)
+    {
+        const auto i = lower_bound_item(items, key);
+        return i != items.end() && std::strcmp(i->m_key.c_str(), key) == 0 ? i : items.end();
+    }
+
+    template <typename ItemVector>
+    typename ItemVector::const_iterator find_item(const ItemVector& items, const char* key)
+    {
+        const auto i = lower_bound_item(items, key);
+        return i != items.end() && std::strcmp(i->m_key.c_str(), key) == 0 ? i : items.end();
+    }
+
+    // Return the amount of memory allocated by a string outside of the string object.
+    size_t get_heap_size(const std::string& s)
+    {
+        const char* data = s.data();
+        const char* object_begin = reinterpret_cast<const char*>(&s);
+        const char* object_end = object_begin + sizeof(s);
+
+        return data >= object_begin && data < object_end ? 0 : s.capacity() + 1;
+    }
+}
+
+
+//
+// StringDictionary and DictionaryDictionary internal state.
+//
+
+struct StringDictionary::Impl
+{
+    struct Value
+    {
+        std::string                         m_string;
+        ValueCache                          m_cache;
+    };
+
+    struct Item
+    {
+        InternedString                      m_key;
+        std::unique_ptr<Value>              m_value;    // boxed to keep pointers valid when items move
+
+        Item()
+        {
+        }
+
+        Item(const InternedString& key, const char* value)
+          : m_key(key)
+          , m_value(new Value())
+        {
+            m_value->m_string = value;
+        }
+
+        Item(const Item& rhs)
+          : m_key(rhs.m_key)
+          , m_value(new Value(*rhs.m_value))
+        {
+        }
+
+        Item(Item&& rhs) = default;
+
+        Item& operator=(const Item& rhs)
+        {
+            m_key = rhs.m_key;
+            m_value.reset(new Value(*rhs.m_value));
+            return *this;
+        }
+
+        Item& operator=(Item&& rhs) = default;
+    };
+
+    typedef std::vector<Item> ItemVector;
+
+    ItemVector m_strings;
+};
+
+struct DictionaryDictionary::Impl
+{
+    struct Item
+    {
+        InternedString                      m_key;
+        std::unique_ptr<Dictionary>         m_value;    // boxed to keep references valid when items move
+
+        Item()
+        {
+        }
+
+        Item(const InternedString& key, const Dictionary& value)
+          : m_key(key)
+          , m_value(new Dictionary(value))
+        {
+        }
+
+        Item(const Item& rhs)
+          : m_key(rhs.m_key)
+          , m_value(new Dictionary(*rhs.m_value))
+        {
+        }
+
+        Item(Item&& rhs) = default;
+
+        Item& operator=(const Item& rhs)
+        {
+            m_key = rhs.m_key;
+            m_value.reset(new Dictionary(*rhs.m_value));
+            return *this;
+        }
+
+        Item& operator=(Item&& rhs) = default;
+    };
+
+    typedef std::vector<Item> ItemVector;
+
+    ItemVector m_dictionaries;
+};
 
 
 //
@@ -51,7 +207,7 @@ typedef std::map<InternedString, Dictionary> DictionaryMap;
 
 struct StringDictionary::const_iterator::Impl
 {
-    StringMap::const_iterator m_it;
+    StringDictionary::Impl::ItemVector::const_iterator m_it;
 };
 
 StringDictionary::const_iterator::const_iterator()
@@ -104,12 +260,12 @@ const StringDictionary::const_iterator::value_type& StringDictionary::const_iter
 
 const char* StringDictionary::const_iterator::key() const
 {
-    return impl->m_it->first.c_str();
+    return impl->m_it->m_key.c_str();
 }
 
 const char* StringDictionary::const_iterator::value() const
 {
-    return impl->m_it->second.c_str();
+    return impl->m_it->m_value->m_string.c_str();
 }
 
 
@@ -117,11 +273,6 @@ const char* StringDictionary::const_iterator::value() const
 // StringDictionary class implementation.
 //
 
-struct StringDictionary::Impl
-{
-    StringMap m_strings;
-};
-
 StringDictionary::StringDictionary()
   : impl(new Impl())
 {
@@ -149,11 +300,11 @@ bool StringDictionary::operator==(const StringDictionary& rhs) const
         return false;
 
     for (
-        StringMap::const_iterator it = impl->m_strings.begin(), rhs_it = rhs.impl->m_strings.begin();
+        Impl::ItemVector::const_iterator it = impl->m_strings.begin(), rhs_it = rhs.impl->m_strings.begin();
         it != impl->m_strings.end();
         ++it, ++rhs_it)
     {
-        if (it->first != rhs_it->first || it->second != rhs_it->second)
+        if (it->m_key != rhs_it->m_key || it->m_value->m_string != rhs_it->m_value->m_string)
             return false;
     }
 
@@ -185,7 +336,14 @@ StringDictionary& StringDictionary::insert(const char* key, const char* value)
     assert(key);
     assert(value);
 
-    impl->m_strings[InternedString(key)] = value;
+    const Impl::ItemVector::iterator i = lower_bound_item(impl->m_strings, key);
+
+    if (i != impl->m_strings.end() && std::strcmp(i->m_key.c_str(), key) == 0)
+    {
+        i->m_value->m_string = value;
+        i->m_value->m_cache.clear();
+    }
+    else impl->m_strings.insert(i, Impl::Item(InternedString(key), value));
 
     return *this;
 }
@@ -195,12 +353,13 @@ StringDictionary& StringDictionary::set(const char* key, const char* value)
     assert(key);
     assert(value);
 
-    const StringMap::iterator i = impl->m_strings.find(InternedString(key));
+    const Impl::ItemVector::iterator i = find_item(impl->m_strings, key);
 
     if (i == impl->m_strings.end())
         throw ExceptionDictionaryKeyNotFound(key);
 
-    i->second = value;
+    i->m_value->m_string = value;
+    i->m_value->m_cache.clear();
 
     return *this;
 }
@@ -209,26 +368,40 @@ const char* StringDictionary::get(const char* key) const
 {
     assert(key);
 
-    const StringMap::const_iterator i = impl->m_strings.find(InternedString(key));
+    const Impl::ItemVector::const_iterator i = find_item(impl->m_strings, key);
 
     if (i == impl->m_strings.end())
         throw ExceptionDictionaryKeyNotFound(key);
 
-    return i->second.c_str();
+    return i->m_value->m_string.c_str();
+}
+
+const char* StringDictionary::lookup(const char* key, const ValueCache*& cache) const
+{
+    assert(key);
+
+    const Impl::ItemVector::const_iterator i = find_item(impl->m_strings, key);
+
+    if (i == impl->m_strings.end())
+        throw ExceptionDictionaryKeyNotFound(key);
+
+    cache = &i->m_value->m_cache;
+
+    return i->m_value->m_string.c_str();
 }
 
 bool StringDictionary::exist(const char* key) const
 {
     assert(key);
 
-    return impl->m_strings.find(InternedString(key)) != impl->m_strings.end();
+    return find_item(impl->m_strings, key) != impl->m_strings.end();
 }
 
 StringDictionary& StringDictionary::remove(const char* key)
 {
     assert(key);
 
-    const StringMap::iterator i = impl->m_strings.find(InternedString(key));
+    const Impl::ItemVector::iterator i = find_item(impl->m_strings, key);
 
     if (i != impl->m_strings.end())
         impl->m_strings.erase(i);
@@ -250,6 +423,20 @@ StringDictionary::const_iterator StringDictionary::end() const
     return it;
 }
 
+size_t StringDictionary::get_memory_size() const
+{
+    size_t size =
+        sizeof(*this) +
+        sizeof(Impl) +
+        impl->m_strings.capacity() * sizeof(Impl::Item) +
+        impl->m_strings.size() * sizeof(Impl::Value);
+
+    for (const_each<Impl::ItemVector> i = impl->m_strings; i; ++i)
+        size += get_heap_size(i->m_value->m_string);
+
+    return size;
+}
+
 
 //
 // DictionaryDictionary::iterator class implementation.
@@ -257,7 +444,7 @@ StringDictionary::const_iterator StringDictionary::end() const
 
 struct DictionaryDictionary::iterator::Impl
 {
-    DictionaryMap::iterator m_it;
+    DictionaryDictionary::Impl::ItemVector::iterator m_it;
 };
 
 DictionaryDictionary::iterator::iterator()
@@ -310,12 +497,12 @@ DictionaryDictionary::iterator::value_type& DictionaryDictionary::iterator::oper
 
 const char* DictionaryDictionary::iterator::key() const
 {
-    return impl->m_it->first.c_str();
+    return impl->m_it->m_key.c_str();
 }
 
 Dictionary& DictionaryDictionary::iterator::value()
 {
-    return impl->m_it->second;
+    return *impl->m_it->m_value;
 }
 
 
@@ -325,7 +512,7 @@ Dictionary& DictionaryDictionary::iterator::value()
 
 struct DictionaryDictionary::const_iterator::Impl
 {
-    DictionaryMap::const_iterator m_it;
+    DictionaryDictionary::Impl::ItemVector::const_iterator m_it;
 };
 
 DictionaryDictionary::const_iterator::const_iterator()
@@ -385,12 +572,12 @@ const DictionaryDictionary::const_iterator::value_type& DictionaryDictionary::co
 
 const char* DictionaryDictionary::const_iterator::key() const
 {
-    return impl->m_it->first.c_str();
+    return impl->m_it->m_key.c_str();
 }
 
 const Dictionary& DictionaryDictionary::const_iterator::value() const
 {
-    return impl->m_it->second;
+    return *impl->m_it->m_value;
 }
 
 
@@ -398,11 +585,6 @@ const Dictionary& DictionaryDictionary::const_iterator::value() const
 // DictionaryDictionary class implementation.
 //
 
-struct DictionaryDictionary::Impl
-{
-    DictionaryMap m_dictionaries;
-};
-
 DictionaryDictionary::DictionaryDictionary()
   : impl(new Impl())
 {
@@ -430,11 +612,11 @@ bool DictionaryDictionary::operator==(const DictionaryDictionary& rhs) const
         return false;
 
     for (
-        DictionaryMap::const_iterator it = impl->m_dictionaries.begin(), rhs_it = rhs.impl->m_dictionaries.begin();
+        Impl::ItemVector::const_iterator it = impl->m_dictionaries.begin(), rhs_it = rhs.impl->m_dictionaries.begin();
         it != impl->m_dictionaries.end();
         ++it, ++rhs_it)
     {
-        if (it->first != rhs_it->first || it->second != rhs_it->second)
+        if (it->m_key != rhs_it->m_key || *it->m_value != *rhs_it->m_value)
             return false;
     }
 
@@ -465,7 +647,11 @@ DictionaryDictionary& DictionaryDictionary::insert(const char* key, const Dictio
 {
     assert(key);
 
-    impl->m_dictionaries[InternedString(key)] = value;
+    const Impl::ItemVector::iterator i = lower_bound_item(impl->m_dictionaries, key);
+
+    if (i != impl->m_dictionaries.end() && std::strcmp(i->m_key.c_str(), key) == 0)
+        *i->m_value = value;
+    else impl->m_dictionaries.insert(i, Impl::Item(InternedString(key), value));
 
     return *this;
 }
@@ -474,12 +660,12 @@ DictionaryDictionary& DictionaryDictionary::set(const char* key, const Dictionar
 {
     assert(key);
 
-    const DictionaryMap::iterator i = impl->m_dictionaries.find(InternedString(key));
+    const Impl::ItemVector::iterator i = find_item(impl->m_dictionaries, key);
 
     if (i == impl->m_dictionaries.end())
         throw ExceptionDictionaryKeyNotFound(key);
 
-    i->second = value;
+    *i->m_value = value;
 
     return *this;
 }
@@ -488,38 +674,38 @@ Dictionary& DictionaryDictionary::get(const char* key)
 {
     assert(key);
 
-    const DictionaryMap::iterator i = impl->m_dictionaries.find(InternedString(key));
+    const Impl::ItemVector::iterator i = find_item(impl->m_dictionaries, key);
 
     if (i == impl->m_dictionaries.end())
         throw ExceptionDictionaryKeyNotFound(key);
 
-    return i->second;
+    return *i->m_value;
 }
 
 const Dictionary& DictionaryDictionary::get(const char* key) const
 {
     assert(key);
 
-    const DictionaryMap::const_iterator i = impl->m_dictionaries.find(InternedString(key));
+    const Impl::ItemVector::const_iterator i = find_item(impl->m_dictionaries, key);
 
     if (i == impl->m_dictionaries.end())
         throw ExceptionDictionaryKeyNotFound(key);
 
-    return i->second;
+    return *i->m_value;
 }
 
 bool DictionaryDictionary::exist(const char* key) const
 {
     assert(key);
 
-    return impl->m_dictionaries.find(InternedString(key)) != impl->m_dictionaries.end();
+    return find_item(impl->m_dictionaries, key) != impl->m_dictionaries.end();
 }
 
 DictionaryDictionary& DictionaryDictionary::remove(const char* key)
 {
     assert(key);
 
-    const DictionaryMap::iterator i = impl->m_dictionaries.find(InternedString(key));
+    const Impl::ItemVector::iterator i = find_item(impl->m_dictionaries, key);
 
     if (i != impl->m_dictionaries.end())
         impl->m_dictionaries.erase(i);
@@ -555,6 +741,19 @@ DictionaryDictionary::const_iterator DictionaryDictionary::end() const
     return it;
 }
 
+size_t DictionaryDictionary::get_memory_size() const
+{
+    size_t size =
+        sizeof(*this) +
+        sizeof(Impl) +
+        impl->m_dictionaries.capacity() * sizeof(Impl::Item);
+
+    for (const_each<Impl::ItemVector> i = impl->m_dictionaries; i; ++i)
+        size += i->m_value->get_memory_size();
+
+    return size;
+}
+
 
 //
 // Dictionary class implementation.
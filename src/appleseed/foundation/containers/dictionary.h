@@ -38,7 +38,11 @@
 #include "main/dllsymbol.h"
 
 // Standard headers.
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 // Forward declarations.
 namespace foundation    { class Dictionary; }
@@ -63,6 +67,14 @@ struct ExceptionDictionaryKeyNotFound
 //
 // A string-to-string dictionary that can cross DLL boundaries.
 //
+// Items are stored in a vector sorted by key; keys are interned. Inserting or
+// removing items invalidates iterators, but not pointers to the values of other items.
+//
+// Values are stored as strings. When a value is retrieved as a number or a boolean,
+// the result of the conversion is cached alongside the string so that subsequent
+// retrievals with the same type don't parse the string again. Retrieving values
+// from multiple threads is safe as long as the dictionary is not modified.
+//
 
 class APPLESEED_DLLSYMBOL StringDictionary
 {
@@ -158,15 +170,30 @@ class APPLESEED_DLLSYMBOL StringDictionary
     const_iterator begin() const;
     const_iterator end() const;
 
+    // Return the amount of memory used by the dictionary, in bytes.
+    size_t get_memory_size() const;
+
   private:
     struct Impl;
     Impl* impl;
+
+    class ValueCache;
+
+    // Retrieve an item from the dictionary, as well as the cached conversion of its value.
+    // Throws a ExceptionDictionaryKeyNotFound exception if the item could not be found.
+    const char* lookup(const char* key, const ValueCache*& cache) const;
+
+    template <typename T> T get_value(const char* key, std::true_type cacheable) const;
+    template <typename T> T get_value(const char* key, std::false_type cacheable) const;
 };
 
 
 //
 // A string-to-dictionary dictionary that can cross DLL boundaries.
 //
+// Items are stored in a vector sorted by key; keys are interned. Inserting or
+// removing items invalidates iterators, but not references to child dictionaries.
+//
 
 class APPLESEED_DLLSYMBOL DictionaryDictionary
 {
@@ -308,6 +335,9 @@ class APPLESEED_DLLSYMBOL DictionaryDictionary
     const_iterator begin() const;
     const_iterator end() const;
 
+    // Return the amount of memory used by the dictionary and its child dictionaries, in bytes.
+    size_t get_memory_size() const;
+
   private:
     struct Impl;
     Impl* impl;
@@ -367,6 +397,9 @@ class APPLESEED_DLLSYMBOL Dictionary
     // Returns the dictionary itself to allow chaining of operations.
     Dictionary& merge(const Dictionary& rhs);
 
+    // Return the amount of memory used by the dictionary, in bytes.
+    size_t get_memory_size() const;
+
   private:
     StringDictionary        m_strings;
     DictionaryDictionary    m_dictionaries;
@@ -384,6 +417,102 @@ inline T StringDictionary::const_iterator::value() const
 }
 
 
+//
+// StringDictionary::ValueCache class implementation.
+//
+
+namespace impl
+{
+    // Identify the types whose conversions from strings can be cached.
+    // Types sharing an identifier must share the same conversion function.
+    template <typename T>
+    struct DictionaryValueType
+    {
+        static const std::uint32_t Value =
+            std::is_same<T, bool>::value ? 0x400 :
+            !std::is_arithmetic<T>::value ||
+            std::is_same<T, char>::value ||
+            std::is_same<T, wchar_t>::value ||
+            std::is_same<T, char16_t>::value ||
+            std::is_same<T, char32_t>::value ||
+            sizeof(T) > sizeof(std::uint64_t) ? 0 :
+                (std::is_floating_point<T>::value ? 0x100 : 0) |
+                (std::is_signed<T>::value ? 0x200 : 0) |
+                static_cast<std::uint32_t>(sizeof(T));
+    };
+}
+
+class StringDictionary::ValueCache
+{
+  public:
+    ValueCache()
+      : m_type(Empty)
+      , m_bits(0)
+    {
+    }
+
+    ValueCache(const ValueCache& rhs)
+      : m_type(rhs.m_type.load(std::memory_order_acquire))
+      , m_bits(rhs.m_bits.load(std::memory_order_relaxed))
+    {
+        if (m_type == Busy)
+            m_type = Empty;
+    }
+
+    ValueCache& operator=(const ValueCache& rhs)
+    {
+        const std::uint32_t type = rhs.m_type.load(std::memory_order_acquire);
+        m_bits.store(rhs.m_bits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_type.store(type == Busy ? Empty : type, std::memory_order_relaxed);
+        return *this;
+    }
+
+    // Forget the cached value. Must not be called concurrently with load() or store().
+    void clear()
+    {
+        m_type.store(Empty, std::memory_order_relaxed);
+    }
+
+    // Retrieve the cached value if it was cached with the same type.
+    template <typename T>
+    bool load(T& value) const
+    {
+        if (m_type.load(std::memory_order_acquire) != impl::DictionaryValueType<T>::Value)
+            return false;
+
+        const std::uint64_t bits = m_bits.load(std::memory_order_relaxed);
+        std::memcpy(&value, &bits, sizeof(T));
+
+        return true;
+    }
+
+    // Cache a value, unless a value is already cached. Can be called concurrently.
+    template <typename T>
+    void store(const T value) const
+    {
+        std::uint32_t expected = Empty;
+
+        if (m_type.compare_exchange_strong(expected, Busy, std::memory_order_relaxed))
+        {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(T));
+            m_bits.store(bits, std::memory_order_relaxed);
+            m_type.store(impl::DictionaryValueType<T>::Value, std::memory_order_release);
+        }
+    }
+
+  private:
+    enum : std::uint32_t
+    {
+        Empty = 0,
+        Busy = ~std::uint32_t(0)
+    };
+
+    mutable std::atomic<std::uint32_t>  m_type;
+    mutable std::atomic<std::uint64_t>  m_bits;
+};
+
+
 //
 // StringDictionary class implementation.
 //
@@ -402,6 +531,29 @@ inline StringDictionary& StringDictionary::set(const char* key, const T& value)
 
 template <typename T>
 inline T StringDictionary::get(const char* key) const
+{
+    return get_value<T>(key, std::integral_constant<bool, impl::DictionaryValueType<T>::Value != 0>());
+}
+
+template <typename T>
+inline T StringDictionary::get_value(const char* key, std::true_type) const
+{
+    const ValueCache* cache;
+    const char* s = lookup(key, cache);
+
+    T value;
+
+    if (!cache->load(value))
+    {
+        value = from_string<T>(s);
+        cache->store(value);
+    }
+
+    return value;
+}
+
+template <typename T>
+inline T StringDictionary::get_value(const char* key, std::false_type) const
 {
     return from_string<T>(get(key));
 }
@@ -516,4 +668,9 @@ inline const DictionaryDictionary& Dictionary::dictionaries() const
     return m_dictionaries;
 }
 
+inline size_t Dictionary::get_memory_size() const
+{
+    return m_strings.get_memory_size() + m_dictionaries.get_memory_size();
+}
+
 }   // namespace foundation
@@ -37,11 +37,13 @@
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
 #include "foundation/math/scalar.h"
+#include "foundation/utility/job/parallelloop.h"
 
 // Standard headers.
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <vector>
 
 namespace foundation
 {
@@ -87,31 +89,50 @@ namespace
 
     void accumulate_luminance(
         const Image&    image,
+        ParallelLoop*   loop,
         double&         accumulated_luminance,
         size_t&         relevant_pixel_count)
     {
+        const CanvasProperties& props = image.properties();
+
+        // Accumulate luminance per tile, then sum tiles in a fixed order
+        // so that the result does not depend on the number of threads.
+        std::vector<double> tile_luminances(props.m_tile_count, 0.0);
+        std::vector<size_t> tile_pixel_counts(props.m_tile_count, 0);
+
+        parallel_for(
+            loop,
+            props.m_tile_count,
+            [&](const size_t tile_index, const size_t thread_index)
+            {
+                const size_t tx = tile_index % props.m_tile_count_x;
+                const size_t ty = tile_index / props.m_tile_count_x;
+
+                accumulate_luminance(
+                    image.tile(tx, ty),
+                    tile_luminances[tile_index],
+                    tile_pixel_counts[tile_index]);
+            });
+
         accumulated_luminance = 0.0;
         relevant_pixel_count = 0;
 
-        const CanvasProperties& props = image.properties();
-
-        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        for (size_t i = 0; i < props.m_tile_count; ++i)
         {
-            for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
-            {
-                const Tile& tile = image.tile(tx, ty);
-                accumulate_luminance(tile, accumulated_luminance, relevant_pixel_count);
-            }
+            accumulated_luminance += tile_luminances[i];
+            relevant_pixel_count += tile_pixel_counts[i];
         }
     }
 }
 
-double compute_average_luminance(const Image& image)
+double compute_average_luminance(
+    const Image&    image,
+    ParallelLoop*   loop)
 {
     double accumulated_luminance;
     size_t relevant_pixel_count;
 
-    accumulate_luminance(image, accumulated_luminance, relevant_pixel_count);
+    accumulate_luminance(image, loop, accumulated_luminance, relevant_pixel_count);
 
     return relevant_pixel_count > 0
         ? accumulated_luminance / relevant_pixel_count
@@ -128,29 +149,64 @@ bool are_images_compatible(const Image& image1, const Image& image2)
         props1.m_canvas_height == props2.m_canvas_height;
 }
 
-double compute_rms_deviation(const Image& image1, const Image& image2)
+double compute_rms_deviation(
+    const Image&    image1,
+    const Image&    image2,
+    ParallelLoop*   loop)
 {
     if (!are_images_compatible(image1, image2))
         throw ExceptionIncompatibleImages();
 
-    const CanvasProperties& props = image1.properties();
-    double mse = 0.0;   // mean square error
+    const CanvasProperties& props1 = image1.properties();
+    const CanvasProperties& props2 = image2.properties();
 
-    for (size_t y = 0; y < props.m_canvas_height; ++y)
+    // The images may be tiled differently: make sure all tiles of the second image
+    // exist before they are accessed concurrently from the tiles of the first one.
+    for (size_t ty = 0; ty < props2.m_tile_count_y; ++ty)
     {
-        for (size_t x = 0; x < props.m_canvas_width; ++x)
+        for (size_t tx = 0; tx < props2.m_tile_count_x; ++tx)
+            image2.tile(tx, ty);
+    }
+
+    std::vector<double> tile_square_errors(props1.m_tile_count, 0.0);
+
+    parallel_for(
+        loop,
+        props1.m_tile_count,
+        [&](const size_t tile_index, const size_t thread_index)
         {
-            Color3f color1;
-            image1.get_pixel(x, y, color1);
+            const size_t tx = tile_index % props1.m_tile_count_x;
+            const size_t ty = tile_index / props1.m_tile_count_x;
+            const Tile& tile1 = image1.tile(tx, ty);
 
-            Color3f color2;
-            image2.get_pixel(x, y, color2);
+            const size_t origin_x = tx * props1.m_tile_width;
+            const size_t origin_y = ty * props1.m_tile_height;
 
-            mse += square_distance(color1, color2);
-        }
-    }
+            double square_error = 0.0;
+
+            for (size_t y = 0, h = tile1.get_height(); y < h; ++y)
+            {
+                for (size_t x = 0, w = tile1.get_width(); x < w; ++x)
+                {
+                    Color3f color1;
+                    tile1.get_pixel(x, y, color1);
+
+                    Color3f color2;
+                    image2.get_pixel(origin_x + x, origin_y + y, color2);
+
+                    square_error += square_distance(color1, color2);
+                }
+            }
+
+            tile_square_errors[tile_index] = square_error;
+        });
+
+    double mse = 0.0;   // mean square error
+
+    for (size_t i = 0; i < props1.m_tile_count; ++i)
+        mse += tile_square_errors[i];
 
-    mse /= props.m_pixel_count * 3.0;
+    mse /= props1.m_pixel_count * 3.0;
 
     return std::sqrt(mse);
 }
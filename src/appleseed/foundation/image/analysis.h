@@ -38,6 +38,7 @@
 
 // Forward declarations.
 namespace foundation    { class Image; }
+namespace foundation    { class ParallelLoop; }
 
 namespace foundation
 {
@@ -47,8 +48,11 @@ namespace foundation
 //
 
 // Compute the average Rec. 709 relative luminance of a linear RGBA image.
-// Pixels containing NaN values are skipped.
-APPLESEED_DLLSYMBOL double compute_average_luminance(const Image& image);
+// Pixels containing NaN values are skipped. Tiles are processed in parallel
+// if a parallel loop is provided; the result does not depend on it.
+APPLESEED_DLLSYMBOL double compute_average_luminance(
+    const Image&    image,
+    ParallelLoop*   loop = nullptr);
 
 
 //
@@ -66,6 +70,9 @@ struct ExceptionIncompatibleImages
 
 // Compute the Root-Mean-Square deviation between two images.
 // Throws a foundation::ExceptionIncompatibleImages exception if the images are not compatible.
-APPLESEED_DLLSYMBOL double compute_rms_deviation(const Image& image1, const Image& image2);
+APPLESEED_DLLSYMBOL double compute_rms_deviation(
+    const Image&    image1,
+    const Image&    image2,
+    ParallelLoop*   loop = nullptr);
 
 }   // namespace foundation
@@ -31,50 +31,136 @@
 
 // appleseed.foundation headers.
 #include "foundation/image/colorspace.h"
+#include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
+#include "foundation/image/tile.h"
 #include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/job/parallelloop.h"
 
 // Standard headers.
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <vector>
 
 namespace foundation
 {
 
 namespace
 {
+    // Invoke visitor(tile_index, tile, bbox) on every tile of an image intersecting a crop window,
+    // where bbox is the part of the crop window covered by the tile, in tile coordinates.
+    template <typename ImageType, typename Func>
+    void for_each_tile(
+        ImageType&      image,
+        const AABB2u&   crop_window,
+        ParallelLoop*   loop,
+        const Func&     visitor)
+    {
+        const CanvasProperties& props = image.properties();
+
+        parallel_for(
+            loop,
+            props.m_tile_count,
+            [&](const size_t tile_index, const size_t thread_index)
+            {
+                const size_t tx = tile_index % props.m_tile_count_x;
+                const size_t ty = tile_index / props.m_tile_count_x;
+                const Vector2u origin(tx * props.m_tile_width, ty * props.m_tile_height);
+
+                const AABB2u tile_bbox =
+                    AABB2u::intersect(
+                        crop_window,
+                        AABB2u(
+                            origin,
+                            Vector2u(
+                                origin.x + props.get_tile_width(tx) - 1,
+                                origin.y + props.get_tile_height(ty) - 1)));
+
+                if (tile_bbox.is_valid())
+                {
+                    visitor(
+                        tile_index,
+                        image.tile(tx, ty),
+                        AABB2u(tile_bbox.min - origin, tile_bbox.max - origin));
+                }
+            });
+    }
+
     template <typename Func>
     void for_each_pixel(
         const Image&    image,
         const AABB2u&   crop_window,
+        ParallelLoop*   loop,
         const Func&     visitor)
     {
-        for (size_t y = crop_window.min.y; y <= crop_window.max.y; ++y)
-        {
-            for (size_t x = crop_window.min.x; x <= crop_window.max.x; ++x)
+        for_each_tile(image, crop_window, loop,
+            [&visitor](const size_t tile_index, const Tile& tile, const AABB2u& bbox)
             {
-                Color3f color;
-                image.get_pixel(x, y, color);
-                visitor(color);
-            }
-        }
+                for (size_t y = bbox.min.y; y <= bbox.max.y; ++y)
+                {
+                    for (size_t x = bbox.min.x; x <= bbox.max.x; ++x)
+                    {
+                        Color3f color;
+                        tile.get_pixel(x, y, color);
+                        visitor(tile_index, color);
+                    }
+                }
+            });
     }
 
     template <typename Func>
     void for_each_pixel(
         Image&          image,
         const AABB2u&   crop_window,
+        ParallelLoop*   loop,
         const Func&     mutator)
     {
-        for (size_t y = crop_window.min.y; y <= crop_window.max.y; ++y)
-        {
-            for (size_t x = crop_window.min.x; x <= crop_window.max.x; ++x)
+        for_each_tile(image, crop_window, loop,
+            [&mutator](const size_t tile_index, Tile& tile, const AABB2u& bbox)
             {
-                Color3f color;
-                image.get_pixel(x, y, color);
-                image.set_pixel(x, y, mutator(color));
-            }
+                for (size_t y = bbox.min.y; y <= bbox.max.y; ++y)
+                {
+                    for (size_t x = bbox.min.x; x <= bbox.max.x; ++x)
+                    {
+                        Color3f color;
+                        tile.get_pixel(x, y, color);
+                        tile.set_pixel(x, y, mutator(color));
+                    }
+                }
+            });
+    }
+
+    // Find the range of a scalar function of the pixels, one tile per job.
+    template <typename Func>
+    void find_min_max(
+        const Image&    image,
+        const AABB2u&   crop_window,
+        ParallelLoop*   loop,
+        const Func&     func,
+        float&          min_value,
+        float&          max_value)
+    {
+        const size_t tile_count = image.properties().m_tile_count;
+        std::vector<float> tile_min_values(tile_count, +std::numeric_limits<float>::max());
+        std::vector<float> tile_max_values(tile_count, -std::numeric_limits<float>::max());
+
+        for_each_pixel(image, crop_window, loop,
+            [&func, &tile_min_values, &tile_max_values](const size_t tile_index, const Color3f& color)
+            {
+                const float value = func(color);
+                tile_min_values[tile_index] = std::min(value, tile_min_values[tile_index]);
+                tile_max_values[tile_index] = std::max(value, tile_max_values[tile_index]);
+            });
+
+        min_value = +std::numeric_limits<float>::max();
+        max_value = -std::numeric_limits<float>::max();
+
+        for (size_t i = 0; i < tile_count; ++i)
+        {
+            min_value = std::min(tile_min_values[i], min_value);
+            max_value = std::max(tile_max_values[i], max_value);
         }
     }
 }
@@ -82,57 +168,61 @@ namespace
 void ColorMap::find_min_max_red_channel(
     const Image&    image,
     float&          min_value,
-    float&          max_value)
+    float&          max_value,
+    ParallelLoop*   loop)
 {
     find_min_max_red_channel(
         image,
         get_full_crop_window(image),
         min_value,
-        max_value);
+        max_value,
+        loop);
 }
 
 void ColorMap::find_min_max_red_channel(
     const Image&    image,
     const AABB2u&   crop_window,
     float&          min_value,
-    float&          max_value)
+    float&          max_value,
+    ParallelLoop*   loop)
 {
-    min_value = +std::numeric_limits<float>::max();
-    max_value = -std::numeric_limits<float>::max();
-
-    for_each_pixel(image, crop_window, [&min_value, &max_value](const Color3f& color)
-    {
-        min_value = std::min(color[0], min_value);
-        max_value = std::max(color[0], max_value);
-    });
+    find_min_max(
+        image,
+        crop_window,
+        loop,
+        [](const Color3f& color) { return color[0]; },
+        min_value,
+        max_value);
 }
 
 void ColorMap::find_min_max_relative_luminance(
     const Image&    image,
     float&          min_luminance,
-    float&          max_luminance)
+    float&          max_luminance,
+    ParallelLoop*   loop)
 {
     find_min_max_relative_luminance(
         image,
         get_full_crop_window(image),
         min_luminance,
-        max_luminance);
+        max_luminance,
+        loop);
 }
 
 void ColorMap::find_min_max_relative_luminance(
     const Image&    image,
     const AABB2u&   crop_window,
     float&          min_luminance,
-    float&          max_luminance)
+    float&          max_luminance,
+    ParallelLoop*   loop)
 {
-    min_luminance = +std::numeric_limits<float>::max();
-    max_luminance = -std::numeric_limits<float>::max();
-
-    for_each_pixel(image, crop_window, [&min_luminance, &max_luminance](const Color3f& color)
-    {
-        min_luminance = std::min(luminance(color), min_luminance);
-        max_luminance = std::max(luminance(color), max_luminance);
-    });
+    find_min_max(
+        image,
+        crop_window,
+        loop,
+        [](const Color3f& color) { return luminance(color); },
+        min_luminance,
+        max_luminance);
 }
 
 void ColorMap::set_palette_from_array(const float* values, const size_t entry_count)
@@ -161,26 +251,29 @@ void ColorMap::set_palette_from_image_file(const Image& image)
 void ColorMap::remap_red_channel(
     Image&          image,
     const float     min_value,
-    const float     max_value) const
+    const float     max_value,
+    ParallelLoop*   loop) const
 {
     remap_red_channel(
         image,
         get_full_crop_window(image),
         min_value,
-        max_value);
+        max_value,
+        loop);
 }
 
 void ColorMap::remap_red_channel(
     Image&          image,
     const AABB2u&   crop_window,
     const float     min_value,
-    const float     max_value) const
+    const float     max_value,
+    ParallelLoop*   loop) const
 {
     if (max_value == min_value)
     {
         const Color3f mapped_color = evaluate_palette(0.0f);
 
-        for_each_pixel(image, crop_window, [mapped_color](const Color3f& color)
+        for_each_pixel(image, crop_window, loop, [mapped_color](const Color3f& color)
         {
             return mapped_color;
         });
@@ -189,7 +282,7 @@ void ColorMap::remap_red_channel(
     {
         const float k = 1.0f / (max_value - min_value);
 
-        for_each_pixel(image, crop_window, [this, min_value, k](const Color3f& color)
+        for_each_pixel(image, crop_window, loop, [this, min_value, k](const Color3f& color)
         {
             const float x = saturate((color[0] - min_value) * k);
             return evaluate_palette(x);
@@ -200,26 +293,29 @@ void ColorMap::remap_red_channel(
 void ColorMap::remap_relative_luminance(
     Image&          image,
     const float     min_luminance,
-    const float     max_luminance) const
+    const float     max_luminance,
+    ParallelLoop*   loop) const
 {
     remap_relative_luminance(
         image,
         get_full_crop_window(image),
         min_luminance,
-        max_luminance);
+        max_luminance,
+        loop);
 }
 
 void ColorMap::remap_relative_luminance(
     Image&          image,
     const AABB2u&   crop_window,
     const float     min_luminance,
-    const float     max_luminance) const
+    const float     max_luminance,
+    ParallelLoop*   loop) const
 {
     if (min_luminance == max_luminance)
     {
         const Color3f mapped_color = evaluate_palette(0.0f);
 
-        for_each_pixel(image, crop_window, [mapped_color](const Color3f& color)
+        for_each_pixel(image, crop_window, loop, [mapped_color](const Color3f& color)
         {
             return mapped_color;
         });
@@ -228,7 +324,7 @@ void ColorMap::remap_relative_luminance(
     {
         const float k = 1.0f / (max_luminance - min_luminance);
 
-        for_each_pixel(image, crop_window, [this, min_luminance, k](const Color3f& color)
+        for_each_pixel(image, crop_window, loop, [this, min_luminance, k](const Color3f& color)
         {
             const float x = saturate((luminance(color) - min_luminance) * k);
             return evaluate_palette(x);
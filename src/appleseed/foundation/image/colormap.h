@@ -38,6 +38,7 @@
 
 // Forward declarations.
 namespace foundation { class Image; }
+namespace foundation { class ParallelLoop; }
 
 namespace foundation
 {
@@ -45,25 +46,31 @@ namespace foundation
 class ColorMap
 {
   public:
+    // All methods operating on images process tiles in parallel if a parallel loop is provided.
+
     static void find_min_max_red_channel(
         const Image&    image,
         float&          min_value,
-        float&          max_value);
+        float&          max_value,
+        ParallelLoop*   loop = nullptr);
     static void find_min_max_red_channel(
         const Image&    image,
         const AABB2u&   crop_window,
         float&          min_value,
-        float&          max_value);
+        float&          max_value,
+        ParallelLoop*   loop = nullptr);
 
     static void find_min_max_relative_luminance(
         const Image&    image,
         float&          min_luminance,
-        float&          max_luminance);
+        float&          max_luminance,
+        ParallelLoop*   loop = nullptr);
     static void find_min_max_relative_luminance(
         const Image&    image,
         const AABB2u&   crop_window,
         float&          min_luminance,
-        float&          max_luminance);
+        float&          max_luminance,
+        ParallelLoop*   loop = nullptr);
 
     void set_palette_from_array(
         const float*    values,
@@ -74,22 +81,26 @@ class ColorMap
     void remap_red_channel(
         Image&          image,
         const float     min_val,
-        const float     max_val) const;
+        const float     max_val,
+        ParallelLoop*   loop = nullptr) const;
     void remap_red_channel(
         Image&          image,
         const AABB2u&   crop_window,
         const float     min_val,
-        const float     max_val) const;
+        const float     max_val,
+        ParallelLoop*   loop = nullptr) const;
 
     void remap_relative_luminance(
         Image&          image,
         const float     min_luminance,
-        const float     max_luminance) const;
+        const float     max_luminance,
+        ParallelLoop*   loop = nullptr) const;
     void remap_relative_luminance(
         Image&          image,
         const AABB2u&   crop_window,
         const float     min_luminance,
-        const float     max_luminance) const;
+        const float     max_luminance,
+        ParallelLoop*   loop = nullptr) const;
 
     Color3f evaluate_palette(float x) const;
 
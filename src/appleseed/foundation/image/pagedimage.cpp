@@ -0,0 +1,103 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "pagedimage.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/tile.h"
+#include "foundation/image/tilepager.h"
+
+namespace foundation
+{
+
+//
+// PagedImage class implementation.
+//
+
+PagedImage::PagedImage(
+    const size_t        image_width,
+    const size_t        image_height,
+    const size_t        tile_width,
+    const size_t        tile_height,
+    const size_t        channel_count,
+    const PixelFormat   pixel_format,
+    TilePager&          pager)
+  : Image(
+        image_width,
+        image_height,
+        tile_width,
+        tile_height,
+        channel_count,
+        pixel_format)
+  , m_pager(pager)
+{
+}
+
+Tile& PagedImage::tile(
+    const size_t        tile_x,
+    const size_t        tile_y)
+{
+    const size_t tile_index = tile_y * m_props.m_tile_count_x + tile_x;
+
+    if (m_tiles[tile_index] == nullptr)
+    {
+        const size_t width = m_props.get_tile_width(tile_x);
+        const size_t height = m_props.get_tile_height(tile_y);
+
+        // Storage allocated by the pager is already zero-initialized.
+        m_tiles[tile_index] =
+            new Tile(
+                width,
+                height,
+                m_props.m_channel_count,
+                m_props.m_pixel_format,
+                m_pager.allocate(width * height * m_props.m_pixel_size));
+    }
+
+    return *m_tiles[tile_index];
+}
+
+const Tile& PagedImage::tile(
+    const size_t        tile_x,
+    const size_t        tile_y) const
+{
+    return const_cast<PagedImage*>(this)->tile(tile_x, tile_y);
+}
+
+void PagedImage::release_tile(
+    const size_t        tile_x,
+    const size_t        tile_y)
+{
+    const size_t tile_index = tile_y * m_props.m_tile_count_x + tile_x;
+    const Tile* tile = m_tiles[tile_index];
+
+    if (tile != nullptr)
+        m_pager.release(tile->get_storage(), tile->get_size());
+}
+
+}   // namespace foundation
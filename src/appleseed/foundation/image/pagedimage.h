@@ -0,0 +1,85 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace foundation    { class Tile; }
+namespace foundation    { class TilePager; }
+
+namespace foundation
+{
+
+//
+// An image whose tiles are stored in memory-mapped scratch files managed by a tile pager.
+//
+// Tiles are lazily constructed and initially blank, as with foundation::Image.
+// Once a tile is released, it may be evicted from memory; it is paged back in on access.
+//
+
+class APPLESEED_DLLSYMBOL PagedImage
+  : public Image
+{
+  public:
+    // Construct an empty image.
+    PagedImage(
+        const size_t        image_width,        // image width, in pixels
+        const size_t        image_height,       // image height, in pixels
+        const size_t        tile_width,         // tile width, in pixels
+        const size_t        tile_height,        // tile height, in pixels
+        const size_t        channel_count,
+        const PixelFormat   pixel_format,
+        TilePager&          pager);
+
+    // Direct access to a given tile.
+    Tile& tile(
+        const size_t        tile_x,
+        const size_t        tile_y) override;
+    const Tile& tile(
+        const size_t        tile_x,
+        const size_t        tile_y) const override;
+
+    // Allow a given tile to be evicted from memory. Does nothing if the tile does not exist.
+    void release_tile(
+        const size_t        tile_x,
+        const size_t        tile_y);
+
+  private:
+    TilePager&              m_pager;
+};
+
+}   // namespace foundation
@@ -0,0 +1,413 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "tilepager.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/platform/thread.h"
+
+// Boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Platform headers.
+#if defined _WIN32
+#include "foundation/platform/windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bf = boost::filesystem;
+
+namespace foundation
+{
+
+namespace
+{
+    // Minimum size of a scratch file, in bytes.
+    const std::size_t MinScratchFileSize = 64 * 1024 * 1024;
+
+    std::size_t get_page_size()
+    {
+#if defined _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<std::size_t>(info.dwPageSize);
+#else
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    //
+    // A scratch file mapped into memory in its entirety.
+    //
+
+    class ScratchFile
+      : public NonCopyable
+    {
+      public:
+        ScratchFile(
+            const bf::path&     path,
+            const std::size_t   size)
+          : m_data(nullptr)
+          , m_size(size)
+        {
+#if defined _WIN32
+            // The file is deleted by the system once its last handle is closed.
+            m_file =
+                CreateFileW(
+                    path.wstring().c_str(),
+                    GENERIC_READ | GENERIC_WRITE,
+                    0,
+                    nullptr,
+                    CREATE_NEW,
+                    FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                    nullptr);
+
+            if (m_file == INVALID_HANDLE_VALUE)
+                throw ExceptionIOError("failed to create scratch file", path.string().c_str());
+
+            // Creating the mapping extends the file to the requested (zero-filled) size.
+            m_mapping =
+                CreateFileMappingW(
+                    m_file,
+                    nullptr,
+                    PAGE_READWRITE,
+                    static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+                    static_cast<DWORD>(size & 0xFFFFFFFFUL),
+                    nullptr);
+
+            if (m_mapping == nullptr)
+            {
+                CloseHandle(m_file);
+                throw ExceptionIOError("failed to map scratch file", path.string().c_str());
+            }
+
+            m_data = static_cast<std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+
+            if (m_data == nullptr)
+            {
+                CloseHandle(m_mapping);
+                CloseHandle(m_file);
+                throw ExceptionIOError("failed to map scratch file", path.string().c_str());
+            }
+#else
+            m_fd = open(path.string().c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+            if (m_fd == -1)
+                throw ExceptionIOError("failed to create scratch file", path.string().c_str());
+
+            // Unlink the file right away so that it disappears even if the process crashes.
+            unlink(path.string().c_str());
+
+            // Extending the file does not consume disk space until pages are written back.
+            if (ftruncate(m_fd, static_cast<off_t>(size)) == -1)
+            {
+                close(m_fd);
+                throw ExceptionIOError("failed to resize scratch file", path.string().c_str());
+            }
+
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+            if (data == MAP_FAILED)
+            {
+                close(m_fd);
+                throw ExceptionIOError("failed to map scratch file", path.string().c_str());
+            }
+
+            m_data = static_cast<std::uint8_t*>(data);
+#endif
+        }
+
+        ~ScratchFile()
+        {
+#if defined _WIN32
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+            CloseHandle(m_file);
+#else
+            munmap(m_data, m_size);
+            close(m_fd);
+#endif
+        }
+
+        std::uint8_t* data() const
+        {
+            return m_data;
+        }
+
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        bool contains(const std::uint8_t* block) const
+        {
+            return block >= m_data && block < m_data + m_size;
+        }
+
+        // Write back a range of pages and drop them from memory.
+        void evict(
+            std::uint8_t*       begin,
+            const std::size_t   size)
+        {
+            assert(contains(begin));
+            assert(contains(begin + size - 1));
+
+#if defined _WIN32
+            FlushViewOfFile(begin, size);
+
+            // Unlocking pages that are not locked removes them from the working set.
+            VirtualUnlock(begin, size);
+#else
+            msync(begin, size, MS_SYNC);
+            madvise(begin, size, MADV_DONTNEED);
+
+#if defined __linux__
+            // Pages of shared mappings stay in the page cache after being unmapped.
+            posix_fadvise(m_fd, static_cast<off_t>(begin - m_data), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+#endif
+#endif
+        }
+
+      private:
+#if defined _WIN32
+        HANDLE          m_file;
+        HANDLE          m_mapping;
+#else
+        int             m_fd;
+#endif
+        std::uint8_t*   m_data;
+        std::size_t     m_size;
+    };
+}
+
+
+//
+// TilePager class implementation.
+//
+
+struct TilePager::Impl
+{
+    struct Block
+    {
+        ScratchFile*    m_file;
+        std::uint8_t*   m_begin;
+        std::size_t     m_size;
+    };
+
+    typedef std::unordered_map<const std::uint8_t*, std::size_t> BlockSizeMap;
+
+    const bf::path                              m_scratch_directory;
+    const std::size_t                           m_memory_budget;
+    const std::size_t                           m_page_size;
+
+    boost::mutex                                m_mutex;
+    std::vector<std::unique_ptr<ScratchFile>>   m_files;
+    std::size_t                                 m_file_offset;      // allocation offset in the last scratch file
+    std::size_t                                 m_scratch_size;
+
+    BlockSizeMap                                m_unreleased;       // blocks never released
+    std::size_t                                 m_unreleased_size;
+
+    std::deque<Block>                           m_released;         // oldest first
+    std::unordered_set<const std::uint8_t*>     m_released_set;
+    std::size_t                                 m_released_size;
+
+    Impl(
+        const char*                             scratch_directory,
+        const std::size_t                       memory_budget)
+      : m_scratch_directory(scratch_directory)
+      , m_memory_budget(memory_budget)
+      , m_page_size(get_page_size())
+      , m_file_offset(0)
+      , m_scratch_size(0)
+      , m_unreleased_size(0)
+      , m_released_size(0)
+    {
+    }
+
+    std::size_t round_to_pages(const std::size_t size) const
+    {
+        return ((size + m_page_size - 1) / m_page_size) * m_page_size;
+    }
+
+    ScratchFile* find_file(const std::uint8_t* block) const
+    {
+        for (const auto& file : m_files)
+        {
+            if (file->contains(block))
+                return file.get();
+        }
+
+        return nullptr;
+    }
+
+    static void evict(const std::vector<Block>& blocks)
+    {
+        for (const Block& block : blocks)
+            block.m_file->evict(block.m_begin, block.m_size);
+    }
+};
+
+TilePager::TilePager(
+    const char*         scratch_directory,
+    const std::size_t   memory_budget)
+  : impl(new Impl(scratch_directory, memory_budget))
+{
+}
+
+TilePager::~TilePager()
+{
+    delete impl;
+}
+
+std::size_t TilePager::get_memory_budget() const
+{
+    return impl->m_memory_budget;
+}
+
+std::size_t TilePager::get_scratch_size() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    return impl->m_scratch_size;
+}
+
+std::size_t TilePager::get_resident_size() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    return impl->m_unreleased_size + impl->m_released_size;
+}
+
+std::uint8_t* TilePager::allocate(const std::size_t size)
+{
+    assert(size > 0);
+
+    // Round sizes to whole pages so that evicting a block never affects its neighbors.
+    const std::size_t rounded_size = impl->round_to_pages(size);
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    if (impl->m_files.empty() || impl->m_file_offset + rounded_size > impl->m_files.back()->size())
+    {
+        const std::size_t file_size = impl->round_to_pages(std::max(MinScratchFileSize, rounded_size));
+        const bf::path file_path =
+            impl->m_scratch_directory / bf::unique_path("appleseed-%%%%-%%%%-%%%%-%%%%.scratch");
+
+        impl->m_files.emplace_back(new ScratchFile(file_path, file_size));
+        impl->m_file_offset = 0;
+        impl->m_scratch_size += file_size;
+    }
+
+    std::uint8_t* block = impl->m_files.back()->data() + impl->m_file_offset;
+    impl->m_file_offset += rounded_size;
+
+    impl->m_unreleased.emplace(block, rounded_size);
+    impl->m_unreleased_size += rounded_size;
+
+    return block;
+}
+
+void TilePager::release(
+    std::uint8_t*       block,
+    const std::size_t   size)
+{
+    assert(block);
+    assert(size > 0);
+
+    std::vector<Impl::Block> evicted;
+
+    {
+        boost::mutex::scoped_lock lock(impl->m_mutex);
+
+        // Ignore blocks that were not allocated by this pager.
+        ScratchFile* file = impl->find_file(block);
+        if (file == nullptr)
+            return;
+
+        // The first release of a block moves it from the unreleased blocks to the released ones.
+        const auto unreleased = impl->m_unreleased.find(block);
+        if (unreleased != impl->m_unreleased.end())
+        {
+            impl->m_unreleased_size -= unreleased->second;
+            impl->m_unreleased.erase(unreleased);
+        }
+
+        if (impl->m_released_set.insert(block).second)
+        {
+            const Impl::Block b = { file, block, impl->round_to_pages(size) };
+            impl->m_released.push_back(b);
+            impl->m_released_size += b.m_size;
+        }
+
+        while (!impl->m_released.empty() &&
+               impl->m_unreleased_size + impl->m_released_size > impl->m_memory_budget)
+        {
+            const Impl::Block& b = impl->m_released.front();
+            impl->m_released_set.erase(b.m_begin);
+            impl->m_released_size -= b.m_size;
+            evicted.push_back(b);
+            impl->m_released.pop_front();
+        }
+    }
+
+    // Write back evicted blocks outside of the lock. Blocks remain valid while this happens.
+    Impl::evict(evicted);
+}
+
+void TilePager::evict_all()
+{
+    std::vector<Impl::Block> evicted;
+
+    {
+        boost::mutex::scoped_lock lock(impl->m_mutex);
+
+        evicted.assign(impl->m_released.begin(), impl->m_released.end());
+        impl->m_released.clear();
+        impl->m_released_set.clear();
+        impl->m_released_size = 0;
+    }
+
+    Impl::evict(evicted);
+}
+
+}   // namespace foundation
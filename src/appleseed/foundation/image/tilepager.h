@@ -0,0 +1,102 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+#include <cstdint>
+
+namespace foundation
+{
+
+//
+// Pixel storage backed by memory-mapped scratch files.
+//
+// Blocks are allocated from scratch files that are mapped into memory, so the addresses
+// of blocks never change. The memory budget applies to all blocks known to be resident:
+// blocks that were never released, and released blocks that were not evicted yet. When
+// it is exceeded, released blocks are written back to their scratch file and evicted
+// from memory, oldest first. Blocks that were never released cannot be evicted, so they
+// may exceed the budget on their own.
+//
+// Accessing an evicted block transparently pages it back in. The pager does not see this,
+// so such a block only counts toward the budget again once it is released again.
+//
+// Scratch files are deleted when the pager is destroyed (or when the process terminates).
+//
+
+class APPLESEED_DLLSYMBOL TilePager
+  : public NonCopyable
+{
+  public:
+    // Constructor.
+    TilePager(
+        const char*         scratch_directory,      // directory where scratch files are created
+        const std::size_t   memory_budget);         // in bytes
+
+    // Destructor.
+    ~TilePager();
+
+    // Return the memory budget in bytes.
+    std::size_t get_memory_budget() const;
+
+    // Return the total size of all scratch files in bytes.
+    std::size_t get_scratch_size() const;
+
+    // Return the total size in bytes of the blocks known to be resident in memory.
+    std::size_t get_resident_size() const;
+
+    // Allocate a zero-initialized block of a given size.
+    // Throws foundation::ExceptionIOError if the block cannot be allocated.
+    // Thread-safe.
+    std::uint8_t* allocate(const std::size_t size);
+
+    // Allow a block to be written back to disk and evicted from memory.
+    // The block remains valid and may be accessed (and released) again.
+    // Blocks that were not allocated by this pager are ignored.
+    // Thread-safe.
+    void release(
+        std::uint8_t*       block,
+        const std::size_t   size);
+
+    // Write back and evict all released blocks.
+    // Thread-safe.
+    void evict_all();
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}   // namespace foundation
@@ -41,15 +41,21 @@
 
 // Boost headers.
 #include "boost/date_time/posix_time/posix_time.hpp"
+#include "boost/thread/condition_variable.hpp"
 
 // Standard headers.
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <list>
 #include <map>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 using namespace boost::posix_time;
@@ -195,6 +201,134 @@ namespace
         size_t              m_thread_count;
         ThreadIdToIntMap    m_thread_id_to_int;
     };
+
+    //
+    // A message queued in asynchronous mode.
+    //
+
+    struct LogRecord
+    {
+        LogMessage::Category    m_category;
+        const char*             m_file;
+        size_t                  m_line;
+        ptime                   m_datetime;
+        std::string             m_message;      // capacity is reused from one message to the next
+    };
+
+    //
+    // A fixed-size, single-producer, single-consumer queue of log records.
+    //
+    // Only the thread owning the ring pushes records into it, and only the logger's
+    // background thread pops records from it. Positions only ever increase; they are
+    // published with release stores so that the other side never sees partially
+    // written records.
+    //
+    // The owning thread raises m_writing while it may push a record, so that disabling
+    // asynchronous mode can wait for in-flight writes before delivering the last records.
+    //
+
+    class LogRecordRing
+      : public NonCopyable
+    {
+      public:
+        static const size_t Capacity = 256;
+
+        const size_t            m_thread;           // thread number, as printed in log messages
+        std::atomic<size_t>     m_dropped_count;    // number of messages dropped because the ring was full
+        std::atomic<bool>       m_writing;          // true while the owning thread may push a record
+        std::vector<char>       m_buffer;           // formatting buffer, only accessed by the owning thread
+
+        explicit LogRecordRing(const size_t thread)
+          : m_thread(thread)
+          , m_dropped_count(0)
+          , m_writing(false)
+          , m_head(0)
+          , m_tail(0)
+        {
+        }
+
+        // Producer side: return the record to fill in, or nullptr if the ring is full.
+        LogRecord* begin_push()
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+                return nullptr;
+
+            return &m_records[tail % Capacity];
+        }
+
+        // Producer side: publish the record returned by begin_push().
+        void end_push()
+        {
+            m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Consumer side: return the number of records ready to be popped.
+        size_t size() const
+        {
+            return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_relaxed);
+        }
+
+        // Consumer side: return a given record among those ready to be popped.
+        const LogRecord& operator[](const size_t index) const
+        {
+            return m_records[(m_head.load(std::memory_order_relaxed) + index) % Capacity];
+        }
+
+        // Consumer side: release a given number of records.
+        void pop(const size_t count)
+        {
+            m_head.store(m_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+        }
+
+      private:
+        LogRecord               m_records[Capacity];
+        std::atomic<size_t>     m_head;
+        std::atomic<size_t>     m_tail;
+    };
+
+    //
+    // Rings of the calling thread, one per logger the thread has written to in asynchronous mode.
+    //
+    // A ring is shared between its thread and its logger: a ring only referenced by its logger
+    // belongs to a thread that has exited, a ring only referenced by its thread belongs to a
+    // logger that has been destroyed.
+    //
+
+    typedef std::vector<std::pair<std::uint64_t, std::shared_ptr<LogRecordRing>>> ThreadRingVector;
+
+    thread_local ThreadRingVector t_thread_rings;
+
+    std::atomic<std::uint64_t> g_next_logger_id(0);
+
+    //
+    // Per call site state used to collapse repeated messages and limit message rates.
+    //
+
+    const size_t MaxMessagesPerCallSite = 10;                   // per rate limiting window
+    const time_duration RateLimitingWindow = seconds(1);
+    const time_duration DrainingPeriod = milliseconds(10);
+
+    struct CallSite
+    {
+        LogMessage::Category    m_category;             // category of the last message sent
+        size_t                  m_thread;               // thread of the last message sent
+        std::string             m_last_message;
+        ptime                   m_window_begin;
+        size_t                  m_sent_count;           // number of messages sent in the current window
+        size_t                  m_repeated_count;       // number of repetitions of the last message sent
+        size_t                  m_suppressed_count;     // number of messages suppressed in the current window
+
+        CallSite()
+          : m_category(LogMessage::Info)
+          , m_thread(0)
+          , m_sent_count(0)
+          , m_repeated_count(0)
+          , m_suppressed_count(0)
+        {
+        }
+    };
 }
 
 
@@ -205,14 +339,71 @@ namespace
 struct Logger::Impl
 {
     typedef std::list<ILogTarget*> LogTargetContainer;
+    typedef std::pair<const char*, size_t> CallSiteKey;
+    typedef std::map<CallSiteKey, CallSite> CallSiteMap;
+
+    boost::mutex                                    m_mutex;
+    std::atomic<bool>                               m_enabled;
+    std::atomic<LogMessage::Category>               m_verbosity_level;
+    LogTargetContainer                              m_targets;
+    std::vector<char>                               m_message_buffer;
+    ThreadMap                                       m_thread_map;
+    Formatter                                       m_formatter;
+
+    // Asynchronous mode.
+    const std::uint64_t                             m_id;
+    std::atomic<bool>                               m_asynchronous;
+    boost::mutex                                    m_async_mutex;          // serializes set_asynchronous() calls
+    std::unique_ptr<boost::thread>                  m_draining_thread;
+    boost::mutex                                    m_draining_mutex;
+    boost::condition_variable                       m_draining_event;
+    bool                                            m_stop_requested;       // protected by m_draining_mutex
+    std::uint64_t                                   m_flush_requested;      // protected by m_draining_mutex
+    std::uint64_t                                   m_flush_completed;      // protected by m_draining_mutex
+    boost::mutex                                    m_rings_mutex;
+    std::vector<std::shared_ptr<LogRecordRing>>     m_rings;                // protected by m_rings_mutex
+    CallSiteMap                                     m_call_sites;           // only accessed by the draining thread
+
+    Impl()
+      : m_id(g_next_logger_id++)
+      , m_asynchronous(false)
+      , m_stop_requested(false)
+      , m_flush_requested(0)
+      , m_flush_completed(0)
+    {
+    }
 
-    boost::mutex            m_mutex;
-    bool                    m_enabled;
-    LogMessage::Category    m_verbosity_level;
-    LogTargetContainer      m_targets;
-    std::vector<char>       m_message_buffer;
-    ThreadMap               m_thread_map;
-    Formatter               m_formatter;
+    // Format a message and send it to all log targets. The caller must hold m_mutex.
+    void send(
+        const LogMessage::Category  category,
+        const char*                 file,
+        const size_t                line,
+        const ptime&                datetime,
+        const size_t                thread,
+        const char*                 message);
+
+    // Return the ring of the calling thread, creating it if necessary.
+    LogRecordRing& get_thread_ring();
+
+    // Queue a message into the ring of the calling thread.
+    // Returns false if asynchronous mode was disabled in the meantime.
+    bool enqueue(
+        const LogMessage::Category  category,
+        const char*                 file,
+        const size_t                line,
+        const char*                 format,
+        va_list                     argptr);
+
+    // Send queued messages to log targets. Runs on the draining thread.
+    void drain(const bool flush);
+    void process(const LogRecord& record, const size_t thread);
+    void close_window(const CallSiteKey& key, CallSite& call_site, const ptime& now);
+
+    void draining_thread_main();
+    void start_draining_thread();
+    void stop_draining_thread();
+    void wait_for_writers();
+    void flush();
 };
 
 namespace
@@ -231,6 +422,8 @@ Logger::Logger()
 
 Logger::~Logger()
 {
+    set_asynchronous(false);
+
     delete impl;
 }
 
@@ -239,8 +432,8 @@ void Logger::initialize_from(const Logger& source)
     boost::mutex::scoped_lock source_lock(source.impl->m_mutex);
     boost::mutex::scoped_lock this_lock(impl->m_mutex);
 
-    impl->m_enabled = source.impl->m_enabled;
-    impl->m_verbosity_level = source.impl->m_verbosity_level;
+    impl->m_enabled = source.impl->m_enabled.load();
+    impl->m_verbosity_level = source.impl->m_verbosity_level.load();
 
     impl->m_targets.clear();
     for (const_each<Impl::LogTargetContainer> i = source.impl->m_targets; i; ++i)
@@ -301,6 +494,39 @@ const char* Logger::get_format(const LogMessage::Category category) const
     return impl->m_formatter.get_format(category).c_str();
 }
 
+void Logger::set_asynchronous(const bool asynchronous)
+{
+    boost::mutex::scoped_lock lock(impl->m_async_mutex);
+
+    if (asynchronous == impl->m_asynchronous.load(std::memory_order_relaxed))
+        return;
+
+    if (asynchronous)
+    {
+        impl->start_draining_thread();
+        impl->m_asynchronous.store(true, std::memory_order_release);
+    }
+    else
+    {
+        // Sequentially consistent store: see Logger::Impl::enqueue().
+        impl->m_asynchronous.store(false);
+        impl->stop_draining_thread();
+    }
+}
+
+bool Logger::is_asynchronous() const
+{
+    return impl->m_asynchronous.load(std::memory_order_acquire);
+}
+
+void Logger::flush()
+{
+    boost::mutex::scoped_lock lock(impl->m_async_mutex);
+
+    if (impl->m_asynchronous.load(std::memory_order_relaxed))
+        impl->flush();
+}
+
 void Logger::add_target(ILogTarget* target)
 {
     boost::mutex::scoped_lock lock(impl->m_mutex);
@@ -364,6 +590,26 @@ void Logger::write(
     const size_t                        line,
     APPLESEED_PRINTF_FMT const char*    format, ...)
 {
+    // Fast path: queue the message without taking any lock.
+    if (category != LogMessage::Fatal && impl->m_asynchronous.load(std::memory_order_acquire))
+    {
+        if (category < impl->m_verbosity_level.load(std::memory_order_relaxed) ||
+            !impl->m_enabled.load(std::memory_order_relaxed))
+            return;
+
+        va_list argptr;
+        va_start(argptr, format);
+        const bool enqueued = impl->enqueue(category, file, line, format, argptr);
+        va_end(argptr);
+
+        if (enqueued)
+            return;
+    }
+
+    // Make sure a fatal message comes after all queued messages.
+    if (category == LogMessage::Fatal)
+        flush();
+
     boost::mutex::scoped_lock lock(impl->m_mutex);
 
     if (category < impl->m_verbosity_level)
@@ -378,42 +624,402 @@ void Logger::write(
         va_start(argptr, format);
         const bool formatting_succeeded =
             write_to_buffer(impl->m_message_buffer, MaxBufferSize, format, argptr);
+        va_end(argptr);
 
         // If formatting failed, print the message as an error.
         if (!formatting_succeeded)
             effective_category = LogMessage::Error;
 
-        // Retrieve the current UTC time.
-        const ptime datetime(microsec_clock::universal_time());
+        // Send the message to all log targets.
+        impl->send(
+            effective_category,
+            file,
+            line,
+            microsec_clock::universal_time(),
+            impl->m_thread_map.thread_id_to_int(boost::this_thread::get_id()),
+            &impl->m_message_buffer[0]);
+    }
+
+    // Terminate the application if the message category is 'Fatal'.
+    if (effective_category == LogMessage::Fatal)
+        exit(EXIT_FAILURE);
+}
+
+void Logger::Impl::send(
+    const LogMessage::Category  category,
+    const char*                 file,
+    const size_t                line,
+    const ptime&                datetime,
+    const size_t                thread,
+    const char*                 message)
+{
+    // Format the header and message.
+    const FormatEvaluator format_evaluator(category, datetime, thread, message);
+    const std::string header = format_evaluator.evaluate(m_formatter.get_header_format(category));
+    std::string formatted_message = format_evaluator.evaluate(m_formatter.get_message_format(category));
+
+    // Remove trailing newline characters from the message.
+    formatted_message = trim_right(formatted_message, "\n");
+
+    if (formatted_message.empty())
+        return;
+
+    // Send the header and message to all log targets.
+    for (const_each<LogTargetContainer> i = m_targets; i; ++i)
+    {
+        ILogTarget* target = *i;
+        target->write(
+            category,
+            file,
+            line,
+            header.c_str(),
+            formatted_message.c_str());
+    }
+}
+
+LogRecordRing& Logger::Impl::get_thread_ring()
+{
+    for (const auto& entry : t_thread_rings)
+    {
+        if (entry.first == m_id)
+            return *entry.second;
+    }
+
+    size_t thread;
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        thread = m_thread_map.thread_id_to_int(boost::this_thread::get_id());
+    }
 
-        // Format the header and message.
-        const size_t thread = impl->m_thread_map.thread_id_to_int(boost::this_thread::get_id());
-        const FormatEvaluator format_evaluator(effective_category, datetime, thread, &impl->m_message_buffer[0]);
-        const std::string header = format_evaluator.evaluate(impl->m_formatter.get_header_format(effective_category));
-        std::string message = format_evaluator.evaluate(impl->m_formatter.get_message_format(effective_category));
+    std::shared_ptr<LogRecordRing> ring(new LogRecordRing(thread));
+    ring->m_buffer.resize(InitialBufferSize);
+
+    {
+        boost::mutex::scoped_lock lock(m_rings_mutex);
+        m_rings.push_back(ring);
+    }
+
+    // Forget the rings of loggers that have been destroyed.
+    t_thread_rings.erase(
+        std::remove_if(
+            t_thread_rings.begin(),
+            t_thread_rings.end(),
+            [](const ThreadRingVector::value_type& entry) { return entry.second.use_count() == 1; }),
+        t_thread_rings.end());
+
+    t_thread_rings.emplace_back(m_id, ring);
+
+    return *ring;
+}
+
+bool Logger::Impl::enqueue(
+    const LogMessage::Category  category,
+    const char*                 file,
+    const size_t                line,
+    const char*                 format,
+    va_list                     argptr)
+{
+    LogRecordRing& ring = get_thread_ring();
+
+    // Announce the write, then check that the logger is still asynchronous. Both accesses are
+    // sequentially consistent, like the store in set_asynchronous(false) and the load in
+    // wait_for_writers(): either this write sees asynchronous mode disabled and falls back to
+    // synchronous mode, or wait_for_writers() sees it and waits until the record is pushed.
+    ring.m_writing.store(true);
+
+    if (!m_asynchronous.load())
+    {
+        ring.m_writing.store(false, std::memory_order_release);
+        return false;
+    }
 
-        // Remove trailing newline characters from the message.
-        message = trim_right(message, "\n");
+    LogRecord* record = ring.begin_push();
 
-        if (!message.empty())
+    // If the draining thread can't keep up, drop the message rather than wait.
+    if (record == nullptr)
+    {
+        ring.m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+        ring.m_writing.store(false, std::memory_order_release);
+        return true;
+    }
+
+    const bool formatting_succeeded =
+        write_to_buffer(ring.m_buffer, MaxBufferSize, format, argptr);
+
+    record->m_category = formatting_succeeded ? category : LogMessage::Error;
+    record->m_file = file;
+    record->m_line = line;
+    record->m_datetime = microsec_clock::universal_time();
+    record->m_message.assign(&ring.m_buffer[0]);
+
+    ring.end_push();
+    ring.m_writing.store(false, std::memory_order_release);
+
+    return true;
+}
+
+void Logger::Impl::drain(const bool flush)
+{
+    std::vector<std::shared_ptr<LogRecordRing>> rings;
+
+    {
+        boost::mutex::scoped_lock lock(m_rings_mutex);
+        rings = m_rings;
+    }
+
+    // Collect the records queued so far.
+    typedef std::pair<const LogRecord*, size_t> PendingRecord;
+    std::vector<PendingRecord> records;
+    std::vector<size_t> record_counts(rings.size());
+
+    for (size_t i = 0, e = rings.size(); i < e; ++i)
+    {
+        const LogRecordRing& ring = *rings[i];
+        record_counts[i] = ring.size();
+
+        for (size_t j = 0; j < record_counts[i]; ++j)
+            records.emplace_back(&ring[j], ring.m_thread);
+    }
+
+    // Interleave the records of all threads in chronological order.
+    std::stable_sort(
+        records.begin(),
+        records.end(),
+        [](const PendingRecord& lhs, const PendingRecord& rhs)
+        {
+            return lhs.first->m_datetime < rhs.first->m_datetime;
+        });
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        for (const auto& ring : rings)
+        {
+            const size_t dropped_count = ring->m_dropped_count.exchange(0, std::memory_order_relaxed);
+
+            if (dropped_count > 0)
+            {
+                send(
+                    LogMessage::Warning,
+                    __FILE__,
+                    __LINE__,
+                    microsec_clock::universal_time(),
+                    ring->m_thread,
+                    format(
+                        "{0} log {1} dropped because the log queue was full.",
+                        pretty_uint(dropped_count),
+                        plural(dropped_count, "message")).c_str());
+            }
+        }
+
+        for (const auto& record : records)
+            process(*record.first, record.second);
+
+        // Close rate limiting windows that have expired, or all of them when flushing.
+        const ptime now = microsec_clock::universal_time();
+        for (auto i = m_call_sites.begin(); i != m_call_sites.end(); )
         {
-            // Send the header and message to all log targets.
-            for (const_each<Impl::LogTargetContainer> i = impl->m_targets; i; ++i)
+            if (flush || now - i->second.m_window_begin >= RateLimitingWindow)
             {
-                ILogTarget* target = *i;
-                target->write(
-                    effective_category,
-                    file,
-                    line,
-                    header.c_str(),
-                    message.c_str());
+                close_window(i->first, i->second, now);
+                m_call_sites.erase(i++);
             }
+            else ++i;
         }
     }
 
-    // Terminate the application if the message category is 'Fatal'.
-    if (effective_category == LogMessage::Fatal)
-        exit(EXIT_FAILURE);
+    for (size_t i = 0, e = rings.size(); i < e; ++i)
+        rings[i]->pop(record_counts[i]);
+
+    rings.clear();
+
+    // Release the rings of threads that have exited.
+    boost::mutex::scoped_lock lock(m_rings_mutex);
+    m_rings.erase(
+        std::remove_if(
+            m_rings.begin(),
+            m_rings.end(),
+            [](const std::shared_ptr<LogRecordRing>& ring) { return ring.use_count() == 1 && ring->size() == 0; }),
+        m_rings.end());
+}
+
+void Logger::Impl::process(const LogRecord& record, const size_t thread)
+{
+    if (!m_enabled)
+        return;
+
+    const CallSiteKey key(record.m_file, record.m_line);
+    CallSite& call_site = m_call_sites[key];
+
+    if (call_site.m_sent_count > 0)
+    {
+        if (record.m_datetime - call_site.m_window_begin >= RateLimitingWindow)
+        {
+            close_window(key, call_site, record.m_datetime);
+            call_site = CallSite();
+        }
+        else if (record.m_message == call_site.m_last_message)
+        {
+            // Collapse repetitions of the last message sent.
+            ++call_site.m_repeated_count;
+            return;
+        }
+    }
+
+    if (call_site.m_repeated_count > 0)
+    {
+        send(
+            call_site.m_category,
+            record.m_file,
+            record.m_line,
+            record.m_datetime,
+            call_site.m_thread,
+            format(
+                "(previous message repeated {0} more {1}.)",
+                pretty_uint(call_site.m_repeated_count),
+                plural(call_site.m_repeated_count, "time")).c_str());
+        call_site.m_repeated_count = 0;
+    }
+
+    if (call_site.m_sent_count == MaxMessagesPerCallSite)
+    {
+        ++call_site.m_suppressed_count;
+        return;
+    }
+
+    if (call_site.m_sent_count == 0)
+        call_site.m_window_begin = record.m_datetime;
+
+    ++call_site.m_sent_count;
+    call_site.m_category = record.m_category;
+    call_site.m_thread = thread;
+    call_site.m_last_message = record.m_message;
+
+    send(
+        record.m_category,
+        record.m_file,
+        record.m_line,
+        record.m_datetime,
+        thread,
+        record.m_message.c_str());
+}
+
+void Logger::Impl::close_window(const CallSiteKey& key, CallSite& call_site, const ptime& now)
+{
+    if (call_site.m_repeated_count > 0)
+    {
+        send(
+            call_site.m_category,
+            key.first,
+            key.second,
+            now,
+            call_site.m_thread,
+            format(
+                "(previous message repeated {0} more {1}.)",
+                pretty_uint(call_site.m_repeated_count),
+                plural(call_site.m_repeated_count, "time")).c_str());
+    }
+
+    if (call_site.m_suppressed_count > 0)
+    {
+        send(
+            call_site.m_category,
+            key.first,
+            key.second,
+            now,
+            call_site.m_thread,
+            format(
+                "({0} similar {1} suppressed.)",
+                pretty_uint(call_site.m_suppressed_count),
+                plural(call_site.m_suppressed_count, "message")).c_str());
+    }
+}
+
+void Logger::Impl::draining_thread_main()
+{
+    set_current_thread_name("logger");
+
+    while (true)
+    {
+        bool stop;
+        std::uint64_t flush_request;
+
+        {
+            boost::mutex::scoped_lock lock(m_draining_mutex);
+
+            if (!m_stop_requested && m_flush_requested == m_flush_completed)
+                m_draining_event.timed_wait(lock, DrainingPeriod);
+
+            stop = m_stop_requested;
+            flush_request = m_flush_requested;
+        }
+
+        const bool flush = stop || flush_request != m_flush_completed;
+        drain(flush);
+
+        {
+            boost::mutex::scoped_lock lock(m_draining_mutex);
+            m_flush_completed = flush_request;
+        }
+
+        m_draining_event.notify_all();
+
+        if (stop)
+            break;
+    }
+}
+
+void Logger::Impl::start_draining_thread()
+{
+    assert(!m_draining_thread);
+
+    m_stop_requested = false;
+    m_draining_thread.reset(new boost::thread(&Logger::Impl::draining_thread_main, this));
+}
+
+void Logger::Impl::stop_draining_thread()
+{
+    assert(m_draining_thread);
+
+    {
+        boost::mutex::scoped_lock lock(m_draining_mutex);
+        m_stop_requested = true;
+    }
+
+    m_draining_event.notify_all();
+
+    m_draining_thread->join();
+    m_draining_thread.reset();
+
+    // Deliver messages queued by threads that were still writing while the draining thread stopped.
+    wait_for_writers();
+    drain(true);
+}
+
+void Logger::Impl::wait_for_writers()
+{
+    assert(!m_asynchronous.load(std::memory_order_relaxed));
+
+    // Threads that create their ring from now on will see that asynchronous mode is disabled.
+    boost::mutex::scoped_lock lock(m_rings_mutex);
+
+    for (const auto& ring : m_rings)
+    {
+        while (ring->m_writing.load())
+            boost::this_thread::yield();
+    }
+}
+
+void Logger::Impl::flush()
+{
+    boost::mutex::scoped_lock lock(m_draining_mutex);
+
+    const std::uint64_t flush_request = ++m_flush_requested;
+    m_draining_event.notify_all();
+
+    while (m_flush_completed < flush_request)
+        m_draining_event.wait(lock);
 }
 
 }   // namespace foundation
@@ -52,6 +52,14 @@ namespace foundation
 //
 // All methods of this class are thread-safe.
 //
+// By default, messages are formatted and sent to log targets on the calling thread
+// while holding an internal lock. In asynchronous mode, write() does not take any lock:
+// messages are formatted on the calling thread, queued into a ring buffer owned by that
+// thread, and sent to log targets by a background thread. In that mode, identical
+// messages repeated by a given call site are collapsed, and the number of messages
+// emitted by a given call site per second is limited. Fatal messages are always
+// written synchronously.
+//
 
 class APPLESEED_DLLSYMBOL Logger
   : public NonCopyable
@@ -93,6 +101,14 @@ class APPLESEED_DLLSYMBOL Logger
     // Return the format string of a given message category.
     const char* get_format(const LogMessage::Category category) const;
 
+    // Enable/disable asynchronous mode. Disabling it delivers all queued messages first.
+    void set_asynchronous(const bool asynchronous = true);
+    bool is_asynchronous() const;
+
+    // Wait until all messages queued so far have been sent to log targets.
+    // Does nothing if the logger is not in asynchronous mode.
+    void flush();
+
     // Add a log target. A given log target may be added
     // multiple times. Log targets can be added at any time.
     void add_target(ILogTarget* target);
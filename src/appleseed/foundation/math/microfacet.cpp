@@ -32,8 +32,13 @@
 // appleseed.foundation headers.
 #include "foundation/math/scalar.h"
 #include "foundation/math/specialfunctions.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/memory/memory.h"
+#include "foundation/platform/sse.h"
+#endif
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -498,6 +503,153 @@ float GGXMDF::pdf(
     return pdf_visible_normals<GGXMDF>(v, m, alpha_x, alpha_y);
 }
 
+void GGXMDF::evaluate_reflection_batch(
+    const Vector3f&     wo,
+    const size_t        count,
+    const float*        wi_x,
+    const float*        wi_y,
+    const float*        wi_z,
+    const float         alpha_x,
+    const float         alpha_y,
+    float*              m_x,
+    float*              m_y,
+    float*              m_z,
+    float*              weights,
+    float*              pdfs)
+{
+    assert(is_normalized(wo));
+
+    if (wo.y == 0.0f)
+    {
+        std::fill(weights, weights + count, 0.0f);
+        std::fill(pdfs, pdfs + count, 0.0f);
+        return;
+    }
+
+#ifdef APPLESEED_USE_SSE
+
+    assert(is_aligned(wi_x, 16) && is_aligned(wi_y, 16) && is_aligned(wi_z, 16));
+    assert(is_aligned(m_x, 16) && is_aligned(m_y, 16) && is_aligned(m_z, 16));
+    assert(is_aligned(weights, 16) && is_aligned(pdfs, 16));
+
+    // Terms that only depend on the outgoing direction.
+    const float one_plus_lambda_o = 1.0f + lambda(wo, alpha_x, alpha_y);
+    const float abs_cos_on = std::abs(wo.y);
+
+    const __m128 wox = _mm_set1_ps(wo.x);
+    const __m128 woy = _mm_set1_ps(wo.y);
+    const __m128 woz = _mm_set1_ps(wo.z);
+    const __m128 ax2 = _mm_set1_ps(square(alpha_x));
+    const __m128 ay2 = _mm_set1_ps(square(alpha_y));
+    const __m128 rcp_ax2 = _mm_set1_ps(1.0f / square(alpha_x));
+    const __m128 rcp_ay2 = _mm_set1_ps(1.0f / square(alpha_y));
+    const __m128 pi_ax_ay = _mm_set1_ps(Pi<float>() * alpha_x * alpha_y);
+    const __m128 d_limit = _mm_set1_ps(square(alpha_x) * RcpPi<float>());
+    const __m128 g_denom_o = _mm_set1_ps(one_plus_lambda_o);
+    const __m128 weight_denom_o = _mm_set1_ps(4.0f * abs_cos_on);
+    const __m128 pdf_scale = _mm_set1_ps(1.0f / (4.0f * abs_cos_on * one_plus_lambda_o));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    for (size_t i = 0; i < count; i += 4)
+    {
+        const __m128 wix = _mm_load_ps(wi_x + i);
+        const __m128 wiy = _mm_load_ps(wi_y + i);
+        const __m128 wiz = _mm_load_ps(wi_z + i);
+
+        // Half vector.
+        __m128 mx = _mm_add_ps(wix, wox);
+        __m128 my = _mm_add_ps(wiy, woy);
+        __m128 mz = _mm_add_ps(wiz, woz);
+        const __m128 norm =
+            _mm_sqrt_ps(
+                _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)),
+                    _mm_mul_ps(mz, mz)));
+        mx = _mm_div_ps(mx, norm);
+        my = _mm_div_ps(my, norm);
+        mz = _mm_div_ps(mz, norm);
+        _mm_store_ps(m_x + i, mx);
+        _mm_store_ps(m_y + i, my);
+        _mm_store_ps(m_z + i, mz);
+
+        const __m128 cos_oh =
+            _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(wox, mx), _mm_mul_ps(woy, my)),
+                _mm_mul_ps(woz, mz));
+
+        // D(m) = 1 / (pi * alpha_x * alpha_y * (m.y^2 + m.x^2 / alpha_x^2 + m.z^2 / alpha_y^2)^2).
+        const __m128 t =
+            _mm_add_ps(
+                _mm_mul_ps(my, my),
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_mul_ps(mx, mx), rcp_ax2),
+                    _mm_mul_ps(_mm_mul_ps(mz, mz), rcp_ay2)));
+        __m128 D = _mm_div_ps(one, _mm_mul_ps(pi_ax_ay, _mm_mul_ps(t, t)));
+        const __m128 grazing_m = _mm_cmpeq_ps(my, zero);
+        D = _mm_or_ps(_mm_and_ps(grazing_m, d_limit), _mm_andnot_ps(grazing_m, D));
+
+        // Smith's lambda(wi) = (sqrt(1 + (alpha_x^2 * wi.x^2 + alpha_y^2 * wi.z^2) / wi.y^2) - 1) / 2.
+        const __m128 a2_tan2 =
+            _mm_div_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(ax2, _mm_mul_ps(wix, wix)),
+                    _mm_mul_ps(ay2, _mm_mul_ps(wiz, wiz))),
+                _mm_mul_ps(wiy, wiy));
+        const __m128 lambda_i = _mm_mul_ps(_mm_sub_ps(_mm_sqrt_ps(_mm_add_ps(one, a2_tan2)), one), half);
+
+        // G(wi, wo, m) = 1 / (1 + lambda(wo) + lambda(wi)).
+        const __m128 G = _mm_div_ps(one, _mm_add_ps(g_denom_o, lambda_i));
+
+        __m128 weight =
+            _mm_div_ps(
+                _mm_mul_ps(D, G),
+                _mm_mul_ps(weight_denom_o, _mm_and_ps(wiy, abs_mask)));
+
+        // pdf(wo, m) / |4 * cos(wo, m)| = G1(wo) * D(m) / |4 * cos(wo, n)|.
+        __m128 pdf = _mm_mul_ps(D, pdf_scale);
+
+        // Discard degenerate configurations.
+        const __m128 valid = _mm_and_ps(_mm_cmpneq_ps(wiy, zero), _mm_cmpneq_ps(cos_oh, zero));
+        weight = _mm_and_ps(valid, weight);
+        pdf = _mm_and_ps(valid, pdf);
+
+        _mm_store_ps(weights + i, weight);
+        _mm_store_ps(pdfs + i, pdf);
+    }
+
+#else
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vector3f wi(wi_x[i], wi_y[i], wi_z[i]);
+        const Vector3f m = normalize(wi + wo);
+
+        m_x[i] = m.x;
+        m_y[i] = m.y;
+        m_z[i] = m.z;
+
+        const float cos_oh = dot(wo, m);
+
+        if (wi.y == 0.0f || cos_oh == 0.0f)
+        {
+            weights[i] = 0.0f;
+            pdfs[i] = 0.0f;
+            continue;
+        }
+
+        weights[i] =
+            D(m, alpha_x, alpha_y) * G(wi, wo, m, alpha_x, alpha_y) /
+            std::abs(4.0f * wo.y * wi.y);
+
+        pdfs[i] = pdf(wo, m, alpha_x, alpha_y) / std::abs(4.0f * cos_oh);
+    }
+
+#endif
+}
+
 float GGXMDF::D(
     const Vector3f&     m,
     const float         alpha)
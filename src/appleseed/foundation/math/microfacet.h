@@ -34,6 +34,7 @@
 
 // Standard headers.
 #include <algorithm>
+#include <cstddef>
 
 namespace foundation
 {
@@ -210,6 +211,27 @@ class GGXMDF
         const float         alpha_x,
         const float         alpha_y);
 
+    // Evaluate a GGX reflection lobe for one outgoing direction and a batch of
+    // incoming directions given in SoA form, all in the local frame of the surface.
+    // For each incoming direction wi, compute the half vector m = normalize(wi + wo),
+    // the weight D(m) * G(wi, wo, m) / |4 * cos(wo, n) * cos(wi, n)| and the PDF
+    // pdf(wo, m) / |4 * cos(wo, m)|. Weights and PDFs are zero in degenerate cases.
+    // When APPLESEED_USE_SSE is defined, all arrays must be 16-byte aligned and
+    // padded to a multiple of 4 elements.
+    static void evaluate_reflection_batch(
+        const Vector3f&     wo,
+        const size_t        count,
+        const float*        wi_x,
+        const float*        wi_y,
+        const float*        wi_z,
+        const float         alpha_x,
+        const float         alpha_y,
+        float*              m_x,
+        float*              m_y,
+        float*              m_z,
+        float*              weights,
+        float*              pdfs);
+
     // Isotropic versions of the above methods.
     // They are used in shading models that don't support
     // anisotropy and when computing albedo tables.
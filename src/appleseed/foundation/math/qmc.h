@@ -53,7 +53,6 @@ namespace foundation
 //   implement specializations of Halton and Hammersley sequences generators for bases (2,3).
 //   implement incremental radical inverse (for successive input values).
 //   implement vectorized radical inverse functions with SSE2.
-//   implement Sobol sequence generator.
 //
 
 
@@ -168,6 +167,51 @@ const size_t PrecomputedHaltonSequenceSize = 256;
 extern const double PrecomputedHaltonSequence[4 * PrecomputedHaltonSequenceSize];
 
 
+//
+// Sobol sequence with Owen scrambling.
+//
+// Owen scrambling is implemented with the hash-based nested uniform scrambling of
+// Laine and Karras, using the improved hash function from Burley. Scrambled points
+// keep the stratification properties of the Sobol sequence: any aligned block of
+// 2^k consecutive points is a (0,k,2)-net in dimensions 0 and 1.
+//
+// References:
+//
+//   Joe and Kuo, Constructing Sobol Sequences with Better Two-Dimensional Projections
+//   https://web.maths.unsw.edu.au/~fkuo/sobol/joe-kuo-old.pdf
+//
+//   Laine and Karras, Stratified Sampling for Stochastic Transparency
+//   https://research.nvidia.com/publication/stratified-sampling-stochastic-transparency
+//
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
+
+// Number of dimensions supported by the Sobol sequence generator.
+const size_t SobolDimensionCount = 4;
+
+// Generator matrices of the Sobol sequence, one per dimension.
+extern const std::uint32_t SobolMatrices[SobolDimensionCount][32];
+
+// Return the i'th sample of the Sobol sequence in a given dimension, as a 0.32 fixed point value.
+std::uint32_t sobol_32(
+    const size_t        dimension,      // dimension, in [0, SobolDimensionCount)
+    std::uint32_t       i);             // sample number
+
+// Apply Owen scrambling to a 0.32 fixed point value.
+std::uint32_t owen_scramble_32(
+    std::uint32_t       value,          // value to scramble
+    const std::uint32_t seed);          // scrambling seed
+
+// Return the i'th sample of an Owen-scrambled Sobol sequence in a given dimension.
+// The return value is in the interval [0, 1).
+template <typename T>
+T owen_scrambled_sobol(
+    const size_t        dimension,      // dimension, in [0, SobolDimensionCount)
+    const std::uint32_t i,              // sample number
+    const std::uint32_t seed);          // scrambling seed
+
+
 //
 // Hammersley sequences of arbitrary dimensions.
 //
@@ -2534,6 +2578,71 @@ inline Vector<T, Dim> halton_zaremba_sequence(
 }
 
 
+//
+// Sobol sequence implementation.
+//
+
+namespace impl
+{
+    inline std::uint32_t reverse_bits_32(std::uint32_t value)
+    {
+        value = (value >> 16) | (value << 16);
+        value = ((value & 0xFF00FF00u) >> 8) | ((value & 0x00FF00FFu) << 8);
+        value = ((value & 0xF0F0F0F0u) >> 4) | ((value & 0x0F0F0F0Fu) << 4);
+        value = ((value & 0xCCCCCCCCu) >> 2) | ((value & 0x33333333u) << 2);
+        value = ((value & 0xAAAAAAAAu) >> 1) | ((value & 0x55555555u) << 1);
+        return value;
+    }
+}
+
+inline std::uint32_t sobol_32(
+    const size_t        dimension,
+    std::uint32_t       i)
+{
+    assert(dimension < SobolDimensionCount);
+
+    const std::uint32_t* matrix = SobolMatrices[dimension];
+    std::uint32_t result = 0;
+
+    for (; i != 0; i >>= 1, ++matrix)
+    {
+        if (i & 1)
+            result ^= *matrix;
+    }
+
+    return result;
+}
+
+inline std::uint32_t owen_scramble_32(
+    std::uint32_t       value,
+    const std::uint32_t seed)
+{
+    // The hash only propagates changes from lower bits to higher bits,
+    // so each digit of the reversed value is permuted based on preceding digits.
+    value = impl::reverse_bits_32(value);
+    value ^= value * 0x3D20ADEAu;
+    value += seed;
+    value *= (seed >> 16) | 1;
+    value ^= value * 0x05526C56u;
+    value ^= value * 0x53A22864u;
+    return impl::reverse_bits_32(value);
+}
+
+template <typename T>
+inline T owen_scrambled_sobol(
+    const size_t        dimension,
+    const std::uint32_t i,
+    const std::uint32_t seed)
+{
+    const T result = owen_scramble_32(sobol_32(dimension, i), seed) * Rcp2Pow32<T>();
+
+    assert(result >= T(0.0));
+    assert(result < T(1.0));
+
+    return result;
+}
+
+
 //
 // Hammersley sequences implementation.
 //
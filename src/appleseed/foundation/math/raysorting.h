@@ -0,0 +1,125 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cstdint>
+
+namespace foundation
+{
+
+//
+// Compute keys such that tracing rays in increasing key order improves
+// the coherence of acceleration structure traversals.
+//
+// Rays are grouped by direction octant first, then by origin along a
+// Z-order (Morton) curve over a regular grid spanning a bounding box.
+// Origins outside of the bounding box are clamped to its boundary.
+//
+
+template <typename T>
+class RaySortKeyGenerator
+{
+  public:
+    // Number of grid cells along each axis is 2^CellBits.
+    static const std::uint32_t CellBits = 10;
+
+    // Constructor.
+    explicit RaySortKeyGenerator(const AABB<T, 3>& bbox);
+
+    // Compute the sorting key of a ray.
+    std::uint64_t operator()(
+        const Vector<T, 3>&     org,
+        const Vector<T, 3>&     dir) const;
+
+  private:
+    Vector<T, 3>    m_origin;
+    Vector<T, 3>    m_scale;
+
+    static std::uint64_t spread_bits(std::uint64_t x);
+};
+
+
+//
+// RaySortKeyGenerator class implementation.
+//
+
+template <typename T>
+RaySortKeyGenerator<T>::RaySortKeyGenerator(const AABB<T, 3>& bbox)
+  : m_origin(bbox.min)
+{
+    const T CellCount = static_cast<T>(1UL << CellBits);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const T extent = bbox.max[i] - bbox.min[i];
+        m_scale[i] = extent > T(0.0) ? CellCount / extent : T(0.0);
+    }
+}
+
+template <typename T>
+inline std::uint64_t RaySortKeyGenerator<T>::operator()(
+    const Vector<T, 3>&         org,
+    const Vector<T, 3>&         dir) const
+{
+    const T MaxCell = static_cast<T>((1UL << CellBits) - 1);
+
+    std::uint64_t octant = 0;
+    std::uint64_t cell = 0;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (dir[i] < T(0.0))
+            octant |= 1ULL << i;
+
+        const T c = clamp((org[i] - m_origin[i]) * m_scale[i], T(0.0), MaxCell);
+        cell |= spread_bits(static_cast<std::uint64_t>(c)) << i;
+    }
+
+    return (octant << (3 * CellBits)) | cell;
+}
+
+template <typename T>
+inline std::uint64_t RaySortKeyGenerator<T>::spread_bits(std::uint64_t x)
+{
+    // Insert two 0 bits after each of the 10 low bits of x.
+    x &= 0x000003FF;
+    x = (x | (x << 16)) & 0xFF0000FF;
+    x = (x | (x << 8)) & 0x0300F00F;
+    x = (x | (x << 4)) & 0x030C30C3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+}   // namespace foundation
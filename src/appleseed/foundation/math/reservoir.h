@@ -0,0 +1,134 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// A single-entry weighted reservoir.
+//
+// Candidates are streamed through the reservoir, which keeps one of them with a
+// probability proportional to its weight. Only weights are stored: the caller keeps
+// a copy of the candidate whenever update() returns true.
+//
+// Used for resampled importance sampling (RIS), where a sample is chosen among
+// a number of candidates drawn from a cheap source distribution, in proportion
+// to a target function that better approximates the integrand.
+//
+// Reference:
+//
+//   Justin F. Talbot, David Cline, and Parris Egbert, Importance Resampling
+//   for Global Illumination, Eurographics Symposium on Rendering, 2005
+//
+
+class WeightedReservoir
+{
+  public:
+    // Constructor.
+    WeightedReservoir();
+
+    // Stream a candidate with a given (strictly positive) weight.
+    // The sample must be uniformly distributed in [0, 1).
+    // Return true if the candidate replaces the one held by the reservoir.
+    bool update(const float weight, const float sample);
+
+    // Return true if no candidate was kept yet.
+    bool empty() const;
+
+    // Return the weight of the kept candidate.
+    float get_selected_weight() const;
+
+    // Return the sum of the weights of all candidates streamed so far.
+    float get_weight_sum() const;
+
+    // Return the factor by which the contribution of the kept candidate must be multiplied
+    // for the RIS estimate to be unbiased, given the total number of candidates that were
+    // drawn, including those that were not streamed because their weight was zero.
+    float get_ris_factor(const std::size_t candidate_count) const;
+
+  private:
+    float   m_weight_sum;
+    float   m_selected_weight;
+};
+
+
+//
+// WeightedReservoir class implementation.
+//
+
+inline WeightedReservoir::WeightedReservoir()
+  : m_weight_sum(0.0f)
+  , m_selected_weight(0.0f)
+{
+}
+
+inline bool WeightedReservoir::update(const float weight, const float sample)
+{
+    assert(weight > 0.0f);
+    assert(sample >= 0.0f && sample < 1.0f);
+
+    m_weight_sum += weight;
+
+    if (sample * m_weight_sum < weight)
+    {
+        m_selected_weight = weight;
+        return true;
+    }
+
+    return false;
+}
+
+inline bool WeightedReservoir::empty() const
+{
+    return m_weight_sum == 0.0f;
+}
+
+inline float WeightedReservoir::get_selected_weight() const
+{
+    return m_selected_weight;
+}
+
+inline float WeightedReservoir::get_weight_sum() const
+{
+    return m_weight_sum;
+}
+
+inline float WeightedReservoir::get_ris_factor(const std::size_t candidate_count) const
+{
+    assert(!empty());
+    assert(candidate_count > 0);
+
+    return m_weight_sum / (candidate_count * m_selected_weight);
+}
+
+}   // namespace foundation
@@ -30,6 +30,7 @@
 #pragma once
 
 // appleseed.foundation headers.
+#include "foundation/hash/hash.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/primes.h"
 #include "foundation/math/qmc.h"
@@ -38,8 +39,10 @@
 #include "foundation/utility/test/helpers.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 
 // Unit test case declarations.
 DECLARE_TEST_CASE(Foundation_Math_Sampling_QMCSamplingContext, InitialStateIsCorrect);
@@ -59,11 +62,20 @@ namespace foundation
 //   - Cranley-Patterson rotation
 //   - Monte Carlo padding
 //
-// Reference:
+// or, alternatively:
+//
+//   - deterministic sampling based on Sobol sequences
+//   - Owen scrambling seeded per sequence (typically per pixel)
+//   - per-split index shuffling to decorrelate dimensions
+//
+// References:
 //
 //   Kollig and Keller, Efficient Multidimensional Sampling
 //   www.uni-kl.de/AG-Heinrich/EMS.pdf
 //
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
 
 template <typename RNG>
 class QMCSamplingContext
@@ -72,10 +84,13 @@ class QMCSamplingContext
     // Random number generator type.
     typedef RNG RNGType;
 
-    // This sampler can operate in two modes:
+    // This sampler can operate in three modes:
     //   1. In QMC mode, it uses possibly patent-encumbered techniques.
     //   2. In RNG mode, it works like `RNGSamplingContext` and sticks to random sampling.
-    enum Mode { QMCMode, RNGMode };
+    //   3. In Sobol mode, it uses Owen-scrambled Sobol sequences. The instance number
+    //      passed at construction seeds the scrambling, and samples are drawn from the
+    //      start of the sequence.
+    enum Mode { QMCMode, RNGMode, SobolMode };
 
     // Construct a sampling context of dimension 0.
     // The resulting sampling context cannot be used directly;
@@ -144,6 +159,10 @@ class QMCSamplingContext
     size_t      m_instance;
     VectorType  m_offset;
 
+    // Sobol mode only.
+    std::uint32_t   m_seed;
+    size_t          m_first_instance;
+
     // Cranley-Patterson rotation.
     template <typename T>
     static T rotate(T x, const T offset);
@@ -154,10 +173,18 @@ class QMCSamplingContext
         const size_t    base_dimension,
         const size_t    base_instance,
         const size_t    dimension,
-        const size_t    sample_count);
+        const size_t    sample_count,
+        const std::uint32_t seed);
 
     void compute_offset();
 
+    // Return the index in the Sobol sequence of the sample with a given instance number.
+    // The index is 64-bit since it may exceed 2^32 at high resolutions and sample counts.
+    std::uint64_t get_sobol_index(const size_t instance) const;
+
+    // Return the base instance of a child context split from this one.
+    size_t get_child_base_instance() const;
+
     template <typename T> struct Tag {};
 
     template <typename T> T next2(Tag<T>);
@@ -182,6 +209,8 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
   , m_sample_count(0)
   , m_instance(0)
   , m_offset(0.0)
+  , m_seed(static_cast<std::uint32_t>(base_instance))
+  , m_first_instance(0)
 {
 }
 
@@ -200,6 +229,8 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
   , m_sample_count(sample_count)
   , m_instance(instance)
   , m_offset(0.0)
+  , m_seed(static_cast<std::uint32_t>(instance))
+  , m_first_instance(instance)
 {
     assert(dimension <= VectorType::Dimension);
 }
@@ -211,7 +242,8 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
     const size_t        base_dimension,
     const size_t        base_instance,
     const size_t        dimension,
-    const size_t        sample_count)
+    const size_t        sample_count,
+    const std::uint32_t seed)
   : m_rng(rng)
   , m_mode(mode)
   , m_base_dimension(base_dimension)
@@ -219,6 +251,8 @@ inline QMCSamplingContext<RNG>::QMCSamplingContext(
   , m_dimension(dimension)
   , m_sample_count(sample_count)
   , m_instance(0)
+  , m_seed(seed)
+  , m_first_instance(0)
 {
     assert(dimension <= VectorType::Dimension);
 
@@ -239,6 +273,8 @@ QMCSamplingContext<RNG>::operator=(const QMCSamplingContext& rhs)
     m_sample_count = rhs.m_sample_count;
     m_instance = rhs.m_instance;
     m_offset = rhs.m_offset;
+    m_seed = rhs.m_seed;
+    m_first_instance = rhs.m_first_instance;
 
     return *this;
 }
@@ -253,9 +289,10 @@ inline QMCSamplingContext<RNG> QMCSamplingContext<RNG>::split(
             m_rng,
             m_mode,
             m_base_dimension + m_dimension,         // dimension allocation
-            m_base_instance + m_instance,           // decorrelation by generalization
+            get_child_base_instance(),              // decorrelation by generalization
             dimension,
-            sample_count);
+            sample_count,
+            m_seed);
 }
 
 template <typename RNG>
@@ -266,11 +303,12 @@ inline void QMCSamplingContext<RNG>::split_in_place(
     assert(m_sample_count == 0 || m_instance == m_sample_count);    // can't split in the middle of a sequence
     assert(dimension <= VectorType::Dimension);
 
+    m_base_instance = get_child_base_instance();    // decorrelation by generalization
     m_base_dimension += m_dimension;                // dimension allocation
-    m_base_instance += m_instance;                  // decorrelation by generalization
     m_dimension = dimension;
     m_sample_count = sample_count;
     m_instance = 0;
+    m_first_instance = 0;
 
     if (m_mode == QMCMode)
         compute_offset();
@@ -338,6 +376,26 @@ inline void QMCSamplingContext<RNG>::compute_offset()
     }
 }
 
+template <typename RNG>
+inline std::uint64_t QMCSamplingContext<RNG>::get_sobol_index(const size_t instance) const
+{
+    // Flatten the samples of this context and of its ancestors into a single sequence,
+    // so that consecutive pixel samples use consecutive points at every dimension.
+    return
+          static_cast<std::uint64_t>(m_base_instance) * std::max<size_t>(m_sample_count, 1)
+        + (instance - m_first_instance);
+}
+
+template <typename RNG>
+inline size_t QMCSamplingContext<RNG>::get_child_base_instance() const
+{
+    if (m_mode != SobolMode)
+        return m_base_instance + m_instance;
+
+    // Index of the last sample drawn from this context.
+    return static_cast<size_t>(get_sobol_index(m_instance > m_first_instance ? m_instance - 1 : m_instance));
+}
+
 template <typename RNG>
 template <typename T>
 inline T QMCSamplingContext<RNG>::next2(Tag<T>)
@@ -377,6 +435,33 @@ inline Vector<T, N> QMCSamplingContext<RNG>::next2(Tag<Vector<T, N>>)
             }
         }
     }
+    else if (m_mode == SobolMode)
+    {
+        assert(N <= SobolDimensionCount);
+
+        // The generator matrices only cover 2^32 points: past that, each block
+        // of 2^32 points is a distinct, independently scrambled sequence.
+        const std::uint64_t sobol_index = get_sobol_index(m_instance);
+        const std::uint32_t block = static_cast<std::uint32_t>(sobol_index >> 32);
+        const std::uint32_t seed = block == 0 ? m_seed : mix_uint32(m_seed, block);
+
+        // Shuffle the sequence differently for each group of dimensions
+        // so that successive splits are decorrelated.
+        const std::uint32_t base_dimension = static_cast<std::uint32_t>(m_base_dimension);
+        const std::uint32_t index =
+            owen_scramble_32(
+                static_cast<std::uint32_t>(sobol_index),
+                mix_uint32(seed, base_dimension));
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            v[i] =
+                owen_scrambled_sobol<T>(
+                    i,
+                    index,
+                    mix_uint32(seed, base_dimension, static_cast<std::uint32_t>(i)));
+        }
+    }
     else
     {
         for (size_t i = 0; i < N; ++i)
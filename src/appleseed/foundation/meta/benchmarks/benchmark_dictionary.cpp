@@ -0,0 +1,95 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+
+// appleseed.foundation headers.
+#include "foundation/containers/dictionary.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+
+BENCHMARK_SUITE(Foundation_Containers_Dictionary)
+{
+    // Roughly the parameters of a typical material or light entity.
+    struct Fixture
+    {
+        StringDictionary    m_dictionary;
+        double              m_dummy;
+
+        Fixture()
+          : m_dummy(0.0)
+        {
+            m_dictionary.insert("bsdf", "material_bsdf");
+            m_dictionary.insert("cast_indirect_light", "true");
+            m_dictionary.insert("edf", "material_edf");
+            m_dictionary.insert("exposure", "0.5");
+            m_dictionary.insert("importance_multiplier", "1.0");
+            m_dictionary.insert("intensity", "light_intensity");
+            m_dictionary.insert("intensity_multiplier", "2.5");
+            m_dictionary.insert("light_near_start", "0.0");
+            m_dictionary.insert("max_ray_intensity", "1000");
+            m_dictionary.insert("radius", "0.25");
+            m_dictionary.insert("surface_shader", "material_surface_shader");
+            m_dictionary.insert("visibility", "7");
+        }
+    };
+
+    BENCHMARK_CASE_F(Exist, Fixture)
+    {
+        m_dummy += m_dictionary.exist("intensity_multiplier") ? 1.0 : 0.0;
+    }
+
+    BENCHMARK_CASE_F(GetAsString, Fixture)
+    {
+        m_dummy += m_dictionary.get("surface_shader")[0];
+    }
+
+    BENCHMARK_CASE_F(GetAsDouble, Fixture)
+    {
+        m_dummy += m_dictionary.get<double>("intensity_multiplier");
+    }
+
+    BENCHMARK_CASE_F(GetAsSizeT, Fixture)
+    {
+        m_dummy += m_dictionary.get<size_t>("max_ray_intensity");
+    }
+
+    BENCHMARK_CASE_F(GetAsBool, Fixture)
+    {
+        m_dummy += m_dictionary.get<bool>("cast_indirect_light") ? 1.0 : 0.0;
+    }
+
+    BENCHMARK_CASE_F(Copy, Fixture)
+    {
+        const StringDictionary copy(m_dictionary);
+        m_dummy += static_cast<double>(copy.size());
+    }
+}
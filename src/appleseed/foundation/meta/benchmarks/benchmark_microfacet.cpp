@@ -32,8 +32,13 @@
 #include "foundation/math/rng/distribution.h"
 #include "foundation/math/rng/lcg.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
 #include "foundation/utility/benchmark.h"
 
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
 using namespace foundation;
 
 BENCHMARK_SUITE(Foundation_Math_Microfacet)
@@ -136,4 +141,96 @@ BENCHMARK_SUITE(Foundation_Math_Microfacet)
     {
         evaluate(0.5f, 0.5f);
     }
+
+    //
+    // GGX reflection lobe, one outgoing direction and a batch of incoming directions.
+    //
+
+    struct GGXBatchFixture
+    {
+        static const size_t BatchSize = 16;
+
+        Vector3f                        m_outgoing;     // view direction, unit-length
+        APPLESEED_SIMD4_ALIGN float     m_wi_x[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_wi_y[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_wi_z[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_m_x[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_m_y[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_m_z[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_weights[BatchSize];
+        APPLESEED_SIMD4_ALIGN float     m_pdfs[BatchSize];
+        float                           m_dummy;
+
+        GGXBatchFixture()
+          : m_outgoing(normalize(Vector3f(0.1f, 0.8f, 0.3f)))
+          , m_dummy(0.0f)
+        {
+            LCG rng;
+
+            for (size_t i = 0; i < BatchSize; ++i)
+            {
+                const Vector3f wi =
+                    normalize(
+                        Vector3f(
+                            rand_float2(rng) * 2.0f - 1.0f,
+                            rand_float2(rng) + 0.01f,
+                            rand_float2(rng) * 2.0f - 1.0f));
+                m_wi_x[i] = wi.x;
+                m_wi_y[i] = wi.y;
+                m_wi_z[i] = wi.z;
+            }
+        }
+
+        void evaluate_scalar(const float alpha_x, const float alpha_y)
+        {
+            for (size_t i = 0; i < BatchSize; ++i)
+            {
+                const Vector3f wi(m_wi_x[i], m_wi_y[i], m_wi_z[i]);
+                const Vector3f m = normalize(wi + m_outgoing);
+
+                m_dummy +=
+                    GGXMDF::D(m, alpha_x, alpha_y) *
+                    GGXMDF::G(wi, m_outgoing, m, alpha_x, alpha_y) /
+                    std::abs(4.0f * m_outgoing.y * wi.y);
+                m_dummy +=
+                    GGXMDF::pdf(m_outgoing, m, alpha_x, alpha_y) /
+                    std::abs(4.0f * dot(m_outgoing, m));
+            }
+        }
+
+        void evaluate_batch(const float alpha_x, const float alpha_y)
+        {
+            GGXMDF::evaluate_reflection_batch(
+                m_outgoing,
+                BatchSize,
+                m_wi_x, m_wi_y, m_wi_z,
+                alpha_x, alpha_y,
+                m_m_x, m_m_y, m_m_z,
+                m_weights,
+                m_pdfs);
+
+            for (size_t i = 0; i < BatchSize; ++i)
+                m_dummy += m_weights[i] + m_pdfs[i];
+        }
+    };
+
+    BENCHMARK_CASE_F(GGXMDF_EvaluateReflection_Isotropic_Scalar, GGXBatchFixture)
+    {
+        evaluate_scalar(0.5f, 0.5f);
+    }
+
+    BENCHMARK_CASE_F(GGXMDF_EvaluateReflection_Isotropic_Batch, GGXBatchFixture)
+    {
+        evaluate_batch(0.5f, 0.5f);
+    }
+
+    BENCHMARK_CASE_F(GGXMDF_EvaluateReflection_Anisotropic_Scalar, GGXBatchFixture)
+    {
+        evaluate_scalar(0.25f, 0.5f);
+    }
+
+    BENCHMARK_CASE_F(GGXMDF_EvaluateReflection_Anisotropic_Batch, GGXBatchFixture)
+    {
+        evaluate_batch(0.25f, 0.5f);
+    }
 }
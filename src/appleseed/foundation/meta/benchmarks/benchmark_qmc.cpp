@@ -258,6 +258,17 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
             for (size_t i = 0; i < 64; ++i)
                 m_x += hammersley_sequence<T, 2>(Bases, 64, i);
         }
+
+        void owen_scrambled_sobol_payload()
+        {
+            m_x = Vector<T, 2>(0.0f);
+
+            for (std::uint32_t i = 0; i < 64; ++i)
+            {
+                m_x[0] += owen_scrambled_sobol<T>(0, i, 0x9E3779B9u);
+                m_x[1] += owen_scrambled_sobol<T>(1, i, 0x7F4A7C15u);
+            }
+        }
     };
 
     //
@@ -369,4 +380,18 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
     {
         hammersley_payload();
     }
+
+    //
+    // Owen-scrambled Sobol sequence.
+    //
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_SinglePrecision, Vector2Fixture<float>)
+    {
+        owen_scrambled_sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_DoublePrecision, Vector2Fixture<double>)
+    {
+        owen_scrambled_sobol_payload();
+    }
 }
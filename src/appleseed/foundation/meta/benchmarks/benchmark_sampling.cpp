@@ -111,6 +111,23 @@ BENCHMARK_SUITE(Foundation_Math_Sampling_QMCSamplingContext)
             m_v += context.next2<Vector2d>();
         }
     }
+
+    BENCHMARK_CASE_F(BenchmarkTrajectory_SobolMode, SamplingContextFixture)
+    {
+        const size_t InitialInstance = 1234567;
+        QMCSamplingContext<RNG> context(
+            m_rng,
+            QMCSamplingContext<RNG>::SobolMode,
+            1,
+            InitialInstance,
+            InitialInstance);
+
+        for (size_t i = 0; i < 32; ++i)
+        {
+            context.split_in_place(2, 1);
+            m_v += context.next2<Vector2d>();
+        }
+    }
 }
 
 BENCHMARK_SUITE(Foundation_Math_Sampling_Mappings)
@@ -33,9 +33,14 @@
 #include "foundation/image/image.h"
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
+#include "foundation/log/log.h"
 #include "foundation/math/fp.h"
+#include "foundation/utility/job/parallelloop.h"
 #include "foundation/utility/test.h"
 
+// Standard headers.
+#include <cstddef>
+
 using namespace foundation;
 
 TEST_SUITE(Foundation_Image_Analysis)
@@ -81,6 +86,25 @@ TEST_SUITE(Foundation_Image_Analysis)
         EXPECT_FEQ_EPS(1.0, average_luminance, 1.0e-6);
     }
 
+    TEST_CASE(ComputeAverageLuminance_GivenParallelLoop_ReturnsSameValueAsSequentialComputation)
+    {
+        Image image(37, 23, 8, 8, 4, PixelFormatFloat);
+
+        for (size_t y = 0; y < 23; ++y)
+        {
+            for (size_t x = 0; x < 37; ++x)
+                image.set_pixel(x, y, Color4f(x * 0.1f, y * 0.2f, (x + y) * 0.05f, 1.0f));
+        }
+
+        Logger logger;
+        ParallelLoop loop(logger, 4);
+
+        const double sequential_average_luminance = compute_average_luminance(image);
+        const double parallel_average_luminance = compute_average_luminance(image, &loop);
+
+        EXPECT_EQ(sequential_average_luminance, parallel_average_luminance);
+    }
+
     TEST_CASE(ComputeRMSDeviation_GivenBothImagesFilledWithZeroes_ReturnsZero)
     {
         Image image1(4, 4, 2, 2, 4, PixelFormatFloat);
@@ -158,4 +182,20 @@ TEST_SUITE(Foundation_Image_Analysis)
 
         EXPECT_FEQ_EPS(std::sqrt(2.0 / 3.0), rmsd, 1.0e-6);
     }
+
+    TEST_CASE(ComputeRMSDeviation_GivenDifferentlyTiledImagesAndParallelLoop_ReturnsOne)
+    {
+        Image image1(5, 5, 2, 2, 4, PixelFormatFloat);
+        Image image2(5, 5, 3, 3, 4, PixelFormatFloat);
+
+        image1.clear(Color4f(0.0f));
+        image2.clear(Color4f(1.0f));
+
+        Logger logger;
+        ParallelLoop loop(logger, 4);
+
+        const double rmsd = compute_rms_deviation(image1, image2, &loop);
+
+        EXPECT_FEQ(1.0, rmsd);
+    }
 }
@@ -0,0 +1,227 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/memory/autoreleaseptr.h"
+#include "foundation/utility/benchmark/benchmarkcomparison.h"
+#include "foundation/utility/benchmark/benchmarksuite.h"
+#include "foundation/utility/benchmark/ibenchmarkcase.h"
+#include "foundation/utility/benchmark/jsonfilebenchmarklistener.h"
+#include "foundation/utility/benchmark/timingresult.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Utility_Benchmark_TimingResult)
+{
+    TEST_CASE(ComputeRunStatistics_GivenOddRunCount_ComputesMedianAndMAD)
+    {
+        double run_ticks[] = { 5.0, 1.0, 3.0, 2.0, 4.0 };
+
+        TimingResult result;
+        compute_run_statistics(run_ticks, 5, result);
+
+        EXPECT_EQ(5, result.m_run_count);
+        EXPECT_EQ(3.0, result.m_median_ticks);
+        EXPECT_EQ(1.0, result.m_mad_ticks);
+        EXPECT_EQ(1.0, result.m_ci_low_ticks);
+        EXPECT_EQ(5.0, result.m_ci_high_ticks);
+    }
+
+    TEST_CASE(ComputeRunStatistics_GivenEvenRunCount_AveragesMiddleValues)
+    {
+        double run_ticks[] = { 4.0, 1.0, 3.0, 2.0 };
+
+        TimingResult result;
+        compute_run_statistics(run_ticks, 4, result);
+
+        EXPECT_EQ(2.5, result.m_median_ticks);
+        EXPECT_EQ(1.0, result.m_mad_ticks);
+    }
+
+    TEST_CASE(ComputeRunStatistics_GivenManyRuns_ComputesConfidenceIntervalFromOrderStatistics)
+    {
+        std::vector<double> run_ticks;
+        for (size_t i = 100; i > 0; --i)
+            run_ticks.push_back(static_cast<double>(i));
+
+        TimingResult result;
+        compute_run_statistics(run_ticks.data(), run_ticks.size(), result);
+
+        EXPECT_EQ(50.5, result.m_median_ticks);
+        EXPECT_EQ(25.0, result.m_mad_ticks);
+        EXPECT_EQ(40.0, result.m_ci_low_ticks);
+        EXPECT_EQ(61.0, result.m_ci_high_ticks);
+    }
+}
+
+TEST_SUITE(Foundation_Utility_Benchmark_BenchmarkComparison)
+{
+    struct FakeBenchmarkCase
+      : public IBenchmarkCase
+    {
+        const std::string m_name;
+
+        explicit FakeBenchmarkCase(const char* name)
+          : m_name(name)
+        {
+        }
+
+        const char* get_name() const override
+        {
+            return m_name.c_str();
+        }
+
+        void run() override
+        {
+        }
+    };
+
+    struct FakeTiming
+    {
+        const char*     m_case_name;
+        double          m_median_ticks;
+        double          m_ci_low_ticks;
+        double          m_ci_high_ticks;
+    };
+
+    void write_results_file(
+        const char*         path,
+        const FakeTiming*   timings,
+        const size_t        timing_count)
+    {
+        auto_release_ptr<JSONFileBenchmarkListener> listener(create_jsonfile_benchmark_listener());
+        listener->open(path);
+
+        const BenchmarkSuite suite("Suite \"A\"");
+        listener->begin_suite(suite);
+
+        for (size_t i = 0; i < timing_count; ++i)
+        {
+            const FakeBenchmarkCase benchmark_case(timings[i].m_case_name);
+            listener->begin_case(suite, benchmark_case);
+
+            TimingResult result;
+            result.m_iteration_count = 1;
+            result.m_measurement_count = 100;
+            result.m_frequency = 1000.0;
+            result.m_ticks = timings[i].m_ci_low_ticks;
+            result.m_run_count = 10;
+            result.m_median_ticks = timings[i].m_median_ticks;
+            result.m_mad_ticks = 1.0;
+            result.m_ci_low_ticks = timings[i].m_ci_low_ticks;
+            result.m_ci_high_ticks = timings[i].m_ci_high_ticks;
+            listener->write(suite, benchmark_case, __FILE__, __LINE__, "a message");
+            listener->write(suite, benchmark_case, __FILE__, __LINE__, result);
+
+            listener->end_case(suite, benchmark_case);
+        }
+
+        listener->end_suite(suite);
+        listener->close();
+    }
+
+    TEST_CASE(Compare_FlagsSignificantChangesBeyondThreshold)
+    {
+        const FakeTiming Baseline[] =
+        {
+            { "Unchanged",  100.0,  98.0, 102.0 },
+            { "Slower",     100.0,  98.0, 102.0 },
+            { "Faster",     100.0,  98.0, 102.0 },
+            { "Noisy",      100.0,  60.0, 140.0 },
+            { "Removed",    100.0,  98.0, 102.0 }
+        };
+
+        const FakeTiming Current[] =
+        {
+            { "Unchanged",  101.0,  99.0, 103.0 },
+            { "Slower",     150.0, 148.0, 152.0 },
+            { "Faster",      50.0,  48.0,  52.0 },
+            { "Noisy",      130.0,  90.0, 170.0 },
+            { "Added",      100.0,  98.0, 102.0 }
+        };
+
+        write_results_file("unit tests/outputs/test_benchmarkcomparison_baseline.json", Baseline, 5);
+        write_results_file("unit tests/outputs/test_benchmarkcomparison_current.json", Current, 5);
+
+        BenchmarkComparison comparison;
+        ASSERT_TRUE(comparison.read_baseline("unit tests/outputs/test_benchmarkcomparison_baseline.json"));
+        ASSERT_TRUE(comparison.read_current("unit tests/outputs/test_benchmarkcomparison_current.json"));
+        comparison.compare(0.1);
+
+        ASSERT_EQ(4, comparison.get_case_count());
+        EXPECT_EQ(1, comparison.get_regression_count());
+        EXPECT_EQ(2, comparison.get_unmatched_case_count());
+
+        const BenchmarkComparison::Case& unchanged = comparison.get_case(0);
+        EXPECT_EQ(std::string("Suite \"A\""), unchanged.m_suite_name);
+        EXPECT_EQ(std::string("Unchanged"), unchanged.m_case_name);
+        EXPECT_FEQ(0.1, unchanged.m_baseline_time);
+        EXPECT_FEQ(0.101, unchanged.m_current_time);
+        EXPECT_FALSE(unchanged.m_regression);
+        EXPECT_FALSE(unchanged.m_improvement);
+
+        const BenchmarkComparison::Case& slower = comparison.get_case(1);
+        EXPECT_FEQ(0.5, slower.m_relative_change);
+        EXPECT_TRUE(slower.m_regression);
+
+        const BenchmarkComparison::Case& faster = comparison.get_case(2);
+        EXPECT_FEQ(-0.5, faster.m_relative_change);
+        EXPECT_TRUE(faster.m_improvement);
+
+        // Confidence intervals overlap: the change is not significant.
+        const BenchmarkComparison::Case& noisy = comparison.get_case(3);
+        EXPECT_FALSE(noisy.m_regression);
+    }
+
+    TEST_CASE(ReadBaseline_GivenMissingFile_ReturnsFalse)
+    {
+        BenchmarkComparison comparison;
+
+        EXPECT_FALSE(comparison.read_baseline("unit tests/outputs/test_benchmarkcomparison_missing.json"));
+    }
+
+    TEST_CASE(ReadBaseline_GivenMalformedFile_ReturnsFalse)
+    {
+        const char* Filename = "unit tests/outputs/test_benchmarkcomparison_malformed.json";
+
+        {
+            std::ofstream file(Filename);
+            file << "{ \"suites\": [ { \"name\": \"Suite\", \"cases\": [ }";
+        }
+
+        BenchmarkComparison comparison;
+
+        EXPECT_FALSE(comparison.read_baseline(Filename));
+    }
+}
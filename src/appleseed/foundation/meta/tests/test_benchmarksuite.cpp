@@ -0,0 +1,158 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/utility/benchmark/benchmarkparams.h"
+#include "foundation/utility/benchmark/benchmarkresult.h"
+#include "foundation/utility/benchmark/benchmarksuite.h"
+#include "foundation/utility/benchmark/ibenchmarkcase.h"
+#include "foundation/utility/benchmark/ibenchmarkcasefactory.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <thread>
+
+// Platform headers.
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Utility_Benchmark_BenchmarkSuite)
+{
+#ifdef __linux__
+
+    size_t get_current_thread_cpu_count()
+    {
+        cpu_set_t affinity;
+        CPU_ZERO(&affinity);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &affinity);
+        return static_cast<size_t>(CPU_COUNT(&affinity));
+    }
+
+    // A benchmark case that records the number of processors a thread it spawns may run on.
+    class SpawnThreadBenchmarkCase
+      : public IBenchmarkCase
+    {
+      public:
+        SpawnThreadBenchmarkCase(
+            const bool          multithreaded,
+            size_t&             thread_cpu_count)
+          : m_multithreaded(multithreaded)
+          , m_thread_cpu_count(thread_cpu_count)
+        {
+        }
+
+        const char* get_name() const override
+        {
+            return "SpawnThread";
+        }
+
+        bool is_multithreaded() const override
+        {
+            return m_multithreaded;
+        }
+
+        void run() override
+        {
+            std::thread thread([this]() { m_thread_cpu_count = get_current_thread_cpu_count(); });
+            thread.join();
+        }
+
+      private:
+        const bool  m_multithreaded;
+        size_t&     m_thread_cpu_count;
+    };
+
+    class SpawnThreadBenchmarkCaseFactory
+      : public IBenchmarkCaseFactory
+    {
+      public:
+        SpawnThreadBenchmarkCaseFactory(
+            const bool          multithreaded,
+            size_t&             thread_cpu_count)
+          : m_multithreaded(multithreaded)
+          , m_thread_cpu_count(thread_cpu_count)
+        {
+        }
+
+        const char* get_name() const override
+        {
+            return "SpawnThread";
+        }
+
+        IBenchmarkCase* create() override
+        {
+            return new SpawnThreadBenchmarkCase(m_multithreaded, m_thread_cpu_count);
+        }
+
+      private:
+        const bool  m_multithreaded;
+        size_t&     m_thread_cpu_count;
+    };
+
+    size_t run_spawn_thread_benchmark(const bool multithreaded)
+    {
+        size_t thread_cpu_count = 0;
+        SpawnThreadBenchmarkCaseFactory factory(multithreaded, thread_cpu_count);
+
+        BenchmarkSuite suite("Suite");
+        suite.register_case(&factory);
+
+        BenchmarkParams params;
+        params.m_run_count = 1;
+        params.m_pin_thread = true;
+
+        BenchmarkResult result;
+        suite.run(result, params);
+
+        return thread_cpu_count;
+    }
+
+    TEST_CASE(Run_GivenMultithreadedCase_DoesNotPinThreadsSpawnedByCase)
+    {
+        const size_t cpu_count = get_current_thread_cpu_count();
+
+        const size_t thread_cpu_count = run_spawn_thread_benchmark(true);
+
+        EXPECT_EQ(cpu_count, thread_cpu_count);
+    }
+
+    TEST_CASE(Run_GivenSingleThreadedCase_RestoresAffinityOfBenchmarkingThread)
+    {
+        const size_t cpu_count = get_current_thread_cpu_count();
+
+        run_spawn_thread_benchmark(false);
+
+        EXPECT_EQ(cpu_count, get_current_thread_cpu_count());
+    }
+
+#endif
+}
@@ -29,6 +29,8 @@
 
 // appleseed.foundation headers.
 #include "foundation/containers/dictionary.h"
+#include "foundation/string/string.h"
+#include "foundation/utility/foreach.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
@@ -148,6 +150,90 @@ TEST_SUITE(Foundation_Utility_StringDictionary)
 
         EXPECT_EQ(&sd, result);
     }
+
+    TEST_CASE(Iteration_GivenItemsInsertedInArbitraryOrder_VisitsItemsInKeyOrder)
+    {
+        StringDictionary sd;
+        sd.insert("b", "2");
+        sd.insert("c", "3");
+        sd.insert("a", "1");
+
+        std::string keys;
+        for (const_each<StringDictionary> i = sd; i; ++i)
+            keys += i->key();
+
+        EXPECT_EQ("abc", keys);
+    }
+
+    TEST_CASE(GetAsInt_CalledTwice_ReturnsSameValue)
+    {
+        StringDictionary sd;
+        sd.insert("key", "42");
+
+        EXPECT_EQ(42, sd.get<int>("key"));
+        EXPECT_EQ(42, sd.get<int>("key"));
+    }
+
+    TEST_CASE(GetAsInt_AfterValueWasRetrievedAsDouble_ThrowsExceptionStringConversionError)
+    {
+        StringDictionary sd;
+        sd.insert("key", "1.5");
+
+        EXPECT_EQ(1.5, sd.get<double>("key"));
+
+        EXPECT_EXCEPTION(ExceptionStringConversionError,
+        {
+            APPLESEED_UNUSED const int item = sd.get<int>("key");
+        });
+    }
+
+    TEST_CASE(GetAsInt_AfterValueWasChanged_ReturnsNewValue)
+    {
+        StringDictionary sd;
+        sd.insert("key", "1");
+        EXPECT_EQ(1, sd.get<int>("key"));
+
+        sd.set("key", "2");
+        EXPECT_EQ(2, sd.get<int>("key"));
+
+        sd.insert("key", "3");
+        EXPECT_EQ(3, sd.get<int>("key"));
+    }
+
+    TEST_CASE(GetAsBool_CalledTwice_ReturnsSameValue)
+    {
+        StringDictionary sd;
+        sd.insert("key", "on");
+
+        EXPECT_TRUE(sd.get<bool>("key"));
+        EXPECT_TRUE(sd.get<bool>("key"));
+    }
+
+    TEST_CASE(GetMemorySize_GrowsWithItems)
+    {
+        StringDictionary sd;
+        const size_t empty_size = sd.get_memory_size();
+
+        sd.insert("key", "a value long enough not to fit in the string object itself");
+
+        EXPECT_GT(empty_size, sd.get_memory_size());
+    }
+
+    TEST_CASE(Get_AfterOtherItemsWereInsertedAndRemoved_ReturnedPointerRemainsValid)
+    {
+        StringDictionary sd;
+        sd.insert("m", "value");
+
+        const char* value = sd.get("m");
+
+        for (size_t i = 0; i < 100; ++i)
+            sd.insert(("a" + to_string(i)).c_str(), i);
+
+        sd.remove("a0");
+
+        EXPECT_EQ(sd.get("m"), value);
+        EXPECT_EQ(std::string("value"), value);
+    }
 }
 
 TEST_SUITE(Foundation_Utility_DictionaryDictionary)
@@ -176,6 +262,19 @@ TEST_SUITE(Foundation_Utility_DictionaryDictionary)
 
         EXPECT_EQ(&dd, result);
     }
+
+    TEST_CASE(Insert_DoesNotInvalidateReferencesToOtherItems)
+    {
+        DictionaryDictionary dd;
+        dd.insert("m", Dictionary());
+
+        Dictionary& m = dd.get("m");
+
+        for (int i = 0; i < 100; ++i)
+            dd.insert(to_string(i).c_str(), Dictionary());
+
+        EXPECT_EQ(&m, &dd.get("m"));
+    }
 }
 
 TEST_SUITE(Foundation_Utility_Dictionary)
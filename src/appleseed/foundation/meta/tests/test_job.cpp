@@ -36,14 +36,20 @@
 #include "foundation/utility/job/ijob.h"
 #include "foundation/utility/job/jobmanager.h"
 #include "foundation/utility/job/jobqueue.h"
+#include "foundation/utility/job/parallelloop.h"
 #include "foundation/utility/job/workerthread.h"
 #include "foundation/utility/test.h"
 
+// Boost headers.
+#include "boost/thread/thread.hpp"
+
 // Standard headers.
 #include <cstddef>
 #include <cstdint>
 #include <new>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 using namespace foundation;
 
@@ -483,3 +489,138 @@ TEST_SUITE(Foundation_Utility_Job_WorkerThread)
         EXPECT_EQ(1, execution_count);
     }
 }
+
+TEST_SUITE(Foundation_Utility_Job_ParallelLoop)
+{
+    TEST_CASE(Run_GivenSingleThread_ExecutesAllIterationsInOrder)
+    {
+        Logger logger;
+        ParallelLoop loop(logger, 1);
+
+        std::vector<size_t> indices;
+        loop.run(4, [&indices](const size_t i, const size_t thread_index) { indices.push_back(i); });
+
+        const size_t expected[] = { 0, 1, 2, 3 };
+        ASSERT_EQ(4, indices.size());
+        EXPECT_SEQUENCE_EQ(4, expected, &indices[0]);
+    }
+
+    TEST_CASE(Run_GivenMultipleThreads_ExecutesEachIterationOnce)
+    {
+        Logger logger;
+        ParallelLoop loop(logger, 4);
+
+        std::vector<std::uint32_t> execution_counts(100, 0);
+
+        // The loop is reused to make sure worker threads survive the end of a loop.
+        for (size_t pass = 0; pass < 2; ++pass)
+        {
+            loop.run(
+                execution_counts.size(),
+                [&execution_counts](const size_t i, const size_t thread_index)
+                {
+                    ++execution_counts[i];
+                });
+        }
+
+        for (const std::uint32_t count : execution_counts)
+            EXPECT_EQ(2, count);
+    }
+
+    TEST_CASE(Run_GivenNestedLoop_ExecutesNestedIterationsInCallingThread)
+    {
+        Logger logger;
+        ParallelLoop loop(logger, 4);
+
+        std::vector<std::uint32_t> execution_counts(8 * 8, 0);
+        std::vector<std::uint32_t> mismatch_counts(8, 0);
+
+        loop.run(
+            8,
+            [&](const size_t i, const size_t thread_index)
+            {
+                loop.run(
+                    8,
+                    [&, i, thread_index](const size_t j, const size_t nested_thread_index)
+                    {
+                        ++execution_counts[i * 8 + j];
+
+                        if (nested_thread_index != thread_index)
+                            ++mismatch_counts[i];
+                    });
+            });
+
+        for (const std::uint32_t count : execution_counts)
+            EXPECT_EQ(1, count);
+
+        for (const std::uint32_t count : mismatch_counts)
+            EXPECT_EQ(0, count);
+    }
+
+    TEST_CASE(Run_GivenConcurrentCallers_ExecutesEachIterationOnce)
+    {
+        Logger logger;
+        ParallelLoop loop(logger, 4);
+
+        std::vector<std::uint32_t> execution_counts[2] =
+        {
+            std::vector<std::uint32_t>(100, 0),
+            std::vector<std::uint32_t>(100, 0)
+        };
+
+        auto run_loop = [&loop](std::vector<std::uint32_t>& counts)
+        {
+            loop.run(
+                counts.size(),
+                [&counts](const size_t i, const size_t thread_index)
+                {
+                    ++counts[i];
+                });
+        };
+
+        boost::thread other_caller([&]() { run_loop(execution_counts[1]); });
+        run_loop(execution_counts[0]);
+        other_caller.join();
+
+        for (size_t k = 0; k < 2; ++k)
+        {
+            for (const std::uint32_t count : execution_counts[k])
+                EXPECT_EQ(1, count);
+        }
+    }
+
+    TEST_CASE(Run_GivenThrowingIteration_RethrowsExceptionAndRemainsUsable)
+    {
+        Logger logger;
+        ParallelLoop loop(logger, 4);
+
+        std::vector<std::uint32_t> execution_counts(100, 0);
+
+        EXPECT_EXCEPTION(std::runtime_error,
+        {
+            loop.run(
+                execution_counts.size(),
+                [&execution_counts](const size_t i, const size_t thread_index)
+                {
+                    ++execution_counts[i];
+
+                    if (i == 42)
+                        throw std::runtime_error("iteration failed");
+                });
+        });
+
+        // All iterations were scheduled before the failure and are completed when run() returns.
+        for (const std::uint32_t count : execution_counts)
+            EXPECT_EQ(1, count);
+
+        loop.run(
+            execution_counts.size(),
+            [&execution_counts](const size_t i, const size_t thread_index)
+            {
+                ++execution_counts[i];
+            });
+
+        for (const std::uint32_t count : execution_counts)
+            EXPECT_EQ(2, count);
+    }
+}
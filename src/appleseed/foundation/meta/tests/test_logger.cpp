@@ -0,0 +1,222 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/log/helpers.h"
+#include "foundation/log/logger.h"
+#include "foundation/log/stringlogtarget.h"
+#include "foundation/memory/autoreleaseptr.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/test.h"
+
+// Boost headers.
+#include "boost/thread/thread.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Log_Logger)
+{
+    struct Fixture
+    {
+        auto_release_ptr<StringLogTarget>   m_target;
+        Logger                              m_logger;
+
+        Fixture()
+          : m_target(create_string_log_target())
+        {
+            m_logger.set_all_formats("{message}");
+            m_logger.add_target(m_target.get());
+        }
+
+        ~Fixture()
+        {
+            m_logger.set_asynchronous(false);
+            m_logger.remove_target(m_target.get());
+        }
+    };
+
+    TEST_CASE_F(Write_SynchronousMode_DeliversMessageImmediately, Fixture)
+    {
+        LOG_INFO(m_logger, "hello");
+
+        EXPECT_EQ("hello\n", std::string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Write_AsynchronousMode_DeliversMessageAfterFlush, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        LOG_INFO(m_logger, "hello");
+        LOG_INFO(m_logger, "world");
+        m_logger.flush();
+
+        EXPECT_EQ("hello\nworld\n", std::string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(SetAsynchronous_False_DeliversQueuedMessages, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        LOG_INFO(m_logger, "hello");
+        m_logger.set_asynchronous(false);
+
+        EXPECT_FALSE(m_logger.is_asynchronous());
+        EXPECT_EQ("hello\n", std::string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Write_AsynchronousMode_MessagesBelowVerbosityLevelAreDiscarded, Fixture)
+    {
+        m_logger.set_asynchronous();
+        m_logger.set_verbosity_level(LogMessage::Warning);
+
+        LOG_INFO(m_logger, "hello");
+        LOG_WARNING(m_logger, "world");
+        m_logger.flush();
+
+        EXPECT_EQ("world\n", std::string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Write_AsynchronousMode_CollapsesRepeatedMessages, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        for (size_t i = 0; i < 5; ++i)
+            LOG_INFO(m_logger, "hello");
+
+        m_logger.flush();
+
+        EXPECT_EQ(
+            "hello\n"
+            "(previous message repeated 4 more times.)\n",
+            std::string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Write_AsynchronousMode_LimitsMessageRatePerCallSite, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        for (size_t i = 0; i < 15; ++i)
+            LOG_INFO(m_logger, "message " FMT_SIZE_T, i);
+
+        m_logger.flush();
+
+        std::string expected;
+        for (size_t i = 0; i < 10; ++i)
+            expected += "message " + std::to_string(i) + "\n";
+        expected += "(5 similar messages suppressed.)\n";
+
+        EXPECT_EQ(expected, std::string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Write_AsynchronousModeFromMultipleThreads_DeliversAllMessages, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        const size_t ThreadCount = 4;
+        std::vector<boost::thread*> threads;
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            threads.push_back(
+                new boost::thread(
+                    [this, i]()
+                    {
+                        LOG_INFO(m_logger, "thread " FMT_SIZE_T " first message", i);
+                        LOG_INFO(m_logger, "thread " FMT_SIZE_T " second message", i);
+                    }));
+        }
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        m_logger.flush();
+
+        const std::string result = m_target->get_string();
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            const std::string first = "thread " + std::to_string(i) + " first message\n";
+            const std::string second = "thread " + std::to_string(i) + " second message\n";
+            const size_t first_pos = result.find(first);
+            const size_t second_pos = result.find(second);
+
+            ASSERT_NEQ(std::string::npos, first_pos);
+            ASSERT_NEQ(std::string::npos, second_pos);
+            EXPECT_LT(second_pos, first_pos);
+        }
+    }
+
+    TEST_CASE_F(SetAsynchronous_FalseWhileOtherThreadsAreWriting_DeliversAllMessages, Fixture)
+    {
+        const size_t ThreadCount = 4;
+        const size_t PassCount = 50;
+
+        for (size_t pass = 0; pass < PassCount; ++pass)
+        {
+            m_logger.set_asynchronous();
+
+            std::vector<boost::thread*> threads;
+
+            for (size_t i = 0; i < ThreadCount; ++i)
+            {
+                threads.push_back(
+                    new boost::thread(
+                        [this, pass, i]()
+                        {
+                            LOG_INFO(m_logger, "pass " FMT_SIZE_T " thread " FMT_SIZE_T, pass, i);
+                        }));
+            }
+
+            m_logger.set_asynchronous(false);
+
+            for (size_t i = 0; i < ThreadCount; ++i)
+            {
+                threads[i]->join();
+                delete threads[i];
+            }
+        }
+
+        const std::string result = m_target->get_string();
+
+        for (size_t pass = 0; pass < PassCount; ++pass)
+        {
+            for (size_t i = 0; i < ThreadCount; ++i)
+            {
+                const std::string message = "pass " + std::to_string(pass) + " thread " + std::to_string(i) + "\n";
+                EXPECT_NEQ(std::string::npos, result.find(message));
+            }
+        }
+    }
+}
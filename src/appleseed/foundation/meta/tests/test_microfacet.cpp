@@ -34,6 +34,7 @@
 #include "foundation/math/sampling/mappings.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
@@ -390,6 +391,109 @@ TEST_SUITE(Foundation_Math_Microfacet)
     }
 
 
+    // Return the largest relative difference between GGXMDF::evaluate_reflection_batch()
+    // and the scalar evaluation of the same reflection lobe.
+    float compute_ggx_batch_max_relative_error(
+        const float         alpha_x,
+        const float         alpha_y)
+    {
+        const size_t BatchSize = 16;
+        const size_t BatchCount = 16;
+
+        static const size_t Bases[] = { 2 };
+        static const size_t Bases2And3[] = { 2, 3 };
+
+        APPLESEED_SIMD4_ALIGN float wi_x[BatchSize];
+        APPLESEED_SIMD4_ALIGN float wi_y[BatchSize];
+        APPLESEED_SIMD4_ALIGN float wi_z[BatchSize];
+        APPLESEED_SIMD4_ALIGN float m_x[BatchSize];
+        APPLESEED_SIMD4_ALIGN float m_y[BatchSize];
+        APPLESEED_SIMD4_ALIGN float m_z[BatchSize];
+        APPLESEED_SIMD4_ALIGN float weights[BatchSize];
+        APPLESEED_SIMD4_ALIGN float pdfs[BatchSize];
+
+        float max_error = 0.0f;
+
+        for (size_t b = 0; b < BatchCount; ++b)
+        {
+            const Vector3f wo =
+                sample_hemisphere_uniform(
+                    hammersley_sequence<float, 2>(Bases, BatchCount, b));
+
+            for (size_t i = 0; i < BatchSize; ++i)
+            {
+                const Vector3f wi =
+                    sample_hemisphere_uniform(
+                        halton_sequence<float, 2>(Bases2And3, b * BatchSize + i + 1));
+                wi_x[i] = wi.x;
+                wi_y[i] = wi.y;
+                wi_z[i] = wi.z;
+            }
+
+            GGXMDF::evaluate_reflection_batch(
+                wo,
+                BatchSize,
+                wi_x, wi_y, wi_z,
+                alpha_x, alpha_y,
+                m_x, m_y, m_z,
+                weights,
+                pdfs);
+
+            for (size_t i = 0; i < BatchSize; ++i)
+            {
+                const Vector3f wi(wi_x[i], wi_y[i], wi_z[i]);
+                const Vector3f m = normalize(wi + wo);
+
+                const float ref_weight =
+                    GGXMDF::D(m, alpha_x, alpha_y) *
+                    GGXMDF::G(wi, wo, m, alpha_x, alpha_y) /
+                    std::abs(4.0f * wo.y * wi.y);
+                const float ref_pdf =
+                    GGXMDF::pdf(wo, m, alpha_x, alpha_y) /
+                    std::abs(4.0f * dot(wo, m));
+
+                max_error = std::max(max_error, std::abs(weights[i] - ref_weight) / ref_weight);
+                max_error = std::max(max_error, std::abs(pdfs[i] - ref_pdf) / ref_pdf);
+                max_error = std::max(max_error, norm(Vector3f(m_x[i], m_y[i], m_z[i]) - m));
+            }
+        }
+
+        return max_error;
+    }
+
+    TEST_CASE(GGXMDF_EvaluateReflectionBatch_Isotropic_MatchesScalarEvaluation)
+    {
+        EXPECT_LT(1.0e-4f, compute_ggx_batch_max_relative_error(0.35f, 0.35f));
+    }
+
+    TEST_CASE(GGXMDF_EvaluateReflectionBatch_Anisotropic_MatchesScalarEvaluation)
+    {
+        EXPECT_LT(1.0e-4f, compute_ggx_batch_max_relative_error(0.25f, 0.5f));
+    }
+
+    TEST_CASE(GGXMDF_EvaluateReflectionBatch_GivenGrazingIncomingDirection_ReturnsZero)
+    {
+        APPLESEED_SIMD4_ALIGN float wi_x[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        APPLESEED_SIMD4_ALIGN float wi_y[4] = { 0.0f, 1.0f, 1.0f, 1.0f };
+        APPLESEED_SIMD4_ALIGN float wi_z[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        APPLESEED_SIMD4_ALIGN float m_x[4], m_y[4], m_z[4];
+        APPLESEED_SIMD4_ALIGN float weights[4], pdfs[4];
+
+        GGXMDF::evaluate_reflection_batch(
+            Vector3f(0.0f, 1.0f, 0.0f),
+            4,
+            wi_x, wi_y, wi_z,
+            0.5f, 0.5f,
+            m_x, m_y, m_z,
+            weights,
+            pdfs);
+
+        EXPECT_EQ(0.0f, weights[0]);
+        EXPECT_EQ(0.0f, pdfs[0]);
+        EXPECT_GT(0.0f, weights[1]);
+        EXPECT_GT(0.0f, pdfs[1]);
+    }
+
     //
     // Ward MDF.
     //
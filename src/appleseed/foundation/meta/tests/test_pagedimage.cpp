@@ -0,0 +1,124 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/image/pagedimage.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/image/tilepager.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Boost headers.
+#include "boost/filesystem/operations.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Image_PagedImage)
+{
+    const std::string ScratchDirectory = boost::filesystem::temp_directory_path().string();
+
+    TEST_CASE(Allocate_ReturnsZeroInitializedBlock)
+    {
+        TilePager pager(ScratchDirectory.c_str(), 0);
+
+        const std::uint8_t* block = pager.allocate(100);
+
+        for (size_t i = 0; i < 100; ++i)
+            EXPECT_EQ(0, block[i]);
+    }
+
+    size_t get_page_size()
+    {
+        TilePager pager(ScratchDirectory.c_str(), 0);
+        pager.allocate(1);
+        return pager.get_resident_size();
+    }
+
+    TEST_CASE(Release_GivenUnreleasedBlocksOverBudget_EvictsReleasedBlock)
+    {
+        const size_t page_size = get_page_size();
+        TilePager pager(ScratchDirectory.c_str(), 2 * page_size);
+
+        std::uint8_t* block = pager.allocate(1);
+        pager.allocate(1);
+        pager.allocate(1);
+
+        EXPECT_EQ(3 * page_size, pager.get_resident_size());
+
+        pager.release(block, 1);
+
+        EXPECT_EQ(2 * page_size, pager.get_resident_size());
+    }
+
+    TEST_CASE(Constructor_CreatesBlankImage)
+    {
+        TilePager pager(ScratchDirectory.c_str(), 0);
+        PagedImage image(2, 1, 1, 1, 3, PixelFormatFloat, pager);
+
+        Color3f c00; image.tile(0, 0).get_pixel(0, 0, c00);
+        Color3f c10; image.tile(1, 0).get_pixel(0, 0, c10);
+
+        EXPECT_EQ(Color3f(0.0), c00);
+        EXPECT_EQ(Color3f(0.0), c10);
+    }
+
+    TEST_CASE(ReleaseTile_GivenZeroMemoryBudget_PreservesTileContents)
+    {
+        TilePager pager(ScratchDirectory.c_str(), 0);
+        PagedImage image(4, 4, 2, 2, 3, PixelFormatFloat, pager);
+
+        image.tile(1, 1).set_pixel(1, 0, Color3f(42.0f));
+        image.release_tile(1, 1);
+
+        Color3f c; image.tile(1, 1).get_pixel(1, 0, c);
+
+        EXPECT_EQ(Color3f(42.0f), c);
+    }
+
+    TEST_CASE(ReleaseTile_CalledTwice_PreservesTileContents)
+    {
+        TilePager pager(ScratchDirectory.c_str(), 1024 * 1024);
+        PagedImage image(4, 4, 2, 2, 3, PixelFormatFloat, pager);
+
+        image.tile(0, 1).set_pixel(0, 1, Color3f(1.0f));
+        image.release_tile(0, 1);
+        image.tile(0, 1).set_pixel(0, 1, Color3f(2.0f));
+        image.release_tile(0, 1);
+        pager.evict_all();
+
+        Color3f c; image.tile(0, 1).get_pixel(0, 1, c);
+
+        EXPECT_EQ(Color3f(2.0f), c);
+    }
+}
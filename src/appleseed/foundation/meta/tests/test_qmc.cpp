@@ -31,6 +31,7 @@
 #include "foundation/image/color.h"
 #include "foundation/image/genericimagefilewriter.h"
 #include "foundation/image/image.h"
+#include "foundation/hash/hash.h"
 #include "foundation/image/pixel.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/primes.h"
@@ -49,6 +50,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <string>
 #include <vector>
@@ -399,6 +401,141 @@ TEST_SUITE(Foundation_Math_QMC)
             points);
     }
 
+    TEST_CASE(Sobol32_FirstPoints)
+    {
+        for (size_t d = 0; d < SobolDimensionCount; ++d)
+        {
+            EXPECT_EQ(0x00000000u, sobol_32(d, 0));
+            EXPECT_EQ(0x80000000u, sobol_32(d, 1));
+        }
+
+        // The first dimension is the Van der Corput sequence in base 2.
+        EXPECT_EQ(0x40000000u, sobol_32(0, 2));
+        EXPECT_EQ(0xC0000000u, sobol_32(0, 3));
+
+        EXPECT_EQ(0xC0000000u, sobol_32(1, 2));
+        EXPECT_EQ(0x40000000u, sobol_32(1, 3));
+    }
+
+    // Return true if a set of 2^m points in [0,1)^2 is a (0,m,2)-net in base 2,
+    // i.e. if every elementary interval of area 2^-m contains exactly one point.
+    bool is_02_net(const std::vector<Vector2d>& points, const size_t m)
+    {
+        assert(points.size() == (size_t(1) << m));
+
+        for (size_t a = 0; a <= m; ++a)
+        {
+            const size_t nx = size_t(1) << a;
+            const size_t ny = size_t(1) << (m - a);
+
+            std::vector<size_t> counts(nx * ny, 0);
+
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                const size_t ix = truncate<size_t>(points[i].x * nx);
+                const size_t iy = truncate<size_t>(points[i].y * ny);
+
+                if (++counts[iy * nx + ix] > 1)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(OwenScrambledSobol_FirstPowerOfTwoPoints_FormA02Net)
+    {
+        for (std::uint32_t seed = 0; seed < 16; ++seed)
+        {
+            std::vector<Vector2d> points;
+
+            for (std::uint32_t i = 0; i < PointCount; ++i)
+            {
+                points.push_back(
+                    Vector2d(
+                        owen_scrambled_sobol<double>(0, i, hash_uint32(2 * seed + 0)),
+                        owen_scrambled_sobol<double>(1, i, hash_uint32(2 * seed + 1))));
+            }
+
+            EXPECT_TRUE(is_02_net(points, 8));
+        }
+    }
+
+    TEST_CASE(OwenScrambledSobol_ScrambledIndices_FormA02Net)
+    {
+        // Shuffling the sample indices with Owen scrambling preserves the net
+        // property of any power-of-two prefix of the sequence.
+
+        std::vector<Vector2d> points;
+
+        for (std::uint32_t i = 0; i < 64; ++i)
+        {
+            const std::uint32_t index = owen_scramble_32(i, 0x12345678u);
+
+            points.push_back(
+                Vector2d(
+                    owen_scrambled_sobol<double>(0, index, 17),
+                    owen_scrambled_sobol<double>(1, index, 42)));
+        }
+
+        EXPECT_TRUE(is_02_net(points, 6));
+    }
+
+    TEST_CASE(Generate2DOwenScrambledSobolSequenceImage)
+    {
+        std::vector<Vector2d> points;
+
+        for (std::uint32_t i = 0; i < PointCount; ++i)
+        {
+            points.push_back(
+                Vector2d(
+                    owen_scrambled_sobol<double>(0, i, 0x9E3779B9u),
+                    owen_scrambled_sobol<double>(1, i, 0x7F4A7C15u)));
+        }
+
+        write_point_cloud_image(
+            "unit tests/outputs/test_qmc_sobol_2d_owen_scrambled.png",
+            points);
+    }
+
+    TEST_CASE(Integrate2DFunction_OwenScrambledSobol_HasLowerErrorThanRandomSampling)
+    {
+        const double Exact = 4.0 / (Pi<double>() * Pi<double>());
+        const size_t TrialCount = 32;
+        const size_t SampleCount = 256;
+
+        MersenneTwister rng;
+
+        double sobol_mse = 0.0;
+        double rng_mse = 0.0;
+
+        for (std::uint32_t trial = 0; trial < TrialCount; ++trial)
+        {
+            double sobol_sum = 0.0;
+            double rng_sum = 0.0;
+
+            for (std::uint32_t i = 0; i < SampleCount; ++i)
+            {
+                const double sx = owen_scrambled_sobol<double>(0, i, hash_uint32(2 * trial + 0));
+                const double sy = owen_scrambled_sobol<double>(1, i, hash_uint32(2 * trial + 1));
+                sobol_sum += std::sin(sx * Pi<double>()) * std::sin(sy * Pi<double>());
+
+                const double rx = rand_double2(rng);
+                const double ry = rand_double2(rng);
+                rng_sum += std::sin(rx * Pi<double>()) * std::sin(ry * Pi<double>());
+            }
+
+            sobol_mse += square(sobol_sum / SampleCount - Exact);
+            rng_mse += square(rng_sum / SampleCount - Exact);
+        }
+
+        sobol_mse /= TrialCount;
+        rng_mse /= TrialCount;
+
+        // The variance of Owen-scrambled nets decreases much faster than O(1/n).
+        EXPECT_LT(rng_mse * 0.01, sobol_mse);
+    }
+
     TEST_CASE(SampleImagePlaneWithHaltonSequence)
     {
         //
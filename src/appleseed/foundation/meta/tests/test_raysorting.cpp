@@ -0,0 +1,84 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/raysorting.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstdint>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Math_RaySortKeyGenerator)
+{
+    const AABB3d SceneBBox(Vector3d(-1.0), Vector3d(1.0));
+
+    TEST_CASE(RaysWithSameOriginAndOctant_HaveSameKey)
+    {
+        const RaySortKeyGenerator<double> key(SceneBBox);
+
+        EXPECT_EQ(
+            key(Vector3d(0.5, 0.5, 0.5), Vector3d(1.0, 2.0, 3.0)),
+            key(Vector3d(0.5, 0.5, 0.5), Vector3d(3.0, 2.0, 1.0)));
+    }
+
+    TEST_CASE(RaysInDifferentOctants_AreSortedByOctantFirst)
+    {
+        const RaySortKeyGenerator<double> key(SceneBBox);
+
+        const std::uint64_t k1 = key(Vector3d(0.9, 0.9, 0.9), Vector3d(1.0, 1.0, 1.0));
+        const std::uint64_t k2 = key(Vector3d(-0.9, -0.9, -0.9), Vector3d(-1.0, 1.0, 1.0));
+
+        EXPECT_LT(k2, k1);
+    }
+
+    TEST_CASE(NearbyOrigins_AreCloserThanDistantOrigins)
+    {
+        const RaySortKeyGenerator<double> key(SceneBBox);
+        const Vector3d dir(0.0, 1.0, 0.0);
+
+        const std::uint64_t k1 = key(Vector3d(-0.9, -0.9, -0.9), dir);
+        const std::uint64_t k2 = key(Vector3d(-0.8, -0.9, -0.9), dir);
+        const std::uint64_t k3 = key(Vector3d(0.9, 0.9, 0.9), dir);
+
+        EXPECT_LT(k2, k1);
+        EXPECT_LT(k3, k2);
+    }
+
+    TEST_CASE(OriginsOutsideBoundingBox_AreClampedToBoundary)
+    {
+        const RaySortKeyGenerator<double> key(SceneBBox);
+        const Vector3d dir(1.0, 1.0, 1.0);
+
+        EXPECT_EQ(key(Vector3d(1.0), dir), key(Vector3d(5.0), dir));
+        EXPECT_EQ(key(Vector3d(-1.0), dir), key(Vector3d(-5.0), dir));
+    }
+}
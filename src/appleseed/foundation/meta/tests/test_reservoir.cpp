@@ -0,0 +1,213 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/math/reservoir.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <cstdint>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Math_WeightedReservoir)
+{
+    TEST_CASE(Empty_GivenNewReservoir_ReturnsTrue)
+    {
+        const WeightedReservoir reservoir;
+
+        EXPECT_TRUE(reservoir.empty());
+    }
+
+    TEST_CASE(Update_GivenFirstCandidate_KeepsIt)
+    {
+        WeightedReservoir reservoir;
+
+        const bool kept = reservoir.update(2.0f, 0.99f);
+
+        EXPECT_TRUE(kept);
+        EXPECT_FALSE(reservoir.empty());
+        EXPECT_EQ(2.0f, reservoir.get_selected_weight());
+        EXPECT_EQ(2.0f, reservoir.get_weight_sum());
+    }
+
+    TEST_CASE(GetRISFactor_DividesAverageWeightByWeightOfKeptCandidate)
+    {
+        WeightedReservoir reservoir;
+        reservoir.update(2.0f, 0.0f);
+        reservoir.update(6.0f, 0.9f);
+
+        EXPECT_FEQ(1.0f, reservoir.get_ris_factor(4));
+    }
+
+    TEST_CASE(Update_GivenManyCandidates_KeepsEachWithProbabilityProportionalToItsWeight)
+    {
+        const float Weights[] = { 1.0f, 2.0f, 3.0f, 4.0f };
+        const size_t TrialCount = 100000;
+
+        MersenneTwister rng;
+        size_t counts[4] = { 0, 0, 0, 0 };
+
+        for (size_t i = 0; i < TrialCount; ++i)
+        {
+            WeightedReservoir reservoir;
+            size_t selected = 0;
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                if (reservoir.update(Weights[j], rand_float2(rng)))
+                    selected = j;
+            }
+
+            ++counts[selected];
+        }
+
+        for (size_t j = 0; j < 4; ++j)
+            EXPECT_FEQ_EPS(Weights[j] / 10.0f, static_cast<float>(counts[j]) / TrialCount, 0.03f);
+    }
+
+    //
+    // Direct lighting from a set of lights, some of them occluded, estimated by picking lights
+    // uniformly (the source distribution). The resampling weight of a candidate is its unshadowed
+    // contribution divided by its source probability, and visibility is only known for the kept
+    // candidate, exactly as in renderer::DirectLightingIntegrator.
+    //
+
+    const size_t LightCount = 16;
+
+    float unshadowed_contribution(const size_t light)
+    {
+        return 1.0f + static_cast<float>(light * light);
+    }
+
+    float visibility(const size_t light)
+    {
+        return light % 3 == 0 ? 0.0f : 1.0f;
+    }
+
+    float exact_lighting()
+    {
+        float result = 0.0f;
+
+        for (size_t i = 0; i < LightCount; ++i)
+            result += unshadowed_contribution(i) * visibility(i);
+
+        return result;
+    }
+
+    template <typename RNG>
+    size_t sample_light(RNG& rng)
+    {
+        return static_cast<size_t>(rand_int1(rng, 0, static_cast<std::int32_t>(LightCount - 1)));
+    }
+
+    template <typename RNG>
+    float estimate_lighting(RNG& rng)
+    {
+        const size_t light = sample_light(rng);
+        return unshadowed_contribution(light) * visibility(light) * LightCount;
+    }
+
+    template <typename RNG>
+    float estimate_lighting_ris(RNG& rng, const size_t candidate_count)
+    {
+        WeightedReservoir reservoir;
+        size_t selected = 0;
+
+        for (size_t i = 0; i < candidate_count; ++i)
+        {
+            const size_t light = sample_light(rng);
+            const float weight = unshadowed_contribution(light) * LightCount;
+
+            if (reservoir.update(weight, rand_float2(rng)))
+                selected = light;
+        }
+
+        return
+              unshadowed_contribution(selected) * visibility(selected) * LightCount
+            * reservoir.get_ris_factor(candidate_count);
+    }
+
+    struct Estimate
+    {
+        double  m_mean;
+        double  m_variance;
+    };
+
+    const size_t TrialCount = 200000;
+
+    Estimate compute_estimate(const size_t candidate_count)
+    {
+        MersenneTwister rng;
+        double sum = 0.0;
+        double sum_squares = 0.0;
+
+        for (size_t i = 0; i < TrialCount; ++i)
+        {
+            const double value =
+                candidate_count == 0
+                    ? estimate_lighting(rng)
+                    : estimate_lighting_ris(rng, candidate_count);
+            sum += value;
+            sum_squares += value * value;
+        }
+
+        Estimate estimate;
+        estimate.m_mean = sum / TrialCount;
+        estimate.m_variance = sum_squares / TrialCount - estimate.m_mean * estimate.m_mean;
+        return estimate;
+    }
+
+    TEST_CASE(RIS_GivenManyLights_AgreesWithEstimatorWithoutResampling)
+    {
+        const double expected = exact_lighting();
+
+        const Estimate without_ris = compute_estimate(0);
+        EXPECT_FEQ_EPS(expected, without_ris.m_mean, 0.01);
+
+        const size_t CandidateCounts[] = { 1, 4, 16 };
+
+        for (const size_t candidate_count : CandidateCounts)
+        {
+            const Estimate with_ris = compute_estimate(candidate_count);
+            EXPECT_FEQ_EPS(expected, with_ris.m_mean, 0.01);
+        }
+    }
+
+    TEST_CASE(RIS_GivenMoreCandidates_ReducesVariance)
+    {
+        const Estimate one_candidate = compute_estimate(1);
+        const Estimate four_candidates = compute_estimate(4);
+        const Estimate sixteen_candidates = compute_estimate(16);
+
+        EXPECT_LT(one_candidate.m_variance, four_candidates.m_variance);
+        EXPECT_LT(four_candidates.m_variance, sixteen_candidates.m_variance);
+    }
+}
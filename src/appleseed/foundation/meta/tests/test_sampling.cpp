@@ -130,6 +130,95 @@ TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext)
         EXPECT_EQ(4, child_child_context.m_dimension);
         EXPECT_EQ(0, child_child_context.m_instance);
     }
+
+    // Return true if a set of 2^m points in [0,1)^2 is a (0,m,2)-net in base 2.
+    bool is_02_net(const std::vector<Vector2d>& points, const size_t m)
+    {
+        for (size_t a = 0; a <= m; ++a)
+        {
+            const size_t nx = size_t(1) << a;
+            const size_t ny = size_t(1) << (m - a);
+
+            std::vector<size_t> counts(nx * ny, 0);
+
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                const size_t ix = truncate<size_t>(points[i].x * nx);
+                const size_t iy = truncate<size_t>(points[i].y * ny);
+
+                if (++counts[iy * nx + ix] > 1)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    TEST_CASE(SobolMode_PixelSamples_FormA02Net)
+    {
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::SobolMode, 2, 0, 12345);
+
+        std::vector<Vector2d> points;
+
+        for (size_t i = 0; i < 64; ++i)
+            points.push_back(context.next2<Vector2d>());
+
+        EXPECT_TRUE(is_02_net(points, 6));
+    }
+
+    TEST_CASE(SobolMode_ChildSamplesAcrossPixelSamples_FormA02Net)
+    {
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::SobolMode, 2, 0, 999);
+
+        std::vector<Vector2d> points;
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            context.next2<Vector2d>();
+
+            SamplingContext child_context = context.split(2, 4);
+
+            for (size_t j = 0; j < 4; ++j)
+                points.push_back(child_context.next2<Vector2d>());
+        }
+
+        EXPECT_TRUE(is_02_net(points, 6));
+    }
+
+    TEST_CASE(SobolMode_DifferentInstances_AreDecorrelated)
+    {
+        RNG rng;
+        SamplingContext context1(rng, SamplingContext::SobolMode, 2, 0, 1);
+        SamplingContext context2(rng, SamplingContext::SobolMode, 2, 0, 2);
+
+        EXPECT_NEQ(context1.next2<Vector2d>(), context2.next2<Vector2d>());
+    }
+
+    TEST_CASE(SobolMode_InstancesPast2Pow32_DoNotWrapAround)
+    {
+        RNG rng;
+        SamplingContext context1(rng, SamplingContext::SobolMode, 2, 0, 7);
+        SamplingContext context2(rng, SamplingContext::SobolMode, 2, 0, 7);
+        context2.set_instance(7 + (size_t(1) << 32));
+
+        EXPECT_NEQ(context1.next2<Vector2d>(), context2.next2<Vector2d>());
+    }
+
+    TEST_CASE(SobolMode_PixelSamplesPast2Pow32_FormA02Net)
+    {
+        RNG rng;
+        SamplingContext context(rng, SamplingContext::SobolMode, 2, 0, 12345);
+        context.set_instance(12345 + (size_t(3) << 32) + 64);
+
+        std::vector<Vector2d> points;
+
+        for (size_t i = 0; i < 64; ++i)
+            points.push_back(context.next2<Vector2d>());
+
+        EXPECT_TRUE(is_02_net(points, 6));
+    }
 }
 
 TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext_DirectIlluminationSimulation)
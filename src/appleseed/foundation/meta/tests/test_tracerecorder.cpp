@@ -0,0 +1,173 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+#include "foundation/utility/tracerecorder.h"
+
+// Boost headers.
+#include "boost/thread/thread.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+
+TEST_SUITE(Foundation_Utility_TraceRecorder)
+{
+    TEST_CASE(Start_GivenRecordingAlreadyStarted_ReturnsFalseAndKeepsRecordingUntilLastStop)
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+
+        EXPECT_TRUE(recorder.start());
+        EXPECT_FALSE(recorder.start());
+
+        recorder.stop();
+        EXPECT_TRUE(recorder.is_recording());
+
+        recorder.stop();
+        EXPECT_FALSE(recorder.is_recording());
+    }
+
+    TEST_CASE(TraceScope_WhileRecording_RecordsOneEvent)
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+
+        recorder.start();
+        {
+            TraceScope scope("test", "scope");
+        }
+        recorder.stop();
+
+        EXPECT_EQ(1, recorder.get_event_count());
+    }
+
+    TEST_CASE(TraceScope_WhenNotRecording_DoesNotRecordEvent)
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+
+        recorder.start();
+        recorder.stop();
+
+        {
+            TraceScope scope("test", "scope");
+        }
+
+        EXPECT_EQ(0, recorder.get_event_count());
+    }
+
+    TEST_CASE(Start_GivenEventsFromPreviousSession_DiscardsThem)
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+
+        recorder.start();
+        {
+            TraceScope scope1("test", "scope1");
+            TraceScope scope2("test", "scope2");
+        }
+        recorder.stop();
+
+        recorder.start();
+        {
+            TraceScope scope("test", "scope3");
+        }
+        recorder.stop();
+
+        EXPECT_EQ(1, recorder.get_event_count());
+    }
+
+    struct RecordEvents
+    {
+        size_t m_event_count;
+
+        explicit RecordEvents(const size_t event_count)
+          : m_event_count(event_count)
+        {
+        }
+
+        void operator()() const
+        {
+            for (size_t i = 0; i < m_event_count; ++i)
+                TraceScope scope("test", "scope");
+        }
+    };
+
+    TEST_CASE(Record_FromMultipleThreads_RecordsAllEvents)
+    {
+        const size_t ThreadCount = 4;
+        const size_t EventsPerThread = 5000;
+
+        TraceRecorder& recorder = TraceRecorder::instance();
+
+        recorder.start();
+
+        std::vector<boost::thread*> threads;
+        for (size_t i = 0; i < ThreadCount; ++i)
+            threads.push_back(new boost::thread(RecordEvents(EventsPerThread)));
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        recorder.stop();
+
+        // Events of threads that have exited are still available.
+        EXPECT_EQ(ThreadCount * EventsPerThread, recorder.get_event_count());
+    }
+
+    TEST_CASE(WriteChromeTrace_WritesCompleteEventsAndThreadNames)
+    {
+        const char* Filename = "unit tests/outputs/test_tracerecorder.json";
+
+        TraceRecorder& recorder = TraceRecorder::instance();
+
+        recorder.start();
+        recorder.set_current_thread_name("test \"thread\"");
+        {
+            TraceScope scope("test", "tile", "x", 3, "y", -4);
+        }
+        recorder.stop();
+
+        ASSERT_TRUE(recorder.write_chrome_trace(Filename));
+
+        std::ifstream file(Filename);
+        const std::string contents(
+            (std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>());
+
+        EXPECT_EQ(0, contents.find("{\"traceEvents\":["));
+        EXPECT_NEQ(std::string::npos, contents.find("\"args\":{\"name\":\"test \\\"thread\\\"\"}"));
+        EXPECT_NEQ(std::string::npos, contents.find("{\"name\":\"tile\",\"cat\":\"test\",\"ph\":\"X\""));
+        EXPECT_NEQ(std::string::npos, contents.find("\"args\":{\"x\":3,\"y\":-4}}"));
+    }
+}
@@ -253,6 +253,17 @@ std::uint64_t System::get_total_virtual_memory_size()
     return static_cast<std::uint64_t>(mem_info.ullTotalPageFile);
 }
 
+std::uint64_t System::get_process_resident_memory_size()
+{
+    PROCESS_MEMORY_COUNTERS pmc;
+    GetProcessMemoryInfo(
+        GetCurrentProcess(),
+        &pmc,
+        sizeof(pmc));
+
+    return pmc.WorkingSetSize;
+}
+
 std::uint64_t System::get_process_virtual_memory_size()
 {
     // Reference: http://stackoverflow.com/questions/63166/how-to-determine-cpu-and-memory-consumption-from-inside-a-process
@@ -386,6 +397,35 @@ std::uint64_t System::get_total_virtual_memory_size()
     else return 0;
 }
 
+std::uint64_t System::get_process_resident_memory_size()
+{
+    // Reference: http://nadeausoftware.com/articles/2012/07/c_c_tip_how_get_process_resident_set_size_physical_memory_use
+
+#ifdef MACH_TASK_BASIC_INFO
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t info_count = MACH_TASK_BASIC_INFO_COUNT;
+
+    if (task_info(
+            mach_task_self(),
+            MACH_TASK_BASIC_INFO,
+            (task_info_t)&info,
+            &info_count) != KERN_SUCCESS)
+        return 0;
+#else
+    struct task_basic_info info;
+    mach_msg_type_number_t info_count = TASK_BASIC_INFO_COUNT;
+
+    if (task_info(
+            mach_task_self(),
+            TASK_BASIC_INFO,
+            (task_info_t)&info,
+            &info_count) != KERN_SUCCESS)
+        return 0;
+#endif
+
+    return info.resident_size;
+}
+
 std::uint64_t System::get_process_virtual_memory_size()
 {
     // Reference: http://nadeausoftware.com/articles/2012/07/c_c_tip_how_get_process_resident_set_size_physical_memory_use
@@ -522,6 +562,26 @@ std::uint64_t System::get_total_virtual_memory_size()
     return result;
 }
 
+std::uint64_t System::get_process_resident_memory_size()
+{
+    // Reference: http://nadeausoftware.com/articles/2012/07/c_c_tip_how_get_process_resident_set_size_physical_memory_use
+
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp == nullptr)
+        return 0;
+
+    long rss = 0;
+    if (fscanf(fp, "%*s%ld", &rss) != 1)
+    {
+        fclose(fp);
+        return 0;
+    }
+
+    fclose(fp);
+
+    return static_cast<std::uint64_t>(rss) * sysconf(_SC_PAGESIZE);
+}
+
 std::uint64_t System::get_process_virtual_memory_size()
 {
     // todo: this is wrong, it returns RSS instead of virtual memory.
@@ -924,6 +984,12 @@ std::uint64_t System::get_total_virtual_memory_size()
     return get_total_physical_memory_size() + swap;
 }
 
+std::uint64_t System::get_process_resident_memory_size()
+{
+    // todo: implement.
+    return 0;
+}
+
 std::uint64_t System::get_process_virtual_memory_size()
 {
     // todo: this is wrong, it returns peak RSS instead of virtual memory.
@@ -174,6 +174,9 @@ class APPLESEED_DLLSYMBOL System
     // Return the total size in bytes of the physical memory.
     static std::uint64_t get_total_physical_memory_size();
 
+    // Return the amount in bytes of physical memory used by the current process (its resident set size).
+    static std::uint64_t get_process_resident_memory_size();
+
     //
     // Virtual memory.
     //
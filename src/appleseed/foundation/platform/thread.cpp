@@ -52,6 +52,8 @@
 #include <pthread.h>
 #include <pthread_np.h>
 #elif defined __linux__
+#include <pthread.h>
+#include <sched.h>
 #include <sys/prctl.h>
 #endif
 
@@ -363,21 +365,73 @@ void yield()
         ThreadPriorityContext   m_thread_priority_context;
         std::uint64_t           m_thread_affinity_mask;
 
-        explicit Impl(Logger* logger)
+        Impl(Logger* logger, const bool pin_thread)
           : m_process_priority_context(ProcessPriorityHighest, logger)
           , m_thread_priority_context(ProcessPriorityHighest, logger)
-          , m_thread_affinity_mask(SetThreadAffinityMask(GetCurrentThread(), 1))
+          , m_thread_affinity_mask(pin_thread ? SetThreadAffinityMask(GetCurrentThread(), 1) : 0)
+        {
+        }
+
+        ~Impl()
+        {
+            if (m_thread_affinity_mask != 0)
+                SetThreadAffinityMask(GetCurrentThread(), m_thread_affinity_mask);
+        }
+    };
+
+    BenchmarkingThreadContext::BenchmarkingThreadContext(
+        Logger*                 logger,
+        const bool              pin_thread)
+      : impl(new Impl(logger, pin_thread))
+    {
+    }
+
+    BenchmarkingThreadContext::~BenchmarkingThreadContext()
+    {
+        delete impl;
+    }
+
+#elif defined __linux__
+
+    struct BenchmarkingThreadContext::Impl
+    {
+        cpu_set_t               m_thread_affinity;
+        bool                    m_pinned;
+
+        Impl(Logger* logger, const bool pin_thread)
+          : m_pinned(false)
         {
+            if (!pin_thread)
+                return;
+
+            // Pin the thread to the processor it is currently running on.
+            const int cpu = sched_getcpu();
+
+            if (cpu >= 0 &&
+                pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &m_thread_affinity) == 0)
+            {
+                cpu_set_t pinned_affinity;
+                CPU_ZERO(&pinned_affinity);
+                CPU_SET(cpu, &pinned_affinity);
+
+                m_pinned = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &pinned_affinity) == 0;
+            }
+
+            if (!m_pinned && logger)
+                LOG_WARNING(*logger, "failed to pin benchmarking thread to a single processor.");
         }
 
         ~Impl()
         {
-            SetThreadAffinityMask(GetCurrentThread(), m_thread_affinity_mask);
+            if (m_pinned)
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &m_thread_affinity);
         }
     };
 
-    BenchmarkingThreadContext::BenchmarkingThreadContext(Logger* logger)
-      : impl(new Impl(logger))
+    BenchmarkingThreadContext::BenchmarkingThreadContext(
+        Logger*                 logger,
+        const bool              pin_thread)
+      : impl(new Impl(logger, pin_thread))
     {
     }
 
@@ -388,7 +442,9 @@ void yield()
 
 #else
 
-    BenchmarkingThreadContext::BenchmarkingThreadContext(Logger* logger)
+    BenchmarkingThreadContext::BenchmarkingThreadContext(
+        Logger*                 logger,
+        const bool              pin_thread)
     {
         // todo: implement.
     }
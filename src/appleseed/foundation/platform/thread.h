@@ -226,8 +226,11 @@ class APPLESEED_DLLSYMBOL BenchmarkingThreadContext
   : public NonCopyable
 {
   public:
-    // The constructor enables the benchmarking mode.
-    explicit BenchmarkingThreadContext(Logger* logger = nullptr);
+    // The constructor enables the benchmarking mode. If `pin_thread` is true,
+    // the calling thread is also pinned to a single processor.
+    explicit BenchmarkingThreadContext(
+        Logger*                 logger = nullptr,
+        const bool              pin_thread = true);
 
     // The destructor restores previous settings.
     ~BenchmarkingThreadContext();
@@ -82,6 +82,11 @@ class AttributeSet
         const ChannelID     channel_id,
         const size_t        count);
 
+    // Resize a given attribute channel. New attributes are left uninitialized.
+    void resize_attributes(
+        const ChannelID     channel_id,
+        const size_t        count);
+
     // Insert a new attribute at the end of a given attribute channel.
     // Return the index of the attribute in the attribute channel.
     template <typename T>
@@ -142,6 +147,18 @@ inline void AttributeSet::reserve_attributes(
     channel->m_storage.reserve(count * channel->m_value_size);
 }
 
+inline void AttributeSet::resize_attributes(
+    const ChannelID         channel_id,
+    const size_t            count)
+{
+    // Get the channel descriptor.
+    assert(channel_id < m_channels.size());
+    Channel* channel = m_channels[channel_id];
+
+    // Resize the storage.
+    channel->m_storage.resize(count * channel->m_value_size);
+}
+
 template <typename T>
 inline size_t AttributeSet::push_attribute(
     const ChannelID         channel_id,
@@ -31,8 +31,10 @@
 
 // Interface headers.
 #include "foundation/utility/benchmark/benchmarkaggregator.h"
+#include "foundation/utility/benchmark/benchmarkcomparison.h"
 #include "foundation/utility/benchmark/benchmarkdatapoint.h"
 #include "foundation/utility/benchmark/benchmarklistenerbase.h"
+#include "foundation/utility/benchmark/benchmarkparams.h"
 #include "foundation/utility/benchmark/benchmarkresult.h"
 #include "foundation/utility/benchmark/benchmarkseries.h"
 #include "foundation/utility/benchmark/benchmarksuiterepository.h"
@@ -40,6 +42,7 @@
 #include "foundation/utility/benchmark/ibenchmarkcase.h"
 #include "foundation/utility/benchmark/ibenchmarkcasefactory.h"
 #include "foundation/utility/benchmark/ibenchmarklistener.h"
+#include "foundation/utility/benchmark/jsonfilebenchmarklistener.h"
 #include "foundation/utility/benchmark/loggerbenchmarklistener.h"
 #include "foundation/utility/benchmark/timingresult.h"
 #include "foundation/utility/benchmark/xmlfilebenchmarklistener.h"
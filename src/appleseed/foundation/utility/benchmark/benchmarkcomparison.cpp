@@ -0,0 +1,519 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "benchmarkcomparison.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace foundation
+{
+
+//
+// BenchmarkComparison class implementation.
+//
+
+namespace
+{
+    //
+    // A minimal JSON document model and parser, sufficient to read back the files
+    // written by JSONFileBenchmarkListener.
+    //
+
+    struct JSONValue
+    {
+        enum Type { Null, Boolean, Number, String, Array, Object };
+
+        Type                        m_type;
+        bool                        m_boolean;
+        double                      m_number;
+        std::string                 m_string;
+        std::vector<std::string>    m_names;        // member names, if this is an object
+        std::vector<JSONValue>      m_elements;     // array elements or member values
+
+        JSONValue()
+          : m_type(Null)
+          , m_boolean(false)
+          , m_number(0.0)
+        {
+        }
+
+        const JSONValue* find_member(const char* name) const
+        {
+            if (m_type != Object)
+                return nullptr;
+
+            for (size_t i = 0, e = m_names.size(); i < e; ++i)
+            {
+                if (m_names[i] == name)
+                    return &m_elements[i];
+            }
+
+            return nullptr;
+        }
+
+        double get_number(const char* name, const double default_value) const
+        {
+            const JSONValue* value = find_member(name);
+            return value && value->m_type == Number ? value->m_number : default_value;
+        }
+
+        const char* get_string(const char* name) const
+        {
+            const JSONValue* value = find_member(name);
+            return value && value->m_type == String ? value->m_string.c_str() : nullptr;
+        }
+    };
+
+    class JSONParser
+    {
+      public:
+        JSONParser(const char* begin, const char* end)
+          : m_ptr(begin)
+          , m_end(end)
+        {
+        }
+
+        bool parse_document(JSONValue& value)
+        {
+            if (!parse_value(value))
+                return false;
+
+            skip_whitespace();
+
+            return m_ptr == m_end;
+        }
+
+      private:
+        const char* m_ptr;
+        const char* m_end;
+
+        void skip_whitespace()
+        {
+            while (m_ptr < m_end && (*m_ptr == ' ' || *m_ptr == '\t' || *m_ptr == '\n' || *m_ptr == '\r'))
+                ++m_ptr;
+        }
+
+        bool consume(const char c)
+        {
+            skip_whitespace();
+
+            if (m_ptr < m_end && *m_ptr == c)
+            {
+                ++m_ptr;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool consume_literal(const char* literal)
+        {
+            const size_t length = std::strlen(literal);
+
+            if (static_cast<size_t>(m_end - m_ptr) < length || std::strncmp(m_ptr, literal, length) != 0)
+                return false;
+
+            m_ptr += length;
+            return true;
+        }
+
+        bool parse_value(JSONValue& value)
+        {
+            skip_whitespace();
+
+            if (m_ptr == m_end)
+                return false;
+
+            switch (*m_ptr)
+            {
+              case '{':
+                value.m_type = JSONValue::Object;
+                return parse_object(value);
+
+              case '[':
+                value.m_type = JSONValue::Array;
+                return parse_array(value);
+
+              case '"':
+                value.m_type = JSONValue::String;
+                return parse_string(value.m_string);
+
+              case 't':
+                value.m_type = JSONValue::Boolean;
+                value.m_boolean = true;
+                return consume_literal("true");
+
+              case 'f':
+                value.m_type = JSONValue::Boolean;
+                value.m_boolean = false;
+                return consume_literal("false");
+
+              case 'n':
+                value.m_type = JSONValue::Null;
+                return consume_literal("null");
+
+              default:
+                value.m_type = JSONValue::Number;
+                return parse_number(value.m_number);
+            }
+        }
+
+        bool parse_object(JSONValue& value)
+        {
+            ++m_ptr;
+
+            if (consume('}'))
+                return true;
+
+            do
+            {
+                skip_whitespace();
+
+                std::string name;
+                if (m_ptr == m_end || *m_ptr != '"' || !parse_string(name))
+                    return false;
+
+                if (!consume(':'))
+                    return false;
+
+                value.m_names.push_back(name);
+                value.m_elements.emplace_back();
+
+                if (!parse_value(value.m_elements.back()))
+                    return false;
+            } while (consume(','));
+
+            return consume('}');
+        }
+
+        bool parse_array(JSONValue& value)
+        {
+            ++m_ptr;
+
+            if (consume(']'))
+                return true;
+
+            do
+            {
+                value.m_elements.emplace_back();
+
+                if (!parse_value(value.m_elements.back()))
+                    return false;
+            } while (consume(','));
+
+            return consume(']');
+        }
+
+        bool parse_string(std::string& s)
+        {
+            ++m_ptr;
+
+            while (m_ptr < m_end)
+            {
+                const char c = *m_ptr++;
+
+                if (c == '"')
+                    return true;
+
+                if (c != '\\')
+                {
+                    s += c;
+                    continue;
+                }
+
+                if (m_ptr == m_end)
+                    return false;
+
+                const char e = *m_ptr++;
+
+                switch (e)
+                {
+                  case '"': s += '"'; break;
+                  case '\\': s += '\\'; break;
+                  case '/': s += '/'; break;
+                  case 'b': s += '\b'; break;
+                  case 'f': s += '\f'; break;
+                  case 'n': s += '\n'; break;
+                  case 'r': s += '\r'; break;
+                  case 't': s += '\t'; break;
+
+                  case 'u':
+                    {
+                        if (m_end - m_ptr < 4)
+                            return false;
+
+                        const std::string digits(m_ptr, m_ptr + 4);
+                        char* digits_end;
+                        const unsigned long code = std::strtoul(digits.c_str(), &digits_end, 16);
+
+                        if (digits_end != digits.c_str() + 4)
+                            return false;
+
+                        m_ptr += 4;
+
+                        // Encode the code point in UTF-8 (surrogate pairs are not combined).
+                        if (code < 0x80)
+                            s += static_cast<char>(code);
+                        else if (code < 0x800)
+                        {
+                            s += static_cast<char>(0xC0 | (code >> 6));
+                            s += static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                        else
+                        {
+                            s += static_cast<char>(0xE0 | (code >> 12));
+                            s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                            s += static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                    }
+                    break;
+
+                  default:
+                    return false;
+                }
+            }
+
+            return false;
+        }
+
+        bool parse_number(double& number)
+        {
+            // The document is not null-terminated; copy the characters that may be part of the number.
+            const char* end = m_ptr;
+            while (end < m_end && std::strchr("+-.0123456789eE", *end) != nullptr)
+                ++end;
+
+            if (end == m_ptr)
+                return false;
+
+            const std::string text(m_ptr, end);
+            char* text_end;
+            number = std::strtod(text.c_str(), &text_end);
+
+            if (text_end != text.c_str() + text.size())
+                return false;
+
+            m_ptr = end;
+            return true;
+        }
+    };
+
+    struct CaseTiming
+    {
+        std::string     m_suite_name;
+        std::string     m_case_name;
+        double          m_median;           // in seconds
+        double          m_ci_low;           // in seconds
+        double          m_ci_high;          // in seconds
+    };
+
+    typedef std::vector<CaseTiming> CaseTimingVector;
+
+    bool read_results_file(const char* path, CaseTimingVector& timings)
+    {
+        assert(path);
+
+        timings.clear();
+
+        std::ifstream file(path);
+        if (!file.is_open())
+            return false;
+
+        const std::string contents(
+            (std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>());
+
+        JSONValue root;
+        JSONParser parser(contents.data(), contents.data() + contents.size());
+        if (!parser.parse_document(root))
+            return false;
+
+        const JSONValue* suites = root.find_member("suites");
+        if (suites == nullptr || suites->m_type != JSONValue::Array)
+            return false;
+
+        for (const JSONValue& suite : suites->m_elements)
+        {
+            const char* suite_name = suite.get_string("name");
+            const JSONValue* cases = suite.find_member("cases");
+
+            if (suite_name == nullptr || cases == nullptr || cases->m_type != JSONValue::Array)
+                return false;
+
+            for (const JSONValue& c : cases->m_elements)
+            {
+                const char* case_name = c.get_string("name");
+                if (case_name == nullptr)
+                    return false;
+
+                // Skip benchmark cases without timing results (e.g. cases that failed).
+                const double frequency = c.get_number("frequency", 0.0);
+                const double median_ticks = c.get_number("median_ticks", -1.0);
+                if (frequency <= 0.0 || median_ticks < 0.0)
+                    continue;
+
+                CaseTiming timing;
+                timing.m_suite_name = suite_name;
+                timing.m_case_name = case_name;
+                timing.m_median = median_ticks / frequency;
+                timing.m_ci_low = c.get_number("ci_low_ticks", median_ticks) / frequency;
+                timing.m_ci_high = c.get_number("ci_high_ticks", median_ticks) / frequency;
+                timings.push_back(timing);
+            }
+        }
+
+        return true;
+    }
+}
+
+struct BenchmarkComparison::Impl
+{
+    CaseTimingVector        m_baseline;
+    CaseTimingVector        m_current;
+    std::vector<Case>       m_cases;
+    size_t                  m_regression_count;
+    size_t                  m_unmatched_case_count;
+
+    Impl()
+      : m_regression_count(0)
+      , m_unmatched_case_count(0)
+    {
+    }
+
+    void clear_comparison()
+    {
+        m_cases.clear();
+        m_regression_count = 0;
+        m_unmatched_case_count = 0;
+    }
+};
+
+BenchmarkComparison::BenchmarkComparison()
+  : impl(new Impl())
+{
+}
+
+BenchmarkComparison::~BenchmarkComparison()
+{
+    delete impl;
+}
+
+bool BenchmarkComparison::read_baseline(const char* path)
+{
+    impl->clear_comparison();
+    return read_results_file(path, impl->m_baseline);
+}
+
+bool BenchmarkComparison::read_current(const char* path)
+{
+    impl->clear_comparison();
+    return read_results_file(path, impl->m_current);
+}
+
+void BenchmarkComparison::compare(const double threshold)
+{
+    assert(threshold >= 0.0);
+
+    impl->clear_comparison();
+
+    typedef std::map<std::pair<std::string, std::string>, size_t> CaseIndexMap;
+
+    CaseIndexMap current_indices;
+    for (size_t i = 0, e = impl->m_current.size(); i < e; ++i)
+    {
+        const CaseTiming& timing = impl->m_current[i];
+        current_indices[std::make_pair(timing.m_suite_name, timing.m_case_name)] = i;
+    }
+
+    size_t matched_case_count = 0;
+
+    for (const CaseTiming& baseline : impl->m_baseline)
+    {
+        const CaseIndexMap::const_iterator it =
+            current_indices.find(std::make_pair(baseline.m_suite_name, baseline.m_case_name));
+
+        if (it == current_indices.end())
+        {
+            ++impl->m_unmatched_case_count;
+            continue;
+        }
+
+        const CaseTiming& current = impl->m_current[it->second];
+        ++matched_case_count;
+
+        Case c;
+        c.m_suite_name = baseline.m_suite_name.c_str();
+        c.m_case_name = baseline.m_case_name.c_str();
+        c.m_baseline_time = baseline.m_median;
+        c.m_current_time = current.m_median;
+        c.m_relative_change =
+            baseline.m_median > 0.0
+                ? (current.m_median - baseline.m_median) / baseline.m_median
+                : 0.0;
+        c.m_regression = c.m_relative_change > threshold && current.m_ci_low > baseline.m_ci_high;
+        c.m_improvement = c.m_relative_change < -threshold && current.m_ci_high < baseline.m_ci_low;
+        impl->m_cases.push_back(c);
+
+        if (c.m_regression)
+            ++impl->m_regression_count;
+    }
+
+    impl->m_unmatched_case_count += impl->m_current.size() - matched_case_count;
+}
+
+size_t BenchmarkComparison::get_case_count() const
+{
+    return impl->m_cases.size();
+}
+
+const BenchmarkComparison::Case& BenchmarkComparison::get_case(const size_t index) const
+{
+    assert(index < impl->m_cases.size());
+    return impl->m_cases[index];
+}
+
+size_t BenchmarkComparison::get_regression_count() const
+{
+    return impl->m_regression_count;
+}
+
+size_t BenchmarkComparison::get_unmatched_case_count() const
+{
+    return impl->m_unmatched_case_count;
+}
+
+}   // namespace foundation
@@ -0,0 +1,94 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// Compare two benchmark result files written by JSONFileBenchmarkListener.
+//
+// Running times are compared using their median across timing runs. A benchmark
+// case is flagged as a regression (resp. an improvement) when its median running
+// time increased (resp. decreased) by more than a given relative threshold and
+// the 95% confidence intervals of the two medians do not overlap.
+//
+
+class APPLESEED_DLLSYMBOL BenchmarkComparison
+  : public NonCopyable
+{
+  public:
+    struct Case
+    {
+        const char* m_suite_name;
+        const char* m_case_name;
+        double      m_baseline_time;        // median running time in the baseline, in seconds
+        double      m_current_time;         // median running time in the current results, in seconds
+        double      m_relative_change;      // (current - baseline) / baseline
+        bool        m_regression;
+        bool        m_improvement;
+    };
+
+    // Constructor.
+    BenchmarkComparison();
+
+    // Destructor.
+    ~BenchmarkComparison();
+
+    // Read the results files. Return false in case of i/o or parsing error.
+    bool read_baseline(const char* path);
+    bool read_current(const char* path);
+
+    // Compare the benchmark cases present in both the baseline and the current results.
+    void compare(const double threshold);
+
+    // Access the compared benchmark cases.
+    size_t get_case_count() const;
+    const Case& get_case(const size_t index) const;
+
+    // Return the number of benchmark cases flagged as regressions.
+    size_t get_regression_count() const;
+
+    // Return the number of benchmark cases only present in one of the two files.
+    size_t get_unmatched_case_count() const;
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}   // namespace foundation
@@ -192,17 +192,19 @@ void BenchmarkSuite::register_case(IBenchmarkCaseFactory* factory)
     impl->m_factories.push_back(factory);
 }
 
-void BenchmarkSuite::run(BenchmarkResult& suite_result) const
+void BenchmarkSuite::run(
+    BenchmarkResult&        suite_result,
+    const BenchmarkParams&  params) const
 {
     PassThroughFilter filter;
-    run(filter, suite_result);
+    run(filter, suite_result, params);
 }
 
 void BenchmarkSuite::run(
-    const IFilter&      filter,
-    BenchmarkResult&    suite_result) const
+    const IFilter&          filter,
+    BenchmarkResult&        suite_result,
+    const BenchmarkParams&  params) const
 {
-    BenchmarkingThreadContext benchmarking_context;
     bool has_begun_suite = false;
 
     for (size_t i = 0; i < impl->m_factories.size(); ++i)
@@ -224,6 +226,12 @@ void BenchmarkSuite::run(
         // Instantiate the benchmark case.
         std::unique_ptr<IBenchmarkCase> benchmark(factory->create());
 
+        // Configure the benchmarking thread for this case only, after the case was instantiated,
+        // such that threads created by the case's constructor are not pinned along with it.
+        BenchmarkingThreadContext benchmarking_context(
+            nullptr,
+            params.m_pin_thread && !benchmark->is_multithreaded());
+
         // Tell the listeners that a benchmark case is about to be executed.
         suite_result.begin_case(*this, *benchmark.get());
 
@@ -239,6 +247,10 @@ void BenchmarkSuite::run(
             // compute accurate call rates.
             Impl::StopwatchType stopwatch(100000);
 
+            // Warm up caches and branch predictors.
+            for (size_t j = 0; j < params.m_warmup_count; ++j)
+                benchmark->run();
+
             // Estimate benchmarking parameters.
             const size_t measurement_count =
                 Impl::compute_measurement_count(benchmark.get(), stopwatch);
@@ -247,20 +259,32 @@ void BenchmarkSuite::run(
             const double overhead_ticks =
                 Impl::measure_call_overhead_ticks(stopwatch, measurement_count);
 
-            // Run the benchmark case.
-            const double runtime_ticks =
-                Impl::measure_runtime(
-                    benchmark.get(),
-                    stopwatch,
-                    BenchmarkSuite::Impl::measure_runtime_ticks,
-                    measurement_count);
+            // Run the benchmark case as a number of independent timing runs. Measurements
+            // are split across runs such that the run count doesn't affect benchmarking time.
+            const size_t run_count = std::max<size_t>(params.m_run_count, 1);
+            const size_t run_measurement_count = std::max<size_t>(measurement_count / run_count, 1);
+            std::vector<double> run_ticks(run_count);
+            double runtime_ticks = std::numeric_limits<double>::max();
+
+            for (size_t j = 0; j < run_count; ++j)
+            {
+                const double ticks =
+                    Impl::measure_runtime(
+                        benchmark.get(),
+                        stopwatch,
+                        BenchmarkSuite::Impl::measure_runtime_ticks,
+                        run_measurement_count);
+                runtime_ticks = std::min(runtime_ticks, ticks);
+                run_ticks[j] = ticks > overhead_ticks ? ticks - overhead_ticks : 0.0;
+            }
 
             // Gather the timing results.
             TimingResult timing_result;
-            timing_result.m_iteration_count = 1;
-            timing_result.m_measurement_count = measurement_count;
+            timing_result.m_iteration_count = benchmark->get_iteration_count();
+            timing_result.m_measurement_count = run_measurement_count * run_count;
             timing_result.m_frequency = static_cast<double>(stopwatch.get_timer().frequency());
             timing_result.m_ticks = runtime_ticks > overhead_ticks ? runtime_ticks - overhead_ticks : 0.0;
+            compute_run_statistics(run_ticks.data(), run_count, timing_result);
 
             // Post the timing result.
             suite_result.write(
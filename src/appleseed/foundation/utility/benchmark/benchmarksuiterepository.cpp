@@ -68,15 +68,18 @@ void BenchmarkSuiteRepository::register_suite(BenchmarkSuite* suite)
     impl->m_suites.push_back(suite);
 }
 
-void BenchmarkSuiteRepository::run(BenchmarkResult& result) const
+void BenchmarkSuiteRepository::run(
+    BenchmarkResult&        result,
+    const BenchmarkParams&  params) const
 {
     PassThroughFilter filter;
-    run(filter, result);
+    run(filter, result, params);
 }
 
 void BenchmarkSuiteRepository::run(
-    const IFilter&      filter,
-    BenchmarkResult&    result) const
+    const IFilter&          filter,
+    BenchmarkResult&        result,
+    const BenchmarkParams&  params) const
 {
     for (size_t i = 0; i < impl->m_suites.size(); ++i)
     {
@@ -88,8 +91,8 @@ void BenchmarkSuiteRepository::run(
 
         // Run the benchmark suite.
         if (filter.accepts(suite.get_name()))
-            suite.run(suite_result);
-        else suite.run(filter, suite_result);
+            suite.run(suite_result, params);
+        else suite.run(filter, suite_result, params);
 
         // Merge the benchmark suite result into the final benchmark result.
         result.merge(suite_result);
@@ -31,6 +31,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/singleton.h"
+#include "foundation/utility/benchmark/benchmarkparams.h"
 
 // appleseed.main headers.
 #include "main/dllsymbol.h"
@@ -55,12 +56,15 @@ class APPLESEED_DLLSYMBOL BenchmarkSuiteRepository
     void register_suite(BenchmarkSuite* suite);
 
     // Run all the registered benchmark suites.
-    void run(BenchmarkResult& result) const;
+    void run(
+        BenchmarkResult&        result,
+        const BenchmarkParams&  params = BenchmarkParams()) const;
 
     // Run those benchmark suites whose name pass a given filter.
     void run(
-        const IFilter&      filter,
-        BenchmarkResult&    result) const;
+        const IFilter&          filter,
+        BenchmarkResult&        result,
+        const BenchmarkParams&  params = BenchmarkParams()) const;
 
   private:
     friend class Singleton<BenchmarkSuiteRepository>;
@@ -35,6 +35,10 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+#include <cstdint>
+
 namespace foundation
 {
 
@@ -54,6 +58,27 @@ class APPLESEED_DLLSYMBOL IBenchmarkCase
 
     // Run the benchmark case.
     virtual void run() = 0;
+
+    // Return the number of iterations performed by each call to run().
+    // Listeners use it to report throughput in iterations per second.
+    virtual size_t get_iteration_count() const
+    {
+        return 1;
+    }
+
+    // Return true if run() spawns threads. Such benchmark cases are never run on a
+    // thread pinned to a single processor since, on Linux, new threads inherit the
+    // processor affinity of the thread that creates them.
+    virtual bool is_multithreaded() const
+    {
+        return false;
+    }
+
+    // Return the amount of memory in bytes used by the benchmark case, or 0 if unknown.
+    virtual std::uint64_t get_memory_size() const
+    {
+        return 0;
+    }
 };
 
 }   // namespace foundation
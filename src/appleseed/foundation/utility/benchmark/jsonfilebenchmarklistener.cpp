@@ -0,0 +1,323 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "jsonfilebenchmarklistener.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/appleseed.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/benchmark/benchmarksuite.h"
+#include "foundation/utility/benchmark/ibenchmarkcase.h"
+#include "foundation/utility/benchmark/timingresult.h"
+#include "foundation/utility/indenter.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace foundation
+{
+
+//
+// JSONFileBenchmarkListener class implementation.
+//
+
+namespace
+{
+    void write_json_string(FILE* file, const char* s)
+    {
+        fputc('"', file);
+
+        for (; *s; ++s)
+        {
+            const char c = *s;
+
+            if (c == '"' || c == '\\')
+            {
+                fputc('\\', file);
+                fputc(c, file);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+                fprintf(file, "\\u%04x", static_cast<unsigned int>(c));
+            else fputc(c, file);
+        }
+
+        fputc('"', file);
+    }
+}
+
+struct JSONFileBenchmarkListener::Impl
+{
+    FILE*                       m_file;
+    Indenter                    m_indenter;
+    bool                        m_has_header;
+    size_t                      m_suite_count;
+    size_t                      m_case_count;
+
+    // Results of the current benchmark case, written when the case ends.
+    std::vector<std::string>    m_messages;
+    bool                        m_has_timing_result;
+    TimingResult                m_timing_result;
+
+    Impl()
+      : m_file(nullptr)
+      , m_indenter(4)
+      , m_has_header(false)
+      , m_suite_count(0)
+      , m_case_count(0)
+      , m_has_timing_result(false)
+    {
+    }
+
+    void write_field(const char* name, const char* value)
+    {
+        fprintf(m_file, ",\n%s\"%s\": ", m_indenter.c_str(), name);
+        write_json_string(m_file, value);
+    }
+
+    void write_field(const char* name, const size_t value)
+    {
+        fprintf(m_file, ",\n%s\"%s\": " FMT_SIZE_T, m_indenter.c_str(), name, value);
+    }
+
+    void write_uint64_field(const char* name, const std::uint64_t value)
+    {
+        fprintf(m_file, ",\n%s\"%s\": " FMT_UINT64, m_indenter.c_str(), name, value);
+    }
+
+    void write_field(const char* name, const double value)
+    {
+        fprintf(m_file, ",\n%s\"%s\": %.9g", m_indenter.c_str(), name, value);
+    }
+};
+
+JSONFileBenchmarkListener::JSONFileBenchmarkListener()
+  : impl(new Impl())
+{
+}
+
+JSONFileBenchmarkListener::~JSONFileBenchmarkListener()
+{
+    close();
+
+    delete impl;
+}
+
+void JSONFileBenchmarkListener::release()
+{
+    delete this;
+}
+
+void JSONFileBenchmarkListener::begin_suite(
+    const BenchmarkSuite&   benchmark_suite)
+{
+    if (!impl->m_has_header)
+    {
+        write_file_header();
+        impl->m_has_header = true;
+    }
+
+    fprintf(
+        impl->m_file,
+        "%s%s{\n",
+        impl->m_suite_count > 0 ? ",\n" : "",
+        impl->m_indenter.c_str());
+
+    ++impl->m_indenter;
+
+    fprintf(impl->m_file, "%s\"name\": ", impl->m_indenter.c_str());
+    write_json_string(impl->m_file, benchmark_suite.get_name());
+    fprintf(impl->m_file, ",\n%s\"cases\": [\n", impl->m_indenter.c_str());
+
+    ++impl->m_indenter;
+
+    ++impl->m_suite_count;
+    impl->m_case_count = 0;
+}
+
+void JSONFileBenchmarkListener::end_suite(
+    const BenchmarkSuite&   benchmark_suite)
+{
+    --impl->m_indenter;
+
+    fprintf(impl->m_file, "\n%s]\n", impl->m_indenter.c_str());
+
+    --impl->m_indenter;
+
+    fprintf(impl->m_file, "%s}", impl->m_indenter.c_str());
+}
+
+void JSONFileBenchmarkListener::begin_case(
+    const BenchmarkSuite&   benchmark_suite,
+    const IBenchmarkCase&   benchmark_case)
+{
+    impl->m_messages.clear();
+    impl->m_has_timing_result = false;
+}
+
+void JSONFileBenchmarkListener::end_case(
+    const BenchmarkSuite&   benchmark_suite,
+    const IBenchmarkCase&   benchmark_case)
+{
+    fprintf(
+        impl->m_file,
+        "%s%s{\n",
+        impl->m_case_count > 0 ? ",\n" : "",
+        impl->m_indenter.c_str());
+
+    ++impl->m_indenter;
+
+    fprintf(impl->m_file, "%s\"name\": ", impl->m_indenter.c_str());
+    write_json_string(impl->m_file, benchmark_case.get_name());
+
+    if (!impl->m_messages.empty())
+    {
+        fprintf(impl->m_file, ",\n%s\"messages\": [", impl->m_indenter.c_str());
+
+        for (size_t i = 0, e = impl->m_messages.size(); i < e; ++i)
+        {
+            if (i > 0)
+                fputs(", ", impl->m_file);
+            write_json_string(impl->m_file, impl->m_messages[i].c_str());
+        }
+
+        fputc(']', impl->m_file);
+    }
+
+    if (impl->m_has_timing_result)
+    {
+        const TimingResult& timing_result = impl->m_timing_result;
+        impl->write_field("iterations", timing_result.m_iteration_count);
+        impl->write_field("measurements", timing_result.m_measurement_count);
+        impl->write_field("runs", timing_result.m_run_count);
+        impl->write_field("frequency", timing_result.m_frequency);
+        impl->write_field("ticks", timing_result.m_ticks);
+        impl->write_field("median_ticks", timing_result.m_median_ticks);
+        impl->write_field("mad_ticks", timing_result.m_mad_ticks);
+        impl->write_field("ci_low_ticks", timing_result.m_ci_low_ticks);
+        impl->write_field("ci_high_ticks", timing_result.m_ci_high_ticks);
+    }
+
+    const std::uint64_t memory_size = benchmark_case.get_memory_size();
+    if (memory_size > 0)
+        impl->write_uint64_field("memory_size", memory_size);
+
+    --impl->m_indenter;
+
+    fprintf(impl->m_file, "\n%s}", impl->m_indenter.c_str());
+
+    ++impl->m_case_count;
+}
+
+void JSONFileBenchmarkListener::write(
+    const BenchmarkSuite&   benchmark_suite,
+    const IBenchmarkCase&   benchmark_case,
+    const char*             file,
+    const size_t            line,
+    const char*             message)
+{
+    impl->m_messages.emplace_back(message);
+}
+
+void JSONFileBenchmarkListener::write(
+    const BenchmarkSuite&   benchmark_suite,
+    const IBenchmarkCase&   benchmark_case,
+    const char*             file,
+    const size_t            line,
+    const TimingResult&     timing_result)
+{
+    impl->m_has_timing_result = true;
+    impl->m_timing_result = timing_result;
+}
+
+bool JSONFileBenchmarkListener::open(const char* filename)
+{
+    assert(filename);
+
+    close();
+
+    impl->m_file = fopen(filename, "wt");
+
+    return impl->m_file != nullptr;
+}
+
+void JSONFileBenchmarkListener::close()
+{
+    if (impl->m_file)
+    {
+        if (impl->m_has_header)
+            write_file_footer();
+
+        fclose(impl->m_file);
+
+        impl->m_file = nullptr;
+        impl->m_has_header = false;
+        impl->m_suite_count = 0;
+    }
+}
+
+bool JSONFileBenchmarkListener::is_open() const
+{
+    return impl->m_file != nullptr;
+}
+
+void JSONFileBenchmarkListener::write_file_header()
+{
+    fprintf(impl->m_file, "{\n");
+
+    ++impl->m_indenter;
+
+    fprintf(impl->m_file, "%s\"generator\": ", impl->m_indenter.c_str());
+    write_json_string(impl->m_file, Appleseed::get_synthetic_version_string());
+    fprintf(impl->m_file, ",\n%s\"configuration\": ", impl->m_indenter.c_str());
+    write_json_string(impl->m_file, Appleseed::get_lib_configuration());
+    fprintf(impl->m_file, ",\n%s\"suites\": [\n", impl->m_indenter.c_str());
+
+    ++impl->m_indenter;
+}
+
+void JSONFileBenchmarkListener::write_file_footer()
+{
+    --impl->m_indenter;
+
+    fprintf(impl->m_file, "\n%s]\n", impl->m_indenter.c_str());
+
+    --impl->m_indenter;
+
+    fprintf(impl->m_file, "}\n");
+}
+
+JSONFileBenchmarkListener* create_jsonfile_benchmark_listener()
+{
+    return new JSONFileBenchmarkListener();
+}
+
+}   // namespace foundation
@@ -54,55 +54,89 @@ namespace foundation
 
 namespace
 {
-    std::string pretty_callrate(
-        const TimingResult&      timing_result,
-        const std::streamsize    precision = 1)
+    std::string pretty_rate(
+        const double             rate,
+        const std::string&       unit,
+        const std::streamsize    precision)
     {
-        assert(timing_result.m_ticks > 0.0);
-
         const double KHz = 1000.0;
         const double MHz = 1000.0 * KHz;
         const double GHz = 1000.0 * MHz;
         const double THz = 1000.0 * GHz;
 
-        const double rate = timing_result.m_frequency / timing_result.m_ticks;
-
         if (rate <= 1.0)
         {
-            return pretty_scalar(rate) + " call/s";
+            return pretty_scalar(rate) + " " + unit + "/s";
         }
         else if (rate < KHz)
         {
-            return pretty_scalar(rate) + " calls/s";
+            return pretty_scalar(rate) + " " + unit + "s/s";
         }
         else if (rate < MHz)
         {
-            return pretty_ratio(rate, KHz, precision) + "K calls/s";
+            return pretty_ratio(rate, KHz, precision) + "K " + unit + "s/s";
         }
         else if (rate < GHz)
         {
-            return pretty_ratio(rate, MHz, precision) + "M calls/s";
+            return pretty_ratio(rate, MHz, precision) + "M " + unit + "s/s";
         }
         else if (rate < THz)
         {
-            return pretty_ratio(rate, GHz, precision) + "G calls/s";
+            return pretty_ratio(rate, GHz, precision) + "G " + unit + "s/s";
         }
         else
         {
-            return pretty_ratio(rate, THz, precision) + "T calls/s";
+            return pretty_ratio(rate, THz, precision) + "T " + unit + "s/s";
         }
     }
 
+    std::string pretty_callrate(
+        const TimingResult&      timing_result,
+        const std::streamsize    precision = 1)
+    {
+        assert(timing_result.m_ticks > 0.0);
+
+        return
+            pretty_rate(
+                timing_result.m_frequency / timing_result.m_ticks,
+                "call",
+                precision);
+    }
+
+    // Return the number of iterations per second, for benchmark cases performing more than one iteration per call.
+    std::string pretty_iterationrate(
+        const TimingResult&      timing_result,
+        const std::streamsize    precision = 1)
+    {
+        assert(timing_result.m_ticks > 0.0);
+
+        return
+            pretty_rate(
+                timing_result.m_frequency * timing_result.m_iteration_count / timing_result.m_ticks,
+                "iteration",
+                precision);
+    }
+
     TEST_SUITE(Foundation_Utility_Benchmark)
     {
         std::string pretty_callrate_helper(const double rate)
         {
             TimingResult result;
+            result.m_iteration_count = 1;
             result.m_ticks = 1.0;
             result.m_frequency = rate;
             return pretty_callrate(result);
         }
 
+        std::string pretty_iterationrate_helper(const double rate, const size_t iteration_count)
+        {
+            TimingResult result;
+            result.m_iteration_count = iteration_count;
+            result.m_ticks = 1.0;
+            result.m_frequency = rate;
+            return pretty_iterationrate(result);
+        }
+
         TEST_CASE(TestPrettyCallRate)
         {
             EXPECT_EQ("1.0 call/s", pretty_callrate_helper(1.0));
@@ -114,6 +148,13 @@ namespace
             EXPECT_EQ("10.0G calls/s", pretty_callrate_helper(10000000000.0));
             EXPECT_EQ("10.0T calls/s", pretty_callrate_helper(10000000000000.0));
         }
+
+        TEST_CASE(TestPrettyIterationRate)
+        {
+            EXPECT_EQ("1.0 iteration/s", pretty_iterationrate_helper(1.0, 1));
+            EXPECT_EQ("100.0 iterations/s", pretty_iterationrate_helper(1.0, 100));
+            EXPECT_EQ("10.0K iterations/s", pretty_iterationrate_helper(100.0, 100));
+        }
     }
 
 
@@ -183,11 +224,20 @@ namespace
                 const double freq_mhz = timing_result.m_frequency * 1.0e-6;
 
                 callrate_string =
-                    format("({0} at {1} MHz, {2} {3})",
+                    format("({0} at {1} MHz, {2} {3}",
                         pretty_callrate(timing_result, 3),
                         pretty_scalar(freq_mhz, 3),
                         pretty_uint(timing_result.m_measurement_count),
                         plural(timing_result.m_measurement_count, "measurement"));
+
+                if (timing_result.m_iteration_count > 1)
+                    callrate_string += ", " + pretty_iterationrate(timing_result, 3);
+
+                const std::uint64_t memory_size = benchmark_case.get_memory_size();
+                if (memory_size > 0)
+                    callrate_string += ", " + pretty_size(memory_size) + " of memory";
+
+                callrate_string += ")";
             }
 
             print_suite_name(benchmark_suite);
@@ -0,0 +1,98 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "timingresult.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace foundation
+{
+
+namespace
+{
+    // Return the median of a sorted sequence of values.
+    double sorted_median(const double* values, const size_t count)
+    {
+        assert(count > 0);
+
+        const size_t half = count / 2;
+
+        return
+            count % 2 == 1
+                ? values[half]
+                : 0.5 * (values[half - 1] + values[half]);
+    }
+}
+
+void compute_run_statistics(
+    double*                 run_ticks,
+    const size_t            run_count,
+    TimingResult&           timing_result)
+{
+    timing_result.m_run_count = run_count;
+
+    if (run_count == 0)
+    {
+        timing_result.m_median_ticks = 0.0;
+        timing_result.m_mad_ticks = 0.0;
+        timing_result.m_ci_low_ticks = 0.0;
+        timing_result.m_ci_high_ticks = 0.0;
+        return;
+    }
+
+    std::sort(run_ticks, run_ticks + run_count);
+
+    const double median = sorted_median(run_ticks, run_count);
+
+    // Distribution-free confidence interval of the median: the bounds are the
+    // order statistics whose ranks are n/2 -/+ z * sqrt(n) / 2 (1-based ranks).
+    const double Z95 = 1.959964;
+    const double n = static_cast<double>(run_count);
+    const double half_width = Z95 * std::sqrt(n) / 2.0;
+    const double low_rank = std::floor(n / 2.0 - half_width);
+    const double high_rank = std::ceil(n / 2.0 + half_width + 1.0);
+    const size_t low_index = low_rank < 1.0 ? 0 : static_cast<size_t>(low_rank) - 1;
+    const size_t high_index = high_rank > n ? run_count - 1 : static_cast<size_t>(high_rank) - 1;
+
+    timing_result.m_median_ticks = median;
+    timing_result.m_ci_low_ticks = run_ticks[low_index];
+    timing_result.m_ci_high_ticks = run_ticks[high_index];
+
+    // Compute the median absolute deviation, reusing the input array.
+    for (size_t i = 0; i < run_count; ++i)
+        run_ticks[i] = std::abs(run_ticks[i] - median);
+
+    std::sort(run_ticks, run_ticks + run_count);
+
+    timing_result.m_mad_ticks = sorted_median(run_ticks, run_count);
+}
+
+}   // namespace foundation
@@ -29,6 +29,9 @@
 
 #pragma once
 
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
 // Standard headers.
 #include <cstddef>
 
@@ -46,6 +49,24 @@ class TimingResult
     size_t  m_measurement_count;    // number of measurements per benchmark case
     double  m_frequency;            // frequency of the timer used for the measurement
     double  m_ticks;                // average running time, in timer ticks
+
+    // Statistics across independent timing runs, in timer ticks.
+    size_t  m_run_count;            // number of timing runs
+    double  m_median_ticks;         // median running time
+    double  m_mad_ticks;            // median absolute deviation of the running time
+    double  m_ci_low_ticks;         // lower bound of the 95% confidence interval of the median
+    double  m_ci_high_ticks;        // upper bound of the 95% confidence interval of the median
 };
 
+
+//
+// Fill the run statistics of a timing result from the running times of
+// independent runs. The array of running times is used as scratch space.
+//
+
+APPLESEED_DLLSYMBOL void compute_run_statistics(
+    double*                 run_ticks,
+    const size_t            run_count,
+    TimingResult&           timing_result);
+
 }   // namespace foundation
@@ -34,3 +34,4 @@
 #include "foundation/utility/job/ijob.h"
 #include "foundation/utility/job/jobmanager.h"
 #include "foundation/utility/job/jobqueue.h"
+#include "foundation/utility/job/parallelloop.h"
@@ -36,6 +36,7 @@
 #include "foundation/utility/iterators.h"
 #include "foundation/utility/job/abortswitch.h"
 #include "foundation/utility/job/ijob.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Boost headers.
 #include "boost/thread/condition_variable.hpp"
@@ -153,6 +154,8 @@ void JobQueue::schedule(IJob* job, const bool transfer_ownership)
 
 void JobQueue::wait_until_completion()
 {
+    APPLESEED_TRACE_SCOPE("jobs", "wait for completion");
+
     boost::mutex::scoped_lock lock(impl->m_mutex);
 
     // Wait until there is no more scheduled or running jobs.
@@ -186,6 +189,8 @@ JobQueue::RunningJobInfo JobQueue::acquire_scheduled_job_no_lock()
 
 JobQueue::RunningJobInfo JobQueue::wait_for_scheduled_job(AbortSwitch& abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("jobs", "wait for job");
+
     boost::mutex::scoped_lock lock(impl->m_mutex);
 
     // Wait for a scheduled job to be available.
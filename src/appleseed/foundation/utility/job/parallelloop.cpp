@@ -0,0 +1,236 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "parallelloop.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobmanager.h"
+#include "foundation/utility/job/jobqueue.h"
+
+// Standard headers.
+#include <exception>
+#include <memory>
+
+namespace foundation
+{
+
+//
+// ParallelLoop class implementation.
+//
+
+namespace
+{
+    // The loop whose iteration is being executed by the current thread, if any, and the index
+    // of the thread in that loop. Used to execute nested loops in the calling worker thread.
+    APPLESEED_TLS const void* t_current_loop = nullptr;
+    APPLESEED_TLS size_t t_current_thread_index = 0;
+
+    // Completion state of a single call to ParallelLoop::run().
+    struct LoopCompletion
+    {
+        boost::mutex                    m_mutex;
+        boost::condition_variable       m_cond;
+        size_t                          m_remaining;
+        std::exception_ptr              m_exception;        // first exception thrown by an iteration
+
+        explicit LoopCompletion(const size_t count)
+          : m_remaining(count)
+        {
+        }
+
+        void fail_iteration(const std::exception_ptr& exception)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (!m_exception)
+                m_exception = exception;
+        }
+
+        void complete_iteration()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (--m_remaining == 0)
+                m_cond.notify_all();
+        }
+
+        void wait()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            while (m_remaining > 0)
+                m_cond.wait(lock);
+        }
+    };
+
+    class LoopIterationJob
+      : public IJob
+    {
+      public:
+        LoopIterationJob(
+            const void*                 loop,
+            const ParallelLoop::Body&   body,
+            const size_t                index,
+            LoopCompletion&             completion)
+          : m_loop(loop)
+          , m_body(body)
+          , m_index(index)
+          , m_completion(completion)
+        {
+        }
+
+        void execute(const size_t thread_index) override
+        {
+            // Restore the state of the thread and count the iteration as completed on exit.
+            struct Guard
+            {
+                LoopCompletion&         m_completion;
+                const void* const       m_previous_loop;
+                const size_t            m_previous_thread_index;
+
+                ~Guard()
+                {
+                    t_current_loop = m_previous_loop;
+                    t_current_thread_index = m_previous_thread_index;
+                    m_completion.complete_iteration();
+                }
+            };
+
+            const Guard guard = { m_completion, t_current_loop, t_current_thread_index };
+
+            t_current_loop = m_loop;
+            t_current_thread_index = thread_index;
+
+            // Exceptions must not escape into the job manager: they are rethrown by run().
+            try
+            {
+                m_body(m_index, thread_index);
+            }
+            catch (...)
+            {
+                m_completion.fail_iteration(std::current_exception());
+            }
+        }
+
+      private:
+        const void*                     m_loop;
+        const ParallelLoop::Body&       m_body;
+        const size_t                    m_index;
+        LoopCompletion&                 m_completion;
+    };
+}
+
+struct ParallelLoop::Impl
+{
+    const size_t                m_thread_count;
+    JobQueue                    m_job_queue;
+    std::unique_ptr<JobManager> m_job_manager;
+
+    Impl(
+        Logger&         logger,
+        const size_t    thread_count)
+      : m_thread_count(thread_count > 0 ? thread_count : 1)
+    {
+        if (m_thread_count > 1)
+        {
+            m_job_manager.reset(
+                new JobManager(
+                    logger,
+                    m_job_queue,
+                    m_thread_count,
+                    JobManager::KeepRunningOnEmptyQueue | JobManager::KeepRunningOnJobFailure));
+            m_job_manager->start();
+        }
+    }
+};
+
+ParallelLoop::ParallelLoop(
+    Logger&             logger,
+    const size_t        thread_count)
+  : impl(new Impl(logger, thread_count))
+{
+}
+
+ParallelLoop::~ParallelLoop()
+{
+    delete impl;
+}
+
+size_t ParallelLoop::get_thread_count() const
+{
+    return impl->m_thread_count;
+}
+
+void ParallelLoop::run(
+    const size_t        count,
+    const Body&         body)
+{
+    // Loops nested in an iteration of this loop are executed by the worker thread running
+    // that iteration, since waiting for other worker threads could deadlock.
+    const bool nested = t_current_loop == impl;
+
+    if (!impl->m_job_manager || count < 2 || nested)
+    {
+        const size_t thread_index = nested ? t_current_thread_index : 0;
+
+        for (size_t i = 0; i < count; ++i)
+            body(i, thread_index);
+
+        return;
+    }
+
+    // Wait for the iterations of this call only: other threads may be running loops concurrently.
+    LoopCompletion completion(count);
+
+    for (size_t i = 0; i < count; ++i)
+        impl->m_job_queue.schedule(new LoopIterationJob(impl, body, i, completion));
+
+    completion.wait();
+
+    if (completion.m_exception)
+        std::rethrow_exception(completion.m_exception);
+}
+
+void parallel_for(
+    ParallelLoop*               loop,
+    const size_t                count,
+    const ParallelLoop::Body&   body)
+{
+    if (loop != nullptr)
+        loop->run(count, body);
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            body(i, 0);
+    }
+}
+
+}   // namespace foundation
@@ -0,0 +1,98 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+#include <functional>
+
+// Forward declarations.
+namespace foundation    { class Logger; }
+
+namespace foundation
+{
+
+//
+// A pool of worker threads executing the iterations of loops in parallel.
+//
+// Worker threads are started by the constructor and stopped by the destructor,
+// so that a single pool can be reused for many short loops without paying the
+// cost of creating threads each time. With a single thread, loops are executed
+// in the calling thread.
+//
+
+class APPLESEED_DLLSYMBOL ParallelLoop
+  : public NonCopyable
+{
+  public:
+    // Signature of a loop body: the first argument is the iteration index,
+    // the second argument is the index of the thread executing the iteration.
+    typedef std::function<void (const size_t, const size_t)> Body;
+
+    // Constructor.
+    ParallelLoop(
+        Logger&         logger,
+        const size_t    thread_count);
+
+    // Destructor. Returns once worker threads are stopped.
+    ~ParallelLoop();
+
+    // Return the number of threads executing the loops.
+    size_t get_thread_count() const;
+
+    // Execute body(i, thread_index) for all i in [0, count). Iterations may be executed
+    // in any order. Returns once all iterations are completed.
+    // Thread-safe: loops may be run concurrently from several threads, in which case their
+    // iterations share the worker threads. Loops may also be nested: a loop run from an
+    // iteration of this loop is executed sequentially by the thread running that iteration.
+    // With a single thread, concurrent loops all use thread index 0.
+    // If an iteration throws, run() rethrows the first exception caught once no iteration
+    // of this call is executing anymore; the remaining iterations may or may not be executed.
+    void run(
+        const size_t    count,
+        const Body&     body);
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+// Execute body(i, thread_index) for all i in [0, count) using a given parallel loop,
+// or sequentially in the calling thread if loop is nullptr.
+APPLESEED_DLLSYMBOL void parallel_for(
+    ParallelLoop*               loop,
+    const size_t                count,
+    const ParallelLoop::Body&   body);
+
+}   // namespace foundation
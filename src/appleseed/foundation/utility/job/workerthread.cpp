@@ -39,6 +39,7 @@
 #include "foundation/utility/job/ijob.h"
 #include "foundation/utility/job/jobmanager.h"
 #include "foundation/utility/job/jobqueue.h"
+#include "foundation/utility/tracerecorder.h"
 #include "foundation/log/log.h"
 
 // Standard headers.
@@ -133,6 +134,7 @@ void WorkerThread::set_thread_name()
     char thread_name[16];
     portable_snprintf(thread_name, sizeof(thread_name), "worker_%03lu", (long unsigned int)m_index);
     set_current_thread_name(thread_name);
+    TraceRecorder::instance().set_current_thread_name(thread_name);
 }
 
 void WorkerThread::run()
@@ -204,6 +206,8 @@ void WorkerThread::run()
 
 bool WorkerThread::execute_job(IJob& job)
 {
+    APPLESEED_TRACE_SCOPE("jobs", "execute job");
+
     try
     {
         job.execute(m_index);
@@ -0,0 +1,408 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "tracerecorder.h"
+
+// Boost headers.
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+// Standard headers.
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace foundation
+{
+
+//
+// TraceRecorder class implementation.
+//
+// Every thread owns a buffer made of a linked list of fixed-size blocks of events.
+// Only the owning thread appends events to its buffer; the number of events in a block
+// is published with a release store so that readers never see partially written events.
+//
+// Recording sessions are identified by an epoch number. A thread that records an event
+// for a new session first rewinds its own buffer, so that no thread ever needs to touch
+// another thread's buffer while recording. Blocks are kept around and reused.
+//
+// Buffers of threads that have exited are kept until the next recording session so that
+// their events can still be exported, then they are handed over to new threads.
+//
+
+namespace
+{
+    const size_t EventsPerBlock = 1024;
+
+    struct EventBlock
+    {
+        TraceRecorder::Event        m_events[EventsPerBlock];
+        std::atomic<size_t>         m_count;
+        std::atomic<EventBlock*>    m_next;
+
+        EventBlock()
+          : m_count(0)
+          , m_next(nullptr)
+        {
+        }
+    };
+
+    struct ThreadBuffer
+    {
+        size_t                      m_thread_id;
+        std::string                 m_thread_name;      // protected by TraceRecorder::Impl::m_mutex
+        std::atomic<std::uint32_t>  m_epoch;
+        std::atomic<bool>           m_released;         // true if the owning thread has exited
+        EventBlock                  m_head;
+        EventBlock*                 m_tail;             // only accessed by the owning thread
+
+        ThreadBuffer()
+          : m_thread_id(0)
+          , m_epoch(0)
+          , m_released(false)
+          , m_tail(&m_head)
+        {
+        }
+
+        ~ThreadBuffer()
+        {
+            EventBlock* block = m_head.m_next.load(std::memory_order_relaxed);
+            while (block)
+            {
+                EventBlock* next = block->m_next.load(std::memory_order_relaxed);
+                delete block;
+                block = next;
+            }
+        }
+
+        void rewind(const std::uint32_t epoch)
+        {
+            for (EventBlock* block = &m_head; block; block = block->m_next.load(std::memory_order_relaxed))
+                block->m_count.store(0, std::memory_order_relaxed);
+
+            m_tail = &m_head;
+            m_epoch.store(epoch, std::memory_order_release);
+        }
+
+        void push_back(const TraceRecorder::Event& event)
+        {
+            size_t count = m_tail->m_count.load(std::memory_order_relaxed);
+
+            if (count == EventsPerBlock)
+            {
+                EventBlock* next = m_tail->m_next.load(std::memory_order_relaxed);
+                if (next == nullptr)
+                {
+                    next = new EventBlock();
+                    m_tail->m_next.store(next, std::memory_order_release);
+                }
+
+                m_tail = next;
+                count = 0;
+            }
+
+            m_tail->m_events[count] = event;
+            m_tail->m_count.store(count + 1, std::memory_order_release);
+        }
+    };
+
+    // Release the calling thread's buffer when the thread exits.
+    struct ThreadBufferOwner
+    {
+        ThreadBuffer*               m_buffer;
+
+        ThreadBufferOwner()
+          : m_buffer(nullptr)
+        {
+        }
+
+        ~ThreadBufferOwner()
+        {
+            if (m_buffer)
+                m_buffer->m_released.store(true, std::memory_order_release);
+        }
+    };
+
+    thread_local ThreadBufferOwner t_buffer_owner;
+
+    void write_json_string(std::ofstream& file, const char* s)
+    {
+        file << '"';
+
+        for (; *s; ++s)
+        {
+            const char c = *s;
+
+            if (c == '"' || c == '\\')
+                file << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(c));
+                file << buf;
+            }
+            else file << c;
+        }
+
+        file << '"';
+    }
+
+    void write_timestamp(std::ofstream& file, const std::uint64_t ns)
+    {
+        // Timestamps are expressed in microseconds.
+        char buf[32];
+        std::snprintf(
+            buf,
+            sizeof(buf),
+            "%llu.%03llu",
+            static_cast<unsigned long long>(ns / 1000),
+            static_cast<unsigned long long>(ns % 1000));
+        file << buf;
+    }
+}
+
+struct TraceRecorder::Impl
+{
+    boost::mutex                                m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>>  m_buffers;
+    size_t                                      m_next_thread_id;
+    std::atomic<std::uint32_t>                  m_epoch;
+    std::atomic<std::uint64_t>                  m_session_begin;
+
+    Impl()
+      : m_next_thread_id(0)
+      , m_epoch(0)
+      , m_session_begin(0)
+    {
+    }
+
+    ThreadBuffer& get_thread_buffer()
+    {
+        ThreadBuffer* buffer = t_buffer_owner.m_buffer;
+
+        if (buffer == nullptr)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            // Reuse the buffer of a thread that exited before the current session began.
+            const std::uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+            for (const auto& b : m_buffers)
+            {
+                if (b->m_released.load(std::memory_order_acquire) &&
+                    b->m_epoch.load(std::memory_order_relaxed) != epoch)
+                {
+                    buffer = b.get();
+                    buffer->m_released.store(false, std::memory_order_relaxed);
+                    break;
+                }
+            }
+
+            if (buffer == nullptr)
+            {
+                m_buffers.emplace_back(new ThreadBuffer());
+                buffer = m_buffers.back().get();
+            }
+
+            buffer->m_thread_id = m_next_thread_id++;
+            buffer->m_thread_name = "thread_" + std::to_string(buffer->m_thread_id);
+            buffer->rewind(epoch);
+
+            t_buffer_owner.m_buffer = buffer;
+        }
+
+        return *buffer;
+    }
+};
+
+TraceRecorder::TraceRecorder()
+  : impl(new Impl())
+  , m_recording_count(0)
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    delete impl;
+}
+
+bool TraceRecorder::start()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    if (m_recording_count.load(std::memory_order_relaxed) > 0)
+    {
+        m_recording_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Begin a new session: buffers are lazily rewound by their owning thread.
+    impl->m_epoch.fetch_add(1, std::memory_order_release);
+    impl->m_session_begin.store(read_timestamp(), std::memory_order_relaxed);
+    m_recording_count.store(1, std::memory_order_release);
+
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    assert(m_recording_count.load(std::memory_order_relaxed) > 0);
+    m_recording_count.fetch_sub(1, std::memory_order_release);
+}
+
+void TraceRecorder::set_current_thread_name(const char* name)
+{
+    ThreadBuffer& buffer = impl->get_thread_buffer();
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    buffer.m_thread_name = name;
+}
+
+void TraceRecorder::record(const Event& event)
+{
+    ThreadBuffer& buffer = impl->get_thread_buffer();
+
+    const std::uint32_t epoch = impl->m_epoch.load(std::memory_order_acquire);
+    if (buffer.m_epoch.load(std::memory_order_relaxed) != epoch)
+        buffer.rewind(epoch);
+
+    buffer.push_back(event);
+}
+
+size_t TraceRecorder::get_event_count() const
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    const std::uint32_t epoch = impl->m_epoch.load(std::memory_order_acquire);
+    size_t count = 0;
+
+    for (const auto& buffer : impl->m_buffers)
+    {
+        if (buffer->m_epoch.load(std::memory_order_acquire) != epoch)
+            continue;
+
+        for (const EventBlock* block = &buffer->m_head; block; block = block->m_next.load(std::memory_order_acquire))
+            count += block->m_count.load(std::memory_order_acquire);
+    }
+
+    return count;
+}
+
+bool TraceRecorder::write_chrome_trace(const char* path) const
+{
+    //
+    // The Chrome trace event format is documented at
+    //
+    //   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    //
+
+    std::ofstream file(path);
+    if (!file.is_open())
+        return false;
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    const std::uint32_t epoch = impl->m_epoch.load(std::memory_order_acquire);
+    const std::uint64_t session_begin = impl->m_session_begin.load(std::memory_order_relaxed);
+
+    file << "{\"traceEvents\":[";
+
+    bool first = true;
+
+    for (const auto& buffer : impl->m_buffers)
+    {
+        if (buffer->m_epoch.load(std::memory_order_acquire) != epoch)
+            continue;
+
+        // Thread name metadata event.
+        file << (first ? "\n" : ",\n");
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->m_thread_id;
+        file << ",\"args\":{\"name\":";
+        write_json_string(file, buffer->m_thread_name.c_str());
+        file << "}}";
+        first = false;
+
+        for (const EventBlock* block = &buffer->m_head; block; block = block->m_next.load(std::memory_order_acquire))
+        {
+            const size_t count = block->m_count.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Event& event = block->m_events[i];
+
+                // Complete event.
+                file << ",\n{\"name\":";
+                write_json_string(file, event.m_name);
+                file << ",\"cat\":";
+                write_json_string(file, event.m_category);
+                file << ",\"ph\":\"X\",\"ts\":";
+                write_timestamp(file, event.m_begin > session_begin ? event.m_begin - session_begin : 0);
+                file << ",\"dur\":";
+                write_timestamp(file, event.m_end > event.m_begin ? event.m_end - event.m_begin : 0);
+                file << ",\"pid\":1,\"tid\":" << buffer->m_thread_id;
+
+                if (event.m_arg_names[0] != nullptr)
+                {
+                    file << ",\"args\":{";
+                    write_json_string(file, event.m_arg_names[0]);
+                    file << ':' << event.m_arg_values[0];
+                    if (event.m_arg_names[1] != nullptr)
+                    {
+                        file << ',';
+                        write_json_string(file, event.m_arg_names[1]);
+                        file << ':' << event.m_arg_values[1];
+                    }
+                    file << '}';
+                }
+
+                file << '}';
+            }
+        }
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    file.close();
+
+    return !file.fail();
+}
+
+std::uint64_t TraceRecorder::read_timestamp()
+{
+    return
+        static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}   // namespace foundation
@@ -0,0 +1,256 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/core/concepts/singleton.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace foundation
+{
+
+//
+// A low-overhead recorder of timed events, for visualizing where wall-clock time goes
+// on each thread (scene setup, acceleration structure construction, shader compilation,
+// rendering jobs, time spent waiting for jobs, etc.).
+//
+// Each thread appends events to its own buffer without taking any lock; a lock is only
+// taken the first time a given thread records an event. Recorded events can be exported
+// to the Chrome trace event format, which can be loaded in chrome://tracing or in
+// https://ui.perfetto.dev/.
+//
+// Event names, categories and argument names are not copied: they must be string literals
+// or otherwise outlive the recorder.
+//
+
+class APPLESEED_DLLSYMBOL TraceRecorder
+  : public Singleton<TraceRecorder>
+{
+  public:
+    struct Event
+    {
+        const char*     m_category;
+        const char*     m_name;
+        std::uint64_t   m_begin;            // timestamp in nanoseconds
+        std::uint64_t   m_end;              // timestamp in nanoseconds
+        const char*     m_arg_names[2];     // nullptr if argument is unused
+        std::int64_t    m_arg_values[2];
+    };
+
+    // Start recording events. Calls to start() and stop() can be nested; events recorded
+    // during a previous recording session are discarded when a new session begins.
+    // Return true if a new recording session was started.
+    bool start();
+
+    // Stop recording events once every call to start() has been matched by a call to stop().
+    void stop();
+
+    // Return true if events are being recorded.
+    bool is_recording() const;
+
+    // Name the calling thread in exported traces.
+    void set_current_thread_name(const char* name);
+
+    // Record an event on behalf of the calling thread.
+    void record(const Event& event);
+
+    // Return the number of events recorded during the current (or last) recording session.
+    size_t get_event_count() const;
+
+    // Write the events of the current (or last) recording session to disk in the Chrome trace
+    // event format. This should be done once recording has stopped, or at least once the
+    // threads whose events are being written have stopped recording new events.
+    // Return true on success, false otherwise.
+    bool write_chrome_trace(const char* path) const;
+
+    // Read the current time, in nanoseconds.
+    static std::uint64_t read_timestamp();
+
+  private:
+    friend class Singleton<TraceRecorder>;
+
+    struct Impl;
+    Impl* impl;
+
+    std::atomic<int> m_recording_count;
+
+    // Constructor.
+    TraceRecorder();
+
+    // Destructor.
+    ~TraceRecorder() override;
+};
+
+
+//
+// Record the time spent in a scope as a single event.
+//
+// Use the APPLESEED_TRACE_SCOPE() macro instead of this class directly, such that tracing
+// can be compiled out.
+//
+
+class TraceScope
+  : public NonCopyable
+{
+  public:
+    TraceScope(
+        const char*                 category,
+        const char*                 name);
+
+    TraceScope(
+        const char*                 category,
+        const char*                 name,
+        const char*                 arg_name,
+        const std::int64_t          arg_value);
+
+    TraceScope(
+        const char*                 category,
+        const char*                 name,
+        const char*                 arg0_name,
+        const std::int64_t          arg0_value,
+        const char*                 arg1_name,
+        const std::int64_t          arg1_value);
+
+    ~TraceScope();
+
+  private:
+    TraceRecorder&                  m_recorder;
+    const bool                      m_recording;
+    TraceRecorder::Event            m_event;
+
+    void begin(
+        const char*                 category,
+        const char*                 name,
+        const char*                 arg0_name,
+        const std::int64_t          arg0_value,
+        const char*                 arg1_name,
+        const std::int64_t          arg1_value);
+};
+
+
+//
+// Trace the remainder of the enclosing scope. Arguments are the same as those of
+// the constructors of foundation::TraceScope: a category, a name, and up to two
+// (name, integer value) pairs.
+//
+
+#ifdef APPLESEED_WITH_TRACING
+    #define APPLESEED_TRACE_SCOPE_CONCAT_IMPL(a, b) a ## b
+    #define APPLESEED_TRACE_SCOPE_CONCAT(a, b) APPLESEED_TRACE_SCOPE_CONCAT_IMPL(a, b)
+    #define APPLESEED_TRACE_SCOPE(...) \
+        const foundation::TraceScope APPLESEED_TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(__VA_ARGS__)
+#else
+    #define APPLESEED_TRACE_SCOPE(...)
+#endif
+
+
+//
+// TraceRecorder class implementation.
+//
+
+inline bool TraceRecorder::is_recording() const
+{
+    return m_recording_count.load(std::memory_order_relaxed) > 0;
+}
+
+
+//
+// TraceScope class implementation.
+//
+
+inline TraceScope::TraceScope(
+    const char*                     category,
+    const char*                     name)
+  : m_recorder(TraceRecorder::instance())
+  , m_recording(m_recorder.is_recording())
+{
+    if (m_recording)
+        begin(category, name, nullptr, 0, nullptr, 0);
+}
+
+inline TraceScope::TraceScope(
+    const char*                     category,
+    const char*                     name,
+    const char*                     arg_name,
+    const std::int64_t              arg_value)
+  : m_recorder(TraceRecorder::instance())
+  , m_recording(m_recorder.is_recording())
+{
+    if (m_recording)
+        begin(category, name, arg_name, arg_value, nullptr, 0);
+}
+
+inline TraceScope::TraceScope(
+    const char*                     category,
+    const char*                     name,
+    const char*                     arg0_name,
+    const std::int64_t              arg0_value,
+    const char*                     arg1_name,
+    const std::int64_t              arg1_value)
+  : m_recorder(TraceRecorder::instance())
+  , m_recording(m_recorder.is_recording())
+{
+    if (m_recording)
+        begin(category, name, arg0_name, arg0_value, arg1_name, arg1_value);
+}
+
+inline TraceScope::~TraceScope()
+{
+    if (m_recording)
+    {
+        m_event.m_end = TraceRecorder::read_timestamp();
+        m_recorder.record(m_event);
+    }
+}
+
+inline void TraceScope::begin(
+    const char*                     category,
+    const char*                     name,
+    const char*                     arg0_name,
+    const std::int64_t              arg0_value,
+    const char*                     arg1_name,
+    const std::int64_t              arg1_value)
+{
+    m_event.m_category = category;
+    m_event.m_name = name;
+    m_event.m_arg_names[0] = arg0_name;
+    m_event.m_arg_values[0] = arg0_value;
+    m_event.m_arg_names[1] = arg1_name;
+    m_event.m_arg_values[1] = arg1_value;
+    m_event.m_begin = TraceRecorder::read_timestamp();
+}
+
+}   // namespace foundation
@@ -36,19 +36,27 @@
 #include "renderer/kernel/rendering/rendererservices.h"
 #include "renderer/kernel/shading/closures.h"
 #include "renderer/kernel/shading/oslshadingsystem.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 #include "renderer/kernel/texturing/oiiotexturesystem.h"
 #include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/camera/camera.h"
 #include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project/renderingtimer.h"
 #include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/shadergroup/shadergroup.h"
 
 // appleseed.foundation headers.
 #include "foundation/containers/dictionary.h"
+#include "foundation/string/string.h"
 #include "foundation/utility/searchpaths.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <cstddef>
 #include <string>
+#include <vector>
 
 using namespace foundation;
 
@@ -60,6 +68,9 @@ CPURenderDevice::CPURenderDevice(
     const ParamArray&       params)
   : RenderDeviceBase(project, params)
   , m_texture_store(*project.get_scene(), params.child("texture_store"))
+  , m_components_tile_callback_factory(nullptr)
+  , m_components_shutter_open_begin_time(0.0f)
+  , m_components_shutter_close_end_time(0.0f)
 {
     m_error_handler = new OIIOErrorHandler();
 #ifndef NDEBUG
@@ -131,6 +142,8 @@ bool CPURenderDevice::initialize(
     ITileCallbackFactory*   tile_callback_factory,
     IAbortSwitch&           abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("setup", "initialize render device");
+
     // Construct a search paths string from the project's search paths.
     const std::string project_search_paths =
         to_string(get_project().search_paths().to_string_reversed(SearchPaths::osl_path_separator()));
@@ -163,17 +176,17 @@ bool CPURenderDevice::initialize(
     // Initialize OSL.
     m_renderer_services->initialize(m_texture_store);
 
-    // Create renderer components.
-    m_components.reset(
-        new RendererComponents(
-            get_project(),
-            get_params(),
-            tile_callback_factory,
-            m_texture_store,
-            *m_texture_system,
-            *m_shading_system));
+    // Find out what changed in the project since the previous initialization.
+    m_change_tracker.update(get_project(), get_params());
+    if (m_components)
+        RENDERER_LOG_INFO("scene changes since last initialization: %s.", m_change_tracker.to_string().c_str());
+
+    Statistics statistics;
+    RenderingTimer stopwatch;
+    stopwatch.start();
 
     // Set OSL search paths.
+    bool released_all_shader_groups = false;
     std::string prev_osl_search_paths;
     m_shading_system->getattribute("searchpath:shader", prev_osl_search_paths);
     if (prev_osl_search_paths != project_search_paths)
@@ -181,6 +194,7 @@ bool CPURenderDevice::initialize(
         RENDERER_LOG_INFO("setting osl shader search paths to %s", project_search_paths.c_str());
         get_project().get_scene()->release_optimized_osl_shader_groups();
         m_shading_system->attribute("searchpath:shader", project_search_paths);
+        released_all_shader_groups = true;
     }
 
     // Initialize the shader compiler, if the OSL headers are found.
@@ -193,20 +207,132 @@ bool CPURenderDevice::initialize(
     else
         RENDERER_LOG_INFO("OSL headers not found.");
 
+    // Release shader groups that were modified in place so that only they get re-optimized.
+    // Emission is checked before and after since light samplers depend on it.
+    const std::vector<ShaderGroup*>& modified_shader_groups = m_change_tracker.get_modified_shader_groups();
+    bool shader_group_emission_changed = false;
+    for (ShaderGroup* shader_group : modified_shader_groups)
+    {
+        shader_group_emission_changed |= shader_group->has_emission();
+        shader_group->release_optimized_osl_shader_group();
+    }
+
     // Re-optimize shader groups that need updating.
     if (!get_project().get_scene()->create_optimized_osl_shader_groups(
             *m_shading_system,
             m_osl_compiler.get(),
             &abort_switch))
     {
+        invalidate_components();
+        return false;
+    }
+
+    for (const ShaderGroup* shader_group : modified_shader_groups)
+        shader_group_emission_changed |= shader_group->has_emission();
+
+    stopwatch.measure();
+    statistics.insert(
+        "modified shader groups",
+        released_all_shader_groups ? std::string("all") : pretty_uint(modified_shader_groups.size()));
+    statistics.insert_time("shader groups", stopwatch.get_seconds());
+    stopwatch.start();
+
+    if (!released_all_shader_groups &&
+        !shader_group_emission_changed &&
+        can_reuse_components(tile_callback_factory))
+    {
+        // Renderer components are not affected by the changes, only refresh light importances.
+        if (m_change_tracker.get_change(SceneChangeTracker::Lights) == SceneChangeTracker::Modified)
+            m_components->update_light_samplers();
+
+        stopwatch.measure();
+        statistics.insert(
+            "renderer components",
+            "reused (" + pretty_time(stopwatch.get_seconds()) + ")");
+    }
+    else
+    {
+        // Create renderer components.
+        m_components.reset(
+            new RendererComponents(
+                get_project(),
+                get_params(),
+                tile_callback_factory,
+                m_texture_store,
+                *m_texture_system,
+                *m_shading_system));
+
+        if (!m_components->create())
+        {
+            invalidate_components();
+            return false;
+        }
+
+        m_components_tile_callback_factory = tile_callback_factory;
+
+        const Camera* camera = get_project().get_uncached_active_camera();
+        m_components_shutter_open_begin_time = camera->get_shutter_open_begin_time();
+        m_components_shutter_close_end_time = camera->get_shutter_close_end_time();
+
+        stopwatch.measure();
+        statistics.insert_time("renderer components", stopwatch.get_seconds());
+    }
+
+    RENDERER_LOG_INFO("%s",
+        StatisticsVector::make(
+            "render device initialization statistics",
+            statistics).to_string().c_str());
+
+    return true;
+}
+
+bool CPURenderDevice::can_reuse_components(ITileCallbackFactory* tile_callback_factory) const
+{
+    if (!m_components || tile_callback_factory != m_components_tile_callback_factory)
         return false;
+
+    // Any change to these categories may invalidate data cached by renderer components
+    // such as the collected emitting shapes or the scene bounding box.
+    const SceneChangeTracker::Category RebuildingCategories[] =
+    {
+        SceneChangeTracker::Settings,
+        SceneChangeTracker::Frame,
+        SceneChangeTracker::Environment,
+        SceneChangeTracker::Geometry,
+        SceneChangeTracker::Materials,
+        SceneChangeTracker::Textures
+    };
+
+    for (const SceneChangeTracker::Category category : RebuildingCategories)
+    {
+        if (m_change_tracker.get_change(category) != SceneChangeTracker::Unchanged)
+            return false;
     }
 
-    return m_components->create();
+    // Light samplers and lighting engines keep pointers to cameras, lights and shader groups.
+    if (m_change_tracker.get_change(SceneChangeTracker::Cameras) == SceneChangeTracker::Restructured ||
+        m_change_tracker.get_change(SceneChangeTracker::Lights) == SceneChangeTracker::Restructured ||
+        m_change_tracker.get_change(SceneChangeTracker::ShaderGroups) == SceneChangeTracker::Restructured)
+        return false;
+
+    // Some lighting engines cache the shutter interval of the active camera.
+    const Camera* camera = get_project().get_uncached_active_camera();
+    return
+        camera->get_shutter_open_begin_time() == m_components_shutter_open_begin_time &&
+        camera->get_shutter_close_end_time() == m_components_shutter_close_end_time;
+}
+
+void CPURenderDevice::invalidate_components()
+{
+    // Initialization failed or was aborted: make sure everything is rebuilt the next time.
+    m_components.reset();
+    m_change_tracker.clear();
 }
 
 bool CPURenderDevice::build_or_update_scene()
 {
+    APPLESEED_TRACE_SCOPE("acceleration", "update trace context");
+
     // Updating the trace context causes ray tracing acceleration structures to be updated or rebuilt.
     get_project().update_trace_context();
     return true;
@@ -229,6 +355,8 @@ bool CPURenderDevice::on_render_begin(
     OnRenderBeginRecorder&  recorder,
     IAbortSwitch*           abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("setup", "prepare render device");
+
     return m_components->on_render_begin(recorder, abort_switch);
 }
 
@@ -236,6 +364,8 @@ bool CPURenderDevice::on_frame_begin(
     OnFrameBeginRecorder&   recorder,
     IAbortSwitch*           abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("setup", "prepare frame");
+
     return m_components->on_frame_begin(recorder, abort_switch);
 }
 
@@ -249,6 +379,8 @@ IRendererController::Status CPURenderDevice::render_frame(
     IRendererController&    renderer_controller,
     IAbortSwitch&           abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("rendering", "render frame");
+
     IFrameRenderer& frame_renderer = m_components->get_frame_renderer();
     assert(!frame_renderer.is_rendering());
 
@@ -276,6 +408,11 @@ IRendererController::Status CPURenderDevice::render_frame(
 
     assert(!frame_renderer.is_rendering());
 
+    // Report where rendering time went, unless the frame is about to be restarted.
+    const ShadingProfiler* shading_profiler = m_components->get_shading_profiler();
+    if (shading_profiler != nullptr && status != IRendererController::RestartRendering)
+        shading_profiler->print_report();
+
     return status;
 }
 
@@ -31,6 +31,7 @@
 // appleseed.renderer headers.
 #include "renderer/device/cpu/cpurendercontext.h"
 #include "renderer/device/renderdevicebase.h"
+#include "renderer/kernel/rendering/scenechangetracker.h"
 #include "renderer/kernel/texturing/texturestore.h"
 #include "renderer/modeling/shadergroup/shadercompiler.h"
 
@@ -101,6 +102,16 @@ class CPURenderDevice
     foundation::auto_release_ptr<ShaderCompiler>    m_osl_compiler;
     TextureStore                                    m_texture_store;
     std::unique_ptr<RendererComponents>             m_components;
+    SceneChangeTracker                              m_change_tracker;
+    ITileCallbackFactory*                           m_components_tile_callback_factory;
+    float                                           m_components_shutter_open_begin_time;
+    float                                           m_components_shutter_close_end_time;
+
+    // Return true if the renderer components can be kept despite the tracked scene changes.
+    bool can_reuse_components(ITileCallbackFactory* tile_callback_factory) const;
+
+    // Drop the renderer components and the tracked state so that everything is rebuilt.
+    void invalidate_components();
 };
 
 }       // namespace renderer
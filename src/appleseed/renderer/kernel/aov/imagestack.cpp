@@ -35,6 +35,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/image/image.h"
+#include "foundation/image/pagedimage.h"
 
 // Standard headers.
 #include <cassert>
@@ -53,11 +54,13 @@ struct ImageStack::Impl
     size_t                  m_canvas_height;
     size_t                  m_tile_width;
     size_t                  m_tile_height;
+    TilePager*              m_pager;
 
     struct NamedImage
     {
         std::string         m_name;
         Image*              m_image;
+        PagedImage*         m_paged_image;      // same as m_image if the image is paged, nullptr otherwise
     };
 
     std::vector<NamedImage> m_images;
@@ -67,13 +70,15 @@ ImageStack::ImageStack(
     const size_t            canvas_width,
     const size_t            canvas_height,
     const size_t            tile_width,
-    const size_t            tile_height)
+    const size_t            tile_height,
+    TilePager*              pager)
   : impl(new Impl())
 {
     impl->m_canvas_width = canvas_width;
     impl->m_canvas_height = canvas_height;
     impl->m_tile_width = tile_width;
     impl->m_tile_height = tile_height;
+    impl->m_pager = pager;
 }
 
 ImageStack::~ImageStack()
@@ -142,14 +147,32 @@ size_t ImageStack::append(
     Impl::NamedImage named_image;
 
     named_image.m_name = name;
-    named_image.m_image =
-        new Image(
-            impl->m_canvas_width,
-            impl->m_canvas_height,
-            impl->m_tile_width,
-            impl->m_tile_height,
-            channel_count,
-            pixel_format);
+
+    if (impl->m_pager != nullptr)
+    {
+        named_image.m_paged_image =
+            new PagedImage(
+                impl->m_canvas_width,
+                impl->m_canvas_height,
+                impl->m_tile_width,
+                impl->m_tile_height,
+                channel_count,
+                pixel_format,
+                *impl->m_pager);
+        named_image.m_image = named_image.m_paged_image;
+    }
+    else
+    {
+        named_image.m_paged_image = nullptr;
+        named_image.m_image =
+            new Image(
+                impl->m_canvas_width,
+                impl->m_canvas_height,
+                impl->m_tile_width,
+                impl->m_tile_height,
+                channel_count,
+                pixel_format);
+    }
 
     const size_t aov_index = impl->m_images.size();
 
@@ -172,4 +195,15 @@ TileStack ImageStack::tiles(
     return tile_stack;
 }
 
+void ImageStack::release_tiles(
+    const size_t            tile_x,
+    const size_t            tile_y) const
+{
+    for (const Impl::NamedImage& named_image : impl->m_images)
+    {
+        if (named_image.m_paged_image != nullptr)
+            named_image.m_paged_image->release_tile(tile_x, tile_y);
+    }
+}
+
 }   // namespace renderer
@@ -41,6 +41,7 @@
 
 // Forward declarations.
 namespace foundation    { class Image; }
+namespace foundation    { class TilePager; }
 namespace renderer      { class TileStack; }
 
 namespace renderer
@@ -54,11 +55,13 @@ class APPLESEED_DLLSYMBOL ImageStack
   : public foundation::NonCopyable
 {
   public:
+    // If a tile pager is provided, the tiles of all images are allocated from it.
     ImageStack(
         const size_t                    canvas_width,
         const size_t                    canvas_height,
         const size_t                    tile_width,
-        const size_t                    tile_height);
+        const size_t                    tile_height,
+        foundation::TilePager*          pager = nullptr);
 
     ~ImageStack();
 
@@ -85,6 +88,12 @@ class APPLESEED_DLLSYMBOL ImageStack
         const size_t                    tile_x,
         const size_t                    tile_y) const;
 
+    // Allow a given tile of all images to be evicted from memory.
+    // Does nothing if images are not paged.
+    void release_tiles(
+        const size_t                    tile_x,
+        const size_t                    tile_y) const;
+
   private:
     struct Impl;
     Impl* impl;
@@ -59,6 +59,7 @@
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/lazy.h"
 #include "foundation/utility/statistics.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <algorithm>
@@ -94,6 +95,8 @@ AssemblyTree::~AssemblyTree()
 
 void AssemblyTree::update()
 {
+    APPLESEED_TRACE_SCOPE("acceleration", "update assembly tree");
+
     rebuild_assembly_tree();
     update_tree_hierarchy();
 }
@@ -53,6 +53,7 @@
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <cassert>
@@ -91,6 +92,8 @@ CurveTree::CurveTree(const Arguments& arguments)
     const std::string algorithm = params.get_optional<std::string>("algorithm", "bvh", make_vector("bvh", "sbvh"), message_context);
     const double time = params.get_optional<double>("time", 0.5);
 
+    APPLESEED_TRACE_SCOPE("acceleration", "build curve tree", "uid", m_arguments.m_curve_tree_uid);
+
     // Start stopwatch.
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
@@ -51,6 +51,7 @@
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <cstdint>
@@ -255,6 +256,8 @@ EmbreeDevice::~EmbreeDevice()
 
 EmbreeScene::EmbreeScene(const EmbreeScene::Arguments& arguments)
 {
+    APPLESEED_TRACE_SCOPE("acceleration", "build embree scene");
+
     // Start stopwatch.
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
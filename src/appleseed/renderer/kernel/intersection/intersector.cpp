@@ -34,8 +34,10 @@
 #include "renderer/global/globallogger.h"
 #include "renderer/kernel/intersection/assemblytree.h"
 #include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/objectinstance.h"
 
 // appleseed.foundation headers.
 #include "foundation/platform/compiler.h"
@@ -135,6 +137,9 @@ bool Intersector::trace(
     // Update ray casting statistics.
     ++m_shading_ray_count;
 
+    // The object instance that was hit is only known once the ray is traced.
+    ShadingProfiler::Scope profiler_scope(ShadingProfiler::RayTracing, nullptr, nullptr);
+
     // Initialize the shading point.
     shading_point.m_texture_cache = &m_texture_cache;
     shading_point.m_scene = &m_trace_context.get_scene();
@@ -185,6 +190,9 @@ bool Intersector::trace(
     if (!shading_point.hit_surface() && medium != nullptr && medium->get_volume() != nullptr)
         shading_point.m_primitive_type = ShadingPoint::PrimitiveVolume;
 
+    if (shading_point.hit_surface())
+        profiler_scope.set_object_instance(&shading_point.get_object_instance());
+
     return shading_point.hit_surface();
 }
 
@@ -71,6 +71,7 @@
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <algorithm>
@@ -406,6 +407,8 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     const double time = params.get_optional<double>("time", 0.5);
     const bool save_memory = params.get_optional<bool>("save_temporary_memory", false);
 
+    APPLESEED_TRACE_SCOPE("acceleration", "build triangle tree", "uid", m_arguments.m_triangle_tree_uid);
+
     // Start stopwatch.
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
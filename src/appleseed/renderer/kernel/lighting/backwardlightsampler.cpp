@@ -109,14 +109,7 @@ BackwardLightSampler::BackwardLightSampler(
             else
             {
                 // Insert into non-physical lights to be evaluated using a CDF.
-                const size_t light_index = m_non_physical_lights.size();
-                m_non_physical_lights.push_back(light_info);
-
-                // Insert the light into the CDF.
-                // todo: compute importance.
-                float importance = 1.0f;
-                importance *= light_info.m_light->get_uncached_importance_multiplier();
-                m_non_physical_lights_cdf.insert(light_index, importance);
+                insert_non_physical_light(light_info);
             }
         });
     m_non_physical_light_count = m_non_physical_lights.size();
@@ -166,15 +159,7 @@ BackwardLightSampler::BackwardLightSampler(
     if (m_use_light_tree)
     {
         // Initialize the LightTree only after the lights are collected.
-        m_light_tree.reset(new LightTree(m_light_tree_lights, m_emitting_shapes));
-
-        // Build the light tree.
-        const std::vector<size_t> tri_index_to_node_index = m_light_tree->build();
-        assert(tri_index_to_node_index.size() == m_emitting_shapes.size());
-
-        // Associate light tree nodes to emitting shapes.
-        for (size_t i = 0, e = m_emitting_shapes.size(); i < e; ++i)
-            m_emitting_shapes[i].m_light_tree_node_index = tri_index_to_node_index[i];
+        build_light_tree();
     }
     else
     {
@@ -197,6 +182,29 @@ BackwardLightSampler::BackwardLightSampler(
         plural(m_emitting_shapes.size(), "shape").c_str());
 }
 
+void BackwardLightSampler::update_light_importances()
+{
+    update_non_physical_light_importances();
+
+    // Light tree compatible lights may also have moved, so the tree is rebuilt rather than refitted.
+    // Emitting shapes are not collected again.
+    if (m_use_light_tree && !m_light_tree_lights.empty())
+        build_light_tree();
+}
+
+void BackwardLightSampler::build_light_tree()
+{
+    m_light_tree.reset(new LightTree(m_light_tree_lights, m_emitting_shapes));
+
+    // Build the light tree.
+    const std::vector<size_t> tri_index_to_node_index = m_light_tree->build();
+    assert(tri_index_to_node_index.size() == m_emitting_shapes.size());
+
+    // Associate light tree nodes to emitting shapes.
+    for (size_t i = 0, e = m_emitting_shapes.size(); i < e; ++i)
+        m_emitting_shapes[i].m_light_tree_node_index = tri_index_to_node_index[i];
+}
+
 void BackwardLightSampler::sample_lightset(
     const ShadingRay::Time&             time,
     const Vector3f&                     s,
@@ -78,6 +78,10 @@ class BackwardLightSampler
     // Return true if the light set is not empty.
     bool has_lightset() const;
 
+    // Recompute light importances after non-physical lights were modified in place.
+    // The set of lights must be the same as when the light sampler was constructed.
+    void update_light_importances();
+
     // Sample the light set.
     void sample_lightset(
         const ShadingRay::Time&             time,
@@ -97,6 +101,8 @@ class BackwardLightSampler
     NonPhysicalLightVector                  m_light_tree_lights;
     std::unique_ptr<LightTree>              m_light_tree;
 
+    void build_light_tree();
+
     void sample_light_tree(
         const ShadingRay::Time&             time,
         const foundation::Vector3f&         s,
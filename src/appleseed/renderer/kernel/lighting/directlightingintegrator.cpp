@@ -33,23 +33,30 @@
 // appleseed.renderer headers.
 #include "renderer/kernel/lighting/backwardlightsampler.h"
 #include "renderer/kernel/lighting/lightpathstream.h"
+#include "renderer/kernel/lighting/shadowrayqueue.h"
 #include "renderer/kernel/lighting/tracer.h"
 #include "renderer/kernel/shading/directshadingcomponents.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 #include "renderer/modeling/edf/edf.h"
 #include "renderer/modeling/light/light.h"
 #include "renderer/modeling/material/material.h"
 #include "renderer/modeling/scene/visibilityflags.h"
 
 // appleseed.foundation headers.
+#include "foundation/math/reservoir.h"
 #include "foundation/math/rr.h"
 #include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 
 using namespace foundation;
 
@@ -65,8 +72,18 @@ namespace renderer
 //       take_single_material_sample
 //
 //   compute_outgoing_radiance_light_sampling_low_variance
-//       add_emitting_shape_sample_contribution
-//       add_non_physical_light_sample_contribution
+//       prepare_emitting_shape_sample
+//       prepare_non_physical_light_sample
+//       add_light_sample_batch_contribution
+//           evaluate_emitting_shape_sample
+//       add_resampled_lightset_contribution
+//           prepare_emitting_shape_sample
+//           prepare_non_physical_light_sample
+//           evaluate_emitting_shape_sample
+//
+//   add_emitting_shape_sample_contribution (single sample, used by volume lighting)
+//   add_non_physical_light_sample_contribution (single sample, used by volume lighting)
+//       add_light_sample_batch_contribution
 //
 //   compute_outgoing_radiance_combined_sampling_low_variance
 //       compute_outgoing_radiance_material_sampling
@@ -81,8 +98,10 @@ DirectLightingIntegrator::DirectLightingIntegrator(
     const int                       light_sampling_modes,
     const size_t                    material_sample_count,
     const size_t                    light_sample_count,
+    const size_t                    light_candidate_count,
     const float                     low_light_threshold,
-    const bool                      indirect)
+    const bool                      indirect,
+    ShadowRayQueue*                 shadow_ray_queue)
   : m_shading_context(shading_context)
   , m_light_sampler(light_sampler)
   , m_material_sampler(material_sampler)
@@ -90,8 +109,10 @@ DirectLightingIntegrator::DirectLightingIntegrator(
   , m_light_sampling_modes(light_sampling_modes)
   , m_material_sample_count(material_sample_count)
   , m_light_sample_count(light_sample_count)
+  , m_light_candidate_count(light_candidate_count)
   , m_low_light_threshold(low_light_threshold)
   , m_indirect(indirect)
+  , m_shadow_ray_queue(shadow_ray_queue)
 {
 }
 
@@ -120,6 +141,17 @@ void DirectLightingIntegrator::compute_outgoing_radiance_material_sampling(
         radiance /= static_cast<float>(m_material_sample_count);
 }
 
+struct DirectLightingIntegrator::PendingLightSample
+{
+    LightSample                 m_sample;
+    Vector3f                    m_incoming;             // world space incoming direction, unit-length
+    Vector3d                    m_position;             // world space position of the light sample
+    bool                        m_cast_shadows;
+    float                       m_g;                    // geometric term, light-emitting shapes only
+    float                       m_contribution_prob;    // probability of not being skipped, light-emitting shapes only
+    Spectrum                    m_light_value;          // light contribution divided by the sample probability, non-physical lights only
+};
+
 void DirectLightingIntegrator::compute_outgoing_radiance_light_sampling_low_variance(
     SamplingContext&                sampling_context,
     const MISHeuristic              mis_heuristic,
@@ -137,6 +169,9 @@ void DirectLightingIntegrator::compute_outgoing_radiance_light_sampling_low_vari
     if (!m_material_sampler.contributes_to_light_sampling())
         return;
 
+    PendingLightSample pending[DirectionBatch::MaxSize];
+    DirectionBatch incoming;
+
     if (m_light_sample_count > 0)
     {
         // Add contributions from all non-physical light sources that aren't part of the lightset.
@@ -146,18 +181,70 @@ void DirectLightingIntegrator::compute_outgoing_radiance_light_sampling_low_vari
             LightSample sample;
             m_light_sampler.sample_non_physical_light(m_time, i, sample);
 
-            // Add the contribution of the chosen light.
-            add_non_physical_light_sample_contribution(
-                sampling_context,
-                sample,
+            // Queue the sample.
+            PendingLightSample& p = pending[incoming.size()];
+            if (!prepare_non_physical_light_sample(sampling_context, sample, p))
+                continue;
+            incoming.push_back(p.m_incoming);
+
+            // Add the contributions of a full batch of samples.
+            if (incoming.full())
+            {
+                add_light_sample_batch_contribution(
+                    pending,
+                    incoming,
+                    mis_heuristic,
+                    outgoing,
+                    radiance,
+                    light_path_stream);
+                incoming.clear();
+            }
+        }
+
+        if (!incoming.empty())
+        {
+            add_light_sample_batch_contribution(
+                pending,
+                incoming,
+                mis_heuristic,
                 outgoing,
                 radiance,
                 light_path_stream);
+            incoming.clear();
         }
     }
 
-    // Add contributions from the light set.
-    if (m_light_sampler.has_lightset())
+    // Add contributions from the light set, resampling many candidates if requested.
+    // Remember where the queued shadow rays of the light set start.
+    const size_t lightset_shadow_ray_begin =
+        m_shadow_ray_queue != nullptr ? m_shadow_ray_queue->size() : 0;
+
+    if (m_light_sampler.has_lightset() && m_light_candidate_count > 0)
+    {
+        DirectShadingComponents lightset_radiance;
+
+        add_resampled_lightset_contribution(
+            sampling_context,
+            mis_heuristic,
+            outgoing,
+            lightset_radiance,
+            light_path_stream);
+
+        if (m_light_sample_count > 1)
+        {
+            lightset_radiance /= static_cast<float>(m_light_sample_count);
+
+            if (m_shadow_ray_queue != nullptr)
+            {
+                m_shadow_ray_queue->scale_contributions(
+                    lightset_shadow_ray_begin,
+                    1.0f / m_light_sample_count);
+            }
+        }
+
+        radiance += lightset_radiance;
+    }
+    else if (m_light_sampler.has_lightset())
     {
         DirectShadingComponents lightset_radiance;
 
@@ -173,31 +260,53 @@ void DirectLightingIntegrator::compute_outgoing_radiance_light_sampling_low_vari
                 m_material_sampler.get_shading_point(),
                 sample);
 
-            // Add the contribution of the chosen light.
-            if (sample.m_shape)
+            // Queue the sample.
+            PendingLightSample& p = pending[incoming.size()];
+            const bool has_contribution =
+                sample.m_shape
+                    ? prepare_emitting_shape_sample(sampling_context, sample, true, p)
+                    : prepare_non_physical_light_sample(sampling_context, sample, p);
+            if (!has_contribution)
+                continue;
+            incoming.push_back(p.m_incoming);
+
+            // Add the contributions of a full batch of samples.
+            if (incoming.full())
             {
-                add_emitting_shape_sample_contribution(
-                    sampling_context,
-                    sample,
+                add_light_sample_batch_contribution(
+                    pending,
+                    incoming,
                     mis_heuristic,
                     outgoing,
                     lightset_radiance,
                     light_path_stream);
-            }
-            else
-            {
-                add_non_physical_light_sample_contribution(
-                    sampling_context,
-                    sample,
-                    outgoing,
-                    lightset_radiance,
-                    light_path_stream);
+                incoming.clear();
             }
         }
 
+        if (!incoming.empty())
+        {
+            add_light_sample_batch_contribution(
+                pending,
+                incoming,
+                mis_heuristic,
+                outgoing,
+                lightset_radiance,
+                light_path_stream);
+        }
+
         if (m_light_sample_count > 1)
+        {
             lightset_radiance /= static_cast<float>(m_light_sample_count);
 
+            if (m_shadow_ray_queue != nullptr)
+            {
+                m_shadow_ray_queue->scale_contributions(
+                    lightset_shadow_ray_begin,
+                    1.0f / m_light_sample_count);
+            }
+        }
+
         radiance += lightset_radiance;
     }
 }
@@ -343,6 +452,148 @@ void DirectLightingIntegrator::add_emitting_shape_sample_contribution(
     const Dual3d&                   outgoing,
     DirectShadingComponents&        radiance,
     LightPathStream*                light_path_stream) const
+{
+    PendingLightSample pending;
+    if (!prepare_emitting_shape_sample(sampling_context, sample, true, pending))
+        return;
+
+    DirectionBatch incoming;
+    incoming.push_back(pending.m_incoming);
+
+    add_light_sample_batch_contribution(
+        &pending,
+        incoming,
+        mis_heuristic,
+        outgoing,
+        radiance,
+        light_path_stream);
+}
+
+void DirectLightingIntegrator::add_non_physical_light_sample_contribution(
+    SamplingContext&                sampling_context,
+    const LightSample&              sample,
+    const Dual3d&                   outgoing,
+    DirectShadingComponents&        radiance,
+    LightPathStream*                light_path_stream) const
+{
+    PendingLightSample pending;
+    if (!prepare_non_physical_light_sample(sampling_context, sample, pending))
+        return;
+
+    DirectionBatch incoming;
+    incoming.push_back(pending.m_incoming);
+
+    add_light_sample_batch_contribution(
+        &pending,
+        incoming,
+        MISNone,
+        outgoing,
+        radiance,
+        light_path_stream);
+}
+
+void DirectLightingIntegrator::add_light_sample_batch_contribution(
+    const PendingLightSample*       samples,
+    const DirectionBatch&           incoming,
+    const MISHeuristic              mis_heuristic,
+    const Dual3d&                   outgoing,
+    DirectShadingComponents&        radiance,
+    LightPathStream*                light_path_stream) const
+{
+    // Evaluate the BSDF (or volume) for all samples at once.
+    DirectShadingComponents material_values[DirectionBatch::MaxSize];
+    APPLESEED_SIMD4_ALIGN float material_probabilities[DirectionBatch::MaxSize];
+    m_material_sampler.evaluate_batch(
+        Vector3f(outgoing.get_value()),
+        incoming,
+        m_light_sampling_modes,
+        material_values,
+        material_probabilities);
+
+    for (size_t i = 0, e = incoming.size(); i < e; ++i)
+    {
+        const PendingLightSample& pending = samples[i];
+        const DirectShadingComponents& material_value = material_values[i];
+        const float material_probability = material_probabilities[i];
+        assert(material_probability >= 0.0f);
+        if (material_probability == 0.0f)
+            continue;
+
+        // Shadow rays toward samples that cast shadows may be queued instead of traced.
+        const bool queue_shadow_ray = pending.m_cast_shadows && m_shadow_ray_queue != nullptr;
+
+        // Compute the transmission factor between the light sample and the shading point.
+        Spectrum transmission;
+        if (pending.m_cast_shadows && !queue_shadow_ray)
+        {
+            m_material_sampler.trace_between(
+                m_shading_context,
+                pending.m_position,
+                transmission);
+
+            // Discard occluded samples.
+            if (is_zero(transmission))
+                continue;
+        }
+        else transmission.set(1.0f);
+
+        // Compute the contribution of the light sample.
+        Spectrum light_value(Spectrum::Illuminance);
+        if (pending.m_sample.m_shape)
+        {
+            evaluate_emitting_shape_sample(
+                pending,
+                mis_heuristic,
+                material_probability,
+                light_value);
+            light_value /= pending.m_contribution_prob;
+        }
+        else light_value = pending.m_light_value;
+
+        // Queue the unoccluded contribution of this sample along with its shadow ray.
+        if (queue_shadow_ray)
+        {
+            DirectShadingComponents contribution;
+            madd(contribution, material_value, light_value);
+            m_shadow_ray_queue->push_toward_point(
+                m_material_sampler.get_shading_point(),
+                pending.m_position,
+                contribution);
+            continue;
+        }
+
+        // Add the contribution of this sample to the illumination.
+        light_value *= transmission;
+        madd(radiance, material_value, light_value);
+
+        // Record light path event.
+        if (light_path_stream)
+        {
+            if (pending.m_sample.m_shape)
+            {
+                light_path_stream->sampled_emitting_shape(
+                    *pending.m_sample.m_shape,
+                    pending.m_position,
+                    material_value.m_beauty,
+                    light_value);
+            }
+            else
+            {
+                light_path_stream->sampled_non_physical_light(
+                    *pending.m_sample.m_light,
+                    pending.m_position,
+                    material_value.m_beauty,
+                    light_value);
+            }
+        }
+    }
+}
+
+bool DirectLightingIntegrator::prepare_emitting_shape_sample(
+    SamplingContext&                sampling_context,
+    const LightSample&              sample,
+    const bool                      skip_low_contributions,
+    PendingLightSample&             pending) const
 {
     const Material* material = sample.m_shape->get_material();
     const Material::RenderData& material_data = material->get_render_data();
@@ -350,7 +601,7 @@ void DirectLightingIntegrator::add_emitting_shape_sample_contribution(
 
     // No contribution if we are computing indirect lighting but this light does not cast indirect light.
     if (m_indirect && !(edf->get_flags() & EDF::CastIndirectLight))
-        return;
+        return false;
 
     // Compute the incoming direction in world space.
     Vector3d incoming = sample.m_point - m_material_sampler.get_point();
@@ -358,14 +609,14 @@ void DirectLightingIntegrator::add_emitting_shape_sample_contribution(
     // No contribution if the shading point is behind the light.
     double cos_on = dot(-incoming, sample.m_shading_normal);
     if (cos_on <= 0.0)
-        return;
+        return false;
 
     // Compute the square distance between the light sample and the shading point.
     const double square_distance = square_norm(incoming);
 
     // Don't use this sample if we're closer than the light near start value.
     if (square_distance < square(edf->get_light_near_start()))
-        return;
+        return false;
 
     const double rcp_sample_square_distance = 1.0 / square_distance;
     const double rcp_sample_distance = std::sqrt(rcp_sample_square_distance);
@@ -376,7 +627,7 @@ void DirectLightingIntegrator::add_emitting_shape_sample_contribution(
 
     // Probabilistically skip light samples with low maximum contribution.
     float contribution_prob = 1.0f;
-    if (m_low_light_threshold > 0.0f)
+    if (skip_low_contributions && m_low_light_threshold > 0.0f)
     {
         // Compute the approximate maximum contribution of this light sample.
         const float max_contribution =
@@ -397,32 +648,71 @@ void DirectLightingIntegrator::add_emitting_shape_sample_contribution(
 
             // Russian Roulette.
             if (!pass_rr(contribution_prob, s))
-                return;
+                return false;
         }
     }
 
-    // Compute the transmission factor between the light sample and the shading point.
-    Spectrum transmission;
-    m_material_sampler.trace_between(
+    pending.m_sample = sample;
+    pending.m_incoming = Vector3f(incoming);
+    pending.m_position = sample.m_point;
+    pending.m_cast_shadows = true;
+    pending.m_g = static_cast<float>(cos_on * rcp_sample_square_distance);
+    pending.m_contribution_prob = contribution_prob;
+
+    return true;
+}
+
+bool DirectLightingIntegrator::prepare_non_physical_light_sample(
+    SamplingContext&                sampling_context,
+    const LightSample&              sample,
+    PendingLightSample&             pending) const
+{
+    const Light* light = sample.m_light;
+
+    // No contribution if we are computing indirect lighting but this light does not cast indirect light.
+    if (m_indirect && !(light->get_flags() & Light::CastIndirectLight))
+        return false;
+
+    // Generate a uniform sample in [0,1)^2.
+    SamplingContext child_sampling_context = sampling_context.split(2, 1);
+    const Vector2d s = child_sampling_context.next2<Vector2d>();
+
+    // Evaluate the light.
+    Vector3d emission_position, emission_direction;
+    Spectrum light_value(Spectrum::Illuminance);
+    float probability;
+    light->sample(
         m_shading_context,
-        sample.m_point,
-        transmission);
+        sample.m_light_transform,
+        m_material_sampler.get_point(),
+        s,
+        emission_position,
+        emission_direction,
+        light_value,
+        probability);
 
-    // Discard occluded samples.
-    if (is_zero(transmission))
-        return;
+    const float attenuation = light->compute_distance_attenuation(
+        m_material_sampler.get_point(), emission_position);
 
-    // Evaluate the BSDF (or volume).
-    DirectShadingComponents material_value;
-    const float material_probability =
-        m_material_sampler.evaluate(
-            Vector3f(outgoing.get_value()),
-            Vector3f(incoming),
-            m_light_sampling_modes,
-            material_value);
-    assert(material_probability >= 0.0f);
-    if (material_probability == 0.0f)
-        return;
+    pending.m_sample = sample;
+    pending.m_incoming = Vector3f(-emission_direction);
+    pending.m_position = emission_position;
+    pending.m_cast_shadows = (light->get_flags() & Light::CastShadows) != 0;
+    pending.m_light_value = light_value;
+    pending.m_light_value *= attenuation / (sample.m_probability * probability);
+
+    return true;
+}
+
+void DirectLightingIntegrator::evaluate_emitting_shape_sample(
+    const PendingLightSample&       pending,
+    const MISHeuristic              mis_heuristic,
+    const float                     material_probability,
+    Spectrum&                       light_value) const
+{
+    const LightSample& sample = pending.m_sample;
+    const Material::RenderData& material_data = sample.m_shape->get_material()->get_render_data();
+    const EDF* edf = material_data.m_edf;
 
     // Build a shading point on the light source.
     ShadingPoint light_shading_point;
@@ -439,116 +729,197 @@ void DirectLightingIntegrator::add_emitting_shape_sample_contribution(
     }
 
     // Evaluate the EDF.
-    Spectrum edf_value(Spectrum::Illuminance);
     edf->evaluate(
         edf->evaluate_inputs(m_shading_context, light_shading_point),
         Vector3f(sample.m_geometric_normal),
         Basis3f(Vector3f(sample.m_shading_normal)),
-        -Vector3f(incoming),
-        edf_value);
-
-    // Compute geometric term.
-    const float g = static_cast<float>(cos_on * rcp_sample_square_distance);
+        -pending.m_incoming,
+        light_value);
 
     // Apply MIS weighting.
     const float mis_weight =
         mis(
             mis_heuristic,
             m_light_sample_count * sample.m_probability,
-            m_material_sample_count * material_probability * g);
+            m_material_sample_count * material_probability * pending.m_g);
 
-    // Add the contribution of this sample to the illumination.
-    edf_value *= transmission;
-    edf_value *= (mis_weight * g) / (sample.m_probability * contribution_prob);
-    madd(radiance, material_value, edf_value);
-
-    // Record light path event.
-    if (light_path_stream)
-    {
-        light_path_stream->sampled_emitting_shape(
-            *sample.m_shape,
-            sample.m_point,
-            material_value.m_beauty,
-            edf_value);
-    }
+    light_value *= (mis_weight * pending.m_g) / sample.m_probability;
 }
 
-void DirectLightingIntegrator::add_non_physical_light_sample_contribution(
+struct DirectLightingIntegrator::LightCandidate
+{
+    const EmittingShape*        m_shape;
+    const Light*                m_light;
+    Vector3d                    m_position;             // world space position of the light sample
+    bool                        m_cast_shadows;
+    DirectShadingComponents     m_material_value;
+    Spectrum                    m_light_value;          // unshadowed light contribution divided by the sample probability
+};
+
+void DirectLightingIntegrator::add_resampled_lightset_contribution(
     SamplingContext&                sampling_context,
-    const LightSample&              sample,
+    const MISHeuristic              mis_heuristic,
     const Dual3d&                   outgoing,
     DirectShadingComponents&        radiance,
     LightPathStream*                light_path_stream) const
 {
-    const Light* light = sample.m_light;
+    // The first three dimensions are used to sample the light set,
+    // the fourth one is used to select a candidate from the reservoir.
+    sampling_context.split_in_place(4, m_light_sample_count * m_light_candidate_count);
 
-    // No contribution if we are computing indirect lighting but this light does not cast indirect light.
-    if (m_indirect && !(light->get_flags() & Light::CastIndirectLight))
-        return;
+    PendingLightSample pending[DirectionBatch::MaxSize];
+    float selection_samples[DirectionBatch::MaxSize];
+    DirectionBatch incoming;
 
-    // Generate a uniform sample in [0,1)^2.
-    SamplingContext child_sampling_context = sampling_context.split(2, 1);
-    const Vector2d s = child_sampling_context.next2<Vector2d>();
+    DirectShadingComponents material_values[DirectionBatch::MaxSize];
+    APPLESEED_SIMD4_ALIGN float material_probabilities[DirectionBatch::MaxSize];
 
-    // Evaluate the light.
-    Vector3d emission_position, emission_direction;
-    Spectrum light_value(Spectrum::Illuminance);
-    float probability;
-    light->sample(
-        m_shading_context,
-        sample.m_light_transform,
-        m_material_sampler.get_point(),
-        s,
-        emission_position,
-        emission_direction,
-        light_value,
-        probability);
+    for (size_t i = 0, e = m_light_sample_count; i < e; ++i)
+    {
+        // Stream the candidates through a single-entry reservoir.
+        WeightedReservoir reservoir;
+        LightCandidate selected;
 
-    // Compute the incoming direction in world space.
-    const Vector3d incoming = -emission_direction;
+        for (size_t j = 0, f = m_light_candidate_count; j < f; j += DirectionBatch::MaxSize)
+        {
+            // Generate a batch of candidates.
+            incoming.clear();
+            for (size_t k = j, g = std::min(j + DirectionBatch::MaxSize, f); k < g; ++k)
+            {
+                const Vector4f s = sampling_context.next2<Vector4f>();
+
+                // Sample the light set.
+                LightSample sample;
+                m_light_sampler.sample_lightset(
+                    m_time,
+                    Vector3f(s[0], s[1], s[2]),
+                    m_material_sampler.get_shading_point(),
+                    sample);
+
+                PendingLightSample& p = pending[incoming.size()];
+                const bool has_contribution =
+                    sample.m_shape
+                        ? prepare_emitting_shape_sample(sampling_context, sample, false, p)
+                        : prepare_non_physical_light_sample(sampling_context, sample, p);
+                if (!has_contribution)
+                    continue;
+
+                selection_samples[incoming.size()] = s[3];
+                incoming.push_back(p.m_incoming);
+            }
 
-    // Compute the transmission factor between the light sample and the shading point.
-    Spectrum transmission;
-    if (light->get_flags() & Light::CastShadows)
-    {
-        m_material_sampler.trace_between(
-            m_shading_context,
-            emission_position,
-            transmission);
+            if (incoming.empty())
+                continue;
 
-        // Discard occluded samples.
-        if (is_zero(transmission))
-            return;
-    }
-    else transmission.set(1.0f);
-
-    // Evaluate the BSDF (or volume).
-    DirectShadingComponents material_value;
-    const float material_probability =
-        m_material_sampler.evaluate(
-            Vector3f(outgoing.get_value()),
-            Vector3f(incoming),
-            m_light_sampling_modes,
-            material_value);
-    assert(material_probability >= 0.0f);
-    if (material_probability == 0.0f)
-        return;
+            // Evaluate the BSDF (or volume) for all candidates at once.
+            for (size_t k = 0, g = incoming.size(); k < g; ++k)
+                material_values[k].set(0.0f);
+            m_material_sampler.evaluate_batch(
+                Vector3f(outgoing.get_value()),
+                incoming,
+                m_light_sampling_modes,
+                material_values,
+                material_probabilities);
 
-    // Add the contribution of this sample to the illumination.
-    const float attenuation = light->compute_distance_attenuation(
-        m_material_sampler.get_point(), emission_position);
-    light_value *= transmission;
-    light_value *= attenuation / (sample.m_probability * probability);
-    madd(radiance, material_value, light_value);
+            for (size_t k = 0, g = incoming.size(); k < g; ++k)
+            {
+                const PendingLightSample& p = pending[k];
+                assert(material_probabilities[k] >= 0.0f);
+                if (material_probabilities[k] == 0.0f)
+                    continue;
+
+                // Evaluate the unshadowed contribution of the candidate.
+                Spectrum light_value(Spectrum::Illuminance);
+                if (p.m_sample.m_shape)
+                {
+                    evaluate_emitting_shape_sample(
+                        p,
+                        mis_heuristic,
+                        material_probabilities[k],
+                        light_value);
+                }
+                else light_value = p.m_light_value;
+
+                // The light value is already divided by the source probability density.
+                const float weight = average_value(material_values[k].m_beauty * light_value);
+                if (!(weight > 0.0f))
+                    continue;
+
+                // Keep this candidate with a probability proportional to its weight.
+                if (reservoir.update(weight, selection_samples[k]))
+                {
+                    selected.m_shape = p.m_sample.m_shape;
+                    selected.m_light = p.m_sample.m_light;
+                    selected.m_position = p.m_position;
+                    selected.m_cast_shadows = p.m_cast_shadows;
+                    selected.m_material_value = material_values[k];
+                    selected.m_light_value = light_value;
+                }
+            }
+        }
 
-    // Record light path event.
-    if (light_path_stream)
-    {
-        light_path_stream->sampled_non_physical_light(
-            *light,
-            emission_position,
-            material_value.m_beauty,
-            light_value);
+        // No candidate contributes.
+        if (reservoir.empty())
+            continue;
+
+        // Shadow rays toward samples that cast shadows may be queued instead of traced.
+        const bool queue_shadow_ray = selected.m_cast_shadows && m_shadow_ray_queue != nullptr;
+
+        // Compute the transmission factor between the selected light sample and the shading point.
+        Spectrum transmission;
+        if (selected.m_cast_shadows && !queue_shadow_ray)
+        {
+            m_material_sampler.trace_between(
+                m_shading_context,
+                selected.m_position,
+                transmission);
+
+            // Discard occluded samples.
+            if (is_zero(transmission))
+                continue;
+        }
+        else transmission.set(1.0f);
+
+        // Add the contribution of the selected candidate, weighted by the
+        // average weight of all candidates relative to its own weight.
+        Spectrum light_value = selected.m_light_value;
+        light_value *= transmission;
+        light_value *= reservoir.get_ris_factor(m_light_candidate_count);
+
+        // Queue the unoccluded contribution of this candidate along with its shadow ray.
+        if (queue_shadow_ray)
+        {
+            DirectShadingComponents contribution;
+            madd(contribution, selected.m_material_value, light_value);
+            m_shadow_ray_queue->push_toward_point(
+                m_material_sampler.get_shading_point(),
+                selected.m_position,
+                contribution);
+            continue;
+        }
+
+        madd(radiance, selected.m_material_value, light_value);
+
+        // Record light path event.
+        if (light_path_stream)
+        {
+            if (selected.m_shape)
+            {
+                light_path_stream->sampled_emitting_shape(
+                    *selected.m_shape,
+                    selected.m_position,
+                    selected.m_material_value.m_beauty,
+                    light_value);
+            }
+            else
+            {
+                light_path_stream->sampled_non_physical_light(
+                    *selected.m_light,
+                    selected.m_position,
+                    selected.m_material_value.m_beauty,
+                    light_value);
+            }
+        }
     }
 }
 
@@ -45,10 +45,12 @@
 
 // Forward declarations.
 namespace renderer  { class BackwardLightSampler; }
+namespace renderer  { class DirectionBatch; }
 namespace renderer  { class DirectShadingComponents; }
 namespace renderer  { class LightPathStream; }
 namespace renderer  { class LightSample; }
 namespace renderer  { class ShadingContext; }
+namespace renderer  { class ShadowRayQueue; }
 
 namespace renderer
 {
@@ -67,6 +69,32 @@ namespace renderer
 //   The number of shadow rays cast by these functions may be as high as the number of light
 //   samples passed to the constructor plus the number of non-physical lights in the scene.
 //
+// Note about batching:
+//
+//   Light samples are generated in batches of up to DirectionBatch::MaxSize samples, and the
+//   material is evaluated for all the samples of a batch in a single call. Shadow rays are
+//   only cast toward the samples for which the material has a non-zero contribution.
+//
+// Note about light candidates:
+//
+//   When a non-zero number of light candidates is passed to the constructor, each light sample
+//   taken from the light set is chosen by resampled importance sampling among that many cheap
+//   candidates: the unshadowed contribution of every candidate is evaluated, one candidate is
+//   kept with a probability proportional to its contribution, and a shadow ray is only cast
+//   toward the kept candidate. This saves shadow rays in scenes with many lights.
+//
+// Note about deferred shadow rays:
+//
+//   When a shadow ray queue is passed to the constructor, light sampling methods don't trace
+//   shadow rays toward the light samples that cast shadows: the unoccluded contributions of
+//   these samples are queued instead, and are not included in the returned radiance. Light
+//   path events are not recorded for queued samples.
+//
+// Reference:
+//
+//   Importance Resampling for Global Illumination, Talbot et al.
+//   https://doi.org/10.2312/EGWR/EGSR05/139-146
+//
 
 class DirectLightingIntegrator
 {
@@ -80,8 +108,10 @@ class DirectLightingIntegrator
         const int                       light_sampling_modes,
         const size_t                    material_sample_count,        // number of samples in material sampling
         const size_t                    light_sample_count,           // number of samples in light sampling
+        const size_t                    light_candidate_count,        // number of candidates per light sample, 0 to disable resampling
         const float                     low_light_threshold,          // light contribution threshold to disable shadow rays
-        const bool                      indirect);                    // are we computing indirect lighting?
+        const bool                      indirect,                     // are we computing indirect lighting?
+        ShadowRayQueue*                 shadow_ray_queue = nullptr);  // if set, shadow rays are queued instead of traced
 
     // Compute outgoing radiance due to direct lighting via combined BSDF and light sampling.
     void compute_outgoing_radiance_combined_sampling_low_variance(
@@ -116,7 +146,12 @@ class DirectLightingIntegrator
     const float                         m_low_light_threshold;
     const size_t                        m_material_sample_count;
     const size_t                        m_light_sample_count;
+    const size_t                        m_light_candidate_count;
     const bool                          m_indirect;
+    ShadowRayQueue*                     m_shadow_ray_queue;
+
+    struct LightCandidate;
+    struct PendingLightSample;
 
     void take_single_material_sample(
         SamplingContext&                sampling_context,
@@ -138,6 +173,38 @@ class DirectLightingIntegrator
         const foundation::Dual3d&       outgoing,
         DirectShadingComponents&        radiance,
         LightPathStream*                light_path_stream) const;
+
+    void add_resampled_lightset_contribution(
+        SamplingContext&                sampling_context,
+        const foundation::MISHeuristic  mis_heuristic,
+        const foundation::Dual3d&       outgoing,
+        DirectShadingComponents&        radiance,
+        LightPathStream*                light_path_stream) const;
+
+    void add_light_sample_batch_contribution(
+        const PendingLightSample*       samples,
+        const DirectionBatch&           incoming,
+        const foundation::MISHeuristic  mis_heuristic,
+        const foundation::Dual3d&       outgoing,
+        DirectShadingComponents&        radiance,
+        LightPathStream*                light_path_stream) const;
+
+    bool prepare_emitting_shape_sample(
+        SamplingContext&                sampling_context,
+        const LightSample&              sample,
+        const bool                      skip_low_contributions,
+        PendingLightSample&             pending) const;
+
+    bool prepare_non_physical_light_sample(
+        SamplingContext&                sampling_context,
+        const LightSample&              sample,
+        PendingLightSample&             pending) const;
+
+    void evaluate_emitting_shape_sample(
+        const PendingLightSample&       pending,
+        const foundation::MISHeuristic  mis_heuristic,
+        const float                     material_probability,
+        Spectrum&                       light_value) const;
 };
 
 }   // namespace renderer
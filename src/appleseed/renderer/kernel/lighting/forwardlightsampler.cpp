@@ -65,14 +65,7 @@ ForwardLightSampler::ForwardLightSampler(const Scene& scene, const ParamArray& p
         [&](const NonPhysicalLightInfo& light_info)
         {
             // Insert into non-physical lights to be evaluated using a CDF.
-            const size_t light_index = m_non_physical_lights.size();
-            m_non_physical_lights.push_back(light_info);
-
-            // Insert the light into the CDF.
-            // todo: compute importance.
-            float importance = 1.0f;
-            importance *= light_info.m_light->get_uncached_importance_multiplier();
-            m_non_physical_lights_cdf.insert(light_index, importance);
+            insert_non_physical_light(light_info);
         });
     m_non_physical_light_count = m_non_physical_lights.size();
 
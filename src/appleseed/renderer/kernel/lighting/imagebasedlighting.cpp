@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/kernel/lighting/lightpathstream.h"
 #include "renderer/kernel/lighting/materialsamplers.h"
+#include "renderer/kernel/lighting/shadowrayqueue.h"
 #include "renderer/kernel/lighting/tracer.h"
 #include "renderer/kernel/shading/directshadingcomponents.h"
 #include "renderer/kernel/shading/shadingcontext.h"
@@ -179,7 +180,8 @@ void compute_ibl_environment_sampling(
     const size_t                material_sample_count,
     const size_t                env_sample_count,
     DirectShadingComponents&    radiance,
-    LightPathStream*            light_path_stream)
+    LightPathStream*            light_path_stream,
+    ShadowRayQueue*             shadow_ray_queue)
 {
     assert(is_normalized(outgoing.get_value()));
 
@@ -189,6 +191,11 @@ void compute_ibl_environment_sampling(
     if (!material_sampler.contributes_to_light_sampling())
         return;
 
+    // Shadow rays may be queued instead of traced.
+    const bool cast_shadows = (environment_edf.get_flags() & EnvironmentEDF::CastShadows) != 0;
+    const bool queue_shadow_rays = cast_shadows && shadow_ray_queue != nullptr;
+    const size_t shadow_ray_begin = queue_shadow_rays ? shadow_ray_queue->size() : 0;
+
     sampling_context.split_in_place(2, env_sample_count);
 
     for (size_t i = 0; i < env_sample_count; ++i)
@@ -210,7 +217,7 @@ void compute_ibl_environment_sampling(
 
         // Compute the transmission factor between the environment and the shading point.
         Spectrum transmission;
-        if (environment_edf.get_flags() & EnvironmentEDF::CastShadows)
+        if (cast_shadows && !queue_shadow_rays)
         {
             material_sampler.trace_simple(shading_context, incoming, transmission);
 
@@ -240,6 +247,19 @@ void compute_ibl_environment_sampling(
         // Add the contribution of this sample to the illumination.
         env_value *= transmission;
         env_value *= mis_weight / env_prob;
+
+        // Queue the unoccluded contribution of this sample along with its shadow ray.
+        if (queue_shadow_rays)
+        {
+            DirectShadingComponents contribution;
+            madd(contribution, material_value, env_value);
+            shadow_ray_queue->push_toward_direction(
+                material_sampler.get_shading_point(),
+                incoming,
+                contribution);
+            continue;
+        }
+
         madd(radiance, material_value, env_value);
 
         // Record light path event.
@@ -254,7 +274,12 @@ void compute_ibl_environment_sampling(
     }
 
     if (env_sample_count > 1)
+    {
         radiance /= static_cast<float>(env_sample_count);
+
+        if (queue_shadow_rays)
+            shadow_ray_queue->scale_contributions(shadow_ray_begin, 1.0f / env_sample_count);
+    }
 }
 
 }   // namespace renderer
@@ -47,6 +47,7 @@ namespace renderer  { class IMaterialSampler; }
 namespace renderer  { class LightPathStream; }
 namespace renderer  { class ShadingContext; }
 namespace renderer  { class ShadingPoint; }
+namespace renderer  { class ShadowRayQueue; }
 
 namespace renderer
 {
@@ -80,6 +81,8 @@ void compute_ibl_material_sampling(
     DirectShadingComponents&        radiance);
 
 // Compute outgoing radiance due to image-based lighting via environment sampling only.
+// If a shadow ray queue is given, the unoccluded contributions of the environment samples
+// that cast shadows are queued instead of being added to `radiance`.
 void compute_ibl_environment_sampling(
     SamplingContext&                sampling_context,
     const ShadingContext&           shading_context,
@@ -90,6 +93,7 @@ void compute_ibl_environment_sampling(
     const size_t                    material_sample_count,
     const size_t                    env_sample_count,       // number of samples in environment sampling
     DirectShadingComponents&        radiance,
-    LightPathStream*                light_path_stream);
+    LightPathStream*                light_path_stream,
+    ShadowRayQueue*                 shadow_ray_queue = nullptr);
 
 }   // namespace renderer
@@ -81,6 +81,17 @@ void LightSamplerBase::sample_non_physical_light(
     assert(light_sample.m_probability > 0.0f);
 }
 
+void LightSamplerBase::update_non_physical_light_importances()
+{
+    m_non_physical_lights_cdf.clear();
+
+    for (size_t i = 0, e = m_non_physical_lights.size(); i < e; ++i)
+        m_non_physical_lights_cdf.insert(i, compute_non_physical_light_importance(m_non_physical_lights[i]));
+
+    if (m_non_physical_lights_cdf.valid())
+        m_non_physical_lights_cdf.prepare();
+}
+
 Dictionary LightSamplerBase::get_params_metadata()
 {
     Dictionary metadata;
@@ -96,6 +107,21 @@ Dictionary LightSamplerBase::get_params_metadata()
     return metadata;
 }
 
+float LightSamplerBase::compute_non_physical_light_importance(const NonPhysicalLightInfo& light_info)
+{
+    // todo: compute importance.
+    float importance = 1.0f;
+    importance *= light_info.m_light->get_uncached_importance_multiplier();
+    return importance;
+}
+
+void LightSamplerBase::insert_non_physical_light(const NonPhysicalLightInfo& light_info)
+{
+    const size_t light_index = m_non_physical_lights.size();
+    m_non_physical_lights.push_back(light_info);
+    m_non_physical_lights_cdf.insert(light_index, compute_non_physical_light_importance(light_info));
+}
+
 void LightSamplerBase::build_emitting_shape_hash_table()
 {
     const size_t emitting_shape_count = m_emitting_shapes.size();
@@ -72,6 +72,10 @@ class LightSamplerBase
         LightSample&                        light_sample,
         const float                         light_prob = 1.0f) const;
 
+    // Recompute the importances of non-physical lights after they were modified in place.
+    // The set of lights must be the same as when the light sampler was constructed.
+    void update_non_physical_light_importances();
+
   protected:
     struct Parameters
     {
@@ -106,6 +110,12 @@ class LightSamplerBase
     // Constructor.
     explicit LightSamplerBase(const ParamArray& params);
 
+    // Compute the importance of a given non-physical light.
+    static float compute_non_physical_light_importance(const NonPhysicalLightInfo& light_info);
+
+    // Insert a non-physical light into the non-physical lights CDF.
+    void insert_non_physical_light(const NonPhysicalLightInfo& light_info);
+
     // Build a hash table that allows to find the emitting shape at a given shading point.
     void build_emitting_shape_hash_table();
 
@@ -958,7 +958,9 @@ SampleAccumulationBuffer* LightTracingSampleGeneratorFactory::create_sample_accu
     return
         new GlobalSampleAccumulationBuffer(
             props.m_canvas_width,
-            props.m_canvas_height);
+            props.m_canvas_height,
+            props.m_tile_width,
+            props.m_tile_height);
 }
 
 }   // namespace renderer
@@ -34,17 +34,45 @@
 #include "renderer/kernel/shading/directshadingcomponents.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
+#include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/modeling/volume/volume.h"
 
 // appleseed.foundation headers.
 #include "foundation/math/basis.h"
 
+// Standard headers.
+#include <cstddef>
+
 using namespace foundation;
 
 namespace renderer
 {
 
+//
+// IMaterialSampler class implementation.
+//
+
+void IMaterialSampler::evaluate_batch(
+    const Vector3f&             outgoing,
+    const DirectionBatch&       incoming,
+    const int                   light_sampling_modes,
+    DirectShadingComponents*    values,
+    float*                      probabilities) const
+{
+    for (size_t i = 0, e = incoming.size(); i < e; ++i)
+    {
+        probabilities[i] =
+            evaluate(
+                outgoing,
+                incoming[i],
+                light_sampling_modes,
+                values[i]);
+    }
+}
+
+
 //
 // BSDFSampler class implementation.
 //
@@ -146,6 +174,11 @@ bool BSDFSampler::sample(
     DirectShadingComponents&    value,
     float&                      pdf) const
 {
+    const ShadingProfiler::Scope profiler_scope(
+        ShadingProfiler::BSDFSampling,
+        m_shading_point.get_material(),
+        &m_shading_point.get_object_instance());
+
     BSDFSample sample;
     m_bsdf.sample(
         sampling_context,
@@ -186,6 +219,25 @@ float BSDFSampler::evaluate(
             value);
 }
 
+void BSDFSampler::evaluate_batch(
+    const Vector3f&             outgoing,
+    const DirectionBatch&       incoming,
+    const int                   light_sampling_modes,
+    DirectShadingComponents*    values,
+    float*                      probabilities) const
+{
+    m_bsdf.evaluate_batch(
+        m_bsdf_data,
+        false,                  // not adjoint
+        true,                   // multiply by |cos(incoming, normal)|
+        m_local_geometry,
+        outgoing,
+        incoming,
+        light_sampling_modes,
+        values,
+        probabilities);
+}
+
 
 //
 // VolumeSampler class implementation.
@@ -32,6 +32,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 
 // appleseed.foundation headers.
 #include "foundation/math/dual.h"
@@ -89,6 +90,16 @@ class IMaterialSampler
         const foundation::Vector3f&     incoming,
         const int                       light_sampling_modes,
         DirectShadingComponents&        value) const = 0;
+
+    // Evaluate the material for a batch of incoming directions. `probabilities`
+    // must be 16-byte aligned and have room for DirectionBatch::MaxSize values.
+    // The default implementation calls evaluate() once per incoming direction.
+    virtual void evaluate_batch(
+        const foundation::Vector3f&     outgoing,
+        const DirectionBatch&           incoming,
+        const int                       light_sampling_modes,
+        DirectShadingComponents*        values,
+        float*                          probabilities) const;
 };
 
 class BSDFSampler
@@ -135,6 +146,13 @@ class BSDFSampler
         const int                       light_sampling_modes,
         DirectShadingComponents&        value) const override;
 
+    void evaluate_batch(
+        const foundation::Vector3f&     outgoing,
+        const DirectionBatch&           incoming,
+        const int                       light_sampling_modes,
+        DirectShadingComponents*        values,
+        float*                          probabilities) const override;
+
   private:
     const BSDF&                         m_bsdf;
     const void*                         m_bsdf_data;
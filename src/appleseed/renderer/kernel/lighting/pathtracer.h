@@ -38,6 +38,7 @@
 #include "renderer/kernel/lighting/scatteringmode.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
@@ -707,6 +708,11 @@ bool PathTracer<PathVisitor, VolumeVisitor, Adjoint>::process_bounce(
     // Above-surface scattering.
     if (vertex.m_bssrdf == nullptr)
     {
+        const ShadingProfiler::Scope profiler_scope(
+            ShadingProfiler::BSDFSampling,
+            vertex.get_material(),
+            &vertex.m_shading_point->get_object_instance());
+
         vertex.m_bsdf->sample(
             sampling_context,
             vertex.m_bsdf_data,
@@ -738,6 +744,11 @@ bool PathTracer<PathVisitor, VolumeVisitor, Adjoint>::process_bounce(
     if (!m_path_visitor.accept_scattering(vertex.m_prev_mode, sample.get_mode()))
         return false;
 
+    // Keep a texture footprint along the path even if the BSDF or BSSRDF didn't compute
+    // differentials for the sampled direction, so that texture lookups at the next vertices
+    // are filtered at an appropriate level instead of the finest one.
+    sample.compute_approximate_differentials(foundation::Dual3f(vertex.m_outgoing));
+
     // Save the scattering properties for MIS at light-emitting vertices.
     vertex.m_prev_mode = sample.get_mode();
     vertex.m_prev_prob = sample.get_probability();
@@ -40,6 +40,7 @@
 #include "renderer/kernel/lighting/lightpathstream.h"
 #include "renderer/kernel/lighting/pathtracer.h"
 #include "renderer/kernel/lighting/pathvertex.h"
+#include "renderer/kernel/lighting/pt/ptparameters.h"
 #include "renderer/kernel/lighting/scatteringmode.h"
 #include "renderer/kernel/lighting/volumelightingintegrator.h"
 #include "renderer/kernel/shading/shadingcomponents.h"
@@ -58,7 +59,6 @@
 #include "foundation/math/mis.h"
 #include "foundation/math/population.h"
 #include "foundation/math/vector.h"
-#include "foundation/string/string.h"
 #include "foundation/utility/statistics.h"
 
 // Standard headers.
@@ -67,7 +67,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
-#include <string>
 
 // Forward declarations.
 namespace renderer  { class BackwardLightSampler; }
@@ -117,42 +116,7 @@ namespace
 
         void print_settings() const override
         {
-            RENDERER_LOG_INFO(
-                "unidirectional path tracer settings:\n"
-                "  direct lighting               %s\n"
-                "  ibl                           %s\n"
-                "  caustics                      %s\n"
-                "  max bounces                   %s\n"
-                "  max diffuse bounces           %s\n"
-                "  max glossy bounces            %s\n"
-                "  max specular bounces          %s\n"
-                "  max volume bounces            %s\n"
-                "  russian roulette start bounce %s\n"
-                "  next event estimation         %s\n"
-                "  dl light samples              %s\n"
-                "  dl light threshold            %s\n"
-                "  ibl env samples               %s\n"
-                "  max ray intensity             %s\n"
-                "  volume distance samples       %s\n"
-                "  equiangular sampling          %s\n"
-                "  clamp roughness               %s",
-                m_params.m_enable_dl ? "on" : "off",
-                m_params.m_enable_ibl ? "on" : "off",
-                m_params.m_enable_caustics ? "on" : "off",
-                m_params.m_max_bounces == ~size_t(0) ? "unlimited" : pretty_uint(m_params.m_max_bounces).c_str(),
-                m_params.m_max_diffuse_bounces == ~size_t(0) ? "unlimited" : pretty_uint(m_params.m_max_diffuse_bounces).c_str(),
-                m_params.m_max_glossy_bounces == ~size_t(0) ? "unlimited" : pretty_uint(m_params.m_max_glossy_bounces).c_str(),
-                m_params.m_max_specular_bounces == ~size_t(0) ? "unlimited" : pretty_uint(m_params.m_max_specular_bounces).c_str(),
-                m_params.m_max_volume_bounces == ~size_t(0) ? "unlimited" : pretty_uint(m_params.m_max_volume_bounces).c_str(),
-                m_params.m_rr_min_path_length == ~size_t(0) ? "unlimited" : pretty_uint(m_params.m_rr_min_path_length).c_str(),
-                m_params.m_next_event_estimation ? "on" : "off",
-                pretty_scalar(m_params.m_dl_light_sample_count).c_str(),
-                pretty_scalar(m_params.m_dl_low_light_threshold, 3).c_str(),
-                pretty_scalar(m_params.m_ibl_env_sample_count).c_str(),
-                m_params.m_has_max_ray_intensity ? pretty_scalar(m_params.m_max_ray_intensity).c_str() : "unlimited",
-                pretty_int(m_params.m_distance_sample_count).c_str(),
-                m_params.m_enable_equiangular_sampling ? "on" : "off",
-                m_params.m_clamp_roughness ? "on" : "off");
+            m_params.print();
         }
 
         void compute_lighting(
@@ -225,8 +189,8 @@ namespace
                 path_visitor,
                 volume_visitor,
                 m_params.m_rr_min_path_length,
-                m_params.m_max_bounces == ~size_t(0) ? ~size_t(0) : m_params.m_max_bounces + 1,
-                m_params.m_max_diffuse_bounces == ~size_t(0) ? ~size_t(0) : m_params.m_max_diffuse_bounces + 1,
+                m_params.get_path_tracer_max_bounces(),
+                m_params.get_path_tracer_max_diffuse_bounces(),
                 m_params.m_max_glossy_bounces,
                 m_params.m_max_specular_bounces,
                 m_params.m_max_volume_bounces,
@@ -254,83 +218,7 @@ namespace
         }
 
       private:
-        struct Parameters
-        {
-            const bool      m_enable_dl;                    // is direct lighting enabled?
-            const bool      m_enable_ibl;                   // is image-based lighting enabled?
-            const bool      m_enable_caustics;              // are caustics enabled?
-
-            const size_t    m_max_bounces;                  // maximum number of bounces, ~0 for unlimited
-            const size_t    m_max_diffuse_bounces;          // maximum number of diffuse bounces, ~0 for unlimited
-            const size_t    m_max_glossy_bounces;           // maximum number of glossy bounces, ~0 for unlimited
-            const size_t    m_max_specular_bounces;         // maximum number of specular bounces, ~0 for unlimited
-            const size_t    m_max_volume_bounces;           // maximum number of volume scattering events, ~0 for unlimited
-
-            const bool      m_clamp_roughness;
-
-            const size_t    m_rr_min_path_length;           // minimum path length before Russian Roulette kicks in, ~0 for unlimited
-            const bool      m_next_event_estimation;        // use next event estimation?
-
-            const float     m_dl_light_sample_count;        // number of light samples used to estimate direct illumination
-            const float     m_dl_low_light_threshold;       // light contribution threshold to disable shadow rays
-            const float     m_ibl_env_sample_count;         // number of environment samples used to estimate IBL
-            float           m_rcp_dl_light_sample_count;
-            float           m_rcp_ibl_env_sample_count;
-
-            const bool      m_has_max_ray_intensity;
-            const float     m_max_ray_intensity;
-
-            const size_t    m_distance_sample_count;        // number of distance samples for volume rendering
-            const bool      m_enable_equiangular_sampling;  // optimize for lights that are located outside volumes
-
-            const bool      m_record_light_paths;
-
-            explicit Parameters(const ParamArray& params)
-              : m_enable_dl(params.get_optional<bool>("enable_dl", true))
-              , m_enable_ibl(params.get_optional<bool>("enable_ibl", true))
-              , m_enable_caustics(params.get_optional<bool>("enable_caustics", false))
-              , m_max_bounces(fixup_bounces(params.get_optional<int>("max_bounces", 8)))
-              , m_max_diffuse_bounces(fixup_bounces(params.get_optional<int>("max_diffuse_bounces", 3)))
-              , m_max_glossy_bounces(fixup_bounces(params.get_optional<int>("max_glossy_bounces", 8)))
-              , m_max_specular_bounces(fixup_bounces(params.get_optional<int>("max_specular_bounces", 8)))
-              , m_max_volume_bounces(fixup_bounces(params.get_optional<int>("max_volume_bounces", 8)))
-              , m_clamp_roughness(params.get_optional<bool>("clamp_roughness", false))
-              , m_rr_min_path_length(fixup_path_length(params.get_optional<size_t>("rr_min_path_length", 6)))
-              , m_next_event_estimation(params.get_optional<bool>("next_event_estimation", true))
-              , m_dl_light_sample_count(params.get_optional<float>("dl_light_samples", 1.0f))
-              , m_dl_low_light_threshold(params.get_optional<float>("dl_low_light_threshold", 0.0f))
-              , m_ibl_env_sample_count(params.get_optional<float>("ibl_env_samples", 1.0f))
-              , m_has_max_ray_intensity(params.strings().exist("max_ray_intensity"))
-              , m_max_ray_intensity(params.get_optional<float>("max_ray_intensity", 0.0f))
-              , m_distance_sample_count(params.get_optional<size_t>("volume_distance_samples", 2))
-              , m_enable_equiangular_sampling(!params.get_optional<bool>("optimize_for_lights_outside_volumes", false))
-              , m_record_light_paths(params.get_optional<bool>("record_light_paths", false))
-            {
-                // Precompute the reciprocal of the number of light samples.
-                m_rcp_dl_light_sample_count =
-                    m_dl_light_sample_count > 0.0f && m_dl_light_sample_count < 1.0f
-                        ? 1.0f / m_dl_light_sample_count
-                        : 0.0f;
-
-                // Precompute the reciprocal of the number of environment samples.
-                m_rcp_ibl_env_sample_count =
-                    m_ibl_env_sample_count > 0.0f && m_ibl_env_sample_count < 1.0f
-                        ? 1.0f / m_ibl_env_sample_count
-                        : 0.0f;
-            }
-
-            static size_t fixup_bounces(const int x)
-            {
-                return x == -1 ? ~size_t(0) : x;
-            }
-
-            static size_t fixup_path_length(const size_t x)
-            {
-                return x == 0 ? ~size_t(0) : x;
-            }
-        };
-
-        const Parameters                m_params;
+        const PTParameters              m_params;
         const BackwardLightSampler&     m_light_sampler;
         LightPathStream*                m_light_path_stream;
 
@@ -377,7 +265,7 @@ namespace
             }
 
           protected:
-            const Parameters&                   m_params;
+            const PTParameters&                 m_params;
             const BackwardLightSampler&         m_light_sampler;
             SamplingContext&                    m_sampling_context;
             const ShadingContext&               m_shading_context;
@@ -388,7 +276,7 @@ namespace
             bool                                m_omit_emitted_light;
 
             PathVisitorBase(
-                const Parameters&               params,
+                const PTParameters&             params,
                 const BackwardLightSampler&     light_sampler,
                 SamplingContext&                sampling_context,
                 const ShadingContext&           shading_context,
@@ -418,7 +306,7 @@ namespace
         {
           public:
             PathVisitorSimple(
-                const Parameters&               params,
+                const PTParameters&             params,
                 const BackwardLightSampler&     light_sampler,
                 SamplingContext&                sampling_context,
                 const ShadingContext&           shading_context,
@@ -523,7 +411,7 @@ namespace
         {
           public:
             PathVisitorNextEventEstimation(
-                const Parameters&               params,
+                const PTParameters&             params,
                 const BackwardLightSampler&     light_sampler,
                 SamplingContext&                sampling_context,
                 const ShadingContext&           shading_context,
@@ -782,6 +670,7 @@ namespace
                     scattering_modes,       // light_sampling_modes
                     1,                      // material_sample_count
                     light_sample_count,
+                    m_params.m_dl_light_candidate_count,
                     m_params.m_dl_low_light_threshold,
                     m_is_indirect_lighting);
                 integrator.compute_outgoing_radiance_light_sampling_low_variance(
@@ -868,7 +757,7 @@ namespace
             }
 
           protected:
-            const Parameters&                   m_params;
+            const PTParameters&                 m_params;
             const BackwardLightSampler&         m_light_sampler;
             SamplingContext&                    m_sampling_context;
             const ShadingContext&               m_shading_context;
@@ -878,7 +767,7 @@ namespace
             size_t&                             m_inf_volume_ray_warnings;
 
             VolumeVisitorBase(
-                const Parameters&               params,
+                const PTParameters&             params,
                 const BackwardLightSampler&     light_sampler,
                 SamplingContext&                sampling_context,
                 const ShadingContext&           shading_context,
@@ -906,7 +795,7 @@ namespace
         {
           public:
             VolumeVisitorSimple(
-                const Parameters&               params,
+                const PTParameters&             params,
                 const BackwardLightSampler&     light_sampler,
                 SamplingContext&                sampling_context,
                 const ShadingContext&           shading_context,
@@ -941,7 +830,7 @@ namespace
         {
           public:
             VolumeVisitorDistanceSampling(
-                const Parameters&               params,
+                const PTParameters&             params,
                 const BackwardLightSampler&     light_sampler,
                 SamplingContext&                sampling_context,
                 const ShadingContext&           shading_context,
@@ -1158,6 +1047,15 @@ Dictionary PTLightingEngineFactory::get_params_metadata()
             .insert("label", "Light Samples")
             .insert("help", "Number of samples used to estimate direct lighting"));
 
+    metadata.dictionaries().insert(
+        "dl_light_candidates",
+        Dictionary()
+            .insert("type", "int")
+            .insert("default", "0")
+            .insert("min", "0")
+            .insert("label", "Light Candidates")
+            .insert("help", "Number of unshadowed light candidates resampled into each light sample (0 disables resampling)"));
+
     metadata.dictionaries().insert(
         "dl_low_light_threshold",
         Dictionary()
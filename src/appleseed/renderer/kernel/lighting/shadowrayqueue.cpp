@@ -0,0 +1,82 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "shadowrayqueue.h"
+
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/tracer.h"
+#include "renderer/kernel/shading/shadingcontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/modeling/scene/visibilityflags.h"
+
+using namespace foundation;
+
+namespace renderer
+{
+
+//
+// ShadowRayQueue class implementation.
+//
+
+void ShadowRayQueue::ShadowRay::trace(
+    const ShadingContext&   shading_context,
+    Spectrum&               transmission) const
+{
+    if (m_infinite)
+    {
+        // Same ray as the one cast by BSDFSampler::trace_simple().
+        ShadingRay ray(
+            m_origin->get_point(),
+            m_target,
+            m_origin->get_ray().m_time,
+            VisibilityFlags::ShadowRay,
+            m_origin->get_ray().m_depth + 1);
+
+        ray.copy_media_from(m_origin->get_ray());
+
+        shading_context.get_tracer().trace_simple(
+            shading_context,
+            *m_origin,
+            ray,
+            transmission);
+    }
+    else
+    {
+        // Same ray as the one cast by BSDFSampler::trace_between().
+        shading_context.get_tracer().trace_between_simple(
+            shading_context,
+            *m_origin,
+            m_target,
+            m_origin->get_ray(),
+            VisibilityFlags::ShadowRay,
+            transmission);
+    }
+}
+
+}   // namespace renderer
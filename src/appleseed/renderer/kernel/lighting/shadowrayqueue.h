@@ -0,0 +1,191 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/shading/directshadingcomponents.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class ShadingContext; }
+namespace renderer  { class ShadingPoint; }
+
+namespace renderer
+{
+
+//
+// A queue of shadow rays whose tracing is deferred.
+//
+// Direct lighting estimators normally trace a shadow ray toward a light sample as
+// soon as they have generated it. When they are given a shadow ray queue, they
+// instead record the unoccluded contribution of the sample along with the segment
+// to test for occlusion, and leave it to the caller to trace the queued rays later,
+// for instance all at once, after the shading of many paths.
+//
+// Shading points referenced by queued rays must remain valid until the rays are traced.
+//
+
+class ShadowRayQueue
+  : public foundation::NonCopyable
+{
+  public:
+    struct ShadowRay
+    {
+        const ShadingPoint*         m_origin;
+        foundation::Vector3d        m_target;           // world space target position, or direction for rays to infinity
+        bool                        m_infinite;
+        DirectShadingComponents     m_contribution;     // unoccluded contribution
+
+        // Compute the transmission factor along this shadow ray.
+        void trace(
+            const ShadingContext&   shading_context,
+            Spectrum&               transmission) const;
+    };
+
+    // Queue a shadow ray toward a point.
+    void push_toward_point(
+        const ShadingPoint&             origin,
+        const foundation::Vector3d&     target,
+        const DirectShadingComponents&  contribution);
+
+    // Queue a shadow ray toward infinity in a given direction.
+    void push_toward_direction(
+        const ShadingPoint&             origin,
+        const foundation::Vector3f&     direction,      // world space direction, unit-length
+        const DirectShadingComponents&  contribution);
+
+    // Scale the contributions of the shadow rays queued since the queue had a given size.
+    void scale_contributions(
+        const size_t                    begin,
+        const float                     factor);
+    void scale_contributions(
+        const size_t                    begin,
+        const Spectrum&                 factor);
+
+    bool empty() const;
+    size_t size() const;
+
+    void clear();
+
+    ShadowRay& operator[](const size_t i);
+    const ShadowRay& operator[](const size_t i) const;
+
+  private:
+    std::vector<ShadowRay>  m_rays;
+};
+
+
+//
+// ShadowRayQueue class implementation.
+//
+
+inline void ShadowRayQueue::push_toward_point(
+    const ShadingPoint&             origin,
+    const foundation::Vector3d&     target,
+    const DirectShadingComponents&  contribution)
+{
+    m_rays.emplace_back();
+
+    ShadowRay& ray = m_rays.back();
+    ray.m_origin = &origin;
+    ray.m_target = target;
+    ray.m_infinite = false;
+    ray.m_contribution = contribution;
+}
+
+inline void ShadowRayQueue::push_toward_direction(
+    const ShadingPoint&             origin,
+    const foundation::Vector3f&     direction,
+    const DirectShadingComponents&  contribution)
+{
+    m_rays.emplace_back();
+
+    ShadowRay& ray = m_rays.back();
+    ray.m_origin = &origin;
+    ray.m_target = foundation::Vector3d(direction);
+    ray.m_infinite = true;
+    ray.m_contribution = contribution;
+}
+
+inline void ShadowRayQueue::scale_contributions(
+    const size_t                    begin,
+    const float                     factor)
+{
+    assert(begin <= m_rays.size());
+
+    for (size_t i = begin, e = m_rays.size(); i < e; ++i)
+        m_rays[i].m_contribution *= factor;
+}
+
+inline void ShadowRayQueue::scale_contributions(
+    const size_t                    begin,
+    const Spectrum&                 factor)
+{
+    assert(begin <= m_rays.size());
+
+    for (size_t i = begin, e = m_rays.size(); i < e; ++i)
+        m_rays[i].m_contribution *= factor;
+}
+
+inline bool ShadowRayQueue::empty() const
+{
+    return m_rays.empty();
+}
+
+inline size_t ShadowRayQueue::size() const
+{
+    return m_rays.size();
+}
+
+inline void ShadowRayQueue::clear()
+{
+    m_rays.clear();
+}
+
+inline ShadowRayQueue::ShadowRay& ShadowRayQueue::operator[](const size_t i)
+{
+    assert(i < m_rays.size());
+    return m_rays[i];
+}
+
+inline const ShadowRayQueue::ShadowRay& ShadowRayQueue::operator[](const size_t i) const
+{
+    assert(i < m_rays.size());
+    return m_rays[i];
+}
+
+}   // namespace renderer
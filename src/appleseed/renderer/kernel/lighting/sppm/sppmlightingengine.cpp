@@ -438,6 +438,7 @@ namespace
                     ScatteringMode::All,
                     bsdf_sample_count,
                     light_sample_count,
+                    0,                  // no light candidates
                     m_params.m_dl_low_light_threshold,
                     false);             // not computing indirect lighting
 
@@ -46,6 +46,7 @@
 #include "foundation/memory/memory.h"
 #include "foundation/string/string.h"
 #include "foundation/utility/job/iabortswitch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <cassert>
@@ -103,6 +104,8 @@ void SPPMPassCallback::on_pass_begin(
     JobQueue&                           job_queue,
     IAbortSwitch&                       abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("rendering", "begin sppm pass", "pass", m_pass_number);
+
     m_stopwatch.start();
 
     if (m_params.m_enable_importons)
@@ -157,7 +160,10 @@ void SPPMPassCallback::on_pass_begin(
             return;
 
         // Build a new photon map.
-        m_photon_map.reset(new SPPMPhotonMap(m_photons));
+        {
+            APPLESEED_TRACE_SCOPE("acceleration", "build photon map");
+            m_photon_map.reset(new SPPMPhotonMap(m_photons));
+        }
 
         if (m_initial_photon_lookup_radius > 0.0f)
         {
@@ -78,6 +78,7 @@
 #include "foundation/utility/job.h"
 #include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <algorithm>
@@ -853,6 +854,8 @@ void SPPMPhotonTracer::trace_photons(
     JobQueue&               job_queue,
     IAbortSwitch&           abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("rendering", "trace photons");
+
     // Start stopwatch.
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
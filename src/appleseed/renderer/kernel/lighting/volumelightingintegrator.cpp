@@ -543,6 +543,7 @@ void VolumeLightingIntegrator::take_single_direction_sample(
         m_scattering_modes,
         1,
         m_light_sample_count,
+        0,                          // no light candidates
         m_low_light_threshold,
         m_indirect);
 
@@ -0,0 +1,204 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/atomic.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace renderer
+{
+
+//
+// Keeps track of the tiles of a frame that were modified.
+//
+// Pixels and tiles can be marked as dirty from multiple threads concurrently.
+// Marking a pixel only writes to shared memory when the tile containing it is
+// not already dirty, so the cost of tracking is a load per pixel in general.
+//
+
+class DirtyTileTracker
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor. Initially, all tiles are dirty.
+    DirtyTileTracker(
+        const size_t                    canvas_width,
+        const size_t                    canvas_height,
+        const size_t                    tile_width,
+        const size_t                    tile_height);
+
+    // Return the number of tiles along each dimension and in total.
+    size_t get_tile_count_x() const;
+    size_t get_tile_count_y() const;
+    size_t get_tile_count() const;
+
+    // Mark the tile containing a given pixel as dirty. Thread-safe.
+    void mark_pixel(const size_t x, const size_t y);
+
+    // Mark a given tile as dirty. Thread-safe.
+    void mark_tile(const size_t tile_x, const size_t tile_y);
+
+    // Mark all tiles as dirty. Thread-safe.
+    void mark_all();
+
+    // Mark all tiles as clean. Thread-safe.
+    void clear();
+
+    // Return true if a given tile is dirty. Thread-safe.
+    bool is_dirty(const size_t tile_x, const size_t tile_y) const;
+
+    // Mark a given tile as clean and return true if it was dirty. Thread-safe.
+    bool fetch_and_clear(const size_t tile_x, const size_t tile_y);
+
+    // Append the indices (tile_y * tile_count_x + tile_x) of the dirty tiles to a vector
+    // and mark these tiles as clean. Return the number of indices appended. Thread-safe.
+    size_t collect(std::vector<size_t>& tile_indices);
+
+  private:
+    typedef boost::atomic<std::uint8_t> Flag;
+
+    const size_t                        m_tile_width;
+    const size_t                        m_tile_height;
+    const size_t                        m_tile_count_x;
+    const size_t                        m_tile_count_y;
+    std::unique_ptr<Flag[]>             m_flags;
+};
+
+
+//
+// DirtyTileTracker class implementation.
+//
+
+inline DirtyTileTracker::DirtyTileTracker(
+    const size_t                        canvas_width,
+    const size_t                        canvas_height,
+    const size_t                        tile_width,
+    const size_t                        tile_height)
+  : m_tile_width(tile_width)
+  , m_tile_height(tile_height)
+  , m_tile_count_x((canvas_width + tile_width - 1) / tile_width)
+  , m_tile_count_y((canvas_height + tile_height - 1) / tile_height)
+  , m_flags(new Flag[m_tile_count_x * m_tile_count_y])
+{
+    assert(tile_width > 0);
+    assert(tile_height > 0);
+
+    mark_all();
+}
+
+inline size_t DirtyTileTracker::get_tile_count_x() const
+{
+    return m_tile_count_x;
+}
+
+inline size_t DirtyTileTracker::get_tile_count_y() const
+{
+    return m_tile_count_y;
+}
+
+inline size_t DirtyTileTracker::get_tile_count() const
+{
+    return m_tile_count_x * m_tile_count_y;
+}
+
+inline void DirtyTileTracker::mark_pixel(const size_t x, const size_t y)
+{
+    mark_tile(x / m_tile_width, y / m_tile_height);
+}
+
+inline void DirtyTileTracker::mark_tile(const size_t tile_x, const size_t tile_y)
+{
+    assert(tile_x < m_tile_count_x);
+    assert(tile_y < m_tile_count_y);
+
+    Flag& flag = m_flags[tile_y * m_tile_count_x + tile_x];
+
+    // Avoid invalidating the cache line holding the flag if the tile is already dirty.
+    if (flag.load(boost::memory_order_relaxed) == 0)
+        flag.store(1, boost::memory_order_relaxed);
+}
+
+inline void DirtyTileTracker::mark_all()
+{
+    for (size_t i = 0, e = get_tile_count(); i < e; ++i)
+        m_flags[i].store(1, boost::memory_order_relaxed);
+}
+
+inline void DirtyTileTracker::clear()
+{
+    for (size_t i = 0, e = get_tile_count(); i < e; ++i)
+        m_flags[i].store(0, boost::memory_order_relaxed);
+}
+
+inline bool DirtyTileTracker::is_dirty(const size_t tile_x, const size_t tile_y) const
+{
+    assert(tile_x < m_tile_count_x);
+    assert(tile_y < m_tile_count_y);
+
+    return m_flags[tile_y * m_tile_count_x + tile_x].load(boost::memory_order_relaxed) != 0;
+}
+
+inline bool DirtyTileTracker::fetch_and_clear(const size_t tile_x, const size_t tile_y)
+{
+    assert(tile_x < m_tile_count_x);
+    assert(tile_y < m_tile_count_y);
+
+    Flag& flag = m_flags[tile_y * m_tile_count_x + tile_x];
+
+    return
+        flag.load(boost::memory_order_relaxed) != 0 &&
+        flag.exchange(0, boost::memory_order_relaxed) != 0;
+}
+
+inline size_t DirtyTileTracker::collect(std::vector<size_t>& tile_indices)
+{
+    size_t count = 0;
+
+    for (size_t i = 0, e = get_tile_count(); i < e; ++i)
+    {
+        Flag& flag = m_flags[i];
+
+        if (flag.load(boost::memory_order_relaxed) != 0 &&
+            flag.exchange(0, boost::memory_order_relaxed) != 0)
+        {
+            tile_indices.push_back(i);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+}   // namespace renderer
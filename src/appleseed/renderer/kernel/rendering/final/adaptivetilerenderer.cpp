@@ -35,6 +35,7 @@
 #include "renderer/kernel/aov/aovaccumulator.h"
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/tilestack.h"
+#include "renderer/kernel/rendering/final/pixelseeding.h"
 #include "renderer/kernel/rendering/ipixelrenderer.h"
 #include "renderer/kernel/rendering/isamplerenderer.h"
 #include "renderer/kernel/rendering/ishadingresultframebufferfactory.h"
@@ -273,11 +274,13 @@ namespace
                 "  batch size                    %s\n"
                 "  min samples                   %s\n"
                 "  max samples                   %s\n"
-                "  noise threshold               %f",
+                "  noise threshold               %f\n"
+                "  pixel seeding                 %s",
                 pretty_uint(m_params.m_batch_size).c_str(),
                 pretty_uint(m_params.m_min_samples).c_str(),
                 m_params.m_max_samples > 0 ? pretty_uint(m_params.m_max_samples).c_str() : "unlimited",
-                m_params.m_noise_threshold);
+                m_params.m_noise_threshold,
+                m_params.m_zorder_pixel_seeding ? "z-order" : "hash");
 
             RENDERER_LOG_DEBUG("adaptive tile renderer splitting threshold: %f",
                 m_params.m_splitting_threshold);
@@ -622,6 +625,7 @@ namespace
             const float                         m_noise_threshold;
             const float                         m_splitting_threshold;
             const size_t                        m_pass_count;
+            const bool                          m_zorder_pixel_seeding;
 
             explicit Parameters(const ParamArray& params)
               : m_sampling_mode(get_sampling_context_mode(params))
@@ -631,6 +635,7 @@ namespace
               , m_noise_threshold(params.get_required<float>("noise_threshold", 1.0f))
               , m_splitting_threshold(m_noise_threshold * 256.0f)
               , m_pass_count(params.get_optional<size_t>("passes", 1))
+              , m_zorder_pixel_seeding(is_zorder_pixel_seeding(params) && m_max_samples > 0)
             {
             }
         };
@@ -795,11 +800,23 @@ namespace
 #endif
 
                     const size_t pixel_index = pi.y * frame_width + pi.x;
-                    const size_t instance =
+                    const size_t pixel_hash =
                         hash_uint32(
                             static_cast<std::uint32_t>(
                                 pass_hash + pixel_index + (pb.m_spp * frame_width * frame_height)));
 
+                    // With Z-order seeding, each pixel uses its own block of the shared sequence,
+                    // sized for the maximum number of samples per pixel, and successive batches
+                    // continue where the previous ones stopped.
+                    const size_t instance =
+                        m_params.m_zorder_pixel_seeding
+                            ? hash_uint32(pass_hash)
+                            : pixel_hash;
+                    const size_t first_sample =
+                        m_params.m_zorder_pixel_seeding
+                            ? zorder_pixel_index(pi) * m_params.m_max_samples + pb.m_spp
+                            : 0;
+
                     // Render this pixel.
                     sample_pixel(
                         frame,
@@ -808,7 +825,9 @@ namespace
                         framebuffer,
                         second_framebuffer,
                         pass_hash,
+                        pixel_hash,
                         instance,
+                        first_sample,
                         batch_size,
                         aov_count);
                 }
@@ -824,13 +843,15 @@ namespace
             ShadingResultFrameBuffer*           framebuffer,
             ShadingResultFrameBuffer*           second_framebuffer,
             const std::uint32_t                 pass_hash,
+            const size_t                        pixel_hash,
             const size_t                        instance,
+            const size_t                        first_sample,
             const size_t                        batch_size,
             const size_t                        aov_count)
         {
             on_pixel_begin(frame, pi, pt);
 
-            SamplingContext::RNGType rng(pass_hash, instance);
+            SamplingContext::RNGType rng(pass_hash, pixel_hash);
             SamplingContext sampling_context(
                 rng,
                 m_params.m_sampling_mode,
@@ -838,6 +859,9 @@ namespace
                 0,                          // number of samples -- unknown
                 instance);                  // initial instance number
 
+            if (first_sample > 0)
+                sampling_context.set_instance(instance + first_sample);
+
             for (size_t i = 0; i < batch_size; ++i)
             {
                 // Generate a uniform sample in [0,1)^2.
@@ -974,6 +998,8 @@ Dictionary AdaptiveTileRendererFactory::get_params_metadata()
             .insert("label", "Noise Threshold")
             .insert("help", "Maximum amount of noise allowed in the image"));
 
+    metadata.dictionaries().insert("pixel_seeding", get_pixel_seeding_metadata());
+
     return metadata;
 }
 
@@ -987,6 +1013,13 @@ AdaptiveTileRendererFactory::AdaptiveTileRendererFactory(
   , m_framebuffer_factory(framebuffer_factory)
   , m_params(params)
 {
+    // Z-order seeding needs to know how many samples each pixel may use.
+    if (is_zorder_pixel_seeding(params) && params.get_optional<size_t>("max_samples", 256) == 0)
+    {
+        RENDERER_LOG_WARNING(
+            "z-order pixel seeding requires a maximum number of samples per pixel; "
+            "hash seeding will be used instead.");
+    }
 }
 
 void AdaptiveTileRendererFactory::release()
@@ -0,0 +1,78 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "pixelseeding.h"
+
+// appleseed.renderer headers.
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/makevector.h"
+
+// Standard headers.
+#include <string>
+
+using namespace foundation;
+
+namespace renderer
+{
+
+bool is_zorder_pixel_seeding(const ParamArray& params)
+{
+    return
+        params.get_optional<std::string>(
+            "pixel_seeding",
+            "hash",
+            make_vector("hash", "zorder")) == "zorder";
+}
+
+Dictionary get_pixel_seeding_metadata()
+{
+    return
+        Dictionary()
+            .insert("type", "enum")
+            .insert("values", "hash|zorder")
+            .insert("default", "hash")
+            .insert("label", "Pixel Seeding")
+            .insert("help", "How sampling sequences are decorrelated between pixels")
+            .insert(
+                "options",
+                Dictionary()
+                    .insert(
+                        "hash",
+                        Dictionary()
+                            .insert("label", "Hash")
+                            .insert("help", "Each pixel uses an independently seeded sequence"))
+                    .insert(
+                        "zorder",
+                        Dictionary()
+                            .insert("label", "Z-Order")
+                            .insert("help", "Pixels use consecutive blocks of a shared sequence along a Z-order curve")));
+}
+
+}   // namespace renderer
@@ -0,0 +1,81 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/containers/dictionary.h"
+#include "foundation/math/vector.h"
+
+// Standard headers.
+#include <cstdint>
+
+// Forward declarations.
+namespace renderer  { class ParamArray; }
+
+namespace renderer
+{
+
+//
+// Pixel seeding controls how sampling sequences are decorrelated between pixels:
+//
+//   - With "hash" seeding, each pixel uses an independently seeded sequence.
+//
+//   - With "zorder" seeding, all pixels share a single sequence and consecutive pixels
+//     along a Z-order curve use consecutive blocks of samples, which distributes error
+//     as blue noise in screen space. Pixel renderers give each pixel a block as large
+//     as its maximum number of samples.
+//
+
+// Return true if the parameters request Z-order pixel seeding.
+bool is_zorder_pixel_seeding(const ParamArray& params);
+
+// Return the metadata of the pixel_seeding parameter.
+foundation::Dictionary get_pixel_seeding_metadata();
+
+// Interleave the bits of the coordinates of a pixel to get its index along a Z-order curve.
+std::uint32_t zorder_pixel_index(const foundation::Vector2i& pi);
+
+
+//
+// Implementation.
+//
+
+inline std::uint32_t zorder_pixel_index(const foundation::Vector2i& pi)
+{
+    std::uint32_t index = 0;
+
+    for (std::uint32_t i = 0; i < 16; ++i)
+    {
+        index |= ((static_cast<std::uint32_t>(pi.x) >> i) & 1) << (2 * i);
+        index |= ((static_cast<std::uint32_t>(pi.y) >> i) & 1) << (2 * i + 1);
+    }
+
+    return index;
+}
+
+}   // namespace renderer
@@ -34,6 +34,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/aov/aovaccumulator.h"
 #include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/rendering/final/pixelseeding.h"
 #include "renderer/kernel/rendering/isamplerenderer.h"
 #include "renderer/kernel/rendering/pixelcontext.h"
 #include "renderer/kernel/rendering/pixelrendererbase.h"
@@ -120,10 +121,12 @@ namespace
                 "texture-controlled pixel renderer settings:\n"
                 "  min samples                   %s\n"
                 "  max samples                   %s\n"
-                "  force anti-aliasing           %s\n",
+                "  force anti-aliasing           %s\n"
+                "  pixel seeding                 %s",
                 pretty_uint(m_params.m_min_samples).c_str(),
                 pretty_uint(m_params.m_max_samples).c_str(),
-                m_params.m_force_aa ? "on" : "off");
+                m_params.m_force_aa ? "on" : "off",
+                m_params.m_zorder_pixel_seeding ? "z-order" : "hash");
 
             m_sample_renderer->print_settings();
         }
@@ -146,8 +149,12 @@ namespace
             // Create a sampling context.
             const size_t frame_width = frame.image().properties().m_canvas_width;
             const size_t pixel_index = pi.y * frame_width + pi.x;
-            const size_t instance = hash_uint32(static_cast<std::uint32_t>(pass_hash + pixel_index));
-            SamplingContext::RNGType rng(pass_hash, instance);
+            const size_t pixel_hash = hash_uint32(static_cast<std::uint32_t>(pass_hash + pixel_index));
+            const size_t instance =
+                m_params.m_zorder_pixel_seeding
+                    ? hash_uint32(pass_hash)
+                    : pixel_hash;
+            SamplingContext::RNGType rng(pass_hash, pixel_hash);
             SamplingContext sampling_context(
                 rng,
                 m_params.m_sampling_mode,
@@ -155,6 +162,11 @@ namespace
                 0,                          // number of samples -- unknown
                 instance);                  // initial instance number
 
+            // With Z-order seeding, each pixel uses its own block of the shared sequence,
+            // sized for the maximum number of samples per pixel.
+            if (m_params.m_zorder_pixel_seeding)
+                sampling_context.set_instance(instance + zorder_pixel_index(pi) * m_max_sample_count);
+
             const ROI roi(
                 pi.x,
                 pi.x + 1,
@@ -242,12 +254,14 @@ namespace
             const size_t                    m_min_samples;
             const size_t                    m_max_samples;
             const bool                      m_force_aa;
+            const bool                      m_zorder_pixel_seeding;
 
             explicit Parameters(const ParamArray& params)
               : m_sampling_mode(get_sampling_context_mode(params))
               , m_min_samples(params.get_required<size_t>("min_samples", 0))
               , m_max_samples(params.get_required<size_t>("max_samples", 64))
               , m_force_aa(params.get_optional<bool>("force_antialiasing", false))
+              , m_zorder_pixel_seeding(is_zorder_pixel_seeding(params))
             {
             }
         };
@@ -304,6 +318,8 @@ Dictionary TextureControlledPixelRendererFactory::get_params_metadata()
                 "help",
                 "When using 1 sample/pixel and Force Anti-Aliasing is disabled, samples are placed at the center of pixels"));
 
+    metadata.dictionaries().insert("pixel_seeding", get_pixel_seeding_metadata());
+
     return metadata;
 }
 
@@ -35,6 +35,7 @@
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/aov/aovaccumulator.h"
 #include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/rendering/final/pixelseeding.h"
 #include "renderer/kernel/rendering/isamplerenderer.h"
 #include "renderer/kernel/rendering/pixelcontext.h"
 #include "renderer/kernel/rendering/pixelrendererbase.h"
@@ -61,6 +62,8 @@
 // Standard headers.
 #include <cmath>
 #include <cstdint>
+#include <deque>
+#include <vector>
 
 using namespace foundation;
 
@@ -72,6 +75,10 @@ namespace
     //
     // Uniform pixel renderer.
     //
+    // When the sample renderer renders samples in batches, pixels are not rendered
+    // as soon as they are submitted: their samples are queued until there are enough
+    // of them to fill a batch, or until the end of the tile.
+    //
 
     class UniformPixelRenderer
       : public PixelRendererBase
@@ -85,7 +92,11 @@ namespace
           : m_params(params)
           , m_sample_renderer(factory->create(thread_index))
           , m_sample_count(m_params.m_samples)
+          , m_max_batch_size(m_sample_renderer->get_max_batch_size())
         {
+            if (m_max_batch_size > 0)
+                m_samples.reserve(m_max_batch_size + m_sample_count);
+
             const size_t sample_aov_index = frame.aovs().get_index("pixel_sample_count");
 
             // If the sample count AOV is enabled, we need to reset its normalization
@@ -110,13 +121,29 @@ namespace
             RENDERER_LOG_INFO(
                 "uniform pixel renderer settings:\n"
                 "  samples                       %s\n"
-                "  force anti-aliasing           %s",
+                "  force anti-aliasing           %s\n"
+                "  pixel seeding                 %s",
                 pretty_uint(m_params.m_samples).c_str(),
-                m_params.m_force_aa ? "on" : "off");
+                m_params.m_force_aa ? "on" : "off",
+                m_params.m_zorder_pixel_seeding ? "z-order" : "hash");
 
             m_sample_renderer->print_settings();
         }
 
+        void on_tile_begin(
+            const Frame&                frame,
+            const size_t                tile_x,
+            const size_t                tile_y,
+            Tile&                       tile,
+            TileStack&                  aov_tiles) override
+        {
+            PixelRendererBase::on_tile_begin(frame, tile_x, tile_y, tile, aov_tiles);
+
+            // Discard the pixels left over by a tile whose rendering was aborted.
+            m_samples.clear();
+            m_queued_pixels.clear();
+        }
+
         void render_pixel(
             const Frame&                frame,
             Tile&                       tile,
@@ -128,38 +155,29 @@ namespace
             AOVAccumulatorContainer&    aov_accumulators,
             ShadingResultFrameBuffer&   framebuffer) override
         {
+            if (m_max_batch_size > 0)
+            {
+                queue_pixel(frame, pass_hash, pi, pt);
+
+                if (m_samples.size() >= m_max_batch_size)
+                    render_queued_pixels(frame, tile_bbox, aov_accumulators, framebuffer);
+
+                return;
+            }
+
             const size_t aov_count = frame.aov_images().size();
 
             on_pixel_begin(frame, pi, pt, tile_bbox, aov_accumulators);
 
             // Create a sampling context.
-            const size_t frame_width = frame.image().properties().m_canvas_width;
-            const size_t pixel_index = pi.y * frame_width + pi.x;
-            const size_t instance = hash_uint32(static_cast<std::uint32_t>(pass_hash + pixel_index));
-            SamplingContext::RNGType rng(pass_hash, instance);
-            SamplingContext sampling_context(
-                rng,
-                m_params.m_sampling_mode,
-                2,                          // number of dimensions
-                0,                          // number of samples -- unknown
-                instance);                  // initial instance number
+            const size_t pixel_hash = compute_pixel_hash(frame, pass_hash, pi);
+            SamplingContext::RNGType rng(pass_hash, pixel_hash);
+            SamplingContext sampling_context(create_sampling_context(rng, pass_hash, pixel_hash, pi));
 
             for (size_t i = 0, e = m_sample_count; i < e; ++i)
             {
-                // Generate a uniform sample in [0,1)^2.
-                const Vector2f s =
-                    m_sample_count > 1 || m_params.m_force_aa
-                        ? sampling_context.next2<Vector2f>()
-                        : Vector2f(0.5f);
-
-                // Sample the pixel filter.
-                const auto& filter_table = frame.get_filter_sampling_table();
-                const Vector2d pf(
-                    static_cast<double>(filter_table.sample(s[0]) + 0.5f),
-                    static_cast<double>(filter_table.sample(s[1]) + 0.5f));
-
                 // Compute the sample position in NDC.
-                const Vector2d sample_position = frame.get_sample_position(pi.x + pf.x, pi.y + pf.y);
+                const Vector2d sample_position = sample_pixel(frame, sampling_context, pi);
 
                 // Create a pixel context that identifies the pixel and sample currently being rendered.
                 const PixelContext pixel_context(pi, sample_position);
@@ -186,6 +204,16 @@ namespace
             on_pixel_end(frame, pi, pt, tile_bbox, aov_accumulators);
         }
 
+        void flush_pixels(
+            const Frame&                frame,
+            const AABB2i&               tile_bbox,
+            AOVAccumulatorContainer&    aov_accumulators,
+            ShadingResultFrameBuffer&   framebuffer) override
+        {
+            if (!m_samples.empty())
+                render_queued_pixels(frame, tile_bbox, aov_accumulators, framebuffer);
+        }
+
         StatisticsVector get_statistics() const override
         {
             Statistics stats;
@@ -209,11 +237,35 @@ namespace
             const SamplingContext::Mode     m_sampling_mode;
             const size_t                    m_samples;
             const bool                      m_force_aa;
+            const bool                      m_zorder_pixel_seeding;
 
             explicit Parameters(const ParamArray& params)
               : m_sampling_mode(get_sampling_context_mode(params))
               , m_samples(params.get_required<size_t>("samples", 64))
               , m_force_aa(params.get_optional<bool>("force_antialiasing", false))
+              , m_zorder_pixel_seeding(is_zorder_pixel_seeding(params))
+            {
+            }
+        };
+
+        // A pixel whose samples are waiting to be rendered.
+        struct QueuedPixel
+        {
+            Vector2i                        m_pi;
+            Vector2i                        m_pt;
+            SamplingContext::RNGType        m_rng;              // referenced by the sampling contexts of the samples
+            size_t                          m_sample_begin;     // index of the first sample of this pixel in m_samples
+
+            QueuedPixel(
+                const Vector2i&             pi,
+                const Vector2i&             pt,
+                const std::uint32_t         pass_hash,
+                const size_t                pixel_hash,
+                const size_t                sample_begin)
+              : m_pi(pi)
+              , m_pt(pt)
+              , m_rng(pass_hash, static_cast<std::uint32_t>(pixel_hash))
+              , m_sample_begin(sample_begin)
             {
             }
         };
@@ -221,7 +273,132 @@ namespace
         const Parameters                    m_params;
         auto_release_ptr<ISampleRenderer>   m_sample_renderer;
         const size_t                        m_sample_count;
+        const size_t                        m_max_batch_size;
+        std::vector<SampleRequest>          m_samples;
+        std::deque<QueuedPixel>             m_queued_pixels;    // deque: random number generators must not move
         Population<std::uint64_t>           m_total_sampling_dim;
+
+        size_t compute_pixel_hash(
+            const Frame&                    frame,
+            const std::uint32_t             pass_hash,
+            const Vector2i&                 pi) const
+        {
+            const size_t frame_width = frame.image().properties().m_canvas_width;
+            const size_t pixel_index = pi.y * frame_width + pi.x;
+            return hash_uint32(static_cast<std::uint32_t>(pass_hash + pixel_index));
+        }
+
+        SamplingContext create_sampling_context(
+            SamplingContext::RNGType&       rng,
+            const std::uint32_t             pass_hash,
+            const size_t                    pixel_hash,
+            const Vector2i&                 pi) const
+        {
+            const size_t instance =
+                m_params.m_zorder_pixel_seeding
+                    ? hash_uint32(pass_hash)
+                    : pixel_hash;
+
+            SamplingContext sampling_context(
+                rng,
+                m_params.m_sampling_mode,
+                2,                          // number of dimensions
+                0,                          // number of samples -- unknown
+                instance);                  // initial instance number
+
+            // With Z-order seeding, each pixel uses its own block of the shared sequence.
+            if (m_params.m_zorder_pixel_seeding)
+                sampling_context.set_instance(instance + zorder_pixel_index(pi) * m_sample_count);
+
+            return sampling_context;
+        }
+
+        Vector2d sample_pixel(
+            const Frame&                    frame,
+            SamplingContext&                sampling_context,
+            const Vector2i&                 pi) const
+        {
+            // Generate a uniform sample in [0,1)^2.
+            const Vector2f s =
+                m_sample_count > 1 || m_params.m_force_aa
+                    ? sampling_context.next2<Vector2f>()
+                    : Vector2f(0.5f);
+
+            // Sample the pixel filter.
+            const auto& filter_table = frame.get_filter_sampling_table();
+            const Vector2d pf(
+                static_cast<double>(filter_table.sample(s[0]) + 0.5f),
+                static_cast<double>(filter_table.sample(s[1]) + 0.5f));
+
+            // Compute the sample position in NDC.
+            return frame.get_sample_position(pi.x + pf.x, pi.y + pf.y);
+        }
+
+        void queue_pixel(
+            const Frame&                    frame,
+            const std::uint32_t             pass_hash,
+            const Vector2i&                 pi,
+            const Vector2i&                 pt)
+        {
+            const size_t aov_count = frame.aov_images().size();
+
+            const size_t pixel_hash = compute_pixel_hash(frame, pass_hash, pi);
+            m_queued_pixels.emplace_back(pi, pt, pass_hash, pixel_hash, m_samples.size());
+
+            SamplingContext sampling_context(
+                create_sampling_context(
+                    m_queued_pixels.back().m_rng,
+                    pass_hash,
+                    pixel_hash,
+                    pi));
+
+            // Generate all the samples of this pixel.
+            for (size_t i = 0, e = m_sample_count; i < e; ++i)
+            {
+                const Vector2d sample_position = sample_pixel(frame, sampling_context, pi);
+
+                m_samples.emplace_back(
+                    sampling_context,
+                    PixelContext(pi, sample_position),
+                    sample_position,
+                    aov_count);
+            }
+        }
+
+        void render_queued_pixels(
+            const Frame&                    frame,
+            const AABB2i&                   tile_bbox,
+            AOVAccumulatorContainer&        aov_accumulators,
+            ShadingResultFrameBuffer&       framebuffer)
+        {
+            // Render the samples of all queued pixels at once.
+            m_sample_renderer->render_samples(m_samples.data(), m_samples.size());
+
+            // Complete the pixels one by one, in the order they were submitted.
+            for (const QueuedPixel& pixel : m_queued_pixels)
+            {
+                on_pixel_begin(frame, pixel.m_pi, pixel.m_pt, tile_bbox, aov_accumulators);
+
+                for (size_t i = pixel.m_sample_begin, e = pixel.m_sample_begin + m_sample_count; i < e; ++i)
+                {
+                    SampleRequest& sample = m_samples[i];
+                    m_sample_renderer->resolve_sample(sample, i, aov_accumulators);
+
+                    // Update sampling statistics.
+                    m_total_sampling_dim.insert(sample.m_sampling_context.get_total_dimension());
+
+                    // Merge the sample into the framebuffer.
+                    if (sample.m_shading_result.is_valid())
+                        framebuffer.add(Vector2u(pixel.m_pt), sample.m_shading_result);
+                    else signal_invalid_sample();
+                }
+
+                on_pixel_end(frame, pixel.m_pi, pixel.m_pt, tile_bbox, aov_accumulators);
+            }
+
+            m_samples.clear();
+            m_queued_pixels.clear();
+        }
     };
 }
 
@@ -252,6 +429,8 @@ Dictionary UniformPixelRendererFactory::get_params_metadata()
                 "help",
                 "When using 1 sample/pixel and Force Anti-Aliasing is disabled, samples are placed at the center of pixels"));
 
+    metadata.dictionaries().insert("pixel_seeding", get_pixel_seeding_metadata());
+
     return metadata;
 }
 
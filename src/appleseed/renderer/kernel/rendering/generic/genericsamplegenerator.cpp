@@ -261,7 +261,9 @@ SampleAccumulationBuffer* GenericSampleGeneratorFactory::create_sample_accumulat
     return
         new LocalSampleAccumulationBuffer(
             props.m_canvas_width,
-            props.m_canvas_height);
+            props.m_canvas_height,
+            props.m_tile_width,
+            props.m_tile_height);
 }
 
 }   // namespace renderer
@@ -43,6 +43,7 @@
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingengine.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/kernel/shading/shadingresult.h"
 #include "renderer/kernel/texturing/oiiotexturesystem.h"
@@ -97,6 +98,7 @@ namespace
             ShadingEngine&          shading_engine,
             OIIOTextureSystem&      oiio_texture_system,
             OSLShadingSystem&       shading_system,
+            ShadingProfiler*        shading_profiler,
             const size_t            thread_index,
             const ParamArray&       params)
           : m_params(params)
@@ -107,6 +109,10 @@ namespace
           , m_shading_engine(shading_engine)
           , m_oiio_texture_system(oiio_texture_system)
           , m_thread_index(thread_index)
+          , m_profiler_counters(
+                shading_profiler != nullptr
+                    ? shading_profiler->create_thread_counters()
+                    : nullptr)
           , m_shadergroup_exec(shading_system, m_arena)
           , m_intersector(
                 trace_context,
@@ -175,6 +181,9 @@ namespace
 
 #endif
 
+            // Attribute the time spent rendering this sample to this thread's profiler counters.
+            const ShadingProfiler::Binding profiler_binding(m_profiler_counters);
+
             // Construct a primary ray.
             ShadingRay primary_ray;
             m_scene.get_render_data().m_active_camera->spawn_ray(
@@ -326,6 +335,7 @@ namespace
         ShadingEngine&              m_shading_engine;
         OIIOTextureSystem&          m_oiio_texture_system;
         const size_t                m_thread_index;
+        ShadingProfiler::ThreadCounters* m_profiler_counters;
 
         Arena                       m_arena;
         OSLShaderGroupExec          m_shadergroup_exec;
@@ -352,6 +362,7 @@ GenericSampleRendererFactory::GenericSampleRendererFactory(
     ShadingEngine&          shading_engine,
     OIIOTextureSystem&      oiio_texture_system,
     OSLShadingSystem&       shading_system,
+    ShadingProfiler*        shading_profiler,
     const ParamArray&       params)
   : m_scene(scene)
   , m_frame(frame)
@@ -361,6 +372,7 @@ GenericSampleRendererFactory::GenericSampleRendererFactory(
   , m_shading_engine(shading_engine)
   , m_oiio_texture_system(oiio_texture_system)
   , m_shading_system(shading_system)
+  , m_shading_profiler(shading_profiler)
   , m_params(params)
 {
 }
@@ -382,6 +394,7 @@ ISampleRenderer* GenericSampleRendererFactory::create(const size_t thread_index)
             m_shading_engine,
             m_oiio_texture_system,
             m_shading_system,
+            m_shading_profiler,
             thread_index,
             m_params);
 }
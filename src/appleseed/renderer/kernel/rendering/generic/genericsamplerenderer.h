@@ -43,6 +43,7 @@ namespace renderer  { class OIIOTextureSystem; }
 namespace renderer  { class OSLShadingSystem; }
 namespace renderer  { class Scene; }
 namespace renderer  { class ShadingEngine; }
+namespace renderer  { class ShadingProfiler; }
 namespace renderer  { class TextureStore; }
 namespace renderer  { class TraceContext; }
 
@@ -67,6 +68,7 @@ class GenericSampleRendererFactory
         ShadingEngine&          shading_engine,
         OIIOTextureSystem&      oiio_texture_system,
         OSLShadingSystem&       shading_system,
+        ShadingProfiler*        shading_profiler,
         const ParamArray&       params);
 
     // Delete this instance.
@@ -85,6 +87,7 @@ class GenericSampleRendererFactory
     ShadingEngine&              m_shading_engine;
     OIIOTextureSystem&          m_oiio_texture_system;
     OSLShadingSystem&           m_shading_system;
+    ShadingProfiler*            m_shading_profiler;
     const ParamArray            m_params;
 };
 
@@ -207,6 +207,13 @@ namespace
                     *framebuffer);
             }
 
+            // Let the pixel renderer finish the pixels it has deferred.
+            m_pixel_renderer->flush_pixels(
+                frame,
+                tile_bbox,
+                m_aov_accumulators,
+                *framebuffer);
+
             // Develop the framebuffer to the tile.
             framebuffer->develop_to_tile(tile, aov_tiles);
 
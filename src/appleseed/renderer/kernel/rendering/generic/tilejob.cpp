@@ -39,6 +39,7 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <cassert>
@@ -141,6 +142,8 @@ void TileJob::execute(const size_t thread_index)
 
     try
     {
+        APPLESEED_TRACE_SCOPE("rendering", "render tile", "x", m_tile_x, "y", m_tile_y);
+
         // Render the tile.
         m_tile_renderers[thread_index]->render_tile(
             m_frame,
@@ -162,6 +165,9 @@ void TileJob::execute(const size_t thread_index)
     // Call the post-render tile callback.
     if (tile_callback)
         tile_callback->on_tile_end(&m_frame, m_tile_x, m_tile_y);
+
+    // The tile is finished, allow it to be evicted from memory.
+    m_frame.release_tile(m_tile_x, m_tile_y);
 }
 
 }   // namespace renderer
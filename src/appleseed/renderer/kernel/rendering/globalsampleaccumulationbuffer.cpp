@@ -52,8 +52,12 @@ namespace renderer
 
 GlobalSampleAccumulationBuffer::GlobalSampleAccumulationBuffer(
     const size_t    width,
-    const size_t    height)
-  : m_fb(width, height, 3)
+    const size_t    height,
+    const size_t    tile_width,
+    const size_t    tile_height)
+  : SampleAccumulationBuffer(width, height, tile_width, tile_height)
+  , m_fb(width, height, 3)
+  , m_developed_sample_count(0)
 {
 }
 
@@ -65,6 +69,8 @@ void GlobalSampleAccumulationBuffer::clear()
     m_sample_count = 0;
 
     m_fb.clear();
+
+    m_dirty_tiles.mark_all();
 }
 
 void GlobalSampleAccumulationBuffer::store_samples(
@@ -115,7 +121,15 @@ void GlobalSampleAccumulationBuffer::develop_to_frame(
     assert(frame_props.m_canvas_height == m_fb.get_height());
     assert(frame_props.m_channel_count == 4);
 
-    const float scale = 1.0f / m_sample_count;
+    // Pixel values are normalized by the total sample count: when it changes, all tiles change.
+    const std::uint64_t sample_count = m_sample_count;
+    if (sample_count != m_developed_sample_count)
+    {
+        m_dirty_tiles.mark_all();
+        m_developed_sample_count = sample_count;
+    }
+
+    const float scale = 1.0f / sample_count;
 
     for (size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty)
     {
@@ -124,12 +138,19 @@ void GlobalSampleAccumulationBuffer::develop_to_frame(
             if (abort_switch.is_aborted())
                 return;
 
+            if (!m_dirty_tiles.fetch_and_clear(tx, ty))
+                continue;
+
             Tile& tile = image.tile(tx, ty);
 
             const size_t x = tx * frame_props.m_tile_width;
             const size_t y = ty * frame_props.m_tile_height;
 
             develop_to_tile(tile, x, y, tx, ty, scale);
+
+            frame.release_tile(tx, ty);
+
+            m_updated_tiles.mark_tile(tx, ty);
         }
     }
 }
@@ -57,7 +57,9 @@ class GlobalSampleAccumulationBuffer
     // Constructor.
     GlobalSampleAccumulationBuffer(
         const size_t                width,
-        const size_t                height);
+        const size_t                height,
+        const size_t                tile_width,
+        const size_t                tile_height);
 
     // Reset the buffer to its initial state. Thread-safe.
     void clear() override;
@@ -79,6 +81,7 @@ class GlobalSampleAccumulationBuffer
   private:
     boost::shared_mutex             m_mutex;
     foundation::AccumulatorTile     m_fb;
+    std::uint64_t                   m_developed_sample_count;
 
     void develop_to_tile(
         foundation::Tile&           tile,
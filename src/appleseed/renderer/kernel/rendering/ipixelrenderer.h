@@ -88,6 +88,14 @@ class IPixelRenderer
         AOVAccumulatorContainer&    aov_accumulators,
         ShadingResultFrameBuffer&   framebuffer) = 0;
 
+    // Finish rendering the pixels whose rendering was deferred by render_pixel(), if any.
+    // This method is called once all the pixels of a tile were passed to render_pixel().
+    virtual void flush_pixels(
+        const Frame&                frame,
+        const foundation::AABB2i&   tile_bbox,
+        AOVAccumulatorContainer&    aov_accumulators,
+        ShadingResultFrameBuffer&   framebuffer) = 0;
+
     // Retrieve performance statistics.
     virtual foundation::StatisticsVector get_statistics() const = 0;
 
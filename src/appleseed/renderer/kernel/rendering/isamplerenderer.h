@@ -31,6 +31,8 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globaltypes.h"
+#include "renderer/kernel/rendering/pixelcontext.h"
+#include "renderer/kernel/shading/shadingresult.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
@@ -42,12 +44,32 @@
 // Forward declarations.
 namespace foundation    { class StatisticsVector; }
 namespace renderer      { class AOVAccumulatorContainer; }
-namespace renderer      { class PixelContext; }
-namespace renderer      { class ShadingResult; }
 
 namespace renderer
 {
 
+//
+// A sample submitted to ISampleRenderer::render_samples().
+//
+
+struct SampleRequest
+{
+    SamplingContext         m_sampling_context;
+    PixelContext            m_pixel_context;
+    foundation::Vector2d    m_image_point;
+    ShadingResult           m_shading_result;
+
+    SampleRequest(
+        const SamplingContext&          sampling_context,
+        const PixelContext&             pixel_context,
+        const foundation::Vector2d&     image_point,
+        const size_t                    aov_count);
+
+    // ShadingResult is not copyable, but requests are stored in vectors.
+    SampleRequest(const SampleRequest& rhs);
+};
+
+
 //
 // Sample renderer interface.
 //
@@ -68,6 +90,28 @@ class ISampleRenderer
         AOVAccumulatorContainer&        aov_accumulators,
         ShadingResult&                  shading_result) = 0;
 
+    // Return the maximum number of samples that should be passed to render_samples() at once,
+    // or 0 if this sample renderer renders samples one at a time with render_sample().
+    // The default implementation returns 0.
+    virtual size_t get_max_batch_size() const;
+
+    // Render a batch of samples, possibly belonging to many pixels. The AOV accumulators are
+    // not involved at this point: every sample must then be completed with resolve_sample(),
+    // between the on_pixel_begin() and on_pixel_end() calls of the pixel it belongs to.
+    // The default implementation does nothing and leaves all the work to resolve_sample().
+    virtual void render_samples(
+        SampleRequest*                  samples,
+        const size_t                    sample_count);
+
+    // Complete the rendering of the sample at a given index in the last batch passed to
+    // render_samples(). The AOV accumulators' on_sample_begin() and on_sample_end() methods
+    // are called around the accumulation of this sample only.
+    // The default implementation renders the sample with render_sample().
+    virtual void resolve_sample(
+        SampleRequest&                  sample,
+        const size_t                    sample_index,
+        AOVAccumulatorContainer&        aov_accumulators);
+
     // Retrieve performance statistics.
     virtual foundation::StatisticsVector get_statistics() const = 0;
 };
@@ -85,4 +129,62 @@ class ISampleRendererFactory
     virtual ISampleRenderer* create(const size_t thread_index) = 0;
 };
 
+
+//
+// SampleRequest class implementation.
+//
+
+inline SampleRequest::SampleRequest(
+    const SamplingContext&              sampling_context,
+    const PixelContext&                 pixel_context,
+    const foundation::Vector2d&         image_point,
+    const size_t                        aov_count)
+  : m_sampling_context(sampling_context)
+  , m_pixel_context(pixel_context)
+  , m_image_point(image_point)
+  , m_shading_result(aov_count)
+{
+}
+
+inline SampleRequest::SampleRequest(const SampleRequest& rhs)
+  : m_sampling_context(rhs.m_sampling_context)
+  , m_pixel_context(rhs.m_pixel_context)
+  , m_image_point(rhs.m_image_point)
+  , m_shading_result(rhs.m_shading_result.m_aov_count)
+{
+    m_shading_result.m_main = rhs.m_shading_result.m_main;
+
+    for (size_t i = 0, e = rhs.m_shading_result.m_aov_count; i < e; ++i)
+        m_shading_result.m_aovs[i] = rhs.m_shading_result.m_aovs[i];
+}
+
+
+//
+// ISampleRenderer class implementation.
+//
+
+inline size_t ISampleRenderer::get_max_batch_size() const
+{
+    return 0;
+}
+
+inline void ISampleRenderer::render_samples(
+    SampleRequest*                      samples,
+    const size_t                        sample_count)
+{
+}
+
+inline void ISampleRenderer::resolve_sample(
+    SampleRequest&                      sample,
+    const size_t                        sample_index,
+    AOVAccumulatorContainer&            aov_accumulators)
+{
+    render_sample(
+        sample.m_sampling_context,
+        sample.m_pixel_context,
+        sample.m_image_point,
+        aov_accumulators,
+        sample.m_shading_result);
+}
+
 }   // namespace renderer
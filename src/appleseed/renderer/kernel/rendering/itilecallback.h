@@ -92,6 +92,26 @@ class APPLESEED_DLLSYMBOL ITileCallback
         const std::uint64_t     samples,
         const double            samples_per_pixel,
         const std::uint64_t     samples_per_second) = 0;
+
+    // This method is called after the frame has been updated, with the indices
+    // (tile_y * tile_count_x + tile_x) of the tiles that changed since the previous
+    // update. The default implementation calls on_progressive_frame_update().
+    virtual void on_progressive_frame_tiles_update(
+        const Frame&            frame,
+        const double            time,
+        const std::uint64_t     samples,
+        const double            samples_per_pixel,
+        const std::uint64_t     samples_per_second,
+        const size_t            tile_count,
+        const size_t*           tile_indices)
+    {
+        on_progressive_frame_update(
+            frame,
+            time,
+            samples,
+            samples_per_pixel,
+            samples_per_second);
+    }
 };
 
 
@@ -77,12 +77,19 @@ namespace renderer
 //   pushing samples to and the level that is displayed. As soon as a level contains enough
 //   samples, it becomes the new active level.
 //
+//   Once the highest resolution level is active, develop_to_frame() only develops the
+//   tiles of the frame that received samples since they were last developed. Before that,
+//   coarser levels span several tiles and the whole frame is developed.
+//
 
 // #define PRINT_DETAILED_PERF_REPORTS
 
 LocalSampleAccumulationBuffer::LocalSampleAccumulationBuffer(
     const size_t        width,
-    const size_t        height)
+    const size_t        height,
+    const size_t        tile_width,
+    const size_t        tile_height)
+  : SampleAccumulationBuffer(width, height, tile_width, tile_height)
 {
     const size_t MinSize = 32;
 
@@ -143,6 +150,9 @@ void LocalSampleAccumulationBuffer::clear()
     }
 
     m_active_level = static_cast<std::uint32_t>(m_levels.size() - 1);
+    m_developed_level = m_active_level;
+
+    m_dirty_tiles.mark_all();
 }
 
 void LocalSampleAccumulationBuffer::store_samples(
@@ -169,6 +179,15 @@ void LocalSampleAccumulationBuffer::store_samples(
         RENDERER_LOG_DEBUG("store_samples: acquiring lock: %f", sw.get_seconds() * 1000.0);
 #endif
 
+        // Keep track of the tiles of the frame that receive samples.
+        const Sample* sample_end = samples + sample_count;
+        for (const Sample* s = samples; s < sample_end; ++s)
+        {
+            m_dirty_tiles.mark_pixel(
+                static_cast<size_t>(s->m_pixel_coords.x),
+                static_cast<size_t>(s->m_pixel_coords.y));
+        }
+
         // Store samples at every level, starting with the highest resolution level up to the active level.
         size_t counter = 0;
         for (std::uint32_t i = 0, e = m_active_level; i <= e; ++i)
@@ -176,7 +195,6 @@ void LocalSampleAccumulationBuffer::store_samples(
             AccumulatorTile* level = m_levels[i];
             const Vector2f& level_scale = m_level_scales[i];
 
-            const Sample* sample_end = samples + sample_count;
             for (const Sample* s = samples; s < sample_end; ++s)
             {
                 if ((counter++ & 4096) == 0 && abort_switch.is_aborted())
@@ -261,7 +279,11 @@ void LocalSampleAccumulationBuffer::develop_to_frame(
 
     const AABB2u& crop_window = frame.get_crop_window();
 
-    const AccumulatorTile& level = *m_levels[m_active_level];
+    const std::uint32_t active_level = m_active_level;
+    const AccumulatorTile& level = *m_levels[active_level];
+
+    // Coarser levels span several tiles: develop all tiles while they are displayed.
+    const bool develop_all_tiles = active_level > 0 || m_developed_level > 0;
 
     for (size_t ty = 0; ty < frame_props.m_tile_count_y; ++ty)
     {
@@ -273,6 +295,9 @@ void LocalSampleAccumulationBuffer::develop_to_frame(
                 return;
             }
 
+            if (!m_dirty_tiles.fetch_and_clear(tx, ty) && !develop_all_tiles)
+                continue;
+
             const size_t origin_x = tx * frame_props.m_tile_width;
             const size_t origin_y = ty * frame_props.m_tile_height;
 
@@ -291,9 +316,15 @@ void LocalSampleAccumulationBuffer::develop_to_frame(
                 origin_x,
                 origin_y,
                 rect);
+
+            frame.release_tile(tx, ty);
+
+            m_updated_tiles.mark_tile(tx, ty);
         }
     }
 
+    m_developed_level = active_level;
+
     m_lock.unlock_write();
 
 #ifdef PRINT_DETAILED_PERF_REPORTS
@@ -60,7 +60,9 @@ class LocalSampleAccumulationBuffer
     // Constructor.
     LocalSampleAccumulationBuffer(
         const size_t                            width,
-        const size_t                            height);
+        const size_t                            height,
+        const size_t                            tile_width,
+        const size_t                            tile_height);
 
     // Destructor.
     ~LocalSampleAccumulationBuffer() override;
@@ -99,6 +101,7 @@ class LocalSampleAccumulationBuffer
     std::vector<foundation::Vector2f>           m_level_scales;
     boost::atomic<std::int32_t>*                m_remaining_pixels;
     boost::atomic<std::uint32_t>                m_active_level;
+    std::uint32_t                               m_developed_level;
 };
 
 }   // namespace renderer
@@ -44,24 +44,30 @@
 #include "renderer/modeling/entity/onrenderbeginrecorder.h"
 #include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/postprocessingstage/postprocessingstage.h"
 #include "renderer/modeling/project/project.h"
 #include "renderer/modeling/project/renderingtimer.h"
 #include "renderer/modeling/scene/scene.h"
 #include "renderer/utility/settingsparsing.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/memory/autoreleaseptr.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/job/iabortswitch.h"
+#include "foundation/utility/job/parallelloop.h"
 #include "foundation/utility/otherwise.h"
 #include "foundation/utility/searchpaths.h"
 #include "foundation/utility/statistics.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <exception>
 #include <memory>
 #include <new>
@@ -101,6 +107,46 @@ namespace
       private:
         IRendererController& m_renderer_controller;
     };
+
+#ifdef APPLESEED_WITH_TRACING
+
+    // Record a timeline of the rendering process and write it to disk when going out of scope.
+    // Nothing is recorded if the path of the trace file is empty.
+    class TraceSession
+      : public NonCopyable
+    {
+      public:
+        explicit TraceSession(const std::string& path)
+          : m_path(path)
+        {
+            if (!m_path.empty())
+                TraceRecorder::instance().start();
+        }
+
+        ~TraceSession()
+        {
+            if (m_path.empty())
+                return;
+
+            TraceRecorder& recorder = TraceRecorder::instance();
+            recorder.stop();
+
+            const size_t event_count = recorder.get_event_count();
+            RENDERER_LOG_INFO(
+                "writing " FMT_SIZE_T " trace event%s to %s...",
+                event_count,
+                event_count > 1 ? "s" : "",
+                m_path.c_str());
+
+            if (!recorder.write_chrome_trace(m_path.c_str()))
+                RENDERER_LOG_ERROR("failed to write trace file %s.", m_path.c_str());
+        }
+
+      private:
+        const std::string m_path;
+    };
+
+#endif
 }
 
 struct MasterRenderer::Impl
@@ -116,6 +162,7 @@ struct MasterRenderer::Impl
     ITileCallbackFactory*               m_serial_tile_callback_factory;
 
     std::unique_ptr<IRenderDevice>      m_render_device;
+    std::unique_ptr<ParallelLoop>       m_post_processing_loop;
 
     Impl(
         Project&                        project,
@@ -175,6 +222,12 @@ struct MasterRenderer::Impl
         // RenderingResult is initialized to Failed.
         RenderingResult result;
 
+#ifdef APPLESEED_WITH_TRACING
+        // Optionally record a timeline of the rendering process.
+        const TraceSession trace_session(m_params.get_optional<std::string>("trace_file", ""));
+        APPLESEED_TRACE_SCOPE("rendering", "render");
+#endif
+
         // Perform basic integrity checks on the scene.
         if (!check_scene())
             return result;
@@ -343,6 +396,11 @@ struct MasterRenderer::Impl
         // Construct an abort switch that will allow to abort initialization or rendering.
         RendererControllerAbortSwitch abort_switch(renderer_controller);
 
+        // Measure the time spent in each initialization step.
+        Statistics init_statistics;
+        RenderingTimer init_stopwatch;
+        init_stopwatch.start();
+
         // Let scene entities perform their pre-render actions. Don't proceed if that failed.
         // This is done before creating renderer components because renderer components need
         // to access the scene's render data such as the scene's bounding box.
@@ -354,6 +412,11 @@ struct MasterRenderer::Impl
             return renderer_controller.get_status();
         }
 
+        init_stopwatch.measure();
+        init_statistics.insert_time("scene preparation", init_stopwatch.get_seconds());
+        recorder.collect_parameters_statistics(init_statistics);
+        init_stopwatch.start();
+
         // Initialize the render device.
         const bool success =
             m_render_device->initialize(
@@ -371,6 +434,9 @@ struct MasterRenderer::Impl
                     : IRendererController::AbortRendering;
         }
 
+        init_stopwatch.measure();
+        init_statistics.insert_time("render device initialization", init_stopwatch.get_seconds());
+
         // Print render device settings.
         m_render_device->print_settings();
 
@@ -386,11 +452,14 @@ struct MasterRenderer::Impl
         else RENDERER_LOG_INFO("using built-in ray tracing kernel.");
 
         // Updating the device scene causes ray tracing acceleration structures to be updated or rebuilt.
+        init_stopwatch.start();
         if (!m_render_device->build_or_update_scene())
         {
             recorder.on_render_end(m_project);
             return IRendererController::AbortRendering;
         }
+        init_stopwatch.measure();
+        init_statistics.insert_time("scene update", init_stopwatch.get_seconds());
 
         // Load the checkpoint if any.
         Frame& frame = *m_project.get_frame();
@@ -407,15 +476,18 @@ struct MasterRenderer::Impl
         m_project.get_scene()->get_render_data().m_active_camera->print_settings();
 
         // Perform pre-render actions.
+        init_stopwatch.start();
         if (!m_render_device->on_render_begin(recorder, &abort_switch) ||
             abort_switch.is_aborted())
         {
             recorder.on_render_end(m_project);
             return renderer_controller.get_status();
         }
+        init_stopwatch.measure();
+        init_statistics.insert_time("render device preparation", init_stopwatch.get_seconds());
 
         // Execute the main rendering loop.
-        const auto status = render_frame(renderer_controller, abort_switch);
+        const auto status = render_frame(renderer_controller, abort_switch, &init_statistics);
 
         // Perform post-render actions.
         recorder.on_render_end(m_project);
@@ -430,9 +502,12 @@ struct MasterRenderer::Impl
     }
 
     // Render a frame until completed or aborted and handle restart events.
+    // If initialization statistics are provided, the preparation time of the first frame
+    // is added to them and they are printed before the first frame is rendered.
     IRendererController::Status render_frame(
         IRendererController&    renderer_controller,
-        IAbortSwitch&           abort_switch)
+        IAbortSwitch&           abort_switch,
+        Statistics*             init_statistics = nullptr)
     {
         // Combine the provided renderer controller and the (optional) frame renderer's controller into one.
         RendererControllerCollection combined_renderer_controller;
@@ -452,6 +527,8 @@ struct MasterRenderer::Impl
             m_project.get_light_path_recorder().clear();
 
             // Perform pre-frame actions. Don't proceed if that failed.
+            RenderingTimer stopwatch;
+            stopwatch.start();
             OnFrameBeginRecorder recorder;
             if (!m_render_device->on_frame_begin(recorder, &abort_switch) ||
                 !m_project.on_frame_begin(m_project, nullptr, recorder, &abort_switch) ||
@@ -461,6 +538,18 @@ struct MasterRenderer::Impl
                 combined_renderer_controller.on_frame_end();
                 return IRendererController::AbortRendering;
             }
+            stopwatch.measure();
+
+            // Print initialization statistics once the first frame is ready to be rendered.
+            if (init_statistics != nullptr)
+            {
+                init_statistics->insert_time("frame preparation", stopwatch.get_seconds());
+                RENDERER_LOG_INFO("%s",
+                    StatisticsVector::make(
+                        "rendering initialization statistics",
+                        *init_statistics).to_string().c_str());
+                init_statistics = nullptr;
+            }
 
             // Render the frame.
             const IRendererController::Status status =
@@ -490,6 +579,8 @@ struct MasterRenderer::Impl
 
     void postprocess()
     {
+        APPLESEED_TRACE_SCOPE("output", "post-process");
+
         Frame* frame = m_project.get_frame();
         assert(frame != nullptr);
 
@@ -528,16 +619,69 @@ struct MasterRenderer::Impl
             }
         }
 
+        // Post-processing stages process tiles in parallel using the rendering threads.
+        ParallelLoop& loop = get_post_processing_loop();
+
         // Execute post-processing stages.
-        for (PostProcessingStage* stage : ordered_stages)
+        for (size_t i = 0, e = ordered_stages.size(); i < e; )
         {
-            RENDERER_LOG_INFO("executing \"%s\" post-processing stage with order %d on frame \"%s\"...",
-                stage->get_path().c_str(), stage->get_order(), frame->get_path().c_str());
-            stage->execute(*frame);
+            // Group consecutive tile-local stages so that they are executed in a single pass.
+            size_t end = i + 1;
+            if (ordered_stages[i]->is_tile_local())
+            {
+                while (end < e && ordered_stages[end]->is_tile_local())
+                    ++end;
+            }
+
+            for (size_t j = i; j < end; ++j)
+            {
+                RENDERER_LOG_INFO("executing \"%s\" post-processing stage with order %d on frame \"%s\"...",
+                    ordered_stages[j]->get_path().c_str(), ordered_stages[j]->get_order(), frame->get_path().c_str());
+            }
+
+            if (end - i == 1)
+                ordered_stages[i]->execute(*frame, loop);
+            else execute_fused_post_processing_stages(*frame, &ordered_stages[i], end - i, loop);
+
             invoke_tile_callbacks(*frame);
+
+            i = end;
         }
     }
 
+    // Return the loop executing post-processing stages. It is kept across frames and renders
+    // so that its worker threads are started once, and only recreated if the number of
+    // rendering threads changed.
+    ParallelLoop& get_post_processing_loop()
+    {
+        const size_t thread_count = get_rendering_thread_count(m_params);
+
+        if (!m_post_processing_loop || m_post_processing_loop->get_thread_count() != thread_count)
+            m_post_processing_loop.reset(new ParallelLoop(global_logger(), thread_count));
+
+        return *m_post_processing_loop;
+    }
+
+    static void execute_fused_post_processing_stages(
+        Frame&                              frame,
+        PostProcessingStage* const*         stages,
+        const size_t                        stage_count,
+        ParallelLoop&                       loop)
+    {
+        const CanvasProperties& props = frame.image().properties();
+
+        loop.run(
+            props.m_tile_count,
+            [&frame, &props, stages, stage_count](const size_t tile_index, const size_t thread_index)
+            {
+                const size_t tile_x = tile_index % props.m_tile_count_x;
+                const size_t tile_y = tile_index / props.m_tile_count_x;
+
+                for (size_t i = 0; i < stage_count; ++i)
+                    stages[i]->execute_on_tile(frame, tile_x, tile_y);
+            });
+    }
+
     void invoke_tile_callbacks(const Frame& frame)
     {
         if (m_tile_callback_factory)
@@ -39,6 +39,7 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/image/tilepager.h"
 
 using namespace foundation;
 
@@ -47,12 +48,16 @@ namespace renderer
 
 PermanentShadingResultFrameBufferFactory::PermanentShadingResultFrameBufferFactory(
     const Frame&                frame)
+  : m_tile_pager(frame.get_tile_pager())
 {
     const CanvasProperties& props = frame.image().properties();
     const std::size_t tile_count_x = props.m_tile_count_x;
     const std::size_t tile_count_y = props.m_tile_count_y;
 
     m_framebuffers.resize(tile_count_x * tile_count_y, nullptr);
+
+    if (m_tile_pager != nullptr)
+        m_storage.resize(tile_count_x * tile_count_y, nullptr);
 }
 
 PermanentShadingResultFrameBufferFactory::~PermanentShadingResultFrameBufferFactory()
@@ -86,13 +91,32 @@ ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
     if (m_framebuffers[index] == nullptr)
     {
         const Tile& tile = frame.image().tile(tile_x, tile_y);
+        const std::size_t aov_count = frame.aov_images().size();
+
+        // Out-of-core frame buffers reuse their storage across calls to clear().
+        std::uint8_t* storage = nullptr;
+        if (m_tile_pager != nullptr)
+        {
+            if (m_storage[index] == nullptr)
+            {
+                m_storage[index] =
+                    m_tile_pager->allocate(
+                        ShadingResultFrameBuffer::get_storage_size(
+                            tile.get_width(),
+                            tile.get_height(),
+                            aov_count));
+            }
+
+            storage = m_storage[index];
+        }
 
         m_framebuffers[index] =
             new ShadingResultFrameBuffer(
                 tile.get_width(),
                 tile.get_height(),
-                frame.aov_images().size(),
-                tile_bbox);
+                aov_count,
+                tile_bbox,
+                storage);
 
         m_framebuffers[index]->clear();
     }
@@ -103,6 +127,9 @@ ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
 void PermanentShadingResultFrameBufferFactory::destroy(
     ShadingResultFrameBuffer*   framebuffer)
 {
+    // Frame buffers are kept until the next pass, but may be evicted from memory meanwhile.
+    if (m_tile_pager != nullptr)
+        m_tile_pager->release(framebuffer->get_storage(), framebuffer->get_size());
 }
 
 }   // namespace renderer
@@ -37,11 +37,13 @@
 
 // Standard headers.
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 // Forward declarations.
-namespace renderer  { class Frame; }
-namespace renderer  { class ShadingResultFrameBuffer; }
+namespace foundation    { class TilePager; }
+namespace renderer      { class Frame; }
+namespace renderer      { class ShadingResultFrameBuffer; }
 
 namespace renderer
 {
@@ -72,7 +74,9 @@ class PermanentShadingResultFrameBufferFactory
         ShadingResultFrameBuffer*   framebuffer) override;
 
   private:
-    std::vector<ShadingResultFrameBuffer*> m_framebuffers;
+    foundation::TilePager*                  m_tile_pager;
+    std::vector<ShadingResultFrameBuffer*>  m_framebuffers;
+    std::vector<std::uint8_t*>              m_storage;      // storage allocated from the tile pager, if any
 };
 
 }   // namespace renderer
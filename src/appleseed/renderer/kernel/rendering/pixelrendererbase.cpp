@@ -73,6 +73,14 @@ void PixelRendererBase::on_tile_end(
 {
 }
 
+void PixelRendererBase::flush_pixels(
+    const Frame&                frame,
+    const AABB2i&               tile_bbox,
+    AOVAccumulatorContainer&    aov_accumulators,
+    ShadingResultFrameBuffer&   framebuffer)
+{
+}
+
 void PixelRendererBase::on_pixel_begin(
     const Frame&                frame,
     const Vector2i&             pi,
@@ -43,6 +43,7 @@
 namespace foundation    { class Tile; }
 namespace renderer      { class AOVAccumulatorContainer; }
 namespace renderer      { class Frame; }
+namespace renderer      { class ShadingResultFrameBuffer; }
 namespace renderer      { class TileStack; }
 
 namespace renderer
@@ -75,6 +76,13 @@ class PixelRendererBase
         foundation::Tile&               tile,
         TileStack&                      aov_tiles) override;
 
+    // Finish rendering deferred pixels. The default implementation does nothing.
+    void flush_pixels(
+        const Frame&                    frame,
+        const foundation::AABB2i&       tile_bbox,
+        AOVAccumulatorContainer&        aov_accumulators,
+        ShadingResultFrameBuffer&       framebuffer) override;
+
   protected:
     void on_pixel_begin(
         const Frame&                    frame,
@@ -201,13 +201,19 @@ namespace
                 truncate<std::uint64_t>(m_sample_count_history.get_samples_per_second());
             m_sample_count_history_spinlock.unlock();
 
+            // Retrieve the tiles that changed since the last update.
+            m_updated_tiles.clear();
+            m_buffer.collect_updated_tiles(m_updated_tiles);
+
             // Present the frame.
-            m_tile_callback->on_progressive_frame_update(
+            m_tile_callback->on_progressive_frame_tiles_update(
                 m_frame,
                 time,
                 samples,
                 samples_per_pixel,
-                samples_per_second);
+                samples_per_second,
+                m_updated_tiles.size(),
+                m_updated_tiles.data());
 
 #ifdef PRINT_DISPLAY_THREAD_PERFS
             m_stopwatch.measure();
@@ -240,6 +246,7 @@ namespace
         DefaultWallclockTimer               m_timer;
         const double                        m_rcp_timer_freq;
         std::uint64_t                       m_start_time;
+        std::vector<size_t>                 m_updated_tiles;
     };
 
 
@@ -43,6 +43,7 @@
 #include "foundation/platform/defaulttimers.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <algorithm>
@@ -125,6 +126,8 @@ void SampleGeneratorJob::execute(const size_t thread_index)
     // samples during this phase; fix.
     const bool abortable = current_sample_count > m_sampling_profile.m_samples_in_uninterruptible_phase;
 
+    APPLESEED_TRACE_SCOPE("rendering", "generate samples", "job", m_job_index, "samples", acquired_sample_count);
+
     // Render the samples and store them into the accumulation buffer.
     if (abortable)
     {
@@ -51,17 +51,24 @@
 #include "renderer/kernel/rendering/generic/generictilerenderer.h"
 #include "renderer/kernel/rendering/permanentshadingresultframebufferfactory.h"
 #include "renderer/kernel/rendering/progressive/progressiveframerenderer.h"
+#include "renderer/kernel/rendering/wavefront/wavefrontsamplerenderer.h"
 #include "renderer/kernel/shading/oslshadingsystem.h"
 #include "renderer/kernel/texturing/oiiotexturesystem.h"
+#include "renderer/modeling/aov/aov.h"
+#include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/project/project.h"
 #include "renderer/utility/paramarray.h"
 
+// appleseed.foundation headers.
+#include "foundation/utility/tracerecorder.h"
+
 // OpenImageIO headers.
 #include "foundation/platform/_beginoiioheaders.h"
 #include "OpenImageIO/imagebuf.h"
 #include "foundation/platform/_endoiioheaders.h"
 
 // Standard headers.
+#include <cstddef>
 #include <string>
 
 using namespace foundation;
@@ -122,12 +129,21 @@ RendererComponents::RendererComponents(
 
 bool RendererComponents::create()
 {
+    APPLESEED_TRACE_SCOPE("setup", "create renderer components");
+
     if (!create_shading_result_framebuffer_factory())
         return false;
 
     if (!create_lighting_engine_factory())
         return false;
 
+    // Attribute rendering time to shader groups and object instances if requested,
+    // or if a shading cost AOV needs it.
+    if (m_params.get_optional<bool>("profile_shading", false) ||
+        m_frame.aovs().get_index("shading_cost") != ~size_t(0) ||
+        m_frame.aovs().get_index("object_shading_cost") != ~size_t(0))
+        m_shading_profiler.reset(new ShadingProfiler());
+
     if (!create_sample_renderer_factory())
         return false;
 
@@ -169,9 +185,21 @@ bool RendererComponents::on_frame_begin(
     if (!m_shading_engine.on_frame_begin(m_project, recorder, abort_switch))
         return false;
 
+    if (m_shading_profiler)
+        m_shading_profiler->clear();
+
     return true;
 }
 
+void RendererComponents::update_light_samplers()
+{
+    if (m_forward_light_sampler)
+        m_forward_light_sampler->update_non_physical_light_importances();
+
+    if (m_backward_light_sampler)
+        m_backward_light_sampler->update_light_importances();
+}
+
 bool RendererComponents::create_lighting_engine_factory()
 {
     const std::string name = m_params.get_required<std::string>("lighting_engine", "pt");
@@ -276,9 +304,32 @@ bool RendererComponents::create_sample_renderer_factory()
                 m_shading_engine,
                 m_oiio_texture_system,
                 m_osl_shading_system,
+                m_shading_profiler.get(),
                 get_child_and_inherit_globals(m_params, "generic_sample_renderer")));
         return true;
     }
+    else if (name == "wavefront")
+    {
+        // Paths can only be staged with the path tracing lighting engine.
+        const bool is_path_tracer =
+            m_params.get_required<std::string>("lighting_engine", "pt") == "pt";
+
+        m_sample_renderer_factory.reset(
+            new WavefrontSampleRendererFactory(
+                m_scene,
+                m_frame,
+                m_trace_context,
+                m_texture_store,
+                m_lighting_engine_factory.get(),
+                is_path_tracer ? m_backward_light_sampler.get() : nullptr,
+                m_shading_engine,
+                m_oiio_texture_system,
+                m_osl_shading_system,
+                m_shading_profiler.get(),
+                get_child_and_inherit_globals(m_params, "wavefront_sample_renderer"),
+                get_child_and_inherit_globals(m_params, "pt")));
+        return true;
+    }
     else if (name == "blank")
     {
         m_sample_renderer_factory.reset(new BlankSampleRendererFactory());
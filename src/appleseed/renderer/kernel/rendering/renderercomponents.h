@@ -40,6 +40,7 @@
 #include "renderer/kernel/rendering/ishadingresultframebufferfactory.h"
 #include "renderer/kernel/rendering/itilerenderer.h"
 #include "renderer/kernel/shading/shadingengine.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 
 // appleseed.foundation headers.
 #include "foundation/memory/autoreleaseptr.h"
@@ -98,6 +99,9 @@ class RendererComponents
         OnFrameBeginRecorder&       recorder,
         foundation::IAbortSwitch*   abort_switch = nullptr);
 
+    // Update light samplers after non-physical lights were modified in place.
+    void update_light_samplers();
+
     // Retrieve individual components.
     const TraceContext& get_trace_context() const;
     BackwardLightSampler* get_backward_light_sampler() const;
@@ -105,6 +109,7 @@ class RendererComponents
     TextureStore& get_texture_store() const;
     OIIOTextureSystem& get_oiio_texture_system();
     OSLShadingSystem& get_osl_shading_system();
+    ShadingProfiler* get_shading_profiler() const;
     IShadingResultFrameBufferFactory& get_shading_result_framebuffer_factory() const;
     IFrameRenderer& get_frame_renderer() const;
 
@@ -121,6 +126,7 @@ class RendererComponents
     TextureStore&                                       m_texture_store;
     OIIOTextureSystem&                                  m_oiio_texture_system;
     OSLShadingSystem&                                   m_osl_shading_system;
+    std::unique_ptr<ShadingProfiler>                    m_shading_profiler;
 
     std::unique_ptr<IShadingResultFrameBufferFactory>   m_shading_result_framebuffer_factory;
     std::unique_ptr<ILightingEngineFactory>             m_lighting_engine_factory;
@@ -175,6 +181,11 @@ inline OSLShadingSystem& RendererComponents::get_osl_shading_system()
     return m_osl_shading_system;
 }
 
+inline ShadingProfiler* RendererComponents::get_shading_profiler() const
+{
+    return m_shading_profiler.get();
+}
+
 inline IFrameRenderer& RendererComponents::get_frame_renderer() const
 {
     return *m_frame_renderer.get();
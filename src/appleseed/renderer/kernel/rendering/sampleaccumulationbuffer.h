@@ -29,6 +29,9 @@
 
 #pragma once
 
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/dirtytiletracker.h"
+
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/platform/atomic.h"
@@ -36,6 +39,7 @@
 // Standard headers.
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
@@ -64,13 +68,27 @@ class SampleAccumulationBuffer
         const Sample                samples[],
         foundation::IAbortSwitch&   abort_switch) = 0;
 
-    // Develop the buffer to a frame. Thread-safe.
+    // Develop the buffer to a frame. Only tiles that changed since the
+    // last call need to be developed. Thread-safe.
     virtual void develop_to_frame(
         Frame&                      frame,
         foundation::IAbortSwitch&   abort_switch) = 0;
 
+    // Append the indices (tile_y * tile_count_x + tile_x) of the tiles developed
+    // since the last call to this method. Initially, all tiles are reported. Thread-safe.
+    void collect_updated_tiles(std::vector<size_t>& tile_indices);
+
   protected:
-    boost::atomic<std::uint64_t> m_sample_count;
+    boost::atomic<std::uint64_t>    m_sample_count;
+    DirtyTileTracker                m_dirty_tiles;      // tiles that changed since they were last developed
+    DirtyTileTracker                m_updated_tiles;    // tiles developed since they were last collected
+
+    // Constructor.
+    SampleAccumulationBuffer(
+        const size_t                canvas_width,
+        const size_t                canvas_height,
+        const size_t                tile_width,
+        const size_t                tile_height);
 };
 
 
@@ -78,9 +96,25 @@ class SampleAccumulationBuffer
 // SampleAccumulationBuffer class implementation.
 //
 
+inline SampleAccumulationBuffer::SampleAccumulationBuffer(
+    const size_t                    canvas_width,
+    const size_t                    canvas_height,
+    const size_t                    tile_width,
+    const size_t                    tile_height)
+  : m_sample_count(0)
+  , m_dirty_tiles(canvas_width, canvas_height, tile_width, tile_height)
+  , m_updated_tiles(canvas_width, canvas_height, tile_width, tile_height)
+{
+}
+
 inline std::uint64_t SampleAccumulationBuffer::get_sample_count() const
 {
     return m_sample_count;
 }
 
+inline void SampleAccumulationBuffer::collect_updated_tiles(std::vector<size_t>& tile_indices)
+{
+    m_updated_tiles.collect(tile_indices);
+}
+
 }   // namespace renderer
@@ -0,0 +1,282 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "scenechangetracker.h"
+
+// appleseed.renderer headers.
+#include "renderer/modeling/aov/aov.h"
+#include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/bssrdf/bssrdf.h"
+#include "renderer/modeling/camera/camera.h"
+#include "renderer/modeling/color/colorentity.h"
+#include "renderer/modeling/edf/edf.h"
+#include "renderer/modeling/entity/entity.h"
+#include "renderer/modeling/environment/environment.h"
+#include "renderer/modeling/environmentedf/environmentedf.h"
+#include "renderer/modeling/environmentshader/environmentshader.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/light/light.h"
+#include "renderer/modeling/material/material.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/basegroup.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/scene/textureinstance.h"
+#include "renderer/modeling/shadergroup/shadergroup.h"
+#include "renderer/modeling/surfaceshader/surfaceshader.h"
+#include "renderer/modeling/texture/texture.h"
+#include "renderer/modeling/volume/volume.h"
+
+// Standard headers.
+#include <cassert>
+
+using namespace foundation;
+
+namespace renderer
+{
+
+namespace
+{
+    typedef std::vector<std::pair<UniqueID, VersionID>> EntityStateVector;
+
+    void record(EntityStateVector& states, const Entity& entity)
+    {
+        states.emplace_back(entity.get_uid(), entity.get_version_id());
+    }
+
+    template <typename EntityContainer>
+    void record_all(EntityStateVector& states, const EntityContainer& entities)
+    {
+        for (const auto& entity : entities)
+            record(states, entity);
+    }
+
+    void record_assembly(EntityStateVector* states, const Assembly& assembly);
+
+    void record_base_group(EntityStateVector* states, const BaseGroup& base_group)
+    {
+        record_all(states[SceneChangeTracker::Textures], base_group.colors());
+        record_all(states[SceneChangeTracker::Textures], base_group.textures());
+        record_all(states[SceneChangeTracker::Textures], base_group.texture_instances());
+        record_all(states[SceneChangeTracker::ShaderGroups], base_group.shader_groups());
+        record_all(states[SceneChangeTracker::Geometry], base_group.assembly_instances());
+
+        for (const Assembly& assembly : base_group.assemblies())
+            record_assembly(states, assembly);
+    }
+
+    void record_assembly(EntityStateVector* states, const Assembly& assembly)
+    {
+        record(states[SceneChangeTracker::Geometry], assembly);
+
+        record_base_group(states, assembly);
+
+        record_all(states[SceneChangeTracker::Materials], assembly.bsdfs());
+        record_all(states[SceneChangeTracker::Materials], assembly.bssrdfs());
+        record_all(states[SceneChangeTracker::Materials], assembly.edfs());
+        record_all(states[SceneChangeTracker::Materials], assembly.surface_shaders());
+        record_all(states[SceneChangeTracker::Materials], assembly.materials());
+        record_all(states[SceneChangeTracker::Lights], assembly.lights());
+        record_all(states[SceneChangeTracker::Geometry], assembly.objects());
+        record_all(states[SceneChangeTracker::Geometry], assembly.object_instances());
+        record_all(states[SceneChangeTracker::Geometry], assembly.volumes());
+    }
+
+    void collect_shader_groups(std::vector<ShaderGroup*>& shader_groups, const BaseGroup& base_group)
+    {
+        for (ShaderGroup& shader_group : base_group.shader_groups())
+            shader_groups.push_back(&shader_group);
+
+        for (const Assembly& assembly : base_group.assemblies())
+            collect_shader_groups(shader_groups, assembly);
+    }
+
+    SceneChangeTracker::Change compare(
+        const EntityStateVector&    previous,
+        const EntityStateVector&    current,
+        std::vector<size_t>*        modified_indices = nullptr)
+    {
+        if (previous.size() != current.size())
+            return SceneChangeTracker::Restructured;
+
+        SceneChangeTracker::Change change = SceneChangeTracker::Unchanged;
+
+        for (size_t i = 0, e = current.size(); i < e; ++i)
+        {
+            if (previous[i].first != current[i].first)
+                return SceneChangeTracker::Restructured;
+
+            if (previous[i].second != current[i].second)
+            {
+                change = SceneChangeTracker::Modified;
+
+                if (modified_indices != nullptr)
+                    modified_indices->push_back(i);
+            }
+        }
+
+        return change;
+    }
+}
+
+SceneChangeTracker::SceneChangeTracker()
+{
+    clear();
+}
+
+void SceneChangeTracker::update(const Project& project, const ParamArray& params)
+{
+    // Record the current state of the project.
+    EntityStateVector states[CategoryCount];
+
+    if (const renderer::Frame* frame = project.get_frame())
+    {
+        record(states[Frame], *frame);
+        record_all(states[Frame], frame->aovs());
+    }
+
+    std::vector<ShaderGroup*> shader_groups;
+
+    if (const Scene* scene = project.get_scene())
+    {
+        record(states[Geometry], *scene);
+        record_all(states[Cameras], scene->cameras());
+
+        if (const renderer::Environment* environment = scene->get_environment())
+            record(states[Environment], *environment);
+        record_all(states[Environment], scene->environment_edfs());
+        record_all(states[Environment], scene->environment_shaders());
+
+        record_base_group(states, *scene);
+        collect_shader_groups(shader_groups, *scene);
+    }
+
+    assert(shader_groups.size() == states[ShaderGroups].size());
+
+    // Compare it with the previously recorded state.
+    m_modified_shader_groups.clear();
+
+    if (m_initialized)
+    {
+        m_changes[Settings] = params == m_params ? Unchanged : Modified;
+
+        for (size_t i = Frame; i < CategoryCount; ++i)
+        {
+            if (i == ShaderGroups)
+            {
+                std::vector<size_t> modified_indices;
+                m_changes[i] = compare(m_states[i], states[i], &modified_indices);
+
+                if (m_changes[i] == Modified)
+                {
+                    for (const size_t index : modified_indices)
+                        m_modified_shader_groups.push_back(shader_groups[index]);
+                }
+            }
+            else m_changes[i] = compare(m_states[i], states[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < CategoryCount; ++i)
+            m_changes[i] = Restructured;
+    }
+
+    m_initialized = true;
+    m_params = params;
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+        m_states[i].swap(states[i]);
+}
+
+void SceneChangeTracker::clear()
+{
+    m_initialized = false;
+    m_params.clear();
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+    {
+        m_states[i].clear();
+        m_changes[i] = Restructured;
+    }
+
+    m_modified_shader_groups.clear();
+}
+
+bool SceneChangeTracker::has_changes() const
+{
+    for (size_t i = 0; i < CategoryCount; ++i)
+    {
+        if (m_changes[i] != Unchanged)
+            return true;
+    }
+
+    return false;
+}
+
+std::string SceneChangeTracker::to_string() const
+{
+    std::string result;
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+    {
+        if (m_changes[i] == Unchanged)
+            continue;
+
+        if (!result.empty())
+            result += ", ";
+
+        result += get_category_name(static_cast<Category>(i));
+        result += m_changes[i] == Modified ? " (modified)" : " (restructured)";
+    }
+
+    return result.empty() ? "none" : result;
+}
+
+const char* SceneChangeTracker::get_category_name(const Category category)
+{
+    switch (category)
+    {
+      case Settings:        return "settings";
+      case Frame:           return "frame";
+      case Cameras:         return "cameras";
+      case Environment:     return "environment";
+      case Geometry:        return "geometry";
+      case Lights:          return "lights";
+      case Materials:       return "materials";
+      case ShaderGroups:    return "shader groups";
+      case Textures:        return "textures";
+      default:              return "unknown";
+    }
+}
+
+}   // namespace renderer
@@ -0,0 +1,133 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.renderer headers.
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/utility/uid.h"
+#include "foundation/utility/version.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class Project; }
+namespace renderer  { class ShaderGroup; }
+
+namespace renderer
+{
+
+//
+// The scene change tracker records the unique ID and version ID of every entity that
+// affects rendering, grouped in categories, and reports which categories changed since
+// the previous update. It allows the render device to only rebuild the subsystems that
+// are affected by an edit when rendering is reinitialized.
+//
+
+class SceneChangeTracker
+  : public foundation::NonCopyable
+{
+  public:
+    enum Category
+    {
+        Settings,               // rendering parameters
+        Frame,                  // frame and AOVs
+        Cameras,
+        Environment,            // environment, environment EDFs and environment shaders
+        Geometry,               // assemblies, objects, volumes and their instances
+        Lights,                 // non-physical lights
+        Materials,              // materials, BSDFs, BSSRDFs, EDFs and surface shaders
+        ShaderGroups,
+        Textures,               // colors, textures and texture instances
+        CategoryCount
+    };
+
+    enum Change
+    {
+        Unchanged,              // no entity of this category changed
+        Modified,               // some entities were modified in place (their version IDs changed)
+        Restructured            // entities were added, removed or replaced
+    };
+
+    // Constructor.
+    SceneChangeTracker();
+
+    // Record the current state of the project and compare it with the state recorded
+    // by the previous call. Everything is reported as restructured on the first call.
+    void update(const Project& project, const ParamArray& params);
+
+    // Forget the recorded state; the next update will report everything as restructured.
+    void clear();
+
+    // Return how a given category changed during the last update.
+    Change get_change(const Category category) const;
+
+    // Return true if any category changed during the last update.
+    bool has_changes() const;
+
+    // Return the shader groups that were modified in place during the last update.
+    const std::vector<ShaderGroup*>& get_modified_shader_groups() const;
+
+    // Return a human-readable description of the changes of the last update.
+    std::string to_string() const;
+
+    // Return the name of a given category.
+    static const char* get_category_name(const Category category);
+
+  private:
+    typedef std::vector<std::pair<foundation::UniqueID, foundation::VersionID>> EntityStateVector;
+
+    bool                        m_initialized;
+    ParamArray                  m_params;
+    EntityStateVector           m_states[CategoryCount];
+    Change                      m_changes[CategoryCount];
+    std::vector<ShaderGroup*>   m_modified_shader_groups;
+};
+
+
+//
+// SceneChangeTracker class implementation.
+//
+
+inline SceneChangeTracker::Change SceneChangeTracker::get_change(const Category category) const
+{
+    return m_changes[category];
+}
+
+inline const std::vector<ShaderGroup*>& SceneChangeTracker::get_modified_shader_groups() const
+{
+    return m_modified_shader_groups;
+}
+
+}   // namespace renderer
@@ -36,6 +36,9 @@
 // appleseed.foundation headers.
 #include "foundation/utility/otherwise.h"
 
+// Standard headers.
+#include <utility>
+
 namespace renderer
 {
 
@@ -179,6 +182,28 @@ void SerialRendererController::add_on_progressive_frame_update_callback(
     m_pending_callbacks.push_back(callback);
 }
 
+void SerialRendererController::add_on_progressive_frame_tiles_update_callback(
+    const Frame&            frame,
+    const double            time,
+    const std::uint64_t     samples,
+    const double            samples_per_pixel,
+    const std::uint64_t     samples_per_second,
+    const size_t            tile_count,
+    const size_t*           tile_indices)
+{
+    PendingTileCallback callback = {};
+    callback.m_type = PendingTileCallback::OnProgressiveFrameTilesUpdate;
+    callback.m_frame = &frame;
+    callback.m_time = time;
+    callback.m_samples = samples;
+    callback.m_samples_per_pixel = samples_per_pixel;
+    callback.m_samples_per_second = samples_per_second;
+    callback.m_tile_indices.assign(tile_indices, tile_indices + tile_count);
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_pending_callbacks.push_back(std::move(callback));
+}
+
 void SerialRendererController::exec_callbacks()
 {
     boost::mutex::scoped_lock lock(m_mutex);
@@ -219,6 +244,17 @@ void SerialRendererController::exec_callback(const PendingTileCallback& cb)
             cb.m_samples_per_second);
         break;
 
+      case PendingTileCallback::OnProgressiveFrameTilesUpdate:
+        m_tile_callback->on_progressive_frame_tiles_update(
+            *cb.m_frame,
+            cb.m_time,
+            cb.m_samples,
+            cb.m_samples_per_pixel,
+            cb.m_samples_per_second,
+            cb.m_tile_indices.size(),
+            cb.m_tile_indices.data());
+        break;
+
       assert_otherwise;
     }
 }
@@ -39,6 +39,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <deque>
+#include <vector>
 
 // Forward declarations.
 namespace renderer  { class Frame; }
@@ -97,6 +98,15 @@ class SerialRendererController
         const double            samples_per_pixel,
         const std::uint64_t     samples_per_second);
 
+    void add_on_progressive_frame_tiles_update_callback(
+        const Frame&            frame,
+        const double            time,
+        const std::uint64_t     samples,
+        const double            samples_per_pixel,
+        const std::uint64_t     samples_per_second,
+        const size_t            tile_count,
+        const size_t*           tile_indices);
+
     void exec_callbacks();
 
   private:
@@ -108,19 +118,21 @@ class SerialRendererController
             OnTiledFrameEnd,
             OnTileBegin,
             OnTileEnd,
-            OnProgressiveFrameUpdate
+            OnProgressiveFrameUpdate,
+            OnProgressiveFrameTilesUpdate
         };
 
-        CallbackType    m_type;
-        const Frame*    m_frame;
-        size_t          m_tile_x;
-        size_t          m_tile_y;
-        double          m_time;
-        std::uint64_t   m_samples;
-        double          m_samples_per_pixel;
-        std::uint64_t   m_samples_per_second;
-        size_t          m_thread_index;
-        size_t          m_thread_count;
+        CallbackType        m_type;
+        const Frame*        m_frame;
+        size_t              m_tile_x;
+        size_t              m_tile_y;
+        double              m_time;
+        std::uint64_t       m_samples;
+        double              m_samples_per_pixel;
+        std::uint64_t       m_samples_per_second;
+        size_t              m_thread_index;
+        size_t              m_thread_count;
+        std::vector<size_t> m_tile_indices;
     };
 
     IRendererController*                m_controller;
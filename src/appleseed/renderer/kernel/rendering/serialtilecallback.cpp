@@ -99,6 +99,25 @@ namespace
                 samples_per_second);
         }
 
+        void on_progressive_frame_tiles_update(
+            const Frame&            frame,
+            const double            time,
+            const std::uint64_t     samples,
+            const double            samples_per_pixel,
+            const std::uint64_t     samples_per_second,
+            const size_t            tile_count,
+            const size_t*           tile_indices) override
+        {
+            m_controller->add_on_progressive_frame_tiles_update_callback(
+                frame,
+                time,
+                samples,
+                samples_per_pixel,
+                samples_per_second,
+                tile_count,
+                tile_indices);
+        }
+
       private:
         SerialRendererController* m_controller;
     };
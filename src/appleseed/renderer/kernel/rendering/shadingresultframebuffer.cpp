@@ -64,12 +64,14 @@ ShadingResultFrameBuffer::ShadingResultFrameBuffer(
     const size_t                    width,
     const size_t                    height,
     const size_t                    aov_count,
-    const AABB2u&                   crop_window)
+    const AABB2u&                   crop_window,
+    std::uint8_t*                   storage)
   : AccumulatorTile(
         width,
         height,
         get_total_channel_count(aov_count),
-        crop_window)
+        crop_window,
+        storage)
   , m_aov_count(aov_count)
   , m_scratch(get_total_channel_count(aov_count))
 {
@@ -36,6 +36,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 // Forward declarations.
@@ -46,6 +47,25 @@ namespace renderer      { class TileStack; }
 namespace renderer
 {
 
+//
+// A tile accumulating the weighted samples of the main output and of the AOVs.
+//
+// The accumulator holds one float weight, then four float channels for the main output
+// and for each AOV. Only color AOVs go through it: unfiltered AOVs (depth, normals, UVs,
+// positions, etc.) write directly into their own images, whose pixel format is chosen
+// by AOV::get_storage_format(), and cost nothing here.
+//
+// The accumulator itself stays in full precision:
+//
+//   - Sums of samples can't be stored in half floats or 16-bit integers: with an 11-bit
+//     significand, adding a sample of 1 to a sum of 2048 is lost, so long renders would
+//     be biased toward darker values.
+//
+//   - Color AOVs can't drop their alpha channel in favor of the alpha of the main output:
+//     the NPR contour AOV has its own alpha, and AOVs are left transparent in samples
+//     where they are not written (e.g. surfaces without a surface shader).
+//
+
 class ShadingResultFrameBuffer
   : public foundation::AccumulatorTile
 {
@@ -59,7 +79,14 @@ class ShadingResultFrameBuffer
         const size_t                    width,
         const size_t                    height,
         const size_t                    aov_count,
-        const foundation::AABB2u&       crop_window);
+        const foundation::AABB2u&       crop_window,
+        std::uint8_t*                   storage = nullptr);     // if provided, use this memory for pixel storage
+
+    // Return the size in bytes of the pixel storage of a frame buffer.
+    static size_t get_storage_size(
+        const size_t                    width,
+        const size_t                    height,
+        const size_t                    aov_count);
 
     static size_t get_total_channel_count(const size_t aov_count);
 
@@ -90,4 +117,13 @@ inline size_t ShadingResultFrameBuffer::get_total_channel_count(const size_t aov
     return (1 + aov_count) * 4;
 }
 
+inline size_t ShadingResultFrameBuffer::get_storage_size(
+    const size_t                        width,
+    const size_t                        height,
+    const size_t                        aov_count)
+{
+    // One weight channel followed by all other channels.
+    return width * height * (get_total_channel_count(aov_count) + 1) * sizeof(float);
+}
+
 }   // namespace renderer
@@ -0,0 +1,424 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "streamingexrtilecallback.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/kernel/rendering/tilecallbackbase.h"
+#include "renderer/modeling/aov/aov.h"
+#include "renderer/modeling/aov/aovcontainer.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/filesystem.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/platform/thread.h"
+
+// OpenImageIO headers.
+#include "foundation/platform/_beginoiioheaders.h"
+#include "OpenImageIO/imageio.h"
+#include "OpenImageIO/version.h"
+#include "foundation/platform/_endoiioheaders.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+
+namespace renderer
+{
+
+namespace
+{
+    //
+    // Writer shared by all the tile callbacks of a factory.
+    //
+    // All layers (the main image followed by the AOVs) are stored as channels of a single
+    // tiled part: OpenImageIO requires the parts of a multipart file to be written one
+    // after the other, which would prevent writing tiles in the order they are finished.
+    //
+
+    class StreamingEXRWriter
+      : public NonCopyable
+    {
+      public:
+        explicit StreamingEXRWriter(const char* file_path)
+          : m_file_path(file_path)
+          , m_state(State::Closed)
+          , m_channel_count(0)
+        {
+        }
+
+        ~StreamingEXRWriter()
+        {
+            close();
+        }
+
+        void write_tile(
+            const Frame&                frame,
+            const size_t                tile_x,
+            const size_t                tile_y,
+            std::vector<float>&         buffer)
+        {
+            if (!open(frame))
+                return;
+
+            // Interleave the channels of all layers into the buffer, outside of the lock.
+            const Tile& main_tile = frame.image().tile(tile_x, tile_y);
+            const size_t tile_width = main_tile.get_width();
+            const size_t tile_height = main_tile.get_height();
+            const size_t pixel_count = tile_width * tile_height;
+            buffer.resize(pixel_count * m_channel_count);
+
+            size_t layer_offset = 0;
+            for (const Image* image : m_layers)
+            {
+                const Tile& tile = image->tile(tile_x, tile_y);
+                assert(tile.get_width() == tile_width);
+                assert(tile.get_height() == tile_height);
+
+                const PixelFormat format = tile.get_pixel_format();
+                const size_t channel_count = tile.get_channel_count();
+                const size_t pixel_size = channel_count * Pixel::size(format);
+                const std::uint8_t* src = tile.get_storage();
+                float* dest = &buffer[layer_offset];
+
+                if (format == PixelFormatFloat)
+                {
+                    for (size_t i = 0; i < pixel_count; ++i)
+                    {
+                        std::memcpy(dest, src, pixel_size);
+                        src += pixel_size;
+                        dest += m_channel_count;
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < pixel_count; ++i)
+                    {
+                        Pixel::convert_from_format(format, src, src + pixel_size, 1, dest, 1);
+                        src += pixel_size;
+                        dest += m_channel_count;
+                    }
+                }
+
+                layer_offset += channel_count;
+            }
+
+            // Compute the position of the tile and the strides of the buffer.
+            const CanvasProperties& props = frame.image().properties();
+            const size_t xstride = m_channel_count * sizeof(float);
+            const size_t ystride = tile_width * xstride;
+
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (m_state != State::Open)
+                return;
+
+            if (!m_output->write_tile(
+                    static_cast<int>(tile_x * props.m_tile_width),
+                    static_cast<int>(tile_y * props.m_tile_height),
+                    0,
+                    OIIO::TypeDesc::FLOAT,
+                    buffer.data(),
+                    xstride,
+                    ystride))
+                fail();
+        }
+
+        void close()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (m_state != State::Open)
+                return;
+
+            if (m_output->close())
+            {
+                RENDERER_LOG_INFO("wrote streamed exr image file %s.", m_file_path.c_str());
+                m_state = State::Closed;
+            }
+            else fail();
+
+            m_output.reset();
+        }
+
+      private:
+        enum class State { Closed, Open, Failed };
+
+        const std::string               m_file_path;
+        boost::mutex                    m_mutex;
+        State                           m_state;
+        std::unique_ptr<OIIO::ImageOutput, void(*)(OIIO::ImageOutput*)>
+                                        m_output{nullptr, &destroy_output};
+        std::vector<const Image*>       m_layers;
+        size_t                          m_channel_count;
+
+        static void destroy_output(OIIO::ImageOutput* output)
+        {
+#if OIIO_VERSION >= 20000
+            delete output;
+#else
+            OIIO::ImageOutput::destroy(output);
+#endif
+        }
+
+        // Open the file on the first finished tile. Return false if the file cannot be written.
+        bool open(const Frame& frame)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (m_state == State::Open)
+                return true;
+
+            if (m_state == State::Failed || m_output)
+                return false;
+
+            const CanvasProperties& props = frame.image().properties();
+
+            OIIO::ImageSpec spec(
+                static_cast<int>(props.m_canvas_width),
+                static_cast<int>(props.m_canvas_height),
+                0,
+                OIIO::TypeDesc::HALF);
+            spec.tile_width = static_cast<int>(props.m_tile_width);
+            spec.tile_height = static_cast<int>(props.m_tile_height);
+
+            // Main image.
+            m_layers.push_back(&frame.image());
+            add_channels(spec, nullptr, props.m_channel_count, nullptr, true);
+            spec.alpha_channel = 3;
+
+            // AOVs. Each AOV is written at the precision of its image.
+            for (const AOV& aov : frame.aovs())
+            {
+                m_layers.push_back(&aov.get_image());
+                add_channels(
+                    spec,
+                    aov.get_name(),
+                    aov.get_channel_count(),
+                    aov.get_channel_names(),
+                    aov.get_storage_format() == PixelFormatHalf);
+            }
+
+            m_channel_count = static_cast<size_t>(spec.nchannels);
+
+            // Write tiles as soon as they are received instead of buffering them
+            // until the tiles that precede them in scanline order are available.
+            spec.attribute("openexr:lineOrder", "randomY");
+            spec.attribute("oiio:ColorSpace", "Linear");
+
+            create_parent_directories(m_file_path.c_str());
+
+#if OIIO_VERSION >= 20000
+            m_output.reset(OIIO::ImageOutput::create(m_file_path).release());
+#else
+            m_output.reset(OIIO::ImageOutput::create(m_file_path));
+#endif
+
+            if (!m_output)
+            {
+                RENDERER_LOG_ERROR(
+                    "failed to create streamed exr image file %s: %s",
+                    m_file_path.c_str(),
+                    OIIO::geterror().c_str());
+                m_state = State::Failed;
+                return false;
+            }
+
+            if (!m_output->supports("tiles") || !m_output->supports("channelformats"))
+            {
+                RENDERER_LOG_ERROR(
+                    "cannot stream tiles to %s: file format does not support tiles with per-channel formats.",
+                    m_file_path.c_str());
+                m_state = State::Failed;
+                m_output.reset();
+                return false;
+            }
+
+            if (!m_output->open(m_file_path, spec))
+            {
+                fail();
+                m_output.reset();
+                return false;
+            }
+
+            RENDERER_LOG_INFO("streaming tiles to exr image file %s...", m_file_path.c_str());
+
+            m_state = State::Open;
+            return true;
+        }
+
+        static void add_channels(
+            OIIO::ImageSpec&            spec,
+            const char*                 layer_name,
+            const size_t                channel_count,
+            const char**                channel_names,
+            const bool                  half_precision)
+        {
+            static const char* DefaultChannelNames[] = { "R", "G", "B", "A" };
+
+            if (channel_names == nullptr)
+            {
+                assert(channel_count <= 4);
+                channel_names = DefaultChannelNames;
+            }
+
+            for (size_t i = 0; i < channel_count; ++i)
+            {
+                spec.channelnames.push_back(
+                    layer_name != nullptr
+                        ? std::string(layer_name) + "." + channel_names[i]
+                        : std::string(channel_names[i]));
+                spec.channelformats.push_back(
+                    half_precision ? OIIO::TypeDesc::HALF : OIIO::TypeDesc::FLOAT);
+            }
+
+            spec.nchannels += static_cast<int>(channel_count);
+        }
+
+        // Must be called with the mutex locked.
+        void fail()
+        {
+            RENDERER_LOG_ERROR(
+                "failed to write streamed exr image file %s: %s",
+                m_file_path.c_str(),
+                m_output->geterror().c_str());
+
+            m_state = State::Failed;
+        }
+    };
+
+
+    //
+    // Tile callback writing tiles of the last pass to the shared writer.
+    //
+
+    class StreamingEXRTileCallback
+      : public TileCallbackBase
+    {
+      public:
+        StreamingEXRTileCallback(
+            StreamingEXRWriter&         writer,
+            const size_t                pass_count)
+          : m_writer(writer)
+          , m_pass_count(pass_count)
+          , m_pass(0)
+        {
+        }
+
+        void release() override
+        {
+            delete this;
+        }
+
+        void on_tiled_frame_end(const Frame* frame) override
+        {
+            // Tiled frame renderers call on_tiled_frame_end() once all tiles of the
+            // pass are finished: once the last pass is done, the file is complete.
+            if (is_last_pass())
+                m_writer.close();
+
+            ++m_pass;
+        }
+
+        void on_tile_end(
+            const Frame*                frame,
+            const size_t                tile_x,
+            const size_t                tile_y) override
+        {
+            if (is_last_pass())
+                m_writer.write_tile(*frame, tile_x, tile_y, m_buffer);
+        }
+
+      private:
+        StreamingEXRWriter&             m_writer;
+        const size_t                    m_pass_count;
+        size_t                          m_pass;
+        std::vector<float>              m_buffer;
+
+        bool is_last_pass() const
+        {
+            return m_pass + 1 >= m_pass_count;
+        }
+    };
+}
+
+
+//
+// StreamingEXRTileCallbackFactory class implementation.
+//
+
+struct StreamingEXRTileCallbackFactory::Impl
+{
+    StreamingEXRWriter  m_writer;
+    const size_t        m_pass_count;
+
+    Impl(
+        const char*     file_path,
+        const size_t    pass_count)
+      : m_writer(file_path)
+      , m_pass_count(pass_count)
+    {
+    }
+};
+
+StreamingEXRTileCallbackFactory::StreamingEXRTileCallbackFactory(
+    const char*         file_path,
+    const size_t        pass_count)
+  : impl(new Impl(file_path, pass_count))
+{
+    assert(file_path);
+}
+
+StreamingEXRTileCallbackFactory::~StreamingEXRTileCallbackFactory()
+{
+    delete impl;
+}
+
+void StreamingEXRTileCallbackFactory::release()
+{
+    delete this;
+}
+
+ITileCallback* StreamingEXRTileCallbackFactory::create()
+{
+    return new StreamingEXRTileCallback(impl->m_writer, impl->m_pass_count);
+}
+
+}   // namespace renderer
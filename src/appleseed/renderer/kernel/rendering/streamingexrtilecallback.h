@@ -0,0 +1,76 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/itilecallback.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// A tile callback factory whose tile callbacks write tiles of the frame and of its AOVs
+// to a single tiled, multi-layer OpenEXR file as soon as they are finished, instead of
+// writing the whole frame once rendering is complete.
+//
+// Tiles are written in random order, without buffering, so that a file left behind by
+// an interrupted render contains all the tiles that were finished until then.
+//
+// Only tiles of the last pass are written. Post-processing stages are not applied.
+//
+
+class APPLESEED_DLLSYMBOL StreamingEXRTileCallbackFactory
+  : public ITileCallbackFactory
+{
+  public:
+    // Constructor.
+    StreamingEXRTileCallbackFactory(
+        const char*     file_path,
+        const size_t    pass_count);
+
+    // Destructor.
+    ~StreamingEXRTileCallbackFactory();
+
+    // Delete this instance.
+    void release() override;
+
+    // Return a new instance.
+    ITileCallback* create() override;
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}   // namespace renderer
@@ -107,6 +107,28 @@ namespace
             }
         }
 
+        void on_progressive_frame_tiles_update(
+            const Frame&            frame,
+            const double            time,
+            const std::uint64_t     samples,
+            const double            samples_per_pixel,
+            const std::uint64_t     samples_per_second,
+            const size_t            tile_count,
+            const size_t*           tile_indices) override
+        {
+            for (ITileCallback* callback : m_callbacks)
+            {
+                callback->on_progressive_frame_tiles_update(
+                    frame,
+                    time,
+                    samples,
+                    samples_per_pixel,
+                    samples_per_second,
+                    tile_count,
+                    tile_indices);
+            }
+        }
+
       private:
         std::list<ITileCallback*> m_callbacks;
     };
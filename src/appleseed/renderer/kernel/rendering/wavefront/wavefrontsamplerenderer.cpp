@@ -0,0 +1,1778 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "wavefrontsamplerenderer.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/aov/aovaccumulator.h"
+#include "renderer/kernel/aov/aovcomponents.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/lighting/backwardlightsampler.h"
+#include "renderer/kernel/lighting/directlightingintegrator.h"
+#include "renderer/kernel/lighting/ilightingengine.h"
+#include "renderer/kernel/lighting/imagebasedlighting.h"
+#include "renderer/kernel/lighting/materialsamplers.h"
+#include "renderer/kernel/lighting/pathvertex.h"
+#include "renderer/kernel/lighting/pt/ptparameters.h"
+#include "renderer/kernel/lighting/scatteringmode.h"
+#include "renderer/kernel/lighting/shadowrayqueue.h"
+#include "renderer/kernel/lighting/tracer.h"
+#include "renderer/kernel/rendering/pixelcontext.h"
+#include "renderer/kernel/shading/directshadingcomponents.h"
+#include "renderer/kernel/shading/oslshadergroupexec.h"
+#include "renderer/kernel/shading/oslshadingsystem.h"
+#include "renderer/kernel/shading/shadingcomponents.h"
+#include "renderer/kernel/shading/shadingcontext.h"
+#include "renderer/kernel/shading/shadingengine.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/shading/shadingresult.h"
+#include "renderer/kernel/texturing/oiiotexturesystem.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/bsdf/bsdfsample.h"
+#include "renderer/modeling/camera/camera.h"
+#include "renderer/modeling/color/colorspace.h"
+#include "renderer/modeling/edf/edf.h"
+#include "renderer/modeling/environment/environment.h"
+#include "renderer/modeling/environmentedf/environmentedf.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/material/material.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/basegroup.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/shadergroup/shadergroup.h"
+#include "renderer/modeling/surfaceshader/surfaceshader.h"
+#include "renderer/utility/spectrumclamp.h"
+#include "renderer/utility/stochasticcast.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/math/basis.h"
+#include "foundation/math/dual.h"
+#include "foundation/math/mis.h"
+#include "foundation/math/population.h"
+#include "foundation/math/raysorting.h"
+#include "foundation/math/rr.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/memory/arena.h"
+#include "foundation/string/string.h"
+#include "foundation/utility/statistics.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace foundation;
+
+namespace renderer
+{
+
+namespace
+{
+    //
+    // Wavefront sample renderer.
+    //
+    // Batches of samples, usually spanning many pixels, are rendered in stages:
+    //
+    //   1. Camera rays are spawned for all the samples of the batch.
+    //   2. All camera rays are traced.
+    //   3. The paths are extended one bounce at a time until all of them have
+    //      terminated. Each bounce is made of three stages:
+    //        a. A shading stage, where the active paths are sorted by shading key
+    //           (shader group or material) and shaded in that order: emission,
+    //           next event estimation and BSDF sampling. Shadow rays and
+    //           extension rays are generated but not traced.
+    //        b. A shadow stage, where the shadow rays of all paths are traced.
+    //        c. An extension stage, where the extension rays of all paths are traced.
+    //
+    // When ray sorting is enabled, the rays of each tracing stage (camera, shadow and
+    // extension rays) are traced in the order of their sorting keys (direction octant,
+    // then origin cell) so that neighboring rays are traced back to back. Since rays
+    // are traced independently and contributions are accumulated in a fixed order,
+    // ray sorting does not change the rendered image.
+    //
+    // Shading is a port of the path tracing lighting engine with next event estimation
+    // (renderer/kernel/lighting/pt/ptlightingengine.cpp and renderer/kernel/lighting/pathtracer.h)
+    // and consumes the sampling context in the same order. Unlike the path tracer, which clamps
+    // the sum of the contributions of each path vertex when a maximum ray intensity is set, the
+    // shadowed contributions are clamped individually.
+    //
+    // Only the paths that the staged path tracer fully supports are staged; the others are
+    // rendered like in the generic sample renderer, when they are resolved. The following
+    // conditions must be met for paths to be staged:
+    //
+    //   - The lighting engine is the path tracer, with next event estimation and without
+    //     light path recording.
+    //   - No diagnostic surface shader overrides the surface shaders of the scene.
+    //   - No material of the scene has a BSSRDF or a volume.
+    //   - The camera ray hits an opaque surface with a physical surface shader that takes a
+    //     single lighting sample, and the OSL shader group of the material, if any, has no
+    //     transparency, matte or NPR closure.
+    //
+    // Shading results are written to the AOV accumulators when samples are resolved, which
+    // happens once all the samples of the batch have been rendered. Consequently, the pixel
+    // time and shading cost AOVs only measure the time spent resolving samples.
+    //
+
+    class WavefrontSampleRenderer
+      : public ISampleRenderer
+    {
+      public:
+        WavefrontSampleRenderer(
+            const Scene&                    scene,
+            const Frame&                    frame,
+            const TraceContext&             trace_context,
+            TextureStore&                   texture_store,
+            ILightingEngineFactory*         lighting_engine_factory,
+            const BackwardLightSampler*     light_sampler,
+            ShadingEngine&                  shading_engine,
+            OIIOTextureSystem&              oiio_texture_system,
+            OSLShadingSystem&               shading_system,
+            ShadingProfiler*                shading_profiler,
+            const size_t                    thread_index,
+            const ParamArray&               params,
+            const ParamArray&               pt_params)
+          : m_params(params)
+          , m_pt_params(pt_params)
+          , m_scene(scene)
+          , m_light_sampler(light_sampler)
+          , m_env_edf(scene.get_environment()->get_environment_edf())
+          , m_opacity_threshold(1.0f - m_params.m_transparency_threshold)
+          , m_ray_sort_key(AABB3d(scene.get_render_data().m_bbox))
+          , m_texture_cache(texture_store)
+          , m_lighting_engine(lighting_engine_factory->create())
+          , m_shading_engine(shading_engine)
+          , m_oiio_texture_system(oiio_texture_system)
+          , m_thread_index(thread_index)
+          , m_profiler_counters(
+                shading_profiler != nullptr
+                    ? shading_profiler->create_thread_counters()
+                    : nullptr)
+          , m_shadergroup_exec(shading_system, m_arena)
+          , m_intersector(
+                trace_context,
+                m_texture_cache,
+                m_params.m_report_self_intersections)
+          , m_tracer(
+                m_scene,
+                m_intersector,
+                m_shadergroup_exec,
+                m_params.m_transparency_threshold,
+                m_params.m_max_iterations,
+                thread_index == 0)
+          , m_shading_context(
+                m_intersector,
+                m_tracer,
+                m_texture_cache,
+                m_oiio_texture_system,
+                m_shadergroup_exec,
+                m_arena,
+                m_thread_index,
+                m_lighting_engine,
+                m_params.m_transparency_threshold,
+                m_params.m_max_iterations)
+          , m_staging_enabled(
+                m_params.m_staged_path_tracing &&
+                m_light_sampler != nullptr &&
+                m_pt_params.m_next_event_estimation &&
+                !m_pt_params.m_record_light_paths &&
+                !shading_engine.has_diagnostic_surface_shader())
+          , m_scene_checked(false)
+          , m_path_capacity(0)
+          , m_staged_sample_count(0)
+          , m_fallback_sample_count(0)
+        {
+            // 1/4 of a pixel, like in RenderMan RIS.
+            const CanvasProperties& c = frame.image().properties();
+            m_image_point_dx = Vector2d(1.0 / (2.0 * c.m_canvas_width), 0.0);
+            m_image_point_dy = Vector2d(0.0, -1.0 / (2.0 * c.m_canvas_height));
+        }
+
+        ~WavefrontSampleRenderer() override
+        {
+            m_lighting_engine->release();
+        }
+
+        void release() override
+        {
+            delete this;
+        }
+
+        void print_settings() const override
+        {
+            RENDERER_LOG_INFO(
+                "wavefront sample renderer settings:\n"
+                "  transparency threshold        %f\n"
+                "  max iterations                %s\n"
+                "  report self intersections     %s\n"
+                "  ray sorting                   %s\n"
+                "  batch size                    %s\n"
+                "  staged path tracing           %s",
+                m_params.m_transparency_threshold,
+                pretty_uint(m_params.m_max_iterations).c_str(),
+                m_params.m_report_self_intersections ? "on" : "off",
+                m_params.m_ray_sorting ? "on" : "off",
+                pretty_uint(m_params.m_batch_size).c_str(),
+                m_staging_enabled ? "on" : "off");
+
+            m_lighting_engine->print_settings();
+        }
+
+        void render_sample(
+            SamplingContext&            sampling_context,
+            const PixelContext&         pixel_context,
+            const Vector2d&             image_point,
+            AOVAccumulatorContainer&    aov_accumulators,
+            ShadingResult&              shading_result) override
+        {
+            ensure_path_capacity(1);
+
+            spawn_camera_ray(
+                m_paths[0],
+                sampling_context,
+                pixel_context,
+                image_point,
+                shading_result);
+
+            render_paths(1);
+            resolve_path(m_paths[0], aov_accumulators);
+        }
+
+        size_t get_max_batch_size() const override
+        {
+            return m_params.m_batch_size;
+        }
+
+        void render_samples(
+            SampleRequest*              samples,
+            const size_t                sample_count) override
+        {
+            ensure_path_capacity(sample_count);
+
+            // Spawn the camera rays of all samples.
+            for (size_t i = 0; i < sample_count; ++i)
+            {
+                SampleRequest& sample = samples[i];
+                spawn_camera_ray(
+                    m_paths[i],
+                    sample.m_sampling_context,
+                    sample.m_pixel_context,
+                    sample.m_image_point,
+                    sample.m_shading_result);
+            }
+
+            render_paths(sample_count);
+        }
+
+        void resolve_sample(
+            SampleRequest&              sample,
+            const size_t                sample_index,
+            AOVAccumulatorContainer&    aov_accumulators) override
+        {
+            assert(sample_index < m_path_capacity);
+            assert(m_paths[sample_index].m_shading_result == &sample.m_shading_result);
+
+            resolve_path(m_paths[sample_index], aov_accumulators);
+        }
+
+        StatisticsVector get_statistics() const override
+        {
+            Statistics stats;
+            stats.insert("samples per batch", m_batch_size);
+            stats.insert<std::uint64_t>("staged samples", m_staged_sample_count);
+            stats.insert<std::uint64_t>("fallback samples", m_fallback_sample_count);
+            stats.insert("staged path length", m_staged_path_length);
+            stats.insert("shading stages per batch", m_shading_stage_count);
+            stats.insert("shading keys per stage", m_shading_key_count);
+            stats.insert("shadow rays per stage", m_shadow_ray_count);
+
+            StatisticsVector vec;
+            vec.insert("wavefront sample renderer statistics", stats);
+            vec.merge(m_texture_cache.get_statistics());
+            vec.merge(m_intersector.get_statistics());
+            vec.merge(m_lighting_engine->get_statistics());
+
+            return vec;
+        }
+
+      private:
+        struct Parameters
+        {
+            const float     m_transparency_threshold;
+            const size_t    m_max_iterations;
+            const bool      m_report_self_intersections;
+            const bool      m_ray_sorting;
+            const size_t    m_batch_size;                   // maximum number of samples per batch, 0 to render samples one by one
+            const bool      m_staged_path_tracing;
+
+            explicit Parameters(const ParamArray& params)
+              : m_transparency_threshold(params.get_optional<float>("transparency_threshold", 0.001f))
+              , m_max_iterations(params.get_optional<size_t>("max_iterations", 100))
+              , m_report_self_intersections(params.get_optional<bool>("report_self_intersections", false))
+              , m_ray_sorting(params.get_optional<bool>("ray_sorting", false))
+              , m_batch_size(params.get_optional<size_t>("batch_size", 1024))
+              , m_staged_path_tracing(params.get_optional<bool>("staged_path_tracing", true))
+            {
+            }
+        };
+
+        static const size_t NoSlot = ~size_t(0);
+
+        // A sample in flight.
+        struct Path
+        {
+            SamplingContext*        m_sampling_context;
+            const PixelContext*     m_pixel_context;
+            ShadingResult*          m_shading_result;
+
+            bool                    m_staged;                   // is this path rendered by the staged path tracer?
+            bool                    m_active;                   // does this path have an extension ray to trace?
+
+            // Intersections along the path. The first slot holds the intersection of the camera
+            // ray, which is kept until the sample is resolved; the other slots are recycled.
+            ShadingRay              m_ray;                      // next ray to trace
+            ShadingPoint            m_shading_points[4];
+            size_t                  m_current;                  // slot of the current path vertex
+            size_t                  m_parent;                   // slot of the previous scattering vertex, or NoSlot
+            bool                    m_bounce;                   // does the next ray start a new path segment?
+
+            // Path tracing state, see PathTracer::trace().
+            Spectrum                m_throughput;
+            size_t                  m_path_length;
+            int                     m_scattering_modes;
+            ScatteringMode::Mode    m_prev_mode;
+            float                   m_prev_prob;
+            ScatteringMode::Mode    m_aov_mode;
+            size_t                  m_diffuse_bounces;
+            size_t                  m_glossy_bounces;
+            size_t                  m_specular_bounces;
+            size_t                  m_iterations;
+            bool                    m_omit_emitted_light;
+            bool                    m_is_indirect_lighting;
+            Vector3d                m_medium_start;
+
+            // Outputs.
+            ShadingComponents       m_radiance;
+            AOVComponents           m_aov_components;
+        };
+
+        // The path that queued a given shadow ray.
+        struct ShadowRayOwner
+        {
+            size_t                  m_path_index;
+            size_t                  m_path_length;
+            ScatteringMode::Mode    m_aov_mode;
+            bool                    m_clamp;
+        };
+
+        typedef std::pair<std::uint64_t, size_t> RayKey;
+        typedef std::pair<std::uintptr_t, size_t> ShadingKey;
+
+        const Parameters                    m_params;
+        const PTParameters                  m_pt_params;
+        const Scene&                        m_scene;
+        const BackwardLightSampler*         m_light_sampler;
+        const EnvironmentEDF*               m_env_edf;
+        const float                         m_opacity_threshold;
+        const RaySortKeyGenerator<double>   m_ray_sort_key;
+        TextureCache                        m_texture_cache;
+        ILightingEngine*                    m_lighting_engine;
+        ShadingEngine&                      m_shading_engine;
+        OIIOTextureSystem&                  m_oiio_texture_system;
+        const size_t                        m_thread_index;
+        ShadingProfiler::ThreadCounters*    m_profiler_counters;
+
+        Arena                               m_arena;
+        OSLShaderGroupExec                  m_shadergroup_exec;
+        const Intersector                   m_intersector;
+        Tracer                              m_tracer;
+        const ShadingContext                m_shading_context;
+
+        bool                                m_staging_enabled;
+        bool                                m_scene_checked;
+        std::unordered_set<const Material*> m_stageable_materials;
+
+        Vector2d                            m_image_point_dx;
+        Vector2d                            m_image_point_dy;
+
+        std::unique_ptr<Path[]>             m_paths;
+        size_t                              m_path_capacity;
+        std::vector<RayKey>                 m_ray_keys;
+        std::vector<ShadingKey>             m_shading_keys;
+        ShadowRayQueue                      m_shadow_rays;
+        std::vector<ShadowRayOwner>         m_shadow_ray_owners;
+        std::vector<Spectrum>               m_shadow_ray_transmissions;
+
+        Population<std::uint64_t>           m_batch_size;
+        std::uint64_t                       m_staged_sample_count;
+        std::uint64_t                       m_fallback_sample_count;
+        Population<std::uint64_t>           m_staged_path_length;
+        Population<std::uint64_t>           m_shading_stage_count;
+        Population<std::uint64_t>           m_shading_key_count;
+        Population<std::uint64_t>           m_shadow_ray_count;
+
+        void ensure_path_capacity(const size_t path_count)
+        {
+            // Shading points cannot be implicitly copied, and paths don't carry
+            // any state from one batch to the next: simply allocate new ones.
+            if (m_path_capacity < path_count)
+            {
+                m_paths.reset(new Path[path_count]);
+                m_path_capacity = path_count;
+            }
+        }
+
+        void spawn_camera_ray(
+            Path&                       path,
+            SamplingContext&            sampling_context,
+            const PixelContext&         pixel_context,
+            const Vector2d&             image_point,
+            ShadingResult&              shading_result) const
+        {
+            path.m_sampling_context = &sampling_context;
+            path.m_pixel_context = &pixel_context;
+            path.m_shading_result = &shading_result;
+
+            m_scene.get_render_data().m_active_camera->spawn_ray(
+                sampling_context,
+                Dual2d(image_point, m_image_point_dx, m_image_point_dy),
+                path.m_ray);
+        }
+
+        static std::uintptr_t get_shading_key(const ShadingPoint& shading_point)
+        {
+            // Samples that escaped the scene are shaded first.
+            if (!shading_point.hit_surface())
+                return 0;
+
+            const Material* material = shading_point.get_material();
+            if (material == nullptr)
+                return 0;
+
+            // Group OSL materials by shader group since it is what gets executed.
+            const ShaderGroup* shader_group = material->get_render_data().m_shader_group;
+            return
+                shader_group != nullptr
+                    ? reinterpret_cast<std::uintptr_t>(shader_group)
+                    : reinterpret_cast<std::uintptr_t>(material);
+        }
+
+        //
+        // Staging support.
+        //
+
+        void collect_stageable_materials(const BaseGroup& base_group)
+        {
+            for (const Assembly& assembly : base_group.assemblies())
+            {
+                for (const Material& material : assembly.materials())
+                {
+                    const Material::RenderData& material_data = material.get_render_data();
+
+                    // Subsurface scattering and participating media may be reached from any
+                    // path, so none of them can be staged if the scene has any.
+                    if (material_data.m_bssrdf != nullptr || material_data.m_volume != nullptr)
+                    {
+                        m_staging_enabled = false;
+                        return;
+                    }
+
+                    if (is_stageable_material(material_data))
+                        m_stageable_materials.insert(&material);
+                }
+
+                collect_stageable_materials(assembly);
+
+                if (!m_staging_enabled)
+                    return;
+            }
+        }
+
+        static bool is_stageable_material(const Material::RenderData& material_data)
+        {
+            // The surface shader must only invoke the lighting engine once.
+            const SurfaceShader* surface_shader = material_data.m_surface_shader;
+            if (surface_shader == nullptr ||
+                std::strcmp(surface_shader->get_model(), "physical_surface_shader") != 0 ||
+                surface_shader->get_parameters().get_optional<size_t>("lighting_samples", 1) != 1)
+                return false;
+
+            // The shading engine handles these closures before invoking the surface shader.
+            const ShaderGroup* shader_group = material_data.m_shader_group;
+            if (shader_group != nullptr &&
+                (shader_group->has_transparency() ||
+                 shader_group->has_matte() ||
+                 shader_group->has_npr()))
+                return false;
+
+            return true;
+        }
+
+        void check_scene()
+        {
+            // Materials are only prepared for rendering at the beginning of the frame.
+            m_scene_checked = true;
+
+            if (!m_staging_enabled)
+                return;
+
+            collect_stageable_materials(m_scene);
+
+            if (!m_staging_enabled)
+            {
+                m_stageable_materials.clear();
+
+                if (m_thread_index == 0)
+                {
+                    RENDERER_LOG_INFO(
+                        "the scene contains subsurface scattering or participating media, "
+                        "the wavefront sample renderer will not stage paths.");
+                }
+            }
+        }
+
+        bool can_stage(const ShadingPoint& shading_point) const
+        {
+            if (!shading_point.hit_surface())
+                return false;
+
+            const Material* material = shading_point.get_material();
+            if (material == nullptr || m_stageable_materials.count(material) == 0)
+                return false;
+
+            // Partially transparent surfaces require continuation rays to be shaded.
+            return shading_point.get_alpha()[0] > m_opacity_threshold;
+        }
+
+        //
+        // Stages.
+        //
+
+        void render_paths(const size_t path_count)
+        {
+            // Attribute the time spent rendering these samples to this thread's profiler counters.
+            const ShadingProfiler::Binding profiler_binding(m_profiler_counters);
+
+            if (!m_scene_checked)
+                check_scene();
+
+            // Trace all camera rays. Each ray is traced independently of the others,
+            // so the tracing order does not affect the results.
+            if (m_params.m_ray_sorting && path_count > 1)
+            {
+                m_ray_keys.clear();
+                for (size_t i = 0; i < path_count; ++i)
+                {
+                    const ShadingRay& ray = m_paths[i].m_ray;
+                    m_ray_keys.emplace_back(m_ray_sort_key(ray.m_org, ray.m_dir), i);
+                }
+                std::sort(m_ray_keys.begin(), m_ray_keys.end());
+
+                for (size_t i = 0; i < path_count; ++i)
+                    trace_camera_ray(m_paths[m_ray_keys[i].second]);
+            }
+            else
+            {
+                for (size_t i = 0; i < path_count; ++i)
+                    trace_camera_ray(m_paths[i]);
+            }
+
+            // Decide which paths are staged.
+            size_t active_path_count = 0;
+            for (size_t i = 0; i < path_count; ++i)
+            {
+                Path& path = m_paths[i];
+                path.m_staged = m_staging_enabled && can_stage(path.m_shading_points[0]);
+                path.m_active = path.m_staged;
+
+                if (path.m_staged)
+                {
+                    begin_staged_path(path);
+                    ++active_path_count;
+                    ++m_staged_sample_count;
+                }
+                else ++m_fallback_sample_count;
+            }
+
+            // Extend the staged paths one bounce at a time.
+            size_t shading_stage_count = 0;
+            while (active_path_count > 0)
+            {
+                shading_stage(path_count);
+                shadow_stage();
+                active_path_count = extension_stage(path_count);
+                ++shading_stage_count;
+            }
+
+            m_batch_size.insert(path_count);
+            m_shading_stage_count.insert(shading_stage_count);
+        }
+
+        void trace_camera_ray(Path& path) const
+        {
+            path.m_current = 0;
+            path.m_parent = NoSlot;
+            path.m_shading_points[0].clear();
+            m_intersector.trace(path.m_ray, path.m_shading_points[0]);
+        }
+
+        void shading_stage(const size_t path_count)
+        {
+            // Sort active paths by shading key. Ties are broken using the path index
+            // such that the shading order is deterministic for a given scene.
+            m_shading_keys.clear();
+            for (size_t i = 0; i < path_count; ++i)
+            {
+                const Path& path = m_paths[i];
+                if (path.m_active)
+                    m_shading_keys.emplace_back(get_shading_key(path.m_shading_points[path.m_current]), i);
+            }
+            std::sort(m_shading_keys.begin(), m_shading_keys.end());
+
+            size_t shading_key_count = 0;
+            for (size_t i = 0, e = m_shading_keys.size(); i < e; ++i)
+            {
+                if (i == 0 || m_shading_keys[i].first != m_shading_keys[i - 1].first)
+                    ++shading_key_count;
+
+                const size_t path_index = m_shading_keys[i].second;
+                shade_staged_path(path_index, m_paths[path_index]);
+            }
+
+            m_shading_key_count.insert(shading_key_count);
+        }
+
+        void shadow_stage()
+        {
+            assert(m_shadow_ray_owners.size() == m_shadow_rays.size());
+
+            const size_t shadow_ray_count = m_shadow_rays.size();
+            m_shadow_ray_transmissions.resize(shadow_ray_count);
+
+            // Compute the transmission factors between the light samples and the shading points.
+            // Each ray is traced independently of the others, so the tracing order does not
+            // affect the results.
+            if (m_params.m_ray_sorting && shadow_ray_count > 1)
+            {
+                m_ray_keys.clear();
+                for (size_t i = 0; i < shadow_ray_count; ++i)
+                {
+                    const ShadowRayQueue::ShadowRay& shadow_ray = m_shadow_rays[i];
+                    const Vector3d& org = shadow_ray.m_origin->get_point();
+                    const Vector3d dir =
+                        shadow_ray.m_infinite
+                            ? shadow_ray.m_target
+                            : shadow_ray.m_target - org;
+                    m_ray_keys.emplace_back(m_ray_sort_key(org, dir), i);
+                }
+                std::sort(m_ray_keys.begin(), m_ray_keys.end());
+
+                for (size_t i = 0; i < shadow_ray_count; ++i)
+                    trace_shadow_ray(m_ray_keys[i].second);
+            }
+            else
+            {
+                for (size_t i = 0; i < shadow_ray_count; ++i)
+                    trace_shadow_ray(i);
+            }
+
+            // Accumulate the contributions in the order they were queued.
+            for (size_t i = 0; i < shadow_ray_count; ++i)
+            {
+                const Spectrum& transmission = m_shadow_ray_transmissions[i];
+
+                // Discard occluded samples.
+                if (is_zero(transmission))
+                    continue;
+
+                const ShadowRayOwner& owner = m_shadow_ray_owners[i];
+
+                DirectShadingComponents contribution = m_shadow_rays[i].m_contribution;
+                contribution *= transmission;
+
+                // Optionally clamp secondary rays contribution.
+                if (owner.m_clamp)
+                    clamp_contribution(contribution, m_pt_params.m_max_ray_intensity);
+
+                // Update path radiance.
+                m_paths[owner.m_path_index].m_radiance.add(
+                    owner.m_path_length,
+                    owner.m_aov_mode,
+                    contribution);
+            }
+
+            m_shadow_ray_count.insert(shadow_ray_count);
+
+            m_shadow_rays.clear();
+            m_shadow_ray_owners.clear();
+        }
+
+        void trace_shadow_ray(const size_t shadow_ray_index)
+        {
+            m_arena.clear();
+
+            m_shadow_rays[shadow_ray_index].trace(
+                m_shading_context,
+                m_shadow_ray_transmissions[shadow_ray_index]);
+        }
+
+        size_t extension_stage(const size_t path_count)
+        {
+            // Trace the extension rays of all active paths. Each ray is traced
+            // independently of the others, so the tracing order does not affect the results.
+            if (m_params.m_ray_sorting)
+            {
+                m_ray_keys.clear();
+                for (size_t i = 0; i < path_count; ++i)
+                {
+                    const Path& path = m_paths[i];
+                    if (path.m_active)
+                        m_ray_keys.emplace_back(m_ray_sort_key(path.m_ray.m_org, path.m_ray.m_dir), i);
+                }
+                std::sort(m_ray_keys.begin(), m_ray_keys.end());
+
+                for (const RayKey& ray_key : m_ray_keys)
+                    trace_extension_ray(m_paths[ray_key.second]);
+
+                return m_ray_keys.size();
+            }
+
+            size_t active_path_count = 0;
+
+            for (size_t i = 0; i < path_count; ++i)
+            {
+                Path& path = m_paths[i];
+                if (!path.m_active)
+                    continue;
+
+                trace_extension_ray(path);
+                ++active_path_count;
+            }
+
+            return active_path_count;
+        }
+
+        void trace_extension_ray(Path& path) const
+        {
+            // Pick a slot that holds neither the current vertex nor the previous scattering vertex.
+            size_t next = 1;
+            while (next == path.m_current || next == path.m_parent)
+                ++next;
+            assert(next < 4);
+
+            ShadingPoint& next_shading_point = path.m_shading_points[next];
+            next_shading_point.clear();
+            m_intersector.trace(
+                path.m_ray,
+                next_shading_point,
+                &path.m_shading_points[path.m_current]);
+
+            // Only scattering events start a new path segment.
+            if (path.m_bounce)
+                path.m_parent = path.m_current;
+
+            path.m_current = next;
+        }
+
+        //
+        // Staged path tracing.
+        //
+
+        static void begin_staged_path(Path& path)
+        {
+            path.m_throughput.set(1.0f);
+            path.m_path_length = 1;
+            path.m_scattering_modes = ScatteringMode::All;
+            path.m_prev_mode = ScatteringMode::Specular;
+            path.m_prev_prob = BSDF::DiracDelta;
+            path.m_aov_mode = ScatteringMode::None;
+            path.m_diffuse_bounces = 0;
+            path.m_glossy_bounces = 0;
+            path.m_specular_bounces = 0;
+            path.m_iterations = 0;
+            path.m_omit_emitted_light = false;
+            path.m_is_indirect_lighting = false;
+            path.m_medium_start = Vector3d(0.0);
+            path.m_radiance = ShadingComponents();
+            path.m_aov_components = AOVComponents();
+        }
+
+        void end_staged_path(Path& path)
+        {
+            path.m_active = false;
+            m_staged_path_length.insert(path.m_path_length);
+        }
+
+        // Shade the current vertex of a staged path and prepare its extension ray.
+        // This is the body of the loop of PathTracer::trace().
+        void shade_staged_path(
+            const size_t                path_index,
+            Path&                       path)
+        {
+            m_arena.clear();
+
+            SamplingContext& sampling_context = *path.m_sampling_context;
+
+            // Put a hard limit on the number of iterations.
+            const size_t max_iterations = m_shading_context.get_max_iterations();
+            if (path.m_iterations++ == max_iterations)
+            {
+                if (m_pt_params.get_path_tracer_max_bounces() < max_iterations)
+                {
+                    RENDERER_LOG_WARNING(
+                        "reached hard iteration limit (%s), breaking path tracing loop.",
+                        pretty_int(max_iterations).c_str());
+                }
+                end_staged_path(path);
+                return;
+            }
+
+            PathVertex vertex(sampling_context);
+            vertex.m_path_length = path.m_path_length;
+            vertex.m_scattering_modes = path.m_scattering_modes;
+            vertex.m_throughput = path.m_throughput;
+            vertex.m_shading_point = &path.m_shading_points[path.m_current];
+            vertex.m_parent_shading_point =
+                path.m_parent != NoSlot ? &path.m_shading_points[path.m_parent] : nullptr;
+            vertex.m_prev_mode = path.m_prev_mode;
+            vertex.m_prev_prob = path.m_prev_prob;
+            vertex.m_aov_mode = path.m_aov_mode;
+
+            // Retrieve the ray.
+            const ShadingRay& ray = vertex.get_ray();
+            assert(is_normalized(ray.m_dir));
+
+            // Compute the outgoing direction at this vertex.
+            vertex.m_outgoing =
+                ray.m_has_differentials
+                    ? Dual3d(-ray.m_dir, -ray.m_rx_dir, -ray.m_ry_dir)
+                    : Dual3d(-ray.m_dir);
+
+            // Terminate the path if the ray didn't hit anything.
+            if (!vertex.m_shading_point->hit_surface())
+            {
+                on_miss(path, vertex);
+                end_staged_path(path);
+                return;
+            }
+
+            // Retrieve the material at the shading point.
+            const Material* material = vertex.get_material();
+
+            // Terminate the path if the surface has no material.
+            if (material == nullptr)
+            {
+                end_staged_path(path);
+                return;
+            }
+
+            // Retrieve the material's render data.
+            const Material::RenderData& material_data = material->get_render_data();
+
+            // Retrieve the object instance at the shading point.
+            const ObjectInstance& object_instance = vertex.m_shading_point->get_object_instance();
+
+            // Determine whether the ray is entering or leaving a medium.
+            const bool entering = vertex.m_shading_point->is_entering();
+
+            // Handle false intersections.
+            if (ray.get_current_medium() &&
+                ray.get_current_medium()->m_object_instance->get_medium_priority() > object_instance.get_medium_priority() &&
+                material_data.m_bsdf != nullptr)
+            {
+                // Construct a ray that continues in the same direction as the incoming ray.
+                ShadingRay& next_ray = make_continuation_ray(path, vertex);
+
+                // Initialize the ray's medium list.
+                if (entering)
+                {
+                    // Execute the OSL shader if there is one.
+                    if (material_data.m_shader_group)
+                    {
+                        m_shading_context.execute_osl_shading(
+                            *material_data.m_shader_group,
+                            *vertex.m_shading_point);
+                    }
+
+                    const void* data = material_data.m_bsdf->evaluate_inputs(m_shading_context, *vertex.m_shading_point);
+                    const float ior = material_data.m_bsdf->sample_ior(sampling_context, data);
+                    next_ray.add_medium(ray, &object_instance, material, ior);
+                }
+                else next_ray.remove_medium(ray, &object_instance);
+
+                return;
+            }
+
+            // Handle alpha mapping.
+            if (vertex.m_path_length > 1)
+            {
+                Alpha alpha = vertex.m_shading_point->get_alpha();
+
+                // Apply OSL transparency if needed.
+                if (material_data.m_shader_group &&
+                    material_data.m_shader_group->has_transparency())
+                {
+                    Alpha a;
+                    m_shading_context.execute_osl_transparency(
+                        *material_data.m_shader_group,
+                        *vertex.m_shading_point,
+                        a);
+                    alpha *= a;
+                }
+
+                if (pass_through(sampling_context, alpha))
+                {
+                    // Construct a ray that continues in the same direction as the incoming ray
+                    // and inherits the medium list from the parent ray.
+                    ShadingRay& next_ray = make_continuation_ray(path, vertex);
+                    next_ray.copy_media_from(ray);
+                    return;
+                }
+            }
+
+            // Execute the OSL shader if there is one.
+            if (material_data.m_shader_group)
+            {
+                m_shading_context.execute_osl_shading(
+                    *material_data.m_shader_group,
+                    *vertex.m_shading_point);
+            }
+
+            // Retrieve the EDF and the BSDF. Staged paths never reach BSSRDFs.
+            vertex.m_edf =
+                vertex.m_shading_point->is_curve_primitive() ? nullptr : material_data.m_edf;
+            vertex.m_bsdf = material_data.m_bsdf;
+            vertex.m_bssrdf = nullptr;
+            assert(material_data.m_bssrdf == nullptr);
+
+            // Evaluate the inputs of the BSDF.
+            if (vertex.m_bsdf)
+            {
+                vertex.m_bsdf_data =
+                    vertex.m_bsdf->evaluate_inputs(m_shading_context, *vertex.m_shading_point);
+            }
+
+            // Handle the hit.
+            vertex.m_cos_on = dot(vertex.m_outgoing.get_value(), vertex.get_shading_normal());
+            on_hit(path, vertex);
+
+            // Use Russian Roulette to cut the path without introducing bias.
+            if (!continue_path_rr(sampling_context, vertex))
+            {
+                end_staged_path(path);
+                return;
+            }
+
+            // Honor the global bounce limit.
+            const size_t bounces = vertex.m_path_length - 1;
+            if (bounces == m_pt_params.get_path_tracer_max_bounces())
+            {
+                end_staged_path(path);
+                return;
+            }
+
+            // Determine which scattering modes are still enabled.
+            if (path.m_diffuse_bounces >= m_pt_params.get_path_tracer_max_diffuse_bounces())
+                vertex.m_scattering_modes &= ~ScatteringMode::Diffuse;
+            if (path.m_glossy_bounces >= m_pt_params.m_max_glossy_bounces)
+                vertex.m_scattering_modes &= ~ScatteringMode::Glossy;
+            if (path.m_specular_bounces >= m_pt_params.m_max_specular_bounces)
+                vertex.m_scattering_modes &= ~ScatteringMode::Specular;
+
+            // Staging is disabled for scenes with volumes (see collect_stageable_materials()),
+            // so staged paths never enter a medium and never scatter in volumes, whatever
+            // the volume bounce limit.
+            vertex.m_scattering_modes &= ~ScatteringMode::Volume;
+
+            // Terminate path if no scattering event is possible.
+            // Staged paths never reach volumes, so there is no above-surface scattering without a BSDF.
+            if (vertex.m_scattering_modes == ScatteringMode::None || vertex.m_bsdf == nullptr)
+            {
+                end_staged_path(path);
+                return;
+            }
+
+            // Compute the bounce.
+            ShadingRay next_ray(
+                vertex.get_point(),
+                ray.m_dir,
+                ray.m_time,
+                ray.m_flags,
+                ray.m_depth);
+            if (!process_bounce(path_index, path, vertex, next_ray))
+            {
+                end_staged_path(path);
+                return;
+            }
+
+            // Build the medium list of the scattered ray.
+            const Vector3d& geometric_normal = vertex.get_geometric_normal();
+            const bool crossing_interface =
+                dot(vertex.m_outgoing.get_value(), geometric_normal) *
+                dot(next_ray.m_dir, geometric_normal) < 0.0;
+            if (crossing_interface)
+            {
+                // Ray goes under the surface:
+                // inherit the medium list of the parent ray and add/remove the current medium.
+                if (entering)
+                {
+                    const float ior = vertex.m_bsdf->sample_ior(sampling_context, vertex.m_bsdf_data);
+                    next_ray.add_medium(ray, &object_instance, vertex.get_material(), ior);
+                }
+                else
+                {
+                    next_ray.remove_medium(ray, &object_instance);
+                }
+            }
+            else
+            {
+                // Reflected ray:
+                // inherit the medium list of the parent ray.
+                next_ray.copy_media_from(ray);
+            }
+
+            // Compute absorption for the segment inside the medium.
+            const ShadingRay::Medium* prev_medium = ray.get_current_medium();
+            if (prev_medium != nullptr && prev_medium->m_material != nullptr)
+            {
+                const Material::RenderData& render_data = prev_medium->m_material->get_render_data();
+
+                if (render_data.m_bsdf)
+                {
+                    // Execute the OSL shader if there is one.
+                    if (render_data.m_shader_group)
+                    {
+                        m_shading_context.execute_osl_shading(
+                            *render_data.m_shader_group,
+                            *vertex.m_shading_point);
+                    }
+
+                    const void* data = render_data.m_bsdf->evaluate_inputs(m_shading_context, *vertex.m_shading_point);
+                    const float distance = static_cast<float>(norm(vertex.get_point() - path.m_medium_start));
+                    Spectrum absorption;
+                    render_data.m_bsdf->compute_absorption(data, distance, absorption);
+                    vertex.m_throughput *= absorption;
+                }
+            }
+
+            path.m_medium_start = vertex.get_point();
+
+            // Save the path state; the extension ray is traced in the extension stage.
+            path.m_ray = next_ray;
+            path.m_bounce = true;
+            path.m_path_length = vertex.m_path_length;
+            path.m_scattering_modes = vertex.m_scattering_modes;
+            path.m_throughput = vertex.m_throughput;
+            path.m_prev_mode = vertex.m_prev_mode;
+            path.m_prev_prob = vertex.m_prev_prob;
+            path.m_aov_mode = vertex.m_aov_mode;
+        }
+
+        // Prepare a ray that continues the current ray past the current vertex,
+        // either through a false intersection or through a transparent surface.
+        static ShadingRay& make_continuation_ray(
+            Path&                       path,
+            const PathVertex&           vertex)
+        {
+            const ShadingRay& ray = vertex.get_ray();
+
+            // The ray depth does not increase.
+            ShadingRay next_ray(
+                vertex.get_point(),
+                ray.m_dir,
+                ray.m_time,
+                ray.m_flags,
+                ray.m_depth);
+
+            // Advance the differentials if the ray has them.
+            if (ray.m_has_differentials)
+            {
+                next_ray.m_rx_org = ray.m_rx_org + ray.m_tmax * ray.m_rx_dir;
+                next_ray.m_ry_org = ray.m_ry_org + ray.m_tmax * ray.m_ry_dir;
+                next_ray.m_rx_dir = ray.m_rx_dir;
+                next_ray.m_ry_dir = ray.m_ry_dir;
+                next_ray.m_has_differentials = true;
+            }
+
+            path.m_ray = next_ray;
+            path.m_bounce = false;
+
+            return path.m_ray;
+        }
+
+        // Determine whether a ray can pass through a surface with a given alpha value.
+        static bool pass_through(
+            SamplingContext&            sampling_context,
+            const Alpha                 alpha)
+        {
+            // Fully opaque: never pass through.
+            if (alpha[0] >= 1.0f)
+                return false;
+
+            // Fully transparent: always pass through.
+            if (alpha[0] <= 0.0f)
+                return true;
+
+            // Generate a uniform sample in [0,1).
+            sampling_context.split_in_place(1, 1);
+            const float s = sampling_context.next2<float>();
+
+            return s >= alpha[0];
+        }
+
+        // Use Russian Roulette to cut the path without introducing bias.
+        bool continue_path_rr(
+            SamplingContext&            sampling_context,
+            PathVertex&                 vertex) const
+        {
+            // Don't apply Russian Roulette for the first few bounces.
+            if (vertex.m_path_length <= m_pt_params.m_rr_min_path_length)
+                return true;
+
+            // Generate a uniform sample in [0,1).
+            sampling_context.split_in_place(1, 1);
+            const float s = sampling_context.next2<float>();
+
+            // Compute the probability of extending this path.
+            const float scattering_prob =
+                std::min(max_value(vertex.m_throughput), 0.99f);
+
+            // Russian Roulette.
+            if (!pass_rr(scattering_prob, s))
+                return false;
+
+            // Adjust throughput to account for terminated paths.
+            assert(scattering_prob > 0.0f);
+            vertex.m_throughput /= scattering_prob;
+
+            return true;
+        }
+
+        // Compute next event estimation, sample the BSDF and build the bounced ray.
+        // Returns false if the path must be terminated.
+        bool process_bounce(
+            const size_t                path_index,
+            Path&                       path,
+            PathVertex&                 vertex,
+            ShadingRay&                 next_ray)
+        {
+            SamplingContext& sampling_context = *path.m_sampling_context;
+
+            // Add the direct lighting contribution at this vertex.
+            on_scatter(path_index, path, vertex);
+
+            // Terminate the path if all scattering modes are disabled.
+            if (vertex.m_scattering_modes == ScatteringMode::None)
+                return false;
+
+            BSDF::LocalGeometry local_geometry;
+            local_geometry.m_shading_point = vertex.m_shading_point;
+            local_geometry.m_geometric_normal = Vector3f(vertex.get_geometric_normal());
+            local_geometry.m_shading_basis = Basis3f(vertex.get_shading_basis());
+
+            BSDFSample sample;
+
+            {
+                const ShadingProfiler::Scope profiler_scope(
+                    ShadingProfiler::BSDFSampling,
+                    vertex.get_material(),
+                    &vertex.m_shading_point->get_object_instance());
+
+                vertex.m_bsdf->sample(
+                    sampling_context,
+                    vertex.m_bsdf_data,
+                    false,      // not adjoint
+                    true,       // multiply by |cos(incoming, normal)|
+                    local_geometry,
+                    Dual3f(vertex.m_outgoing),
+                    vertex.m_scattering_modes,
+                    sample);
+            }
+
+            next_ray.m_min_roughness = m_pt_params.m_clamp_roughness ? sample.m_min_roughness : 0.0f;
+
+            if (vertex.m_path_length == 1 && sample.get_mode() == ScatteringMode::Diffuse)
+                path.m_aov_components.m_albedo = sample.m_aov_components.m_albedo;
+
+            // Terminate the path if it gets absorbed.
+            if (sample.get_mode() == ScatteringMode::None)
+                return false;
+
+            // Terminate the path if this scattering event is not accepted.
+            if (!accept_scattering(path, vertex.m_prev_mode, sample.get_mode()))
+                return false;
+
+            // Keep a texture footprint along the path, see PathTracer::process_bounce().
+            sample.compute_approximate_differentials(Dual3f(vertex.m_outgoing));
+
+            // Save the scattering properties for MIS at light-emitting vertices.
+            vertex.m_prev_mode = sample.get_mode();
+            vertex.m_prev_prob = sample.get_probability();
+
+            // Update the AOV scattering mode only for the first bounce.
+            if (vertex.m_path_length == 1)
+                vertex.m_aov_mode = sample.get_mode();
+
+            // Update path throughput.
+            if (sample.get_probability() != BSDF::DiracDelta)
+                sample.m_value /= sample.get_probability();
+            vertex.m_throughput *= sample.m_value.m_beauty;
+
+            // Update bounce counters.
+            ++vertex.m_path_length;
+            path.m_diffuse_bounces +=  (sample.get_mode() >> ScatteringMode::DiffuseBitShift)  & 1;
+            path.m_glossy_bounces +=   (sample.get_mode() >> ScatteringMode::GlossyBitShift)   & 1;
+            path.m_specular_bounces += (sample.get_mode() >> ScatteringMode::SpecularBitShift) & 1;
+
+            // Construct the scattered ray.
+            const ShadingRay& ray = vertex.get_ray();
+            next_ray.m_org = vertex.m_shading_point->get_point();
+            next_ray.m_dir = improve_normalization<2>(Vector3d(sample.m_incoming.get_value()));
+            next_ray.m_time = ray.m_time;
+            next_ray.m_flags = ScatteringMode::get_vis_flags(sample.get_mode());
+            next_ray.m_depth = ray.m_depth + 1;
+
+            // Compute scattered ray differentials.
+            if (sample.m_incoming.has_derivatives())
+            {
+                next_ray.m_rx_org = next_ray.m_org + vertex.m_shading_point->get_dpdx();
+                next_ray.m_ry_org = next_ray.m_org + vertex.m_shading_point->get_dpdy();
+                next_ray.m_rx_dir = Vector3d(sample.m_incoming.get_dx());
+                next_ray.m_ry_dir = Vector3d(sample.m_incoming.get_dy());
+                next_ray.m_has_differentials = true;
+            }
+
+            return true;
+        }
+
+        //
+        // Path visitor with next event estimation, see PathVisitorNextEventEstimation
+        // in renderer/kernel/lighting/pt/ptlightingengine.cpp.
+        //
+
+        bool accept_scattering(
+            Path&                       path,
+            const ScatteringMode::Mode  prev_mode,
+            const ScatteringMode::Mode  next_mode) const
+        {
+            assert(next_mode != ScatteringMode::None);
+
+            if (!m_pt_params.m_enable_caustics)
+            {
+                // Don't follow paths leading to caustics.
+                if (ScatteringMode::has_diffuse_or_volume(prev_mode) &&
+                    ScatteringMode::has_glossy_or_specular(next_mode))
+                    return false;
+
+                // Ignore light emission after glossy-to-specular bounces to prevent another class of fireflies.
+                if (ScatteringMode::has_glossy(prev_mode) &&
+                    ScatteringMode::has_specular(next_mode))
+                    path.m_omit_emitted_light = true;
+            }
+
+            return true;
+        }
+
+        bool must_clamp(const PathVertex& vertex) const
+        {
+            return
+                m_pt_params.m_has_max_ray_intensity &&
+                vertex.m_path_length > 1 &&
+                vertex.m_prev_mode != ScatteringMode::Specular;
+        }
+
+        void on_miss(
+            Path&                       path,
+            const PathVertex&           vertex) const
+        {
+            assert(vertex.m_prev_mode != ScatteringMode::None);
+
+            // Can't look up the environment if there's no environment EDF.
+            if (m_env_edf == nullptr)
+                return;
+
+            // When IBL is disabled, the environment should still be reflected by glossy and specular surfaces.
+            if (!m_pt_params.m_enable_ibl && vertex.m_prev_mode == ScatteringMode::Diffuse)
+                return;
+
+            // Evaluate the environment EDF.
+            Spectrum env_radiance(Spectrum::Illuminance);
+            float env_prob;
+            m_env_edf->evaluate(
+                m_shading_context,
+                -Vector3f(vertex.m_outgoing.get_value()),
+                env_radiance,
+                env_prob);
+
+            // This may happen for points of the environment map with infinite components,
+            // which are then excluded from importance sampling and thus have zero weight.
+            if (env_prob == 0.0f)
+                return;
+
+            // Multiple importance sampling.
+            if (vertex.m_prev_mode != ScatteringMode::Specular)
+            {
+                assert(vertex.m_prev_prob > 0.0f);
+                const float env_sample_count = std::max(m_pt_params.m_ibl_env_sample_count, 1.0f);
+                const float mis_weight =
+                    mis_power2(
+                        1.0f * vertex.m_prev_prob,
+                        env_sample_count * env_prob);
+                env_radiance *= mis_weight;
+            }
+
+            // Apply path throughput.
+            env_radiance *= vertex.m_throughput;
+
+            // Optionally clamp secondary rays contribution.
+            if (must_clamp(vertex))
+                clamp_contribution(env_radiance, m_pt_params.m_max_ray_intensity);
+
+            // Update path radiance.
+            path.m_radiance.add_emission(
+                vertex.m_path_length,
+                vertex.m_aov_mode,
+                env_radiance);
+        }
+
+        void on_hit(
+            Path&                       path,
+            const PathVertex&           vertex) const
+        {
+            // Emitted light contribution.
+            if ((!path.m_omit_emitted_light || m_pt_params.m_enable_caustics) &&
+                vertex.m_edf &&
+                vertex.m_cos_on > 0.0 &&
+                (vertex.m_path_length > 2 || m_pt_params.m_enable_dl) &&
+                (vertex.m_path_length < 2 || (vertex.m_edf->get_flags() & EDF::CastIndirectLight)))
+            {
+                // Compute the emitted radiance.
+                Spectrum emitted_radiance(Spectrum::Illuminance);
+                vertex.compute_emitted_radiance(m_shading_context, emitted_radiance);
+
+                // Multiple importance sampling.
+                if (vertex.m_prev_mode != ScatteringMode::Specular)
+                {
+                    const float light_sample_count = std::max(m_pt_params.m_dl_light_sample_count, 1.0f);
+                    const float mis_weight =
+                        mis_power2(
+                            1.0f * vertex.get_bsdf_prob_area(),
+                            light_sample_count * vertex.get_light_prob_area(*m_light_sampler));
+                    emitted_radiance *= mis_weight;
+                }
+
+                // Apply path throughput.
+                emitted_radiance *= vertex.m_throughput;
+
+                // Optionally clamp secondary rays contribution.
+                if (must_clamp(vertex))
+                    clamp_contribution(emitted_radiance, m_pt_params.m_max_ray_intensity);
+
+                // Update path radiance.
+                path.m_radiance.add_emission(
+                    vertex.m_path_length,
+                    vertex.m_aov_mode,
+                    emitted_radiance);
+            }
+        }
+
+        void on_scatter(
+            const size_t                path_index,
+            Path&                       path,
+            PathVertex&                 vertex)
+        {
+            assert(vertex.m_scattering_modes != ScatteringMode::None);
+
+            SamplingContext& sampling_context = *path.m_sampling_context;
+
+            // Any light contribution after a diffuse or glossy bounce is considered indirect.
+            if (ScatteringMode::has_diffuse_or_glossy_or_volume(vertex.m_prev_mode))
+                path.m_is_indirect_lighting = true;
+
+            // When caustics are disabled, disable glossy and specular components after a diffuse or volume bounce.
+            if (!m_pt_params.m_enable_caustics)
+            {
+                if (vertex.m_prev_mode == ScatteringMode::Diffuse ||
+                    vertex.m_prev_mode == ScatteringMode::Volume)
+                    vertex.m_scattering_modes &= ~(ScatteringMode::Glossy | ScatteringMode::Specular);
+            }
+
+            // Terminate the path if all scattering modes are disabled.
+            if (vertex.m_scattering_modes == ScatteringMode::None)
+                return;
+
+            // If we have an OSL shader, we need to choose one of the closures and set
+            // its shading basis into the shading point for the direct lighting estimators.
+            if (m_pt_params.m_enable_dl || m_pt_params.m_enable_ibl)
+            {
+                const Material::RenderData& material_data =
+                    vertex.m_shading_point->get_material()->get_render_data();
+                if (material_data.m_shader_group)
+                {
+                    sampling_context.split_in_place(2, 1);
+                    m_shading_context.choose_bsdf_closure_shading_basis(
+                        *vertex.m_shading_point,
+                        sampling_context.next2<Vector2f>());
+                }
+            }
+
+            const BSDFSampler bsdf_sampler(
+                *vertex.m_bsdf,
+                vertex.m_bsdf_data,
+                vertex.m_scattering_modes,      // bsdf_sampling_modes (unused)
+                *vertex.m_shading_point);
+
+            // Contributions of unshadowed samples are added right away,
+            // the others are queued along with their shadow rays.
+            DirectShadingComponents vertex_radiance;
+            const size_t shadow_ray_begin = m_shadow_rays.size();
+
+            // Direct lighting contribution.
+            if (m_pt_params.m_enable_dl || vertex.m_path_length > 1)
+            {
+                const size_t light_sample_count =
+                    stochastic_cast<size_t>(
+                        sampling_context,
+                        m_pt_params.m_dl_light_sample_count);
+
+                if (light_sample_count > 0)
+                {
+                    const size_t dl_shadow_ray_begin = m_shadow_rays.size();
+
+                    // This path will be extended via BSDF sampling: sample the lights only.
+                    DirectShadingComponents dl_radiance;
+                    const DirectLightingIntegrator integrator(
+                        m_shading_context,
+                        *m_light_sampler,
+                        bsdf_sampler,
+                        vertex.m_shading_point->get_time(),
+                        vertex.m_scattering_modes,      // light_sampling_modes
+                        1,                              // material_sample_count
+                        light_sample_count,
+                        m_pt_params.m_dl_light_candidate_count,
+                        m_pt_params.m_dl_low_light_threshold,
+                        path.m_is_indirect_lighting,
+                        &m_shadow_rays);
+                    integrator.compute_outgoing_radiance_light_sampling_low_variance(
+                        sampling_context,
+                        MISPower2,
+                        vertex.m_outgoing,
+                        dl_radiance,
+                        nullptr);
+
+                    // Divide by the sample count when this number is less than 1.
+                    if (m_pt_params.m_rcp_dl_light_sample_count > 0.0f)
+                    {
+                        dl_radiance *= m_pt_params.m_rcp_dl_light_sample_count;
+                        m_shadow_rays.scale_contributions(
+                            dl_shadow_ray_begin,
+                            m_pt_params.m_rcp_dl_light_sample_count);
+                    }
+
+                    vertex_radiance += dl_radiance;
+                }
+            }
+
+            // Image-based lighting contribution.
+            if (m_pt_params.m_enable_ibl && m_env_edf)
+            {
+                const size_t env_sample_count =
+                    stochastic_cast<size_t>(
+                        sampling_context,
+                        m_pt_params.m_ibl_env_sample_count);
+
+                const size_t ibl_shadow_ray_begin = m_shadow_rays.size();
+
+                // This path will be extended via BSDF sampling: sample the environment only.
+                DirectShadingComponents ibl_radiance;
+                compute_ibl_environment_sampling(
+                    sampling_context,
+                    m_shading_context,
+                    *m_env_edf,
+                    vertex.m_outgoing,
+                    bsdf_sampler,
+                    vertex.m_scattering_modes,
+                    1,                                  // bsdf_sample_count
+                    env_sample_count,
+                    ibl_radiance,
+                    nullptr,
+                    &m_shadow_rays);
+
+                // Divide by the sample count when this number is less than 1.
+                if (m_pt_params.m_rcp_ibl_env_sample_count > 0.0f)
+                {
+                    ibl_radiance *= m_pt_params.m_rcp_ibl_env_sample_count;
+                    m_shadow_rays.scale_contributions(
+                        ibl_shadow_ray_begin,
+                        m_pt_params.m_rcp_ibl_env_sample_count);
+                }
+
+                vertex_radiance += ibl_radiance;
+            }
+
+            const bool clamp = must_clamp(vertex);
+
+            // Apply path throughput.
+            vertex_radiance *= vertex.m_throughput;
+            m_shadow_rays.scale_contributions(shadow_ray_begin, vertex.m_throughput);
+
+            // Optionally clamp secondary rays contribution.
+            if (clamp)
+                clamp_contribution(vertex_radiance, m_pt_params.m_max_ray_intensity);
+
+            // Update path radiance.
+            path.m_radiance.add(
+                vertex.m_path_length,
+                vertex.m_aov_mode,
+                vertex_radiance);
+
+            // Remember where to accumulate the contributions of the queued shadow rays.
+            ShadowRayOwner owner;
+            owner.m_path_index = path_index;
+            owner.m_path_length = vertex.m_path_length;
+            owner.m_aov_mode = vertex.m_aov_mode;
+            owner.m_clamp = clamp;
+            m_shadow_ray_owners.resize(m_shadow_rays.size(), owner);
+        }
+
+        //
+        // Resolution.
+        //
+
+        void resolve_path(
+            Path&                       path,
+            AOVAccumulatorContainer&    aov_accumulators)
+        {
+            // Attribute the time spent shading this sample to this thread's profiler counters.
+            const ShadingProfiler::Binding profiler_binding(m_profiler_counters);
+
+            if (!path.m_staged)
+            {
+                shade_path(path, aov_accumulators);
+                return;
+            }
+
+            const PixelContext& pixel_context = *path.m_pixel_context;
+            const ShadingPoint& shading_point = path.m_shading_points[0];
+            ShadingResult& shading_result = *path.m_shading_result;
+
+            // Inform the AOV accumulators that we are about to render a sample.
+            aov_accumulators.on_sample_begin(pixel_context);
+
+            // Do what the shading engine and the physical surface shader do with the lighting.
+            shading_result.m_main.a = shading_point.get_alpha()[0];
+            shading_result.m_main.rgb() =
+                path.m_radiance.m_beauty.to_rgb(g_std_lighting_conditions);
+
+            // Accumulate shading components and AOV components into the shading result and AOVs.
+            aov_accumulators.write(
+                pixel_context,
+                shading_point,
+                path.m_radiance,
+                path.m_aov_components,
+                shading_result);
+
+            // Apply alpha premultiplication.
+            shading_result.apply_alpha_premult();
+
+            // Inform the AOV accumulators that we are done rendering a sample.
+            aov_accumulators.on_sample_end(pixel_context);
+        }
+
+        // Shade a path that is not staged, like the generic sample renderer does.
+        void shade_path(
+            Path&                       path,
+            AOVAccumulatorContainer&    aov_accumulators)
+        {
+            SamplingContext& sampling_context = *path.m_sampling_context;
+            const PixelContext& pixel_context = *path.m_pixel_context;
+            ShadingResult& shading_result = *path.m_shading_result;
+            ShadingRay& ray = path.m_ray;
+
+            size_t shading_point_index = 0;
+            const ShadingPoint* shading_point_ptr = &path.m_shading_points[0];
+            size_t iterations = 1;
+
+            // Inform the AOV accumulators that we are about to render a sample.
+            aov_accumulators.on_sample_begin(pixel_context);
+
+            while (true)
+            {
+                m_arena.clear();
+
+                if (iterations == 1)
+                {
+                    // Shade the first intersection point along the ray.
+                    const bool terminate_path =
+                        m_shading_engine.shade(
+                            sampling_context,
+                            pixel_context,
+                            m_shading_context,
+                            *shading_point_ptr,
+                            aov_accumulators,
+                            shading_result);
+
+                    if (terminate_path)
+                        break;
+                }
+                else
+                {
+                    // Shade the next intersection point along the ray.
+                    ShadingResult local_result(shading_result.m_aov_count);
+                    const bool terminate_path =
+                        m_shading_engine.shade(
+                            sampling_context,
+                            pixel_context,
+                            m_shading_context,
+                            *shading_point_ptr,
+                            aov_accumulators,
+                            local_result);
+
+                    // Composite `shading_result` over `local_result`.
+                    shading_result.composite_over(local_result);
+
+                    if (terminate_path)
+                        break;
+                }
+
+                // Stop once we hit the environment.
+                if (!shading_point_ptr->hit_surface())
+                    break;
+
+                // Stop once we hit full opacity.
+                if (shading_result.m_main.a > m_opacity_threshold)
+                    break;
+
+                // Put a hard limit on the number of iterations.
+                if (++iterations >= m_params.m_max_iterations)
+                {
+                    RENDERER_LOG_WARNING(
+                        "reached hard iteration limit (%s), breaking primary ray trace loop.",
+                        pretty_int(m_params.m_max_iterations).c_str());
+                    break;
+                }
+
+                // Move the ray origin to the intersection point.
+                ray.m_org = shading_point_ptr->get_point();
+                if (ray.m_has_differentials)
+                {
+                    const double t = shading_point_ptr->get_distance();
+                    ray.m_rx_org = ray.m_rx_org + t * ray.m_rx_dir;
+                    ray.m_ry_org = ray.m_ry_org + t * ray.m_ry_dir;
+                }
+
+                // Trace the continuation ray right away.
+                shading_point_index = 1 - shading_point_index;
+                ShadingPoint& next_shading_point = path.m_shading_points[shading_point_index];
+                next_shading_point.clear();
+                m_intersector.trace(ray, next_shading_point, shading_point_ptr);
+                shading_point_ptr = &next_shading_point;
+            }
+
+            // Inform the AOV accumulators that we are done rendering a sample.
+            aov_accumulators.on_sample_end(pixel_context);
+        }
+    };
+}
+
+
+//
+// WavefrontSampleRendererFactory class implementation.
+//
+
+WavefrontSampleRendererFactory::WavefrontSampleRendererFactory(
+    const Scene&                scene,
+    const Frame&                frame,
+    const TraceContext&         trace_context,
+    TextureStore&               texture_store,
+    ILightingEngineFactory*     lighting_engine_factory,
+    const BackwardLightSampler* light_sampler,
+    ShadingEngine&              shading_engine,
+    OIIOTextureSystem&          oiio_texture_system,
+    OSLShadingSystem&           shading_system,
+    ShadingProfiler*            shading_profiler,
+    const ParamArray&           params,
+    const ParamArray&           pt_params)
+  : m_scene(scene)
+  , m_frame(frame)
+  , m_trace_context(trace_context)
+  , m_texture_store(texture_store)
+  , m_lighting_engine_factory(lighting_engine_factory)
+  , m_light_sampler(light_sampler)
+  , m_shading_engine(shading_engine)
+  , m_oiio_texture_system(oiio_texture_system)
+  , m_shading_system(shading_system)
+  , m_shading_profiler(shading_profiler)
+  , m_params(params)
+  , m_pt_params(pt_params)
+{
+}
+
+void WavefrontSampleRendererFactory::release()
+{
+    delete this;
+}
+
+ISampleRenderer* WavefrontSampleRendererFactory::create(const size_t thread_index)
+{
+    return
+        new WavefrontSampleRenderer(
+            m_scene,
+            m_frame,
+            m_trace_context,
+            m_texture_store,
+            m_lighting_engine_factory,
+            m_light_sampler,
+            m_shading_engine,
+            m_oiio_texture_system,
+            m_shading_system,
+            m_shading_profiler,
+            thread_index,
+            m_params,
+            m_pt_params);
+}
+
+}   // namespace renderer
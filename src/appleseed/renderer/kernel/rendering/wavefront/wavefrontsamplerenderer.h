@@ -0,0 +1,109 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/isamplerenderer.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+
+// Forward declarations.
+namespace renderer  { class BackwardLightSampler; }
+namespace renderer  { class Frame; }
+namespace renderer  { class ILightingEngineFactory; }
+namespace renderer  { class OIIOTextureSystem; }
+namespace renderer  { class OSLShadingSystem; }
+namespace renderer  { class Scene; }
+namespace renderer  { class ShadingEngine; }
+namespace renderer  { class ShadingProfiler; }
+namespace renderer  { class TextureStore; }
+namespace renderer  { class TraceContext; }
+
+namespace renderer
+{
+
+//
+// Wavefront sample renderer factory.
+//
+// Batches of samples spanning many pixels are rendered in stages rather than one
+// sample at a time: all camera rays are traced, then paths are extended one bounce
+// at a time, alternating between a shading stage where paths are sorted by material
+// so that the same shaders execute back to back, a shadow stage where the shadow
+// rays of all paths are traced, and an extension stage where the bounce rays of all
+// paths are traced.
+//
+// Paths are only staged when the lighting engine is the path tracer, in which case
+// the light sampler must be provided along with the path tracer parameters. Other
+// paths are shaded one at a time, like in the generic sample renderer.
+//
+
+class WavefrontSampleRendererFactory
+  : public ISampleRendererFactory
+{
+  public:
+    // Constructor.
+    WavefrontSampleRendererFactory(
+        const Scene&                scene,
+        const Frame&                frame,
+        const TraceContext&         trace_context,
+        TextureStore&               texture_store,
+        ILightingEngineFactory*     lighting_engine_factory,
+        const BackwardLightSampler* light_sampler,          // light sampler of the path tracer, or nullptr
+        ShadingEngine&              shading_engine,
+        OIIOTextureSystem&          oiio_texture_system,
+        OSLShadingSystem&           shading_system,
+        ShadingProfiler*            shading_profiler,
+        const ParamArray&           params,
+        const ParamArray&           pt_params);             // path tracer parameters
+
+    // Delete this instance.
+    void release() override;
+
+    // Return a new sample renderer instance.
+    ISampleRenderer* create(
+        const size_t                thread_index) override;
+
+  private:
+    const Scene&                m_scene;
+    const Frame&                m_frame;
+    const TraceContext&         m_trace_context;
+    TextureStore&               m_texture_store;
+    ILightingEngineFactory*     m_lighting_engine_factory;
+    const BackwardLightSampler* m_light_sampler;
+    ShadingEngine&              m_shading_engine;
+    OIIOTextureSystem&          m_oiio_texture_system;
+    OSLShadingSystem&           m_shading_system;
+    ShadingProfiler*            m_shading_profiler;
+    const ParamArray            m_params;
+    const ParamArray            m_pt_params;
+};
+
+}   // namespace renderer
@@ -33,6 +33,7 @@
 #include "renderer/kernel/shading/closures.h"
 #include "renderer/kernel/shading/oslshadingsystem.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
 #include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/shadergroup/shadergroup.h"
@@ -207,6 +208,11 @@ void OSLShaderGroupExec::do_execute(
     assert(m_osl_shading_context);
     assert(m_osl_thread_info);
 
+    const ShadingProfiler::Scope profiler_scope(
+        ShadingProfiler::ShaderExecution,
+        &shader_group,
+        shading_point.hit_surface() ? &shading_point.get_object_instance() : nullptr);
+
     shading_point.initialize_osl_shader_globals(
         shader_group,
         ray_flags,
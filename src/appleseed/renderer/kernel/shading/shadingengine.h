@@ -75,6 +75,9 @@ class ShadingEngine
         OnFrameBeginRecorder&       recorder,
         foundation::IAbortSwitch*   abort_switch = nullptr);
 
+    // Return true if a diagnostic surface shader overrides the surface shaders of the scene.
+    bool has_diagnostic_surface_shader() const;
+
     // Shade a given intersection point.
     // Returns true if the path should be terminated.
     bool shade(
@@ -112,6 +115,11 @@ class ShadingEngine
 // ShadingEngine class implementation.
 //
 
+inline bool ShadingEngine::has_diagnostic_surface_shader() const
+{
+    return m_diagnostic_surface_shader.get() != nullptr;
+}
+
 inline bool ShadingEngine::shade(
     SamplingContext&            sampling_context,
     const PixelContext&         pixel_context,
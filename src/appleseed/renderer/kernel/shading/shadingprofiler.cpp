@@ -0,0 +1,402 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// Interface header.
+#include "shadingprofiler.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/modeling/entity/entity.h"
+#include "renderer/modeling/scene/objectinstance.h"
+
+// appleseed.foundation headers.
+#include "foundation/hash/hash.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/string/string.h"
+#include "foundation/utility/api/apistring.h"
+#include "foundation/utility/otherwise.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using namespace foundation;
+
+namespace renderer
+{
+
+//
+// ShadingProfiler::ThreadCounters class implementation.
+//
+
+class ShadingProfiler::ThreadCounters
+  : public NonCopyable
+{
+  public:
+    struct Key
+    {
+        Category                m_category;
+        const Entity*           m_entity;
+        const ObjectInstance*   m_object_instance;
+
+        bool operator==(const Key& rhs) const
+        {
+            return
+                m_category == rhs.m_category &&
+                m_entity == rhs.m_entity &&
+                m_object_instance == rhs.m_object_instance;
+        }
+    };
+
+    struct KeyHasher
+    {
+        size_t operator()(const Key& key) const
+        {
+            return
+                static_cast<size_t>(
+                    mix_uint64(
+                        static_cast<std::uint64_t>(key.m_category),
+                        reinterpret_cast<std::uintptr_t>(key.m_entity),
+                        reinterpret_cast<std::uintptr_t>(key.m_object_instance)));
+        }
+    };
+
+    struct Value
+    {
+        std::uint64_t           m_ticks;
+        std::uint64_t           m_calls;
+
+        Value()
+          : m_ticks(0)
+          , m_calls(0)
+        {
+        }
+    };
+
+    typedef std::unordered_map<Key, Value, KeyHasher> CounterMap;
+
+    DefaultProcessorTimer       m_timer;
+    const double                m_rcp_frequency;
+    CounterMap                  m_counters;
+    Key                         m_last_key;
+    Value*                      m_last_value;
+    std::uint64_t               m_category_ticks[CategoryCount];
+    Scope*                      m_current_scope;
+
+    ThreadCounters()
+      : m_rcp_frequency(1.0 / m_timer.frequency())
+      , m_current_scope(nullptr)
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        assert(m_current_scope == nullptr);
+
+        m_counters.clear();
+        m_last_value = nullptr;
+
+        for (size_t i = 0; i < CategoryCount; ++i)
+            m_category_ticks[i] = 0;
+    }
+
+    void add(
+        const Category          category,
+        const Entity*           entity,
+        const ObjectInstance*   object_instance,
+        const std::uint64_t     ticks)
+    {
+        const Key key = { category, entity, object_instance };
+
+        // Consecutive scopes often share the same key (e.g. when a batch of samples
+        // is shaded in material order), skip the hash table lookup in that case.
+        if (m_last_value == nullptr || !(key == m_last_key))
+        {
+            m_last_key = key;
+            m_last_value = &m_counters[key];
+        }
+
+        m_last_value->m_ticks += ticks;
+        ++m_last_value->m_calls;
+
+        m_category_ticks[category] += ticks;
+    }
+};
+
+APPLESEED_TLS ShadingProfiler::ThreadCounters* ShadingProfiler::s_thread_counters = nullptr;
+
+
+//
+// ShadingProfiler::Binding class implementation.
+//
+
+ShadingProfiler::Binding::Binding(ThreadCounters* counters)
+  : m_previous(s_thread_counters)
+{
+    s_thread_counters = counters;
+}
+
+ShadingProfiler::Binding::~Binding()
+{
+    s_thread_counters = m_previous;
+}
+
+
+//
+// ShadingProfiler::Scope class implementation.
+//
+
+void ShadingProfiler::Scope::begin(
+    const Category              category,
+    const Entity*               entity,
+    const ObjectInstance*       object_instance)
+{
+    m_parent = m_counters->m_current_scope;
+    m_category = category;
+    m_entity = entity;
+    m_object_instance = object_instance;
+    m_child_ticks = 0;
+
+    m_counters->m_current_scope = this;
+    m_begin = m_counters->m_timer.read();
+}
+
+void ShadingProfiler::Scope::end()
+{
+    const std::uint64_t elapsed = m_counters->m_timer.read() - m_begin;
+
+    // Only keep the time that was not spent in nested scopes.
+    m_counters->add(
+        m_category,
+        m_entity,
+        m_object_instance,
+        elapsed - std::min(m_child_ticks, elapsed));
+
+    if (m_parent != nullptr)
+        m_parent->m_child_ticks += elapsed;
+
+    m_counters->m_current_scope = m_parent;
+}
+
+
+//
+// ShadingProfiler class implementation.
+//
+
+namespace
+{
+    std::string get_entity_path(const Entity* entity, const char* default_path)
+    {
+        return entity != nullptr ? std::string(entity->get_path().c_str()) : default_path;
+    }
+
+    struct CostComparer
+    {
+        template <typename T>
+        bool operator()(const T& lhs, const T& rhs) const
+        {
+            return lhs.m_time > rhs.m_time;
+        }
+    };
+}
+
+ShadingProfiler::ShadingProfiler()
+{
+}
+
+ShadingProfiler::~ShadingProfiler()
+{
+}
+
+ShadingProfiler::ThreadCounters* ShadingProfiler::create_thread_counters()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_thread_counters.emplace_back(new ThreadCounters());
+    return m_thread_counters.back().get();
+}
+
+void ShadingProfiler::clear()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    for (const std::unique_ptr<ThreadCounters>& counters : m_thread_counters)
+        counters->clear();
+}
+
+std::vector<ShadingProfiler::Entry> ShadingProfiler::get_entries() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    // Merge the counters of all threads, converting them to seconds on the way.
+    typedef std::unordered_map<ThreadCounters::Key, Entry, ThreadCounters::KeyHasher> EntryMap;
+    EntryMap merged;
+
+    for (const std::unique_ptr<ThreadCounters>& counters : m_thread_counters)
+    {
+        for (const ThreadCounters::CounterMap::value_type& counter : counters->m_counters)
+        {
+            const ThreadCounters::Key& key = counter.first;
+
+            EntryMap::iterator i = merged.find(key);
+            if (i == merged.end())
+            {
+                const Entry entry = { key.m_category, key.m_entity, key.m_object_instance, 0.0, 0 };
+                i = merged.insert(EntryMap::value_type(key, entry)).first;
+            }
+
+            i->second.m_time += counter.second.m_ticks * counters->m_rcp_frequency;
+            i->second.m_calls += counter.second.m_calls;
+        }
+    }
+
+    std::vector<Entry> entries;
+    entries.reserve(merged.size());
+
+    for (const EntryMap::value_type& entry : merged)
+        entries.push_back(entry.second);
+
+    std::sort(entries.begin(), entries.end(), CostComparer());
+
+    return entries;
+}
+
+void ShadingProfiler::print_report(const size_t max_entries) const
+{
+    const std::vector<Entry> entries = get_entries();
+
+    if (entries.empty())
+    {
+        RENDERER_LOG_INFO("shading profile: no profiling data collected.");
+        return;
+    }
+
+    // Compute the time spent in each category and in each object instance.
+    struct ObjectInstanceCost
+    {
+        const ObjectInstance*   m_object_instance;
+        double                  m_time;
+    };
+
+    double category_times[CategoryCount] = { 0.0 };
+    std::unordered_map<const ObjectInstance*, double> object_instance_times;
+    double total_time = 0.0;
+
+    for (const Entry& entry : entries)
+    {
+        category_times[entry.m_category] += entry.m_time;
+        object_instance_times[entry.m_object_instance] += entry.m_time;
+        total_time += entry.m_time;
+    }
+
+    std::vector<ObjectInstanceCost> object_instance_costs;
+    object_instance_costs.reserve(object_instance_times.size());
+
+    for (const auto& object_instance_time : object_instance_times)
+    {
+        const ObjectInstanceCost cost = { object_instance_time.first, object_instance_time.second };
+        object_instance_costs.push_back(cost);
+    }
+
+    std::sort(object_instance_costs.begin(), object_instance_costs.end(), CostComparer());
+
+    std::stringstream sstr;
+    sstr << "shading profile (" << pretty_time(total_time) << " profiled):" << std::endl;
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+    {
+        sstr
+            << "  " << get_category_name(static_cast<Category>(i))
+            << " " << pretty_time(category_times[i])
+            << " (" << pretty_percent(category_times[i], total_time) << ")" << std::endl;
+    }
+
+    const size_t entry_count = std::min(max_entries, entries.size());
+    sstr << "  most expensive entries:" << std::endl;
+
+    for (size_t i = 0; i < entry_count; ++i)
+    {
+        const Entry& entry = entries[i];
+        sstr
+            << "    " << pretty_uint(i + 1) << ". "
+            << pretty_percent(entry.m_time, total_time) << "  "
+            << pretty_time(entry.m_time) << "  "
+            << get_category_name(entry.m_category) << "  "
+            << "\"" << get_entity_path(entry.m_entity, "n/a") << "\" on "
+            << "\"" << get_entity_path(entry.m_object_instance, "no object") << "\" "
+            << "(" << pretty_uint(entry.m_calls) << (entry.m_calls > 1 ? " calls)" : " call)")
+            << std::endl;
+    }
+
+    const size_t object_instance_count = std::min(max_entries, object_instance_costs.size());
+    sstr << "  most expensive object instances:";
+
+    for (size_t i = 0; i < object_instance_count; ++i)
+    {
+        const ObjectInstanceCost& cost = object_instance_costs[i];
+        sstr
+            << std::endl
+            << "    " << pretty_uint(i + 1) << ". "
+            << pretty_percent(cost.m_time, total_time) << "  "
+            << pretty_time(cost.m_time) << "  "
+            << "\"" << get_entity_path(cost.m_object_instance, "no object") << "\"";
+    }
+
+    RENDERER_LOG_INFO("%s", sstr.str().c_str());
+}
+
+bool ShadingProfiler::get_thread_category_times(double times[CategoryCount])
+{
+    const ThreadCounters* counters = s_thread_counters;
+
+    if (counters == nullptr)
+        return false;
+
+    for (size_t i = 0; i < CategoryCount; ++i)
+        times[i] = counters->m_category_ticks[i] * counters->m_rcp_frequency;
+
+    return true;
+}
+
+const char* ShadingProfiler::get_category_name(const Category category)
+{
+    switch (category)
+    {
+      case ShaderExecution: return "shader execution";
+      case RayTracing: return "ray tracing";
+      case BSDFSampling: return "bsdf sampling";
+      assert_otherwise;
+    }
+
+    return "";
+}
+
+}   // namespace renderer
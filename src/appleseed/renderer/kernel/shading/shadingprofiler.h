@@ -0,0 +1,188 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/compiler.h"
+#include "foundation/platform/thread.h"
+
+// Standard headers.
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Forward declarations.
+namespace renderer  { class Entity; }
+namespace renderer  { class ObjectInstance; }
+
+namespace renderer
+{
+
+//
+// A profiler that attributes rendering time to the shader groups, materials and
+// object instances that caused it.
+//
+// Each rendering thread accumulates time into its own counters, keyed by category,
+// entity (shader group or material) and object instance. Counters only collect time
+// while they are bound to the calling thread: scopes entered on threads without
+// bound counters cost an inlined thread-local load and measure nothing.
+//
+// Time spent in nested scopes (e.g. a ray traced from within a shader) is only
+// attributed to the innermost scope.
+//
+
+class ShadingProfiler
+  : public foundation::NonCopyable
+{
+  public:
+    enum Category
+    {
+        ShaderExecution,
+        RayTracing,
+        BSDFSampling,
+        CategoryCount
+    };
+
+    class ThreadCounters;
+
+    // Bind a set of counters to the calling thread for the lifetime of this object.
+    class Binding
+      : public foundation::NonCopyable
+    {
+      public:
+        explicit Binding(ThreadCounters* counters);
+        ~Binding();
+
+      private:
+        ThreadCounters* m_previous;
+    };
+
+    // Measure the time spent in a section of code.
+    class Scope
+      : public foundation::NonCopyable
+    {
+      public:
+        Scope(
+            const Category              category,
+            const Entity*               entity,
+            const ObjectInstance*       object_instance);
+
+        ~Scope();
+
+        // Set the object instance once it is known (e.g. after a ray was traced).
+        void set_object_instance(const ObjectInstance* object_instance);
+
+      private:
+        void begin(
+            const Category              category,
+            const Entity*               entity,
+            const ObjectInstance*       object_instance);
+
+        void end();
+
+        ThreadCounters*                 m_counters;
+        Scope*                          m_parent;
+        Category                        m_category;
+        const Entity*                   m_entity;
+        const ObjectInstance*           m_object_instance;
+        std::uint64_t                   m_begin;
+        std::uint64_t                   m_child_ticks;
+    };
+
+    // Time spent in a given category for a given entity and object instance.
+    struct Entry
+    {
+        Category                        m_category;
+        const Entity*                   m_entity;           // shader group or material, may be null
+        const ObjectInstance*           m_object_instance;  // may be null
+        double                          m_time;             // in seconds
+        std::uint64_t                   m_calls;
+    };
+
+    // Constructor.
+    ShadingProfiler();
+
+    // Destructor.
+    ~ShadingProfiler();
+
+    // Create counters for a rendering thread. The counters are owned by the profiler.
+    ThreadCounters* create_thread_counters();
+
+    // Reset all counters. Must not be called while rendering.
+    void clear();
+
+    // Merge the counters of all threads. Entries are sorted by decreasing time.
+    std::vector<Entry> get_entries() const;
+
+    // Print a ranked report of the most expensive entries and object instances.
+    void print_report(const size_t max_entries = 20) const;
+
+    // Retrieve the total time (in seconds) spent in each category by the counters bound
+    // to the calling thread. Return false if no counters are bound to the calling thread.
+    static bool get_thread_category_times(double times[CategoryCount]);
+
+    // Return a human-readable name for a given category.
+    static const char* get_category_name(const Category category);
+
+  private:
+    // Counters bound to the current thread, if any.
+    static APPLESEED_TLS ThreadCounters*            s_thread_counters;
+
+    mutable boost::mutex                            m_mutex;
+    std::vector<std::unique_ptr<ThreadCounters>>    m_thread_counters;
+};
+
+
+//
+// ShadingProfiler::Scope class implementation.
+//
+
+inline ShadingProfiler::Scope::Scope(
+    const Category              category,
+    const Entity*               entity,
+    const ObjectInstance*       object_instance)
+  : m_counters(s_thread_counters)
+{
+    if (m_counters != nullptr)
+        begin(category, entity, object_instance);
+}
+
+inline ShadingProfiler::Scope::~Scope()
+{
+    if (m_counters != nullptr)
+        end();
+}
+
+inline void ShadingProfiler::Scope::set_object_instance(const ObjectInstance* object_instance)
+{
+    m_object_instance = object_instance;
+}
+
+}   // namespace renderer
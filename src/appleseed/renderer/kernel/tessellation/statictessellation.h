@@ -85,7 +85,9 @@ class StaticTessellation
 
     // Insert and access texture coordinates.
     void reserve_tex_coords(const size_t count);
+    void resize_tex_coords(const size_t count);
     size_t push_tex_coords(const GVector2& uv);
+    void set_tex_coords(const size_t index, const GVector2& uv);
     size_t get_tex_coords_count() const;
     GVector2 get_tex_coords(const size_t index) const;
 
@@ -196,6 +198,15 @@ inline void StaticTessellation<Primitive>::reserve_tex_coords(const size_t count
     m_vertex_attributes.reserve_attributes(m_uv_0_cid, count);
 }
 
+template <typename Primitive>
+inline void StaticTessellation<Primitive>::resize_tex_coords(const size_t count)
+{
+    if (m_uv_0_cid == foundation::AttributeSet::InvalidChannelID)
+        create_uv_0_attribute();
+
+    m_vertex_attributes.resize_attributes(m_uv_0_cid, count);
+}
+
 template <typename Primitive>
 inline size_t StaticTessellation<Primitive>::push_tex_coords(const GVector2& uv)
 {
@@ -205,6 +216,14 @@ inline size_t StaticTessellation<Primitive>::push_tex_coords(const GVector2& uv)
     return m_vertex_attributes.push_attribute(m_uv_0_cid, uv);
 }
 
+template <typename Primitive>
+inline void StaticTessellation<Primitive>::set_tex_coords(const size_t index, const GVector2& uv)
+{
+    assert(m_uv_0_cid != foundation::AttributeSet::InvalidChannelID);
+
+    m_vertex_attributes.set_attribute(m_uv_0_cid, index, uv);
+}
+
 template <typename Primitive>
 inline size_t StaticTessellation<Primitive>::get_tex_coords_count() const
 {
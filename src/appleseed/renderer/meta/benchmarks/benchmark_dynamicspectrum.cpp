@@ -32,6 +32,9 @@
 // appleseed.foundation headers.
 #include "foundation/utility/benchmark.h"
 
+// Standard headers.
+#include <cstddef>
+
 using namespace foundation;
 using namespace renderer;
 
@@ -45,6 +48,13 @@ BENCHMARK_SUITE(Renderer_Utility_DynamicSpectrum31f)
         DynamicSpectrum31f              m_white;
         bool                            m_is_zero_result;
         float                           m_max_value_result;
+        DynamicSpectrum31f              m_arithmetic_result;
+        DynamicSpectrum31f              m_components[8];        // as many spectra as in ShadingComponents
+        DynamicSpectrum31f              m_copied_components[8];
+        DynamicSpectrum31f              m_throughput;
+        DynamicSpectrum31f              m_bsdf_value;
+        DynamicSpectrum31f              m_emission;
+        DynamicSpectrum31f              m_radiance;
 
         Fixture()
           : m_old_mode(DynamicSpectrum31f::set_mode(Mode))
@@ -54,6 +64,15 @@ BENCHMARK_SUITE(Renderer_Utility_DynamicSpectrum31f)
             // Must be initialized after setting the dynamic spectrum mode.
             m_black = DynamicSpectrum31f(0.0f);
             m_white = DynamicSpectrum31f(1.0f);
+            m_arithmetic_result = DynamicSpectrum31f(0.0f);
+
+            for (size_t i = 0; i < 8; ++i)
+                m_components[i] = DynamicSpectrum31f(static_cast<float>(i));
+
+            m_throughput = DynamicSpectrum31f(1.0f);
+            m_bsdf_value = DynamicSpectrum31f(0.5f);
+            m_emission = DynamicSpectrum31f(0.01f);
+            m_radiance = DynamicSpectrum31f(0.0f);
         }
 
         ~Fixture()
@@ -101,4 +120,41 @@ BENCHMARK_SUITE(Renderer_Utility_DynamicSpectrum31f)
     {
         m_max_value_result += max_value(m_white);
     }
+
+    BENCHMARK_CASE_F(Arithmetic_RGB, Fixture<DynamicSpectrum31f::RGB>)
+    {
+        m_arithmetic_result = (m_arithmetic_result + m_white) * m_white - m_black * 0.5f;
+    }
+
+    BENCHMARK_CASE_F(Arithmetic_Spectral, Fixture<DynamicSpectrum31f::Spectral>)
+    {
+        m_arithmetic_result = (m_arithmetic_result + m_white) * m_white - m_black * 0.5f;
+    }
+
+    BENCHMARK_CASE_F(Copy_RGB, Fixture<DynamicSpectrum31f::RGB>)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_copied_components[i] = m_components[i];
+    }
+
+    BENCHMARK_CASE_F(Copy_Spectral, Fixture<DynamicSpectrum31f::Spectral>)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_copied_components[i] = m_components[i];
+    }
+
+    // Throughput update and radiance accumulation of one path tracer bounce.
+    BENCHMARK_CASE_F(PathBounce_RGB, Fixture<DynamicSpectrum31f::RGB>)
+    {
+        m_throughput *= m_bsdf_value;
+        m_throughput /= 0.5f;
+        madd(m_radiance, m_throughput, m_emission);
+    }
+
+    BENCHMARK_CASE_F(PathBounce_Spectral, Fixture<DynamicSpectrum31f::Spectral>)
+    {
+        m_throughput *= m_bsdf_value;
+        m_throughput /= 0.5f;
+        madd(m_radiance, m_throughput, m_emission);
+    }
 }
@@ -0,0 +1,1029 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/rendering/defaultrenderercontroller.h"
+#include "renderer/kernel/rendering/itilecallback.h"
+#include "renderer/kernel/rendering/masterrenderer.h"
+#include "renderer/kernel/rendering/tilecallbackbase.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/bsdf/disneybrdf.h"
+#include "renderer/modeling/bsdf/lambertianbrdf.h"
+#include "renderer/modeling/bsdf/plasticbrdf.h"
+#include "renderer/modeling/camera/camera.h"
+#include "renderer/modeling/camera/pinholecamera.h"
+#include "renderer/modeling/entity/onframebeginrecorder.h"
+#include "renderer/modeling/entity/onrenderbeginrecorder.h"
+#include "renderer/modeling/environment/environment.h"
+#include "renderer/modeling/environmentshader/backgroundenvironmentshader.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/light/light.h"
+#include "renderer/modeling/light/pointlight.h"
+#include "renderer/modeling/material/genericmaterial.h"
+#include "renderer/modeling/material/material.h"
+#include "renderer/modeling/object/curveobject.h"
+#include "renderer/modeling/object/curveobjectreader.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/meshobjectprimitives.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/project-builtin/defaultproject.h"
+#include "renderer/modeling/project/configuration.h"
+#include "renderer/modeling/project/configurationcontainer.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/scene/visibilityflags.h"
+#include "renderer/modeling/surfaceshader/physicalsurfaceshader.h"
+#include "renderer/modeling/surfaceshader/surfaceshader.h"
+#include "renderer/modeling/volume/genericvolume.h"
+#include "renderer/modeling/volume/volume.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/transformsequence.h"
+
+// appleseed.foundation headers.
+#include "foundation/containers/dictionary.h"
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/matrix.h"
+#include "foundation/math/raysorting.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/sampling/mappings.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/memory/autoreleaseptr.h"
+#include "foundation/platform/system.h"
+#include "foundation/string/string.h"
+#include "foundation/utility/benchmark.h"
+#include "foundation/utility/searchpaths.h"
+
+// Standard headers.
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+
+//
+// End-to-end rendering benchmarks.
+//
+// Every scene is benchmarked with the following cases:
+//
+//   <Scene>_BuildTraceContext      build of the ray tracing acceleration structures
+//   <Scene>_TraceRays              closest-hit ray tracing throughput (rays/s)
+//   <Scene>_TraceSortedRays        same, tracing rays in the order of their ray sorting keys
+//   <Scene>_TimeToFirstPixel       time from scene creation to the first rendered tile
+//   <Scene>_Render_<N>Threads      rendering throughput (samples/s) with N rendering threads
+//   <Scene>_RenderWavefront        rendering throughput (samples/s) of the wavefront sample renderer
+//   <Scene>_RenderWavefrontSorted  same, with ray sorting enabled
+//
+// All cases also report the growth of the resident memory of the process between the
+// creation of the benchmark case and the end of its measurements, i.e. the physical memory
+// used by the scene, the renderer and anything else the case allocated and still holds.
+//
+// Cases that render spawn rendering threads, so they are never run on a pinned thread.
+//
+
+BENCHMARK_SUITE(Renderer_Kernel_Rendering_EndToEnd)
+{
+    // Frame rendered by the TimeToFirstPixel and Render cases.
+    const size_t FrameWidth = 64;
+    const size_t FrameHeight = 64;
+    const size_t TileSize = 8;
+    const size_t SamplesPerPixel = 8;
+
+    // Number of rays traced by a single call to the TraceRays cases.
+    const size_t RayCount = 10000;
+
+    // Parameters of the procedurally generated scenes.
+    const size_t InstanceGridSize = 20;         // number of assembly instances along each axis
+    const size_t LightGridSize = 16;            // number of point lights along each axis
+    const size_t HairCurveCount = 20000;
+
+
+    //
+    // Scenes.
+    //
+
+    typedef auto_release_ptr<Project> (*CreateProjectFunction)();
+
+    // Replace the frame of a project by a smaller one, so that rendering cases remain reasonably fast.
+    void set_benchmark_frame(Project& project)
+    {
+        project.set_frame(
+            FrameFactory::create(
+                "beauty",
+                ParamArray()
+                    .insert("camera", "camera")
+                    .insert("resolution", format("{0} {1}", FrameWidth, FrameHeight))
+                    .insert("tile_size", format("{0} {0}", TileSize))));
+    }
+
+    // Create a project with a camera, a black environment and an empty scene.
+    auto_release_ptr<Project> create_empty_project(const char* name)
+    {
+        auto_release_ptr<Project> project(ProjectFactory::create(name));
+        project->add_default_configurations();
+
+        auto_release_ptr<Scene> scene(SceneFactory::create());
+
+        auto_release_ptr<Camera> camera(
+            PinholeCameraFactory().create(
+                "camera",
+                ParamArray()
+                    .insert("film_dimensions", "0.024 0.024")
+                    .insert("focal_length", "0.035")));
+        camera->transform_sequence().set_transform(
+            0.0f,
+            Transformd(
+                Matrix4d::make_lookat(
+                    Vector3d(0.0, 2.0, 6.0),        // origin
+                    Vector3d(0.0, 0.0, 0.0),        // target
+                    Vector3d(0.0, 1.0, 0.0))));     // up
+        scene->cameras().insert(camera);
+
+        scene->environment_shaders().insert(
+            BackgroundEnvironmentShaderFactory().create(
+                "environment_shader",
+                ParamArray()
+                    .insert("color", "0.0")));
+
+        scene->set_environment(
+            EnvironmentFactory::create(
+                "environment",
+                ParamArray()
+                    .insert("environment_shader", "environment_shader")));
+
+        project->set_scene(scene);
+        set_benchmark_frame(project.ref());
+
+        return project;
+    }
+
+    typedef auto_release_ptr<BSDF> (*CreateBRDFFunction)();
+
+    auto_release_ptr<BSDF> create_lambertian_brdf()
+    {
+        return
+            LambertianBRDFFactory().create(
+                "material_brdf",
+                ParamArray()
+                    .insert("reflectance", 0.8f));
+    }
+
+    auto_release_ptr<BSDF> create_disney_brdf()
+    {
+        return
+            DisneyBRDFFactory().create(
+                "material_brdf",
+                ParamArray()
+                    .insert("base_color", 0.8f)
+                    .insert("specular", 0.5f)
+                    .insert("roughness", 0.3f)
+                    .insert("sheen", 0.2f)
+                    .insert("clearcoat", 0.5f));
+    }
+
+    auto_release_ptr<BSDF> create_plastic_brdf()
+    {
+        return
+            PlasticBRDFFactory().create(
+                "material_brdf",
+                ParamArray()
+                    .insert("diffuse_reflectance", 0.8f)
+                    .insert("specular_reflectance", 1.0f)
+                    .insert("roughness", 0.3f));
+    }
+
+    // Create an assembly containing a material named "material" using a given BRDF.
+    auto_release_ptr<Assembly> create_assembly(
+        const char*                 name,
+        CreateBRDFFunction          create_brdf = create_lambertian_brdf)
+    {
+        auto_release_ptr<Assembly> assembly(AssemblyFactory().create(name));
+
+        assembly->surface_shaders().insert(
+            PhysicalSurfaceShaderFactory().create("physical_shader", ParamArray()));
+
+        assembly->bsdfs().insert(create_brdf());
+
+        assembly->materials().insert(
+            GenericMaterialFactory().create(
+                "material",
+                ParamArray()
+                    .insert("surface_shader", "physical_shader")
+                    .insert("bsdf", "material_brdf")));
+
+        return assembly;
+    }
+
+    // Insert an object into an assembly and instantiate it with a given material on both sides.
+    void insert_object(
+        Assembly&                   assembly,
+        auto_release_ptr<Object>    object,
+        const Transformd&           transform,
+        const char*                 material_name)
+    {
+        const std::string object_name = object->get_name();
+        assembly.objects().insert(object);
+
+        const StringDictionary material_mappings =
+            StringDictionary().insert("default", material_name);
+
+        assembly.object_instances().insert(
+            ObjectInstanceFactory::create(
+                (object_name + "_inst").c_str(),
+                ParamArray(),
+                object_name.c_str(),
+                transform,
+                material_mappings,
+                material_mappings));
+    }
+
+    void insert_point_light(
+        Assembly&                   assembly,
+        const char*                 name,
+        const Vector3d&             position,
+        const float                 intensity)
+    {
+        auto_release_ptr<Light> light(
+            PointLightFactory().create(
+                name,
+                ParamArray()
+                    .insert("intensity", intensity)));
+        light->set_transform(
+            Transformd::from_local_to_parent(Matrix4d::make_translation(position)));
+        assembly.lights().insert(light);
+    }
+
+    // Insert an assembly into a scene and instantiate it with a given transform.
+    void insert_assembly(
+        Scene&                      scene,
+        auto_release_ptr<Assembly>  assembly,
+        const char*                 instance_name,
+        const Transformd&           transform = Transformd::identity())
+    {
+        auto_release_ptr<AssemblyInstance> assembly_instance(
+            AssemblyInstanceFactory::create(
+                instance_name,
+                ParamArray(),
+                assembly->get_name()));
+        assembly_instance->transform_sequence().set_transform(0.0, transform);
+        scene.assembly_instances().insert(assembly_instance);
+        scene.assemblies().insert(assembly);
+    }
+
+    auto_release_ptr<Object> create_sphere(const char* name, const float radius)
+    {
+        return
+            auto_release_ptr<Object>(
+                create_primitive_mesh(
+                    name,
+                    ParamArray()
+                        .insert("primitive", "sphere")
+                        .insert("radius", radius)
+                        .insert("resolution_u", 32)
+                        .insert("resolution_v", 16)).release());
+    }
+
+    auto_release_ptr<Project> create_cornell_box_project()
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+        set_benchmark_frame(project.ref());
+        return project;
+    }
+
+    auto_release_ptr<Project> create_default_project()
+    {
+        auto_release_ptr<Project> project(DefaultProjectFactory::create());
+        set_benchmark_frame(project.ref());
+        return project;
+    }
+
+    // A single small mesh instantiated many times: stresses the top-level acceleration structure.
+    auto_release_ptr<Project> create_heavy_instancing_project()
+    {
+        auto_release_ptr<Project> project(create_empty_project("heavy_instancing"));
+        Scene& scene = *project->get_scene();
+
+        auto_release_ptr<Assembly> sphere_assembly(create_assembly("sphere_assembly"));
+        insert_object(sphere_assembly.ref(), create_sphere("sphere", 0.08f), Transformd::identity(), "material");
+        scene.assemblies().insert(sphere_assembly);
+
+        const double Extent = 4.0;
+        const double Spacing = Extent / InstanceGridSize;
+
+        for (size_t z = 0; z < InstanceGridSize; ++z)
+        {
+            for (size_t y = 0; y < InstanceGridSize; ++y)
+            {
+                for (size_t x = 0; x < InstanceGridSize; ++x)
+                {
+                    const Vector3d position(
+                        -0.5 * Extent + (x + 0.5) * Spacing,
+                        -0.5 * Extent + (y + 0.5) * Spacing,
+                        -0.5 * Extent + (z + 0.5) * Spacing);
+
+                    auto_release_ptr<AssemblyInstance> assembly_instance(
+                        AssemblyInstanceFactory::create(
+                            format("sphere_assembly_inst_{0}_{1}_{2}", x, y, z).c_str(),
+                            ParamArray(),
+                            "sphere_assembly"));
+                    assembly_instance->transform_sequence().set_transform(
+                        0.0,
+                        Transformd::from_local_to_parent(Matrix4d::make_translation(position)));
+                    scene.assembly_instances().insert(assembly_instance);
+                }
+            }
+        }
+
+        auto_release_ptr<Assembly> light_assembly(create_assembly("light_assembly"));
+        insert_point_light(light_assembly.ref(), "light", Vector3d(0.0, 5.0, 5.0), 100.0f);
+        insert_assembly(scene, light_assembly, "light_assembly_inst");
+
+        return project;
+    }
+
+    // A simple scene lit by a large grid of point lights: stresses light sampling
+    // and, through direct lighting, the evaluation of the material's BRDF.
+    auto_release_ptr<Project> create_many_lights_project(
+        const char*                 name,
+        CreateBRDFFunction          create_brdf)
+    {
+        auto_release_ptr<Project> project(create_empty_project(name));
+
+        auto_release_ptr<Assembly> assembly(create_assembly("assembly", create_brdf));
+
+        insert_object(
+            assembly.ref(),
+            auto_release_ptr<Object>(
+                create_primitive_mesh(
+                    "floor",
+                    ParamArray()
+                        .insert("primitive", "grid")
+                        .insert("width", 8.0f)
+                        .insert("height", 8.0f)
+                        .insert("resolution_u", 1)
+                        .insert("resolution_v", 1)).release()),
+            Transformd::identity(),
+            "material");
+
+        insert_object(
+            assembly.ref(),
+            create_sphere("sphere", 1.0f),
+            Transformd::from_local_to_parent(Matrix4d::make_translation(Vector3d(0.0, 1.0, 0.0))),
+            "material");
+
+        const double Extent = 6.0;
+        const double Spacing = Extent / LightGridSize;
+        const float Intensity = 400.0f / (LightGridSize * LightGridSize);
+
+        for (size_t z = 0; z < LightGridSize; ++z)
+        {
+            for (size_t x = 0; x < LightGridSize; ++x)
+            {
+                insert_point_light(
+                    assembly.ref(),
+                    format("light_{0}_{1}", x, z).c_str(),
+                    Vector3d(
+                        -0.5 * Extent + (x + 0.5) * Spacing,
+                        3.0,
+                        -0.5 * Extent + (z + 0.5) * Spacing),
+                    Intensity);
+            }
+        }
+
+        insert_assembly(*project->get_scene(), assembly, "assembly_inst");
+
+        return project;
+    }
+
+    auto_release_ptr<Project> create_many_lights_project()
+    {
+        return create_many_lights_project("many_lights", create_lambertian_brdf);
+    }
+
+    // Same scene with multi-lobe BRDFs, which are evaluated one direction at a time.
+    auto_release_ptr<Project> create_many_lights_disney_project()
+    {
+        return create_many_lights_project("many_lights_disney", create_disney_brdf);
+    }
+
+    auto_release_ptr<Project> create_many_lights_plastic_project()
+    {
+        return create_many_lights_project("many_lights_plastic", create_plastic_brdf);
+    }
+
+    // A ball covered with curves: stresses curve intersection.
+    auto_release_ptr<Project> create_hair_project()
+    {
+        auto_release_ptr<Project> project(create_empty_project("hair"));
+
+        auto_release_ptr<Assembly> assembly(create_assembly("assembly"));
+
+        insert_object(
+            assembly.ref(),
+            auto_release_ptr<Object>(
+                CurveObjectReader::read(
+                    SearchPaths(),
+                    "hair",
+                    ParamArray()
+                        .insert("filepath", "builtin:furryball")
+                        .insert("curves", HairCurveCount)).release()),
+            Transformd::identity(),
+            "material");
+
+        insert_point_light(assembly.ref(), "light", Vector3d(0.0, 5.0, 5.0), 100.0f);
+
+        insert_assembly(*project->get_scene(), assembly, "assembly_inst");
+
+        return project;
+    }
+
+    // A box filled with a homogeneous participating medium: stresses volume rendering.
+    auto_release_ptr<Project> create_volume_project()
+    {
+        auto_release_ptr<Project> project(create_empty_project("volume"));
+
+        auto_release_ptr<Assembly> assembly(create_assembly("assembly"));
+
+        assembly->volumes().insert(
+            GenericVolumeFactory().create(
+                "volume",
+                ParamArray()
+                    .insert("absorption", 0.2f)
+                    .insert("scattering", 0.8f)
+                    .insert("phase_function_model", "henyey")
+                    .insert("average_cosine", 0.3f)));
+
+        assembly->materials().insert(
+            GenericMaterialFactory().create(
+                "volume_material",
+                ParamArray()
+                    .insert("surface_shader", "physical_shader")
+                    .insert("volume", "volume")));
+
+        insert_object(
+            assembly.ref(),
+            auto_release_ptr<Object>(
+                create_primitive_mesh(
+                    "box",
+                    ParamArray()
+                        .insert("primitive", "cube")).release()),
+            Transformd::identity(),
+            "volume_material");
+
+        insert_point_light(assembly.ref(), "light", Vector3d(0.0, 5.0, 5.0), 100.0f);
+
+        insert_assembly(*project->get_scene(), assembly, "assembly_inst");
+
+        return project;
+    }
+
+    struct SceneDefinition
+    {
+        const char*             m_name;
+        CreateProjectFunction   m_create_project;
+    };
+
+    const SceneDefinition Scenes[] =
+    {
+        { "CornellBox",         create_cornell_box_project },
+        { "Default",            create_default_project },
+        { "HeavyInstancing",    create_heavy_instancing_project },
+        { "ManyLights",         create_many_lights_project },
+        { "ManyLightsDisney",   create_many_lights_disney_project },
+        { "ManyLightsPlastic",  create_many_lights_plastic_project },
+        { "Hair",               create_hair_project },
+        { "Volume",             create_volume_project }
+    };
+
+
+    //
+    // Benchmark cases.
+    //
+
+    // Base class for the benchmark cases of this suite.
+    class SceneBenchmarkCase
+      : public IBenchmarkCase
+    {
+      public:
+        explicit SceneBenchmarkCase(const std::string& name)
+          : m_name(name)
+          , m_initial_memory_size(System::get_process_resident_memory_size())
+        {
+        }
+
+        const char* get_name() const override
+        {
+            return m_name.c_str();
+        }
+
+        std::uint64_t get_memory_size() const override
+        {
+            const std::uint64_t memory_size = System::get_process_resident_memory_size();
+            return memory_size > m_initial_memory_size ? memory_size - m_initial_memory_size : 0;
+        }
+
+      private:
+        const std::string   m_name;
+        const std::uint64_t m_initial_memory_size;
+    };
+
+    // Return the rendering parameters used by the TimeToFirstPixel and Render cases.
+    ParamArray get_render_params(const Project& project, const size_t thread_count)
+    {
+        ParamArray params = project.configurations().get_by_name("final")->get_inherited_parameters();
+        params.insert_path("uniform_pixel_renderer.samples", SamplesPerPixel);
+        params.insert("rendering_threads", thread_count);
+        return params;
+    }
+
+    // Return the rendering parameters used by the RenderWavefront cases.
+    template <bool RaySorting>
+    ParamArray get_wavefront_render_params(const Project& project, const size_t thread_count)
+    {
+        ParamArray params = get_render_params(project, thread_count);
+        params.insert("sample_renderer", "wavefront");
+        params.insert_path("wavefront_sample_renderer.ray_sorting", RaySorting);
+        return params;
+    }
+
+    // Prepare the scene of a project for ray tracing, the same way the master renderer does.
+    class PreparedProject
+      : public NonCopyable
+    {
+      public:
+        explicit PreparedProject(CreateProjectFunction create_project)
+          : m_project(create_project())
+        {
+            const Scene& scene = *m_project->get_scene();
+
+            InputBinder input_binder(scene);
+            input_binder.bind();
+            assert(input_binder.get_error_count() == 0);
+
+#ifndef NDEBUG
+            bool success =
+#endif
+                m_project->get_scene()->on_render_begin(m_project.ref(), nullptr, m_render_begin_recorder);
+            assert(success);
+
+#ifndef NDEBUG
+            success =
+#endif
+                m_project->get_scene()->on_frame_begin(m_project.ref(), nullptr, m_frame_begin_recorder);
+            assert(success);
+        }
+
+        ~PreparedProject()
+        {
+            m_frame_begin_recorder.on_frame_end(m_project.ref());
+            m_render_begin_recorder.on_render_end(m_project.ref());
+        }
+
+        const Scene& get_scene() const
+        {
+            return *m_project->get_scene();
+        }
+
+      private:
+        auto_release_ptr<Project>   m_project;
+        OnRenderBeginRecorder       m_render_begin_recorder;
+        OnFrameBeginRecorder        m_frame_begin_recorder;
+    };
+
+    class BuildTraceContextBenchmarkCase
+      : public SceneBenchmarkCase
+    {
+      public:
+        BuildTraceContextBenchmarkCase(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count)
+          : SceneBenchmarkCase(name)
+          , m_prepared_project(create_project)
+        {
+        }
+
+        void run() override
+        {
+            TraceContext trace_context(m_prepared_project.get_scene());
+            trace_context.update();
+        }
+
+      private:
+        PreparedProject m_prepared_project;
+    };
+
+    class TraceRaysBenchmarkCase
+      : public SceneBenchmarkCase
+    {
+      public:
+        TraceRaysBenchmarkCase(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count)
+          : SceneBenchmarkCase(name)
+          , m_prepared_project(create_project)
+          , m_trace_context(m_prepared_project.get_scene())
+          , m_texture_store(m_prepared_project.get_scene())
+          , m_texture_cache(m_texture_store)
+          , m_intersector(m_trace_context, m_texture_cache)
+          , m_hit_count(0)
+        {
+            m_trace_context.update();
+
+            // Shoot rays from the bounding sphere of the scene toward random points inside it.
+            const Scene::RenderData& render_data = m_prepared_project.get_scene().get_render_data();
+            const Vector3d center(render_data.m_center);
+            const double radius = render_data.m_radius > 0.0 ? static_cast<double>(render_data.m_radius) : 1.0;
+
+            MersenneTwister rng;
+            m_rays.reserve(RayCount);
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                const Vector3d origin =
+                    center + radius * sample_sphere_uniform(rand_vector2<Vector2d>(rng));
+                const Vector3d target =
+                    center + 0.5 * radius * rand_double1(rng) * sample_sphere_uniform(rand_vector2<Vector2d>(rng));
+
+                m_rays.emplace_back(
+                    origin,
+                    normalize(target - origin),
+                    ShadingRay::Time(),
+                    VisibilityFlags::CameraRay,
+                    0);                             // depth
+            }
+        }
+
+        void run() override
+        {
+            for (const ShadingRay& ray : m_rays)
+            {
+                m_shading_point.clear();
+
+                if (m_intersector.trace(ray, m_shading_point))
+                    ++m_hit_count;
+            }
+        }
+
+        size_t get_iteration_count() const override
+        {
+            return m_rays.size();
+        }
+
+      protected:
+        PreparedProject             m_prepared_project;
+        TraceContext                m_trace_context;
+        TextureStore                m_texture_store;
+        TextureCache                m_texture_cache;
+        Intersector                 m_intersector;
+        std::vector<ShadingRay>     m_rays;
+        ShadingPoint                m_shading_point;
+        size_t                      m_hit_count;
+    };
+
+    // Trace the same rays as TraceRays, in the order of their ray sorting keys.
+    // Computing and sorting the keys is part of the measured time.
+    class TraceSortedRaysBenchmarkCase
+      : public TraceRaysBenchmarkCase
+    {
+      public:
+        TraceSortedRaysBenchmarkCase(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count)
+          : TraceRaysBenchmarkCase(name, create_project, thread_count)
+          , m_ray_sort_key(AABB3d(m_prepared_project.get_scene().get_render_data().m_bbox))
+        {
+            m_ray_keys.reserve(m_rays.size());
+        }
+
+        void run() override
+        {
+            m_ray_keys.clear();
+            for (size_t i = 0, e = m_rays.size(); i < e; ++i)
+                m_ray_keys.emplace_back(m_ray_sort_key(m_rays[i].m_org, m_rays[i].m_dir), i);
+            std::sort(m_ray_keys.begin(), m_ray_keys.end());
+
+            for (const RayKey& ray_key : m_ray_keys)
+            {
+                m_shading_point.clear();
+
+                if (m_intersector.trace(m_rays[ray_key.second], m_shading_point))
+                    ++m_hit_count;
+            }
+        }
+
+      private:
+        typedef std::pair<std::uint64_t, size_t> RayKey;
+
+        const RaySortKeyGenerator<double>   m_ray_sort_key;
+        std::vector<RayKey>                 m_ray_keys;
+    };
+
+    class TimeToFirstPixelBenchmarkCase
+      : public SceneBenchmarkCase
+    {
+      public:
+        TimeToFirstPixelBenchmarkCase(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count)
+          : SceneBenchmarkCase(name)
+          , m_create_project(create_project)
+          , m_thread_count(thread_count)
+          , m_tile_rendered(false)
+          , m_tile_callback_factory(new TileCallbackFactory(m_tile_rendered))
+        {
+        }
+
+        bool is_multithreaded() const override
+        {
+            return true;
+        }
+
+        void run() override
+        {
+            m_tile_rendered = false;
+
+            auto_release_ptr<Project> project(m_create_project());
+
+            MasterRenderer renderer(
+                project.ref(),
+                get_render_params(project.ref(), m_thread_count),
+                SearchPaths(),
+                m_tile_callback_factory.get());
+
+            RendererController renderer_controller(m_tile_rendered);
+            renderer.render(renderer_controller);
+        }
+
+      private:
+        // Raise a flag as soon as a tile has been rendered.
+        class TileCallback
+          : public TileCallbackBase
+        {
+          public:
+            explicit TileCallback(std::atomic<bool>& tile_rendered)
+              : m_tile_rendered(tile_rendered)
+            {
+            }
+
+            void release() override
+            {
+                delete this;
+            }
+
+            void on_tile_end(
+                const Frame*            frame,
+                const size_t            tile_x,
+                const size_t            tile_y) override
+            {
+                m_tile_rendered = true;
+            }
+
+          private:
+            std::atomic<bool>& m_tile_rendered;
+        };
+
+        class TileCallbackFactory
+          : public ITileCallbackFactory
+        {
+          public:
+            explicit TileCallbackFactory(std::atomic<bool>& tile_rendered)
+              : m_tile_rendered(tile_rendered)
+            {
+            }
+
+            void release() override
+            {
+                delete this;
+            }
+
+            ITileCallback* create() override
+            {
+                return new TileCallback(m_tile_rendered);
+            }
+
+          private:
+            std::atomic<bool>& m_tile_rendered;
+        };
+
+        // Stop rendering as soon as a tile has been rendered.
+        class RendererController
+          : public DefaultRendererController
+        {
+          public:
+            explicit RendererController(const std::atomic<bool>& tile_rendered)
+              : m_tile_rendered(tile_rendered)
+            {
+            }
+
+            Status get_status() const override
+            {
+                return m_tile_rendered ? TerminateRendering : ContinueRendering;
+            }
+
+          private:
+            const std::atomic<bool>& m_tile_rendered;
+        };
+
+        const CreateProjectFunction             m_create_project;
+        const size_t                            m_thread_count;
+        std::atomic<bool>                       m_tile_rendered;
+        auto_release_ptr<ITileCallbackFactory>  m_tile_callback_factory;
+    };
+
+    typedef ParamArray (*GetRenderParamsFunction)(const Project&, const size_t);
+
+    class RenderBenchmarkCase
+      : public SceneBenchmarkCase
+    {
+      public:
+        RenderBenchmarkCase(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count,
+            GetRenderParamsFunction get_params = get_render_params)
+          : SceneBenchmarkCase(name)
+          , m_project(create_project())
+          , m_renderer(
+                m_project.ref(),
+                get_params(m_project.ref(), thread_count),
+                SearchPaths())
+        {
+        }
+
+        bool is_multithreaded() const override
+        {
+            return true;
+        }
+
+        void run() override
+        {
+            m_renderer.render(m_renderer_controller);
+        }
+
+        size_t get_iteration_count() const override
+        {
+            return FrameWidth * FrameHeight * SamplesPerPixel;
+        }
+
+      private:
+        auto_release_ptr<Project>   m_project;
+        MasterRenderer              m_renderer;
+        DefaultRendererController   m_renderer_controller;
+    };
+
+    template <bool RaySorting>
+    class WavefrontRenderBenchmarkCase
+      : public RenderBenchmarkCase
+    {
+      public:
+        WavefrontRenderBenchmarkCase(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count)
+          : RenderBenchmarkCase(
+                name,
+                create_project,
+                thread_count,
+                get_wavefront_render_params<RaySorting>)
+        {
+        }
+    };
+
+    template <typename BenchmarkCase>
+    class SceneBenchmarkCaseFactory
+      : public IBenchmarkCaseFactory
+    {
+      public:
+        SceneBenchmarkCaseFactory(
+            const std::string&      name,
+            CreateProjectFunction   create_project,
+            const size_t            thread_count)
+          : m_name(name)
+          , m_create_project(create_project)
+          , m_thread_count(thread_count)
+        {
+        }
+
+        const char* get_name() const override
+        {
+            return m_name.c_str();
+        }
+
+        IBenchmarkCase* create() override
+        {
+            return new BenchmarkCase(m_name, m_create_project, m_thread_count);
+        }
+
+      private:
+        const std::string           m_name;
+        const CreateProjectFunction m_create_project;
+        const size_t                m_thread_count;
+    };
+
+    // Register the benchmark cases of all scenes. The BENCHMARK_CASE() macros cannot be
+    // used here since cases are instantiated for every scene and for every thread count.
+    class RegisterBenchmarkCases
+    {
+      public:
+        RegisterBenchmarkCases()
+        {
+            const size_t max_thread_count = std::max<size_t>(System::get_logical_cpu_core_count(), 1);
+
+            for (const SceneDefinition& scene : Scenes)
+            {
+                register_case<BuildTraceContextBenchmarkCase>(scene, "BuildTraceContext", 1);
+                register_case<TraceRaysBenchmarkCase>(scene, "TraceRays", 1);
+                register_case<TraceSortedRaysBenchmarkCase>(scene, "TraceSortedRays", 1);
+                register_case<TimeToFirstPixelBenchmarkCase>(scene, "TimeToFirstPixel", max_thread_count);
+
+                // Render with 1, 2, 4... rendering threads, up to the number of logical cores.
+                for (size_t thread_count = 1; ; thread_count *= 2)
+                {
+                    thread_count = std::min(thread_count, max_thread_count);
+
+                    register_case<RenderBenchmarkCase>(
+                        scene,
+                        format("Render_{0}{1}", thread_count, thread_count > 1 ? "Threads" : "Thread"),
+                        thread_count);
+
+                    if (thread_count == max_thread_count)
+                        break;
+                }
+
+                // Compare the wavefront sample renderer with and without ray sorting on a single thread.
+                register_case<WavefrontRenderBenchmarkCase<false>>(scene, "RenderWavefront", 1);
+                register_case<WavefrontRenderBenchmarkCase<true>>(scene, "RenderWavefrontSorted", 1);
+            }
+        }
+
+      private:
+        std::vector<std::unique_ptr<IBenchmarkCaseFactory>> m_factories;
+
+        template <typename BenchmarkCase>
+        void register_case(
+            const SceneDefinition&  scene,
+            const std::string&      case_name,
+            const size_t            thread_count)
+        {
+            m_factories.emplace_back(
+                new SceneBenchmarkCaseFactory<BenchmarkCase>(
+                    std::string(scene.m_name) + "_" + case_name,
+                    scene.m_create_project,
+                    thread_count));
+
+            current_benchmark_suite__().register_case(m_factories.back().get());
+        }
+    };
+
+    static RegisterBenchmarkCases RegisterBenchmarkCases_instance__;
+}
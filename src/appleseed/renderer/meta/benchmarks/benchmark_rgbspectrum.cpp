@@ -0,0 +1,87 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/utility/rgbspectrum.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+// The same cases as in Renderer_Utility_DynamicSpectrum31f, for comparison with RGB-only builds.
+BENCHMARK_SUITE(Renderer_Utility_RGBSpectrumf)
+{
+    struct Fixture
+    {
+        RGBSpectrumf    m_black;
+        RGBSpectrumf    m_white;
+        RGBSpectrumf    m_arithmetic_result;
+        RGBSpectrumf    m_components[8];        // as many spectra as in ShadingComponents
+        RGBSpectrumf    m_copied_components[8];
+        RGBSpectrumf    m_throughput;
+        RGBSpectrumf    m_bsdf_value;
+        RGBSpectrumf    m_emission;
+        RGBSpectrumf    m_radiance;
+
+        Fixture()
+          : m_black(0.0f)
+          , m_white(1.0f)
+          , m_arithmetic_result(0.0f)
+          , m_throughput(1.0f)
+          , m_bsdf_value(0.5f)
+          , m_emission(0.01f)
+          , m_radiance(0.0f)
+        {
+            for (size_t i = 0; i < 8; ++i)
+                m_components[i] = RGBSpectrumf(static_cast<float>(i));
+        }
+    };
+
+    BENCHMARK_CASE_F(Arithmetic, Fixture)
+    {
+        m_arithmetic_result = (m_arithmetic_result + m_white) * m_white - m_black * 0.5f;
+    }
+
+    BENCHMARK_CASE_F(Copy, Fixture)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_copied_components[i] = m_components[i];
+    }
+
+    // Throughput update and radiance accumulation of one path tracer bounce.
+    BENCHMARK_CASE_F(PathBounce, Fixture)
+    {
+        m_throughput *= m_bsdf_value;
+        m_throughput /= 0.5f;
+        madd(m_radiance, m_throughput, m_emission);
+    }
+}
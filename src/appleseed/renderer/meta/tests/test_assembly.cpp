@@ -30,6 +30,7 @@
 // appleseed.renderer headers.
 #include "renderer/global/globaltypes.h"
 #include "renderer/modeling/object/object.h"
+#include "renderer/modeling/scene/archiveassembly.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
 #include "renderer/modeling/scene/containers.h"
@@ -44,6 +45,7 @@
 #include "foundation/math/transform.h"
 #include "foundation/memory/autoreleaseptr.h"
 #include "foundation/utility/iostreamop.h"
+#include "foundation/utility/searchpaths.h"
 #include "foundation/utility/test.h"
 
 using namespace foundation;
@@ -120,3 +122,41 @@ TEST_SUITE(Renderer_Modeling_Scene_Assembly)
         EXPECT_EQ(GAABB3::invalid(), local_bbox);
     }
 }
+
+TEST_SUITE(Renderer_Modeling_Scene_ArchiveAssembly)
+{
+    TEST_CASE(LoadArchive_GivenMissingFile_DoesNotNeedLoadingAnymore)
+    {
+        auto_release_ptr<Assembly> assembly(
+            ArchiveAssemblyFactory().create(
+                "archive",
+                ParamArray()
+                    .insert("filename", "unit tests/inputs/test_assembly_missingarchive.appleseed")));
+        ArchiveAssembly& archive = static_cast<ArchiveAssembly&>(assembly.ref());
+
+        EXPECT_TRUE(archive.needs_loading());
+
+        archive.load_archive(SearchPaths(), 0);
+
+        EXPECT_FALSE(archive.needs_loading());
+    }
+
+    TEST_CASE(UpdateAssetPaths_AfterFailedLoad_NeedsLoadingAgain)
+    {
+        auto_release_ptr<Assembly> assembly(
+            ArchiveAssemblyFactory().create(
+                "archive",
+                ParamArray()
+                    .insert("filename", "unit tests/inputs/test_assembly_missingarchive.appleseed")));
+        ArchiveAssembly& archive = static_cast<ArchiveAssembly&>(assembly.ref());
+
+        archive.load_archive(SearchPaths(), 0);
+        archive.update_asset_paths(
+            StringDictionary()
+                .insert(
+                    "unit tests/inputs/test_assembly_missingarchive.appleseed",
+                    "unit tests/inputs/test_assembly_otherarchive.appleseed"));
+
+        EXPECT_TRUE(archive.needs_loading());
+    }
+}
@@ -0,0 +1,155 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/defaultrenderercontroller.h"
+#include "renderer/kernel/rendering/masterrenderer.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/light/light.h"
+#include "renderer/modeling/light/pointlight.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/project/configuration.h"
+#include "renderer/modeling/project/configurationcontainer.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/memory/autoreleaseptr.h"
+#include "foundation/string/string.h"
+#include "foundation/utility/searchpaths.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_DirectLightingIntegrator)
+{
+    // Add a grid of point lights below the ceiling of the Cornell box, next to its area light.
+    void add_point_lights(Project& project)
+    {
+        Assembly* assembly = project.get_scene()->assemblies().get_by_name("assembly");
+        assert(assembly != nullptr);
+
+        const size_t GridSize = 4;
+
+        for (size_t z = 0; z < GridSize; ++z)
+        {
+            for (size_t x = 0; x < GridSize; ++x)
+            {
+                auto_release_ptr<Light> light(
+                    PointLightFactory().create(
+                        format("light_{0}_{1}", x, z).c_str(),
+                        ParamArray()
+                            .insert("intensity", 0.01f * (1 + x + GridSize * z))));
+                light->set_transform(
+                    Transformd::from_local_to_parent(
+                        Matrix4d::make_translation(
+                            Vector3d(
+                                0.1 + 0.12 * x,
+                                0.5,
+                                0.1 + 0.12 * z))));
+                assembly->lights().insert(light);
+            }
+        }
+    }
+
+    // Render a small Cornell box lit by many lights and return the average pixel color.
+    Color3f render_average_color(const size_t light_candidate_count)
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+        add_point_lights(project.ref());
+
+        project->set_frame(
+            FrameFactory::create(
+                "beauty",
+                ParamArray()
+                    .insert("camera", "camera")
+                    .insert("resolution", "32 32")));
+
+        ParamArray params = project->configurations().get_by_name("final")->get_inherited_parameters();
+        params.insert_path("uniform_pixel_renderer.samples", 64);
+        params.insert_path("light_sampler.algorithm", "lighttree");
+        params.insert_path("pt.max_bounces", 1);
+        params.insert_path("pt.dl_light_candidates", light_candidate_count);
+
+        MasterRenderer renderer(project.ref(), params, SearchPaths());
+        DefaultRendererController renderer_controller;
+        renderer.render(renderer_controller);
+
+        const Image& image = project->get_frame()->image();
+        const CanvasProperties& props = image.properties();
+
+        Color3f sum(0.0f);
+
+        for (size_t y = 0; y < props.m_canvas_height; ++y)
+        {
+            for (size_t x = 0; x < props.m_canvas_width; ++x)
+            {
+                Color4f color;
+                image.get_pixel(x, y, color);
+                sum += color.rgb();
+            }
+        }
+
+        return sum / static_cast<float>(props.m_pixel_count);
+    }
+
+    // Resampled importance sampling must not change the expected image, only its noise.
+    void expect_same_average_color(const Color3f& expected, const Color3f& actual)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            EXPECT_FEQ_EPS(expected[i], actual[i], 0.03f);
+    }
+
+    TEST_CASE(Render_GivenManyLightsAndOneLightCandidate_MatchesRenderWithoutResampling)
+    {
+        const Color3f expected = render_average_color(0);
+        const Color3f actual = render_average_color(1);
+
+        expect_same_average_color(expected, actual);
+    }
+
+    TEST_CASE(Render_GivenManyLightsAndEightLightCandidates_MatchesRenderWithoutResampling)
+    {
+        const Color3f expected = render_average_color(0);
+        const Color3f actual = render_average_color(8);
+
+        expect_same_average_color(expected, actual);
+    }
+}
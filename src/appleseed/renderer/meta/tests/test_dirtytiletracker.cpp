@@ -0,0 +1,100 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/dirtytiletracker.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_DirtyTileTracker)
+{
+    TEST_CASE(Constructor_ComputesTileCounts)
+    {
+        const DirtyTileTracker tracker(100, 50, 32, 32);
+
+        EXPECT_EQ(4, tracker.get_tile_count_x());
+        EXPECT_EQ(2, tracker.get_tile_count_y());
+        EXPECT_EQ(8, tracker.get_tile_count());
+    }
+
+    TEST_CASE(Constructor_MarksAllTilesAsDirty)
+    {
+        const DirtyTileTracker tracker(64, 64, 32, 32);
+
+        EXPECT_TRUE(tracker.is_dirty(0, 0));
+        EXPECT_TRUE(tracker.is_dirty(1, 1));
+    }
+
+    TEST_CASE(MarkPixel_MarksTileContainingPixel)
+    {
+        DirtyTileTracker tracker(100, 50, 32, 32);
+        tracker.clear();
+
+        tracker.mark_pixel(99, 40);
+
+        EXPECT_TRUE(tracker.is_dirty(3, 1));
+        EXPECT_FALSE(tracker.is_dirty(2, 1));
+        EXPECT_FALSE(tracker.is_dirty(3, 0));
+    }
+
+    TEST_CASE(FetchAndClear_ReturnsPreviousStateAndMarksTileAsClean)
+    {
+        DirtyTileTracker tracker(64, 64, 32, 32);
+        tracker.clear();
+        tracker.mark_tile(1, 0);
+
+        EXPECT_TRUE(tracker.fetch_and_clear(1, 0));
+        EXPECT_FALSE(tracker.fetch_and_clear(1, 0));
+        EXPECT_FALSE(tracker.is_dirty(1, 0));
+    }
+
+    TEST_CASE(Collect_AppendsIndicesOfDirtyTilesAndMarksThemAsClean)
+    {
+        DirtyTileTracker tracker(96, 64, 32, 32);
+        tracker.clear();
+        tracker.mark_tile(2, 0);
+        tracker.mark_tile(1, 1);
+
+        std::vector<size_t> tiles;
+        const size_t count = tracker.collect(tiles);
+
+        ASSERT_EQ(2, count);
+        ASSERT_EQ(2, tiles.size());
+        EXPECT_EQ(2, tiles[0]);
+        EXPECT_EQ(4, tiles[1]);
+        EXPECT_FALSE(tracker.is_dirty(2, 0));
+        EXPECT_FALSE(tracker.is_dirty(1, 1));
+    }
+}
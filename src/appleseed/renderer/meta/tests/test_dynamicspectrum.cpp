@@ -73,6 +73,81 @@ TEST_SUITE(Renderer_Utility_DynamicSpectrum31f)
         }
     };
 
+    TEST_CASE_F(Arithmetic_RGB, RGBFixture)
+    {
+        DynamicSpectrum31f a, b;
+
+        for (size_t i = 0, e = a.size(); i < e; ++i)
+        {
+            a[i] = static_cast<float>(i + 1);
+            b[i] = static_cast<float>(2 * i + 3);
+        }
+
+        const DynamicSpectrum31f sum = a + b;
+        const DynamicSpectrum31f diff = a - b;
+        const DynamicSpectrum31f prod = a * b;
+        const DynamicSpectrum31f scaled = a * 0.5f;
+
+        DynamicSpectrum31f c = a;
+        c -= b;
+
+        for (size_t i = 0, e = a.size(); i < e; ++i)
+        {
+            EXPECT_EQ(a[i] + b[i], sum[i]);
+            EXPECT_EQ(a[i] - b[i], diff[i]);
+            EXPECT_EQ(a[i] * b[i], prod[i]);
+            EXPECT_EQ(a[i] * 0.5f, scaled[i]);
+            EXPECT_EQ(a[i] - b[i], c[i]);
+        }
+    }
+
+    TEST_CASE_F(Arithmetic_Spectral, SpectralFixture)
+    {
+        DynamicSpectrum31f a, b;
+
+        for (size_t i = 0, e = a.size(); i < e; ++i)
+        {
+            a[i] = static_cast<float>(i + 1);
+            b[i] = static_cast<float>(2 * i + 3);
+        }
+
+        const DynamicSpectrum31f sum = a + b;
+        const DynamicSpectrum31f diff = a - b;
+        const DynamicSpectrum31f prod = a * b;
+        const DynamicSpectrum31f scaled = a * 0.5f;
+
+        DynamicSpectrum31f c = a;
+        c -= b;
+
+        for (size_t i = 0, e = a.size(); i < e; ++i)
+        {
+            EXPECT_EQ(a[i] + b[i], sum[i]);
+            EXPECT_EQ(a[i] - b[i], diff[i]);
+            EXPECT_EQ(a[i] * b[i], prod[i]);
+            EXPECT_EQ(a[i] * 0.5f, scaled[i]);
+            EXPECT_EQ(a[i] - b[i], c[i]);
+        }
+    }
+
+    TEST_CASE_F(Copy_Spectral, SpectralFixture)
+    {
+        DynamicSpectrum31f a;
+
+        for (size_t i = 0, e = a.size(); i < e; ++i)
+            a[i] = static_cast<float>(i + 1);
+
+        const DynamicSpectrum31f b(a);
+
+        DynamicSpectrum31f c(0.0f);
+        c = a;
+
+        for (size_t i = 0, e = a.size(); i < e; ++i)
+        {
+            EXPECT_EQ(a[i], b[i]);
+            EXPECT_EQ(a[i], c[i]);
+        }
+    }
+
     TEST_CASE_F(Lerp_Spectral, SpectralFixture)
     {
         static const float AValues[31] =
@@ -31,6 +31,9 @@
 #include "renderer/modeling/project/project.h"
 #include "renderer/modeling/project/projectfilereader.h"
 #include "renderer/modeling/project/projectfilewriter.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
 
 // appleseed.foundation headers.
 #include "foundation/memory/autoreleaseptr.h"
@@ -42,6 +45,7 @@
 
 // Standard headers.
 #include <exception>
+#include <string>
 
 using namespace foundation;
 using namespace renderer;
@@ -75,6 +79,26 @@ TEST_SUITE(Renderer_Modeling_Project_ProjectFileReader)
         EXPECT_TRUE(identical);
     }
 
+    TEST_CASE(DeferredObjectLoading_PreservesDeclarationOrder)
+    {
+        auto_release_ptr<Project> project =
+            ProjectFileReader::read(
+                "unit tests/inputs/test_projectfilereader_deferredobjectloading.appleseed",
+                "../../../schemas/project.xsd");            // path relative to input file
+
+        ASSERT_NEQ(0, project.get());
+
+        const Assembly* assembly = project->get_scene()->assemblies().get_by_name("assembly");
+        ASSERT_NEQ(0, assembly);
+
+        const ObjectContainer& objects = assembly->objects();
+        ASSERT_EQ(4, objects.size());
+        EXPECT_EQ("first.0", std::string(objects.get_by_index(0)->get_name()));
+        EXPECT_EQ("box", std::string(objects.get_by_index(1)->get_name()));
+        EXPECT_EQ("second.quad", std::string(objects.get_by_index(2)->get_name()));
+        EXPECT_EQ("third.0", std::string(objects.get_by_index(3)->get_name()));
+    }
+
     TEST_CASE(ReadValidPackedProject)
     {
         const char* UnpackDirectory = "unit tests/inputs/test_projectfilereader_validpackedproject.unpacked/";
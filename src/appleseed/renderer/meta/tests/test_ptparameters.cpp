@@ -0,0 +1,113 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/kernel/lighting/pt/ptparameters.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_PT_PTParameters)
+{
+    TEST_CASE(Constructor_GivenEmptyParamArray_UsesDefaultBounceLimits)
+    {
+        const PTParameters params((ParamArray()));
+
+        EXPECT_EQ(8, params.m_max_bounces);
+        EXPECT_EQ(3, params.m_max_diffuse_bounces);
+        EXPECT_EQ(8, params.m_max_glossy_bounces);
+        EXPECT_EQ(8, params.m_max_specular_bounces);
+        EXPECT_EQ(8, params.m_max_volume_bounces);
+        EXPECT_EQ(6, params.m_rr_min_path_length);
+    }
+
+    TEST_CASE(Constructor_GivenMinusOneBounces_MakesBouncesUnlimited)
+    {
+        const PTParameters params(
+            ParamArray()
+                .insert("max_bounces", -1)
+                .insert("max_diffuse_bounces", -1)
+                .insert("max_volume_bounces", -1));
+
+        EXPECT_EQ(~std::size_t(0), params.m_max_bounces);
+        EXPECT_EQ(~std::size_t(0), params.m_max_diffuse_bounces);
+        EXPECT_EQ(~std::size_t(0), params.m_max_volume_bounces);
+    }
+
+    TEST_CASE(Constructor_GivenZeroRussianRouletteStart_DisablesRussianRoulette)
+    {
+        const PTParameters params(ParamArray().insert("rr_min_path_length", 0));
+
+        EXPECT_EQ(~std::size_t(0), params.m_rr_min_path_length);
+    }
+
+    TEST_CASE(Constructor_GivenFractionalLightSampleCount_ComputesReciprocal)
+    {
+        const PTParameters params(
+            ParamArray()
+                .insert("dl_light_samples", 0.5f)
+                .insert("ibl_env_samples", 2.0f));
+
+        EXPECT_FEQ(2.0f, params.m_rcp_dl_light_sample_count);
+        EXPECT_EQ(0.0f, params.m_rcp_ibl_env_sample_count);
+    }
+
+    TEST_CASE(Constructor_GivenLightCandidateCount_EnablesResampling)
+    {
+        EXPECT_EQ(0, PTParameters(ParamArray()).m_dl_light_candidate_count);
+        EXPECT_EQ(16, PTParameters(ParamArray().insert("dl_light_candidates", 16)).m_dl_light_candidate_count);
+    }
+
+    TEST_CASE(GetPathTracerMaxBounces_GivenFiniteLimits_CountsCameraVertex)
+    {
+        const PTParameters params(
+            ParamArray()
+                .insert("max_bounces", 4)
+                .insert("max_diffuse_bounces", 0));
+
+        EXPECT_EQ(5, params.get_path_tracer_max_bounces());
+        EXPECT_EQ(1, params.get_path_tracer_max_diffuse_bounces());
+    }
+
+    TEST_CASE(GetPathTracerMaxBounces_GivenUnlimitedBounces_ReturnsUnlimited)
+    {
+        const PTParameters params(
+            ParamArray()
+                .insert("max_bounces", -1)
+                .insert("max_diffuse_bounces", -1));
+
+        EXPECT_EQ(~std::size_t(0), params.get_path_tracer_max_bounces());
+        EXPECT_EQ(~std::size_t(0), params.get_path_tracer_max_diffuse_bounces());
+    }
+}
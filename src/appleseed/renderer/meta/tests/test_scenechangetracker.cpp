@@ -0,0 +1,146 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/scenechangetracker.h"
+#include "renderer/modeling/camera/pinholecamera.h"
+#include "renderer/modeling/light/light.h"
+#include "renderer/modeling/light/pointlight.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/shadergroup/shadergroup.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/memory/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_SceneChangeTracker)
+{
+    struct Fixture
+    {
+        auto_release_ptr<Project>   m_project;
+        Scene*                      m_scene;
+        Assembly*                   m_assembly;
+        ParamArray                  m_params;
+        SceneChangeTracker          m_tracker;
+
+        Fixture()
+          : m_project(ProjectFactory::create("project"))
+        {
+            m_project->set_scene(SceneFactory::create());
+            m_scene = m_project->get_scene();
+            m_scene->cameras().insert(PinholeCameraFactory().create("camera", ParamArray()));
+
+            m_scene->assemblies().insert(AssemblyFactory().create("assembly", ParamArray()));
+            m_assembly = m_scene->assemblies().get_by_name("assembly");
+            m_assembly->lights().insert(PointLightFactory().create("light", ParamArray()));
+
+            m_scene->shader_groups().insert(ShaderGroupFactory::create("shader_group"));
+
+            m_params.insert("passes", 1);
+
+            m_tracker.update(m_project.ref(), m_params);
+        }
+    };
+
+    TEST_CASE_F(Update_FirstCall_ReportsEverythingAsRestructured, Fixture)
+    {
+        for (size_t i = 0; i < SceneChangeTracker::CategoryCount; ++i)
+        {
+            const SceneChangeTracker::Category category = static_cast<SceneChangeTracker::Category>(i);
+            EXPECT_EQ(SceneChangeTracker::Restructured, m_tracker.get_change(category));
+        }
+    }
+
+    TEST_CASE_F(Update_GivenNoChange_ReportsNoChange, Fixture)
+    {
+        m_tracker.update(m_project.ref(), m_params);
+
+        EXPECT_FALSE(m_tracker.has_changes());
+        EXPECT_EQ("none", m_tracker.to_string());
+    }
+
+    TEST_CASE_F(Update_GivenLightModifiedInPlace_ReportsLightsAsModified, Fixture)
+    {
+        m_assembly->lights().get_by_name("light")->bump_version_id();
+
+        m_tracker.update(m_project.ref(), m_params);
+
+        EXPECT_EQ(SceneChangeTracker::Modified, m_tracker.get_change(SceneChangeTracker::Lights));
+        EXPECT_EQ(SceneChangeTracker::Unchanged, m_tracker.get_change(SceneChangeTracker::Cameras));
+        EXPECT_EQ(SceneChangeTracker::Unchanged, m_tracker.get_change(SceneChangeTracker::Geometry));
+        EXPECT_EQ("lights (modified)", m_tracker.to_string());
+    }
+
+    TEST_CASE_F(Update_GivenLightReplaced_ReportsLightsAsRestructured, Fixture)
+    {
+        m_assembly->lights().remove(m_assembly->lights().get_by_name("light"));
+        m_assembly->lights().insert(PointLightFactory().create("light", ParamArray()));
+
+        m_tracker.update(m_project.ref(), m_params);
+
+        EXPECT_EQ(SceneChangeTracker::Restructured, m_tracker.get_change(SceneChangeTracker::Lights));
+    }
+
+    TEST_CASE_F(Update_GivenShaderAddedToShaderGroup_ReturnsModifiedShaderGroup, Fixture)
+    {
+        ShaderGroup* shader_group = m_scene->shader_groups().get_by_name("shader_group");
+        shader_group->add_shader("surface", "as_closure2surface", "layer", ParamArray());
+
+        m_tracker.update(m_project.ref(), m_params);
+
+        EXPECT_EQ(SceneChangeTracker::Modified, m_tracker.get_change(SceneChangeTracker::ShaderGroups));
+        ASSERT_EQ(1, m_tracker.get_modified_shader_groups().size());
+        EXPECT_EQ(shader_group, m_tracker.get_modified_shader_groups()[0]);
+    }
+
+    TEST_CASE_F(Update_GivenModifiedParameters_ReportsSettingsAsModified, Fixture)
+    {
+        m_params.insert("passes", 2);
+
+        m_tracker.update(m_project.ref(), m_params);
+
+        EXPECT_EQ(SceneChangeTracker::Modified, m_tracker.get_change(SceneChangeTracker::Settings));
+        EXPECT_EQ("settings (modified)", m_tracker.to_string());
+    }
+
+    TEST_CASE_F(Update_AfterClear_ReportsEverythingAsRestructured, Fixture)
+    {
+        m_tracker.clear();
+
+        m_tracker.update(m_project.ref(), m_params);
+
+        EXPECT_EQ(SceneChangeTracker::Restructured, m_tracker.get_change(SceneChangeTracker::Cameras));
+        EXPECT_EQ(SceneChangeTracker::Restructured, m_tracker.get_change(SceneChangeTracker::Settings));
+    }
+}
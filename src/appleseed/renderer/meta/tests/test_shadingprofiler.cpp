@@ -0,0 +1,152 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/kernel/shading/shadingprofiler.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Shading_ShadingProfiler)
+{
+    TEST_CASE(Scope_GivenNoCountersBoundToThread_RecordsNothing)
+    {
+        ShadingProfiler profiler;
+        profiler.create_thread_counters();
+
+        {
+            const ShadingProfiler::Scope scope(ShadingProfiler::ShaderExecution, nullptr, nullptr);
+        }
+
+        EXPECT_TRUE(profiler.get_entries().empty());
+    }
+
+    TEST_CASE(Scope_GivenCountersBoundToThread_RecordsOneCall)
+    {
+        ShadingProfiler profiler;
+        const ShadingProfiler::Binding binding(profiler.create_thread_counters());
+
+        {
+            const ShadingProfiler::Scope scope(ShadingProfiler::RayTracing, nullptr, nullptr);
+        }
+
+        const std::vector<ShadingProfiler::Entry> entries = profiler.get_entries();
+
+        ASSERT_EQ(1, entries.size());
+        EXPECT_EQ(ShadingProfiler::RayTracing, entries[0].m_category);
+        EXPECT_EQ(1, entries[0].m_calls);
+    }
+
+    TEST_CASE(Scope_GivenNestedScope_AttributesNestedTimeToInnermostScopeOnly)
+    {
+        ShadingProfiler profiler;
+        const ShadingProfiler::Binding binding(profiler.create_thread_counters());
+
+        {
+            const ShadingProfiler::Scope outer_scope(ShadingProfiler::ShaderExecution, nullptr, nullptr);
+            const ShadingProfiler::Scope inner_scope(ShadingProfiler::RayTracing, nullptr, nullptr);
+            foundation::sleep(10);
+        }
+
+        const std::vector<ShadingProfiler::Entry> entries = profiler.get_entries();
+
+        // Entries are sorted by decreasing time.
+        ASSERT_EQ(2, entries.size());
+        EXPECT_EQ(ShadingProfiler::RayTracing, entries[0].m_category);
+        EXPECT_EQ(ShadingProfiler::ShaderExecution, entries[1].m_category);
+        EXPECT_GT(0.005, entries[0].m_time);
+        EXPECT_LT(0.005, entries[1].m_time);
+    }
+
+    TEST_CASE(GetEntries_GivenCountersOfTwoThreads_MergesIdenticalKeys)
+    {
+        ShadingProfiler profiler;
+        ShadingProfiler::ThreadCounters* counters1 = profiler.create_thread_counters();
+        ShadingProfiler::ThreadCounters* counters2 = profiler.create_thread_counters();
+
+        {
+            const ShadingProfiler::Binding binding(counters1);
+            const ShadingProfiler::Scope scope(ShadingProfiler::BSDFSampling, nullptr, nullptr);
+        }
+
+        {
+            const ShadingProfiler::Binding binding(counters2);
+            const ShadingProfiler::Scope scope(ShadingProfiler::BSDFSampling, nullptr, nullptr);
+        }
+
+        const std::vector<ShadingProfiler::Entry> entries = profiler.get_entries();
+
+        ASSERT_EQ(1, entries.size());
+        EXPECT_EQ(2, entries[0].m_calls);
+    }
+
+    TEST_CASE(Clear_DiscardsRecordedEntries)
+    {
+        ShadingProfiler profiler;
+        const ShadingProfiler::Binding binding(profiler.create_thread_counters());
+
+        {
+            const ShadingProfiler::Scope scope(ShadingProfiler::ShaderExecution, nullptr, nullptr);
+        }
+
+        profiler.clear();
+
+        EXPECT_TRUE(profiler.get_entries().empty());
+    }
+
+    TEST_CASE(GetThreadCategoryTimes_GivenNoCountersBoundToThread_ReturnsFalse)
+    {
+        double times[ShadingProfiler::CategoryCount];
+
+        EXPECT_FALSE(ShadingProfiler::get_thread_category_times(times));
+    }
+
+    TEST_CASE(GetThreadCategoryTimes_GivenCountersBoundToThread_ReturnsTimeSpentInEachCategory)
+    {
+        ShadingProfiler profiler;
+        const ShadingProfiler::Binding binding(profiler.create_thread_counters());
+
+        {
+            const ShadingProfiler::Scope scope(ShadingProfiler::BSDFSampling, nullptr, nullptr);
+            foundation::sleep(10);
+        }
+
+        double times[ShadingProfiler::CategoryCount];
+        ASSERT_TRUE(ShadingProfiler::get_thread_category_times(times));
+
+        EXPECT_EQ(0.0, times[ShadingProfiler::ShaderExecution]);
+        EXPECT_EQ(0.0, times[ShadingProfiler::RayTracing]);
+        EXPECT_GT(0.005, times[ShadingProfiler::BSDFSampling]);
+    }
+}
@@ -0,0 +1,119 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/defaultrenderercontroller.h"
+#include "renderer/kernel/rendering/masterrenderer.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/project/configuration.h"
+#include "renderer/modeling/project/configurationcontainer.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/memory/autoreleaseptr.h"
+#include "foundation/utility/searchpaths.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_WavefrontSampleRenderer)
+{
+    // Render a small Cornell box with a given sample renderer and return the average pixel color.
+    Color3f render_average_color(
+        const char*     sample_renderer,
+        const bool      staged_path_tracing)
+    {
+        auto_release_ptr<Project> project(CornellBoxProjectFactory::create());
+
+        project->set_frame(
+            FrameFactory::create(
+                "beauty",
+                ParamArray()
+                    .insert("camera", "camera")
+                    .insert("resolution", "32 32")));
+
+        ParamArray params = project->configurations().get_by_name("final")->get_inherited_parameters();
+        params.insert("sample_renderer", sample_renderer);
+        params.insert_path("uniform_pixel_renderer.samples", 64);
+        params.insert_path("pt.max_bounces", 4);
+        params.insert_path("wavefront_sample_renderer.staged_path_tracing", staged_path_tracing);
+
+        MasterRenderer renderer(project.ref(), params, SearchPaths());
+        DefaultRendererController renderer_controller;
+        renderer.render(renderer_controller);
+
+        const Image& image = project->get_frame()->image();
+        const CanvasProperties& props = image.properties();
+
+        Color3f sum(0.0f);
+
+        for (size_t y = 0; y < props.m_canvas_height; ++y)
+        {
+            for (size_t x = 0; x < props.m_canvas_width; ++x)
+            {
+                Color4f color;
+                image.get_pixel(x, y, color);
+                sum += color.rgb();
+            }
+        }
+
+        return sum / static_cast<float>(props.m_pixel_count);
+    }
+
+    // Both sample renderers must be unbiased estimators of the same image, so their average
+    // pixel colors must agree up to Monte Carlo noise (about 0.5% at 65536 samples per image).
+    void expect_same_average_color(const Color3f& expected, const Color3f& actual)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            EXPECT_FEQ_EPS(expected[i], actual[i], 0.03f);
+    }
+
+    TEST_CASE(Render_GivenCornellBoxAndStagedPathTracing_MatchesGenericSampleRenderer)
+    {
+        const Color3f expected = render_average_color("generic", false);
+        const Color3f actual = render_average_color("wavefront", true);
+
+        expect_same_average_color(expected, actual);
+    }
+
+    TEST_CASE(Render_GivenCornellBoxAndPerSamplePathTracing_MatchesGenericSampleRenderer)
+    {
+        const Color3f expected = render_average_color("generic", false);
+        const Color3f actual = render_average_color("wavefront", false);
+
+        expect_same_average_color(expected, actual);
+    }
+}
@@ -42,6 +42,7 @@
 #include "foundation/string/string.h"
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <exception>
@@ -80,6 +81,11 @@ void AOV::release()
     delete this;
 }
 
+PixelFormat AOV::get_storage_format() const
+{
+    return PixelFormatFloat;
+}
+
 Image& AOV::get_image() const
 {
     return *m_image;
@@ -93,6 +99,8 @@ bool AOV::write_images(
     const char*             file_path,
     const ImageAttributes&  image_attributes) const
 {
+    APPLESEED_TRACE_SCOPE("output", "write aov images");
+
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
@@ -149,7 +157,7 @@ void AOV::create_image(
         m_image_index = aov_images.append(
             get_name(),
             get_channel_count(),
-            PixelFormatFloat);
+            get_storage_format());
     }
 
     m_image = &aov_images.get_image(m_image_index);
@@ -181,6 +189,14 @@ bool ColorAOV::has_color_data() const
     return true;
 }
 
+PixelFormat ColorAOV::get_storage_format() const
+{
+    // Color AOVs are accumulated in full precision by the shading result frame buffers
+    // and are written as half floats, so storing their developed images as half floats
+    // does not lose any precision.
+    return PixelFormatHalf;
+}
+
 void ColorAOV::clear_image()
 {
     m_image->clear(Color4f(0.0f));
@@ -236,7 +252,7 @@ void UnfilteredAOV::create_image(
             tile_width,
             tile_height,
             get_channel_count(),
-            PixelFormatFloat);
+            get_storage_format());
 
     // We need to clear the image because the default channel value might not be zero.
     clear_image();
@@ -32,6 +32,7 @@
 #include "renderer/modeling/entity/entity.h"
 
 // appleseed.foundation headers.
+#include "foundation/image/pixel.h"
 #include "foundation/memory/autoreleaseptr.h"
 #include "foundation/utility/uid.h"
 
@@ -82,6 +83,9 @@ class APPLESEED_DLLSYMBOL AOV
     // Return true if this AOV contains color data.
     virtual bool has_color_data() const = 0;
 
+    // Return the pixel format of the AOV image.
+    virtual foundation::PixelFormat get_storage_format() const;
+
     // Return a reference to the AOV image.
     foundation::Image& get_image() const;
 
@@ -136,6 +140,9 @@ class ColorAOV
     // Return true if this AOV contains color data.
     bool has_color_data() const override;
 
+    // Return the pixel format of the AOV image.
+    foundation::PixelFormat get_storage_format() const override;
+
     // Clear the AOV image to default values.
     void clear_image() override;
 };
@@ -46,6 +46,7 @@
 #include "renderer/modeling/aov/pixelvariationaov.h"
 #include "renderer/modeling/aov/positionaov.h"
 #include "renderer/modeling/aov/screenspacevelocityaov.h"
+#include "renderer/modeling/aov/shadingcostaov.h"
 #include "renderer/modeling/aov/uvaov.h"
 #include "renderer/modeling/entity/entityfactoryregistrar.h"
 
@@ -85,12 +86,14 @@ AOVFactoryRegistrar::AOVFactoryRegistrar(const SearchPaths& search_paths)
     impl->register_factory(auto_release_ptr<FactoryType>(new NormalAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new NPRContourAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new NPRShadingAOVFactory()));
+    impl->register_factory(auto_release_ptr<FactoryType>(new ObjectShadingCostAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new PixelErrorAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new PixelSampleCountAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new PixelTimeAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new PixelVariationAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new PositionAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new ScreenSpaceVelocityAOVFactory()));
+    impl->register_factory(auto_release_ptr<FactoryType>(new ShadingCostAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new UVAOVFactory()));
     impl->register_factory(auto_release_ptr<FactoryType>(new CryptomatteAOVFactory(CryptomatteAOV::CryptomatteType::ObjectNames)));
     impl->register_factory(auto_release_ptr<FactoryType>(new CryptomatteAOVFactory(CryptomatteAOV::CryptomatteType::MaterialNames)));
@@ -41,6 +41,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/containers/dictionary.h"
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/image/color.h"
 #include "foundation/image/genericimagefilewriter.h"
@@ -50,12 +51,16 @@
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
 #include "foundation/memory/memory.h"
+#include "foundation/platform/atomic.h"
 #include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/system.h"
 #include "foundation/string/string.h"
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/api/specializedapiarrays.h"
 #include "foundation/utility/makevector.h"
+#include "foundation/utility/job/parallelloop.h"
 #include "foundation/utility/otherwise.h"
+#include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
 
 // Boost headers.
@@ -75,6 +80,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -273,117 +279,131 @@ namespace
         }
     };
 
-    class WeightMap
+    //
+    // Fixed-capacity storage of (id, weight) pairs for all the pixels of a frame.
+    //
+    // Storage is allocated once, so that memory use does not depend on the number of ids
+    // in the scene. When all the entries of a pixel are in use, a new id replaces the entry
+    // with the lowest weight if this weight does not exceed the weight of the new sample.
+    // The total weight of each pixel is stored separately so that coverage values remain
+    // correct when ids are pruned.
+    //
+
+    class WeightPool
+      : public NonCopyable
     {
       public:
         struct Entry
         {
             std::uint32_t   m_key;
-            float           m_value;
-
-            Entry()
-              : m_key(0)
-              , m_value(0.0f)
-            {
-            }
+            float           m_weight;
         };
 
-        explicit WeightMap(const size_t size)
-          : m_size(static_cast<std::uint32_t>(size))
-          , m_index(0)
+        static const size_t MaxCapacity = 255;
+
+        WeightPool()
+          : m_capacity(0)
         {
-            assert(size > 0);
-            m_map = new Entry[size];
         }
 
-        WeightMap(const WeightMap& other)
-          : m_size(other.m_size)
-          , m_index(other.m_index)
+        void resize(const size_t pixel_count, const size_t capacity)
         {
-            m_map = new Entry[m_size];
-            for (size_t i = 0; i < m_index; ++i)
-                m_map[i] = other.m_map[i];
+            assert(capacity > 0 && capacity <= MaxCapacity);
+
+            m_capacity = capacity;
+
+            std::vector<Entry>(pixel_count * capacity).swap(m_entries);
+            std::vector<std::uint8_t>(pixel_count, 0).swap(m_counts);
+            std::vector<float>(pixel_count, 0.0f).swap(m_total_weights);
         }
 
-        WeightMap& operator=(const WeightMap& rhs)
+        size_t get_capacity() const
         {
-            if (m_size != rhs.m_size)
-            {
-                delete[] m_map;
-                m_map = new Entry[rhs.m_size];
-            }
+            return m_capacity;
+        }
 
-            m_size = rhs.m_size;
-            m_index = rhs.m_size;
-            for (size_t i = 0; i < m_index; ++i)
-                m_map[i] = rhs.m_map[i];
+        size_t get_memory_size() const
+        {
+            return
+                sizeof(*this) +
+                m_entries.capacity() * sizeof(Entry) +
+                m_counts.capacity() * sizeof(std::uint8_t) +
+                m_total_weights.capacity() * sizeof(float);
+        }
 
-            return *this;
+        void clear()
+        {
+            std::fill(m_counts.begin(), m_counts.end(), static_cast<std::uint8_t>(0));
+            std::fill(m_total_weights.begin(), m_total_weights.end(), 0.0f);
         }
 
-        ~WeightMap()
+        void clear_pixel(const size_t pixel_index)
         {
-            delete[] m_map;
+            m_counts[pixel_index] = 0;
+            m_total_weights[pixel_index] = 0.0f;
         }
 
-        void insert(const std::uint32_t key, const float value)
+        // Add a weight to the entry of a given id. Return true if an entry was pruned.
+        bool insert(const size_t pixel_index, const std::uint32_t key, const float weight)
         {
-            assert(m_map);
+            Entry* entries = &m_entries[pixel_index * m_capacity];
+            std::uint8_t& count = m_counts[pixel_index];
+
+            m_total_weights[pixel_index] += weight;
 
-            for (size_t i = 0; i < m_index; ++i)
+            for (size_t i = 0; i < count; ++i)
             {
-                if (m_map[i].m_key == key)
+                if (entries[i].m_key == key)
                 {
-                    m_map[i].m_value = value;
-                    return;
+                    entries[i].m_weight += weight;
+                    return false;
                 }
             }
 
-            if (m_index < m_size)
+            if (count < m_capacity)
             {
-                m_map[m_index].m_key = key;
-                m_map[m_index].m_value = value;
-                ++m_index;
+                entries[count].m_key = key;
+                entries[count].m_weight = weight;
+                ++count;
+                return false;
             }
-        }
 
-        float get(const std::uint32_t key) const
-        {
-            assert(m_map);
+            size_t min_index = 0;
+            for (size_t i = 1; i < m_capacity; ++i)
+            {
+                if (entries[i].m_weight < entries[min_index].m_weight)
+                    min_index = i;
+            }
 
-            for (size_t i = 0; i < m_index; ++i)
+            if (entries[min_index].m_weight <= weight)
             {
-                if (m_map[i].m_key == key)
-                    return m_map[i].m_value;
+                entries[min_index].m_key = key;
+                entries[min_index].m_weight = weight;
             }
 
-            return 0.0f;
+            return true;
         }
 
-        void clear()
+        size_t get_entry_count(const size_t pixel_index) const
         {
-            m_index = 0;
+            return m_counts[pixel_index];
         }
 
-        bool empty() const
+        const Entry* get_entries(const size_t pixel_index) const
         {
-            return m_index == 0;
+            return &m_entries[pixel_index * m_capacity];
         }
 
-        Entry* begin() const
+        float get_total_weight(const size_t pixel_index) const
         {
-            return m_map;
-        }
-
-        Entry* end() const
-        {
-            return m_map + m_index;
+            return m_total_weights[pixel_index];
         }
 
       private:
-        std::uint32_t   m_size;
-        std::uint32_t   m_index;
-        Entry*          m_map;
+        size_t                      m_capacity;
+        std::vector<Entry>          m_entries;
+        std::vector<std::uint8_t>   m_counts;
+        std::vector<float>          m_total_weights;
     };
 
     // Code taken from Cryptomatte specification.
@@ -406,6 +426,70 @@ namespace renderer
 namespace
 {
     typedef std::map<std::uint32_t, std::string> NameMap;
+    typedef std::pair<float, std::uint32_t> RankedEntry;
+
+    // Compute the preview and ranked channels of a pixel from its (id, weight) pairs.
+    void develop_pixel(
+        const WeightPool&               pixel_samples,
+        const size_t                    pixel_index,
+        const size_t                    num_layers,
+        std::vector<RankedEntry>&       ranked_vector,
+        float*                          pixel_values)
+    {
+        constexpr float uint32_max_rcp = 1.0f / std::numeric_limits<std::uint32_t>::max();
+
+        const size_t channel_count = (num_layers * 2) + 3;
+        std::fill(pixel_values, pixel_values + channel_count, 0.0f);
+
+        const size_t entry_count = pixel_samples.get_entry_count(pixel_index);
+        if (entry_count == 0)
+            return;
+
+        // The total weight includes the weight of pruned ids.
+        float total_weight = pixel_samples.get_total_weight(pixel_index);
+        if (total_weight == 0.0f)
+            total_weight = 1.0f;
+
+        clear_keep_memory(ranked_vector);
+
+        const WeightPool::Entry* entries = pixel_samples.get_entries(pixel_index);
+        for (size_t i = 0; i < entry_count; ++i)
+            ranked_vector.push_back(std::make_pair(entries[i].m_weight, entries[i].m_key));
+
+        sort(ranked_vector.begin(), ranked_vector.end(),
+            [](const RankedEntry& a, const RankedEntry& b)
+            {
+                return a.first > b.first;
+            });
+
+        const std::uint32_t m3hash_preview = ranked_vector[0].second;
+
+        // Preview channels (deprecated in recent Cryptomatte specification).
+        if (m3hash_preview != 0)
+        {
+            pixel_values[0] = hash_to_float(m3hash_preview);
+            pixel_values[1] = static_cast<float>(m3hash_preview << 8) * uint32_max_rcp;
+            pixel_values[2] = static_cast<float>(m3hash_preview << 16) * uint32_max_rcp;
+        }
+
+        // Remove background contribution.
+        size_t ranked_vector_start = 0;
+        if (ranked_vector.size() > 1 && m3hash_preview == 0)
+            ranked_vector_start = 1;
+
+        // Ranked channels. Remaining channels are left black.
+        float* ranked_values = pixel_values + 3;
+        for (size_t i = ranked_vector_start, e = std::min(ranked_vector.size(), ranked_vector_start + num_layers); i < e; ++i)
+        {
+            const std::uint32_t m3hash = ranked_vector[i].second;
+            if (m3hash != 0)
+            {
+                ranked_values[0] = hash_to_float(m3hash);
+                ranked_values[1] = ranked_vector[i].first / total_weight;
+            }
+            ranked_values += 2;
+        }
+    }
 
 
     //
@@ -417,16 +501,17 @@ namespace
     {
       public:
         CryptomatteAOVAccumulator(
-            Image&                              aov_image,
-            std::vector<WeightMap>&             pixel_samples,
+            WeightPool&                         pixel_samples,
             NameMap*                            tile_name_array,
-            size_t                              num_layers,
+            boost::atomic<std::uint64_t>&       pruned_sample_count,
+            boost::atomic<bool>&                image_dirty,
             CryptomatteAOV::CryptomatteType     layer_type)
-          : m_aov_image(aov_image)
-          , m_num_layers(num_layers)
-          , m_pixel_samples(pixel_samples)
+          : m_pixel_samples(pixel_samples)
           , m_tile_name_maps(tile_name_array)
+          , m_pruned_sample_count(pruned_sample_count)
+          , m_image_dirty(image_dirty)
           , m_layer_type(layer_type)
+          , m_tile_pruned_sample_count(0)
         {
         }
 
@@ -441,7 +526,7 @@ namespace
             const Tile& tile = frame.image().tile(tile_x, tile_y);
 
             m_frame_width = props.m_canvas_width;
-            m_tile_index = tile_y * props.m_tile_count_y + tile_x;
+            m_tile_index = tile_y * props.m_tile_count_x + tile_x;
 
             // Fetch the tile bounds (inclusive).
             m_tile_origin_x = tile_x * props.m_tile_width;
@@ -452,13 +537,15 @@ namespace
             for (size_t ry = m_tile_origin_y; ry <= m_tile_end_y; ++ry)
             {
                 for (size_t rx = m_tile_origin_x; rx <= m_tile_end_x; ++rx)
-                    m_pixel_samples[ry * m_frame_width + rx].clear();
+                    m_pixel_samples.clear_pixel(ry * m_frame_width + rx);
             }
 
             m_crop_window =
                 frame.has_crop_window()
                     ? frame.get_crop_window()
                     : AABB2u(Vector2u(m_tile_origin_x, m_tile_origin_y), Vector2u(m_tile_end_x, m_tile_end_y));
+
+            m_tile_pruned_sample_count = 0;
         }
 
         void on_tile_end(
@@ -466,84 +553,9 @@ namespace
             const size_t                tile_x,
             const size_t                tile_y) override
         {
-            std::vector<std::pair<float, std::uint32_t>> ranked_vector;
-            std::vector<float> pixel_values;
-            constexpr float uint32_max_rcp = 1.0f / std::numeric_limits<std::uint32_t>::max();
-
-            for (size_t ry = m_tile_origin_y; ry <= m_tile_end_y; ++ry)
-            {
-                for (size_t rx = m_tile_origin_x; rx <= m_tile_end_x; ++rx)
-                {
-                    const WeightMap& weight_map = m_pixel_samples[ry * m_frame_width + rx];
-
-                    if (!weight_map.empty())
-                    {
-                        clear_keep_memory(ranked_vector);
-                        clear_keep_memory(pixel_values);
-
-                        float total_weight = 0.0f;
-                        for (const auto& item : weight_map)
-                            total_weight += item.m_value;
-
-                        if (total_weight == 0.0f)
-                            total_weight = 1.0f;
-
-                        for (const auto& item : weight_map)
-                            ranked_vector.push_back(std::make_pair(item.m_value, item.m_key));
-
-                        sort(ranked_vector.begin(), ranked_vector.end(),
-                            [](std::pair<float, std::uint32_t> const& a, std::pair<float, std::uint32_t> const& b)
-                            {
-                                return a.first > b.first;
-                            });
-
-                        const std::uint32_t m3hash_preview = ranked_vector[0].second;
-
-                        // Preview channels (deprecated in recent Cryptomatte specification).
-                        float r(0.0f), g(0.0f), b(0.0f);
-                        if (m3hash_preview != 0)
-                        {
-                            r = hash_to_float(m3hash_preview);
-                            g = static_cast<float>(m3hash_preview << 8) * uint32_max_rcp;
-                            b = static_cast<float>(m3hash_preview << 16) * uint32_max_rcp;
-                        }
-                        pixel_values.push_back(r);
-                        pixel_values.push_back(g);
-                        pixel_values.push_back(b);
-
-                        // Remove background contribution.
-                        size_t ranked_vector_start = 0;
-                        if (ranked_vector.size() > 1 && m3hash_preview == 0)
-                            ranked_vector_start = 1;
-
-                        // Ranked channels.
-                        for (size_t i = ranked_vector_start, e = std::min(ranked_vector.size(), m_num_layers); i < e; ++i)
-                        {
-                            const std::uint32_t m3hash = ranked_vector[i].second;
-                            float rank(0.0f), coverage(0.0f);
-                            if (m3hash != 0)
-                            {
-                                rank = hash_to_float(m3hash);
-                                coverage = ranked_vector[i].first / total_weight;
-                            }
-                            pixel_values.push_back(rank);
-                            pixel_values.push_back(coverage);
-                        }
-
-                        // Set the remaining channels of the pixel to black.
-                        // This is determined by taking 2 channels per ranked vector plus
-                        // 3 channels for the preview image and subtracting that from the
-                        // total number of AOV channels.
-                        const size_t num_channels = (m_num_layers * 2) + 3;
-                        const size_t filled_channels = (ranked_vector.size() - ranked_vector_start) * 2 + 3;
-
-                        for (size_t i = filled_channels; i < num_channels; ++i)
-                            pixel_values.push_back(0.0f);
-
-                        m_aov_image.set_pixel(rx, ry, pixel_values.data(), pixel_values.size());
-                    }
-                }
-            }
+            // Ranked channels are computed when the cryptomatte image is requested.
+            m_pruned_sample_count += m_tile_pruned_sample_count;
+            m_image_dirty = true;
         }
 
         void on_sample_begin(const PixelContext& pixel_context) override
@@ -569,8 +581,14 @@ namespace
             const AOVComponents&        aov_components,
             ShadingResult&              shading_result) override
         {
+            const Vector2u pixel_pos(pixel_context.get_pixel_coords());
+
+            // Ignore samples outside the crop window.
+            if (!m_crop_window.contains(pixel_pos))
+                return;
+
             std::uint32_t m3hash = 0;
-            std::string obj_name;
+            const char* obj_name = "";
 
             if (shading_point.hit_surface())
             {
@@ -591,25 +609,16 @@ namespace
                   assert_otherwise;
                 }
 
-                MurmurHash3_x86_32(reinterpret_cast<const unsigned char*>(obj_name.c_str()), static_cast<int>(obj_name.size()), 0, &m3hash);
+                MurmurHash3_x86_32(reinterpret_cast<const unsigned char*>(obj_name), static_cast<int>(std::strlen(obj_name)), 0, &m3hash);
             }
 
-            const Vector2u pixel_pos(pixel_context.get_pixel_coords());
-
-            // Ignore samples outside the crop window.
-            if (!m_crop_window.contains(pixel_pos))
-                return;
-
-            m_tile_name_maps[m_tile_index][m3hash] = obj_name;
+            // Only copy the name the first time an id is seen in this tile.
+            NameMap& name_map = m_tile_name_maps[m_tile_index];
+            if (name_map.find(m3hash) == name_map.end())
+                name_map.emplace(m3hash, obj_name);
 
-            const size_t x = pixel_pos.x - m_tile_origin_x;
-            const size_t y = pixel_pos.y - m_tile_origin_y;
-
-            WeightMap& weight_map =
-                m_pixel_samples[(m_tile_origin_y + y) * m_frame_width + (m_tile_origin_x + x)];
-
-            const float old_value = weight_map.get(m3hash);
-            weight_map.insert(m3hash, old_value + 1.0f);
+            if (m_pixel_samples.insert(pixel_pos.y * m_frame_width + pixel_pos.x, m3hash, 1.0f))
+                ++m_tile_pruned_sample_count;
         }
 
       private:
@@ -620,11 +629,12 @@ namespace
         size_t                          m_tile_index;
         size_t                          m_frame_width;
         AABB2u                          m_crop_window;
-        Image&                          m_aov_image;
-        size_t                          m_num_layers;
-        std::vector<WeightMap>&         m_pixel_samples;
+        WeightPool&                     m_pixel_samples;
         NameMap*                        m_tile_name_maps;
+        boost::atomic<std::uint64_t>&   m_pruned_sample_count;
+        boost::atomic<bool>&            m_image_dirty;
         CryptomatteAOV::CryptomatteType m_layer_type;
+        std::uint64_t                   m_tile_pruned_sample_count;
     };
 }
 
@@ -641,11 +651,64 @@ namespace
 
 struct CryptomatteAOV::Impl
 {
-    std::vector<WeightMap>              m_pixel_samples;
+    WeightPool                          m_pixel_samples;
     NameMap*                            m_tile_name_maps;
     std::unique_ptr<Image>              m_image;
     size_t                              m_num_layers;
+    size_t                              m_max_ids_per_pixel;
     CryptomatteAOV::CryptomatteType     m_layer_type;
+    boost::atomic<std::uint64_t>        m_pruned_sample_count;
+    boost::atomic<bool>                 m_image_dirty;
+
+    // Compute the preview and ranked channels of all pixels, in parallel over tiles.
+    void develop_image()
+    {
+        if (!m_image_dirty.exchange(false))
+            return;
+
+        Stopwatch<DefaultWallclockTimer> stopwatch;
+        stopwatch.start();
+
+        const CanvasProperties& props = m_image->properties();
+        const size_t channel_count = get_channel_count();
+
+        ParallelLoop loop(global_logger(), System::get_logical_cpu_core_count());
+        loop.run(
+            props.m_tile_count,
+            [this, &props, channel_count](const size_t tile_index, const size_t)
+            {
+                const size_t tile_x = tile_index % props.m_tile_count_x;
+                const size_t tile_y = tile_index / props.m_tile_count_x;
+                Tile& tile = m_image->tile(tile_x, tile_y);
+
+                const size_t origin_x = tile_x * props.m_tile_width;
+                const size_t origin_y = tile_y * props.m_tile_height;
+
+                std::vector<RankedEntry> ranked_vector;
+                std::vector<float> pixel_values(channel_count);
+
+                for (size_t y = 0, h = tile.get_height(); y < h; ++y)
+                {
+                    for (size_t x = 0, w = tile.get_width(); x < w; ++x)
+                    {
+                        develop_pixel(
+                            m_pixel_samples,
+                            (origin_y + y) * props.m_canvas_width + origin_x + x,
+                            m_num_layers,
+                            ranked_vector,
+                            pixel_values.data());
+
+                        tile.set_pixel(x, y, pixel_values.data(), channel_count);
+                    }
+                }
+            });
+
+        stopwatch.measure();
+
+        RENDERER_LOG_DEBUG(
+            "developed cryptomatte image in %s.",
+            pretty_time(stopwatch.get_seconds()).c_str());
+    }
 
     static std::string make_manifest(const NameMap& name_map)
     {
@@ -707,6 +770,8 @@ struct CryptomatteAOV::Impl
 
     Impl()
       : m_tile_name_maps(nullptr)
+      , m_pruned_sample_count(0)
+      , m_image_dirty(false)
     {
     }
 
@@ -741,6 +806,14 @@ CryptomatteAOV::CryptomatteAOV(const ParamArray& params)
     }
 
     impl->m_num_layers = params.get_optional<size_t>("cryptomatte_num_layers", 6);
+
+    // By default, keep one more id per pixel than the number of ranked layers to
+    // account for the background. Less significant ids are pruned during rendering.
+    impl->m_max_ids_per_pixel =
+        clamp<size_t>(
+            params.get_optional<size_t>("cryptomatte_max_ids_per_pixel", impl->m_num_layers + 1),
+            1,
+            WeightPool::MaxCapacity);
 }
 
 CryptomatteAOV::~CryptomatteAOV()
@@ -774,6 +847,9 @@ bool CryptomatteAOV::has_color_data() const
 
 Image* CryptomatteAOV::get_cryptomatte_image() const
 {
+    if (impl->m_image)
+        impl->develop_image();
+
     return impl->m_image.get();
 }
 
@@ -794,10 +870,18 @@ void CryptomatteAOV::create_image(
             tile_height,
             channel_count,
             PixelFormatFloat));
-    impl->m_pixel_samples.resize(canvas_width * canvas_height, WeightMap(impl->m_num_layers));
+    impl->m_pixel_samples.resize(canvas_width * canvas_height, impl->m_max_ids_per_pixel);
     const auto& image_props = impl->m_image->properties();
+    delete[] impl->m_tile_name_maps;
     impl->m_tile_name_maps = new NameMap[image_props.m_tile_count];
     clear_image();
+
+    RENDERER_LOG_DEBUG(
+        "allocated %s for cryptomatte aov \"%s\" (%s %s per pixel).",
+        pretty_size(impl->m_pixel_samples.get_memory_size()).c_str(),
+        get_path().c_str(),
+        pretty_uint(impl->m_max_ids_per_pixel).c_str(),
+        impl->m_max_ids_per_pixel > 1 ? "ids" : "id");
 }
 
 void CryptomatteAOV::clear_image()
@@ -815,6 +899,10 @@ void CryptomatteAOV::clear_image()
 
     for (size_t i = 0, e = image_props.m_tile_count; i < e; ++i)
         impl->m_tile_name_maps[i].clear();
+
+    impl->m_pixel_samples.clear();
+    impl->m_pruned_sample_count = 0;
+    impl->m_image_dirty = false;
 }
 
 auto_release_ptr<AOVAccumulator> CryptomatteAOV::create_accumulator() const
@@ -822,10 +910,10 @@ auto_release_ptr<AOVAccumulator> CryptomatteAOV::create_accumulator() const
     return
         auto_release_ptr<AOVAccumulator>(
             new CryptomatteAOVAccumulator(
-                *impl->m_image,
                 impl->m_pixel_samples,
                 impl->m_tile_name_maps,
-                impl->m_num_layers,
+                impl->m_pruned_sample_count,
+                impl->m_image_dirty,
                 impl->m_layer_type));
 }
 
@@ -868,6 +956,9 @@ bool CryptomatteAOV::write_images(
     const NameMap name_map = impl->make_name_map();
     const std::string manifest = Impl::make_manifest(name_map);
 
+    // Generate the ranked layers.
+    impl->develop_image();
+
     ImageAttributes image_attributes_copy(image_attributes);
     image_attributes_copy.insert("color_space", "linear");
     image_attributes_copy.insert(std::string(layer_prefix + "/name").c_str(), layer_name);
@@ -904,6 +995,18 @@ bool CryptomatteAOV::write_images(
         get_path().c_str(),
         pretty_time(stopwatch.get_seconds()).c_str());
 
+    Statistics stats;
+    stats.insert("ids", name_map.size());
+    stats.insert("max ids per pixel", impl->m_max_ids_per_pixel);
+    stats.insert("pruned samples", static_cast<std::uint64_t>(impl->m_pruned_sample_count));
+    stats.insert_size("pixel storage", impl->m_pixel_samples.get_memory_size());
+    stats.insert_size("image", impl->m_image->properties().m_pixel_count * impl->m_image->properties().m_pixel_size);
+
+    RENDERER_LOG_DEBUG("%s",
+        StatisticsVector::make(
+            "cryptomatte statistics",
+            stats).to_string().c_str());
+
     return true;
 }
 
@@ -40,6 +40,7 @@
 #include "foundation/containers/dictionary.h"
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/api/specializedapiarrays.h"
@@ -80,25 +81,20 @@ namespace
             if (!m_cropped_tile_bbox.contains(pi))
                 return;
 
-            float* out =
-                reinterpret_cast<float*>(
-                    m_tile->pixel(
-                        pi.x - m_tile_origin_x,
-                        pi.y - m_tile_origin_y));
+            Color3f value(0.5f);
 
             if (shading_point.hit_surface())
             {
                 const Vector3d& n = shading_point.get_shading_normal();
-                out[0] = static_cast<float>(n[0]) * 0.5f + 0.5f;
-                out[1] = static_cast<float>(n[1]) * 0.5f + 0.5f;
-                out[2] = static_cast<float>(n[2]) * 0.5f + 0.5f;
-            }
-            else
-            {
-                out[0] = 0.5f;
-                out[1] = 0.5f;
-                out[2] = 0.5f;
+                value[0] = static_cast<float>(n[0]) * 0.5f + 0.5f;
+                value[1] = static_cast<float>(n[1]) * 0.5f + 0.5f;
+                value[2] = static_cast<float>(n[2]) * 0.5f + 0.5f;
             }
+
+            m_tile->set_pixel(
+                pi.x - m_tile_origin_x,
+                pi.y - m_tile_origin_y,
+                value);
         }
     };
 
@@ -128,6 +124,12 @@ namespace
             return NormalAOVModel;
         }
 
+        PixelFormat get_storage_format() const override
+        {
+            // Encoded normals are in [0, 1]: half floats are precise enough.
+            return PixelFormatHalf;
+        }
+
         void clear_image() override
         {
             m_image->clear(Color3f(0.5f));
@@ -40,7 +40,9 @@
 
 // appleseed.foundation headers.
 #include "foundation/containers/dictionary.h"
+#include "foundation/image/color.h"
 #include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/api/apistring.h"
@@ -129,25 +131,12 @@ namespace
             if (!m_cropped_tile_bbox.contains(pi))
                 return;
 
-            float* out =
-                reinterpret_cast<float*>(
-                    m_tile->pixel(
-                        pi.x - m_tile_origin_x,
-                        pi.y - m_tile_origin_y));
-
-            if (shading_point.hit_surface())
-            {
-                const Color3f c = compute_screen_space_velocity_color(shading_point, m_max_displace);
-                out[0] = c[0];
-                out[1] = c[1];
-                out[2] = c[2];
-            }
-            else
-            {
-                out[0] = 0.0f;
-                out[1] = 0.0f;
-                out[2] = 0.0f;
-            }
+            m_tile->set_pixel(
+                pi.x - m_tile_origin_x,
+                pi.y - m_tile_origin_y,
+                shading_point.hit_surface()
+                    ? compute_screen_space_velocity_color(shading_point, m_max_displace)
+                    : Color3f(0.0f));
         }
 
       private:
@@ -181,6 +170,12 @@ namespace
             return ScreenSpaceVelocityAOVModel;
         }
 
+        PixelFormat get_storage_format() const override
+        {
+            // Velocities are normalized or expressed in pixels: half floats are precise enough.
+            return PixelFormatHalf;
+        }
+
         void clear_image() override
         {
             m_image->clear(Color3f(0.0f));
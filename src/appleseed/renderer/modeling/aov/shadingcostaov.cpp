@@ -0,0 +1,545 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+// Interface header.
+#include "shadingcostaov.h"
+
+// appleseed.renderer headers.
+#include "renderer/kernel/aov/aovaccumulator.h"
+#include "renderer/kernel/rendering/pixelcontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingprofiler.h"
+#include "renderer/modeling/aov/aov.h"
+#include "renderer/modeling/frame/frame.h"
+
+// appleseed.foundation headers.
+#include "foundation/containers/dictionary.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/api/specializedapiarrays.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace foundation;
+
+namespace renderer
+{
+
+namespace
+{
+    static_assert(ShadingProfiler::CategoryCount == 3, "Shading cost AOVs assume three profiling categories");
+
+    //
+    // Base class for shading cost AOV accumulators.
+    //
+    // Measures the time spent in each category of the shading profiler while
+    // rendering a sample: shader execution, ray tracing and BSDF sampling.
+    //
+
+    class ShadingCostAOVAccumulatorBase
+      : public UnfilteredAOVAccumulator
+    {
+      public:
+        explicit ShadingCostAOVAccumulatorBase(Image& image)
+          : UnfilteredAOVAccumulator(image)
+          , m_profiled(false)
+        {
+        }
+
+        void on_sample_begin(const PixelContext& pixel_context) override
+        {
+            m_profiled = ShadingProfiler::get_thread_category_times(m_sample_begin_times);
+        }
+
+      protected:
+        // Retrieve the cost of the sample that just ended. Return false if the sample
+        // was not profiled or lies outside the tile.
+        bool get_sample_cost(const PixelContext& pixel_context, Color3d& cost) const
+        {
+            if (!m_profiled || !m_cropped_tile_bbox.contains(pixel_context.get_pixel_coords()))
+                return false;
+
+            double times[ShadingProfiler::CategoryCount];
+            ShadingProfiler::get_thread_category_times(times);
+
+            for (size_t i = 0; i < ShadingProfiler::CategoryCount; ++i)
+                cost[i] = times[i] - m_sample_begin_times[i];
+
+            return true;
+        }
+
+      private:
+        bool    m_profiled;
+        double  m_sample_begin_times[ShadingProfiler::CategoryCount];
+    };
+
+
+    //
+    // Shading Cost AOV accumulator.
+    //
+    // Each pixel receives the time spent in each profiling category while rendering
+    // its samples: red for shader execution, green for ray tracing and blue for BSDF
+    // sampling.
+    //
+
+    class ShadingCostAOVAccumulator
+      : public ShadingCostAOVAccumulatorBase
+    {
+      public:
+        explicit ShadingCostAOVAccumulator(Image& image)
+          : ShadingCostAOVAccumulatorBase(image)
+        {
+        }
+
+        void on_sample_end(const PixelContext& pixel_context) override
+        {
+            Color3d cost;
+            if (get_sample_cost(pixel_context, cost))
+                m_pixel_cost += cost;
+        }
+
+        void on_pixel_begin(const Vector2i& pi) override
+        {
+            ShadingCostAOVAccumulatorBase::on_pixel_begin(pi);
+            m_pixel_cost.set(0.0);
+        }
+
+        void on_pixel_end(const Vector2i& pi) override
+        {
+            if (m_cropped_tile_bbox.contains(pi))
+            {
+                float* out =
+                    reinterpret_cast<float*>(
+                        m_tile->pixel(
+                            pi.x - m_tile_origin_x,
+                            pi.y - m_tile_origin_y));
+
+                for (size_t i = 0; i < ShadingProfiler::CategoryCount; ++i)
+                    out[i] += static_cast<float>(m_pixel_cost[i]);
+            }
+
+            ShadingCostAOVAccumulatorBase::on_pixel_end(pi);
+        }
+
+      private:
+        Color3d m_pixel_cost;
+    };
+
+
+    //
+    // Costs of object instances, shared by the accumulators of an object shading cost AOV.
+    //
+
+    typedef std::unordered_map<const ObjectInstance*, Color3d> ObjectCostMap;
+
+    struct ObjectCosts
+    {
+        boost::mutex                        m_mutex;
+        ObjectCostMap                       m_costs;            // total cost of each object instance
+        std::vector<const ObjectInstance*>  m_pixel_objects;    // object instance seen through each pixel
+        size_t                              m_canvas_width;
+
+        void clear()
+        {
+            m_costs.clear();
+            std::fill(m_pixel_objects.begin(), m_pixel_objects.end(), nullptr);
+        }
+
+        void merge(const ObjectCostMap& costs)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            for (const auto& entry : costs)
+                m_costs[entry.first] += entry.second;
+        }
+    };
+
+
+    //
+    // Object Shading Cost AOV accumulator.
+    //
+    // The whole cost of a sample is attributed to the first object instance hit by
+    // the camera ray of the sample. Each pixel records the object instance hit by
+    // most of its samples; its value is filled in once the frame is rendered.
+    //
+
+    class ObjectShadingCostAOVAccumulator
+      : public ShadingCostAOVAccumulatorBase
+    {
+      public:
+        ObjectShadingCostAOVAccumulator(Image& image, ObjectCosts& object_costs)
+          : ShadingCostAOVAccumulatorBase(image)
+          , m_object_costs(object_costs)
+          , m_sample_object(nullptr)
+        {
+        }
+
+        void on_tile_end(
+            const Frame&                frame,
+            const size_t                tile_x,
+            const size_t                tile_y) override
+        {
+            m_object_costs.merge(m_tile_costs);
+            m_tile_costs.clear();
+
+            ShadingCostAOVAccumulatorBase::on_tile_end(frame, tile_x, tile_y);
+        }
+
+        void on_sample_begin(const PixelContext& pixel_context) override
+        {
+            ShadingCostAOVAccumulatorBase::on_sample_begin(pixel_context);
+            m_sample_object = nullptr;
+        }
+
+        void write(
+            const PixelContext&         pixel_context,
+            const ShadingPoint&         shading_point,
+            const ShadingComponents&    shading_components,
+            const AOVComponents&        aov_components,
+            ShadingResult&              shading_result) override
+        {
+            // Only consider the first surface along the camera ray.
+            if (m_sample_object == nullptr && shading_point.hit_surface())
+                m_sample_object = &shading_point.get_object_instance();
+        }
+
+        void on_sample_end(const PixelContext& pixel_context) override
+        {
+            Color3d cost;
+            if (!get_sample_cost(pixel_context, cost) || m_sample_object == nullptr)
+                return;
+
+            m_tile_costs[m_sample_object] += cost;
+
+            const auto it =
+                std::find_if(
+                    m_pixel_hits.begin(),
+                    m_pixel_hits.end(),
+                    [this](const PixelHit& hit) { return hit.first == m_sample_object; });
+
+            if (it != m_pixel_hits.end())
+                ++it->second;
+            else m_pixel_hits.emplace_back(m_sample_object, 1);
+        }
+
+        void on_pixel_begin(const Vector2i& pi) override
+        {
+            ShadingCostAOVAccumulatorBase::on_pixel_begin(pi);
+            m_pixel_hits.clear();
+        }
+
+        void on_pixel_end(const Vector2i& pi) override
+        {
+            if (m_cropped_tile_bbox.contains(pi) && !m_pixel_hits.empty())
+            {
+                const auto it =
+                    std::max_element(
+                        m_pixel_hits.begin(),
+                        m_pixel_hits.end(),
+                        [](const PixelHit& lhs, const PixelHit& rhs) { return lhs.second < rhs.second; });
+
+                m_object_costs.m_pixel_objects[pi.y * m_object_costs.m_canvas_width + pi.x] = it->first;
+            }
+
+            ShadingCostAOVAccumulatorBase::on_pixel_end(pi);
+        }
+
+      private:
+        typedef std::pair<const ObjectInstance*, size_t> PixelHit;
+
+        ObjectCosts&                    m_object_costs;
+        ObjectCostMap                   m_tile_costs;
+        const ObjectInstance*           m_sample_object;
+        std::vector<PixelHit>           m_pixel_hits;
+    };
+
+
+    //
+    // Base class for shading cost AOVs.
+    //
+
+    class ShadingCostAOVBase
+      : public UnfilteredAOV
+    {
+      public:
+        ShadingCostAOVBase(const char* name, const ParamArray& params)
+          : UnfilteredAOV(name, params)
+        {
+        }
+
+        void release() override
+        {
+            delete this;
+        }
+
+        size_t get_channel_count() const override
+        {
+            return 3;
+        }
+
+        const char** get_channel_names() const override
+        {
+            static const char* ChannelNames[] = { "R", "G", "B" };
+            return ChannelNames;
+        }
+
+        void clear_image() override
+        {
+            m_image->clear(Color<float, 3>(0.0f));
+        }
+
+        void post_process_image(const Frame& frame) override
+        {
+            // Scale all channels by the same factor so that the most expensive
+            // category of the most expensive pixel maps to 1 while the relative
+            // cost of each category remains visible as a hue.
+            const AABB2u& crop_window = frame.get_crop_window();
+
+            float max_cost = 0.0f;
+            for_each_pixel(
+                crop_window,
+                [&max_cost](const size_t x, const size_t y, Color3f& cost) { max_cost = std::max(max_value(cost), max_cost); });
+
+            if (max_cost > 0.0f)
+            {
+                const float rcp_max_cost = 1.0f / max_cost;
+                for_each_pixel(
+                    crop_window,
+                    [rcp_max_cost](const size_t x, const size_t y, Color3f& cost) { cost *= rcp_max_cost; });
+            }
+        }
+
+      protected:
+        template <typename Func>
+        void for_each_pixel(const AABB2u& crop_window, const Func& func)
+        {
+            const CanvasProperties& props = m_image->properties();
+
+            for (size_t y = crop_window.min.y; y <= crop_window.max.y; ++y)
+            {
+                for (size_t x = crop_window.min.x; x <= crop_window.max.x; ++x)
+                {
+                    Tile& tile = m_image->tile(x / props.m_tile_width, y / props.m_tile_height);
+                    const size_t tx = x % props.m_tile_width;
+                    const size_t ty = y % props.m_tile_height;
+
+                    Color3f cost;
+                    tile.get_pixel(tx, ty, cost);
+                    func(x, y, cost);
+                    tile.set_pixel(tx, ty, cost);
+                }
+            }
+        }
+    };
+
+
+    //
+    // Shading Cost AOV.
+    //
+
+    const char* ShadingCostAOVModel = "shading_cost_aov";
+
+    class ShadingCostAOV
+      : public ShadingCostAOVBase
+    {
+      public:
+        explicit ShadingCostAOV(const ParamArray& params)
+          : ShadingCostAOVBase("shading_cost", params)
+        {
+        }
+
+        const char* get_model() const override
+        {
+            return ShadingCostAOVModel;
+        }
+
+      private:
+        auto_release_ptr<AOVAccumulator> create_accumulator() const override
+        {
+            return auto_release_ptr<AOVAccumulator>(new ShadingCostAOVAccumulator(get_image()));
+        }
+    };
+
+
+    //
+    // Object Shading Cost AOV.
+    //
+
+    const char* ObjectShadingCostAOVModel = "object_shading_cost_aov";
+
+    class ObjectShadingCostAOV
+      : public ShadingCostAOVBase
+    {
+      public:
+        explicit ObjectShadingCostAOV(const ParamArray& params)
+          : ShadingCostAOVBase("object_shading_cost", params)
+          , m_object_costs(new ObjectCosts())
+        {
+        }
+
+        const char* get_model() const override
+        {
+            return ObjectShadingCostAOVModel;
+        }
+
+        void clear_image() override
+        {
+            ShadingCostAOVBase::clear_image();
+            m_object_costs->clear();
+        }
+
+        void post_process_image(const Frame& frame) override
+        {
+            // Replace each pixel by the cost of the object instance seen through it.
+            const ObjectCosts& object_costs = *m_object_costs;
+            for_each_pixel(
+                frame.get_crop_window(),
+                [&object_costs](const size_t x, const size_t y, Color3f& cost)
+                {
+                    const ObjectInstance* object_instance =
+                        object_costs.m_pixel_objects[y * object_costs.m_canvas_width + x];
+                    const auto it = object_costs.m_costs.find(object_instance);
+                    cost =
+                        it != object_costs.m_costs.end()
+                            ? Color3f(it->second)
+                            : Color3f(0.0f);
+                });
+
+            ShadingCostAOVBase::post_process_image(frame);
+        }
+
+      protected:
+        void create_image(
+            const size_t    canvas_width,
+            const size_t    canvas_height,
+            const size_t    tile_width,
+            const size_t    tile_height,
+            ImageStack&     aov_images) override
+        {
+            m_object_costs->m_pixel_objects.assign(canvas_width * canvas_height, nullptr);
+            m_object_costs->m_canvas_width = canvas_width;
+
+            ShadingCostAOVBase::create_image(
+                canvas_width,
+                canvas_height,
+                tile_width,
+                tile_height,
+                aov_images);
+        }
+
+      private:
+        std::unique_ptr<ObjectCosts> m_object_costs;
+
+        auto_release_ptr<AOVAccumulator> create_accumulator() const override
+        {
+            return
+                auto_release_ptr<AOVAccumulator>(
+                    new ObjectShadingCostAOVAccumulator(get_image(), *m_object_costs));
+        }
+    };
+}
+
+
+//
+// ShadingCostAOVFactory class implementation.
+//
+
+void ShadingCostAOVFactory::release()
+{
+    delete this;
+}
+
+const char* ShadingCostAOVFactory::get_model() const
+{
+    return ShadingCostAOVModel;
+}
+
+Dictionary ShadingCostAOVFactory::get_model_metadata() const
+{
+    return
+        Dictionary()
+            .insert("name", ShadingCostAOVModel)
+            .insert("label", "Shading Cost");
+}
+
+DictionaryArray ShadingCostAOVFactory::get_input_metadata() const
+{
+    DictionaryArray metadata;
+    return metadata;
+}
+
+auto_release_ptr<AOV> ShadingCostAOVFactory::create(const ParamArray& params) const
+{
+    return auto_release_ptr<AOV>(new ShadingCostAOV(params));
+}
+
+
+//
+// ObjectShadingCostAOVFactory class implementation.
+//
+
+void ObjectShadingCostAOVFactory::release()
+{
+    delete this;
+}
+
+const char* ObjectShadingCostAOVFactory::get_model() const
+{
+    return ObjectShadingCostAOVModel;
+}
+
+Dictionary ObjectShadingCostAOVFactory::get_model_metadata() const
+{
+    return
+        Dictionary()
+            .insert("name", ObjectShadingCostAOVModel)
+            .insert("label", "Object Shading Cost");
+}
+
+DictionaryArray ObjectShadingCostAOVFactory::get_input_metadata() const
+{
+    DictionaryArray metadata;
+    return metadata;
+}
+
+auto_release_ptr<AOV> ObjectShadingCostAOVFactory::create(const ParamArray& params) const
+{
+    return auto_release_ptr<AOV>(new ObjectShadingCostAOV(params));
+}
+
+}   // namespace renderer
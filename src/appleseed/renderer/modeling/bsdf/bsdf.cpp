@@ -31,6 +31,7 @@
 #include "bsdf.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/shading/directshadingcomponents.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/modeling/input/inputarray.h"
@@ -103,6 +104,32 @@ void BSDF::prepare_inputs(
 {
 }
 
+void BSDF::evaluate_batch(
+    const void*                 data,
+    const bool                  adjoint,
+    const bool                  cosine_mult,
+    const LocalGeometry&        local_geometry,
+    const Vector3f&             outgoing,
+    const DirectionBatch&       incoming,
+    const int                   modes,
+    DirectShadingComponents*    values,
+    float*                      probabilities) const
+{
+    for (size_t i = 0, e = incoming.size(); i < e; ++i)
+    {
+        probabilities[i] =
+            evaluate(
+                data,
+                adjoint,
+                cosine_mult,
+                local_geometry,
+                outgoing,
+                incoming[i],
+                modes,
+                values[i]);
+    }
+}
+
 float BSDF::sample_ior(
     SamplingContext&            sampling_context,
     const void*                 data) const
@@ -32,6 +32,7 @@
 // appleseed.renderer headers.
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/lighting/scatteringmode.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 #include "renderer/modeling/entity/connectableentity.h"
 
 // appleseed.foundation headers.
@@ -178,6 +179,21 @@ class APPLESEED_DLLSYMBOL BSDF
         const int                   modes,                      // enabled scattering modes
         DirectShadingComponents&    value) const = 0;           // BSDF value, or BSDF value * |cos(incoming, normal)|
 
+    // Evaluate the BSDF for a given outgoing direction and a batch of incoming
+    // directions. For each incoming direction, store the PDF value in `probabilities`
+    // and the BSDF value in `values`; a BSDF value is undefined if its PDF value is
+    // zero. The default implementation calls evaluate() once per incoming direction.
+    virtual void evaluate_batch(
+        const void*                 data,                       // input values
+        const bool                  adjoint,                    // if true, use the adjoint scattering kernel
+        const bool                  cosine_mult,                // if true, multiply by |cos(incoming, normal)|
+        const LocalGeometry&        local_geometry,
+        const foundation::Vector3f& outgoing,                   // world space outgoing direction, unit-length
+        const DirectionBatch&       incoming,                   // world space incoming directions, unit-length
+        const int                   modes,                      // enabled scattering modes
+        DirectShadingComponents*    values,                     // BSDF values, or BSDF values * |cos(incoming, normal)|
+        float*                      probabilities) const;       // PDF values, 16-byte aligned, DirectionBatch::MaxSize entries
+
     // Evaluate the PDF for a given pair of directions.
     virtual float evaluate_pdf(
         const void*                 data,                       // input values
@@ -31,6 +31,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/basis.h"
+#include "foundation/math/scalar.h"
 
 // Standard headers.
 #include <cmath>
@@ -42,6 +43,40 @@ namespace renderer
 
 namespace
 {
+    //
+    // Angular spread of the ray differentials of a diffuse bounce:
+    // the footprint of the scattered ray covers 1/25 of the hemisphere.
+    //
+    // Reference:
+    //
+    //   https://www.pbrt.org/texcache.pdf
+    //
+
+    const float DiffuseSpread = 0.2f;
+
+    // Spread of the ray differentials of a glossy lobe of a given roughness.
+    // Approximates the lobe by a cone whose width is proportional to the microfacet
+    // distribution's alpha parameter; a roughness of 1 matches a diffuse bounce.
+    float glossy_spread(const float roughness)
+    {
+        return DiffuseSpread * square(saturate(roughness));
+    }
+
+    // Widen the differentials of a direction by a given angular spread.
+    // If the direction doesn't have derivatives, they are constructed around it.
+    void widen_differentials(Dual3f& dir, const float spread)
+    {
+        const Vector3f& i = dir.get_value();
+        const Basis3f basis(i);
+
+        const Vector3f dx = dir.has_derivatives() ? dir.get_dx() : i;
+        const Vector3f dy = dir.has_derivatives() ? dir.get_dy() : i;
+
+        dir.set_derivatives(
+            normalize(dx + spread * basis.get_tangent_u()),
+            normalize(dy + spread * basis.get_tangent_v()));
+    }
+
     void compute_normal_derivatives(
         const BSDF::LocalGeometry&  local_geometry,
         const Vector3f&             o,
@@ -159,8 +194,10 @@ void BSDFSample::compute_glossy_reflected_differentials(
     const float                 roughness,
     const Dual3f&               outgoing)
 {
-    // TODO: scale differentials based on roughness.
     compute_specular_reflected_differentials(local_geometry, outgoing);
+
+    if (outgoing.has_derivatives())
+        widen_differentials(m_incoming, glossy_spread(roughness));
 }
 
 void BSDFSample::compute_glossy_transmitted_differentials(
@@ -170,25 +207,42 @@ void BSDFSample::compute_glossy_transmitted_differentials(
     const bool                  is_entering,
     const Dual3f&               outgoing)
 {
-    // TODO: scale differentials based on roughness.
     compute_specular_transmitted_differentials(
         local_geometry,
         eta,
         is_entering,
         outgoing);
+
+    if (outgoing.has_derivatives())
+        widen_differentials(m_incoming, glossy_spread(roughness));
 }
 
 void BSDFSample::compute_diffuse_differentials(const Dual3f& outgoing)
 {
     if (outgoing.has_derivatives())
     {
-        // 1/25 of the hemisphere.
-        // Reference: https://www.pbrt.org/texcache.pdf
-        const auto& i = m_incoming.get_value();
-        const Basis3f basis(m_incoming.get_value());
-        m_incoming.set_derivatives(
-            normalize(i + 0.2f * basis.get_tangent_u()),
-            normalize(i + 0.2f * basis.get_tangent_v()));
+        m_incoming = Dual3f(m_incoming.get_value());
+        widen_differentials(m_incoming, DiffuseSpread);
+    }
+}
+
+void BSDFSample::compute_approximate_differentials(const Dual3f& outgoing)
+{
+    if (outgoing.has_derivatives() && !m_incoming.has_derivatives())
+    {
+        switch (m_mode)
+        {
+          case ScatteringMode::Diffuse:
+            widen_differentials(m_incoming, DiffuseSpread);
+            break;
+
+          case ScatteringMode::Glossy:
+            widen_differentials(m_incoming, glossy_spread(m_min_roughness));
+            break;
+
+          default:
+            break;
+        }
     }
 }
 
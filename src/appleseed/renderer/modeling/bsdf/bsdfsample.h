@@ -92,6 +92,11 @@ class BSDFSample
     void compute_diffuse_differentials(
         const foundation::Dual3f&   outgoing);
 
+    // Approximate the differentials of the incoming direction by a cone when the
+    // BSDF could not compute them, using the scattering mode and m_min_roughness.
+    void compute_approximate_differentials(
+        const foundation::Dual3f&   outgoing);
+
   private:
     ScatteringMode::Mode            m_mode;                 // scattering mode
     float                           m_probability;          // PDF value
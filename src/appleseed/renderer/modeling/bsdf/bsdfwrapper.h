@@ -34,6 +34,7 @@
 #include "renderer/kernel/shading/directshadingcomponents.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 #include "renderer/modeling/scene/objectinstance.h"
 #include "renderer/utility/shadowterminator.h"
 
@@ -41,11 +42,13 @@
 #include "foundation/math/basis.h"
 #include "foundation/math/dual.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
 
 // Standard headers.
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 
 // Forward declarations.
 namespace renderer  { class ParamArray; }
@@ -89,6 +92,17 @@ class BSDFWrapper
         const int                       modes,
         DirectShadingComponents&        value) const override;
 
+    void evaluate_batch(
+        const void*                     data,
+        const bool                      adjoint,
+        const bool                      cosine_mult,
+        const LocalGeometry&            local_geometry,
+        const foundation::Vector3f&     outgoing,
+        const DirectionBatch&           incoming,
+        const int                       modes,
+        DirectShadingComponents*        values,
+        float*                          probabilities) const override;
+
     float evaluate_pdf(
         const void*                     data,
         const bool                      adjoint,
@@ -250,6 +264,94 @@ float BSDFWrapper<BSDFImpl, Cull>::evaluate(
     return probability;
 }
 
+template <typename BSDFImpl, bool Cull>
+void BSDFWrapper<BSDFImpl, Cull>::evaluate_batch(
+    const void*                         data,
+    const bool                          adjoint,
+    const bool                          cosine_mult,
+    const LocalGeometry&                local_geometry,
+    const foundation::Vector3f&         outgoing,
+    const DirectionBatch&               incoming,
+    const int                           modes,
+    DirectShadingComponents*            values,
+    float*                              probabilities) const
+{
+    assert(foundation::is_normalized(local_geometry.m_geometric_normal));
+    assert(foundation::is_normalized(outgoing));
+
+    const size_t count = incoming.size();
+    const foundation::Vector3f& n = local_geometry.m_shading_basis.get_normal();
+
+    // In the adjoint case, culling only depends on the outgoing direction.
+    if (Cull && adjoint && is_culled(adjoint, local_geometry.m_shading_basis, outgoing, outgoing))
+    {
+        std::fill(probabilities, probabilities + count, 0.0f);
+        return;
+    }
+
+    // Compute the cosines of all incoming directions with the shading normal at once.
+    APPLESEED_SIMD4_ALIGN float cos_in[DirectionBatch::MaxSize];
+    compute_dot_products(incoming, n, cos_in);
+
+    // Implementations that don't provide a batched evaluation fall back to
+    // BSDF::evaluate_batch() which calls evaluate() on this wrapper.
+    BSDFImpl::evaluate_batch(
+        data,
+        adjoint,
+        false,
+        local_geometry,
+        outgoing,
+        incoming,
+        modes,
+        values,
+        probabilities);
+
+    const float shadow_terminator_freq_mult =
+        cosine_mult && !adjoint
+            ? local_geometry.m_shading_point->get_object_instance().get_render_data().m_shadow_terminator_freq_mult
+            : 0.0f;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(foundation::is_normalized(incoming[i]));
+
+        if (Cull && !adjoint)
+        {
+            const bool culled =
+                BSDFImpl::get_type() == BSDF::Reflective ? cos_in[i] < 0.0f : cos_in[i] > 0.0f;
+
+            if (culled)
+            {
+                probabilities[i] = 0.0f;
+                continue;
+            }
+        }
+
+        assert(probabilities[i] >= 0.0f);
+
+        if (probabilities[i] > 0.0f)
+        {
+            assert(values[i].is_valid());
+
+            if (cosine_mult)
+            {
+                if (adjoint)
+                {
+                    const float cos_on = std::abs(foundation::dot(outgoing, n));
+                    const float cos_ig = std::abs(foundation::dot(incoming[i], local_geometry.m_geometric_normal));
+                    const float cos_og = std::abs(foundation::dot(outgoing, local_geometry.m_geometric_normal));
+                    values[i] *= cos_on * cos_ig / cos_og;
+                }
+                else
+                {
+                    const float cos = std::min(std::abs(cos_in[i]), 1.0f);
+                    values[i] *= shift_cos_in_fast(cos, shadow_terminator_freq_mult);
+                }
+            }
+        }
+    }
+}
+
 template <typename BSDFImpl, bool Cull>
 float BSDFWrapper<BSDFImpl, Cull>::evaluate_pdf(
     const void*                         data,
@@ -0,0 +1,190 @@
+
+//
+// This source file is part of appleseed.
+// Visit https://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2020 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+// appleseed.foundation headers.
+#include "foundation/math/basis.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+namespace renderer
+{
+
+//
+// A small, fixed-capacity batch of unit-length directions stored in SoA form.
+// It is used to evaluate BSDFs for many incoming directions in a single call.
+//
+// Elements past the end of the batch always hold finite values so that SIMD
+// code can process whole groups of 4 directions.
+//
+
+class DirectionBatch
+{
+  public:
+    static const size_t MaxSize = 8;
+
+    APPLESEED_SIMD4_ALIGN float m_x[MaxSize];
+    APPLESEED_SIMD4_ALIGN float m_y[MaxSize];
+    APPLESEED_SIMD4_ALIGN float m_z[MaxSize];
+
+    // Constructor. The batch is initially empty.
+    DirectionBatch();
+
+    size_t size() const;
+    bool empty() const;
+    bool full() const;
+
+    void clear();
+
+    void push_back(const foundation::Vector3f& v);
+
+    foundation::Vector3f operator[](const size_t i) const;
+
+  private:
+    friend void transform_to_local(
+        const DirectionBatch&           batch,
+        const foundation::Basis3f&      basis,
+        DirectionBatch&                 result);
+
+    size_t m_size;
+};
+
+// Compute the dot product of every direction of a batch with a given vector.
+// `result` must be 16-byte aligned and have room for DirectionBatch::MaxSize values.
+void compute_dot_products(
+    const DirectionBatch&               batch,
+    const foundation::Vector3f&         v,
+    float*                              result);
+
+// Express every direction of a batch in the local frame of a given basis.
+void transform_to_local(
+    const DirectionBatch&               batch,
+    const foundation::Basis3f&          basis,
+    DirectionBatch&                     result);
+
+
+//
+// DirectionBatch class implementation.
+//
+
+inline DirectionBatch::DirectionBatch()
+  : m_size(0)
+{
+    for (size_t i = 0; i < MaxSize; ++i)
+    {
+        m_x[i] = 0.0f;
+        m_y[i] = 1.0f;
+        m_z[i] = 0.0f;
+    }
+}
+
+inline size_t DirectionBatch::size() const
+{
+    return m_size;
+}
+
+inline bool DirectionBatch::empty() const
+{
+    return m_size == 0;
+}
+
+inline bool DirectionBatch::full() const
+{
+    return m_size == MaxSize;
+}
+
+inline void DirectionBatch::clear()
+{
+    m_size = 0;
+}
+
+inline void DirectionBatch::push_back(const foundation::Vector3f& v)
+{
+    assert(m_size < MaxSize);
+
+    m_x[m_size] = v.x;
+    m_y[m_size] = v.y;
+    m_z[m_size] = v.z;
+
+    ++m_size;
+}
+
+inline foundation::Vector3f DirectionBatch::operator[](const size_t i) const
+{
+    assert(i < m_size);
+    return foundation::Vector3f(m_x[i], m_y[i], m_z[i]);
+}
+
+inline void compute_dot_products(
+    const DirectionBatch&               batch,
+    const foundation::Vector3f&         v,
+    float*                              result)
+{
+#ifdef APPLESEED_USE_SSE
+    const __m128 vx = _mm_set1_ps(v.x);
+    const __m128 vy = _mm_set1_ps(v.y);
+    const __m128 vz = _mm_set1_ps(v.z);
+
+    for (size_t i = 0, e = batch.size(); i < e; i += 4)
+    {
+        const __m128 d =
+            _mm_add_ps(
+                _mm_add_ps(
+                    _mm_mul_ps(_mm_load_ps(batch.m_x + i), vx),
+                    _mm_mul_ps(_mm_load_ps(batch.m_y + i), vy)),
+                _mm_mul_ps(_mm_load_ps(batch.m_z + i), vz));
+        _mm_store_ps(result + i, d);
+    }
+#else
+    for (size_t i = 0, e = batch.size(); i < e; ++i)
+        result[i] = batch.m_x[i] * v.x + batch.m_y[i] * v.y + batch.m_z[i] * v.z;
+#endif
+}
+
+inline void transform_to_local(
+    const DirectionBatch&               batch,
+    const foundation::Basis3f&          basis,
+    DirectionBatch&                     result)
+{
+    assert(&batch != &result);
+
+    compute_dot_products(batch, basis.get_tangent_u(), result.m_x);
+    compute_dot_products(batch, basis.get_normal(), result.m_y);
+    compute_dot_products(batch, basis.get_tangent_v(), result.m_z);
+
+    result.m_size = batch.m_size;
+}
+
+}   // namespace renderer
@@ -36,6 +36,7 @@
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
 #include "renderer/modeling/bsdf/bsdfwrapper.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 #include "renderer/modeling/bsdf/fresnel.h"
 #include "renderer/modeling/bsdf/microfacethelper.h"
 #include "renderer/modeling/bsdf/specularhelper.h"
@@ -251,6 +252,67 @@ namespace
             return pdf;
         }
 
+        void evaluate_batch(
+            const void*                 data,
+            const bool                  adjoint,
+            const bool                  cosine_mult,
+            const LocalGeometry&        local_geometry,
+            const Vector3f&             outgoing,
+            const DirectionBatch&       incoming,
+            const int                   modes,
+            DirectShadingComponents*    values,
+            float*                      probabilities) const override
+        {
+            const size_t count = incoming.size();
+
+            if (!ScatteringMode::has_glossy(modes))
+            {
+                std::fill(probabilities, probabilities + count, 0.0f);
+                return;
+            }
+
+            const InputValues* input_values = static_cast<const InputValues*>(data);
+
+            float alpha_x, alpha_y;
+            microfacet_alpha_from_roughness(
+                input_values->m_roughness,
+                input_values->m_anisotropy,
+                alpha_x,
+                alpha_y);
+
+            const FresnelDielectricFun f(
+                input_values->m_reflectance,
+                input_values->m_reflectance_multiplier,
+                input_values->m_precomputed.m_outside_ior / input_values->m_ior,
+                input_values->m_fresnel_weight);
+
+            MicrofacetBRDFHelper<GGXMDF>::evaluate_batch(
+                alpha_x,
+                alpha_y,
+                f,
+                local_geometry,
+                outgoing,
+                incoming,
+                values,
+                probabilities);
+
+            // The energy compensation factor only depends on the outgoing direction.
+            const float energy_compensation_factor =
+                compute_energy_compensation_factor(
+                    input_values,
+                    outgoing,
+                    local_geometry.m_shading_basis.get_normal());
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (probabilities[i] > 0.0f)
+                {
+                    values[i].m_glossy *= energy_compensation_factor;
+                    values[i].m_beauty = values[i].m_glossy;
+                }
+            }
+        }
+
         float evaluate_pdf(
             const void*                 data,
             const bool                  adjoint,
@@ -293,21 +355,30 @@ namespace
             Spectrum&                   value)
         {
             if (values->m_energy_compensation != 0.0f)
-            {
-                const float Ess = get_directional_albedo(
-                    std::abs(dot(outgoing, n)),
-                    values->m_roughness);
+                value *= compute_energy_compensation_factor(values, outgoing, n);
+        }
+
+        static float compute_energy_compensation_factor(
+            const InputValues*          values,
+            const Vector3f&             outgoing,
+            const Vector3f&             n)
+        {
+            if (values->m_energy_compensation == 0.0f)
+                return 1.0f;
 
-                if (Ess == 0.0f)
-                    return;
+            const float Ess = get_directional_albedo(
+                std::abs(dot(outgoing, n)),
+                values->m_roughness);
 
-                float fms = (1.0f - Ess) / Ess;
+            if (Ess == 0.0f)
+                return 1.0f;
 
-                if (values->m_fresnel_weight != 0.0f)
-                    fms *= lerp(1.0f, values->m_precomputed.m_F0, values->m_fresnel_weight);
+            float fms = (1.0f - Ess) / Ess;
 
-                value *= 1.0f + (values->m_energy_compensation * fms);
-            }
+            if (values->m_fresnel_weight != 0.0f)
+                fms *= lerp(1.0f, values->m_precomputed.m_F0, values->m_fresnel_weight);
+
+            return 1.0f + (values->m_energy_compensation * fms);
         }
     };
 
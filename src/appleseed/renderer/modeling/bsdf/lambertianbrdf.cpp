@@ -36,6 +36,7 @@
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
 #include "renderer/modeling/bsdf/bsdfwrapper.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 
 // appleseed.foundation headers.
 #include "foundation/containers/dictionary.h"
@@ -47,7 +48,9 @@
 #include "foundation/utility/api/specializedapiarrays.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
@@ -156,6 +159,44 @@ namespace
             return cos_in * RcpPi<float>();
         }
 
+        void evaluate_batch(
+            const void*                 data,
+            const bool                  adjoint,
+            const bool                  cosine_mult,
+            const LocalGeometry&        local_geometry,
+            const Vector3f&             outgoing,
+            const DirectionBatch&       incoming,
+            const int                   modes,
+            DirectShadingComponents*    values,
+            float*                      probabilities) const override
+        {
+            const size_t count = incoming.size();
+
+            if (!ScatteringMode::has_diffuse(modes))
+            {
+                std::fill(probabilities, probabilities + count, 0.0f);
+                return;
+            }
+
+            // The BRDF value does not depend on the incoming direction.
+            const LambertianBRDFInputValues* input_values = static_cast<const LambertianBRDFInputValues*>(data);
+            Spectrum diffuse = input_values->m_reflectance;
+            diffuse *= input_values->m_reflectance_multiplier * RcpPi<float>();
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i].m_diffuse = diffuse;
+                values[i].m_beauty = diffuse;
+            }
+
+            // Compute the probability densities of all incoming directions at once.
+            const Vector3f& n = local_geometry.m_shading_basis.get_normal();
+            compute_dot_products(incoming, n, probabilities);
+
+            for (size_t i = 0; i < count; ++i)
+                probabilities[i] = std::abs(probabilities[i]) * RcpPi<float>();
+        }
+
         float evaluate_pdf(
             const void*                 data,
             const bool                  adjoint,
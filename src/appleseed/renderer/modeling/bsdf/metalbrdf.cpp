@@ -36,6 +36,7 @@
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
 #include "renderer/modeling/bsdf/bsdfwrapper.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 #include "renderer/modeling/bsdf/fresnel.h"
 #include "renderer/modeling/bsdf/microfacethelper.h"
 #include "renderer/modeling/bsdf/specularhelper.h"
@@ -53,6 +54,7 @@
 // Standard headers.
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 
 // Forward declarations.
 namespace foundation    { class IAbortSwitch; }
@@ -250,6 +252,70 @@ namespace
             return pdf;
         }
 
+        void evaluate_batch(
+            const void*                 data,
+            const bool                  adjoint,
+            const bool                  cosine_mult,
+            const LocalGeometry&        local_geometry,
+            const Vector3f&             outgoing,
+            const DirectionBatch&       incoming,
+            const int                   modes,
+            DirectShadingComponents*    values,
+            float*                      probabilities) const override
+        {
+            const size_t count = incoming.size();
+
+            if (!ScatteringMode::has_glossy(modes))
+            {
+                std::fill(probabilities, probabilities + count, 0.0f);
+                return;
+            }
+
+            const InputValues* input_values = static_cast<const InputValues*>(data);
+
+            float alpha_x, alpha_y;
+            microfacet_alpha_from_roughness(
+                input_values->m_roughness,
+                input_values->m_anisotropy,
+                alpha_x,
+                alpha_y);
+
+            const FresnelConductorSchlickLazanyi f(
+                input_values->m_normal_reflectance,
+                input_values->m_precomputed.m_a,
+                input_values->m_reflectance_multiplier);
+
+            MicrofacetBRDFHelper<GGXMDF>::evaluate_batch(
+                alpha_x,
+                alpha_y,
+                f,
+                local_geometry,
+                outgoing,
+                incoming,
+                values,
+                probabilities);
+
+            // The energy compensation factor only depends on the outgoing direction.
+            Spectrum fms;
+            const bool has_energy_compensation =
+                compute_energy_compensation_factor(
+                    input_values,
+                    outgoing,
+                    local_geometry.m_shading_basis.get_normal(),
+                    fms);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (probabilities[i] > 0.0f)
+                {
+                    if (has_energy_compensation)
+                        values[i].m_glossy *= fms;
+
+                    values[i].m_beauty = values[i].m_glossy;
+                }
+            }
+        }
+
         float evaluate_pdf(
             const void*                 data,
             const bool                  adjoint,
@@ -291,20 +357,32 @@ namespace
             const Vector3f&             n,
             Spectrum&                   value)
         {
-            if (values->m_energy_compensation != 0.0f)
-            {
-                const float Ess = get_directional_albedo(
-                    std::abs(dot(outgoing, n)),
-                    values->m_roughness);
+            Spectrum fms;
+            if (compute_energy_compensation_factor(values, outgoing, n, fms))
+                value *= fms;
+        }
 
-                if (Ess == 0.0f)
-                    return;
+        // Return false if no energy compensation is required.
+        static bool compute_energy_compensation_factor(
+            const InputValues*          values,
+            const Vector3f&             outgoing,
+            const Vector3f&             n,
+            Spectrum&                   fms)
+        {
+            if (values->m_energy_compensation == 0.0f)
+                return false;
 
-                Spectrum fms = values->m_normal_reflectance;
-                fms *= values->m_energy_compensation * (1.0f - Ess) / Ess;
-                fms += Spectrum(1.0f);
-                value *= fms;
-            }
+            const float Ess = get_directional_albedo(
+                std::abs(dot(outgoing, n)),
+                values->m_roughness);
+
+            if (Ess == 0.0f)
+                return false;
+
+            fms = values->m_normal_reflectance;
+            fms *= values->m_energy_compensation * (1.0f - Ess) / Ess;
+            fms += Spectrum(1.0f);
+            return true;
         }
     };
 
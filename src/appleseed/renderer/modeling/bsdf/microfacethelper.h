@@ -36,16 +36,19 @@
 #include "renderer/kernel/shading/directshadingcomponents.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 
 // appleseed.foundation headers.
 #include "foundation/math/basis.h"
 #include "foundation/math/dual.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
 
 // Standard headers.
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 
 namespace renderer
 {
@@ -214,6 +217,52 @@ class MicrofacetBRDFHelper
         return MDF::pdf(wo, m, alpha_x, alpha_y) / std::abs(4.0f * cos_oh);
     }
 
+    // Batched variant of evaluate(). The BRDF values are stored in the glossy
+    // component of `values`. MDF must provide evaluate_reflection_batch().
+    template <typename FresnelFun>
+    static void evaluate_batch(
+        const float                     alpha_x,
+        const float                     alpha_y,
+        FresnelFun                      f,
+        const BSDF::LocalGeometry&      local_geometry,
+        const foundation::Vector3f&     outgoing,
+        const DirectionBatch&           incoming,
+        DirectShadingComponents*        values,
+        float*                          probabilities)
+    {
+        const foundation::Vector3f wo = local_geometry.m_shading_basis.transform_to_local(outgoing);
+
+        DirectionBatch wi;
+        transform_to_local(incoming, local_geometry.m_shading_basis, wi);
+
+        APPLESEED_SIMD4_ALIGN float m_x[DirectionBatch::MaxSize];
+        APPLESEED_SIMD4_ALIGN float m_y[DirectionBatch::MaxSize];
+        APPLESEED_SIMD4_ALIGN float m_z[DirectionBatch::MaxSize];
+        APPLESEED_SIMD4_ALIGN float weights[DirectionBatch::MaxSize];
+
+        MDF::evaluate_reflection_batch(
+            wo,
+            wi.size(),
+            wi.m_x, wi.m_y, wi.m_z,
+            alpha_x, alpha_y,
+            m_x, m_y, m_z,
+            weights,
+            probabilities);
+
+        // Only the Fresnel term is evaluated one direction at a time.
+        const foundation::Vector3f n(0.0f, 1.0f, 0.0f);
+
+        for (size_t i = 0, e = wi.size(); i < e; ++i)
+        {
+            if (probabilities[i] > 0.0f)
+            {
+                const foundation::Vector3f m(m_x[i], m_y[i], m_z[i]);
+                f(wo, m, n, values[i].m_glossy);
+                values[i].m_glossy *= weights[i];
+            }
+        }
+    }
+
     static float pdf(
         const float                     alpha_x,
         const float                     alpha_y,
@@ -40,6 +40,7 @@
 #include "renderer/modeling/bsdf/bsdffactoryregistrar.h"
 #include "renderer/modeling/bsdf/bsdfsample.h"
 #include "renderer/modeling/bsdf/bsdfwrapper.h"
+#include "renderer/modeling/bsdf/directionbatch.h"
 #include "renderer/modeling/bsdf/glossylayerbsdf.h"
 #include "renderer/modeling/bsdf/ibsdffactory.h"
 #include "renderer/modeling/scene/assembly.h"
@@ -49,8 +50,10 @@
 #include "foundation/math/dual.h"
 #include "foundation/math/vector.h"
 #include "foundation/memory/arena.h"
+#include "foundation/platform/compiler.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
@@ -324,6 +327,67 @@ namespace
             return pdf;
         }
 
+        void evaluate_batch(
+            const void*                 data,
+            const bool                  adjoint,
+            const bool                  cosine_mult,
+            const LocalGeometry&        local_geometry,
+            const Vector3f&             outgoing,
+            const DirectionBatch&       incoming,
+            const int                   modes,
+            DirectShadingComponents*    values,
+            float*                      probabilities) const override
+        {
+            const CompositeSurfaceClosure* c = static_cast<const CompositeSurfaceClosure*>(data);
+            const size_t count = incoming.size();
+
+            LocalGeometry closure_geometry = local_geometry;
+
+            float pdfs[CompositeSurfaceClosure::MaxClosureEntries];
+            c->compute_pdfs(modes, pdfs);
+
+            std::fill(probabilities, probabilities + count, 0.0f);
+
+            DirectShadingComponents closure_values[DirectionBatch::MaxSize];
+            APPLESEED_SIMD4_ALIGN float closure_probabilities[DirectionBatch::MaxSize];
+
+            // Evaluate each closure for all incoming directions at once.
+            for (size_t i = 0, e = c->get_closure_count(); i < e; ++i)
+            {
+                if (pdfs[i] > 0.0f)
+                {
+                    closure_geometry.m_shading_basis = c->get_closure_shading_basis(i);
+
+                    for (size_t j = 0; j < count; ++j)
+                        closure_values[j].set(0.0f);
+
+                    bsdf_from_closure_id(c->get_closure_type(i))
+                        .evaluate_batch(
+                            c->get_closure_input_values(i),
+                            adjoint,
+                            false,
+                            closure_geometry,
+                            outgoing,
+                            incoming,
+                            modes,
+                            closure_values,
+                            closure_probabilities);
+
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        const float closure_pdf = pdfs[i] * closure_probabilities[j];
+
+                        if (closure_pdf > 0.0f)
+                        {
+                            apply_layers_attenuation(*c, i, outgoing, incoming[j], closure_values[j]);
+                            madd(values[j], closure_values[j], c->get_closure_weight(i));
+                            probabilities[j] += closure_pdf;
+                        }
+                    }
+                }
+            }
+        }
+
         float evaluate_pdf(
             const void*                 data,
             const bool                  adjoint,
@@ -31,10 +31,18 @@
 
 // appleseed.renderer headers.
 #include "renderer/modeling/entity/entity.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/population.h"
+#include "foundation/utility/statistics.h"
 
 // Standard headers.
 #include <cassert>
-#include <stack>
+#include <cstdint>
+#include <vector>
+
+using namespace foundation;
 
 
 namespace renderer
@@ -48,7 +56,7 @@ struct OnRenderBeginRecorder::Impl
         const BaseGroup*    m_parent;
     };
 
-    std::stack<Record> m_records;
+    std::vector<Record> m_records;
 };
 
 OnRenderBeginRecorder::OnRenderBeginRecorder()
@@ -67,17 +75,34 @@ void OnRenderBeginRecorder::record(Entity* entity, const BaseGroup* parent)
     Impl::Record record;
     record.m_entity = entity;
     record.m_parent = parent;
-    impl->m_records.push(record);
+    impl->m_records.push_back(record);
 }
 
 void OnRenderBeginRecorder::on_render_end(const Project& project)
 {
     while (!impl->m_records.empty())
     {
-        const Impl::Record& record = impl->m_records.top();
+        const Impl::Record& record = impl->m_records.back();
         record.m_entity->on_render_end(project, record.m_parent);
-        impl->m_records.pop();
+        impl->m_records.pop_back();
     }
 }
 
+void OnRenderBeginRecorder::collect_parameters_statistics(Statistics& statistics) const
+{
+    Population<std::uint64_t> sizes;
+    std::uint64_t total_size = 0;
+
+    for (const Impl::Record& record : impl->m_records)
+    {
+        const std::uint64_t size = record.m_entity->get_parameters().get_memory_size();
+        sizes.insert(size);
+        total_size += size;
+    }
+
+    statistics.insert("entities", sizes.get_size());
+    statistics.insert_size("entity parameters", total_size);
+    statistics.insert("parameters per entity", sizes, "bytes");
+}
+
 }   // namespace renderer
@@ -32,9 +32,10 @@
 #include "main/dllsymbol.h"
 
 // Forward declarations.
-namespace renderer  { class BaseGroup; }
-namespace renderer  { class Entity; }
-namespace renderer  { class Project; }
+namespace foundation    { class Statistics; }
+namespace renderer      { class BaseGroup; }
+namespace renderer      { class Entity; }
+namespace renderer      { class Project; }
 
 namespace renderer
 {
@@ -54,6 +55,9 @@ class APPLESEED_DLLSYMBOL OnRenderBeginRecorder
 
     void on_render_end(const Project& project);
 
+    // Insert statistics about the memory used by the parameters of recorded entities.
+    void collect_parameters_statistics(foundation::Statistics& statistics) const;
+
   private:
     struct Impl;
     Impl* impl;
@@ -50,6 +50,7 @@
 #include "foundation/containers/dictionary.h"
 #include "foundation/core/exceptions/exceptionioerror.h"
 #include "foundation/image/analysis.h"
+#include "foundation/image/canvasproperties.h"
 #include "foundation/image/color.h"
 #include "foundation/image/conversion.h"
 #include "foundation/image/genericimagefilereader.h"
@@ -57,8 +58,10 @@
 #include "foundation/image/genericprogressiveimagefilereader.h"
 #include "foundation/image/image.h"
 #include "foundation/image/imageattributes.h"
+#include "foundation/image/pagedimage.h"
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
+#include "foundation/image/tilepager.h"
 #include "foundation/math/filtersamplingtable.h"
 #include "foundation/math/scalar.h"
 #include "foundation/platform/defaulttimers.h"
@@ -68,7 +71,9 @@
 #include "foundation/utility/api/specializedapiarrays.h"
 #include "foundation/utility/iostreamop.h"
 #include "foundation/utility/job/iabortswitch.h"
+#include "foundation/utility/statistics.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Boost headers.
 #include "boost/filesystem.hpp"
@@ -99,6 +104,24 @@ namespace renderer
 namespace
 {
     const UniqueID g_class_uid = new_guid();
+
+    // Insert the memory used by an image into a set of statistics and return the
+    // memory saved by storing the image at its precision rather than as floats.
+    size_t insert_image_size(
+        Statistics&     stats,
+        const char*     name,
+        const Image&    image)
+    {
+        const CanvasProperties& props = image.properties();
+        const size_t size = props.m_pixel_count * props.m_pixel_size;
+        const size_t float_size = props.m_pixel_count * props.m_channel_count * sizeof(float);
+
+        stats.insert_size(
+            std::string(name) + " (" + pixel_format_name(props.m_pixel_format) + ")",
+            size);
+
+        return float_size > size ? float_size - size : 0;
+    }
 }
 
 UniqueID Frame::get_class_uid()
@@ -124,6 +147,8 @@ struct Frame::Impl
     bool                                 m_checkpoint_resume;
     std::string                          m_checkpoint_resume_path;
     std::string                          m_ref_image_path;
+    size_t                               m_tile_memory_budget;
+    std::string                          m_scratch_directory;
 
     // Child entities.
     AOVContainer                         m_aovs;
@@ -132,6 +157,7 @@ struct Frame::Impl
     PostProcessingStageContainer         m_post_processing_stages;
 
     // Images.
+    std::unique_ptr<TilePager>           m_tile_pager;
     std::unique_ptr<Image>               m_image;
     std::unique_ptr<Image>               m_ref_image;
     std::unique_ptr<ImageStack>          m_aov_images;
@@ -161,15 +187,44 @@ Frame::Frame(
 
     extract_parameters();
 
+    // Create the tile pager if tiles must be kept out-of-core.
+    if (impl->m_tile_memory_budget > 0)
+    {
+        const std::string scratch_directory =
+            impl->m_scratch_directory.empty()
+                ? bf::temp_directory_path().string()
+                : impl->m_scratch_directory;
+
+        impl->m_tile_pager.reset(
+            new TilePager(
+                scratch_directory.c_str(),
+                impl->m_tile_memory_budget * 1024 * 1024));
+    }
+
     // Create the underlying image.
-    impl->m_image.reset(
-        new Image(
-            impl->m_frame_width,
-            impl->m_frame_height,
-            impl->m_tile_width,
-            impl->m_tile_height,
-            4,
-            PixelFormatFloat));
+    if (impl->m_tile_pager)
+    {
+        impl->m_image.reset(
+            new PagedImage(
+                impl->m_frame_width,
+                impl->m_frame_height,
+                impl->m_tile_width,
+                impl->m_tile_height,
+                4,
+                PixelFormatFloat,
+                *impl->m_tile_pager));
+    }
+    else
+    {
+        impl->m_image.reset(
+            new Image(
+                impl->m_frame_width,
+                impl->m_frame_height,
+                impl->m_tile_width,
+                impl->m_tile_height,
+                4,
+                PixelFormatFloat));
+    }
 
     // Retrieve the image properties.
     m_props = impl->m_image->properties();
@@ -206,7 +261,8 @@ Frame::Frame(
             impl->m_frame_width,
             impl->m_frame_height,
             impl->m_tile_width,
-            impl->m_tile_height));
+            impl->m_tile_height,
+            impl->m_tile_pager.get()));
 
     if (aovs.size() > MaxAOVCount)
     {
@@ -282,7 +338,8 @@ void Frame::print_settings()
         "  denoising mode                %s\n"
         "  create checkpoint             %s\n"
         "  resume checkpoint             %s\n"
-        "  reference image path          %s",
+        "  reference image path          %s\n"
+        "  tile memory budget            %s",
         get_path().c_str(),
         get_uid(),
         camera_name != nullptr ? camera_name : "none",
@@ -302,7 +359,28 @@ void Frame::print_settings()
         impl->m_denoising_mode == DenoisingMode::WriteOutputs ? "write outputs" : "denoise",
         impl->m_checkpoint_create ? impl->m_checkpoint_create_path.c_str() : "off",
         impl->m_checkpoint_resume ? impl->m_checkpoint_resume_path.c_str() : "off",
-        impl->m_ref_image_path.empty() ? "n/a" : impl->m_ref_image_path.c_str());
+        impl->m_ref_image_path.empty() ? "n/a" : impl->m_ref_image_path.c_str(),
+        impl->m_tile_memory_budget > 0 ? (pretty_uint(impl->m_tile_memory_budget) + " mb").c_str() : "unlimited");
+
+    // Print the memory used by the main image and by each AOV image.
+    Statistics stats;
+    size_t saved_size = insert_image_size(stats, "beauty", *impl->m_image);
+    for (const AOV& aov : impl->m_aovs)
+        saved_size += insert_image_size(stats, aov.get_name(), aov.get_image());
+    for (const AOV& aov : impl->m_internal_aovs)
+        saved_size += insert_image_size(stats, aov.get_name(), aov.get_image());
+    stats.insert_size("saved by reduced precision", saved_size);
+    stats.insert_size(
+        "accumulation per tile",
+        ShadingResultFrameBuffer::get_storage_size(
+            impl->m_tile_width,
+            impl->m_tile_height,
+            aov_images().size()));
+
+    RENDERER_LOG_INFO("%s",
+        StatisticsVector::make(
+            "frame \"" + std::string(get_path().c_str()) + "\" storage statistics",
+            stats).to_string().c_str());
 }
 
 const AOVContainer& Frame::aovs() const
@@ -351,6 +429,22 @@ void Frame::clear_main_and_aov_images()
         aov.clear_image();
 }
 
+void Frame::release_tile(
+    const size_t            tile_x,
+    const size_t            tile_y) const
+{
+    if (impl->m_tile_pager)
+    {
+        static_cast<PagedImage*>(impl->m_image.get())->release_tile(tile_x, tile_y);
+        impl->m_aov_images->release_tiles(tile_x, tile_y);
+    }
+}
+
+TilePager* Frame::get_tile_pager() const
+{
+    return impl->m_tile_pager.get();
+}
+
 ImageStack& Frame::aov_images() const
 {
     return *impl->m_aov_images;
@@ -460,6 +554,8 @@ void Frame::denoise(
     const size_t            thread_count,
     IAbortSwitch*           abort_switch) const
 {
+    APPLESEED_TRACE_SCOPE("output", "denoise");
+
     DenoiserOptions options;
 
     const bool skip_denoised = m_params.get_optional<bool>("skip_denoised", true);
@@ -928,6 +1024,8 @@ void Frame::save_checkpoint(
     if (!impl->m_checkpoint_create)
         return;
 
+    APPLESEED_TRACE_SCOPE("output", "save checkpoint", "pass", pass_index);
+
     create_parent_directories(impl->m_checkpoint_create_path.c_str());
 
     GenericImageFileWriter writer(impl->m_checkpoint_create_path.c_str());
@@ -1032,6 +1130,8 @@ namespace
     {
         assert(file_path);
 
+        APPLESEED_TRACE_SCOPE("output", "write image");
+
         Stopwatch<DefaultWallclockTimer> stopwatch;
         stopwatch.start();
 
@@ -1232,6 +1332,8 @@ bool Frame::write_main_and_aov_images() const
 
 void Frame::write_main_and_aov_images_to_multipart_exr(const char* file_path) const
 {
+    APPLESEED_TRACE_SCOPE("output", "write multipart exr image");
+
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
@@ -1239,7 +1341,9 @@ void Frame::write_main_and_aov_images_to_multipart_exr(const char* file_path) co
     add_chromaticities_attributes(image_attributes);
     image_attributes.insert("color_space", "linear");
 
+    // Reserve storage upfront since the writer keeps pointers to these images.
     std::vector<Image> images;
+    images.reserve(impl->m_aovs.size() + 1);
 
     create_parent_directories(file_path);
 
@@ -1262,10 +1366,11 @@ void Frame::write_main_and_aov_images_to_multipart_exr(const char* file_path) co
         const std::string aov_name = aov.get_name();
         const Image& image = aov.get_image();
 
-        if (aov.has_color_data())
+        const CanvasProperties& props = image.properties();
+
+        if (aov.has_color_data() && props.m_pixel_format != PixelFormatHalf)
         {
             // If the AOV has color data, assume we can save it as half floats.
-            const CanvasProperties& props = image.properties();
             images.emplace_back(image, props.m_tile_width, props.m_tile_height, PixelFormatHalf);
             writer.append_image(&(images.back()));
         }
@@ -1495,6 +1600,10 @@ void Frame::extract_parameters()
 
     // Retrieve reference image path parameters.
     impl->m_ref_image_path = m_params.get_optional<std::string>("reference_image", "");
+
+    // Retrieve out-of-core tile storage parameters.
+    impl->m_tile_memory_budget = m_params.get_optional<size_t>("tile_memory_budget", 0);
+    impl->m_scratch_directory = m_params.get_optional<std::string>("scratch_directory", "");
 }
 
 AOVContainer& Frame::internal_aovs() const
@@ -1587,6 +1696,26 @@ DictionaryArray FrameFactory::get_input_metadata()
             .insert("use", "optional")
             .insert("default", "true"));
 
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "tile_memory_budget")
+            .insert("label", "Tile Memory Budget (MB)")
+            .insert("type", "integer")
+            .insert("min",
+                Dictionary()
+                    .insert("value", "0")
+                    .insert("type", "hard"))
+            .insert("use", "optional")
+            .insert("default", "0"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "scratch_directory")
+            .insert("label", "Scratch Directory")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", ""));
+
     metadata.push_back(
         Dictionary()
             .insert("name", "denoiser")
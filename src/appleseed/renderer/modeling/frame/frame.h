@@ -60,6 +60,7 @@ namespace foundation    { class SearchPaths; }
 namespace foundation    { class StringArray; }
 namespace foundation    { class StringDictionary; }
 namespace foundation    { class Tile; }
+namespace foundation    { class TilePager; }
 namespace renderer      { class BaseGroup; }
 namespace renderer      { class DenoiserAOV; }
 namespace renderer      { class ImageStack; }
@@ -115,6 +116,15 @@ class APPLESEED_DLLSYMBOL Frame
     // Access the AOV images.
     ImageStack& aov_images() const;
 
+    // Allow a finished tile of the main image and of the AOV images to be evicted from memory.
+    // Does nothing unless the frame has a tile memory budget.
+    void release_tile(
+        const size_t                                    tile_x,
+        const size_t                                    tile_y) const;
+
+    // Return the tile pager of the frame, or nullptr if the frame has no tile memory budget.
+    foundation::TilePager* get_tile_pager() const;
+
     // Return the sampling table for the reconstruction filter used by the main image and the AOV images.
     const foundation::FilterSamplingTable& get_filter_sampling_table() const;
 
@@ -158,6 +158,11 @@ void MeshObject::reserve_vertices(const size_t count)
     impl->m_tess.m_vertices.reserve(count);
 }
 
+void MeshObject::resize_vertices(const size_t count)
+{
+    impl->m_tess.m_vertices.resize(count);
+}
+
 size_t MeshObject::push_vertex(const GVector3& vertex)
 {
     const size_t index = impl->m_tess.m_vertices.size();
@@ -165,6 +170,11 @@ size_t MeshObject::push_vertex(const GVector3& vertex)
     return index;
 }
 
+void MeshObject::set_vertex(const size_t index, const GVector3& vertex)
+{
+    impl->m_tess.m_vertices[index] = vertex;
+}
+
 size_t MeshObject::get_vertex_count() const
 {
     return impl->m_tess.m_vertices.size();
@@ -180,6 +190,11 @@ void MeshObject::reserve_vertex_normals(const size_t count)
     impl->m_tess.m_vertex_normals.reserve(count);
 }
 
+void MeshObject::resize_vertex_normals(const size_t count)
+{
+    impl->m_tess.m_vertex_normals.resize(count);
+}
+
 size_t MeshObject::push_vertex_normal(const GVector3& normal)
 {
     assert(is_normalized(normal));
@@ -189,6 +204,13 @@ size_t MeshObject::push_vertex_normal(const GVector3& normal)
     return index;
 }
 
+void MeshObject::set_vertex_normal(const size_t index, const GVector3& normal)
+{
+    assert(is_normalized(normal));
+
+    impl->m_tess.m_vertex_normals[index] = normal;
+}
+
 size_t MeshObject::get_vertex_normal_count() const
 {
     return impl->m_tess.m_vertex_normals.size();
@@ -229,11 +251,21 @@ void MeshObject::reserve_tex_coords(const size_t count)
     impl->m_tess.reserve_tex_coords(count);
 }
 
+void MeshObject::resize_tex_coords(const size_t count)
+{
+    impl->m_tess.resize_tex_coords(count);
+}
+
 size_t MeshObject::push_tex_coords(const GVector2& tex_coords)
 {
     return impl->m_tess.push_tex_coords(tex_coords);
 }
 
+void MeshObject::set_tex_coords(const size_t index, const GVector2& tex_coords)
+{
+    impl->m_tess.set_tex_coords(index, tex_coords);
+}
+
 size_t MeshObject::get_tex_coords_count() const
 {
     return impl->m_tess.get_tex_coords_count();
@@ -249,6 +281,11 @@ void MeshObject::reserve_triangles(const size_t count)
     impl->m_tess.m_primitives.reserve(count);
 }
 
+void MeshObject::resize_triangles(const size_t count)
+{
+    impl->m_tess.m_primitives.resize(count);
+}
+
 size_t MeshObject::push_triangle(const Triangle& triangle)
 {
     const size_t index = impl->m_tess.m_primitives.size();
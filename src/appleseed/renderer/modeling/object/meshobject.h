@@ -88,14 +88,20 @@ class APPLESEED_DLLSYMBOL MeshObject
     void rasterize(ObjectRasterizer& drawer) const override;
 
     // Insert and access vertices.
+    // resize_*() and set_*() methods allow to fill arrays from multiple threads,
+    // as long as they write to different elements.
     void reserve_vertices(const size_t count);
+    void resize_vertices(const size_t count);
     size_t push_vertex(const GVector3& vertex);
+    void set_vertex(const size_t index, const GVector3& vertex);
     size_t get_vertex_count() const;
     const GVector3& get_vertex(const size_t index) const;
 
     // Insert and access vertex normals.
     void reserve_vertex_normals(const size_t count);
+    void resize_vertex_normals(const size_t count);
     size_t push_vertex_normal(const GVector3& normal);      // the normal must be unit-length
+    void set_vertex_normal(const size_t index, const GVector3& normal);
     size_t get_vertex_normal_count() const;
     const GVector3& get_vertex_normal(const size_t index) const;
     void clear_vertex_normals();
@@ -108,12 +114,15 @@ class APPLESEED_DLLSYMBOL MeshObject
 
     // Insert and access texture coordinates.
     void reserve_tex_coords(const size_t count);
+    void resize_tex_coords(const size_t count);
     size_t push_tex_coords(const GVector2& tex_coords);
+    void set_tex_coords(const size_t index, const GVector2& tex_coords);
     size_t get_tex_coords_count() const;
     GVector2 get_tex_coords(const size_t index) const;
 
     // Insert and access triangles.
     void reserve_triangles(const size_t count);
+    void resize_triangles(const size_t count);
     size_t push_triangle(const Triangle& triangle);
     size_t get_triangle_count() const;
     const Triangle& get_triangle(const size_t index) const;
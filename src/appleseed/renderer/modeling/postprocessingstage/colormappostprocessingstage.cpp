@@ -56,6 +56,7 @@
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/api/specializedapiarrays.h"
 #include "foundation/utility/countof.h"
+#include "foundation/utility/job/parallelloop.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/otherwise.h"
 #include "foundation/utility/searchpaths.h"
@@ -199,7 +200,9 @@ namespace
             return true;
         }
 
-        void execute(Frame& frame) const override
+        using PostProcessingStage::execute;
+
+        void execute(Frame& frame, ParallelLoop& loop) const override
         {
             float min_luminance, max_luminance;
 
@@ -209,7 +212,8 @@ namespace
                     frame.image(),
                     frame.get_crop_window(),
                     min_luminance,
-                    max_luminance);
+                    max_luminance,
+                    &loop);
             }
             else
             {
@@ -234,7 +238,8 @@ namespace
                 frame.image(),
                 frame.get_crop_window(),
                 min_luminance,
-                max_luminance);
+                max_luminance,
+                &loop);
 
             if (m_render_isolines)
                 render_isoline_segments(frame, isoline_segments);
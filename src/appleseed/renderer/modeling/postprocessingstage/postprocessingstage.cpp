@@ -30,9 +30,19 @@
 #include "postprocessingstage.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/modeling/frame/frame.h"
 #include "renderer/utility/messagecontext.h"
 #include "renderer/utility/paramarray.h"
 
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/image.h"
+#include "foundation/utility/job/parallelloop.h"
+
+// Standard headers.
+#include <cassert>
+
 using namespace foundation;
 
 namespace renderer
@@ -64,4 +74,48 @@ PostProcessingStage::PostProcessingStage(
     m_order = m_params.get_required<int>("order", 0, context);
 }
 
+bool PostProcessingStage::is_tile_local() const
+{
+    return false;
+}
+
+void PostProcessingStage::execute(
+    Frame&              frame) const
+{
+    ParallelLoop loop(global_logger(), 1);
+    execute(frame, loop);
+}
+
+void PostProcessingStage::execute(
+    Frame&              frame,
+    ParallelLoop&       loop) const
+{
+    // Stages that are not tile-local and only implement the sequential execute() method.
+    if (!is_tile_local())
+    {
+        execute(frame);
+        return;
+    }
+
+    const CanvasProperties& props = frame.image().properties();
+
+    loop.run(
+        props.m_tile_count,
+        [this, &frame, &props](const size_t tile_index, const size_t thread_index)
+        {
+            execute_on_tile(
+                frame,
+                tile_index % props.m_tile_count_x,
+                tile_index / props.m_tile_count_x);
+        });
+}
+
+void PostProcessingStage::execute_on_tile(
+    Frame&              frame,
+    const size_t        tile_x,
+    const size_t        tile_y) const
+{
+    assert(!"Tile-local post-processing stages must implement execute_on_tile().");
+}
+
 }   // namespace renderer
@@ -37,9 +37,13 @@
 // appleseed.main headers.
 #include "main/dllsymbol.h"
 
+// Standard headers.
+#include <cstddef>
+
 // Forward declarations.
-namespace renderer  { class Frame; }
-namespace renderer  { class ParamArray; }
+namespace foundation    { class ParallelLoop; }
+namespace renderer      { class Frame; }
+namespace renderer      { class ParamArray; }
 
 namespace renderer
 {
@@ -62,9 +66,31 @@ class APPLESEED_DLLSYMBOL PostProcessingStage
     // Return the order number of this stage. Stages are executed in increasing order.
     int get_order() const;
 
-    // Execute this post-processing stage on a given frame.
+    // Return true if this stage processes each tile of the frame independently of the
+    // other tiles. Consecutive tile-local stages are fused into a single pass over the frame.
+    // Tile-local stages must implement execute_on_tile(); other stages must override at
+    // least one of the two execute() methods.
+    virtual bool is_tile_local() const;
+
+    // Execute this post-processing stage on a given frame, in the calling thread.
+    // The default implementation calls the parallel execute() method with a loop
+    // that executes all iterations in the calling thread.
+    virtual void execute(
+        Frame&                      frame) const;
+
+    // Execute this post-processing stage on a given frame. Tiles may be processed in parallel
+    // using the provided loop. The default implementation calls execute_on_tile() on all tiles
+    // of tile-local stages, and calls execute(frame) for other stages.
     virtual void execute(
-        Frame&                  frame) const = 0;
+        Frame&                      frame,
+        foundation::ParallelLoop&   loop) const;
+
+    // Execute this post-processing stage on a given tile of a frame.
+    // Only called on tile-local stages, possibly from multiple threads concurrently.
+    virtual void execute_on_tile(
+        Frame&                      frame,
+        const size_t                tile_x,
+        const size_t                tile_y) const;
 
   private:
     int m_order;
@@ -113,6 +113,8 @@ namespace
             return true;
         }
 
+        using PostProcessingStage::execute;
+
         void execute(Frame& frame) const override
         {
             // Render stamp settings.
@@ -38,6 +38,7 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
+#include "foundation/image/tile.h"
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/api/specializedapiarrays.h"
@@ -94,20 +95,31 @@ namespace
             return true;
         }
 
-        void execute(Frame& frame) const override
+        bool is_tile_local() const override
+        {
+            return true;
+        }
+
+        void execute_on_tile(
+            Frame&                  frame,
+            const std::size_t       tile_x,
+            const std::size_t       tile_y) const override
         {
             const CanvasProperties& props = frame.image().properties();
             const Vector2f resolution(static_cast<float>(props.m_canvas_width), static_cast<float>(props.m_canvas_height));
             const Vector2f normalization_factor(lerp(resolution.y, resolution.x, m_anisotropy), resolution.y);
 
-            Image& image = frame.image();
+            Tile& tile = frame.image().tile(tile_x, tile_y);
+            const std::size_t origin_x = tile_x * props.m_tile_width;
+            const std::size_t origin_y = tile_y * props.m_tile_height;
 
-            for (std::size_t y = 0; y < props.m_canvas_height; ++y)
+            for (std::size_t y = 0, h = tile.get_height(); y < h; ++y)
             {
-                for (std::size_t x = 0; x < props.m_canvas_width; ++x)
+                for (std::size_t x = 0, w = tile.get_width(); x < w; ++x)
                 {
                     // Pixel coordinate normalized to be in the [-1, 1] range vertically.
-                    const Vector2f coord = (2.0f * Vector2f(static_cast<float>(x), static_cast<float>(y)) - resolution) / normalization_factor;
+                    const Vector2f coord =
+                        (2.0f * Vector2f(static_cast<float>(origin_x + x), static_cast<float>(origin_y + y)) - resolution) / normalization_factor;
 
                     //
                     // Port of Keijiro Takahashi's natural vignetting effect for Unity.
@@ -126,11 +138,11 @@ namespace
                     const float inverse_biquadratic_radial_falloff = 1.0f / (quadratic_radial_falloff * quadratic_radial_falloff);
 
                     Color4f pixel;
-                    image.get_pixel(x, y, pixel);
+                    tile.get_pixel(x, y, pixel);
 
                     pixel.rgb() *= inverse_biquadratic_radial_falloff;
 
-                    image.set_pixel(x, y, pixel);
+                    tile.set_pixel(x, y, pixel);
                 }
             }
         }
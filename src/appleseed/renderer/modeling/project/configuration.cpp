@@ -115,7 +115,7 @@ Dictionary Configuration::get_metadata()
         "sampling_mode",
         Dictionary()
             .insert("type", "enum")
-            .insert("values", "rng|qmc")
+            .insert("values", "rng|qmc|sobol")
             .insert("default", "qmc")
             .insert("label", "Sampler")
             .insert("help", "Sampling algorithm used in Monte Carlo integration")
@@ -131,7 +131,12 @@ Dictionary Configuration::get_metadata()
                         "qmc",
                         Dictionary()
                             .insert("label", "QMC")
-                            .insert("help", "Quasi Monte Carlo sampler"))));
+                            .insert("help", "Quasi Monte Carlo sampler"))
+                    .insert(
+                        "sobol",
+                        Dictionary()
+                            .insert("label", "Sobol")
+                            .insert("help", "Owen-scrambled Sobol sampler"))));
 
     metadata.dictionaries().insert(
         "passes",
@@ -170,6 +175,24 @@ Dictionary Configuration::get_metadata()
             .insert("label", "Render Threads")
             .insert("help", "Number of threads to use for rendering"));
 
+    metadata.insert(
+        "profile_shading",
+        Dictionary()
+            .insert("type", "bool")
+            .insert("label", "Profile Shading")
+            .insert("help", "Report the time spent executing shaders, tracing rays and sampling BSDFs for each material and object instance"));
+
+#ifdef APPLESEED_WITH_TRACING
+
+    metadata.insert(
+        "trace_file",
+        Dictionary()
+            .insert("type", "text")
+            .insert("label", "Trace File")
+            .insert("help", "Path of a file where a timeline of the rendering process is written in the Chrome trace event format"));
+
+#endif
+
 #ifdef APPLESEED_WITH_EMBREE
 
     metadata.insert(
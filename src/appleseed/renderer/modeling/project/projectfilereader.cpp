@@ -45,6 +45,7 @@
 // appleseed.foundation headers.
 #include "foundation/string/string.h"
 #include "foundation/utility/stopwatch.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
 #include <string>
@@ -86,6 +87,8 @@ auto_release_ptr<Project> ProjectFileReader::read(
     if (is_builtin_project(project_filepath, project_name))
         return load_builtin(project_name.c_str());
 
+    APPLESEED_TRACE_SCOPE("setup", "read project");
+
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
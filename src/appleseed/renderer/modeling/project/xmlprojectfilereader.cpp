@@ -64,7 +64,9 @@
 #include "renderer/modeling/material/imaterialfactory.h"
 #include "renderer/modeling/material/material.h"
 #include "renderer/modeling/material/materialfactoryregistrar.h"
+#include "renderer/modeling/object/curveobject.h"
 #include "renderer/modeling/object/iobjectfactory.h"
+#include "renderer/modeling/object/meshobject.h"
 #include "renderer/modeling/object/object.h"
 #include "renderer/modeling/object/objectfactoryregistrar.h"
 #include "renderer/modeling/postprocessingstage/ipostprocessingstagefactory.h"
@@ -100,6 +102,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/containers/dictionary.h"
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/core/exceptions/exceptionunsupportedfileformat.h"
 #include "foundation/log/log.h"
 #include "foundation/math/aabb.h"
@@ -110,12 +113,16 @@
 #include "foundation/memory/memory.h"
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/system.h"
 #include "foundation/platform/types.h"
 #include "foundation/string/string.h"
 #include "foundation/utility/api/apiarray.h"
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/iterators.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobmanager.h"
+#include "foundation/utility/job/jobqueue.h"
 #include "foundation/utility/otherwise.h"
 #include "foundation/utility/searchpaths.h"
 #include "foundation/utility/stopwatch.h"
@@ -134,9 +141,11 @@
 #include "boost/filesystem/operations.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <deque>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -204,6 +213,272 @@ namespace
     };
 
 
+    //
+    // Create the objects defined by an <object> element, reporting errors to the log.
+    // This function is called from the loading threads when object files are read in parallel.
+    //
+
+    bool create_objects(
+        const IObjectFactory&           factory,
+        const std::string&              name,
+        const ParamArray&               params,
+        const SearchPaths&              search_paths,
+        const bool                      omit_loading_assets,
+        ObjectArray&                    objects)
+    {
+        try
+        {
+            return
+                factory.create(
+                    name.c_str(),
+                    params,
+                    search_paths,
+                    omit_loading_assets,
+                    objects);
+        }
+        catch (const ExceptionDictionaryKeyNotFound& e)
+        {
+            RENDERER_LOG_ERROR(
+                "while defining object \"%s\": required parameter \"%s\" missing.",
+                name.c_str(),
+                e.string());
+        }
+        catch (const ExceptionUnknownEntity& e)
+        {
+            RENDERER_LOG_ERROR(
+                "while defining object \"%s\": unknown entity \"%s\".",
+                name.c_str(),
+                e.string());
+        }
+        catch (const Exception& e)
+        {
+            RENDERER_LOG_ERROR(
+                "while defining object \"%s\": %s",
+                name.c_str(),
+                e.what());
+        }
+
+        return false;
+    }
+
+
+    //
+    // Deferred, parallel loading of object files.
+    //
+    // Objects whose geometry must be read from disk (mesh and curve files) are queued
+    // while the project file is parsed, then loaded concurrently once parsing is over.
+    // The number of files being read at any given time is bounded by the number of
+    // loading threads. Loaded objects are inserted into their assembly in declaration
+    // order, so the resulting project does not depend on the order of completion.
+    //
+
+    class ObjectLoadingQueue
+      : public NonCopyable
+    {
+      public:
+        // A run of objects inside an assembly: either already created, or pending.
+        struct Slot
+        {
+            std::vector<Object*>    m_objects;
+            size_t                  m_ticket;
+
+            Slot()
+              : m_ticket(~size_t(0))
+            {
+            }
+
+            bool is_pending() const
+            {
+                return m_ticket != ~size_t(0);
+            }
+        };
+
+        typedef std::vector<Slot> SlotVector;
+
+        ~ObjectLoadingQueue()
+        {
+            for (Request& request : m_requests)
+            {
+                for (size_t i = 0, e = request.m_objects.size(); i < e; ++i)
+                    request.m_objects[i]->release();
+            }
+
+            for (PendingAssembly& pending_assembly : m_pending_assemblies)
+            {
+                for (Slot& slot : pending_assembly.m_slots)
+                {
+                    for (Object* object : slot.m_objects)
+                        object->release();
+                }
+            }
+        }
+
+        bool empty() const
+        {
+            return m_requests.empty();
+        }
+
+        // Queue the creation of objects; return a ticket identifying the request.
+        size_t enqueue(
+            const IObjectFactory&       factory,
+            const std::string&          name,
+            const ParamArray&           params,
+            const SearchPaths&          search_paths)
+        {
+            m_requests.emplace_back(factory, name, params, search_paths);
+            return m_requests.size() - 1;
+        }
+
+        // Defer the insertion of objects into a given assembly until all requests are completed.
+        void defer_insertion(Assembly& assembly, SlotVector& slots)
+        {
+            m_pending_assemblies.emplace_back();
+            m_pending_assemblies.back().m_assembly = &assembly;
+            m_pending_assemblies.back().m_slots.swap(slots);
+        }
+
+        // Execute all queued requests and insert the resulting objects into their assembly.
+        void complete(EventCounters& event_counters)
+        {
+            const size_t thread_count =
+                std::min(System::get_logical_cpu_core_count(), m_requests.size());
+
+            if (thread_count > 1)
+            {
+                RENDERER_LOG_INFO(
+                    "loading " FMT_SIZE_T " object files using " FMT_SIZE_T " %s...",
+                    m_requests.size(),
+                    thread_count,
+                    plural(thread_count, "thread").c_str());
+
+                JobQueue job_queue;
+                for (Request& request : m_requests)
+                    job_queue.schedule(new LoadingJob(request));
+
+                JobManager job_manager(
+                    global_logger(),
+                    job_queue,
+                    thread_count,
+                    JobManager::KeepRunningOnJobFailure);
+
+                job_manager.start();
+                job_queue.wait_until_completion();
+            }
+            else
+            {
+                for (Request& request : m_requests)
+                    LoadingJob(request).execute(0);
+            }
+
+            for (const Request& request : m_requests)
+            {
+                if (!request.m_success)
+                    event_counters.signal_error();
+            }
+
+            for (PendingAssembly& pending_assembly : m_pending_assemblies)
+            {
+                ObjectContainer& objects = pending_assembly.m_assembly->objects();
+
+                for (Slot& slot : pending_assembly.m_slots)
+                {
+                    if (slot.is_pending())
+                    {
+                        ObjectArray& slot_objects = m_requests[slot.m_ticket].m_objects;
+                        for (size_t i = 0, e = slot_objects.size(); i < e; ++i)
+                            insert(objects, auto_release_ptr<Object>(slot_objects[i]), event_counters);
+                        slot_objects.clear();
+                    }
+                    else
+                    {
+                        for (Object* object : slot.m_objects)
+                            insert(objects, auto_release_ptr<Object>(object), event_counters);
+                        slot.m_objects.clear();
+                    }
+                }
+            }
+
+            m_pending_assemblies.clear();
+            m_requests.clear();
+        }
+
+      private:
+        struct Request
+        {
+            const IObjectFactory&       m_factory;
+            const std::string           m_name;
+            const ParamArray            m_params;
+            const SearchPaths&          m_search_paths;
+            ObjectArray                 m_objects;
+            bool                        m_success;
+
+            Request(
+                const IObjectFactory&   factory,
+                const std::string&      name,
+                const ParamArray&       params,
+                const SearchPaths&      search_paths)
+              : m_factory(factory)
+              , m_name(name)
+              , m_params(params)
+              , m_search_paths(search_paths)
+              , m_success(false)
+            {
+            }
+        };
+
+        struct PendingAssembly
+        {
+            Assembly*                   m_assembly;
+            SlotVector                  m_slots;
+        };
+
+        class LoadingJob
+          : public IJob
+        {
+          public:
+            explicit LoadingJob(Request& request)
+              : m_request(request)
+            {
+            }
+
+            void execute(const size_t thread_index) override
+            {
+                m_request.m_success =
+                    create_objects(
+                        m_request.m_factory,
+                        m_request.m_name,
+                        m_request.m_params,
+                        m_request.m_search_paths,
+                        false,
+                        m_request.m_objects);
+            }
+
+          private:
+            Request&                    m_request;
+        };
+
+        std::deque<Request>             m_requests;
+        std::vector<PendingAssembly>    m_pending_assemblies;
+
+        static void insert(
+            ObjectContainer&            objects,
+            auto_release_ptr<Object>    object,
+            EventCounters&              event_counters)
+        {
+            if (objects.get_by_name(object->get_name()) != nullptr)
+            {
+                RENDERER_LOG_ERROR(
+                    "an entity with the path \"%s\" already exists.",
+                    object->get_path().c_str());
+                event_counters.signal_error();
+                return;
+            }
+
+            objects.insert(object);
+        }
+    };
+
+
     //
     // A set of objects that is passed to all element handlers.
     //
@@ -236,10 +511,16 @@ namespace
             return m_event_counters;
         }
 
+        ObjectLoadingQueue& get_object_loading_queue()
+        {
+            return m_object_loading_queue;
+        }
+
       private:
         Project&            m_project;
         const int           m_options;
         EventCounters&      m_event_counters;
+        ObjectLoadingQueue  m_object_loading_queue;
     };
 
 
@@ -1536,6 +1817,7 @@ namespace
             ParametrizedElementHandler::start_element(attrs);
 
             clear_keep_memory(m_objects);
+            m_ticket = ~size_t(0);
 
             m_name = get_value(attrs, "name");
             m_model = get_value(attrs, "model");
@@ -1545,57 +1827,41 @@ namespace
         {
             ParametrizedElementHandler::end_element();
 
-            try
-            {
-                const IObjectFactory* factory =
-                    m_context.get_project().get_factory_registrar<Object>().lookup(m_model.c_str());
+            const IObjectFactory* factory =
+                m_context.get_project().get_factory_registrar<Object>().lookup(m_model.c_str());
 
-                if (factory)
-                {
-                    ObjectArray objects;
-                    if (!factory->create(
-                            m_name.c_str(),
-                            m_params,
-                            m_context.get_project().search_paths(),
-                            m_context.get_options() & ProjectFileReader::OmitReadingMeshFiles,
-                            objects))
-                        m_context.get_event_counters().signal_error();
-
-                    m_objects = array_vector<ObjectVector>(objects);
-                }
-                else
-                {
-                    RENDERER_LOG_ERROR(
-                        "while defining object \"%s\": invalid model \"%s\".",
-                        m_name.c_str(),
-                        m_model.c_str());
-                    m_context.get_event_counters().signal_error();
-                }
-            }
-            catch (const ExceptionDictionaryKeyNotFound& e)
+            if (factory == nullptr)
             {
                 RENDERER_LOG_ERROR(
-                    "while defining object \"%s\": required parameter \"%s\" missing.",
+                    "while defining object \"%s\": invalid model \"%s\".",
                     m_name.c_str(),
-                    e.string());
+                    m_model.c_str());
                 m_context.get_event_counters().signal_error();
+                return;
             }
-            catch (const ExceptionUnknownEntity& e)
+
+            if (is_deferrable())
             {
-                RENDERER_LOG_ERROR(
-                    "while defining object \"%s\": unknown entity \"%s\".",
-                    m_name.c_str(),
-                    e.string());
-                m_context.get_event_counters().signal_error();
+                m_ticket =
+                    m_context.get_object_loading_queue().enqueue(
+                        *factory,
+                        m_name,
+                        m_params,
+                        m_context.get_project().search_paths());
+                return;
             }
-            catch (const Exception& e)
-            {
-                RENDERER_LOG_ERROR(
-                    "while defining object \"%s\": %s",
-                    m_name.c_str(),
-                    e.what());
+
+            ObjectArray objects;
+            if (!create_objects(
+                    *factory,
+                    m_name,
+                    m_params,
+                    m_context.get_project().search_paths(),
+                    (m_context.get_options() & ProjectFileReader::OmitReadingMeshFiles) != 0,
+                    objects))
                 m_context.get_event_counters().signal_error();
-            }
+
+            m_objects = array_vector<ObjectVector>(objects);
         }
 
         const ObjectVector& get_objects() const
@@ -1603,11 +1869,40 @@ namespace
             return m_objects;
         }
 
+        // Return true if the creation of the objects was deferred to the object loading queue.
+        bool is_deferred() const
+        {
+            return m_ticket != ~size_t(0);
+        }
+
+        size_t get_ticket() const
+        {
+            return m_ticket;
+        }
+
       private:
         ParseContext&   m_context;
         ObjectVector    m_objects;
+        size_t          m_ticket;
         std::string     m_name;
         std::string     m_model;
+
+        // Only built-in objects that read a file from disk are loaded in parallel.
+        bool is_deferrable() const
+        {
+            const int options = m_context.get_options();
+
+            if (options & (ProjectFileReader::OmitReadingMeshFiles | ProjectFileReader::OmitParallelObjectLoading))
+                return false;
+
+            if (m_model == MeshObjectFactory().get_model())
+                return m_params.strings().exist("filename");
+
+            if (m_model == CurveObjectFactory().get_model())
+                return m_params.strings().exist("filepath");
+
+            return false;
+        }
     };
 
 
@@ -2087,6 +2382,7 @@ namespace
             m_lights.clear();
             m_materials.clear();
             m_objects.clear();
+            m_object_slots.clear();
             m_object_instances.clear();
             m_volumes.clear();
             m_shader_groups.clear();
@@ -2124,6 +2420,9 @@ namespace
                 m_assembly->surface_shaders().swap(m_surface_shaders);
                 m_assembly->textures().swap(m_textures);
                 m_assembly->texture_instances().swap(m_texture_instances);
+
+                if (!m_object_slots.empty())
+                    m_context.get_object_loading_queue().defer_insertion(m_assembly.ref(), m_object_slots);
             }
             else
             {
@@ -2190,8 +2489,25 @@ namespace
                 break;
 
               case ElementObject:
-                for (Object* object : static_cast<ObjectElementHandler*>(handler)->get_objects())
-                    insert(m_objects, auto_release_ptr<Object>(object));
+                {
+                    ObjectElementHandler* object_handler = static_cast<ObjectElementHandler*>(handler);
+
+                    // As soon as one object is deferred, all following objects of this assembly
+                    // are deferred as well, to preserve their declaration order.
+                    if (object_handler->is_deferred() || !m_object_slots.empty())
+                    {
+                        ObjectLoadingQueue::Slot slot;
+                        if (object_handler->is_deferred())
+                            slot.m_ticket = object_handler->get_ticket();
+                        else slot.m_objects = object_handler->get_objects();
+                        m_object_slots.push_back(slot);
+                    }
+                    else
+                    {
+                        for (Object* object : object_handler->get_objects())
+                            insert(m_objects, auto_release_ptr<Object>(object));
+                    }
+                }
                 break;
 
               case ElementObjectInstance:
@@ -2254,6 +2570,7 @@ namespace
         LightContainer              m_lights;
         MaterialContainer           m_materials;
         ObjectContainer             m_objects;
+        ObjectLoadingQueue::SlotVector m_object_slots;
         ObjectInstanceContainer     m_object_instances;
         VolumeContainer             m_volumes;
         ShaderGroupContainer        m_shader_groups;
@@ -3338,6 +3655,15 @@ auto_release_ptr<Project> XMLProjectFileReader::load_project_file(
         error_handler->get_fatal_error_count() > 0)
         return auto_release_ptr<Project>(nullptr);
 
+    // Load object files whose loading was deferred during parsing.
+    if (!context.get_object_loading_queue().empty())
+    {
+        context.get_object_loading_queue().complete(event_counters);
+
+        if (event_counters.has_errors())
+            return auto_release_ptr<Project>(nullptr);
+    }
+
     return project;
 }
 
@@ -68,6 +68,7 @@ ArchiveAssembly::ArchiveAssembly(
     const ParamArray&   params)
   : ProceduralAssembly(name, params)
   , m_archive_opened(false)
+  , m_loading_failed(false)
 {
 }
 
@@ -90,7 +91,39 @@ void ArchiveAssembly::collect_asset_paths(StringArray& paths) const
 void ArchiveAssembly::update_asset_paths(const StringDictionary& mappings)
 {
     if (m_params.strings().exist("filename"))
+    {
         m_params.set("filename", mappings.get(m_params.get("filename")));
+
+        // The archive may be found at its new location.
+        m_loading_failed = false;
+    }
+}
+
+bool ArchiveAssembly::needs_loading() const
+{
+    return !m_archive_opened && !m_loading_failed && m_loaded_assembly.get() == nullptr;
+}
+
+void ArchiveAssembly::load_archive(
+    const SearchPaths&  search_paths,
+    const int           options)
+{
+    if (!needs_loading())
+        return;
+
+    // Establish and store the qualified path to the archive project.
+    const std::string filepath =
+        to_string(search_paths.qualify(m_params.get_required<std::string>("filename", "")));
+
+    m_loaded_assembly =
+        ProjectFileReader::read_archive(
+            filepath.c_str(),
+            nullptr,  // for now, we don't validate archives
+            search_paths,
+            ProjectFileReader::OmitProjectSchemaValidation | options);
+
+    // Don't read the archive again, the error was already reported.
+    m_loading_failed = m_loaded_assembly.get() == nullptr;
 }
 
 bool ArchiveAssembly::do_expand_contents(
@@ -100,21 +133,13 @@ bool ArchiveAssembly::do_expand_contents(
 {
     if (!m_archive_opened)
     {
-        // Establish and store the qualified path to the archive project.
-        const SearchPaths& search_paths = project.search_paths();
-        const std::string filepath =
-            to_string(search_paths.qualify(m_params.get_required<std::string>("filename", "")));
-
-        auto_release_ptr<Assembly> assembly =
-            ProjectFileReader::read_archive(
-                filepath.c_str(),
-                nullptr,  // for now, we don't validate archives
-                search_paths,
-                ProjectFileReader::OmitProjectSchemaValidation);
-
-        if (assembly.get())
+        if (needs_loading())
+            load_archive(project.search_paths(), 0);
+
+        if (m_loaded_assembly.get())
         {
-            swap_contents(*assembly);
+            swap_contents(*m_loaded_assembly);
+            m_loaded_assembly.reset();
             m_archive_opened = true;
         }
     }
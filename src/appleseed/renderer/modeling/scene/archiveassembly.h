@@ -44,6 +44,7 @@
 namespace foundation    { class Dictionary; }
 namespace foundation    { class DictionaryArray; }
 namespace foundation    { class IAbortSwitch; }
+namespace foundation    { class SearchPaths; }
 namespace foundation    { class StringArray; }
 namespace foundation    { class StringDictionary; }
 namespace renderer      { class ParamArray; }
@@ -71,6 +72,17 @@ class APPLESEED_DLLSYMBOL ArchiveAssembly
     void collect_asset_paths(foundation::StringArray& paths) const override;
     void update_asset_paths(const foundation::StringDictionary& mappings) override;
 
+    // Return true if the archive still needs to be read from disk. Archives that failed
+    // to load are only read again once their file path has been updated.
+    bool needs_loading() const;
+
+    // Read the archive from disk without modifying this assembly; its contents are
+    // swapped in when the assembly is expanded. Different archive assemblies may be
+    // loaded concurrently.
+    void load_archive(
+        const foundation::SearchPaths&  search_paths,
+        const int                       options);
+
   private:
     friend class ArchiveAssemblyFactory;
 
@@ -85,7 +97,9 @@ class APPLESEED_DLLSYMBOL ArchiveAssembly
         const Assembly*             parent,
         foundation::IAbortSwitch*   abort_switch = nullptr) override;
 
-    bool m_archive_opened;
+    bool                                    m_archive_opened;
+    bool                                    m_loading_failed;
+    foundation::auto_release_ptr<Assembly>  m_loaded_assembly;
 };
 
 
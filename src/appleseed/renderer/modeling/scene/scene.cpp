@@ -31,6 +31,7 @@
 #include "scene.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
 #ifdef APPLESEED_WITH_EMBREE
 #include "renderer/kernel/intersection/embreescene.h"
 #endif
@@ -41,6 +42,8 @@
 #include "renderer/modeling/frame/frame.h"
 #include "renderer/modeling/object/object.h"
 #include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project/projectfilereader.h"
+#include "renderer/modeling/scene/archiveassembly.h"
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
 #include "renderer/modeling/scene/objectinstance.h"
@@ -55,12 +58,21 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/vector.h"
+#include "foundation/platform/system.h"
+#include "foundation/string/string.h"
 #include "foundation/utility/api/specializedapiarrays.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobmanager.h"
+#include "foundation/utility/job/jobqueue.h"
+#include "foundation/utility/searchpaths.h"
+#include "foundation/utility/tracerecorder.h"
 
 // Standard headers.
+#include <algorithm>
 #include <set>
+#include <vector>
 
 using namespace foundation;
 
@@ -309,6 +321,97 @@ void Scene::update_asset_paths(const StringDictionary& mappings)
 
 namespace
 {
+    void collect_archive_assemblies_to_load(
+        AssemblyContainer&                  assemblies,
+        std::vector<ArchiveAssembly*>&      archives)
+    {
+        for (each<AssemblyContainer> i = assemblies; i; ++i)
+        {
+            ArchiveAssembly* archive = dynamic_cast<ArchiveAssembly*>(&*i);
+
+            if (archive && archive->needs_loading())
+                archives.push_back(archive);
+            else collect_archive_assemblies_to_load(i->assemblies(), archives);
+        }
+    }
+
+    class ArchiveLoadingJob
+      : public IJob
+    {
+      public:
+        ArchiveLoadingJob(
+            ArchiveAssembly&                archive,
+            const SearchPaths&              search_paths)
+          : m_archive(archive)
+          , m_search_paths(search_paths)
+        {
+        }
+
+        void execute(const size_t thread_index) override
+        {
+            // Archives are already read in parallel, read their own object files sequentially.
+            m_archive.load_archive(m_search_paths, ProjectFileReader::OmitParallelObjectLoading);
+        }
+
+      private:
+        ArchiveAssembly&                    m_archive;
+        const SearchPaths&                  m_search_paths;
+    };
+
+    // Read archive assemblies from disk concurrently, one level of nesting at a time.
+    // Archives are then swapped in sequentially, in declaration order, during expansion.
+    void load_archive_assemblies(
+        AssemblyContainer&                  assemblies,
+        const Project&                      project,
+        IAbortSwitch*                       abort_switch)
+    {
+        while (!is_aborted(abort_switch))
+        {
+            std::vector<ArchiveAssembly*> archives;
+            collect_archive_assemblies_to_load(assemblies, archives);
+
+            if (archives.size() < 2)
+                break;
+
+            const size_t thread_count =
+                std::min(System::get_logical_cpu_core_count(), archives.size());
+
+            RENDERER_LOG_INFO(
+                "loading " FMT_SIZE_T " archives using " FMT_SIZE_T " %s...",
+                archives.size(),
+                thread_count,
+                plural(thread_count, "thread").c_str());
+
+            JobQueue job_queue;
+            for (ArchiveAssembly* archive : archives)
+                job_queue.schedule(new ArchiveLoadingJob(*archive, project.search_paths()));
+
+            JobManager job_manager(
+                global_logger(),
+                job_queue,
+                thread_count,
+                JobManager::KeepRunningOnJobFailure);
+
+            job_manager.start();
+            job_queue.wait_until_completion();
+            job_manager.stop();
+
+            // Swap in the loaded archives so that nested archives can be discovered.
+            bool any_loaded = false;
+            for (ArchiveAssembly* archive : archives)
+            {
+                if (!archive->needs_loading())
+                {
+                    archive->expand_contents(project, nullptr, abort_switch);
+                    any_loaded = true;
+                }
+            }
+
+            if (!any_loaded)
+                break;
+        }
+    }
+
     bool invoke_procedural_expand(
         Assembly&               assembly,
         const Project&          project,
@@ -338,6 +441,8 @@ bool Scene::expand_procedural_assemblies(
     const Project&          project,
     IAbortSwitch*           abort_switch)
 {
+    load_archive_assemblies(assemblies(), project, abort_switch);
+
     for (each<AssemblyContainer> i = assemblies(); i; ++i)
     {
         if (!invoke_procedural_expand(*i, project, nullptr, abort_switch))
@@ -353,6 +458,8 @@ bool Scene::on_render_begin(
     OnRenderBeginRecorder&  recorder,
     IAbortSwitch*           abort_switch)
 {
+    APPLESEED_TRACE_SCOPE("setup", "prepare scene");
+
     if (!Entity::on_render_begin(project, parent, recorder, abort_switch))
         return false;
 
@@ -41,6 +41,7 @@
 #include "foundation/utility/api/apistring.h"
 #include "foundation/utility/api/specializedapiarrays.h"
 #include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/tracerecorder.h"
 #include "foundation/utility/uid.h"
 
 // Boost headers.
@@ -124,6 +125,8 @@ void ShaderGroup::clear()
     impl->m_connections.clear();
     impl->m_shader_group_ref.reset();
     m_flags = 0;
+
+    bump_version_id();
 }
 
 void ShaderGroup::add_shader(
@@ -141,6 +144,8 @@ void ShaderGroup::add_shader(
 
     impl->m_shaders.insert(shader);
 
+    bump_version_id();
+
     RENDERER_LOG_DEBUG("created shader %s, layer = %s.", name, layer);
 }
 
@@ -161,6 +166,8 @@ void ShaderGroup::add_source_shader(
 
     impl->m_shaders.insert(shader);
 
+    bump_version_id();
+
     RENDERER_LOG_DEBUG("created source shader %s, layer = %s.", name, layer);
 }
 
@@ -179,6 +186,8 @@ void ShaderGroup::add_connection(
 
     impl->m_connections.insert(connection);
 
+    bump_version_id();
+
     RENDERER_LOG_DEBUG(
         "created shader connection: src_layer = %s, src_param = %s, dst_layer = %s, dst_param = %s.",
             src_layer,
@@ -195,6 +204,8 @@ bool ShaderGroup::create_optimized_osl_shader_group(
     if (is_valid())
         return true;
 
+    APPLESEED_TRACE_SCOPE("osl", "optimize shader group");
+
     RENDERER_LOG_DEBUG("setting up shader group \"%s\"...", get_path().c_str());
 
     if (!compile_source_shaders(shader_compiler))
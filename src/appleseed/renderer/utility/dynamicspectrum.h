@@ -85,6 +85,11 @@ class DynamicSpectrum
     // Return the number of active color channels for the current spectrum mode.
     static size_t size();
 
+    // Call `f(i)` for each active color channel. The number of channels is a compile-time
+    // constant in each mode, so that RGB and spectral operations get their own loops.
+    template <typename Function>
+    static void for_each_sample(const Function& f);
+
     // Constructors.
 #ifdef APPLESEED_USE_SSE
     DynamicSpectrum();                                      // leave all components uninitialized
@@ -105,6 +110,10 @@ class DynamicSpectrum
         const foundation::LightingConditions&               lighting_conditions,
         const Intent                                        intent);
 
+    // Copy only the channels used by the current spectrum mode.
+    DynamicSpectrum(const DynamicSpectrum& rhs);
+    DynamicSpectrum& operator=(const DynamicSpectrum& rhs);
+
     // Construct a spectrum from another spectrum of a different type.
     template <typename U>
     DynamicSpectrum(const DynamicSpectrum<U, N>& rhs);
@@ -306,6 +315,22 @@ inline size_t DynamicSpectrum<T, N>::size()
     return s_size;
 }
 
+template <typename T, size_t N>
+template <typename Function>
+APPLESEED_FORCE_INLINE void DynamicSpectrum<T, N>::for_each_sample(const Function& f)
+{
+    if (s_mode == RGB)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            f(i);
+    }
+    else
+    {
+        for (size_t i = 0; i < N; ++i)
+            f(i);
+    }
+}
+
 #ifdef APPLESEED_USE_SSE
 
 template <typename T, size_t N>
@@ -352,12 +377,52 @@ inline DynamicSpectrum<T, N>::DynamicSpectrum(
 #endif
 }
 
+template <typename T, size_t N>
+inline DynamicSpectrum<T, N>::DynamicSpectrum(const DynamicSpectrum& rhs)
+{
+    *this = rhs;
+}
+
+template <typename T, size_t N>
+inline DynamicSpectrum<T, N>& DynamicSpectrum<T, N>::operator=(const DynamicSpectrum& rhs)
+{
+    for_each_sample([&](const size_t i) { m_samples[i] = rhs.m_samples[i]; });
+
+#ifdef APPLESEED_USE_SSE
+    m_samples[s_size] = T(0.0);
+#endif
+
+    return *this;
+}
+
+#ifdef APPLESEED_USE_SSE
+
+template <>
+APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31>& DynamicSpectrum<float, 31>::operator=(const DynamicSpectrum& rhs)
+{
+    _mm_store_ps(&m_samples[ 0], _mm_load_ps(&rhs.m_samples[ 0]));
+
+    if (s_size > 3)
+    {
+        _mm_store_ps(&m_samples[ 4], _mm_load_ps(&rhs.m_samples[ 4]));
+        _mm_store_ps(&m_samples[ 8], _mm_load_ps(&rhs.m_samples[ 8]));
+        _mm_store_ps(&m_samples[12], _mm_load_ps(&rhs.m_samples[12]));
+        _mm_store_ps(&m_samples[16], _mm_load_ps(&rhs.m_samples[16]));
+        _mm_store_ps(&m_samples[20], _mm_load_ps(&rhs.m_samples[20]));
+        _mm_store_ps(&m_samples[24], _mm_load_ps(&rhs.m_samples[24]));
+        _mm_store_ps(&m_samples[28], _mm_load_ps(&rhs.m_samples[28]));
+    }
+
+    return *this;
+}
+
+#endif  // APPLESEED_USE_SSE
+
 template <typename T, size_t N>
 template <typename U>
 inline DynamicSpectrum<T, N>::DynamicSpectrum(const DynamicSpectrum<U, N>& rhs)
 {
-    for (size_t i = 0; i < s_size; ++i)
-        m_samples[i] = static_cast<ValueType>(rhs[i]);
+    for_each_sample([&](const size_t i) { m_samples[i] = static_cast<ValueType>(rhs[i]); });
 
 #ifdef APPLESEED_USE_SSE
     m_samples[s_size] = T(0.0);
@@ -371,8 +436,7 @@ inline DynamicSpectrum<T, N> DynamicSpectrum<T, N>::from_array(const ValueType*
 
     DynamicSpectrum result;
 
-    for (size_t i = 0; i < s_size; ++i)
-        result.m_samples[i] = rhs[i];
+    for_each_sample([&](const size_t i) { result.m_samples[i] = rhs[i]; });
 
     return result;
 }
@@ -380,8 +444,7 @@ inline DynamicSpectrum<T, N> DynamicSpectrum<T, N>::from_array(const ValueType*
 template <typename T, size_t N>
 inline void DynamicSpectrum<T, N>::set(const ValueType val)
 {
-    for (size_t i = 0; i < s_size; ++i)
-        m_samples[i] = val;
+    for_each_sample([&](const size_t i) { m_samples[i] = val; });
 }
 
 #ifdef APPLESEED_USE_SSE
@@ -494,7 +557,7 @@ inline foundation::Color<T, 3> DynamicSpectrum<T, N>::to_ciexyz(
 template <typename T, size_t N>
 inline bool operator!=(const DynamicSpectrum<T, N>& lhs, const DynamicSpectrum<T, N>& rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
+    for (size_t i = 0, e = DynamicSpectrum<T, N>::size(); i < e; ++i)
     {
         if (lhs[i] != rhs[i])
             return true;
@@ -514,30 +577,77 @@ inline DynamicSpectrum<T, N> operator+(const DynamicSpectrum<T, N>& lhs, const D
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = lhs[i] + rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = lhs[i] + rhs[i]; });
 
     return result;
 }
 
+#ifdef APPLESEED_USE_SSE
+
+template <>
+APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31> operator+(const DynamicSpectrum<float, 31>& lhs, const DynamicSpectrum<float, 31>& rhs)
+{
+    DynamicSpectrum<float, 31> result;
+
+    _mm_store_ps(&result[ 0], _mm_add_ps(_mm_load_ps(&lhs[ 0]), _mm_load_ps(&rhs[ 0])));
+
+    if (DynamicSpectrum<float, 31>::size() > 3)
+    {
+        _mm_store_ps(&result[ 4], _mm_add_ps(_mm_load_ps(&lhs[ 4]), _mm_load_ps(&rhs[ 4])));
+        _mm_store_ps(&result[ 8], _mm_add_ps(_mm_load_ps(&lhs[ 8]), _mm_load_ps(&rhs[ 8])));
+        _mm_store_ps(&result[12], _mm_add_ps(_mm_load_ps(&lhs[12]), _mm_load_ps(&rhs[12])));
+        _mm_store_ps(&result[16], _mm_add_ps(_mm_load_ps(&lhs[16]), _mm_load_ps(&rhs[16])));
+        _mm_store_ps(&result[20], _mm_add_ps(_mm_load_ps(&lhs[20]), _mm_load_ps(&rhs[20])));
+        _mm_store_ps(&result[24], _mm_add_ps(_mm_load_ps(&lhs[24]), _mm_load_ps(&rhs[24])));
+        _mm_store_ps(&result[28], _mm_add_ps(_mm_load_ps(&lhs[28]), _mm_load_ps(&rhs[28])));
+    }
+
+    return result;
+}
+
+#endif  // APPLESEED_USE_SSE
+
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N> operator-(const DynamicSpectrum<T, N>& lhs, const DynamicSpectrum<T, N>& rhs)
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = lhs[i] - rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = lhs[i] - rhs[i]; });
+
+    return result;
+}
+
+#ifdef APPLESEED_USE_SSE
+
+template <>
+APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31> operator-(const DynamicSpectrum<float, 31>& lhs, const DynamicSpectrum<float, 31>& rhs)
+{
+    DynamicSpectrum<float, 31> result;
+
+    _mm_store_ps(&result[ 0], _mm_sub_ps(_mm_load_ps(&lhs[ 0]), _mm_load_ps(&rhs[ 0])));
+
+    if (DynamicSpectrum<float, 31>::size() > 3)
+    {
+        _mm_store_ps(&result[ 4], _mm_sub_ps(_mm_load_ps(&lhs[ 4]), _mm_load_ps(&rhs[ 4])));
+        _mm_store_ps(&result[ 8], _mm_sub_ps(_mm_load_ps(&lhs[ 8]), _mm_load_ps(&rhs[ 8])));
+        _mm_store_ps(&result[12], _mm_sub_ps(_mm_load_ps(&lhs[12]), _mm_load_ps(&rhs[12])));
+        _mm_store_ps(&result[16], _mm_sub_ps(_mm_load_ps(&lhs[16]), _mm_load_ps(&rhs[16])));
+        _mm_store_ps(&result[20], _mm_sub_ps(_mm_load_ps(&lhs[20]), _mm_load_ps(&rhs[20])));
+        _mm_store_ps(&result[24], _mm_sub_ps(_mm_load_ps(&lhs[24]), _mm_load_ps(&rhs[24])));
+        _mm_store_ps(&result[28], _mm_sub_ps(_mm_load_ps(&lhs[28]), _mm_load_ps(&rhs[28])));
+    }
 
     return result;
 }
 
+#endif  // APPLESEED_USE_SSE
+
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N> operator-(const DynamicSpectrum<T, N>& lhs)
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = -lhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = -lhs[i]; });
 
     return result;
 }
@@ -547,12 +657,38 @@ inline DynamicSpectrum<T, N> operator*(const DynamicSpectrum<T, N>& lhs, const T
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = lhs[i] * rhs;
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = lhs[i] * rhs; });
+
+    return result;
+}
+
+#ifdef APPLESEED_USE_SSE
+
+template <>
+APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31> operator*(const DynamicSpectrum<float, 31>& lhs, const float rhs)
+{
+    DynamicSpectrum<float, 31> result;
+
+    const __m128 mrhs = _mm_set1_ps(rhs);
+
+    _mm_store_ps(&result[ 0], _mm_mul_ps(_mm_load_ps(&lhs[ 0]), mrhs));
+
+    if (DynamicSpectrum<float, 31>::size() > 3)
+    {
+        _mm_store_ps(&result[ 4], _mm_mul_ps(_mm_load_ps(&lhs[ 4]), mrhs));
+        _mm_store_ps(&result[ 8], _mm_mul_ps(_mm_load_ps(&lhs[ 8]), mrhs));
+        _mm_store_ps(&result[12], _mm_mul_ps(_mm_load_ps(&lhs[12]), mrhs));
+        _mm_store_ps(&result[16], _mm_mul_ps(_mm_load_ps(&lhs[16]), mrhs));
+        _mm_store_ps(&result[20], _mm_mul_ps(_mm_load_ps(&lhs[20]), mrhs));
+        _mm_store_ps(&result[24], _mm_mul_ps(_mm_load_ps(&lhs[24]), mrhs));
+        _mm_store_ps(&result[28], _mm_mul_ps(_mm_load_ps(&lhs[28]), mrhs));
+    }
 
     return result;
 }
 
+#endif  // APPLESEED_USE_SSE
+
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N> operator*(const T lhs, const DynamicSpectrum<T, N>& rhs)
 {
@@ -564,19 +700,42 @@ inline DynamicSpectrum<T, N> operator*(const DynamicSpectrum<T, N>& lhs, const D
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = lhs[i] * rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = lhs[i] * rhs[i]; });
 
     return result;
 }
 
+#ifdef APPLESEED_USE_SSE
+
+template <>
+APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31> operator*(const DynamicSpectrum<float, 31>& lhs, const DynamicSpectrum<float, 31>& rhs)
+{
+    DynamicSpectrum<float, 31> result;
+
+    _mm_store_ps(&result[ 0], _mm_mul_ps(_mm_load_ps(&lhs[ 0]), _mm_load_ps(&rhs[ 0])));
+
+    if (DynamicSpectrum<float, 31>::size() > 3)
+    {
+        _mm_store_ps(&result[ 4], _mm_mul_ps(_mm_load_ps(&lhs[ 4]), _mm_load_ps(&rhs[ 4])));
+        _mm_store_ps(&result[ 8], _mm_mul_ps(_mm_load_ps(&lhs[ 8]), _mm_load_ps(&rhs[ 8])));
+        _mm_store_ps(&result[12], _mm_mul_ps(_mm_load_ps(&lhs[12]), _mm_load_ps(&rhs[12])));
+        _mm_store_ps(&result[16], _mm_mul_ps(_mm_load_ps(&lhs[16]), _mm_load_ps(&rhs[16])));
+        _mm_store_ps(&result[20], _mm_mul_ps(_mm_load_ps(&lhs[20]), _mm_load_ps(&rhs[20])));
+        _mm_store_ps(&result[24], _mm_mul_ps(_mm_load_ps(&lhs[24]), _mm_load_ps(&rhs[24])));
+        _mm_store_ps(&result[28], _mm_mul_ps(_mm_load_ps(&lhs[28]), _mm_load_ps(&rhs[28])));
+    }
+
+    return result;
+}
+
+#endif  // APPLESEED_USE_SSE
+
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N> operator/(const DynamicSpectrum<T, N>& lhs, const T rhs)
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = lhs[i] / rhs;
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = lhs[i] / rhs; });
 
     return result;
 }
@@ -604,8 +763,7 @@ inline DynamicSpectrum<T, N> operator/(const DynamicSpectrum<T, N>& lhs, const D
 {
     DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        result[i] = lhs[i] / rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = lhs[i] / rhs[i]; });
 
     return result;
 }
@@ -613,8 +771,7 @@ inline DynamicSpectrum<T, N> operator/(const DynamicSpectrum<T, N>& lhs, const D
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N>& operator+=(DynamicSpectrum<T, N>& lhs, const DynamicSpectrum<T, N>& rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        lhs[i] += rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { lhs[i] += rhs[i]; });
 
     return lhs;
 }
@@ -645,17 +802,38 @@ APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31>& operator+=(DynamicSpectrum<fl
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N>& operator-=(DynamicSpectrum<T, N>& lhs, const DynamicSpectrum<T, N>& rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        lhs[i] -= rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { lhs[i] -= rhs[i]; });
 
     return lhs;
 }
 
+#ifdef APPLESEED_USE_SSE
+
+template <>
+APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31>& operator-=(DynamicSpectrum<float, 31>& lhs, const DynamicSpectrum<float, 31>& rhs)
+{
+    _mm_store_ps(&lhs[ 0], _mm_sub_ps(_mm_load_ps(&lhs[ 0]), _mm_load_ps(&rhs[ 0])));
+
+    if (DynamicSpectrum<float, 31>::size() > 3)
+    {
+        _mm_store_ps(&lhs[ 4], _mm_sub_ps(_mm_load_ps(&lhs[ 4]), _mm_load_ps(&rhs[ 4])));
+        _mm_store_ps(&lhs[ 8], _mm_sub_ps(_mm_load_ps(&lhs[ 8]), _mm_load_ps(&rhs[ 8])));
+        _mm_store_ps(&lhs[12], _mm_sub_ps(_mm_load_ps(&lhs[12]), _mm_load_ps(&rhs[12])));
+        _mm_store_ps(&lhs[16], _mm_sub_ps(_mm_load_ps(&lhs[16]), _mm_load_ps(&rhs[16])));
+        _mm_store_ps(&lhs[20], _mm_sub_ps(_mm_load_ps(&lhs[20]), _mm_load_ps(&rhs[20])));
+        _mm_store_ps(&lhs[24], _mm_sub_ps(_mm_load_ps(&lhs[24]), _mm_load_ps(&rhs[24])));
+        _mm_store_ps(&lhs[28], _mm_sub_ps(_mm_load_ps(&lhs[28]), _mm_load_ps(&rhs[28])));
+    }
+
+    return lhs;
+}
+
+#endif  // APPLESEED_USE_SSE
+
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N>& operator*=(DynamicSpectrum<T, N>& lhs, const T rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        lhs[i] *= rhs;
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { lhs[i] *= rhs; });
 
     return lhs;
 }
@@ -688,8 +866,7 @@ APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31>& operator*=(DynamicSpectrum<fl
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N>& operator*=(DynamicSpectrum<T, N>& lhs, const DynamicSpectrum<T, N>& rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        lhs[i] *= rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { lhs[i] *= rhs[i]; });
 
     return lhs;
 }
@@ -720,8 +897,7 @@ APPLESEED_FORCE_INLINE DynamicSpectrum<float, 31>& operator*=(DynamicSpectrum<fl
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N>& operator/=(DynamicSpectrum<T, N>& lhs, const T rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        lhs[i] /= rhs;
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { lhs[i] /= rhs; });
 
     return lhs;
 }
@@ -747,8 +923,7 @@ inline DynamicSpectrum<long double, N>& operator/=(DynamicSpectrum<long double,
 template <typename T, size_t N>
 inline DynamicSpectrum<T, N>& operator/=(DynamicSpectrum<T, N>& lhs, const DynamicSpectrum<T, N>& rhs)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        lhs[i] /= rhs[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { lhs[i] /= rhs[i]; });
 
     return lhs;
 }
@@ -759,8 +934,7 @@ inline void madd(
     const DynamicSpectrum<T, N>&            b,
     const DynamicSpectrum<T, N>&            c)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        a[i] += b[i] * c[i];
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { a[i] += b[i] * c[i]; });
 }
 
 template <typename T, size_t N>
@@ -769,8 +943,7 @@ inline void madd(
     const DynamicSpectrum<T, N>&            b,
     const T                                 c)
 {
-    for (size_t i = 0; i < DynamicSpectrum<T, N>::size(); ++i)
-        a[i] += b[i] * c;
+    DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { a[i] += b[i] * c; });
 }
 
 #ifdef APPLESEED_USE_SSE
@@ -889,8 +1062,7 @@ inline renderer::DynamicSpectrum<T, N> rcp(const renderer::DynamicSpectrum<T, N>
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = T(1.0) / s[i];
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = T(1.0) / s[i]; });
 
     return result;
 }
@@ -901,8 +1073,7 @@ inline renderer::DynamicSpectrum<T, N> sqrt(const renderer::DynamicSpectrum<T, N
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::sqrt(s[i]);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::sqrt(s[i]); });
 
     return result;
 }
@@ -937,8 +1108,7 @@ inline renderer::DynamicSpectrum<T, N> pow(const renderer::DynamicSpectrum<T, N>
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::pow(x[i], y);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::pow(x[i], y); });
 
     return result;
 }
@@ -950,8 +1120,7 @@ inline renderer::DynamicSpectrum<T, N> pow(
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::pow(x[i], y[i]);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::pow(x[i], y[i]); });
 
     return result;
 }
@@ -961,8 +1130,7 @@ inline renderer::DynamicSpectrum<T, N> log(const renderer::DynamicSpectrum<T, N>
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::log(s[i]);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::log(s[i]); });
 
     return result;
 }
@@ -972,8 +1140,7 @@ inline renderer::DynamicSpectrum<T, N> exp(const renderer::DynamicSpectrum<T, N>
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::exp(s[i]);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::exp(s[i]); });
 
     return result;
 }
@@ -995,8 +1162,7 @@ inline renderer::DynamicSpectrum<T, N> saturate(const renderer::DynamicSpectrum<
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = saturate(s[i]);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = saturate(s[i]); });
 
     return result;
 }
@@ -1012,8 +1178,7 @@ inline renderer::DynamicSpectrum<T, N> clamp(const renderer::DynamicSpectrum<T,
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = clamp(s[i], min, max);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = clamp(s[i], min, max); });
 
     return result;
 }
@@ -1036,8 +1201,7 @@ inline renderer::DynamicSpectrum<T, N> clamp_low(const renderer::DynamicSpectrum
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::max(s[i], min);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::max(s[i], min); });
 
     return result;
 }
@@ -1057,8 +1221,7 @@ inline renderer::DynamicSpectrum<T, N> clamp_high(const renderer::DynamicSpectru
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = std::min(s[i], max);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = std::min(s[i], max); });
 
     return result;
 }
@@ -1081,8 +1244,7 @@ inline renderer::DynamicSpectrum<T, N> lerp(
 {
     renderer::DynamicSpectrum<T, N> result;
 
-    for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-        result[i] = foundation::lerp(a[i], b[i], t[i]);
+    renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { result[i] = foundation::lerp(a[i], b[i], t[i]); });
 
     return result;
 }
@@ -1338,8 +1500,7 @@ class PoisonImpl<renderer::DynamicSpectrum<T, N>>
   public:
     static void do_poison(renderer::DynamicSpectrum<T, N>& s)
     {
-        for (size_t i = 0, e = renderer::DynamicSpectrum<T, N>::size(); i < e; ++i)
-            debug_poison(s[i]);
+        renderer::DynamicSpectrum<T, N>::for_each_sample([&](const size_t i) { debug_poison(s[i]); });
     }
 };
 
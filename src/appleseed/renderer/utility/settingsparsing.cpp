@@ -106,12 +106,12 @@ SamplingContext::Mode get_sampling_context_mode(const ParamArray& params)
         params.get_required<std::string>(
             "sampling_mode",
             "qmc",
-            make_vector("rng", "qmc"));
+            make_vector("rng", "qmc", "sobol"));
 
     return
-        sampling_mode == "rng"
-            ? SamplingContext::RNGMode
-            : SamplingContext::QMCMode;
+        sampling_mode == "rng"   ? SamplingContext::RNGMode :
+        sampling_mode == "sobol" ? SamplingContext::SobolMode :
+                                   SamplingContext::QMCMode;
 }
 
 std::string get_sampling_context_mode_name(const SamplingContext::Mode mode)
@@ -120,6 +120,7 @@ std::string get_sampling_context_mode_name(const SamplingContext::Mode mode)
     {
       case SamplingContext::RNGMode: return "rng";
       case SamplingContext::QMCMode: return "qmc";
+      case SamplingContext::SobolMode: return "sobol";
       default: return "unknown";
     }
 }